@@ -0,0 +1,356 @@
+#include "block_cache/block_cache.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "io/async_io.h"
+#include "util/hash_util.h"
+#include "util/stopwatch.h"
+
+namespace starrocks {
+
+struct BlockCache::Entry {
+    Entry(BlockCache* cache, std::string key, Tier tier, uint32_t size, uint32_t checksum)
+            : cache(cache), key(std::move(key)), tier(tier), size(size), checksum(checksum) {}
+    // A disk block's slot is reused only once no reader holds the block.
+    ~Entry() {
+        if (slot >= 0) {
+            cache->_release_slot(slot);
+        }
+    }
+
+    BlockCache* const cache;
+    const std::string key;
+    const Tier tier;
+    const uint32_t size;
+    const uint32_t checksum;
+    std::unique_ptr<uint8_t[]> data;
+    int64_t slot = -1;
+
+    History history;
+    bool linked = false;
+    OrderKey order_key;
+};
+
+static uint32_t block_checksum(const uint8_t* data, size_t size) {
+    return static_cast<uint32_t>(HashUtil::hash_bytes(data, size));
+}
+
+static Status pwrite_fully(int fd, const uint8_t* data, size_t len, int64_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pwrite(fd, data + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Status::IOError(std::string("failed to write block cache file: ") + std::strerror(errno));
+        }
+        done += n;
+    }
+    return Status::OK();
+}
+
+StatusOr<std::unique_ptr<BlockCache>> BlockCache::create(BlockCacheOptions options, MemTracker* mem_tracker) {
+    if (options.block_size == 0 || options.mem_capacity_bytes < static_cast<int64_t>(options.block_size)) {
+        return Status::InvalidArgument("block cache memory must hold at least one block");
+    }
+    options.lru_k = std::clamp(options.lru_k, 1, kMaxLruK);
+    std::unique_ptr<BlockCache> cache(new BlockCache(std::move(options), mem_tracker));
+    if (cache->_options.disk_capacity_bytes >= static_cast<int64_t>(cache->_options.block_size)) {
+        RETURN_IF_ERROR(cache->_open_disk_tier());
+    }
+    return cache;
+}
+
+BlockCache::BlockCache(BlockCacheOptions options, MemTracker* mem_tracker)
+        : _options(std::move(options)), _mem_tracker(mem_tracker) {
+    // A history record is tiny next to a block; keep several per cached one.
+    _max_history = 8 * (_options.mem_capacity_bytes + std::max<int64_t>(_options.disk_capacity_bytes, 0)) /
+                   _options.block_size;
+}
+
+BlockCache::~BlockCache() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _mem_order.clear();
+        _disk_order.clear();
+        _entries.clear();
+    }
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(_mem_usage);
+    }
+    if (_disk_fd >= 0) {
+        ::close(_disk_fd);
+    }
+}
+
+Status BlockCache::_open_disk_tier() {
+    if (::mkdir(_options.disk_path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return Status::IOError("failed to create block cache directory " + _options.disk_path + ": " +
+                               std::strerror(errno));
+    }
+    // Blocks are not looked up across restarts, so the file starts empty.
+    std::string path = _options.disk_path + "/block_cache.data";
+    _disk_fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0644);
+    if (_disk_fd < 0) {
+        return Status::IOError("failed to open " + path + ": " + std::strerror(errno));
+    }
+    int64_t num_slots = _options.disk_capacity_bytes / _options.block_size;
+    if (::ftruncate(_disk_fd, num_slots * _options.block_size) != 0) {
+        return Status::IOError("failed to size " + path + ": " + std::strerror(errno));
+    }
+    _free_slots.reserve(num_slots);
+    for (int64_t slot = num_slots - 1; slot >= 0; --slot) {
+        _free_slots.push_back(slot);
+    }
+    return Status::OK();
+}
+
+void BlockCache::_touch_locked(Entry* entry, int64_t now_ns) {
+    History& h = entry->history;
+    if (h.num_refs == 0 || now_ns - h.last_ref_ns >= _options.correlated_reference_period_ns) {
+        std::copy_backward(h.refs, h.refs + _options.lru_k - 1, h.refs + _options.lru_k);
+        h.num_refs = std::min(h.num_refs + 1, _options.lru_k);
+    }
+    h.refs[0] = ++_clock;
+    h.last_ref_ns = now_ns;
+    if (entry->linked) {
+        _unlink_locked(entry);
+        _link_locked(_entries[entry->key]);
+    }
+}
+
+void BlockCache::_link_locked(const EntryPtr& entry) {
+    const History& h = entry->history;
+    // Fewer than K references is an infinite K-distance: 0 sorts first.
+    uint64_t kth = h.num_refs >= _options.lru_k ? h.refs[_options.lru_k - 1] : 0;
+    entry->order_key = {kth, h.refs[0]};
+    Order& order = entry->tier == Tier::MEMORY ? _mem_order : _disk_order;
+    order.emplace(entry->order_key, entry.get());
+    entry->linked = true;
+}
+
+void BlockCache::_unlink_locked(Entry* entry) {
+    Order& order = entry->tier == Tier::MEMORY ? _mem_order : _disk_order;
+    order.erase(entry->order_key);
+    entry->linked = false;
+}
+
+void BlockCache::_erase_locked(const EntryPtr& entry) {
+    _unlink_locked(entry.get());
+    if (entry->tier == Tier::MEMORY) {
+        _mem_usage -= entry->size;
+        if (_mem_tracker != nullptr) {
+            _mem_tracker->release(entry->size);
+        }
+    } else {
+        _disk_usage -= entry->size;
+    }
+    _entries.erase(entry->key);
+}
+
+void BlockCache::_remember_locked(const Entry& entry) {
+    if (_entries.count(entry.key) > 0 || !_history.insert_or_assign(entry.key, entry.history).second) {
+        return;
+    }
+    _history_fifo.push_back(entry.key);
+    while (_history.size() > _max_history) {
+        _history.erase(_history_fifo.front());
+        _history_fifo.pop_front();
+    }
+}
+
+void BlockCache::_evict_memory_locked(size_t incoming, std::vector<EntryPtr>* evicted) {
+    while (_mem_usage + static_cast<int64_t>(incoming) > _options.mem_capacity_bytes && !_mem_order.empty()) {
+        EntryPtr victim = _entries[_mem_order.begin()->second->key];
+        _erase_locked(victim);
+        evicted->push_back(std::move(victim));
+    }
+}
+
+bool BlockCache::read(const std::string& key, size_t offset, size_t len, uint8_t* dst, int64_t table_id) {
+    EntryPtr entry;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && offset + len <= it->second->size) {
+            entry = it->second;
+            _touch_locked(entry.get(), monotonic_nanos());
+        }
+    }
+    if (entry == nullptr) {
+        _count(table_id, &BlockCacheStats::misses, len, false);
+        return false;
+    }
+    if (entry->tier == Tier::MEMORY) {
+        memcpy(dst, entry->data.get() + offset, len);
+        _count(table_id, &BlockCacheStats::mem_hits, len, true);
+        return true;
+    }
+
+    // The whole block is read so that it can be verified, and kept.
+    auto data = std::make_unique<uint8_t[]>(entry->size);
+    Status st = io::pread_fully(_disk_fd, data.get(), entry->size, entry->slot * _options.block_size);
+    if (!st.ok() || block_checksum(data.get(), entry->size) != entry->checksum) {
+        if (st.ok()) {
+            _checksum_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second == entry) {
+            _erase_locked(entry);
+        }
+        _count(table_id, &BlockCacheStats::misses, len, false);
+        return false;
+    }
+    memcpy(dst, data.get() + offset, len);
+    _count(table_id, &BlockCacheStats::disk_hits, len, true);
+    _promote(entry, std::move(data));
+    return true;
+}
+
+void BlockCache::write(const std::string& key, std::unique_ptr<uint8_t[]> data, size_t size) {
+    if (size == 0 || size > _options.block_size) {
+        return;
+    }
+    uint32_t checksum = block_checksum(data.get(), size);
+    std::vector<EntryPtr> evicted;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_entries.count(key) > 0) {
+            return;
+        }
+        auto entry = std::make_shared<Entry>(this, key, Tier::MEMORY, size, checksum);
+        entry->data = std::move(data);
+        auto it = _history.find(key);
+        if (it != _history.end()) {
+            entry->history = it->second;
+            _history.erase(it);
+        }
+        // A block is written after a miss on it, which is its reference.
+        _touch_locked(entry.get(), monotonic_nanos());
+        _evict_memory_locked(size, &evicted);
+        _entries.emplace(key, entry);
+        _link_locked(entry);
+        _mem_usage += size;
+        if (_mem_tracker != nullptr) {
+            _mem_tracker->consume(size);
+        }
+    }
+    _demote(std::move(evicted));
+}
+
+void BlockCache::_promote(const EntryPtr& entry, std::unique_ptr<uint8_t[]> data) {
+    std::vector<EntryPtr> evicted;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _entries.find(entry->key);
+        if (it == _entries.end() || it->second != entry) {
+            return;
+        }
+        auto promoted = std::make_shared<Entry>(this, entry->key, Tier::MEMORY, entry->size, entry->checksum);
+        promoted->data = std::move(data);
+        promoted->history = entry->history;
+        _erase_locked(entry);
+        _evict_memory_locked(promoted->size, &evicted);
+        _entries.emplace(promoted->key, promoted);
+        _link_locked(promoted);
+        _mem_usage += promoted->size;
+        if (_mem_tracker != nullptr) {
+            _mem_tracker->consume(promoted->size);
+        }
+    }
+    _demote(std::move(evicted));
+}
+
+void BlockCache::_demote(std::vector<EntryPtr> evicted) {
+    for (EntryPtr& entry : evicted) {
+        int64_t slot = _disk_fd >= 0 ? _allocate_slot() : -1;
+        if (slot >= 0 && !pwrite_fully(_disk_fd, entry->data.get(), entry->size, slot * _options.block_size).ok()) {
+            _release_slot(slot);
+            slot = -1;
+        }
+        auto demoted = slot >= 0 ? std::make_shared<Entry>(this, entry->key, Tier::DISK, entry->size, entry->checksum)
+                                 : nullptr;
+        std::lock_guard<std::mutex> l(_lock);
+        if (demoted != nullptr) {
+            demoted->slot = slot;
+        }
+        if (demoted == nullptr || _entries.count(entry->key) > 0) {
+            // Dropped, or cached again meanwhile.
+            _remember_locked(*entry);
+            continue;
+        }
+        demoted->history = entry->history;
+        _entries.emplace(demoted->key, demoted);
+        _link_locked(demoted);
+        _disk_usage += demoted->size;
+    }
+}
+
+int64_t BlockCache::_allocate_slot() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> l(_slot_lock);
+            if (!_free_slots.empty()) {
+                int64_t slot = _free_slots.back();
+                _free_slots.pop_back();
+                return slot;
+            }
+        }
+        EntryPtr victim;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            if (_disk_order.empty()) {
+                return -1;
+            }
+            victim = _entries[_disk_order.begin()->second->key];
+            _erase_locked(victim);
+            _remember_locked(*victim);
+        }
+        // Frees the slot, unless a reader still holds the block.
+    }
+}
+
+void BlockCache::_release_slot(int64_t slot) {
+    std::lock_guard<std::mutex> l(_slot_lock);
+    _free_slots.push_back(slot);
+}
+
+void BlockCache::_count(int64_t table_id, int64_t BlockCacheStats::*counter, size_t bytes, bool hit) {
+    std::lock_guard<std::mutex> l(_stats_lock);
+    BlockCacheStats& stats = _table_stats[table_id];
+    ++(stats.*counter);
+    (hit ? stats.hit_bytes : stats.miss_bytes) += bytes;
+}
+
+BlockCacheStats BlockCache::table_stats(int64_t table_id) const {
+    std::lock_guard<std::mutex> l(_stats_lock);
+    auto it = _table_stats.find(table_id);
+    return it == _table_stats.end() ? BlockCacheStats() : it->second;
+}
+
+std::vector<std::pair<int64_t, BlockCacheStats>> BlockCache::all_table_stats() const {
+    std::lock_guard<std::mutex> l(_stats_lock);
+    std::vector<std::pair<int64_t, BlockCacheStats>> stats(_table_stats.begin(), _table_stats.end());
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return stats;
+}
+
+int64_t BlockCache::mem_usage() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _mem_usage;
+}
+
+int64_t BlockCache::disk_usage() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _disk_usage;
+}
+
+} // namespace starrocks
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "runtime/mem_tracker.h"
+
+namespace starrocks {
+
+struct BlockCacheOptions {
+    // Bytes of blocks held in memory; at least one block.
+    int64_t mem_capacity_bytes = 0;
+    // Bytes of the SSD tier; 0 disables it.
+    int64_t disk_capacity_bytes = 0;
+    // Directory of the SSD tier's cache file.
+    std::string disk_path;
+    size_t block_size = 1024 * 1024;
+    // Eviction goes by each block's K-th most recent reference (LRU-K).
+    int lru_k = 2;
+    // References to a block closer together than this count as one.
+    int64_t correlated_reference_period_ns = 0;
+};
+
+struct BlockCacheStats {
+    int64_t mem_hits = 0;
+    int64_t disk_hits = 0;
+    int64_t misses = 0;
+    int64_t hit_bytes = 0;
+    int64_t miss_bytes = 0;
+};
+
+// Cache of the fixed-size blocks of remote files (see CachedObjectFile), in a
+// memory tier over a local SSD tier. A block lives in one tier at a time: it
+// moves to disk when evicted from memory and back to memory on a disk hit.
+//
+// Eviction is LRU-K: the victim is the block whose K-th most recent
+// reference is the oldest, and blocks referenced fewer than K times go
+// first, least recently used first. A large scan touching each block once
+// therefore evicts its own blocks rather than those repeated queries keep
+// coming back to. Reads of one block within the correlated reference period,
+// such as the consecutive pages a scan takes from it, are one reference. The
+// history of evicted blocks is kept for a while, so a block read again soon
+// after its eviction is not treated as new.
+//
+// Blocks are checksummed when cached and verified when read back from disk;
+// a block failing verification is dropped and the read is a miss.
+//
+// Hits and misses are counted per table. The memory tier is charged to
+// |mem_tracker|, usually the process tracker, rather than to the queries
+// happening to fill it.
+class BlockCache {
+public:
+    static StatusOr<std::unique_ptr<BlockCache>> create(BlockCacheOptions options, MemTracker* mem_tracker);
+
+    ~BlockCache();
+
+    DISALLOW_COPY_AND_MOVE(BlockCache);
+
+    size_t block_size() const { return _options.block_size; }
+
+    // Copies |len| bytes at |offset| of block |key| to |dst| and returns true
+    // if the block is cached. Counts a hit or a miss for |table_id|.
+    bool read(const std::string& key, size_t offset, size_t len, uint8_t* dst, int64_t table_id);
+    // Caches |size| bytes, at most block_size(), as block |key| unless it is
+    // cached already.
+    void write(const std::string& key, std::unique_ptr<uint8_t[]> data, size_t size);
+
+    BlockCacheStats table_stats(int64_t table_id) const;
+    std::vector<std::pair<int64_t, BlockCacheStats>> all_table_stats() const;
+
+    int64_t mem_usage() const;
+    int64_t disk_usage() const;
+    int64_t num_checksum_failures() const { return _checksum_failures.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kMaxLruK = 4;
+
+    enum class Tier { MEMORY, DISK };
+
+    struct History {
+        // Clock values of the most recent references, newest first.
+        uint64_t refs[kMaxLruK] = {};
+        int num_refs = 0;
+        int64_t last_ref_ns = 0;
+    };
+
+    // Immutable but for its history; moving to the other tier makes a new
+    // entry, so readers may use the data of one they hold without the lock.
+    struct Entry;
+    using EntryPtr = std::shared_ptr<Entry>;
+    using OrderKey = std::pair<uint64_t, uint64_t>;
+    using Order = std::map<OrderKey, Entry*>;
+
+    BlockCache(BlockCacheOptions options, MemTracker* mem_tracker);
+
+    Status _open_disk_tier();
+
+    // The following require _lock.
+    void _touch_locked(Entry* entry, int64_t now_ns);
+    void _link_locked(const EntryPtr& entry);
+    void _unlink_locked(Entry* entry);
+    void _erase_locked(const EntryPtr& entry);
+    // Keeps the history of a block no longer cached.
+    void _remember_locked(const Entry& entry);
+    // Evicts memory blocks until |incoming| more bytes fit.
+    void _evict_memory_locked(size_t incoming, std::vector<EntryPtr>* evicted);
+
+    // Moves blocks evicted from memory to the disk tier, or drops them.
+    void _demote(std::vector<EntryPtr> evicted);
+    // Moves a block just read from disk back to memory.
+    void _promote(const EntryPtr& entry, std::unique_ptr<uint8_t[]> data);
+    // A free slot of the cache file, evicting disk blocks if needed; -1 when
+    // none can be had.
+    int64_t _allocate_slot();
+    void _release_slot(int64_t slot);
+
+    void _count(int64_t table_id, int64_t BlockCacheStats::*counter, size_t bytes, bool hit);
+
+    const BlockCacheOptions _options;
+    MemTracker* const _mem_tracker;
+    int _disk_fd = -1;
+
+    std::mutex _slot_lock;
+    std::vector<int64_t> _free_slots;
+
+    mutable std::mutex _lock;
+    std::unordered_map<std::string, EntryPtr> _entries;
+    Order _mem_order;
+    Order _disk_order;
+    int64_t _mem_usage = 0;
+    int64_t _disk_usage = 0;
+    uint64_t _clock = 0;
+    // History of evicted blocks, forgotten first in first out.
+    std::unordered_map<std::string, History> _history;
+    std::deque<std::string> _history_fifo;
+    size_t _max_history = 0;
+
+    mutable std::mutex _stats_lock;
+    std::unordered_map<int64_t, BlockCacheStats> _table_stats;
+    std::atomic<int64_t> _checksum_failures{0};
+};
+
+} // namespace starrocks
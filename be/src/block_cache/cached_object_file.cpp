@@ -0,0 +1,43 @@
+#include "block_cache/cached_object_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace starrocks {
+
+StatusOr<io::RandomAccessFilePtr> CachedObjectFile::open(io::ObjectStore* store, const std::string& key,
+                                                         BlockCache* cache, int64_t table_id) {
+    ASSIGN_OR_RETURN(int64_t size, store->object_size(key));
+    return io::RandomAccessFilePtr(new CachedObjectFile(store, key, size, cache, table_id));
+}
+
+Status CachedObjectFile::read_at(int64_t offset, uint8_t* data, size_t len) const {
+    if (offset < 0 || offset + static_cast<int64_t>(len) > _size) {
+        return Status::Corruption("read past the end of object " + _key);
+    }
+    if (_cache == nullptr) {
+        return _store->read_object(_key, offset, len, data);
+    }
+    auto block_size = static_cast<int64_t>(_cache->block_size());
+    int64_t end = offset + len;
+    while (offset < end) {
+        int64_t block = offset / block_size;
+        int64_t block_begin = block * block_size;
+        size_t block_len = std::min(block_size, _size - block_begin);
+        size_t in_block = offset - block_begin;
+        size_t n = std::min<int64_t>(end, block_begin + block_len) - offset;
+        // Objects never change, so a block is identified by its position.
+        std::string cache_key = _key + '@' + std::to_string(block);
+        if (!_cache->read(cache_key, in_block, n, data, _table_id)) {
+            auto block_data = std::make_unique<uint8_t[]>(block_len);
+            RETURN_IF_ERROR(_store->read_object(_key, block_begin, block_len, block_data.get()));
+            memcpy(data, block_data.get() + in_block, n);
+            _cache->write(cache_key, std::move(block_data), block_len);
+        }
+        offset += n;
+        data += n;
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "block_cache/block_cache.h"
+#include "io/object_store.h"
+#include "io/random_access_file.h"
+
+namespace starrocks {
+
+// An object of an ObjectStore read as a file through a BlockCache. Reads are
+// cut at block boundaries; each block missing from the cache is fetched
+// whole, in one request, and cached for the next reader. Lake scans open
+// their segments over these, so repeated queries over the same tables read
+// locally instead of paying the store's latency again.
+class CachedObjectFile final : public io::RandomAccessFile {
+public:
+    // |cache| may be null, to read straight from the store; hits and misses
+    // are counted for |table_id|. The store and the cache must outlive the file.
+    static StatusOr<io::RandomAccessFilePtr> open(io::ObjectStore* store, const std::string& key, BlockCache* cache,
+                                                  int64_t table_id);
+
+    const std::string& name() const override { return _key; }
+    int64_t size() const override { return _size; }
+    Status read_at(int64_t offset, uint8_t* data, size_t len) const override;
+
+private:
+    CachedObjectFile(io::ObjectStore* store, std::string key, int64_t size, BlockCache* cache, int64_t table_id)
+            : _store(store), _key(std::move(key)), _size(size), _cache(cache), _table_id(table_id) {}
+
+    io::ObjectStore* const _store;
+    const std::string _key;
+    const int64_t _size;
+    BlockCache* const _cache;
+    const int64_t _table_id;
+};
+
+} // namespace starrocks
@@ -0,0 +1,117 @@
+#include "column/binary_column.h"
+
+namespace starrocks {
+
+void BinaryColumn::resize(size_t n) {
+    if (n <= size()) {
+        _offsets.resize(n + 1);
+        _bytes.resize(_offsets.back());
+    } else {
+        append_default(n - size());
+    }
+}
+
+void BinaryColumn::assign(size_t n, size_t idx) {
+    std::string value = get_slice(idx).to_string();
+    reset_column();
+    _bytes.reserve(value.size() * n);
+    for (size_t i = 0; i < n; ++i) {
+        append(Slice(value));
+    }
+}
+
+void BinaryColumn::append_strings(const Slice* strs, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += strs[i].size;
+    }
+    size_t pos = _bytes.size();
+    _bytes.resize_uninitialized(pos + total);
+    size_t row = _offsets.size();
+    _offsets.resize_uninitialized(row + count);
+    uint8_t* dst = _bytes.data();
+    uint32_t* offsets = _offsets.data();
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(dst + pos, strs[i].data, strs[i].size);
+        pos += strs[i].size;
+        offsets[row + i] = static_cast<uint32_t>(pos);
+    }
+}
+
+void BinaryColumn::append(const Column& src, size_t offset, size_t count) {
+    const auto& b = static_cast<const BinaryColumn&>(src);
+    const uint32_t* src_offsets = b._offsets.data();
+    uint32_t begin = src_offsets[offset];
+    uint32_t end = src_offsets[offset + count];
+
+    _bytes.append(b._bytes.data() + begin, end - begin);
+
+    size_t row = _offsets.size();
+    _offsets.resize_uninitialized(row + count);
+    uint32_t* dst = _offsets.data() + row;
+    // Rebase the source offsets onto the end of our byte buffer.
+    uint32_t delta = _offsets[row - 1] - begin;
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = src_offsets[offset + i + 1] + delta;
+    }
+}
+
+void BinaryColumn::append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    const auto& b = static_cast<const BinaryColumn&>(src);
+    const uint32_t* src_offsets = b._offsets.data();
+    const uint8_t* src_bytes = b._bytes.data();
+
+    size_t row = _offsets.size();
+    _offsets.resize_uninitialized(row + size);
+    uint32_t* dst_offsets = _offsets.data();
+    uint32_t pos = dst_offsets[row - 1];
+    for (uint32_t i = 0; i < size; ++i) {
+        uint32_t idx = indexes[from + i];
+        pos += src_offsets[idx + 1] - src_offsets[idx];
+        dst_offsets[row + i] = pos;
+    }
+
+    size_t byte_pos = _bytes.size();
+    _bytes.resize_uninitialized(pos);
+    uint8_t* dst = _bytes.data();
+    for (uint32_t i = 0; i < size; ++i) {
+        uint32_t idx = indexes[from + i];
+        uint32_t len = src_offsets[idx + 1] - src_offsets[idx];
+        memcpy(dst + byte_pos, src_bytes + src_offsets[idx], len);
+        byte_pos += len;
+    }
+}
+
+void BinaryColumn::append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) {
+    Slice value = static_cast<const BinaryColumn&>(src).get_slice(index);
+    _bytes.reserve(_bytes.size() + value.size * size);
+    for (uint32_t i = 0; i < size; ++i) {
+        append(value);
+    }
+}
+
+size_t BinaryColumn::filter_range(const Filter& filter, size_t from, size_t to) {
+    uint32_t* offsets = _offsets.data();
+    uint8_t* bytes = _bytes.data();
+    size_t result = from;
+    uint32_t write_pos = offsets[from];
+    for (size_t i = from; i < to; ++i) {
+        if (filter[i]) {
+            uint32_t begin = offsets[i];
+            uint32_t len = offsets[i + 1] - begin;
+            if (write_pos != begin) {
+                memmove(bytes + write_pos, bytes + begin, len);
+            }
+            write_pos += len;
+            // Writes never land past offsets[i + 1], which is only rewritten
+            // with its own value while no row has been dropped yet.
+            offsets[result + 1] = write_pos;
+            ++result;
+        }
+    }
+    _offsets.resize_uninitialized(result + 1);
+    _bytes.resize_uninitialized(write_pos);
+    return result;
+}
+
+} // namespace starrocks
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include "column/column.h"
+
+namespace starrocks {
+
+// Variable-length column. Values are stored back to back in |_bytes|; row i
+// spans [_offsets[i], _offsets[i + 1]). |_offsets| always has size() + 1
+// entries and starts with 0.
+class BinaryColumn final : public Column {
+public:
+    using Bytes = Buffer<uint8_t>;
+    using Offsets = Buffer<uint32_t>;
+    using Ptr = std::shared_ptr<BinaryColumn>;
+
+    explicit BinaryColumn(Arena* arena = nullptr) : _bytes(arena), _offsets(arena) { _offsets.push_back(0); }
+    BinaryColumn(Bytes&& bytes, Offsets&& offsets) : _bytes(std::move(bytes)), _offsets(std::move(offsets)) {}
+    BinaryColumn(const BinaryColumn& rhs) = default;
+
+    static Ptr create(Arena* arena = nullptr) { return std::make_shared<BinaryColumn>(arena); }
+
+    bool is_binary() const override { return true; }
+    const std::string get_name() const override { return "binary"; }
+
+    size_t size() const override { return _offsets.size() - 1; }
+    size_t type_size() const override { return 0; }
+    size_t byte_size(size_t from, size_t size) const override {
+        return _offsets[from + size] - _offsets[from] + size * sizeof(uint32_t);
+    }
+    size_t memory_usage() const override { return _bytes.allocated_bytes() + _offsets.allocated_bytes(); }
+
+    const uint8_t* raw_data() const override { return _bytes.data(); }
+    uint8_t* mutable_raw_data() override { return _bytes.data(); }
+    Arena* arena() const override { return _bytes.arena(); }
+
+    Bytes& get_bytes() { return _bytes; }
+    const Bytes& get_bytes() const { return _bytes; }
+    Offsets& get_offset() { return _offsets; }
+    const Offsets& get_offset() const { return _offsets; }
+
+    Slice get_slice(size_t idx) const {
+        return Slice(_bytes.data() + _offsets[idx], _offsets[idx + 1] - _offsets[idx]);
+    }
+
+    void reserve(size_t n) override { _offsets.reserve(n + 1); }
+    // Reserves |n| rows and |bytes| bytes of payload.
+    void reserve(size_t n, size_t bytes) {
+        _offsets.reserve(n + 1);
+        _bytes.reserve(bytes);
+    }
+    void resize(size_t n) override;
+
+    void assign(size_t n, size_t idx) override;
+
+    void append(const Slice& str) {
+        _bytes.append(reinterpret_cast<const uint8_t*>(str.data), str.size);
+        _offsets.push_back(static_cast<uint32_t>(_bytes.size()));
+    }
+    void append_string(std::string_view str) { append(Slice(str)); }
+    // Appends |count| slices in one pass.
+    void append_strings(const Slice* strs, size_t count);
+
+    void append_datum(const Datum& datum) override { append(datum.get_slice()); }
+    Datum get(size_t idx) const override { return Datum(get_slice(idx)); }
+
+    using Column::append;
+    void append(const Column& src, size_t offset, size_t count) override;
+    void append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) override;
+    void append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) override;
+    bool append_nulls(size_t /*count*/) override { return false; }
+    void append_default(size_t count) override { _offsets.resize(_offsets.size() + count, _offsets.back()); }
+
+    size_t filter_range(const Filter& filter, size_t from, size_t to) override;
+
+    ColumnPtr clone_empty() const override { return create(_bytes.arena()); }
+    ColumnPtr clone() const override { return std::make_shared<BinaryColumn>(*this); }
+
+    int compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const override {
+        return get_slice(left).compare(static_cast<const BinaryColumn&>(rhs).get_slice(right));
+    }
+
+    void reset_column() override {
+        _bytes.clear();
+        _offsets.resize(1);
+        _offsets[0] = 0;
+    }
+
+    void swap_column(Column& rhs) override {
+        auto& r = static_cast<BinaryColumn&>(rhs);
+        _bytes.swap(r._bytes);
+        _offsets.swap(r._offsets);
+    }
+
+    std::string debug_item(size_t idx) const override { return "'" + get_slice(idx).to_string() + "'"; }
+
+private:
+    Bytes _bytes;
+    Offsets _offsets;
+};
+
+} // namespace starrocks
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#include "common/compiler_util.h"
+#include "common/constexpr.h"
+#include "runtime/arena.h"
+#include "runtime/current_thread.h"
+
+namespace starrocks {
+
+// Buffer is the contiguous storage behind every column: a std::vector-like
+// container restricted to trivially copyable element types whose memory is
+// 64-byte aligned and, when an Arena is supplied, drawn from the per-query
+// arena instead of the global heap. Its memory is charged to the allocating
+// thread's MemTracker (see CurrentThread).
+//
+// Moving a Buffer only moves the pointer, which is what lets operators hand
+// whole chunks to the next pipeline stage without copying data.
+template <typename T>
+class Buffer {
+    static_assert(std::is_trivially_copyable_v<T>, "Buffer only holds trivially copyable types");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    Buffer() = default;
+    explicit Buffer(Arena* arena) : _arena(arena) {}
+    explicit Buffer(size_t n, Arena* arena = nullptr) : _arena(arena) { resize(n); }
+    Buffer(size_t n, const T& value, Arena* arena = nullptr) : _arena(arena) { resize(n, value); }
+    Buffer(std::initializer_list<T> values, Arena* arena = nullptr) : _arena(arena) {
+        append(values.begin(), values.size());
+    }
+
+    Buffer(const Buffer& rhs) : _arena(rhs._arena) { append(rhs.data(), rhs.size()); }
+    Buffer(Buffer&& rhs) noexcept : _data(rhs._data), _size(rhs._size), _capacity(rhs._capacity), _arena(rhs._arena) {
+        rhs._data = nullptr;
+        rhs._size = 0;
+        rhs._capacity = 0;
+    }
+
+    Buffer& operator=(const Buffer& rhs) {
+        if (this != &rhs) {
+            _size = 0;
+            append(rhs.data(), rhs.size());
+        }
+        return *this;
+    }
+
+    Buffer& operator=(Buffer&& rhs) noexcept {
+        if (this != &rhs) {
+            _release();
+            _data = rhs._data;
+            _size = rhs._size;
+            _capacity = rhs._capacity;
+            _arena = rhs._arena;
+            rhs._data = nullptr;
+            rhs._size = 0;
+            rhs._capacity = 0;
+        }
+        return *this;
+    }
+
+    ~Buffer() { _release(); }
+
+    Arena* arena() const { return _arena; }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _size == 0; }
+    size_t byte_size() const { return _size * sizeof(T); }
+    size_t allocated_bytes() const { return _capacity * sizeof(T); }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+    T* begin() { return _data; }
+    T* end() { return _data + _size; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+    T& operator[](size_t i) { return _data[i]; }
+    const T& operator[](size_t i) const { return _data[i]; }
+    T& back() { return _data[_size - 1]; }
+    const T& back() const { return _data[_size - 1]; }
+    T& front() { return _data[0]; }
+    const T& front() const { return _data[0]; }
+
+    void reserve(size_t n) {
+        if (n > _capacity) {
+            _grow_to(n);
+        }
+    }
+
+    // Resizes without initializing new elements; used by decoders and kernels
+    // that overwrite the whole range anyway.
+    void resize_uninitialized(size_t n) {
+        reserve(n);
+        _size = n;
+    }
+
+    void resize(size_t n) {
+        size_t old = _size;
+        resize_uninitialized(n);
+        if (n > old) {
+            memset(static_cast<void*>(_data + old), 0, (n - old) * sizeof(T));
+        }
+    }
+
+    void resize(size_t n, const T value) {
+        size_t old = _size;
+        resize_uninitialized(n);
+        if (n > old) {
+            std::fill(_data + old, _data + n, value);
+        }
+    }
+
+    void assign(size_t n, const T value) {
+        _size = 0;
+        resize(n, value);
+    }
+
+    ALWAYS_INLINE void push_back(const T value) {
+        if (UNLIKELY(_size == _capacity)) {
+            _grow_to(_size + 1);
+        }
+        _data[_size++] = value;
+    }
+
+    template <typename... Args>
+    ALWAYS_INLINE void emplace_back(Args&&... args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void pop_back() { --_size; }
+
+    void append(const T* values, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        reserve(_size + n);
+        memcpy(static_cast<void*>(_data + _size), values, n * sizeof(T));
+        _size += n;
+    }
+
+    template <typename Iter>
+    void insert(T* pos, Iter first, Iter last) {
+        size_t offset = pos - _data;
+        size_t n = std::distance(first, last);
+        reserve(_size + n);
+        memmove(static_cast<void*>(_data + offset + n), _data + offset, (_size - offset) * sizeof(T));
+        std::copy(first, last, _data + offset);
+        _size += n;
+    }
+
+    void erase(T* first, T* last) {
+        memmove(static_cast<void*>(first), last, (end() - last) * sizeof(T));
+        _size -= last - first;
+    }
+
+    void clear() { _size = 0; }
+
+    // Releases the storage back to the arena (or heap).
+    void shrink_to_empty() {
+        _release();
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+    void swap(Buffer& rhs) noexcept {
+        std::swap(_data, rhs._data);
+        std::swap(_size, rhs._size);
+        std::swap(_capacity, rhs._capacity);
+        std::swap(_arena, rhs._arena);
+    }
+
+private:
+    void _grow_to(size_t n) {
+        size_t new_cap = std::max({n, _capacity * 2, COLUMN_BUFFER_ALIGNMENT / sizeof(T)});
+        size_t new_bytes = new_cap * sizeof(T);
+        T* new_data;
+        if (_arena != nullptr) {
+            // Use the whole size class so the next growths are free.
+            new_bytes = Arena::alloc_size(new_bytes);
+            new_cap = new_bytes / sizeof(T);
+            new_data = static_cast<T*>(_arena->allocate(new_bytes));
+        } else {
+            new_bytes = (new_bytes + COLUMN_BUFFER_ALIGNMENT - 1) & ~(COLUMN_BUFFER_ALIGNMENT - 1);
+            new_cap = new_bytes / sizeof(T);
+            new_data = static_cast<T*>(std::aligned_alloc(COLUMN_BUFFER_ALIGNMENT, new_bytes));
+        }
+        if (UNLIKELY(new_data == nullptr)) {
+            throw std::bad_alloc();
+        }
+        if (_size > 0) {
+            memcpy(static_cast<void*>(new_data), _data, _size * sizeof(T));
+        }
+        _release();
+        _data = new_data;
+        _capacity = new_cap;
+        CurrentThread::mem_consume(_capacity * sizeof(T));
+    }
+
+    void _release() {
+        if (_data == nullptr) {
+            return;
+        }
+        CurrentThread::mem_release(_capacity * sizeof(T));
+        if (_arena != nullptr) {
+            _arena->free(_data, _capacity * sizeof(T));
+        } else {
+            std::free(_data);
+        }
+    }
+
+    T* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    Arena* _arena = nullptr;
+};
+
+} // namespace starrocks
@@ -0,0 +1,141 @@
+#include "column/chunk.h"
+
+#include <cassert>
+
+namespace starrocks {
+
+Chunk::Chunk(Columns columns, SlotHashMap slot_map)
+        : _columns(std::move(columns)), _slot_id_to_index(std::move(slot_map)) {}
+
+void Chunk::append_column(ColumnPtr column) {
+    assert(_columns.empty() || column->size() == num_rows());
+    _columns.emplace_back(std::move(column));
+}
+
+void Chunk::append_column(ColumnPtr column, SlotId slot_id) {
+    assert(!is_slot_exist(slot_id));
+    _slot_id_to_index[slot_id] = _columns.size();
+    append_column(std::move(column));
+}
+
+void Chunk::update_column(ColumnPtr column, SlotId slot_id) {
+    _columns[_slot_id_to_index.at(slot_id)] = std::move(column);
+}
+
+void Chunk::update_column_by_index(ColumnPtr column, size_t idx) {
+    _columns[idx] = std::move(column);
+}
+
+void Chunk::remove_column_by_index(size_t idx) {
+    _columns.erase(_columns.begin() + idx);
+    for (auto it = _slot_id_to_index.begin(); it != _slot_id_to_index.end();) {
+        if (it->second == idx) {
+            it = _slot_id_to_index.erase(it);
+            continue;
+        }
+        if (it->second > idx) {
+            it->second--;
+        }
+        ++it;
+    }
+}
+
+size_t Chunk::filter(const Filter& selection) {
+    return filter_range(selection, 0, selection.size());
+}
+
+size_t Chunk::filter_range(const Filter& selection, size_t from, size_t to) {
+    size_t result = 0;
+    for (auto& column : _columns) {
+        result = column->filter_range(selection, from, to);
+    }
+    return result;
+}
+
+void Chunk::append(const Chunk& src, size_t offset, size_t count) {
+    assert(num_columns() == src.num_columns());
+    for (size_t i = 0; i < _columns.size(); ++i) {
+        _columns[i]->append(*src._columns[i], offset, count);
+    }
+}
+
+void Chunk::append_selective(const Chunk& src, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    assert(num_columns() == src.num_columns());
+    for (size_t i = 0; i < _columns.size(); ++i) {
+        _columns[i]->append_selective(*src._columns[i], indexes, from, size);
+    }
+}
+
+ChunkUniquePtr Chunk::clone_empty(size_t reserve) const {
+    Columns columns;
+    columns.reserve(_columns.size());
+    for (const auto& column : _columns) {
+        auto c = column->clone_empty();
+        c->reserve(reserve);
+        columns.emplace_back(std::move(c));
+    }
+    auto chunk = std::make_unique<Chunk>(std::move(columns), _slot_id_to_index);
+    chunk->_owner_info = _owner_info;
+    return chunk;
+}
+
+ChunkUniquePtr Chunk::clone() const {
+    Columns columns;
+    columns.reserve(_columns.size());
+    for (const auto& column : _columns) {
+        columns.emplace_back(column->clone());
+    }
+    auto chunk = std::make_unique<Chunk>(std::move(columns), _slot_id_to_index);
+    chunk->_owner_info = _owner_info;
+    return chunk;
+}
+
+void Chunk::reset() {
+    for (auto& column : _columns) {
+        column->reset_column();
+    }
+}
+
+void Chunk::set_num_rows(size_t count) {
+    for (auto& column : _columns) {
+        column->resize(count);
+    }
+}
+
+size_t Chunk::bytes_usage() const {
+    size_t bytes = 0;
+    for (const auto& column : _columns) {
+        bytes += column->byte_size();
+    }
+    return bytes;
+}
+
+size_t Chunk::memory_usage() const {
+    size_t bytes = 0;
+    for (const auto& column : _columns) {
+        bytes += column->memory_usage();
+    }
+    return bytes;
+}
+
+void Chunk::unshare_columns() {
+    for (auto& column : _columns) {
+        if (column.use_count() > 1) {
+            column = column->clone();
+        }
+    }
+}
+
+std::string Chunk::debug_row(size_t index) const {
+    std::string res = "[";
+    for (size_t i = 0; i < _columns.size(); ++i) {
+        if (i > 0) {
+            res.append(", ");
+        }
+        res.append(_columns[i]->debug_item(index));
+    }
+    res.append("]");
+    return res;
+}
+
+} // namespace starrocks
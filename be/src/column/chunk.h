@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "column/column.h"
+#include "common/constexpr.h"
+
+namespace starrocks {
+
+// Chunk is the unit of data passed between operators: a set of equally sized
+// columns, usually around DEFAULT_CHUNK_SIZE rows. Columns are addressed by
+// position or by the SlotId of the plan slot they materialize.
+//
+// A chunk only holds shared pointers to its columns, so handing a chunk to the
+// next pipeline stage never copies column data.
+class Chunk {
+public:
+    using SlotHashMap = std::unordered_map<SlotId, size_t>;
+
+    Chunk() = default;
+    Chunk(Columns columns, SlotHashMap slot_map);
+    Chunk(Chunk&&) = default;
+    Chunk& operator=(Chunk&&) = default;
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    bool is_empty() const { return num_rows() == 0; }
+    size_t num_rows() const { return _columns.empty() ? 0 : _columns[0]->size(); }
+    size_t num_columns() const { return _columns.size(); }
+
+    // Appends a column that is not bound to a slot.
+    void append_column(ColumnPtr column);
+    void append_column(ColumnPtr column, SlotId slot_id);
+    void update_column(ColumnPtr column, SlotId slot_id);
+    void update_column_by_index(ColumnPtr column, size_t idx);
+    void remove_column_by_index(size_t idx);
+
+    bool is_slot_exist(SlotId slot_id) const { return _slot_id_to_index.count(slot_id) > 0; }
+    const ColumnPtr& get_column_by_index(size_t idx) const { return _columns[idx]; }
+    ColumnPtr& get_column_by_index(size_t idx) { return _columns[idx]; }
+    const ColumnPtr& get_column_by_slot_id(SlotId slot_id) const { return _columns[_slot_id_to_index.at(slot_id)]; }
+    ColumnPtr& get_column_by_slot_id(SlotId slot_id) { return _columns[_slot_id_to_index.at(slot_id)]; }
+    size_t get_index_by_slot_id(SlotId slot_id) const { return _slot_id_to_index.at(slot_id); }
+
+    const Columns& columns() const { return _columns; }
+    Columns& columns() { return _columns; }
+    const SlotHashMap& get_slot_id_to_index_map() const { return _slot_id_to_index; }
+
+    // Keeps the rows whose filter byte is non-zero in every column.
+    size_t filter(const Filter& selection);
+    size_t filter_range(const Filter& selection, size_t from, size_t to);
+
+    // Appends rows [offset, offset + count) of |src|, which must have the same layout.
+    void append(const Chunk& src, size_t offset, size_t count);
+    void append(const Chunk& src) { append(src, 0, src.num_rows()); }
+    void append_selective(const Chunk& src, const uint32_t* indexes, uint32_t from, uint32_t size);
+
+    // Returns an empty chunk with the same layout; |reserve| rows are reserved.
+    ChunkUniquePtr clone_empty(size_t reserve = 0) const;
+    ChunkUniquePtr clone() const;
+
+    // Clears the rows of every column, keeping their storage for reuse.
+    void reset();
+    void set_num_rows(size_t count);
+
+    size_t bytes_usage() const;
+    size_t memory_usage() const;
+
+    // Columns may be shared with other chunks; call this before mutating a
+    // chunk received from another operator.
+    void unshare_columns();
+
+    std::string debug_row(size_t index) const;
+
+    // Arbitrary per-chunk extra information (e.g. the tablet it was read from).
+    int64_t owner_info() const { return _owner_info; }
+    void set_owner_info(int64_t v) { _owner_info = v; }
+
+private:
+    Columns _columns;
+    SlotHashMap _slot_id_to_index;
+    int64_t _owner_info = -1;
+};
+
+} // namespace starrocks
@@ -0,0 +1,17 @@
+#include "column/column.h"
+
+namespace starrocks {
+
+std::string Column::debug_string() const {
+    std::string res = "[";
+    for (size_t i = 0; i < size(); ++i) {
+        if (i > 0) {
+            res.append(", ");
+        }
+        res.append(debug_item(i));
+    }
+    res.append("]");
+    return res;
+}
+
+} // namespace starrocks
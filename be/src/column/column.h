@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "column/datum.h"
+#include "column/vectorized_fwd.h"
+
+namespace starrocks {
+
+// Column is the in-memory representation of a run of values of a single type.
+//
+// Implementations:
+//   FixedLengthColumn<T> - contiguous array of a fixed-width type
+//   BinaryColumn         - variable-length bytes plus an offsets array
+//   NullableColumn       - any data column plus a one-byte-per-row null map
+//   ConstColumn          - one value logically repeated size() times
+//
+// All storage is held in 64-byte aligned Buffers, optionally drawn from a
+// per-query Arena. Columns are shared between operators through ColumnPtr;
+// an operator that wants to modify a column it did not create must clone it.
+class Column {
+public:
+    virtual ~Column() = default;
+
+    virtual bool is_nullable() const { return false; }
+    virtual bool is_constant() const { return false; }
+    virtual bool is_binary() const { return false; }
+    // True when every row is NULL.
+    virtual bool only_null() const { return false; }
+    virtual bool has_null() const { return false; }
+
+    virtual const std::string get_name() const = 0;
+
+    // Number of rows.
+    virtual size_t size() const = 0;
+    bool empty() const { return size() == 0; }
+
+    // Width of one value for fixed-length columns, 0 otherwise.
+    virtual size_t type_size() const = 0;
+
+    // Bytes used by the values (not the allocated capacity).
+    virtual size_t byte_size() const { return byte_size(0, size()); }
+    virtual size_t byte_size(size_t from, size_t size) const = 0;
+    // Bytes currently reserved by the column's buffers.
+    virtual size_t memory_usage() const = 0;
+
+    // Raw pointer to the first value of a fixed-length column.
+    virtual const uint8_t* raw_data() const = 0;
+    virtual uint8_t* mutable_raw_data() = 0;
+
+    virtual Arena* arena() const = 0;
+
+    virtual void reserve(size_t n) = 0;
+    virtual void resize(size_t n) = 0;
+    // Resizes without initializing new values.
+    virtual void resize_uninitialized(size_t n) { resize(n); }
+
+    // Replaces the contents with |n| copies of the value at |idx|.
+    virtual void assign(size_t n, size_t idx) = 0;
+
+    virtual void append_datum(const Datum& datum) = 0;
+    virtual Datum get(size_t idx) const = 0;
+
+    // Appends rows [offset, offset + count) of |src|, which must have the same type.
+    virtual void append(const Column& src, size_t offset, size_t count) = 0;
+    void append(const Column& src) { append(src, 0, src.size()); }
+
+    // Appends src[indexes[from]], ..., src[indexes[from + size - 1]].
+    virtual void append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) = 0;
+
+    // Appends src[index] |size| times.
+    virtual void append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) = 0;
+
+    // Appends |count| NULLs. Returns false if the column is not nullable.
+    [[nodiscard]] virtual bool append_nulls(size_t count) = 0;
+
+    // Appends |count| default (zero / empty) values.
+    virtual void append_default(size_t count) = 0;
+
+    // Keeps rows in [from, to) whose filter byte is non-zero, compacting them in
+    // place; rows past |to| are dropped. Returns the new size.
+    virtual size_t filter_range(const Filter& filter, size_t from, size_t to) = 0;
+    size_t filter(const Filter& filter) { return filter_range(filter, 0, filter.size()); }
+    size_t filter(const Filter& filter, size_t count) { return filter_range(filter, 0, count); }
+
+    // Returns a new empty column of the same type and arena.
+    virtual ColumnPtr clone_empty() const = 0;
+    virtual ColumnPtr clone() const = 0;
+
+    // Three-way comparison of this[left] with rhs[right]. |nan_direction_hint|
+    // is returned when exactly one side is NULL (1 puts NULLs last).
+    virtual int compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const = 0;
+
+    // Drops the values but keeps the reserved storage for reuse.
+    virtual void reset_column() = 0;
+
+    virtual void swap_column(Column& rhs) = 0;
+
+    virtual std::string debug_item(size_t idx) const = 0;
+    std::string debug_string() const;
+};
+
+} // namespace starrocks
@@ -0,0 +1,90 @@
+#include "column/column_helper.h"
+
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+ColumnPtr ColumnHelper::create_column(LogicalType type, bool nullable, Arena* arena) {
+    ColumnPtr data = type_dispatch_all(type, [arena](auto lt) -> ColumnPtr {
+        return RunTimeColumnType<decltype(lt)::value>::create(arena);
+    });
+    if (!nullable) {
+        return data;
+    }
+    return NullableColumn::create(std::move(data), NullColumn::create(arena));
+}
+
+ColumnPtr ColumnHelper::create_const_null_column(size_t size, LogicalType type) {
+    auto nullable = create_column(type, true);
+    (void)nullable->append_nulls(1);
+    return ConstColumn::create(std::move(nullable), size);
+}
+
+const Column* ColumnHelper::get_data_column(const Column* column) {
+    if (column->is_constant()) {
+        column = static_cast<const ConstColumn*>(column)->data_column().get();
+    }
+    if (column->is_nullable()) {
+        column = static_cast<const NullableColumn*>(column)->data_column().get();
+    }
+    return column;
+}
+
+Column* ColumnHelper::get_data_column(Column* column) {
+    return const_cast<Column*>(get_data_column(static_cast<const Column*>(column)));
+}
+
+ColumnPtr ColumnHelper::unfold_const_column(LogicalType type, size_t size, const ColumnPtr& column) {
+    if (!column->is_constant()) {
+        return column;
+    }
+    const auto& value = static_cast<const ConstColumn*>(column.get())->data_column();
+    ColumnPtr res = create_column(type, value->is_nullable(), value->arena());
+    res->append_value_multiple_times(*value, 0, static_cast<uint32_t>(size));
+    return res;
+}
+
+const NullData* ColumnHelper::get_null_data(const Column* column) {
+    if (!column->is_nullable()) {
+        return nullptr;
+    }
+    const auto* nullable = static_cast<const NullableColumn*>(column);
+    return nullable->has_null() ? &nullable->null_column_data() : nullptr;
+}
+
+size_t ColumnHelper::count_nulls(const ColumnPtr& column) {
+    if (column->is_constant()) {
+        return column->only_null() ? column->size() : 0;
+    }
+    const NullData* nulls = get_null_data(column.get());
+    return nulls == nullptr ? 0 : count_nonzero(nulls->data(), nulls->size());
+}
+
+ColumnPtr ColumnHelper::select_rows(const ColumnPtr& column, const uint32_t* indexes, size_t size) {
+    if (column->is_constant()) {
+        return ConstColumn::create(static_cast<const ConstColumn*>(column.get())->data_column(), size);
+    }
+    ColumnPtr res = column->clone_empty();
+    res->reserve(size);
+    res->append_selective(*column, indexes, 0, static_cast<uint32_t>(size));
+    return res;
+}
+
+bool ColumnHelper::is_all_const(const Columns& columns) {
+    for (const auto& column : columns) {
+        if (!column->is_constant()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ColumnHelper::count_nonzero(const Filter& filter) {
+    return count_nonzero(filter.data(), filter.size());
+}
+
+size_t ColumnHelper::count_nonzero(const uint8_t* data, size_t size) {
+    return simd::count_nonzero(data, size);
+}
+
+} // namespace starrocks
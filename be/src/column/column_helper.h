@@ -0,0 +1,67 @@
+#pragma once
+
+#include "column/binary_column.h"
+#include "column/chunk.h"
+#include "column/const_column.h"
+#include "column/fixed_length_column.h"
+#include "column/nullable_column.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+class ColumnHelper {
+public:
+    // Creates an empty column for |type|, wrapped in a NullableColumn when
+    // |nullable| is set. Buffers are drawn from |arena| when non-null.
+    static ColumnPtr create_column(LogicalType type, bool nullable, Arena* arena = nullptr);
+
+    // Creates a ConstColumn of |size| rows holding NULL.
+    static ColumnPtr create_const_null_column(size_t size, LogicalType type = TYPE_BOOLEAN);
+
+    template <LogicalType LT>
+    static ColumnPtr create_const_column(const RunTimeCppType<LT>& value, size_t size) {
+        auto data = RunTimeColumnType<LT>::create();
+        data->append(value);
+        return ConstColumn::create(std::move(data), size);
+    }
+
+    template <typename T>
+    static T* as_raw_column(const ColumnPtr& column) {
+        return static_cast<T*>(column.get());
+    }
+
+    template <LogicalType LT>
+    static RunTimeColumnType<LT>* cast_to_raw(const ColumnPtr& column) {
+        return static_cast<RunTimeColumnType<LT>*>(column.get());
+    }
+
+    template <LogicalType LT>
+    static const RunTimeCppType<LT>* get_cpp_data(const ColumnPtr& column) {
+        return reinterpret_cast<const RunTimeCppType<LT>*>(column->raw_data());
+    }
+
+    // Strips NullableColumn / ConstColumn wrappers.
+    static const Column* get_data_column(const Column* column);
+    static Column* get_data_column(Column* column);
+
+    // Materializes a ConstColumn into a full column of the same size; any other
+    // column is returned unchanged.
+    static ColumnPtr unfold_const_column(LogicalType type, size_t size, const ColumnPtr& column);
+
+    // Returns the null map of a nullable column, nullptr when there are no nulls.
+    static const NullData* get_null_data(const Column* column);
+
+    static size_t count_nulls(const ColumnPtr& column);
+
+    // A new column of the rows |indexes[0..size)| of |column|; a ConstColumn
+    // stays one.
+    static ColumnPtr select_rows(const ColumnPtr& column, const uint32_t* indexes, size_t size);
+
+    static bool is_all_const(const Columns& columns);
+
+    // Number of kept rows in |filter|.
+    static size_t count_nonzero(const Filter& filter);
+    static size_t count_nonzero(const uint8_t* data, size_t size);
+};
+
+} // namespace starrocks
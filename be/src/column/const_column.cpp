@@ -0,0 +1,62 @@
+#include "column/const_column.h"
+
+#include <cassert>
+
+namespace starrocks {
+
+ConstColumn::ConstColumn(ColumnPtr data, size_t size) : _data(std::move(data)), _size(size) {
+    assert(!_data->is_constant());
+    if (_data->size() > 1) {
+        _data->resize(1);
+    }
+}
+
+// Appending to a const column only makes sense for more copies of the same
+// value; the value of the appended rows is not checked.
+void ConstColumn::append_datum(const Datum& datum) {
+    if (_data->empty()) {
+        _data->append_datum(datum);
+    }
+    _size++;
+}
+
+void ConstColumn::append(const Column& src, size_t offset, size_t count) {
+    if (_data->empty()) {
+        const Column& value = src.is_constant() ? *static_cast<const ConstColumn&>(src)._data : src;
+        _data->append(value, src.is_constant() ? 0 : offset, 1);
+    }
+    _size += count;
+}
+
+void ConstColumn::append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    if (size > 0) {
+        append(src, indexes[from], 0);
+    }
+    _size += size;
+}
+
+void ConstColumn::append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) {
+    append(src, index, size);
+}
+
+bool ConstColumn::append_nulls(size_t count) {
+    if (!_data->is_nullable()) {
+        return false;
+    }
+    if (_data->empty()) {
+        (void)_data->append_nulls(1);
+    }
+    _size += count;
+    return true;
+}
+
+size_t ConstColumn::filter_range(const Filter& filter, size_t from, size_t to) {
+    size_t kept = 0;
+    for (size_t i = from; i < to; ++i) {
+        kept += (filter[i] != 0);
+    }
+    _size = from + kept;
+    return _size;
+}
+
+} // namespace starrocks
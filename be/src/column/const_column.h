@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+
+#include "column/column.h"
+
+namespace starrocks {
+
+// A single value logically repeated size() times. |_data| holds exactly one
+// row (possibly a NullableColumn holding NULL) regardless of size().
+class ConstColumn final : public Column {
+public:
+    using Ptr = std::shared_ptr<ConstColumn>;
+
+    ConstColumn(ColumnPtr data, size_t size);
+    ConstColumn(const ConstColumn& rhs) : _data(rhs._data->clone()), _size(rhs._size) {}
+
+    static Ptr create(ColumnPtr data, size_t size) { return std::make_shared<ConstColumn>(std::move(data), size); }
+
+    bool is_constant() const override { return true; }
+    bool is_nullable() const override { return false; }
+    bool is_binary() const override { return false; }
+    bool only_null() const override { return _data->only_null(); }
+    bool has_null() const override { return _data->has_null(); }
+    const std::string get_name() const override { return "const-" + _data->get_name(); }
+
+    size_t size() const override { return _size; }
+    size_t type_size() const override { return _data->type_size(); }
+    size_t byte_size(size_t /*from*/, size_t /*size*/) const override { return _data->byte_size(); }
+    size_t memory_usage() const override { return _data->memory_usage(); }
+
+    const uint8_t* raw_data() const override { return _data->raw_data(); }
+    uint8_t* mutable_raw_data() override { return _data->mutable_raw_data(); }
+    Arena* arena() const override { return _data->arena(); }
+
+    const ColumnPtr& data_column() const { return _data; }
+    ColumnPtr& data_column() { return _data; }
+
+    void reserve(size_t /*n*/) override {}
+    void resize(size_t n) override { _size = n; }
+    void assign(size_t n, size_t /*idx*/) override { _size = n; }
+
+    void append_datum(const Datum& datum) override;
+    Datum get(size_t /*idx*/) const override { return _data->get(0); }
+
+    using Column::append;
+    void append(const Column& src, size_t offset, size_t count) override;
+    void append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) override;
+    void append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) override;
+    bool append_nulls(size_t count) override;
+    void append_default(size_t count) override { _size += count; }
+
+    size_t filter_range(const Filter& filter, size_t from, size_t to) override;
+
+    ColumnPtr clone_empty() const override { return create(_data->clone_empty(), 0); }
+    ColumnPtr clone() const override { return std::make_shared<ConstColumn>(*this); }
+
+    int compare_at(size_t /*left*/, size_t right, const Column& rhs, int nan_direction_hint) const override {
+        return _data->compare_at(0, right, rhs, nan_direction_hint);
+    }
+
+    void reset_column() override { _size = 0; }
+
+    void swap_column(Column& rhs) override {
+        auto& r = static_cast<ConstColumn&>(rhs);
+        _data.swap(r._data);
+        std::swap(_size, r._size);
+    }
+
+    std::string debug_item(size_t /*idx*/) const override { return _data->debug_item(0); }
+
+private:
+    ColumnPtr _data;
+    size_t _size;
+};
+
+} // namespace starrocks
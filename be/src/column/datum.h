@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <variant>
+
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Datum is a single boxed cell. It exists for planning-time and per-group code
+// paths (constants, zone-map bounds, debugging); hot loops work on whole
+// columns instead.
+class Datum {
+public:
+    Datum() = default;
+
+    template <typename T>
+    Datum(T value) { // NOLINT
+        set(value);
+    }
+
+    bool is_null() const { return _value.index() == 0; }
+    void set_null() { _value = std::monostate(); }
+
+    template <typename T>
+    const T& get() const {
+        return std::get<T>(_value);
+    }
+
+    template <typename T>
+    void set(T value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            _value = static_cast<uint8_t>(value);
+        } else {
+            _value = value;
+        }
+    }
+
+    int8_t get_int8() const { return get<int8_t>(); }
+    uint8_t get_uint8() const { return get<uint8_t>(); }
+    int16_t get_int16() const { return get<int16_t>(); }
+    int32_t get_int32() const { return get<int32_t>(); }
+    int64_t get_int64() const { return get<int64_t>(); }
+    float get_float() const { return get<float>(); }
+    double get_double() const { return get<double>(); }
+    const Slice& get_slice() const { return get<Slice>(); }
+
+private:
+    std::variant<std::monostate, int8_t, uint8_t, int16_t, int32_t, uint32_t, int64_t, uint64_t, float, double, Slice>
+            _value;
+};
+
+} // namespace starrocks
@@ -0,0 +1,100 @@
+#include "column/fixed_length_column.h"
+
+#include <cmath>
+
+namespace starrocks {
+
+template <typename T>
+const std::string FixedLengthColumn<T>::get_name() const {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+        return "uint8";
+    } else if constexpr (std::is_same_v<T, int8_t>) {
+        return "int8";
+    } else if constexpr (std::is_same_v<T, int16_t>) {
+        return "int16";
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return "int32";
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+        return "uint32";
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return "int64";
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return "uint64";
+    } else if constexpr (std::is_same_v<T, float>) {
+        return "float";
+    } else {
+        return "double";
+    }
+}
+
+template <typename T>
+void FixedLengthColumn<T>::append(const Column& src, size_t offset, size_t count) {
+    const auto& src_data = static_cast<const FixedLengthColumn<T>&>(src)._data;
+    _data.append(src_data.data() + offset, count);
+}
+
+template <typename T>
+void FixedLengthColumn<T>::append_selective(const Column& src, const uint32_t* indexes, uint32_t from,
+                                            uint32_t size) {
+    const T* src_data = static_cast<const FixedLengthColumn<T>&>(src)._data.data();
+    size_t orig = _data.size();
+    _data.resize_uninitialized(orig + size);
+    T* dst = _data.data() + orig;
+    for (uint32_t i = 0; i < size; ++i) {
+        dst[i] = src_data[indexes[from + i]];
+    }
+}
+
+template <typename T>
+void FixedLengthColumn<T>::append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) {
+    T value = static_cast<const FixedLengthColumn<T>&>(src)._data[index];
+    _data.resize(_data.size() + size, value);
+}
+
+template <typename T>
+size_t FixedLengthColumn<T>::filter_range(const Filter& filter, size_t from, size_t to) {
+    T* data = _data.data();
+    size_t result = from;
+    for (size_t i = from; i < to; ++i) {
+        // Branch-free compaction: always write, advance only on keep.
+        data[result] = data[i];
+        result += (filter[i] != 0);
+    }
+    _data.resize_uninitialized(result);
+    return result;
+}
+
+template <typename T>
+int FixedLengthColumn<T>::compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const {
+    T x = _data[left];
+    T y = static_cast<const FixedLengthColumn<T>&>(rhs)._data[right];
+    if constexpr (std::is_floating_point_v<T>) {
+        bool x_nan = std::isnan(x);
+        bool y_nan = std::isnan(y);
+        if (x_nan || y_nan) {
+            return x_nan && y_nan ? 0 : (x_nan ? nan_direction_hint : -nan_direction_hint);
+        }
+    }
+    return x < y ? -1 : (x == y ? 0 : 1);
+}
+
+template <typename T>
+std::string FixedLengthColumn<T>::debug_item(size_t idx) const {
+    if constexpr (sizeof(T) == 1) {
+        return std::to_string(static_cast<int>(_data[idx]));
+    } else {
+        return std::to_string(_data[idx]);
+    }
+}
+
+template class FixedLengthColumn<uint8_t>;
+template class FixedLengthColumn<int8_t>;
+template class FixedLengthColumn<int16_t>;
+template class FixedLengthColumn<int32_t>;
+template class FixedLengthColumn<uint32_t>;
+template class FixedLengthColumn<int64_t>;
+template class FixedLengthColumn<uint64_t>;
+template class FixedLengthColumn<float>;
+template class FixedLengthColumn<double>;
+
+} // namespace starrocks
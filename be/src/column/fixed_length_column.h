@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+
+#include "column/column.h"
+
+namespace starrocks {
+
+// Column of a fixed-width arithmetic type backed by a single aligned buffer.
+template <typename T>
+class FixedLengthColumn final : public Column {
+public:
+    using ValueType = T;
+    using Container = Buffer<T>;
+    using Ptr = std::shared_ptr<FixedLengthColumn<T>>;
+
+    explicit FixedLengthColumn(Arena* arena = nullptr) : _data(arena) {}
+    FixedLengthColumn(size_t n, Arena* arena = nullptr) : _data(n, arena) {}
+    FixedLengthColumn(size_t n, T value, Arena* arena = nullptr) : _data(n, value, arena) {}
+    explicit FixedLengthColumn(Container&& data) : _data(std::move(data)) {}
+
+    static Ptr create(Arena* arena = nullptr) { return std::make_shared<FixedLengthColumn<T>>(arena); }
+    static Ptr create(size_t n, Arena* arena = nullptr) { return std::make_shared<FixedLengthColumn<T>>(n, arena); }
+    static Ptr create(size_t n, T value, Arena* arena = nullptr) {
+        return std::make_shared<FixedLengthColumn<T>>(n, value, arena);
+    }
+
+    const std::string get_name() const override;
+
+    size_t size() const override { return _data.size(); }
+    size_t type_size() const override { return sizeof(T); }
+    size_t byte_size(size_t /*from*/, size_t size) const override { return size * sizeof(T); }
+    size_t memory_usage() const override { return _data.allocated_bytes(); }
+
+    const uint8_t* raw_data() const override { return reinterpret_cast<const uint8_t*>(_data.data()); }
+    uint8_t* mutable_raw_data() override { return reinterpret_cast<uint8_t*>(_data.data()); }
+    Arena* arena() const override { return _data.arena(); }
+
+    Container& get_data() { return _data; }
+    const Container& get_data() const { return _data; }
+
+    void reserve(size_t n) override { _data.reserve(n); }
+    void resize(size_t n) override { _data.resize(n); }
+    void resize_uninitialized(size_t n) override { _data.resize_uninitialized(n); }
+
+    void assign(size_t n, size_t idx) override { _data.assign(n, _data[idx]); }
+
+    void append(const T value) { _data.push_back(value); }
+    void append_numbers(const T* values, size_t count) { _data.append(values, count); }
+
+    void append_datum(const Datum& datum) override { _data.push_back(datum.get<T>()); }
+    Datum get(size_t idx) const override { return Datum(_data[idx]); }
+
+    using Column::append;
+    void append(const Column& src, size_t offset, size_t count) override;
+    void append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) override;
+    void append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) override;
+    bool append_nulls(size_t /*count*/) override { return false; }
+    void append_default(size_t count) override { _data.resize(_data.size() + count); }
+
+    size_t filter_range(const Filter& filter, size_t from, size_t to) override;
+
+    ColumnPtr clone_empty() const override { return create(_data.arena()); }
+    ColumnPtr clone() const override { return std::make_shared<FixedLengthColumn<T>>(*this); }
+
+    int compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const override;
+
+    void reset_column() override { _data.clear(); }
+    void swap_column(Column& rhs) override { _data.swap(static_cast<FixedLengthColumn<T>&>(rhs)._data); }
+
+    std::string debug_item(size_t idx) const override;
+
+private:
+    Container _data;
+};
+
+extern template class FixedLengthColumn<uint8_t>;
+extern template class FixedLengthColumn<int8_t>;
+extern template class FixedLengthColumn<int16_t>;
+extern template class FixedLengthColumn<int32_t>;
+extern template class FixedLengthColumn<uint32_t>;
+extern template class FixedLengthColumn<int64_t>;
+extern template class FixedLengthColumn<uint64_t>;
+extern template class FixedLengthColumn<float>;
+extern template class FixedLengthColumn<double>;
+
+} // namespace starrocks
@@ -0,0 +1,108 @@
+#include "column/nullable_column.h"
+
+#include <algorithm>
+
+namespace starrocks {
+
+NullableColumn::NullableColumn(ColumnPtr data_column, NullColumnPtr null_column)
+        : _data_column(std::move(data_column)), _null_column(std::move(null_column)) {
+    update_has_null();
+}
+
+NullableColumn::NullableColumn(const NullableColumn& rhs)
+        : _data_column(rhs._data_column->clone()),
+          _null_column(std::static_pointer_cast<NullColumn>(rhs._null_column->clone())),
+          _has_null(rhs._has_null) {}
+
+bool NullableColumn::update_has_null() {
+    const auto& nulls = _null_column->get_data();
+    _has_null = std::any_of(nulls.begin(), nulls.end(), [](uint8_t v) { return v != 0; });
+    return _has_null;
+}
+
+bool NullableColumn::only_null() const {
+    if (!_has_null) {
+        return false;
+    }
+    const auto& nulls = _null_column->get_data();
+    return std::all_of(nulls.begin(), nulls.end(), [](uint8_t v) { return v != 0; });
+}
+
+void NullableColumn::append_datum(const Datum& datum) {
+    if (datum.is_null()) {
+        (void)append_nulls(1);
+    } else {
+        _data_column->append_datum(datum);
+        _null_column->append(0);
+    }
+}
+
+void NullableColumn::append(const Column& src, size_t offset, size_t count) {
+    if (src.is_nullable()) {
+        const auto& n = static_cast<const NullableColumn&>(src);
+        _data_column->append(*n._data_column, offset, count);
+        _null_column->append(*n._null_column, offset, count);
+        _has_null = _has_null || n._has_null;
+    } else {
+        _data_column->append(src, offset, count);
+        _null_column->append_default(count);
+    }
+}
+
+void NullableColumn::append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    if (src.is_nullable()) {
+        const auto& n = static_cast<const NullableColumn&>(src);
+        _data_column->append_selective(*n._data_column, indexes, from, size);
+        _null_column->append_selective(*n._null_column, indexes, from, size);
+        _has_null = _has_null || n._has_null;
+    } else {
+        _data_column->append_selective(src, indexes, from, size);
+        _null_column->append_default(size);
+    }
+}
+
+void NullableColumn::append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) {
+    if (src.is_nullable()) {
+        const auto& n = static_cast<const NullableColumn&>(src);
+        _data_column->append_value_multiple_times(*n._data_column, index, size);
+        _null_column->append_value_multiple_times(*n._null_column, index, size);
+        _has_null = _has_null || n.is_null(index);
+    } else {
+        _data_column->append_value_multiple_times(src, index, size);
+        _null_column->append_default(size);
+    }
+}
+
+bool NullableColumn::append_nulls(size_t count) {
+    _data_column->append_default(count);
+    _null_column->get_data().resize(_null_column->size() + count, 1);
+    _has_null = true;
+    return true;
+}
+
+size_t NullableColumn::filter_range(const Filter& filter, size_t from, size_t to) {
+    _data_column->filter_range(filter, from, to);
+    size_t new_size = _null_column->filter_range(filter, from, to);
+    if (_has_null) {
+        update_has_null();
+    }
+    return new_size;
+}
+
+int NullableColumn::compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const {
+    bool lhs_null = is_null(left);
+    if (rhs.is_nullable()) {
+        const auto& r = static_cast<const NullableColumn&>(rhs);
+        bool rhs_null = r.is_null(right);
+        if (lhs_null || rhs_null) {
+            return lhs_null && rhs_null ? 0 : (lhs_null ? nan_direction_hint : -nan_direction_hint);
+        }
+        return _data_column->compare_at(left, right, *r._data_column, nan_direction_hint);
+    }
+    if (lhs_null) {
+        return nan_direction_hint;
+    }
+    return _data_column->compare_at(left, right, rhs, nan_direction_hint);
+}
+
+} // namespace starrocks
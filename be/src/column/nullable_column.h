@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory>
+
+#include "column/column.h"
+#include "column/fixed_length_column.h"
+
+namespace starrocks {
+
+// Wraps a data column with a null map. The data column always has the same
+// number of rows as the null map; NULL rows hold a default value so kernels
+// can process the data column without branching on nulls.
+class NullableColumn final : public Column {
+public:
+    using Ptr = std::shared_ptr<NullableColumn>;
+
+    NullableColumn(ColumnPtr data_column, NullColumnPtr null_column);
+    NullableColumn(const NullableColumn& rhs);
+
+    static Ptr create(ColumnPtr data_column, NullColumnPtr null_column) {
+        return std::make_shared<NullableColumn>(std::move(data_column), std::move(null_column));
+    }
+
+    bool is_nullable() const override { return true; }
+    bool is_binary() const override { return _data_column->is_binary(); }
+    bool has_null() const override { return _has_null; }
+    bool only_null() const override;
+    const std::string get_name() const override { return "nullable-" + _data_column->get_name(); }
+
+    size_t size() const override { return _null_column->size(); }
+    size_t type_size() const override { return _data_column->type_size() + sizeof(uint8_t); }
+    size_t byte_size(size_t from, size_t size) const override {
+        return _data_column->byte_size(from, size) + size * sizeof(uint8_t);
+    }
+    size_t memory_usage() const override { return _data_column->memory_usage() + _null_column->memory_usage(); }
+
+    const uint8_t* raw_data() const override { return _data_column->raw_data(); }
+    uint8_t* mutable_raw_data() override { return _data_column->mutable_raw_data(); }
+    Arena* arena() const override { return _data_column->arena(); }
+
+    bool is_null(size_t idx) const { return _has_null && _null_column->get_data()[idx]; }
+
+    const ColumnPtr& data_column() const { return _data_column; }
+    ColumnPtr& data_column() { return _data_column; }
+    const NullColumnPtr& null_column() const { return _null_column; }
+    NullColumnPtr& null_column() { return _null_column; }
+    NullData& null_column_data() { return _null_column->get_data(); }
+    const NullData& null_column_data() const { return _null_column->get_data(); }
+
+    // Callers that write the null map directly must refresh the flag.
+    void set_has_null(bool has_null) { _has_null = _has_null | has_null; }
+    bool update_has_null();
+
+    void reserve(size_t n) override {
+        _data_column->reserve(n);
+        _null_column->reserve(n);
+    }
+    void resize(size_t n) override {
+        _data_column->resize(n);
+        _null_column->resize(n);
+    }
+    void resize_uninitialized(size_t n) override {
+        _data_column->resize_uninitialized(n);
+        _null_column->resize_uninitialized(n);
+    }
+
+    void assign(size_t n, size_t idx) override {
+        _data_column->assign(n, idx);
+        _null_column->assign(n, idx);
+        update_has_null();
+    }
+
+    void append_datum(const Datum& datum) override;
+    Datum get(size_t idx) const override { return is_null(idx) ? Datum() : _data_column->get(idx); }
+
+    using Column::append;
+    void append(const Column& src, size_t offset, size_t count) override;
+    void append_selective(const Column& src, const uint32_t* indexes, uint32_t from, uint32_t size) override;
+    void append_value_multiple_times(const Column& src, uint32_t index, uint32_t size) override;
+    bool append_nulls(size_t count) override;
+    void append_default(size_t count) override { (void)append_nulls(count); }
+
+    size_t filter_range(const Filter& filter, size_t from, size_t to) override;
+
+    ColumnPtr clone_empty() const override {
+        return create(_data_column->clone_empty(), NullColumn::create(_null_column->arena()));
+    }
+    ColumnPtr clone() const override { return std::make_shared<NullableColumn>(*this); }
+
+    int compare_at(size_t left, size_t right, const Column& rhs, int nan_direction_hint) const override;
+
+    void reset_column() override {
+        _data_column->reset_column();
+        _null_column->reset_column();
+        _has_null = false;
+    }
+
+    void swap_column(Column& rhs) override {
+        auto& r = static_cast<NullableColumn&>(rhs);
+        _data_column->swap_column(*r._data_column);
+        _null_column->swap_column(*r._null_column);
+        std::swap(_has_null, r._has_null);
+    }
+
+    std::string debug_item(size_t idx) const override {
+        return is_null(idx) ? "NULL" : _data_column->debug_item(idx);
+    }
+
+private:
+    ColumnPtr _data_column;
+    NullColumnPtr _null_column;
+    bool _has_null = false;
+};
+
+} // namespace starrocks
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "column/buffer.h"
+
+namespace starrocks {
+
+class Arena;
+class Column;
+class Chunk;
+class NullableColumn;
+class ConstColumn;
+class BinaryColumn;
+
+template <typename T>
+class FixedLengthColumn;
+
+using ColumnPtr = std::shared_ptr<Column>;
+using Columns = std::vector<ColumnPtr>;
+using ChunkPtr = std::shared_ptr<Chunk>;
+using ChunkUniquePtr = std::unique_ptr<Chunk>;
+
+using BooleanColumn = FixedLengthColumn<uint8_t>;
+using Int8Column = FixedLengthColumn<int8_t>;
+using UInt8Column = FixedLengthColumn<uint8_t>;
+using Int16Column = FixedLengthColumn<int16_t>;
+using Int32Column = FixedLengthColumn<int32_t>;
+using UInt32Column = FixedLengthColumn<uint32_t>;
+using Int64Column = FixedLengthColumn<int64_t>;
+using UInt64Column = FixedLengthColumn<uint64_t>;
+using FloatColumn = FixedLengthColumn<float>;
+using DoubleColumn = FixedLengthColumn<double>;
+using DateColumn = FixedLengthColumn<int32_t>;
+using TimestampColumn = FixedLengthColumn<int64_t>;
+
+// One byte per row, 1 means NULL.
+using NullColumn = UInt8Column;
+using NullData = Buffer<uint8_t>;
+using NullColumnPtr = std::shared_ptr<NullColumn>;
+
+// One byte per row, 1 means the row is kept.
+using Filter = Buffer<uint8_t>;
+using FilterPtr = std::shared_ptr<Filter>;
+
+using SlotId = int32_t;
+
+} // namespace starrocks
@@ -0,0 +1,22 @@
+#pragma once
+
+#define LIKELY(expr) __builtin_expect(!!(expr), 1)
+#define UNLIKELY(expr) __builtin_expect(!!(expr), 0)
+
+#define ALWAYS_INLINE __attribute__((always_inline)) inline
+#define NO_INLINE __attribute__((noinline))
+
+#define PREFETCH(addr) __builtin_prefetch(addr)
+
+// Width of a cache line on every platform we target.
+#define CACHE_LINE_SIZE 64
+#define CACHE_LINE_ALIGNED alignas(CACHE_LINE_SIZE)
+
+#define DISALLOW_COPY(TypeName)             \
+    TypeName(const TypeName&) = delete;     \
+    TypeName& operator=(const TypeName&) = delete
+
+#define DISALLOW_COPY_AND_MOVE(TypeName)    \
+    DISALLOW_COPY(TypeName);                \
+    TypeName(TypeName&&) = delete;          \
+    TypeName& operator=(TypeName&&) = delete
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace starrocks::config {
+
+// Process-wide tunables. Values are read at the point of use, so changing one
+// at startup (before ExecEnv::init) affects every component that consults it.
+
+// ---- pipeline engine ----
+// Worker threads driving pipeline drivers; 0 means one per core.
+inline int32_t pipeline_exec_thread_pool_thread_num = 0;
+// A driver yields its worker after running this long in one schedule...
+inline int64_t pipeline_yield_max_time_spent_ns = 100'000'000;
+// ...or after moving this many chunks, whichever comes first.
+inline int32_t pipeline_yield_max_chunks_moved = 100;
+// Upper bound on how long the poller sleeps between checks of blocked drivers.
+inline int32_t pipeline_poller_max_interval_us = 1000;
+
+// ---- scan ----
+// Threads serving asynchronous scan I/O tasks; 0 means two per core.
+inline int32_t scan_io_thread_num = 0;
+// Rows covered by one morsel when a scan range is split.
+inline int64_t scan_morsel_rows = 65536;
+// Concurrent I/O tasks (each reading its own morsel) per scan operator.
+inline int32_t scan_max_io_tasks_per_operator = 2;
+// A scan operator stops issuing I/O once this many chunks are buffered.
+inline int32_t scan_chunk_buffer_limit = 8;
+// Chunks read by one I/O task before it gives the thread back.
+inline int32_t scan_io_task_batch_chunks = 4;
+// Bytes of pages an I/O task reads ahead asynchronously (see AsyncIoEngine)
+// for the chunks its source decodes next; 0 makes scans read each page when
+// they decode it.
+inline int64_t scan_read_ahead_bytes = 8L * 1024 * 1024;
+
+// ---- async I/O ----
+// Asynchronous reads go through io_uring when the kernel supports it, and
+// through a thread pool otherwise or when this is false.
+inline bool enable_io_uring = true;
+// Reads one io_uring instance keeps in flight; further ones wait in the engine.
+inline int32_t io_uring_queue_depth = 256;
+// Threads of the thread-pool fallback; 0 means four per core.
+inline int32_t async_io_thread_num = 0;
+
+// ---- hash join ----
+// Target size of one radix partition of a join hash table; 0 means half of the
+// L2 cache. Builds whose table exceeds it are split so each partition's slots
+// stay cache resident while it is built and probed.
+inline int64_t join_hash_table_partition_bytes = 0;
+// Upper bound on the number of radix partitions of one join hash table.
+inline int32_t join_hash_table_max_partitions = 1024;
+
+// ---- runtime filter ----
+// A join key with at most this many distinct build values is published to the
+// probe-side scans as an exact IN-set, a larger one as a bloom filter.
+inline int32_t runtime_filter_in_max_values = 1024;
+// Bits per build value of a bloom runtime filter, and the cap on its size.
+inline int32_t runtime_filter_bloom_bits_per_value = 16;
+inline int64_t runtime_filter_bloom_max_bytes = 16L * 1024 * 1024;
+// Scans wait this long for the runtime filters they apply before reading
+// unfiltered.
+inline int64_t runtime_filter_wait_timeout_ms = 1000;
+// Threads delivering runtime filters to other fragment instances.
+inline int32_t runtime_filter_worker_thread_num = 2;
+
+// ---- aggregation ----
+// A streaming pre-aggregation whose hash table has outgrown this many bytes
+// (0 means the L2 cache size) keeps aggregating only while each group
+// absorbs at least streaming_agg_min_reduction input rows on average.
+inline int64_t streaming_agg_hash_table_bytes = 0;
+inline double streaming_agg_min_reduction = 2.0;
+// Input chunks a pre-aggregation passes through after giving up on
+// aggregating, before it measures its reduction again.
+inline int32_t streaming_agg_pass_through_chunks = 64;
+
+// ---- sort ----
+// A sort driver sorts what it has buffered into a run once it holds this many
+// bytes; the runs of all drivers are merged at the end.
+inline int64_t sort_max_buffered_bytes = 256L * 1024 * 1024;
+// ORDER BY ... LIMIT keeps the first rows in a heap instead of sorting
+// everything as long as LIMIT plus OFFSET is at most this many rows.
+inline int64_t sort_topn_max_rows = 65536;
+
+// ---- expressions ----
+// A CASE branch, or the right side of AND and OR, needed by at most this
+// fraction of the rows of a chunk is evaluated over a copy of just those rows
+// rather than over all of them.
+inline double expr_selective_eval_ratio = 0.3;
+
+// ---- memory and spill ----
+// Memory limit of the whole process in bytes; 0 means 90% of physical memory.
+inline int64_t mem_limit = 0;
+// Default memory budget of one query in bytes; 0 means unlimited.
+inline int64_t query_mem_limit = 0;
+// New queries are rejected while the process uses more than this fraction of
+// its memory limit.
+inline double query_admission_mem_ratio = 0.9;
+// Bytes a thread may allocate or free before its memory tracker is updated.
+// Larger batches mean less contention on the trackers and staler counters.
+inline int64_t mem_tracker_thread_cache_bytes = 1L * 1024 * 1024;
+// Operators holding large state (hash tables, sort runs) spill to disk instead
+// of failing when the query goes over its budget.
+inline bool enable_spill = true;
+// Spilling starts once a query uses this fraction of its memory budget.
+inline double spill_mem_limit_threshold = 0.8;
+// Directory for spill files; each query spills into its own subdirectory.
+inline std::string spill_local_storage_dir = "/tmp/starrocks_spill";
+// Threads writing and reading spill files; 0 means one per core.
+inline int32_t spill_io_thread_num = 0;
+// Partitions a spilling hash join splits its input into.
+inline int32_t spill_hash_join_partitions = 16;
+// Partitions a spilling hash aggregation splits its groups into.
+inline int32_t spill_aggregate_partitions = 16;
+// Serialized bytes queued for asynchronous spill writes before the spilling
+// operator stops taking input.
+inline int64_t spill_max_pending_bytes = 64L * 1024 * 1024;
+// 0 = none, 1 = LZ4 (see CompressionType).
+inline int32_t spill_compression = 1;
+
+// ---- storage ----
+// Target uncompressed size of one column page of a segment file.
+inline int64_t segment_page_size_bytes = 64 * 1024;
+// Page compression of new segment files: 0 = none, 1 = LZ4 (see CompressionType).
+inline int32_t segment_compression = 1;
+// A VARCHAR column stops dictionary-encoding new pages once its dictionary
+// holds this many bytes...
+inline int64_t segment_dict_max_bytes = 1L * 1024 * 1024;
+// ...or if more than this fraction of the rows of its first page are distinct.
+inline double segment_dict_max_distinct_ratio = 0.6;
+// VARCHAR columns with more distinct values than this across a table get no
+// global dictionary (see GlobalDictionary).
+inline int32_t global_dict_max_words = 65535;
+
+// ---- primary key tables ----
+// Keep most of a primary index on disk, holding only its recent changes and
+// one offset per page in memory (see PrimaryIndex).
+inline bool enable_persistent_index = true;
+// The in-memory part of a persistent primary index is merged into the
+// on-disk part once it takes more memory than this.
+inline int64_t primary_index_l0_max_bytes = 64L * 1024 * 1024;
+// Target size of one page (hash bucket) of the on-disk part.
+inline int64_t primary_index_page_bytes = 4096;
+
+// ---- compaction ----
+// Compactions running at once, each on a thread of its own.
+inline int32_t compaction_max_concurrency = 2;
+// Shared by the running compactions.
+inline int64_t compaction_memory_limit_bytes = 512L * 1024 * 1024;
+// Disk bandwidth compactions may take together, reads and writes; 0 = no cap.
+inline int64_t compaction_io_bytes_per_second = 100L * 1024 * 1024;
+inline int64_t compaction_check_interval_ms = 1000;
+// Size a compaction's output is aimed at; segments below a quarter of it are
+// small enough to merge.
+inline int64_t compaction_target_segment_bytes = 256L * 1024 * 1024;
+inline int32_t compaction_min_input_segments = 5;
+inline int32_t compaction_max_input_segments = 100;
+// Segments with more of their rows deleted are rewritten, even alone.
+inline double compaction_delete_ratio_threshold = 0.3;
+
+// ---- materialized views ----
+// Views refreshed at once, each on a thread of its own.
+inline int32_t mv_refresh_thread_num = 2;
+// How often views are checked for changes of their base tables.
+inline int64_t mv_refresh_check_interval_ms = 1000;
+
+// ---- query cache ----
+// Cache the per-partition partial aggregates of queries (see QueryCache).
+inline bool query_cache_enable = true;
+inline int64_t query_cache_capacity = 512L * 1024 * 1024;
+// Partial results of one partition larger than this are not cached: a
+// GROUP BY of about as many groups as rows gains little from them.
+inline int64_t query_cache_entry_max_bytes = 4L * 1024 * 1024;
+
+// ---- optimizer ----
+// Values of a column sampled for its histogram when statistics are
+// collected.
+inline int64_t optimizer_statistics_sample_rows = 20000;
+inline int32_t optimizer_histogram_buckets = 64;
+// Joins of up to this many tables are ordered by dynamic programming over
+// every connected subset of them; larger ones greedily.
+inline int32_t optimizer_dp_join_reorder_max_tables = 12;
+// Backends a query's joins are spread over: a broadcast join sends its build
+// side to each of them.
+inline int32_t optimizer_num_backends = 3;
+
+// ---- stream load ----
+// Threads parsing loaded text; 0 means one per core.
+inline int32_t stream_load_parse_thread_num = 0;
+// Loaded text is cut into blocks of about this size, at record boundaries,
+// each parsed by one thread.
+inline int64_t stream_load_block_bytes = 4L * 1024 * 1024;
+// Threads writing the memtables of loads out as segments.
+inline int32_t memtable_flush_thread_num = 2;
+// A tablet's memtable is flushed once it takes this much memory.
+inline int64_t write_buffer_size = 100L * 1024 * 1024;
+// Memtables of one tablet flushing at once before the load feeding it waits.
+inline int32_t memtable_max_flushing = 2;
+
+// ---- block cache ----
+// Cache blocks of lake table objects read from object storage locally.
+inline bool block_cache_enable = true;
+// Bytes of cached blocks held in memory.
+inline int64_t block_cache_mem_size = 512L * 1024 * 1024;
+// Bytes of cached blocks kept on local disk (SSD) once evicted from memory; 0
+// disables the disk tier.
+inline int64_t block_cache_disk_size = 0;
+inline std::string block_cache_disk_path = "/tmp/starrocks_block_cache";
+inline int64_t block_cache_block_size = 1024 * 1024;
+// Blocks are evicted by their K-th most recent reference (LRU-K), so that
+// blocks read once by a large scan go before the ones queries keep rereading.
+inline int32_t block_cache_lru_k = 2;
+// Reads of one block closer together than this count as a single reference.
+inline int64_t block_cache_correlated_reference_period_ms = 1000;
+
+// ---- local exchange ----
+// Chunks buffered per local exchange before its sinks block.
+inline int32_t local_exchange_buffer_chunks = 16;
+
+// ---- exchange ----
+// A sender batches the rows for one destination until their serialized size
+// reaches this, so small chunks do not each pay for a packet.
+inline int64_t exchange_batch_bytes = 256 * 1024;
+// Serialized bytes a receiver queues before the senders feeding it block.
+inline int64_t exchange_receiver_buffer_bytes = 16L * 1024 * 1024;
+// 0 = none, 1 = LZ4 (see CompressionType).
+inline int32_t exchange_compression = 1;
+
+} // namespace starrocks::config
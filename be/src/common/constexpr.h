@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+namespace starrocks {
+
+// Default number of rows in a Chunk. Sized so that the working set of a few
+// fixed-width columns stays cache resident while an operator processes it.
+constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+// Alignment of every column buffer; matches a cache line and the widest vector
+// register (AVX-512) so kernels can use aligned loads on the buffer head.
+constexpr size_t COLUMN_BUFFER_ALIGNMENT = 64;
+
+} // namespace starrocks
@@ -0,0 +1,56 @@
+#include "common/status.h"
+
+namespace starrocks {
+
+static const char* code_name(Status::Code code) {
+    switch (code) {
+    case Status::kOk:
+        return "OK";
+    case Status::kInvalidArgument:
+        return "Invalid argument";
+    case Status::kNotFound:
+        return "Not found";
+    case Status::kAlreadyExist:
+        return "Already exist";
+    case Status::kCorruption:
+        return "Corruption";
+    case Status::kIOError:
+        return "IO error";
+    case Status::kMemoryLimitExceeded:
+        return "Memory limit exceeded";
+    case Status::kNotSupported:
+        return "Not supported";
+    case Status::kInternalError:
+        return "Internal error";
+    case Status::kEndOfFile:
+        return "End of file";
+    case Status::kCancelled:
+        return "Cancelled";
+    case Status::kTimedOut:
+        return "Timed out";
+    case Status::kResourceBusy:
+        return "Resource busy";
+    }
+    return "Unknown";
+}
+
+Status Status::clone_and_prepend(std::string_view ctx) const {
+    if (ok()) {
+        return *this;
+    }
+    std::string msg(ctx);
+    msg.append(": ");
+    msg.append(_state->msg);
+    return Status(_state->code, msg);
+}
+
+std::string Status::to_string() const {
+    std::string res(code_name(code()));
+    if (!ok()) {
+        res.append(": ");
+        res.append(_state->msg);
+    }
+    return res;
+}
+
+} // namespace starrocks
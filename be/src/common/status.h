@@ -0,0 +1,151 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+// Status is the error-reporting type used throughout the backend. Functions that
+// can fail return a Status (or StatusOr<T>) instead of throwing.
+class [[nodiscard]] Status {
+public:
+    enum Code : int {
+        kOk = 0,
+        kInvalidArgument,
+        kNotFound,
+        kAlreadyExist,
+        kCorruption,
+        kIOError,
+        kMemoryLimitExceeded,
+        kNotSupported,
+        kInternalError,
+        kEndOfFile,
+        kCancelled,
+        kTimedOut,
+        kResourceBusy,
+    };
+
+    Status() = default;
+
+    static Status OK() { return Status(); }
+    static Status InvalidArgument(std::string_view msg) { return Status(kInvalidArgument, msg); }
+    static Status NotFound(std::string_view msg) { return Status(kNotFound, msg); }
+    static Status AlreadyExist(std::string_view msg) { return Status(kAlreadyExist, msg); }
+    static Status Corruption(std::string_view msg) { return Status(kCorruption, msg); }
+    static Status IOError(std::string_view msg) { return Status(kIOError, msg); }
+    static Status MemoryLimitExceeded(std::string_view msg) { return Status(kMemoryLimitExceeded, msg); }
+    static Status NotSupported(std::string_view msg) { return Status(kNotSupported, msg); }
+    static Status InternalError(std::string_view msg) { return Status(kInternalError, msg); }
+    static Status EndOfFile(std::string_view msg) { return Status(kEndOfFile, msg); }
+    static Status Cancelled(std::string_view msg) { return Status(kCancelled, msg); }
+    static Status TimedOut(std::string_view msg) { return Status(kTimedOut, msg); }
+    static Status ResourceBusy(std::string_view msg) { return Status(kResourceBusy, msg); }
+
+    bool ok() const { return _state == nullptr; }
+    Code code() const { return _state == nullptr ? kOk : _state->code; }
+    std::string_view message() const { return _state == nullptr ? std::string_view() : _state->msg; }
+
+    bool is_invalid_argument() const { return code() == kInvalidArgument; }
+    bool is_not_found() const { return code() == kNotFound; }
+    bool is_already_exist() const { return code() == kAlreadyExist; }
+    bool is_corruption() const { return code() == kCorruption; }
+    bool is_io_error() const { return code() == kIOError; }
+    bool is_mem_limit_exceeded() const { return code() == kMemoryLimitExceeded; }
+    bool is_not_supported() const { return code() == kNotSupported; }
+    bool is_end_of_file() const { return code() == kEndOfFile; }
+    bool is_cancelled() const { return code() == kCancelled; }
+    bool is_time_out() const { return code() == kTimedOut; }
+    bool is_resource_busy() const { return code() == kResourceBusy; }
+
+    // Returns a copy of this status with |ctx| prepended to the message.
+    Status clone_and_prepend(std::string_view ctx) const;
+
+    std::string to_string() const;
+
+private:
+    struct State {
+        Code code;
+        std::string msg;
+    };
+
+    Status(Code code, std::string_view msg) : _state(std::make_shared<State>(State{code, std::string(msg)})) {}
+
+    // Shared so that copying a status around the happy path stays cheap.
+    std::shared_ptr<const State> _state;
+};
+
+// StatusOr<T> holds either a value or a non-OK Status.
+template <typename T>
+class [[nodiscard]] StatusOr {
+public:
+    StatusOr(const Status& st) : _status(st) {}                     // NOLINT
+    StatusOr(Status&& st) : _status(std::move(st)) {}               // NOLINT
+    StatusOr(const T& value) : _value(value) {}                     // NOLINT
+    StatusOr(T&& value) : _value(std::move(value)) {}               // NOLINT
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U&&, T> &&
+                                                      !std::is_same_v<std::decay_t<U>, Status> &&
+                                                      !std::is_same_v<std::decay_t<U>, T>>>
+    StatusOr(U&& value) : _value(std::forward<U>(value)) {} // NOLINT
+
+    bool ok() const { return _status.ok(); }
+    const Status& status() const& { return _status; }
+    Status status() && { return std::move(_status); }
+
+    T& value() & { return *_value; }
+    const T& value() const& { return *_value; }
+    T&& value() && { return std::move(*_value); }
+
+    T& operator*() & { return *_value; }
+    const T& operator*() const& { return *_value; }
+    T&& operator*() && { return std::move(*_value); }
+    T* operator->() { return &*_value; }
+    const T* operator->() const { return &*_value; }
+
+private:
+    Status _status;
+    std::optional<T> _value;
+};
+
+#define SR_CONCAT_IMPL(a, b) a##b
+#define SR_CONCAT(a, b) SR_CONCAT_IMPL(a, b)
+
+#define RETURN_IF_ERROR(stmt)                      \
+    do {                                           \
+        auto&& _status_ = (stmt);                  \
+        if (UNLIKELY(!_status_.ok())) {            \
+            return ::starrocks::to_status(_status_); \
+        }                                          \
+    } while (false)
+
+#define ASSIGN_OR_RETURN_IMPL(var, lhs, rhs)  \
+    auto&& var = (rhs);                       \
+    if (UNLIKELY(!var.ok())) {                \
+        return std::move(var).status();       \
+    }                                         \
+    lhs = std::move(var).value();
+
+#define ASSIGN_OR_RETURN(lhs, rhs) ASSIGN_OR_RETURN_IMPL(SR_CONCAT(_status_or_, __LINE__), lhs, rhs)
+
+#define RETURN_IF(cond, ret) \
+    do {                     \
+        if (cond) {          \
+            return ret;      \
+        }                    \
+    } while (false)
+
+inline const Status& to_status(const Status& st) {
+    return st;
+}
+
+template <typename T>
+inline const Status& to_status(const StatusOr<T>& st) {
+    return st.status();
+}
+
+} // namespace starrocks
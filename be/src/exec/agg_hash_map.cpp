@@ -0,0 +1,282 @@
+#include "exec/agg_hash_map.h"
+
+#include <cstring>
+
+namespace starrocks {
+
+const char* agg_key_kind_name(AggKeyKind kind) {
+    switch (kind) {
+    case AggKeyKind::kNumber8:
+        return "number8";
+    case AggKeyKind::kNumber16:
+        return "number16";
+    case AggKeyKind::kNumber32:
+        return "number32";
+    case AggKeyKind::kNumber64:
+        return "number64";
+    case AggKeyKind::kFixed64:
+        return "fixed64";
+    case AggKeyKind::kFixed128:
+        return "fixed128";
+    case AggKeyKind::kString:
+        return "string";
+    case AggKeyKind::kSerialized:
+        return "serialized";
+    }
+    return "unknown";
+}
+
+AggKeyKind choose_agg_key_kind(const AggKeyLayout& layout) {
+    if (layout.size() == 1) {
+        if (is_binary_type(layout.types[0])) {
+            return AggKeyKind::kString;
+        }
+        switch (get_type_size(layout.types[0])) {
+        case 1:
+            return AggKeyKind::kNumber8;
+        case 2:
+            return AggKeyKind::kNumber16;
+        case 4:
+            return AggKeyKind::kNumber32;
+        default:
+            return AggKeyKind::kNumber64;
+        }
+    }
+    size_t width = 0;
+    for (size_t k = 0; k < layout.size(); ++k) {
+        if (is_binary_type(layout.types[k])) {
+            return AggKeyKind::kSerialized;
+        }
+        width += get_type_size(layout.types[k]) + layout.nullable[k];
+    }
+    if (width <= sizeof(uint64_t)) {
+        return AggKeyKind::kFixed64;
+    }
+    return width <= sizeof(Fixed128) ? AggKeyKind::kFixed128 : AggKeyKind::kSerialized;
+}
+
+// Copies one value, turning -0.0 into 0.0 for floating point types.
+template <size_t W>
+static ALWAYS_INLINE void copy_key_value(uint8_t* dst, const uint8_t* src, bool is_float) {
+    memcpy(dst, src, W);
+    if constexpr (W == 4 || W == 8) {
+        if (is_float) {
+            std::conditional_t<W == 4, uint32_t, uint64_t> bits;
+            memcpy(&bits, dst, W);
+            if (bits << 1 == 0) {
+                memset(dst, 0, W);
+            }
+        }
+    }
+}
+
+template <size_t W>
+static void copy_key_values(const uint8_t* src, const uint8_t* nulls, size_t num_rows, bool is_float, uint8_t* out,
+                            const uint32_t* out_offsets, size_t stride) {
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (nulls != nullptr && nulls[i]) {
+            continue;
+        }
+        uint8_t* dst = out + (out_offsets == nullptr ? i * stride : out_offsets[i]);
+        copy_key_value<W>(dst, src + i * W, is_float);
+    }
+}
+
+// Writes value i of a fixed-width column to out + out_offsets[i], or to
+// out + i * stride without offsets; NULL values are skipped.
+static void copy_fixed_key_column(const Column* column, LogicalType type, const uint8_t* nulls, size_t num_rows,
+                                  uint8_t* out, const uint32_t* out_offsets, size_t stride) {
+    const uint8_t* src = ColumnHelper::get_data_column(column)->raw_data();
+    bool is_float = is_float_type(type);
+    switch (get_type_size(type)) {
+    case 1:
+        copy_key_values<1>(src, nulls, num_rows, is_float, out, out_offsets, stride);
+        break;
+    case 2:
+        copy_key_values<2>(src, nulls, num_rows, is_float, out, out_offsets, stride);
+        break;
+    case 4:
+        copy_key_values<4>(src, nulls, num_rows, is_float, out, out_offsets, stride);
+        break;
+    default:
+        copy_key_values<8>(src, nulls, num_rows, is_float, out, out_offsets, stride);
+        break;
+    }
+}
+
+static const uint8_t* null_flags(const Column* column) {
+    const NullData* nulls = ColumnHelper::get_null_data(column);
+    return nulls == nullptr ? nullptr : nulls->data();
+}
+
+void pack_fixed_keys(const Columns& columns, const AggKeyLayout& layout, size_t num_rows, size_t stride,
+                     uint8_t* out) {
+    size_t offset = 0;
+    for (size_t k = 0; k < layout.size(); ++k) {
+        const uint8_t* nulls = null_flags(columns[k].get());
+        if (layout.nullable[k]) {
+            if (nulls != nullptr) {
+                for (size_t i = 0; i < num_rows; ++i) {
+                    out[i * stride + offset] = nulls[i];
+                }
+            }
+            offset++;
+        }
+        copy_fixed_key_column(columns[k].get(), layout.types[k], nulls, num_rows, out + offset, nullptr, stride);
+        offset += get_type_size(layout.types[k]);
+    }
+}
+
+// Appends the null flags of |num_keys| keys, read |stride| bytes apart, to a
+// nullable column.
+static void append_key_nulls(const uint8_t* flags, size_t stride, size_t num_keys, Column* column) {
+    auto* nullable = static_cast<NullableColumn*>(column);
+    auto& nulls = nullable->null_column_data();
+    size_t base = nulls.size();
+    nulls.resize_uninitialized(base + num_keys);
+    bool has_null = false;
+    for (size_t i = 0; i < num_keys; ++i) {
+        nulls[base + i] = flags[i * stride];
+        has_null |= flags[i * stride] != 0;
+    }
+    nullable->set_has_null(has_null);
+}
+
+void unpack_fixed_keys(const uint8_t* keys, size_t stride, size_t num_keys, const AggKeyLayout& layout,
+                       Columns* columns) {
+    size_t offset = 0;
+    for (size_t k = 0; k < layout.size(); ++k) {
+        Column* column = (*columns)[k].get();
+        if (layout.nullable[k]) {
+            append_key_nulls(keys + offset, stride, num_keys, column);
+            offset++;
+        }
+        size_t width = get_type_size(layout.types[k]);
+        Column* data = ColumnHelper::get_data_column(column);
+        size_t base = data->size();
+        data->resize_uninitialized(base + num_keys);
+        uint8_t* dst = data->mutable_raw_data() + base * width;
+        for (size_t i = 0; i < num_keys; ++i) {
+            memcpy(dst + i * width, keys + i * stride + offset, width);
+        }
+        offset += width;
+    }
+}
+
+void serialize_keys(const Columns& columns, const AggKeyLayout& layout, size_t num_rows, Buffer<uint8_t>* bytes,
+                    Buffer<uint32_t>* offsets) {
+    // Size every row first, then write column by column so each pass streams
+    // through one column. A string is its length and its bytes.
+    size_t fixed_width = 0;
+    for (size_t k = 0; k < layout.size(); ++k) {
+        fixed_width += layout.nullable[k] + (is_binary_type(layout.types[k]) ? sizeof(uint32_t)
+                                                                              : get_type_size(layout.types[k]));
+    }
+    offsets->resize_uninitialized(num_rows + 1);
+    uint32_t* row_offsets = offsets->data();
+    row_offsets[0] = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        row_offsets[i + 1] = static_cast<uint32_t>(fixed_width);
+    }
+    for (size_t k = 0; k < layout.size(); ++k) {
+        if (is_binary_type(layout.types[k])) {
+            const uint8_t* nulls = null_flags(columns[k].get());
+            const auto* binary = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(columns[k].get()));
+            const auto& src_offsets = binary->get_offset();
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (nulls == nullptr || !nulls[i]) {
+                    row_offsets[i + 1] += src_offsets[i + 1] - src_offsets[i];
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        row_offsets[i + 1] += row_offsets[i];
+    }
+    bytes->resize(0);
+    bytes->resize(row_offsets[num_rows]);
+
+    Buffer<uint32_t> cursor;
+    cursor.append(row_offsets, num_rows);
+    uint8_t* out = bytes->data();
+    for (size_t k = 0; k < layout.size(); ++k) {
+        const Column* column = columns[k].get();
+        const uint8_t* nulls = null_flags(column);
+        if (layout.nullable[k]) {
+            for (size_t i = 0; i < num_rows; ++i) {
+                out[cursor[i]++] = nulls != nullptr && nulls[i];
+            }
+        }
+        if (is_binary_type(layout.types[k])) {
+            const auto* binary = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(column));
+            for (size_t i = 0; i < num_rows; ++i) {
+                uint32_t len = 0;
+                if (nulls == nullptr || !nulls[i]) {
+                    Slice value = binary->get_slice(i);
+                    len = static_cast<uint32_t>(value.size);
+                    memcpy(out + cursor[i] + sizeof(len), value.data, len);
+                }
+                memcpy(out + cursor[i], &len, sizeof(len));
+                cursor[i] += sizeof(len) + len;
+            }
+        } else {
+            size_t width = get_type_size(layout.types[k]);
+            copy_fixed_key_column(column, layout.types[k], nulls, num_rows, out, cursor.data(), 0);
+            for (size_t i = 0; i < num_rows; ++i) {
+                cursor[i] += width;
+            }
+        }
+    }
+}
+
+void deserialize_keys(const Slice* keys, size_t num_keys, const AggKeyLayout& layout, Columns* columns) {
+    std::vector<const uint8_t*> cursor(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        cursor[i] = reinterpret_cast<const uint8_t*>(keys[i].data);
+    }
+    for (size_t k = 0; k < layout.size(); ++k) {
+        Column* column = (*columns)[k].get();
+        if (layout.nullable[k]) {
+            auto* nullable = static_cast<NullableColumn*>(column);
+            auto& nulls = nullable->null_column_data();
+            bool has_null = false;
+            for (size_t i = 0; i < num_keys; ++i) {
+                nulls.push_back(*cursor[i]);
+                has_null |= *cursor[i]++ != 0;
+            }
+            nullable->set_has_null(has_null);
+        }
+        Column* data = ColumnHelper::get_data_column(column);
+        if (is_binary_type(layout.types[k])) {
+            auto* binary = static_cast<BinaryColumn*>(data);
+            for (size_t i = 0; i < num_keys; ++i) {
+                uint32_t len;
+                memcpy(&len, cursor[i], sizeof(len));
+                binary->append(Slice(cursor[i] + sizeof(len), len));
+                cursor[i] += sizeof(len) + len;
+            }
+        } else {
+            size_t width = get_type_size(layout.types[k]);
+            size_t base = data->size();
+            data->resize_uninitialized(base + num_keys);
+            uint8_t* dst = data->mutable_raw_data() + base * width;
+            for (size_t i = 0; i < num_keys; ++i) {
+                memcpy(dst + i * width, cursor[i], width);
+                cursor[i] += width;
+            }
+        }
+    }
+}
+
+void append_fixed_values(const void* values, size_t width, size_t num_values, Column* column) {
+    Column* data = ColumnHelper::get_data_column(column);
+    size_t base = data->size();
+    data->resize_uninitialized(base + num_values);
+    memcpy(data->mutable_raw_data() + base * width, values, num_values * width);
+    if (column->is_nullable()) {
+        auto& nulls = static_cast<NullableColumn*>(column)->null_column_data();
+        nulls.resize(nulls.size() + num_values, 0);
+    }
+}
+
+} // namespace starrocks
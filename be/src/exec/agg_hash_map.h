@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "column/column_helper.h"
+#include "exec/aggregate_function.h"
+#include "runtime/mem_pool.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+// How the group-by keys of a row are laid out in an aggregation hash map.
+enum class AggKeyKind {
+    // One fixed-width key of 1, 2, 4 or 8 bytes, used as is.
+    kNumber8,
+    kNumber16,
+    kNumber32,
+    kNumber64,
+    // Several fixed-width keys, with a null byte ahead of each nullable one,
+    // packed into 8 (16) bytes.
+    kFixed64,
+    kFixed128,
+    // One VARCHAR key.
+    kString,
+    // Anything else: keys serialized into one byte string per row.
+    kSerialized,
+};
+
+const char* agg_key_kind_name(AggKeyKind kind);
+
+// Types and nullability of the group-by keys, in order.
+struct AggKeyLayout {
+    std::vector<LogicalType> types;
+    std::vector<uint8_t> nullable;
+
+    size_t size() const { return types.size(); }
+};
+
+AggKeyKind choose_agg_key_kind(const AggKeyLayout& layout);
+
+// Key conversions of the composite key kinds. Columns are unfolded; NULL keys
+// are written as a set null byte and a zeroed value, and -0.0 as 0.0, so
+// equal keys have equal bytes.
+//
+// Packs the keys of each row into |stride| bytes at |out|, which must be
+// zeroed.
+void pack_fixed_keys(const Columns& columns, const AggKeyLayout& layout, size_t num_rows, size_t stride,
+                     uint8_t* out);
+void unpack_fixed_keys(const uint8_t* keys, size_t stride, size_t num_keys, const AggKeyLayout& layout,
+                       Columns* columns);
+void serialize_keys(const Columns& columns, const AggKeyLayout& layout, size_t num_rows, Buffer<uint8_t>* bytes,
+                    Buffer<uint32_t>* offsets);
+void deserialize_keys(const Slice* keys, size_t num_keys, const AggKeyLayout& layout, Columns* columns);
+
+// Appends |num_values| fixed-width values of |width| bytes to |column|, as
+// non-NULL values if it is nullable.
+void append_fixed_values(const void* values, size_t width, size_t num_values, Column* column);
+
+struct Fixed128 {
+    uint64_t lo;
+    uint64_t hi;
+
+    bool operator==(const Fixed128& rhs) const { return lo == rhs.lo && hi == rhs.hi; }
+};
+
+template <AggKeyKind KK>
+struct AggKeyTraits {};
+
+#define DEFINE_AGG_KEY_TRAITS(KK, KEY) \
+    template <>                        \
+    struct AggKeyTraits<KK> {          \
+        using KeyType = KEY;           \
+    }
+
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kNumber8, uint8_t);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kNumber16, uint16_t);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kNumber32, uint32_t);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kNumber64, uint64_t);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kFixed64, uint64_t);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kFixed128, Fixed128);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kString, Slice);
+DEFINE_AGG_KEY_TRAITS(AggKeyKind::kSerialized, Slice);
+
+#undef DEFINE_AGG_KEY_TRAITS
+
+template <typename Key>
+ALWAYS_INLINE uint64_t agg_key_hash(const Key& key) {
+    if constexpr (std::is_same_v<Key, Slice>) {
+        return HashUtil::hash_bytes(key.data, key.size);
+    } else if constexpr (std::is_same_v<Key, Fixed128>) {
+        return HashUtil::combine(HashUtil::hash64(key.lo), key.hi);
+    } else {
+        return HashUtil::hash64(key);
+    }
+}
+
+template <typename Key>
+struct AggHashSlot {
+    Key key;
+    AggDataPtr state;
+};
+
+// String keys keep their hash: comparing it first saves most key compares,
+// and growing the table does not hash the bytes again.
+template <>
+struct AggHashSlot<Slice> {
+    Slice key;
+    uint64_t hash;
+    AggDataPtr state;
+};
+
+// Open-addressing, linearly probed table from group keys to aggregate states.
+// A slot is empty while its state is null; the table is kept at most half
+// full and doubles when it would pass that. Slots are only allocated by the
+// first insert.
+template <typename Key>
+class AggHashTable {
+public:
+    using Slot = AggHashSlot<Key>;
+
+    static constexpr size_t kInitialCapacity = 256;
+
+    AggHashTable() = default;
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _slots.size(); }
+    size_t memory_usage() const { return _slots.allocated_bytes(); }
+    const Slot& slot(size_t idx) const { return _slots[idx]; }
+
+    // Bytes of the slots growing the table to take |num_keys| more keys
+    // would allocate.
+    size_t growth_bytes(size_t num_keys) const {
+        size_t capacity = std::max(_slots.size(), kInitialCapacity);
+        while ((_size + num_keys) * 2 > capacity) {
+            capacity *= 2;
+        }
+        return capacity == _slots.size() ? 0 : capacity * sizeof(Slot);
+    }
+
+    void prefetch(uint64_t hash) const { PREFETCH(_slots.data() + (hash & _mask)); }
+
+    // The slot holding |key|. If there is none, a new slot is taken for it
+    // and *|inserted| set; the caller must give it a state.
+    ALWAYS_INLINE Slot* emplace(const Key& key, uint64_t hash, bool* inserted) {
+        if (UNLIKELY((_size + 1) * 2 > _slots.size())) {
+            _grow();
+        }
+        size_t idx = hash & _mask;
+        while (true) {
+            Slot* slot = _slots.data() + idx;
+            if (slot->state == nullptr) {
+                slot->key = key;
+                if constexpr (std::is_same_v<Key, Slice>) {
+                    slot->hash = hash;
+                }
+                _size++;
+                *inserted = true;
+                return slot;
+            }
+            if (_equals(*slot, key, hash)) {
+                *inserted = false;
+                return slot;
+            }
+            idx = (idx + 1) & _mask;
+        }
+    }
+
+    void clear() {
+        _slots.shrink_to_empty();
+        _mask = 0;
+        _size = 0;
+    }
+
+private:
+    static ALWAYS_INLINE bool _equals(const Slot& slot, const Key& key, uint64_t hash) {
+        if constexpr (std::is_same_v<Key, Slice>) {
+            return slot.hash == hash && slot.key == key;
+        } else {
+            return slot.key == key;
+        }
+    }
+
+    static ALWAYS_INLINE uint64_t _hash_of(const Slot& slot) {
+        if constexpr (std::is_same_v<Key, Slice>) {
+            return slot.hash;
+        } else {
+            return agg_key_hash(slot.key);
+        }
+    }
+
+    void _grow() {
+        Buffer<Slot> slots;
+        slots.resize(_slots.empty() ? kInitialCapacity : _slots.size() * 2);
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : _slots) {
+            if (slot.state != nullptr) {
+                size_t idx = _hash_of(slot) & mask;
+                while (slots[idx].state != nullptr) {
+                    idx = (idx + 1) & mask;
+                }
+                slots[idx] = slot;
+            }
+        }
+        _slots.swap(slots);
+        _mask = mask;
+    }
+
+    Buffer<Slot> _slots;
+    size_t _mask = 0;
+    size_t _size = 0;
+};
+
+// Hash map from the group-by keys of one aggregation to its states,
+// specialized at compile time for the key layout |KK|: a batch of rows has
+// its keys converted to KeyType and hashed column by column, then the rows
+// look up their groups, prefetching slots a fixed distance ahead.
+//
+// With one key, rows whose key is NULL share a group kept outside the table.
+// Keys of new groups that point into the input (strings) are copied to the
+// pool, where the states live as well.
+template <AggKeyKind KK>
+class AggHashMap {
+public:
+    using KeyType = typename AggKeyTraits<KK>::KeyType;
+
+    static constexpr size_t kPrefetchDistance = 16;
+    static constexpr bool kIsNumber = KK == AggKeyKind::kNumber8 || KK == AggKeyKind::kNumber16 ||
+                                      KK == AggKeyKind::kNumber32 || KK == AggKeyKind::kNumber64;
+    static constexpr bool kIsFixed = KK == AggKeyKind::kFixed64 || KK == AggKeyKind::kFixed128;
+    static constexpr bool kHasNullGroup = kIsNumber || KK == AggKeyKind::kString;
+
+    AggHashMap(const AggKeyLayout* layout, MemPool* pool) : _layout(layout), _pool(pool) {}
+
+    // Number of groups.
+    size_t size() const { return _table.size() + (_null_state != nullptr); }
+    size_t memory_usage() const {
+        return _table.memory_usage() + _key_buf.allocated_bytes() + _hashes.allocated_bytes() +
+               _bytes.allocated_bytes() + _offsets.allocated_bytes();
+    }
+
+    // Bytes |num_rows| new groups could make the table allocate.
+    size_t growth_bytes(size_t num_rows) const { return _table.growth_bytes(num_rows); }
+
+    // Fills states[i] with the state of the group of row i of |key_columns|,
+    // which are unfolded, creating groups with |alloc_state| as needed.
+    template <typename AllocState>
+    void emplace(const Columns& key_columns, size_t num_rows, AggDataPtr* states, AllocState&& alloc_state) {
+        _prepare_keys(key_columns, num_rows);
+        const uint64_t* hashes = _hashes.data();
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (i + kPrefetchDistance < num_rows) {
+                _table.prefetch(hashes[i + kPrefetchDistance]);
+            }
+            if constexpr (kHasNullGroup) {
+                if (_nulls != nullptr && _nulls[i]) {
+                    if (_null_state == nullptr) {
+                        _null_state = alloc_state();
+                    }
+                    states[i] = _null_state;
+                    continue;
+                }
+            }
+            bool inserted;
+            auto* slot = _table.emplace(_keys[i], hashes[i], &inserted);
+            if (inserted) {
+                if constexpr (std::is_same_v<KeyType, Slice>) {
+                    uint8_t* copy = _pool->allocate(slot->key.size, 1);
+                    memcpy(copy, slot->key.data, slot->key.size);
+                    slot->key = Slice(copy, slot->key.size);
+                }
+                slot->state = alloc_state();
+            }
+            states[i] = slot->state;
+        }
+    }
+
+    // Appends the keys of up to |max_groups| groups, from *|cursor| on, to
+    // |key_columns| and their states to |states|; returns how many. The NULL
+    // group comes last. A cursor starts at 0 and must not outlive a change
+    // to the map.
+    size_t collect(size_t* cursor, size_t max_groups, Columns* key_columns, AggDataPtr* states) {
+        size_t capacity = _table.capacity();
+        size_t count = 0;
+        size_t idx = *cursor;
+        _key_buf.resize_uninitialized(max_groups);
+        for (; idx < capacity && count < max_groups; ++idx) {
+            const auto& slot = _table.slot(idx);
+            if (slot.state != nullptr) {
+                _key_buf[count] = slot.key;
+                states[count++] = slot.state;
+            }
+        }
+        _append_keys(_key_buf.data(), count, key_columns);
+        if (idx == capacity && count < max_groups) {
+            if (_null_state != nullptr) {
+                states[count++] = _null_state;
+                (void)(*key_columns)[0]->append_nulls(1);
+            }
+            idx++;
+        }
+        *cursor = idx;
+        return count;
+    }
+
+    // Hashes of the keys of |key_columns|, as emplace() computes them, with 0
+    // for rows of the NULL group; valid until the next call.
+    const uint64_t* hash_keys(const Columns& key_columns, size_t num_rows) {
+        _prepare_keys(key_columns, num_rows);
+        if constexpr (kHasNullGroup) {
+            for (size_t i = 0; _nulls != nullptr && i < num_rows; ++i) {
+                _hashes[i] = _nulls[i] ? 0 : _hashes[i];
+            }
+        }
+        return _hashes.data();
+    }
+
+    // Drops every group; the caller clears the pool.
+    void clear() {
+        _table.clear();
+        _null_state = nullptr;
+        _key_buf.shrink_to_empty();
+        _hashes.shrink_to_empty();
+        _bytes.shrink_to_empty();
+        _offsets.shrink_to_empty();
+    }
+
+private:
+    void _prepare_keys(const Columns& key_columns, size_t num_rows) {
+        _hashes.resize_uninitialized(num_rows);
+        if constexpr (kIsNumber) {
+            const Column* column = key_columns[0].get();
+            const NullData* nulls = ColumnHelper::get_null_data(column);
+            _nulls = nulls == nullptr ? nullptr : nulls->data();
+            _keys = reinterpret_cast<const KeyType*>(ColumnHelper::get_data_column(column)->raw_data());
+            if (is_float_type(_layout->types[0])) {
+                // -0.0 and 0.0 are one group.
+                _key_buf.resize_uninitialized(num_rows);
+                for (size_t i = 0; i < num_rows; ++i) {
+                    _key_buf[i] = _keys[i] << 1 == 0 ? 0 : _keys[i];
+                }
+                _keys = _key_buf.data();
+            }
+        } else if constexpr (kIsFixed) {
+            _key_buf.resize(0);
+            _key_buf.resize(num_rows);
+            pack_fixed_keys(key_columns, *_layout, num_rows, sizeof(KeyType),
+                            reinterpret_cast<uint8_t*>(_key_buf.data()));
+            _keys = _key_buf.data();
+        } else if constexpr (KK == AggKeyKind::kString) {
+            const Column* column = key_columns[0].get();
+            const NullData* nulls = ColumnHelper::get_null_data(column);
+            _nulls = nulls == nullptr ? nullptr : nulls->data();
+            const auto* binary = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(column));
+            _key_buf.resize_uninitialized(num_rows);
+            for (size_t i = 0; i < num_rows; ++i) {
+                _key_buf[i] = binary->get_slice(i);
+            }
+            _keys = _key_buf.data();
+        } else {
+            serialize_keys(key_columns, *_layout, num_rows, &_bytes, &_offsets);
+            _key_buf.resize_uninitialized(num_rows);
+            for (size_t i = 0; i < num_rows; ++i) {
+                _key_buf[i] = Slice(_bytes.data() + _offsets[i], _offsets[i + 1] - _offsets[i]);
+            }
+            _keys = _key_buf.data();
+        }
+        for (size_t i = 0; i < num_rows; ++i) {
+            _hashes[i] = agg_key_hash(_keys[i]);
+        }
+    }
+
+    void _append_keys(const KeyType* keys, size_t num_keys, Columns* key_columns) const {
+        if constexpr (kIsNumber) {
+            append_fixed_values(keys, sizeof(KeyType), num_keys, (*key_columns)[0].get());
+        } else if constexpr (kIsFixed) {
+            unpack_fixed_keys(reinterpret_cast<const uint8_t*>(keys), sizeof(KeyType), num_keys, *_layout,
+                              key_columns);
+        } else if constexpr (KK == AggKeyKind::kString) {
+            Column* column = (*key_columns)[0].get();
+            static_cast<BinaryColumn*>(ColumnHelper::get_data_column(column))->append_strings(keys, num_keys);
+            if (column->is_nullable()) {
+                auto& nulls = static_cast<NullableColumn*>(column)->null_column_data();
+                nulls.resize(nulls.size() + num_keys, 0);
+            }
+        } else {
+            deserialize_keys(keys, num_keys, *_layout, key_columns);
+        }
+    }
+
+    const AggKeyLayout* const _layout;
+    MemPool* const _pool;
+    AggHashTable<KeyType> _table;
+    AggDataPtr _null_state = nullptr;
+
+    // Keys of the batch being looked up, pointing into the input or into the
+    // buffers below.
+    const KeyType* _keys = nullptr;
+    const uint8_t* _nulls = nullptr;
+    Buffer<KeyType> _key_buf;
+    Buffer<uint64_t> _hashes;
+    Buffer<uint8_t> _bytes;
+    Buffer<uint32_t> _offsets;
+};
+
+// Invokes |fn| with a std::integral_constant<AggKeyKind, KK> for |kind|.
+template <typename Fn>
+auto agg_key_kind_dispatch(AggKeyKind kind, Fn&& fn) {
+#define DISPATCH_CASE(KK) \
+    case KK:              \
+        return fn(std::integral_constant<AggKeyKind, KK>());
+    switch (kind) {
+        DISPATCH_CASE(AggKeyKind::kNumber8)
+        DISPATCH_CASE(AggKeyKind::kNumber16)
+        DISPATCH_CASE(AggKeyKind::kNumber32)
+        DISPATCH_CASE(AggKeyKind::kNumber64)
+        DISPATCH_CASE(AggKeyKind::kFixed64)
+        DISPATCH_CASE(AggKeyKind::kFixed128)
+        DISPATCH_CASE(AggKeyKind::kString)
+    default:
+        return fn(std::integral_constant<AggKeyKind, AggKeyKind::kSerialized>());
+    }
+#undef DISPATCH_CASE
+}
+
+} // namespace starrocks
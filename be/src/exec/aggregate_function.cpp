@@ -0,0 +1,452 @@
+#include "exec/aggregate_function.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "exec/aggregate_function_helper.h"
+#include "runtime/mem_pool.h"
+
+namespace starrocks {
+
+const char* agg_function_name(AggFunctionType type) {
+    switch (type) {
+    case AggFunctionType::COUNT:
+        return "count";
+    case AggFunctionType::SUM:
+        return "sum";
+    case AggFunctionType::MIN:
+        return "min";
+    case AggFunctionType::MAX:
+        return "max";
+    case AggFunctionType::AVG:
+        return "avg";
+    case AggFunctionType::APPROX_COUNT_DISTINCT:
+        return "approx_count_distinct";
+    case AggFunctionType::HLL_SKETCH:
+        return "hll_sketch";
+    case AggFunctionType::HLL_UNION:
+        return "hll_union";
+    case AggFunctionType::THETA_SKETCH:
+        return "theta_sketch";
+    case AggFunctionType::THETA_UNION:
+        return "theta_union";
+    case AggFunctionType::THETA_INTERSECT:
+        return "theta_intersect";
+    case AggFunctionType::PERCENTILE_SKETCH:
+        return "percentile_sketch";
+    case AggFunctionType::PERCENTILE_UNION:
+        return "percentile_union";
+    case AggFunctionType::BITMAP_AGG:
+        return "bitmap_agg";
+    case AggFunctionType::BITMAP_UNION:
+        return "bitmap_union";
+    case AggFunctionType::BITMAP_INTERSECT:
+        return "bitmap_intersect";
+    case AggFunctionType::BITMAP_UNION_COUNT:
+        return "bitmap_union_count";
+    }
+    return "unknown";
+}
+
+template <LogicalType LT>
+static void append_value(Column* data, const RunTimeCppType<LT>& value) {
+    if constexpr (is_binary_type(LT)) {
+        static_cast<BinaryColumn*>(data)->append(value);
+    } else {
+        static_cast<RunTimeColumnType<LT>*>(data)->get_data().push_back(value);
+    }
+}
+
+class CountFunction final : public AggregateFunction {
+public:
+    AggFunctionType type() const override { return AggFunctionType::COUNT; }
+    LogicalType intermediate_type() const override { return TYPE_BIGINT; }
+    bool is_intermediate_nullable() const override { return false; }
+    LogicalType result_type() const override { return TYPE_BIGINT; }
+    bool is_result_nullable() const override { return false; }
+
+    size_t state_size() const override { return sizeof(int64_t); }
+    size_t state_align() const override { return alignof(int64_t); }
+    void create(AggDataPtr state) const override { *reinterpret_cast<int64_t*>(state) = 0; }
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        const uint8_t* nulls = nullptr;
+        if (arg != nullptr) {
+            unpack_nullable(arg, &nulls);
+        }
+        if (nulls == nullptr) {
+            for (size_t i = 0; i < num_rows; ++i) {
+                state_of<int64_t>(states[i], offset)++;
+            }
+        } else {
+            for (size_t i = 0; i < num_rows; ++i) {
+                state_of<int64_t>(states[i], offset) += !nulls[i];
+            }
+        }
+    }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        const uint8_t* nulls;
+        const auto* counts = reinterpret_cast<const int64_t*>(unpack_nullable(intermediate, &nulls)->raw_data());
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls == nullptr || !nulls[i]) {
+                state_of<int64_t>(states[i], offset) += counts[i];
+            }
+        }
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        for (size_t i = 0; i < num_states; ++i) {
+            data.push_back(state_of<int64_t>(states[i], offset));
+        }
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        serialize_to_column(states, num_states, offset, dst);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        const uint8_t* nulls = nullptr;
+        if (arg != nullptr) {
+            unpack_nullable(arg, &nulls);
+        }
+        size_t base = data.size();
+        data.resize_uninitialized(base + num_rows);
+        for (size_t i = 0; i < num_rows; ++i) {
+            data[base + i] = nulls == nullptr ? 1 : !nulls[i];
+        }
+    }
+};
+
+// SUM of integers is a BIGINT, SUM of floating point values a DOUBLE.
+template <LogicalType LT>
+class SumFunction final : public AggregateFunction {
+public:
+    static constexpr LogicalType kSumType = is_float_type(LT) ? TYPE_DOUBLE : TYPE_BIGINT;
+    using SumType = RunTimeCppType<kSumType>;
+
+    struct State {
+        SumType sum;
+        bool has_value;
+    };
+
+    AggFunctionType type() const override { return AggFunctionType::SUM; }
+    LogicalType intermediate_type() const override { return kSumType; }
+    bool is_intermediate_nullable() const override { return true; }
+    LogicalType result_type() const override { return kSumType; }
+    bool is_result_nullable() const override { return true; }
+
+    size_t state_size() const override { return sizeof(State); }
+    size_t state_align() const override { return alignof(State); }
+    void create(AggDataPtr state) const override { new (state) State{0, false}; }
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        _add<LT>(arg, num_rows, offset, states);
+    }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        _add<kSumType>(intermediate, num_rows, offset, states);
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        auto* nullable = as_nullable(dst);
+        auto& data = static_cast<RunTimeColumnType<kSumType>*>(nullable->data_column().get())->get_data();
+        auto& nulls = nullable->null_column_data();
+        bool has_null = false;
+        for (size_t i = 0; i < num_states; ++i) {
+            const auto& s = state_of<State>(states[i], offset);
+            data.push_back(s.sum);
+            nulls.push_back(!s.has_value);
+            has_null |= !s.has_value;
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        serialize_to_column(states, num_states, offset, dst);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* arg_nulls;
+        const auto* values = reinterpret_cast<const RunTimeCppType<LT>*>(unpack_nullable(arg, &arg_nulls)->raw_data());
+        auto* nullable = as_nullable(dst);
+        auto& data = static_cast<RunTimeColumnType<kSumType>*>(nullable->data_column().get())->get_data();
+        auto& nulls = nullable->null_column_data();
+        for (size_t i = 0; i < num_rows; ++i) {
+            data.push_back(static_cast<SumType>(values[i]));
+        }
+        if (arg_nulls != nullptr) {
+            nulls.append(arg_nulls, num_rows);
+            nullable->set_has_null(true);
+        } else {
+            nulls.resize(nulls.size() + num_rows, 0);
+        }
+    }
+
+private:
+    template <LogicalType InputLT>
+    static void _add(const Column* input, size_t num_rows, size_t offset, const AggDataPtr* states) {
+        const uint8_t* nulls;
+        const auto* values =
+                reinterpret_cast<const RunTimeCppType<InputLT>*>(unpack_nullable(input, &nulls)->raw_data());
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls == nullptr || !nulls[i]) {
+                auto& s = state_of<State>(states[i], offset);
+                s.sum += static_cast<SumType>(values[i]);
+                s.has_value = true;
+            }
+        }
+    }
+};
+
+template <LogicalType LT, bool kIsMin>
+class MinMaxFunction final : public AggregateFunction {
+public:
+    using CppType = RunTimeCppType<LT>;
+
+    struct State {
+        CppType value;
+        bool has_value;
+    };
+
+    AggFunctionType type() const override { return kIsMin ? AggFunctionType::MIN : AggFunctionType::MAX; }
+    LogicalType intermediate_type() const override { return LT; }
+    bool is_intermediate_nullable() const override { return true; }
+    LogicalType result_type() const override { return LT; }
+    bool is_result_nullable() const override { return true; }
+
+    size_t state_size() const override { return sizeof(State); }
+    size_t state_align() const override { return alignof(State); }
+    void create(AggDataPtr state) const override { new (state) State{CppType(), false}; }
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        const uint8_t* nulls;
+        const Column* data = unpack_nullable(arg, &nulls);
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls != nullptr && nulls[i]) {
+                continue;
+            }
+            auto& s = state_of<State>(states[i], offset);
+            CppType value = value_at<LT>(data, i);
+            if (s.has_value && !(kIsMin ? value < s.value : s.value < value)) {
+                continue;
+            }
+            if constexpr (is_binary_type(LT)) {
+                // The argument's chunk goes away; keep a copy. Values it
+                // replaces stay in the pool until the aggregation is done.
+                uint8_t* copy = pool->allocate(value.size, 1);
+                memcpy(copy, value.data, value.size);
+                value = Slice(copy, value.size);
+            }
+            s.value = value;
+            s.has_value = true;
+        }
+    }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        update_batch(intermediate, num_rows, offset, states, pool);
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        auto* nullable = as_nullable(dst);
+        Column* data = nullable->data_column().get();
+        auto& nulls = nullable->null_column_data();
+        bool has_null = false;
+        for (size_t i = 0; i < num_states; ++i) {
+            const auto& s = state_of<State>(states[i], offset);
+            append_value<LT>(data, s.value);
+            nulls.push_back(!s.has_value);
+            has_null |= !s.has_value;
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        serialize_to_column(states, num_states, offset, dst);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        dst->append(*arg, 0, num_rows);
+    }
+};
+
+// The intermediate value is the (sum, count) pair, as 16 bytes of VARCHAR.
+template <LogicalType LT>
+class AvgFunction final : public AggregateFunction {
+public:
+    struct State {
+        double sum;
+        int64_t count;
+    };
+
+    AggFunctionType type() const override { return AggFunctionType::AVG; }
+    LogicalType intermediate_type() const override { return TYPE_VARCHAR; }
+    bool is_intermediate_nullable() const override { return false; }
+    LogicalType result_type() const override { return TYPE_DOUBLE; }
+    bool is_result_nullable() const override { return true; }
+
+    size_t state_size() const override { return sizeof(State); }
+    size_t state_align() const override { return alignof(State); }
+    void create(AggDataPtr state) const override { new (state) State{0, 0}; }
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        const uint8_t* nulls;
+        const auto* values = reinterpret_cast<const RunTimeCppType<LT>*>(unpack_nullable(arg, &nulls)->raw_data());
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls == nullptr || !nulls[i]) {
+                auto& s = state_of<State>(states[i], offset);
+                s.sum += static_cast<double>(values[i]);
+                s.count++;
+            }
+        }
+    }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        const uint8_t* nulls;
+        const auto* pairs = static_cast<const BinaryColumn*>(unpack_nullable(intermediate, &nulls));
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls != nullptr && nulls[i]) {
+                continue;
+            }
+            State other;
+            memcpy(&other, pairs->get_slice(i).data, sizeof(other));
+            auto& s = state_of<State>(states[i], offset);
+            s.sum += other.sum;
+            s.count += other.count;
+        }
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        auto* pairs = static_cast<BinaryColumn*>(dst);
+        for (size_t i = 0; i < num_states; ++i) {
+            _append_pair(pairs, state_of<State>(states[i], offset));
+        }
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        auto* nullable = as_nullable(dst);
+        auto& data = static_cast<DoubleColumn*>(nullable->data_column().get())->get_data();
+        auto& nulls = nullable->null_column_data();
+        bool has_null = false;
+        for (size_t i = 0; i < num_states; ++i) {
+            const auto& s = state_of<State>(states[i], offset);
+            data.push_back(s.count == 0 ? 0 : s.sum / static_cast<double>(s.count));
+            nulls.push_back(s.count == 0);
+            has_null |= s.count == 0;
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* nulls;
+        const auto* values = reinterpret_cast<const RunTimeCppType<LT>*>(unpack_nullable(arg, &nulls)->raw_data());
+        auto* pairs = static_cast<BinaryColumn*>(dst);
+        pairs->reserve(pairs->size() + num_rows, pairs->get_bytes().size() + num_rows * sizeof(State));
+        for (size_t i = 0; i < num_rows; ++i) {
+            bool is_null = nulls != nullptr && nulls[i];
+            _append_pair(pairs, is_null ? State{0, 0} : State{static_cast<double>(values[i]), 1});
+        }
+    }
+
+private:
+    static void _append_pair(BinaryColumn* dst, const State& s) {
+        char buf[sizeof(State)];
+        memcpy(buf, &s.sum, sizeof(s.sum));
+        memcpy(buf + sizeof(s.sum), &s.count, sizeof(s.count));
+        dst->append(Slice(buf, sizeof(buf)));
+    }
+};
+
+StatusOr<const AggregateFunction*> get_aggregate_function(AggFunctionType type, LogicalType arg_type,
+                                                          bool is_merge) {
+    switch (type) {
+    case AggFunctionType::COUNT: {
+        static const CountFunction count;
+        if (is_merge && arg_type != TYPE_BIGINT) {
+            return unsupported(type, arg_type, is_merge);
+        }
+        return &count;
+    }
+    case AggFunctionType::SUM: {
+        if (is_merge ? arg_type != TYPE_BIGINT && arg_type != TYPE_DOUBLE
+                     : !is_integer_type(arg_type) && !is_float_type(arg_type) && arg_type != TYPE_BOOLEAN) {
+            return unsupported(type, arg_type, is_merge);
+        }
+        return type_dispatch_all(arg_type, [](auto lt) -> const AggregateFunction* {
+            constexpr LogicalType LT = decltype(lt)::value;
+            if constexpr (is_binary_type(LT) || LT == TYPE_DATE || LT == TYPE_DATETIME) {
+                return nullptr;
+            } else {
+                static const SumFunction<LT> sum;
+                return &sum;
+            }
+        });
+    }
+    case AggFunctionType::MIN:
+    case AggFunctionType::MAX: {
+        if (arg_type == TYPE_UNKNOWN || arg_type == TYPE_BITMAP) {
+            return unsupported(type, arg_type, is_merge);
+        }
+        bool is_min = type == AggFunctionType::MIN;
+        return type_dispatch_all(arg_type, [is_min](auto lt) -> const AggregateFunction* {
+            constexpr LogicalType LT = decltype(lt)::value;
+            static const MinMaxFunction<LT, true> min;
+            static const MinMaxFunction<LT, false> max;
+            return is_min ? static_cast<const AggregateFunction*>(&min) : &max;
+        });
+    }
+    case AggFunctionType::AVG: {
+        if (is_merge) {
+            if (arg_type != TYPE_VARCHAR) {
+                return unsupported(type, arg_type, is_merge);
+            }
+            // Merging does not depend on the argument type.
+            static const AvgFunction<TYPE_DOUBLE> avg;
+            return &avg;
+        }
+        if (!is_integer_type(arg_type) && !is_float_type(arg_type) && arg_type != TYPE_BOOLEAN) {
+            return unsupported(type, arg_type, is_merge);
+        }
+        return type_dispatch_all(arg_type, [](auto lt) -> const AggregateFunction* {
+            constexpr LogicalType LT = decltype(lt)::value;
+            if constexpr (is_binary_type(LT) || LT == TYPE_DATE || LT == TYPE_DATETIME) {
+                return nullptr;
+            } else {
+                static const AvgFunction<LT> avg;
+                return &avg;
+            }
+        });
+    }
+    case AggFunctionType::APPROX_COUNT_DISTINCT:
+    case AggFunctionType::HLL_SKETCH:
+    case AggFunctionType::HLL_UNION:
+    case AggFunctionType::THETA_SKETCH:
+    case AggFunctionType::THETA_UNION:
+    case AggFunctionType::THETA_INTERSECT:
+    case AggFunctionType::PERCENTILE_SKETCH:
+    case AggFunctionType::PERCENTILE_UNION:
+        return get_sketch_aggregate_function(type, arg_type, is_merge);
+    case AggFunctionType::BITMAP_AGG:
+    case AggFunctionType::BITMAP_UNION:
+    case AggFunctionType::BITMAP_INTERSECT:
+    case AggFunctionType::BITMAP_UNION_COUNT:
+        return get_bitmap_aggregate_function(type, arg_type, is_merge);
+    }
+    return unsupported(type, arg_type, is_merge);
+}
+
+} // namespace starrocks
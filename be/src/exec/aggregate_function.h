@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "column/vectorized_fwd.h"
+#include "common/status.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+class MemPool;
+
+enum class AggFunctionType {
+    COUNT,
+    SUM,
+    MIN,
+    MAX,
+    AVG,
+    // Approximate, over sketches (see sketch_aggregate_functions.cpp). The
+    // *_SKETCH functions yield the serialized sketch of their argument's
+    // values, the *_UNION ones that of the union of the serialized sketches
+    // they aggregate, so sketches stored per group of a materialized view
+    // roll up to coarser groups.
+    APPROX_COUNT_DISTINCT,
+    HLL_SKETCH,
+    HLL_UNION,
+    THETA_SKETCH,
+    THETA_UNION,
+    THETA_INTERSECT,
+    PERCENTILE_SKETCH,
+    PERCENTILE_UNION,
+    // Exact, over BITMAP values (see bitmap_aggregate_functions.cpp):
+    // BITMAP_AGG yields the bitmap of its integer argument's values, the
+    // others unite or intersect the bitmaps they aggregate, and
+    // BITMAP_UNION_COUNT yields the cardinality of their union.
+    BITMAP_AGG,
+    BITMAP_UNION,
+    BITMAP_INTERSECT,
+    BITMAP_UNION_COUNT,
+};
+
+const char* agg_function_name(AggFunctionType type);
+
+// Aggregate states are opaque bytes; each function knows the layout of its own.
+using AggDataPtr = uint8_t*;
+
+// A vectorized aggregate function. Every call works on a whole batch of rows:
+// row i of the input is folded into the state at states[i] + |offset|, so one
+// virtual call covers a chunk, and the states of all functions of a group can
+// share one allocation.
+//
+// An aggregation runs in one or two phases. A single phase updates states
+// from the argument and finalizes them. Two phases split at an exchange: the
+// first updates states and serializes them into an intermediate column, the
+// second merges those into its own states and finalizes. A first phase that
+// does not aggregate a row at all converts it straight into the intermediate
+// value of a group of that one row.
+//
+// States are plain data: they live in a MemPool together with the hash table
+// keys and are never destroyed one by one. Functions needing memory beyond
+// the state (the current MIN of strings) take it from the pool as well.
+// NULL arguments are skipped; a function seeing none but NULLs yields NULL,
+// except COUNT, APPROX_COUNT_DISTINCT and BITMAP_UNION_COUNT, which yield 0,
+// and the sketches and bitmaps other than THETA_INTERSECT and
+// BITMAP_INTERSECT, which yield an empty one.
+class AggregateFunction {
+public:
+    virtual ~AggregateFunction() = default;
+
+    virtual AggFunctionType type() const = 0;
+
+    virtual LogicalType intermediate_type() const = 0;
+    virtual bool is_intermediate_nullable() const = 0;
+    virtual LogicalType result_type() const = 0;
+    virtual bool is_result_nullable() const = 0;
+
+    virtual size_t state_size() const = 0;
+    virtual size_t state_align() const = 0;
+    virtual void create(AggDataPtr state) const = 0;
+
+    // |arg| is null for COUNT(*).
+    virtual void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                              MemPool* pool) const = 0;
+    // |intermediate| holds values produced by serialize_to_column() or
+    // convert_to_intermediate().
+    virtual void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                             MemPool* pool) const = 0;
+
+    // Append one value per state to |dst|, a column of the intermediate
+    // (result) type and nullability.
+    virtual void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                                     Column* dst) const = 0;
+    virtual void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                                    Column* dst) const = 0;
+
+    // Appends, for every row of |arg|, the intermediate value of a group
+    // holding just that row.
+    virtual void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const = 0;
+};
+
+// The function |type| over arguments of |arg_type|; with |is_merge|,
+// |arg_type| is the type of the intermediate values it merges instead.
+// Functions are stateless singletons.
+StatusOr<const AggregateFunction*> get_aggregate_function(AggFunctionType type, LogicalType arg_type, bool is_merge);
+
+} // namespace starrocks
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "column/column_helper.h"
+#include "exec/aggregate_function.h"
+
+namespace starrocks {
+
+// Building blocks of the aggregate functions, shared by the files defining
+// them.
+
+// Data column of |column|, and its null map or nullptr when no row is NULL.
+inline const Column* unpack_nullable(const Column* column, const uint8_t** nulls) {
+    const NullData* null_data = ColumnHelper::get_null_data(column);
+    *nulls = null_data == nullptr ? nullptr : null_data->data();
+    return ColumnHelper::get_data_column(column);
+}
+
+inline NullableColumn* as_nullable(Column* column) {
+    return static_cast<NullableColumn*>(column);
+}
+
+template <typename T>
+T& state_of(AggDataPtr state, size_t offset) {
+    return *reinterpret_cast<T*>(state + offset);
+}
+
+template <LogicalType LT>
+RunTimeCppType<LT> value_at(const Column* data, size_t i) {
+    if constexpr (is_binary_type(LT)) {
+        return static_cast<const BinaryColumn*>(data)->get_slice(i);
+    } else {
+        return reinterpret_cast<const RunTimeCppType<LT>*>(data->raw_data())[i];
+    }
+}
+
+inline Status unsupported(AggFunctionType type, LogicalType arg_type, bool is_merge) {
+    return Status::NotSupported(std::string(agg_function_name(type)) + (is_merge ? " merging " : " of ") +
+                                logical_type_to_string(arg_type));
+}
+
+// The functions over sketches (see sketch_aggregate_functions.cpp).
+StatusOr<const AggregateFunction*> get_sketch_aggregate_function(AggFunctionType type, LogicalType arg_type,
+                                                                 bool is_merge);
+
+// The functions over bitmaps (see bitmap_aggregate_functions.cpp).
+StatusOr<const AggregateFunction*> get_bitmap_aggregate_function(AggFunctionType type, LogicalType arg_type,
+                                                                 bool is_merge);
+
+} // namespace starrocks
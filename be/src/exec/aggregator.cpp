@@ -0,0 +1,447 @@
+#include "exec/aggregator.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "runtime/exec_env.h"
+
+namespace starrocks {
+
+static StatusOr<SlotDescriptor> find_slot(const RowDescriptor& desc, SlotId slot) {
+    for (const auto& s : desc) {
+        if (s.id == slot) {
+            return s;
+        }
+    }
+    return Status::NotFound("aggregation slot " + std::to_string(slot) + " not in row descriptor");
+}
+
+static StatusOr<const AggregateFunction*> resolve_function(const Aggregator::Param& param,
+                                                           const AggregateCall& call, LogicalType* arg_type) {
+    *arg_type = TYPE_UNKNOWN;
+    if (call.arg_slot >= 0) {
+        ASSIGN_OR_RETURN(SlotDescriptor arg, find_slot(param.input_row_desc, call.arg_slot));
+        *arg_type = arg.type;
+    } else if (call.type != AggFunctionType::COUNT || param.merge_input) {
+        return Status::InvalidArgument(std::string(agg_function_name(call.type)) + " needs an argument");
+    }
+    return get_aggregate_function(call.type, *arg_type, param.merge_input);
+}
+
+StatusOr<RowDescriptor> Aggregator::output_row_desc(const Param& param) {
+    if (param.group_by_slots.empty() && param.aggregates.empty()) {
+        return Status::InvalidArgument("aggregation needs a group-by key or an aggregate");
+    }
+    RowDescriptor desc;
+    for (SlotId slot : param.group_by_slots) {
+        ASSIGN_OR_RETURN(SlotDescriptor key, find_slot(param.input_row_desc, slot));
+        // Equal bitmaps need not serialize to equal bytes.
+        if (key.type == TYPE_BITMAP) {
+            return Status::InvalidArgument("GROUP BY the BITMAP slot " + std::to_string(slot));
+        }
+        desc.push_back(key);
+    }
+    for (const auto& call : param.aggregates) {
+        LogicalType arg_type;
+        ASSIGN_OR_RETURN(const AggregateFunction* fn, resolve_function(param, call, &arg_type));
+        if (param.output_intermediate) {
+            desc.push_back({call.output_slot, fn->intermediate_type(), fn->is_intermediate_nullable()});
+        } else {
+            desc.push_back({call.output_slot, fn->result_type(), fn->is_result_nullable()});
+        }
+    }
+    return desc;
+}
+
+Aggregator::Aggregator(Param param) : _param(std::move(param)) {}
+
+Aggregator::~Aggregator() {
+    close();
+}
+
+Status Aggregator::prepare(RuntimeState* state, MemTracker* mem_tracker) {
+    if (_prepared) {
+        return Status::OK();
+    }
+    ASSIGN_OR_RETURN(_output_row_desc, output_row_desc(_param));
+    Param intermediate_param = _param;
+    intermediate_param.output_intermediate = true;
+    ASSIGN_OR_RETURN(_intermediate_row_desc, output_row_desc(intermediate_param));
+    for (size_t k = 0; k < _param.group_by_slots.size(); ++k) {
+        _key_layout.types.push_back(_output_row_desc[k].type);
+        _key_layout.nullable.push_back(_output_row_desc[k].nullable);
+    }
+    for (const auto& call : _param.aggregates) {
+        LogicalType arg_type;
+        ASSIGN_OR_RETURN(const AggregateFunction* fn, resolve_function(_param, call, &arg_type));
+        _state_size = (_state_size + fn->state_align() - 1) & ~(fn->state_align() - 1);
+        _state_offsets.push_back(_state_size);
+        _state_size += fn->state_size();
+        _state_align = std::max(_state_align, fn->state_align());
+        _arg_types.push_back(arg_type);
+        _functions.push_back(fn);
+    }
+    _state_size = std::max<size_t>(_state_size, 1);
+
+    _state = state;
+    _mem_tracker = mem_tracker;
+    _pool = std::make_unique<MemPool>(state->arena());
+    if (has_group_by()) {
+        _key_kind = choose_agg_key_kind(_key_layout);
+        _init_hash_map();
+    }
+    _prepared = true;
+    return Status::OK();
+}
+
+void Aggregator::_init_hash_map() {
+    agg_key_kind_dispatch(_key_kind, [this](auto kk) {
+        _hash_map.emplace<AggHashMap<decltype(kk)::value>>(&_key_layout, _pool.get());
+    });
+}
+
+void Aggregator::close() {
+    _partition_aggregator.reset();
+    _hash_map.emplace<std::monostate>();
+    _no_key_state = nullptr;
+    _states.shrink_to_empty();
+    if (_pool != nullptr) {
+        _pool->clear();
+    }
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(_reported_mem_usage);
+        _reported_mem_usage = 0;
+    }
+}
+
+AggDataPtr Aggregator::_new_state() {
+    AggDataPtr state = _pool->allocate(_state_size, _state_align);
+    for (size_t i = 0; i < _functions.size(); ++i) {
+        _functions[i]->create(state + _state_offsets[i]);
+    }
+    return state;
+}
+
+Columns Aggregator::_key_columns(const Chunk& chunk) const {
+    Columns columns;
+    columns.reserve(_param.group_by_slots.size());
+    for (size_t k = 0; k < _param.group_by_slots.size(); ++k) {
+        columns.emplace_back(ColumnHelper::unfold_const_column(_key_layout.types[k], chunk.num_rows(),
+                                                               chunk.get_column_by_slot_id(_param.group_by_slots[k])));
+    }
+    return columns;
+}
+
+ColumnPtr Aggregator::_arg_column(const Chunk& chunk, size_t idx) const {
+    SlotId slot = _param.aggregates[idx].arg_slot;
+    if (slot < 0) {
+        return nullptr;
+    }
+    return ColumnHelper::unfold_const_column(_arg_types[idx], chunk.num_rows(), chunk.get_column_by_slot_id(slot));
+}
+
+Status Aggregator::append_chunk(const Chunk& chunk) {
+    size_t num_rows = chunk.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    _states.resize_uninitialized(num_rows);
+    AggDataPtr* states = _states.data();
+    if (has_group_by()) {
+        Columns key_columns = _key_columns(chunk);
+        std::visit(
+                [&](auto& map) {
+                    if constexpr (!std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                        map.emplace(key_columns, num_rows, states, [this] { return _new_state(); });
+                    }
+                },
+                _hash_map);
+    } else {
+        if (_no_key_state == nullptr) {
+            _no_key_state = _new_state();
+        }
+        std::fill(states, states + num_rows, _no_key_state);
+    }
+    for (size_t i = 0; i < _functions.size(); ++i) {
+        ColumnPtr arg = _arg_column(chunk, i);
+        if (_param.merge_input) {
+            _functions[i]->merge_batch(arg.get(), num_rows, _state_offsets[i], states, _pool.get());
+        } else {
+            _functions[i]->update_batch(arg.get(), num_rows, _state_offsets[i], states, _pool.get());
+        }
+    }
+    _num_input_rows += num_rows;
+    return Status::OK();
+}
+
+ChunkPtr Aggregator::convert_to_intermediate(const Chunk& chunk) const {
+    size_t num_rows = chunk.num_rows();
+    auto output = std::make_shared<Chunk>();
+    Columns key_columns = _key_columns(chunk);
+    for (size_t k = 0; k < key_columns.size(); ++k) {
+        ColumnPtr column = std::move(key_columns[k]);
+        if (_key_layout.nullable[k] && !column->is_nullable()) {
+            column = NullableColumn::create(std::move(column), NullColumn::create(num_rows, static_cast<uint8_t>(0)));
+        }
+        output->append_column(std::move(column), _param.group_by_slots[k]);
+    }
+    for (size_t i = 0; i < _functions.size(); ++i) {
+        const auto* fn = _functions[i];
+        ColumnPtr dst = ColumnHelper::create_column(fn->intermediate_type(), fn->is_intermediate_nullable());
+        fn->convert_to_intermediate(_arg_column(chunk, i).get(), num_rows, dst.get());
+        output->append_column(std::move(dst), _param.aggregates[i].output_slot);
+    }
+    return output;
+}
+
+ChunkPtr Aggregator::next_output(size_t chunk_size) {
+    return _collect_groups(chunk_size, _param.output_intermediate);
+}
+
+ChunkPtr Aggregator::_collect_groups(size_t chunk_size, bool intermediate) {
+    if (_output_done) {
+        return nullptr;
+    }
+    ChunkPtr output = create_chunk_for_row_desc(intermediate ? _intermediate_row_desc : _output_row_desc);
+    _states.resize_uninitialized(chunk_size);
+    AggDataPtr* states = _states.data();
+    size_t num_groups = 0;
+    if (has_group_by()) {
+        Columns key_columns(output->columns().begin(), output->columns().begin() + _key_layout.size());
+        std::visit(
+                [&](auto& map) {
+                    if constexpr (!std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                        num_groups = map.collect(&_output_cursor, chunk_size, &key_columns, states);
+                    }
+                },
+                _hash_map);
+        if (num_groups == 0) {
+            _output_done = true;
+            return nullptr;
+        }
+    } else {
+        if (_no_key_state == nullptr) {
+            _no_key_state = _new_state();
+        }
+        states[0] = _no_key_state;
+        num_groups = 1;
+        _output_done = true;
+    }
+    size_t num_keys = _key_layout.size();
+    for (size_t i = 0; i < _functions.size(); ++i) {
+        Column* dst = output->get_column_by_index(num_keys + i).get();
+        if (intermediate) {
+            _functions[i]->serialize_to_column(states, num_groups, _state_offsets[i], dst);
+        } else {
+            _functions[i]->finalize_to_column(states, num_groups, _state_offsets[i], dst);
+        }
+    }
+    return output;
+}
+
+void Aggregator::reset() {
+    std::visit(
+            [](auto& map) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                    map.clear();
+                }
+            },
+            _hash_map);
+    _no_key_state = nullptr;
+    _pool->clear();
+    _num_input_rows = 0;
+    _output_cursor = 0;
+    _output_done = false;
+}
+
+Status Aggregator::spill(RuntimeState* state) {
+    if (!has_group_by() || num_groups() == 0) {
+        return Status::OK();
+    }
+    if (!is_spilled()) {
+        ASSIGN_OR_RETURN(std::string dir, state->query_ctx()->spill_dir());
+        pipeline::PipelineDriverExecutor* executor = state->fragment_ctx()->executor();
+        // The sink parked on a spill backlog, and the source waiting for the
+        // last writes, re-check once the queue drains.
+        auto spiller = std::make_shared<spill::Spiller>(std::move(dir), "aggregate",
+                                                        ExecEnv::GetInstance()->spill_io_thread_pool(),
+                                                        state->instance_mem_tracker(), [executor] {
+                                                            if (executor != nullptr) {
+                                                                executor->wake_poller();
+                                                            }
+                                                        });
+        size_t num_partitions = std::max(config::spill_aggregate_partitions, 1);
+        _spill_writer = std::make_unique<spill::PartitionedSpillWriter>(spiller, _intermediate_row_desc,
+                                                                        num_partitions, state->chunk_size());
+        std::lock_guard<std::mutex> l(_spill_lock);
+        _spiller = std::move(spiller);
+    }
+    RETURN_IF_ERROR(_spill_groups());
+    reset();
+    update_mem_usage();
+    return Status::OK();
+}
+
+Status Aggregator::_spill_groups() {
+    Buffer<uint32_t> partitions;
+    uint32_t num_partitions = _spill_writer->num_partitions();
+    while (ChunkPtr chunk = _collect_groups(_state->chunk_size(), true)) {
+        size_t num_rows = chunk->num_rows();
+        Columns key_columns(chunk->columns().begin(), chunk->columns().begin() + _key_layout.size());
+        const uint64_t* hashes = std::visit(
+                [&](auto& map) -> const uint64_t* {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                        return nullptr;
+                    } else {
+                        return map.hash_keys(key_columns, num_rows);
+                    }
+                },
+                _hash_map);
+        // Re-mix the hash: the hash maps of the partitions index slots by its
+        // bits.
+        partitions.resize_uninitialized(num_rows);
+        for (size_t i = 0; i < num_rows; ++i) {
+            partitions[i] = HashUtil::fmix64(hashes[i]) % num_partitions;
+        }
+        RETURN_IF_ERROR(_spill_writer->append(*chunk, partitions.data(), 0, num_rows));
+    }
+    return Status::OK();
+}
+
+Status Aggregator::finish_spill() {
+    RETURN_IF_ERROR(_spill_groups());
+    reset();
+    update_mem_usage();
+    return _spill_writer->flush();
+}
+
+bool Aggregator::is_spilled() const {
+    std::lock_guard<std::mutex> l(_spill_lock);
+    return _spiller != nullptr;
+}
+
+bool Aggregator::is_spill_backlogged() const {
+    std::lock_guard<std::mutex> l(_spill_lock);
+    return _spiller != nullptr && _spiller->is_backlogged();
+}
+
+bool Aggregator::has_pending_spill_writes() const {
+    std::lock_guard<std::mutex> l(_spill_lock);
+    return _spiller != nullptr && _spiller->has_pending_writes();
+}
+
+StatusOr<ChunkPtr> Aggregator::next_spilled_output(size_t chunk_size) {
+    while (!_output_done) {
+        if (_partition_aggregator == nullptr) {
+            if (_next_partition == _spill_writer->num_partitions()) {
+                _output_done = true;
+                break;
+            }
+            RETURN_IF_ERROR(_restore_partition(_next_partition++));
+        }
+        ChunkPtr chunk = _partition_aggregator->next_output(chunk_size);
+        if (chunk != nullptr) {
+            return chunk;
+        }
+        _partition_aggregator.reset();
+    }
+    return nullptr;
+}
+
+// The groups of a partition may have been spilled several times over; they
+// are merged like the intermediate values of an earlier phase.
+Status Aggregator::_restore_partition(size_t partition) {
+    Param param;
+    param.input_row_desc = _intermediate_row_desc;
+    param.group_by_slots = _param.group_by_slots;
+    for (const auto& call : _param.aggregates) {
+        param.aggregates.push_back({call.type, call.output_slot, call.output_slot});
+    }
+    param.merge_input = true;
+    param.output_intermediate = _param.output_intermediate;
+    auto aggregator = std::make_unique<Aggregator>(std::move(param));
+    RETURN_IF_ERROR(aggregator->prepare(_state, _mem_tracker));
+
+    ASSIGN_OR_RETURN(spill::SpillStreamReaderPtr reader, _spiller->open_reader(_spill_writer->stream(partition)));
+    for (;;) {
+        ChunkPtr chunk;
+        Status st = reader->get_next(&chunk);
+        if (st.is_end_of_file()) {
+            break;
+        }
+        RETURN_IF_ERROR(st);
+        RETURN_IF_ERROR(aggregator->append_chunk(*chunk));
+        aggregator->update_mem_usage();
+    }
+    _partition_aggregator = std::move(aggregator);
+    return Status::OK();
+}
+
+size_t Aggregator::num_groups() const {
+    if (!has_group_by()) {
+        return _no_key_state != nullptr;
+    }
+    return std::visit(
+            [](const auto& map) -> size_t {
+                if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                    return 0;
+                } else {
+                    return map.size();
+                }
+            },
+            _hash_map);
+}
+
+size_t Aggregator::memory_usage() const {
+    size_t usage = _states.allocated_bytes() + (_pool == nullptr ? 0 : _pool->reserved_bytes());
+    return usage + std::visit(
+                           [](const auto& map) -> size_t {
+                               if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                                   return 0;
+                               } else {
+                                   return map.memory_usage();
+                               }
+                           },
+                           _hash_map);
+}
+
+size_t Aggregator::append_memory_estimate(const Chunk& chunk) const {
+    size_t num_rows = chunk.num_rows();
+    size_t table_bytes = std::visit(
+            [num_rows](const auto& map) -> size_t {
+                if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>) {
+                    return 0;
+                } else {
+                    return map.growth_bytes(num_rows);
+                }
+            },
+            _hash_map);
+    return table_bytes + num_rows * _state_size;
+}
+
+size_t Aggregator::spill_memory_estimate() const {
+    // States and copied keys are about the size of their serialized form.
+    return has_group_by() && _pool != nullptr ? _pool->allocated_bytes() : 0;
+}
+
+void Aggregator::update_mem_usage() {
+    if (_mem_tracker == nullptr) {
+        return;
+    }
+    auto usage = static_cast<int64_t>(memory_usage());
+    _mem_tracker->consume(usage - _reported_mem_usage);
+    _reported_mem_usage = usage;
+}
+
+AggregatorPtr AggregatorFactory::get_or_create(int32_t driver_sequence) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto& aggregator = _aggregators[driver_sequence];
+    if (aggregator == nullptr) {
+        aggregator = std::make_shared<Aggregator>(_param);
+    }
+    return aggregator;
+}
+
+} // namespace starrocks
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "exec/agg_hash_map.h"
+#include "exec/aggregate_function.h"
+#include "exec/spill/spiller.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_pool.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+struct AggregateCall {
+    AggFunctionType type = AggFunctionType::COUNT;
+    // Slot of the argument, -1 for COUNT(*). When merging, the slot holding
+    // this call's intermediate values.
+    SlotId arg_slot = -1;
+    SlotId output_slot = -1;
+};
+
+// Hash aggregation: GROUP BY over a hash map specialized for the shape of the
+// keys (see AggHashMap), with the aggregate states of a group in one
+// allocation from a MemPool over the query's arena.
+//
+// Rows are consumed a chunk at a time: the chunk's keys are looked up, giving
+// a state pointer per row, then every function folds its argument column into
+// those states in one call. Without GROUP BY all rows go to one group, which
+// exists, and is output, even when there are no rows.
+//
+// The same class runs either phase of a two-phase aggregation (see
+// AggregateFunction): the first from raw rows to intermediate values, the
+// second, at |merge_input|, from those to final values; one phase alone goes
+// from raw rows to final values.
+//
+// A blocking aggregation spills when the query crosses its spill threshold:
+// the groups so far are written out as intermediate values, split by key hash
+// into config::spill_aggregate_partitions partitions, and aggregation goes on
+// with an empty table. The groups left at the end follow, and the output is
+// then produced a partition at a time, by merging the partition's spilled
+// groups in an Aggregator of their own.
+class Aggregator {
+public:
+    struct Param {
+        RowDescriptor input_row_desc;
+        std::vector<SlotId> group_by_slots;
+        std::vector<AggregateCall> aggregates;
+        // The input holds intermediate values of an earlier phase.
+        bool merge_input = false;
+        // Output intermediate values for a later phase, not final ones.
+        bool output_intermediate = false;
+    };
+
+    explicit Aggregator(Param param);
+    ~Aggregator();
+
+    DISALLOW_COPY_AND_MOVE(Aggregator);
+
+    // Layout of the output: the group-by slots, then one slot per call.
+    static StatusOr<RowDescriptor> output_row_desc(const Param& param);
+
+    // Idempotent. Validates the parameters and picks the key layout; the size
+    // of the groups is reported to |mem_tracker|, which may be null.
+    Status prepare(RuntimeState* state, MemTracker* mem_tracker);
+    // Releases the groups.
+    void close();
+
+    const Param& param() const { return _param; }
+    const RowDescriptor& output_row_desc() const { return _output_row_desc; }
+    bool has_group_by() const { return !_param.group_by_slots.empty(); }
+    AggKeyKind key_kind() const { return _key_kind; }
+
+    // Folds the rows of |chunk| into their groups.
+    Status append_chunk(const Chunk& chunk);
+
+    // The rows of |chunk| as if each was a group of its own, in output
+    // layout: what a first phase emits for rows it does not aggregate.
+    ChunkPtr convert_to_intermediate(const Chunk& chunk) const;
+
+    // Emits the groups, at most |chunk_size| per call; returns nullptr after
+    // the last one. Groups must not be added in between.
+    ChunkPtr next_output(size_t chunk_size);
+    bool is_output_done() const { return _output_done; }
+
+    // Drops every group; aggregation starts over.
+    void reset();
+
+    // Spills the groups, if any; see the class comment. Without GROUP BY,
+    // whose only group stays small, does nothing.
+    Status spill(RuntimeState* state);
+    // Spills the remaining groups once all input is in. Only after spill().
+    Status finish_spill();
+    bool is_spilled() const;
+    // The sink holds back input while spill writes queue up.
+    bool is_spill_backlogged() const;
+    // The partitions cannot be read back before the writes drain.
+    bool has_pending_spill_writes() const;
+    // next_output() of a spilled aggregation: merges the partitions one after
+    // the other.
+    StatusOr<ChunkPtr> next_spilled_output(size_t chunk_size);
+
+    size_t num_groups() const;
+    // Rows folded into the current groups.
+    int64_t num_input_rows() const { return _num_input_rows; }
+    // Bytes held by the hash map, the states and the keys.
+    size_t memory_usage() const;
+    // Bound on what append_chunk(|chunk|) adds to that, short of string keys,
+    // were every row a new group.
+    size_t append_memory_estimate(const Chunk& chunk) const;
+    // About what spill() holds while it writes the groups out: their keys and
+    // intermediate values, queued for the writes.
+    size_t spill_memory_estimate() const;
+    // Reports memory_usage() to the tracker given to prepare().
+    void update_mem_usage();
+
+    // Blocking aggregation: the sink driver is done and the source driver
+    // may emit.
+    void set_sink_complete() { _sink_complete.store(true, std::memory_order_release); }
+    bool is_sink_complete() const { return _sink_complete.load(std::memory_order_acquire); }
+
+private:
+    using HashMapVariant = std::variant<std::monostate, AggHashMap<AggKeyKind::kNumber8>,
+                                        AggHashMap<AggKeyKind::kNumber16>, AggHashMap<AggKeyKind::kNumber32>,
+                                        AggHashMap<AggKeyKind::kNumber64>, AggHashMap<AggKeyKind::kFixed64>,
+                                        AggHashMap<AggKeyKind::kFixed128>, AggHashMap<AggKeyKind::kString>,
+                                        AggHashMap<AggKeyKind::kSerialized>>;
+
+    Columns _key_columns(const Chunk& chunk) const;
+    // The argument of call |idx|, unfolded; null for COUNT(*).
+    ColumnPtr _arg_column(const Chunk& chunk, size_t idx) const;
+    AggDataPtr _new_state();
+    void _init_hash_map();
+    ChunkPtr _collect_groups(size_t chunk_size, bool intermediate);
+    Status _spill_groups();
+    Status _restore_partition(size_t partition);
+
+    const Param _param;
+    bool _prepared = false;
+    RuntimeState* _state = nullptr;
+    MemTracker* _mem_tracker = nullptr;
+    int64_t _reported_mem_usage = 0;
+    RowDescriptor _output_row_desc;
+    // The output layout with intermediate values, which spilled groups take.
+    RowDescriptor _intermediate_row_desc;
+
+    AggKeyLayout _key_layout;
+    AggKeyKind _key_kind = AggKeyKind::kSerialized;
+    std::vector<LogicalType> _arg_types;
+    std::vector<const AggregateFunction*> _functions;
+    // Offset of each function's state within a group's state.
+    std::vector<size_t> _state_offsets;
+    size_t _state_size = 0;
+    size_t _state_align = 1;
+
+    std::unique_ptr<MemPool> _pool;
+    HashMapVariant _hash_map;
+    // The only group when there is no GROUP BY; created on first use.
+    AggDataPtr _no_key_state = nullptr;
+    Buffer<AggDataPtr> _states;
+    int64_t _num_input_rows = 0;
+
+    size_t _output_cursor = 0;
+    bool _output_done = false;
+
+    // Spilling. The writer is only used by the sink, then the rest by the
+    // source; |_spill_lock| guards the Spiller for the poller's checks.
+    mutable std::mutex _spill_lock;
+    spill::SpillerPtr _spiller;
+    std::unique_ptr<spill::PartitionedSpillWriter> _spill_writer;
+    size_t _next_partition = 0;
+    std::unique_ptr<Aggregator> _partition_aggregator;
+
+    std::atomic<bool> _sink_complete{false};
+};
+
+using AggregatorPtr = std::shared_ptr<Aggregator>;
+
+// The Aggregators of the drivers of one blocking aggregation, one per driver
+// sequence: the sink and the source driver with the same sequence share one.
+// Groups are not combined across drivers, so rows of a group must all reach
+// the same sink driver, as they do behind a shuffle or with a single driver.
+class AggregatorFactory {
+public:
+    explicit AggregatorFactory(Aggregator::Param param) : _param(std::move(param)) {}
+
+    const Aggregator::Param& param() const { return _param; }
+
+    AggregatorPtr get_or_create(int32_t driver_sequence);
+
+private:
+    const Aggregator::Param _param;
+    std::mutex _lock;
+    std::unordered_map<int32_t, AggregatorPtr> _aggregators;
+};
+
+using AggregatorFactoryPtr = std::shared_ptr<AggregatorFactory>;
+
+} // namespace starrocks
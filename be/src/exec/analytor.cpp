@@ -0,0 +1,514 @@
+#include "exec/analytor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "column/column_helper.h"
+
+namespace starrocks {
+
+static StatusOr<SlotDescriptor> find_slot(const RowDescriptor& desc, SlotId slot) {
+    for (const auto& s : desc) {
+        if (s.id == slot) {
+            return s;
+        }
+    }
+    return Status::NotFound("window slot " + std::to_string(slot) + " not in row descriptor");
+}
+
+static int64_t saturating_add(int64_t a, int64_t b) {
+    int64_t res;
+    if (__builtin_add_overflow(a, b, &res)) {
+        return b > 0 ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    }
+    return res;
+}
+
+static bool is_offset_bound(const WindowFrameBound& bound) {
+    return bound.kind == WindowFrameBound::PRECEDING || bound.kind == WindowFrameBound::FOLLOWING;
+}
+
+static bool has_range_offset(const WindowFrame& frame) {
+    return frame.type == WindowFrameType::RANGE && (is_offset_bound(frame.start) || is_offset_bound(frame.end));
+}
+
+static Status check_frame(const Analytor::Param& param, const WindowCall& call, const RowDescriptor& input) {
+    const WindowFrame& frame = call.frame;
+    if (frame.start.kind == WindowFrameBound::UNBOUNDED_FOLLOWING ||
+        frame.end.kind == WindowFrameBound::UNBOUNDED_PRECEDING) {
+        return Status::InvalidArgument(std::string("invalid frame for ") + window_function_name(call.type));
+    }
+    if (frame.start.offset < 0 || frame.end.offset < 0) {
+        return Status::InvalidArgument("negative frame offset");
+    }
+    if (!has_range_offset(frame)) {
+        return Status::OK();
+    }
+    if (param.order_descs.size() != 1) {
+        return Status::InvalidArgument("RANGE frame with an offset needs exactly one ORDER BY key");
+    }
+    ASSIGN_OR_RETURN(SlotDescriptor key, find_slot(input, param.order_descs[0].slot_id));
+    if (!is_integer_type(key.type) && !is_float_type(key.type) && key.type != TYPE_DATE &&
+        key.type != TYPE_DATETIME) {
+        return Status::InvalidArgument("RANGE frame with an offset over an ORDER BY key of type " +
+                                       logical_type_to_string(key.type));
+    }
+    return Status::OK();
+}
+
+static StatusOr<WindowFunctionPtr> resolve_function(const Analytor::Param& param, const WindowCall& call) {
+    LogicalType arg_type = TYPE_UNKNOWN;
+    if (call.arg_slot >= 0) {
+        ASSIGN_OR_RETURN(SlotDescriptor arg, find_slot(param.input_row_desc, call.arg_slot));
+        arg_type = arg.type;
+    }
+    if ((call.type == WindowFunctionType::LAG || call.type == WindowFunctionType::LEAD) && call.offset < 0) {
+        return Status::InvalidArgument(std::string("negative offset of ") + window_function_name(call.type));
+    }
+    if (!is_ranking_function(call.type) && call.type != WindowFunctionType::LAG &&
+        call.type != WindowFunctionType::LEAD) {
+        RETURN_IF_ERROR(check_frame(param, call, param.input_row_desc));
+    }
+    return create_window_function(call.type, arg_type, call.default_value);
+}
+
+// Sets flags[i - from] for each row i in [from, to) whose value differs from
+// that of row i - 1; |from| > 0. NULLs equal each other, and so do NaNs.
+static void mark_changes(LogicalType type, const Column* column, size_t from, size_t to, uint8_t* flags) {
+    const NullData* null_data = ColumnHelper::get_null_data(column);
+    const uint8_t* nulls = null_data == nullptr ? nullptr : null_data->data();
+    const Column* data = ColumnHelper::get_data_column(column);
+    type_dispatch_all(type, [&](auto lt) {
+        constexpr LogicalType LT = decltype(lt)::value;
+        for (size_t i = from; i < to; ++i) {
+            bool changed;
+            if (nulls != nullptr && (nulls[i] || nulls[i - 1])) {
+                changed = nulls[i] != nulls[i - 1];
+            } else if constexpr (is_binary_type(LT)) {
+                const auto* binary = static_cast<const BinaryColumn*>(data);
+                changed = binary->get_slice(i) != binary->get_slice(i - 1);
+            } else {
+                const auto* values = reinterpret_cast<const RunTimeCppType<LT>*>(data->raw_data());
+                changed = values[i] != values[i - 1];
+                if constexpr (is_float_type(LT)) {
+                    changed = changed && !(std::isnan(values[i]) && std::isnan(values[i - 1]));
+                }
+            }
+            flags[i - from] |= changed;
+        }
+    });
+}
+
+StatusOr<RowDescriptor> Analytor::output_row_desc(const Param& param) {
+    if (param.calls.empty()) {
+        return Status::InvalidArgument("analytic without window functions");
+    }
+    RowDescriptor desc = param.input_row_desc;
+    for (const auto& call : param.calls) {
+        ASSIGN_OR_RETURN(WindowFunctionPtr fn, resolve_function(param, call));
+        desc.push_back({call.output_slot, fn->result_type(), fn->is_result_nullable()});
+    }
+    return desc;
+}
+
+Analytor::Analytor(Param param) : _param(std::move(param)) {}
+
+Analytor::~Analytor() {
+    close();
+}
+
+Status Analytor::prepare(RuntimeState* state, MemTracker* mem_tracker) {
+    if (_prepared) {
+        return Status::OK();
+    }
+    ASSIGN_OR_RETURN(_output_row_desc, output_row_desc(_param));
+    auto index_of = [&](SlotId slot) -> StatusOr<int32_t> {
+        for (size_t i = 0; i < _param.input_row_desc.size(); ++i) {
+            if (_param.input_row_desc[i].id == slot) {
+                return static_cast<int32_t>(i);
+            }
+        }
+        return Status::NotFound("window slot " + std::to_string(slot) + " not in row descriptor");
+    };
+    // Partitions and peers are told apart by the keys' bytes, which for equal
+    // bitmaps need not be equal.
+    auto key_index_of = [&](SlotId slot) -> StatusOr<int32_t> {
+        ASSIGN_OR_RETURN(int32_t idx, index_of(slot));
+        if (_param.input_row_desc[idx].type == TYPE_BITMAP) {
+            return Status::InvalidArgument("window partitioned or ordered by the BITMAP slot " + std::to_string(slot));
+        }
+        return idx;
+    };
+    for (SlotId slot : _param.partition_slots) {
+        ASSIGN_OR_RETURN(int32_t idx, key_index_of(slot));
+        _partition_indexes.push_back(idx);
+    }
+    for (const auto& desc : _param.order_descs) {
+        ASSIGN_OR_RETURN(int32_t idx, key_index_of(desc.slot_id));
+        _order_indexes.push_back(idx);
+    }
+    for (const auto& call : _param.calls) {
+        CallState c;
+        ASSIGN_OR_RETURN(c.function, resolve_function(_param, call));
+        if (call.arg_slot >= 0) {
+            ASSIGN_OR_RETURN(c.arg_index, index_of(call.arg_slot));
+        }
+        if (call.type == WindowFunctionType::LAG) {
+            c.has_frame = true;
+            c.frame.type = WindowFrameType::ROWS;
+            c.frame.start = c.frame.end = {WindowFrameBound::PRECEDING, call.offset};
+        } else if (call.type == WindowFunctionType::LEAD) {
+            c.has_frame = true;
+            c.frame.type = WindowFrameType::ROWS;
+            c.frame.start = c.frame.end = {WindowFrameBound::FOLLOWING, call.offset};
+        } else if (!is_ranking_function(call.type)) {
+            c.has_frame = true;
+            c.frame = call.frame;
+            if (has_range_offset(c.frame)) {
+                _range_type = _param.input_row_desc[_order_indexes[0]].type;
+            }
+            _needs_peer_end |= c.frame.type == WindowFrameType::RANGE;
+        }
+        _calls.push_back(std::move(c));
+    }
+    _chunk_size = state->chunk_size();
+    _mem_tracker = mem_tracker;
+    _buffer = create_chunk_for_row_desc(_param.input_row_desc);
+    _prepared = true;
+    return Status::OK();
+}
+
+void Analytor::close() {
+    _buffer.reset();
+    _output.reset();
+    _partition_starts.shrink_to_empty();
+    _peer_starts.shrink_to_empty();
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(_reported_mem_usage);
+        _reported_mem_usage = 0;
+    }
+}
+
+Status Analytor::append_chunk(const Chunk& chunk) {
+    size_t num_rows = chunk.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    size_t from = _buffer->num_rows();
+    for (size_t i = 0; i < _param.input_row_desc.size(); ++i) {
+        const SlotDescriptor& slot = _param.input_row_desc[i];
+        ColumnPtr column = ColumnHelper::unfold_const_column(slot.type, num_rows, chunk.get_column_by_slot_id(slot.id));
+        _buffer->get_column_by_index(i)->append(*column, 0, num_rows);
+    }
+    _num_input_rows += static_cast<int64_t>(num_rows);
+    _mark_boundaries(from);
+    _compute(_chunk_size - _num_ready_rows());
+    return Status::OK();
+}
+
+void Analytor::set_input_finished() {
+    _input_finished = true;
+    _compute(_chunk_size - _num_ready_rows());
+}
+
+ChunkPtr Analytor::next_output() {
+    if (!has_output()) {
+        return nullptr;
+    }
+    ChunkPtr chunk = std::move(_output);
+    _compute(_chunk_size);
+    return chunk;
+}
+
+size_t Analytor::memory_usage() const {
+    size_t usage = _partition_starts.allocated_bytes() + _peer_starts.allocated_bytes();
+    if (_buffer != nullptr) {
+        usage += _buffer->memory_usage();
+    }
+    if (_output != nullptr) {
+        usage += _output->memory_usage();
+    }
+    return usage;
+}
+
+void Analytor::update_mem_usage() {
+    if (_mem_tracker == nullptr) {
+        return;
+    }
+    auto usage = static_cast<int64_t>(memory_usage());
+    _mem_tracker->consume(usage - _reported_mem_usage);
+    _reported_mem_usage = usage;
+}
+
+void Analytor::_mark_boundaries(size_t from) {
+    size_t to = _buffer->num_rows();
+    _partition_starts.resize(to, uint8_t{0});
+    _peer_starts.resize(to, uint8_t{0});
+    // Rows are compared with the row before, which the buffer always keeps,
+    // except for the first row of the input.
+    size_t first_compared = std::max<size_t>(from, 1);
+    if (from == 0) {
+        _partition_starts[0] = 1;
+    }
+    for (int32_t idx : _partition_indexes) {
+        mark_changes(_param.input_row_desc[idx].type, _buffer->get_column_by_index(idx).get(), first_compared, to,
+                     _partition_starts.data() + first_compared);
+    }
+    for (int32_t idx : _order_indexes) {
+        mark_changes(_param.input_row_desc[idx].type, _buffer->get_column_by_index(idx).get(), first_compared, to,
+                     _peer_starts.data() + first_compared);
+    }
+    for (size_t i = from; i < to; ++i) {
+        _peer_starts[i] |= _partition_starts[i];
+    }
+}
+
+void Analytor::_start_partition(int64_t row) {
+    _partition_start = row;
+    _partition_end = -1;
+    _peer_start = row;
+    for (auto& c : _calls) {
+        c.function->reset();
+        c.frame_start = c.frame_end = row;
+    }
+}
+
+void Analytor::_find_partition_end() {
+    if (_partition_end >= 0) {
+        return;
+    }
+    _partition_scan = std::max(_partition_scan, _partition_start + 1);
+    while (_partition_scan < _num_input_rows && !_partition_starts[_partition_scan - _base]) {
+        ++_partition_scan;
+    }
+    if (_partition_scan < _num_input_rows || _input_finished) {
+        _partition_end = _partition_scan;
+    }
+}
+
+int64_t Analytor::_peer_end(int64_t peer_start) {
+    if (_peer_scan_group != peer_start) {
+        // Rows of the group dropped from the buffer did not end it.
+        _peer_scan_group = peer_start;
+        _peer_scan = std::max(peer_start + 1, _base);
+    }
+    int64_t limit = _partition_end >= 0 ? _partition_end : _num_input_rows;
+    while (_peer_scan < limit && !_peer_starts[_peer_scan - _base]) {
+        ++_peer_scan;
+    }
+    return _peer_scan < limit || _partition_end >= 0 ? _peer_scan : -1;
+}
+
+void Analytor::_compute(size_t max_rows) {
+    size_t num_computed = 0;
+    while (num_computed < max_rows && _next_row < _num_input_rows) {
+        if (_partition_starts[_next_row - _base] && _next_row != _partition_start) {
+            _start_partition(_next_row);
+        }
+        _find_partition_end();
+        int64_t limit = _partition_end >= 0 ? _partition_end : _num_input_rows;
+        auto num_rows = static_cast<size_t>(std::min<int64_t>(limit - _next_row, max_rows - num_computed));
+
+        _rows.resize(num_rows);
+        _peer_ends.resize(num_rows);
+        int64_t peer_start = _peer_start;
+        for (size_t i = 0; i < num_rows; ++i) {
+            int64_t row = _next_row + static_cast<int64_t>(i);
+            if (_peer_starts[row - _base]) {
+                peer_start = row;
+            }
+            _rows[i] = {row, _partition_start, peer_start, row, row + 1};
+            _peer_ends[i] = _needs_peer_end ? _peer_end(peer_start) : -1;
+        }
+        size_t num_ready = num_rows;
+        for (auto& c : _calls) {
+            if (!c.has_frame) {
+                c.rows.assign(_rows.begin(), _rows.begin() + num_ready);
+                continue;
+            }
+            num_ready = type_dispatch_all(_range_type, [&](auto lt) {
+                constexpr LogicalType LT = decltype(lt)::value;
+                // Other types never have a RANGE offset (see check_frame()).
+                if constexpr (is_binary_type(LT) || LT == TYPE_BOOLEAN) {
+                    return _compute_frames<TYPE_BIGINT>(&c, num_ready);
+                } else {
+                    return _compute_frames<LT>(&c, num_ready);
+                }
+            });
+        }
+        if (num_ready == 0) {
+            break;
+        }
+
+        if (_output == nullptr) {
+            _output = create_chunk_for_row_desc(_output_row_desc);
+        }
+        size_t num_inputs = _param.input_row_desc.size();
+        for (size_t i = 0; i < num_inputs; ++i) {
+            _output->get_column_by_index(i)->append(*_buffer->get_column_by_index(i), _next_row - _base, num_ready);
+        }
+        for (size_t k = 0; k < _calls.size(); ++k) {
+            CallState& c = _calls[k];
+            const Column* arg = c.arg_index < 0 ? nullptr : _buffer->get_column_by_index(c.arg_index).get();
+            c.function->get_values(arg, _base, c.rows.data(), num_ready,
+                                   _output->get_column_by_index(num_inputs + k).get());
+            if (c.has_frame) {
+                c.frame_start = c.rows[num_ready - 1].frame_start;
+                c.frame_end = c.rows[num_ready - 1].frame_end;
+            }
+        }
+        _peer_start = _rows[num_ready - 1].peer_start;
+        _next_row += static_cast<int64_t>(num_ready);
+        num_computed += num_ready;
+        if (num_ready < num_rows) {
+            break;
+        }
+    }
+    _trim();
+}
+
+template <LogicalType OrderLT>
+size_t Analytor::_compute_frames(CallState* call, size_t num_rows) {
+    const WindowFrame& frame = call->frame;
+    bool is_range = frame.type == WindowFrameType::RANGE;
+    bool partition_known = _partition_end >= 0;
+    int64_t limit = partition_known ? _partition_end : _num_input_rows;
+
+    // RANGE offsets: order values, widened, and how rows relate to a target
+    // value in sort order.
+    const RunTimeCppType<OrderLT>* values = nullptr;
+    const uint8_t* nulls = nullptr;
+    bool is_asc = true;
+    bool is_null_first = true;
+    if (has_range_offset(frame)) {
+        const Column* column = _buffer->get_column_by_index(_order_indexes[0]).get();
+        const NullData* null_data = ColumnHelper::get_null_data(column);
+        nulls = null_data == nullptr ? nullptr : null_data->data();
+        values = reinterpret_cast<const RunTimeCppType<OrderLT>*>(ColumnHelper::get_data_column(column)->raw_data());
+        is_asc = _param.order_descs[0].is_asc;
+        is_null_first = _param.order_descs[0].is_null_first;
+    }
+    using Wide = std::conditional_t<is_float_type(OrderLT), double, int64_t>;
+    auto is_unordered = [&](int64_t row) {
+        size_t idx = row - _base;
+        if (nulls != nullptr && nulls[idx]) {
+            return true;
+        }
+        if constexpr (is_float_type(OrderLT)) {
+            return std::isnan(values[idx]);
+        }
+        return false;
+    };
+    // Negative, zero or positive as |row| sorts before, with or after |target|.
+    auto compare = [&](int64_t row, Wide target) -> int {
+        size_t idx = row - _base;
+        if (nulls != nullptr && nulls[idx]) {
+            return is_null_first ? -1 : 1;
+        }
+        Wide value = values[idx];
+        if constexpr (is_float_type(OrderLT)) {
+            // NaN is above every value.
+            if (std::isnan(value)) {
+                return is_asc ? 1 : -1;
+            }
+        }
+        int res = value < target ? -1 : (value > target ? 1 : 0);
+        return is_asc ? res : -res;
+    };
+    // |row|'s key moved by |offset| in sort order.
+    auto target_of = [&](int64_t row, int64_t offset) -> Wide {
+        Wide value = values[row - _base];
+        if constexpr (is_float_type(OrderLT)) {
+            return is_asc ? value + offset : value - offset;
+        } else {
+            return saturating_add(value, is_asc ? offset : -offset);
+        }
+    };
+
+    // Position of |bound| for row i: the first row of the frame for the start,
+    // the first row after it for the end. False while unknown.
+    auto locate = [&](const WindowFrameBound& bound, bool is_start, size_t i, int64_t* cursor) {
+        const WindowRow& row = _rows[i];
+        int64_t pos = 0;
+        switch (bound.kind) {
+        case WindowFrameBound::UNBOUNDED_PRECEDING:
+            *cursor = _partition_start;
+            return true;
+        case WindowFrameBound::UNBOUNDED_FOLLOWING:
+            *cursor = limit;
+            return partition_known;
+        case WindowFrameBound::CURRENT_ROW:
+            if (!is_range) {
+                pos = is_start ? row.row : row.row + 1;
+                break;
+            }
+            *cursor = is_start ? row.peer_start : _peer_ends[i];
+            return *cursor >= 0;
+        case WindowFrameBound::PRECEDING:
+        case WindowFrameBound::FOLLOWING: {
+            int64_t offset = bound.kind == WindowFrameBound::PRECEDING ? -bound.offset : bound.offset;
+            if (!is_range) {
+                pos = saturating_add(row.row, is_start ? offset : saturating_add(offset, 1));
+                break;
+            }
+            if (is_unordered(row.row)) {
+                *cursor = is_start ? row.peer_start : _peer_ends[i];
+                return *cursor >= 0;
+            }
+            Wide target = target_of(row.row, offset);
+            int64_t c = std::max(*cursor, _partition_start);
+            while (c < limit && (is_start ? compare(c, target) < 0 : compare(c, target) <= 0)) {
+                ++c;
+            }
+            *cursor = c;
+            return c < limit || partition_known;
+        }
+        }
+        if (!partition_known && pos > limit) {
+            return false;
+        }
+        *cursor = std::clamp(pos, _partition_start, limit);
+        return true;
+    };
+
+    call->rows.resize(num_rows);
+    int64_t start = call->frame_start;
+    int64_t end = call->frame_end;
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (!locate(frame.start, true, i, &start) || !locate(frame.end, false, i, &end)) {
+            return i;
+        }
+        start = std::min(start, end);
+        WindowRow& row = call->rows[i];
+        row = _rows[i];
+        row.frame_start = start;
+        row.frame_end = end;
+    }
+    return num_rows;
+}
+
+void Analytor::_trim() {
+    if (_num_input_rows == 0) {
+        return;
+    }
+    int64_t keep = std::min(_next_row, _num_input_rows - 1);
+    for (const auto& c : _calls) {
+        if (c.has_frame && _next_row > _partition_start) {
+            keep = std::min(keep, c.frame_start);
+        }
+    }
+    auto num_dropped = static_cast<size_t>(keep - _base);
+    size_t num_kept = _buffer->num_rows() - num_dropped;
+    if (num_dropped < std::max(_chunk_size, num_kept)) {
+        return;
+    }
+    ChunkPtr buffer = _buffer->clone_empty(num_kept);
+    buffer->append(*_buffer, num_dropped, num_kept);
+    _buffer = std::move(buffer);
+    _partition_starts.erase(_partition_starts.begin(), _partition_starts.begin() + num_dropped);
+    _peer_starts.erase(_peer_starts.begin(), _peer_starts.begin() + num_dropped);
+    _base = keep;
+}
+
+} // namespace starrocks
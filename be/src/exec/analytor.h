@@ -0,0 +1,160 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "column/buffer.h"
+#include "column/chunk.h"
+#include "exec/sort_key.h"
+#include "exec/window_function.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+struct WindowCall {
+    WindowFunctionType type = WindowFunctionType::ROW_NUMBER;
+    // Slot of the argument, -1 for none (ranking functions, COUNT(*)).
+    SlotId arg_slot = -1;
+    SlotId output_slot = -1;
+    // LAG and LEAD: how many rows back or ahead to read, and the value past
+    // the edge of the partition.
+    int64_t offset = 1;
+    Datum default_value;
+    // Aggregates only.
+    WindowFrame frame;
+};
+
+// Window functions over input sorted by the PARTITION BY keys, then by the
+// ORDER BY keys (see SortContext); rows of a partition must all reach the
+// same driver. The output is the input with one more column per call.
+//
+// Rows are buffered as they come and computed a batch at a time as soon as
+// every frame they need has arrived: with ROWS BETWEEN 6 PRECEDING AND
+// CURRENT ROW a row is ready on arrival, with a frame up to the end of the
+// partition not before the partition ends. Rows no frame can reach anymore
+// are dropped from the buffer, so a moving window over a huge partition only
+// holds the window. Frame bounds move forward with monotonic cursors, and the
+// aggregates slide their value from one frame to the next (see
+// WindowFunction), so each row costs O(1) whatever the frame.
+class Analytor {
+public:
+    struct Param {
+        RowDescriptor input_row_desc;
+        std::vector<SlotId> partition_slots;
+        // Only equality of the keys matters, except for RANGE frames with an
+        // offset, which take a single numeric or date key.
+        SortDescs order_descs;
+        std::vector<WindowCall> calls;
+    };
+
+    explicit Analytor(Param param);
+    ~Analytor();
+
+    DISALLOW_COPY_AND_MOVE(Analytor);
+
+    // Layout of the output: the input slots, then one slot per call.
+    static StatusOr<RowDescriptor> output_row_desc(const Param& param);
+
+    // Validates the parameters; the buffered rows are reported to
+    // |mem_tracker|, which may be null.
+    Status prepare(RuntimeState* state, MemTracker* mem_tracker);
+    void close();
+
+    const Param& param() const { return _param; }
+    const RowDescriptor& output_row_desc() const { return _output_row_desc; }
+
+    Status append_chunk(const Chunk& chunk);
+    // The input is exhausted: the last partition ends.
+    void set_input_finished();
+    bool is_input_finished() const { return _input_finished; }
+
+    // Computed rows are emitted a chunk at a time; more input is only needed
+    // while less than that is ready.
+    bool has_output() const { return _num_ready_rows() > 0; }
+    bool need_input() const { return !_input_finished && _num_ready_rows() < _chunk_size; }
+    // The computed rows, at most a chunk of them; nullptr when there are none.
+    ChunkPtr next_output();
+    bool is_output_done() const { return _input_finished && _next_row == _num_input_rows && !has_output(); }
+
+    // Rows held for computing later rows or not computed yet.
+    size_t num_buffered_rows() const { return _buffer == nullptr ? 0 : _buffer->num_rows(); }
+    size_t memory_usage() const;
+    // Reports memory_usage() to the tracker given to prepare().
+    void update_mem_usage();
+
+private:
+    struct CallState {
+        WindowFunctionPtr function;
+        // Index of the argument in the buffer, -1 for none.
+        int32_t arg_index = -1;
+        // The frame the function reads; LAG and LEAD read a one-row frame.
+        bool has_frame = false;
+        WindowFrame frame;
+        // Frame of the last computed row: where the cursors resume.
+        int64_t frame_start = 0;
+        int64_t frame_end = 0;
+        std::vector<WindowRow> rows;
+    };
+
+    size_t _num_ready_rows() const { return _output == nullptr ? 0 : _output->num_rows(); }
+
+    // Marks the rows of the buffer from |from| on that start a partition or a
+    // peer group.
+    void _mark_boundaries(size_t from);
+    void _start_partition(int64_t row);
+    void _find_partition_end();
+    // End of the peer group starting at |peer_start|, -1 while unknown.
+    int64_t _peer_end(int64_t peer_start);
+    // Computes up to |max_rows| more rows into _output.
+    void _compute(size_t max_rows);
+    // Frames of the first |num_rows| rows of _rows for |call|; returns how
+    // many could be determined.
+    template <LogicalType OrderLT>
+    size_t _compute_frames(CallState* call, size_t num_rows);
+    // Drops the rows before those still needed.
+    void _trim();
+
+    const Param _param;
+    bool _prepared = false;
+    MemTracker* _mem_tracker = nullptr;
+    int64_t _reported_mem_usage = 0;
+    size_t _chunk_size = 0;
+    RowDescriptor _output_row_desc;
+    std::vector<int32_t> _partition_indexes;
+    std::vector<int32_t> _order_indexes;
+    // Type of the ORDER BY key if a RANGE frame has an offset.
+    LogicalType _range_type = TYPE_BIGINT;
+    bool _needs_peer_end = false;
+    std::vector<CallState> _calls;
+
+    // Rows are numbered from the start of the input; row _base is the first
+    // row of _buffer.
+    ChunkPtr _buffer;
+    int64_t _base = 0;
+    int64_t _num_input_rows = 0;
+    Buffer<uint8_t> _partition_starts;
+    Buffer<uint8_t> _peer_starts;
+    bool _input_finished = false;
+
+    int64_t _next_row = 0;
+    int64_t _partition_start = 0;
+    // -1 until the next partition (or the input's end) has been seen.
+    int64_t _partition_end = -1;
+    int64_t _partition_scan = 0;
+    // Peer group of the last computed row.
+    int64_t _peer_start = 0;
+    int64_t _peer_scan_group = -1;
+    int64_t _peer_scan = 0;
+    // Common part of the rows being computed, and their peer group ends.
+    std::vector<WindowRow> _rows;
+    std::vector<int64_t> _peer_ends;
+
+    // Computed rows in output layout, at most a chunk of them.
+    ChunkPtr _output;
+};
+
+using AnalytorPtr = std::shared_ptr<Analytor>;
+
+} // namespace starrocks
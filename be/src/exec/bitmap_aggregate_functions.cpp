@@ -0,0 +1,248 @@
+#include <type_traits>
+
+#include "exec/aggregate_function_helper.h"
+#include "runtime/mem_pool.h"
+#include "util/roaring_bitmap.h"
+
+namespace starrocks {
+
+// The aggregate functions over roaring bitmaps. Their intermediate values,
+// and the results of all but BITMAP_UNION_COUNT, are BITMAP values, so the
+// scalar bitmap functions (bitmap_count(), bitmap_and()...) take them.
+//
+// A state is a RoaringBitmap whose containers come from the pool; the
+// bitmaps merged into it are read into scratch memory and united or
+// intersected with it container by container, never expanded into their
+// values. BITMAP values that do not parse are skipped like NULLs, and so are
+// the negative values BITMAP_AGG sees.
+
+struct BitmapUnionState {
+    static constexpr bool kNullable = false;
+
+    RoaringBitmap bitmap;
+
+    void merge(const RoaringBitmap& other, MemPool* pool) { bitmap.union_with(other, pool); }
+};
+
+// The intersection of the bitmaps merged so far; NULL before the first.
+struct BitmapIntersectState {
+    static constexpr bool kNullable = true;
+
+    RoaringBitmap bitmap;
+    bool has_value = false;
+
+    void merge(const RoaringBitmap& other, MemPool* pool) {
+        if (has_value) {
+            bitmap.intersect_with(other);
+        } else {
+            bitmap.union_with(other, pool);
+            has_value = true;
+        }
+    }
+};
+
+// The bitmaps read from one row at a time are dropped every so often.
+static void recycle(MemPool* scratch) {
+    if (scratch->allocated_bytes() > MemPool::kMaxChunkSize) {
+        scratch->clear();
+    }
+}
+
+static void append_bitmap(const RoaringBitmap& bitmap, Buffer<uint8_t>* buf, BinaryColumn* dst) {
+    buf->clear();
+    bitmap.serialize(buf);
+    dst->append(Slice(buf->data(), buf->size()));
+}
+
+// The bitmap of the values merged or aggregated, as result and intermediate
+// value.
+template <typename State>
+class BitmapFunction : public AggregateFunction {
+public:
+    explicit BitmapFunction(AggFunctionType type) : _type(type) {}
+
+    AggFunctionType type() const override { return _type; }
+    LogicalType intermediate_type() const override { return TYPE_BITMAP; }
+    bool is_intermediate_nullable() const override { return State::kNullable; }
+    LogicalType result_type() const override { return TYPE_BITMAP; }
+    bool is_result_nullable() const override { return State::kNullable; }
+
+    size_t state_size() const override { return sizeof(State); }
+    size_t state_align() const override { return alignof(State); }
+    void create(AggDataPtr state) const override { new (state) State(); }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        const uint8_t* nulls;
+        const auto* bitmaps = static_cast<const BinaryColumn*>(unpack_nullable(intermediate, &nulls));
+        MemPool scratch;
+        RoaringBitmap bitmap;
+        for (size_t i = 0; i < num_rows; ++i) {
+            Slice input = bitmaps->get_slice(i);
+            if ((nulls == nullptr || !nulls[i]) && RoaringBitmap::deserialize(&input, &bitmap, &scratch)) {
+                state_of<State>(states[i], offset).merge(bitmap, pool);
+            }
+            recycle(&scratch);
+        }
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        Buffer<uint8_t> buf;
+        if constexpr (State::kNullable) {
+            auto* nullable = as_nullable(dst);
+            auto* bitmaps = static_cast<BinaryColumn*>(nullable->data_column().get());
+            auto& nulls = nullable->null_column_data();
+            bool has_null = false;
+            for (size_t i = 0; i < num_states; ++i) {
+                const auto& s = state_of<State>(states[i], offset);
+                append_bitmap(s.bitmap, &buf, bitmaps);
+                nulls.push_back(!s.has_value);
+                has_null |= !s.has_value;
+            }
+            nullable->set_has_null(has_null);
+        } else {
+            auto* bitmaps = static_cast<BinaryColumn*>(dst);
+            for (size_t i = 0; i < num_states; ++i) {
+                append_bitmap(state_of<State>(states[i], offset).bitmap, &buf, bitmaps);
+            }
+        }
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        serialize_to_column(states, num_states, offset, dst);
+    }
+
+private:
+    const AggFunctionType _type;
+};
+
+// The bitmap of the values of an integer argument of type LT.
+template <LogicalType LT>
+class BitmapAggFunction final : public BitmapFunction<BitmapUnionState> {
+public:
+    BitmapAggFunction() : BitmapFunction<BitmapUnionState>(AggFunctionType::BITMAP_AGG) {}
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        const uint8_t* nulls;
+        const Column* data = unpack_nullable(arg, &nulls);
+        for (size_t i = 0; i < num_rows; ++i) {
+            RunTimeCppType<LT> value = value_at<LT>(data, i);
+            if ((nulls == nullptr || !nulls[i]) && value >= 0) {
+                state_of<BitmapUnionState>(states[i], offset).bitmap.add(static_cast<uint64_t>(value), pool);
+            }
+        }
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* nulls;
+        const Column* data = unpack_nullable(arg, &nulls);
+        auto* bitmaps = static_cast<BinaryColumn*>(dst);
+        MemPool scratch;
+        Buffer<uint8_t> buf;
+        for (size_t i = 0; i < num_rows; ++i) {
+            RoaringBitmap bitmap;
+            RunTimeCppType<LT> value = value_at<LT>(data, i);
+            if ((nulls == nullptr || !nulls[i]) && value >= 0) {
+                bitmap.add(static_cast<uint64_t>(value), &scratch);
+            }
+            append_bitmap(bitmap, &buf, bitmaps);
+            recycle(&scratch);
+        }
+    }
+};
+
+// The union, or intersection, of BITMAP values: rows are merged as
+// intermediate values are.
+template <typename State>
+class BitmapOfBitmapsFunction : public BitmapFunction<State> {
+public:
+    using BitmapFunction<State>::BitmapFunction;
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        this->merge_batch(arg, num_rows, offset, states, pool);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* arg_nulls;
+        const auto* bitmaps = static_cast<const BinaryColumn*>(unpack_nullable(arg, &arg_nulls));
+        auto* nullable = State::kNullable ? as_nullable(dst) : nullptr;
+        auto* out = static_cast<BinaryColumn*>(State::kNullable ? nullable->data_column().get() : dst);
+        Buffer<uint8_t> empty;
+        RoaringBitmap().serialize(&empty);
+        for (size_t i = 0; i < num_rows; ++i) {
+            bool is_null = arg_nulls != nullptr && arg_nulls[i];
+            if (!is_null) {
+                out->append(bitmaps->get_slice(i));
+            } else if (State::kNullable) {
+                out->append(Slice());
+            } else {
+                out->append(Slice(empty.data(), empty.size()));
+            }
+        }
+        if (State::kNullable) {
+            auto& nulls = nullable->null_column_data();
+            if (arg_nulls != nullptr) {
+                nulls.append(arg_nulls, num_rows);
+                nullable->set_has_null(true);
+            } else {
+                nulls.resize(nulls.size() + num_rows, 0);
+            }
+        }
+    }
+};
+
+// The number of values in the union of BITMAP values.
+class BitmapUnionCountFunction final : public BitmapOfBitmapsFunction<BitmapUnionState> {
+public:
+    BitmapUnionCountFunction() : BitmapOfBitmapsFunction<BitmapUnionState>(AggFunctionType::BITMAP_UNION_COUNT) {}
+
+    LogicalType result_type() const override { return TYPE_BIGINT; }
+    bool is_result_nullable() const override { return false; }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        for (size_t i = 0; i < num_states; ++i) {
+            data.push_back(static_cast<int64_t>(state_of<BitmapUnionState>(states[i], offset).bitmap.cardinality()));
+        }
+    }
+};
+
+StatusOr<const AggregateFunction*> get_bitmap_aggregate_function(AggFunctionType type, LogicalType arg_type,
+                                                                 bool is_merge) {
+    bool of_integers = type == AggFunctionType::BITMAP_AGG && !is_merge;
+    if (of_integers ? !is_integer_type(arg_type) : arg_type != TYPE_BITMAP) {
+        return unsupported(type, arg_type, is_merge);
+    }
+    switch (type) {
+    case AggFunctionType::BITMAP_AGG:
+        // Merging does not depend on the argument type.
+        return type_dispatch_all(is_merge ? TYPE_BIGINT : arg_type, [](auto lt) -> const AggregateFunction* {
+            constexpr LogicalType LT = decltype(lt)::value;
+            if constexpr (!is_integer_type(LT)) {
+                return nullptr;
+            } else {
+                static const BitmapAggFunction<LT> function;
+                return &function;
+            }
+        });
+    case AggFunctionType::BITMAP_UNION: {
+        static const BitmapOfBitmapsFunction<BitmapUnionState> function(type);
+        return &function;
+    }
+    case AggFunctionType::BITMAP_INTERSECT: {
+        static const BitmapOfBitmapsFunction<BitmapIntersectState> function(type);
+        return &function;
+    }
+    case AggFunctionType::BITMAP_UNION_COUNT: {
+        static const BitmapUnionCountFunction function;
+        return &function;
+    }
+    default:
+        return unsupported(type, arg_type, is_merge);
+    }
+}
+
+} // namespace starrocks
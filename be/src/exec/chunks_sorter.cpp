@@ -0,0 +1,191 @@
+#include "exec/chunks_sorter.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "exec/sort_context.h"
+
+namespace starrocks {
+
+namespace {
+
+// Rows |order| of |chunk| as chunks of at most |chunk_size| rows.
+std::vector<ChunkPtr> gather_rows(const Chunk& chunk, const Buffer<uint32_t>& order, size_t chunk_size) {
+    std::vector<ChunkPtr> chunks;
+    for (size_t from = 0; from < order.size(); from += chunk_size) {
+        auto size = static_cast<uint32_t>(std::min(chunk_size, order.size() - from));
+        ChunkPtr gathered = chunk.clone_empty(size);
+        gathered->append_selective(chunk, order.data(), static_cast<uint32_t>(from), size);
+        chunks.push_back(std::move(gathered));
+    }
+    return chunks;
+}
+
+// The first 8 bytes of a key as a big-endian integer, zero-padded.
+uint64_t key_prefix(const uint8_t* key, uint32_t size) {
+    uint64_t prefix = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | (i < size ? key[i] : 0);
+    }
+    return prefix;
+}
+
+} // namespace
+
+Status ChunksSorterFullSort::append(RuntimeState* state, const ChunkPtr& chunk) {
+    if (chunk->is_empty()) {
+        return Status::OK();
+    }
+    if (_buffer == nullptr) {
+        _buffer = chunk->clone_empty(chunk->num_rows());
+    }
+    _buffer->append(*chunk);
+    // Spill while sorting still fits, not once it no longer does.
+    bool spill = state->query_ctx()->should_spill(_sort_memory_estimate());
+    if (spill || static_cast<int64_t>(_buffer->memory_usage()) >= config::sort_max_buffered_bytes) {
+        return _sort_buffer(state, spill);
+    }
+    return Status::OK();
+}
+
+Status ChunksSorterFullSort::done(RuntimeState* state) {
+    if (_buffer == nullptr) {
+        return Status::OK();
+    }
+    return _sort_buffer(state, state->query_ctx()->should_spill(_sort_memory_estimate()));
+}
+
+int64_t ChunksSorterFullSort::_sort_memory_estimate() const {
+    // The sorted copy of the rows, their keys and the permutation.
+    size_t key_bytes = _ctx->param().sort_descs.size() * (1 + sizeof(int64_t)) + sizeof(uint32_t);
+    return static_cast<int64_t>(_buffer->memory_usage() + _buffer->num_rows() * (key_bytes + 2 * sizeof(int64_t)));
+}
+
+Status ChunksSorterFullSort::_sort_buffer(RuntimeState* state, bool spill) {
+    if (_buffer == nullptr || _buffer->is_empty()) {
+        return Status::OK();
+    }
+    size_t num_rows = _buffer->num_rows();
+    _ctx->encoder().encode(*_buffer, &_keys);
+    struct Item {
+        uint64_t prefix;
+        uint32_t row;
+    };
+    std::vector<Item> items(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        items[i] = {key_prefix(_keys.data(i), _keys.size(i)), static_cast<uint32_t>(i)};
+    }
+    std::sort(items.begin(), items.end(), [this](const Item& a, const Item& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        return compare_sort_keys(_keys.data(a.row), _keys.size(a.row), _keys.data(b.row), _keys.size(b.row)) < 0;
+    });
+
+    int64_t max_rows = _ctx->max_run_rows();
+    size_t num_kept = max_rows < 0 ? num_rows : std::min(num_rows, static_cast<size_t>(max_rows));
+    Buffer<uint32_t> order;
+    order.resize_uninitialized(num_kept);
+    for (size_t i = 0; i < num_kept; ++i) {
+        order[i] = items[i].row;
+    }
+    std::vector<ChunkPtr> chunks = gather_rows(*_buffer, order, state->chunk_size());
+    _buffer.reset();
+    _keys = SortKeys();
+    return _ctx->add_run(state, std::move(chunks), spill);
+}
+
+bool ChunksSorterTopN::_less(const HeapEntry& a, const HeapEntry& b) const {
+    return compare_sort_keys(_key_bytes.data() + a.key_offset, a.key_size, _key_bytes.data() + b.key_offset,
+                             b.key_size) < 0;
+}
+
+Status ChunksSorterTopN::append(RuntimeState* state, const ChunkPtr& chunk) {
+    if (chunk->is_empty() || _limit == 0) {
+        return Status::OK();
+    }
+    if (_buffer == nullptr) {
+        _buffer = chunk->clone_empty();
+    }
+    _ctx->encoder().encode(*chunk, &_keys);
+    auto less = [this](const HeapEntry& a, const HeapEntry& b) { return _less(a, b); };
+    auto base = static_cast<uint32_t>(_buffer->num_rows());
+    bool top_changed = false;
+    _selected.clear();
+    for (size_t i = 0; i < chunk->num_rows(); ++i) {
+        const uint8_t* key = _keys.data(i);
+        uint32_t key_size = _keys.size(i);
+        if (_heap.size() == _limit) {
+            const HeapEntry& top = _heap.front();
+            if (compare_sort_keys(key, key_size, _key_bytes.data() + top.key_offset, top.key_size) >= 0) {
+                continue;
+            }
+        }
+        HeapEntry entry{static_cast<uint32_t>(_key_bytes.size()), key_size,
+                        base + static_cast<uint32_t>(_selected.size())};
+        _key_bytes.append(key, key_size);
+        _selected.push_back(static_cast<uint32_t>(i));
+        _heap.push_back(entry);
+        std::push_heap(_heap.begin(), _heap.end(), less);
+        if (_heap.size() > _limit) {
+            std::pop_heap(_heap.begin(), _heap.end(), less);
+            _heap.pop_back();
+        }
+        top_changed = true;
+    }
+    if (_selected.empty()) {
+        return Status::OK();
+    }
+    _buffer->append_selective(*chunk, _selected.data(), 0, static_cast<uint32_t>(_selected.size()));
+    if (_buffer->num_rows() > std::max(2 * _limit, static_cast<size_t>(state->chunk_size()))) {
+        _compact();
+    }
+    if (top_changed && _heap.size() == _limit) {
+        _publish_cut_off();
+    }
+    return Status::OK();
+}
+
+void ChunksSorterTopN::_compact() {
+    Buffer<uint32_t> rows;
+    rows.resize_uninitialized(_heap.size());
+    Buffer<uint8_t> key_bytes;
+    for (size_t i = 0; i < _heap.size(); ++i) {
+        HeapEntry& entry = _heap[i];
+        rows[i] = entry.row;
+        auto key_offset = static_cast<uint32_t>(key_bytes.size());
+        key_bytes.append(_key_bytes.data() + entry.key_offset, entry.key_size);
+        entry = {key_offset, entry.key_size, static_cast<uint32_t>(i)};
+    }
+    ChunkPtr buffer = _buffer->clone_empty(rows.size());
+    buffer->append_selective(*_buffer, rows.data(), 0, static_cast<uint32_t>(rows.size()));
+    _buffer = std::move(buffer);
+    _key_bytes.swap(key_bytes);
+}
+
+void ChunksSorterTopN::_publish_cut_off() {
+    TopNRuntimeFilter* filter = _ctx->topn_filter();
+    if (filter != nullptr) {
+        SlotId slot = _ctx->param().sort_descs[0].slot_id;
+        filter->update(*_buffer->get_column_by_slot_id(slot), _heap.front().row);
+    }
+}
+
+Status ChunksSorterTopN::done(RuntimeState* state) {
+    if (_heap.empty()) {
+        return Status::OK();
+    }
+    std::sort_heap(_heap.begin(), _heap.end(), [this](const HeapEntry& a, const HeapEntry& b) { return _less(a, b); });
+    Buffer<uint32_t> order;
+    order.resize_uninitialized(_heap.size());
+    for (size_t i = 0; i < _heap.size(); ++i) {
+        order[i] = _heap[i].row;
+    }
+    std::vector<ChunkPtr> chunks = gather_rows(*_buffer, order, state->chunk_size());
+    _buffer.reset();
+    _heap.clear();
+    _key_bytes = Buffer<uint8_t>();
+    return _ctx->add_run(state, std::move(chunks), false);
+}
+
+} // namespace starrocks
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/status.h"
+#include "exec/sort_key.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+class SortContext;
+
+// Sorts the input of one sink driver of an ORDER BY into sorted runs, which
+// it hands to the SortContext for the source to merge. Not thread-safe: every
+// driver has its own, so drivers sort in parallel.
+class ChunksSorter {
+public:
+    explicit ChunksSorter(SortContext* ctx) : _ctx(ctx) {}
+    virtual ~ChunksSorter() = default;
+
+    virtual Status append(RuntimeState* state, const ChunkPtr& chunk) = 0;
+    // The input is exhausted; hands over what is left.
+    virtual Status done(RuntimeState* state) = 0;
+
+protected:
+    SortContext* _ctx;
+};
+
+// Sorts everything. Input is buffered until config::sort_max_buffered_bytes
+// or until the query has to spill, then sorted into a run: the rows' keys are
+// normalized (see SortKeyEncoder) and a permutation of the rows sorted by
+// them, comparing an 8-byte prefix of the keys as an integer first, is
+// gathered into chunks. Runs made under memory pressure go to disk, along
+// with those kept in memory so far (see SortContext::add_run()).
+class ChunksSorterFullSort final : public ChunksSorter {
+public:
+    using ChunksSorter::ChunksSorter;
+
+    Status append(RuntimeState* state, const ChunkPtr& chunk) override;
+    Status done(RuntimeState* state) override;
+
+private:
+    // Bytes sorting the buffer allocates.
+    int64_t _sort_memory_estimate() const;
+    Status _sort_buffer(RuntimeState* state, bool spill);
+
+    ChunkPtr _buffer;
+    SortKeys _keys;
+};
+
+// ORDER BY ... LIMIT n, for small n: keeps the first n rows seen so far in a
+// max-heap of their normalized keys, so that a row is one comparison with the
+// top of the heap unless it sorts before it. Kept rows live in a buffer chunk,
+// compacted down to the heap's rows when it holds twice as many.
+//
+// Every time the top of a full heap changes, its first key is offered to the
+// context's TopNRuntimeFilter, if any, so that the scan stops producing rows
+// the heap would reject anyway.
+class ChunksSorterTopN final : public ChunksSorter {
+public:
+    ChunksSorterTopN(SortContext* ctx, size_t limit) : ChunksSorter(ctx), _limit(limit) {}
+
+    Status append(RuntimeState* state, const ChunkPtr& chunk) override;
+    Status done(RuntimeState* state) override;
+
+private:
+    struct HeapEntry {
+        // Key of the row in _key_bytes.
+        uint32_t key_offset;
+        uint32_t key_size;
+        // Row in _buffer.
+        uint32_t row;
+    };
+
+    bool _less(const HeapEntry& a, const HeapEntry& b) const;
+    void _compact();
+    void _publish_cut_off();
+
+    const size_t _limit;
+    ChunkPtr _buffer;
+    Buffer<uint8_t> _key_bytes;
+    std::vector<HeapEntry> _heap;
+    SortKeys _keys;
+    Buffer<uint32_t> _selected;
+};
+
+} // namespace starrocks
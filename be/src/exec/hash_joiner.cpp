@@ -0,0 +1,238 @@
+#include "exec/hash_joiner.h"
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "exec/runtime_filter_worker.h"
+#include "runtime/exec_env.h"
+#include "util/hash_util.h"
+#include "util/stopwatch.h"
+
+namespace starrocks {
+
+HashJoiner::HashJoiner(JoinHashTable::Param param)
+        : _join_type(param.join_type), _table(std::make_unique<JoinHashTable>(std::move(param))) {}
+
+HashJoiner::~HashJoiner() = default;
+
+Status HashJoiner::prepare() {
+    if (_prepared) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_table->prepare());
+    const auto& param = _table->param();
+    for (const auto& rf : _runtime_filters) {
+        if (rf.build_key_idx >= param.build_key_slots.size()) {
+            return Status::InvalidArgument("runtime filter " + std::to_string(rf.filter_id) + " on build key " +
+                                           std::to_string(rf.build_key_idx) + " of " +
+                                           std::to_string(param.build_key_slots.size()));
+        }
+        SlotId slot = param.build_key_slots[rf.build_key_idx];
+        LogicalType type = TYPE_UNKNOWN;
+        uint64_t dict_id = 0;
+        for (const auto& desc : param.build_row_desc) {
+            if (desc.id == slot) {
+                type = desc.type;
+                dict_id = desc.dict_id;
+            }
+        }
+        _runtime_filter_types.push_back(type);
+        _runtime_filter_dict_ids.push_back(dict_id);
+    }
+    _prepared = true;
+    return Status::OK();
+}
+
+Status HashJoiner::append_build_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    std::lock_guard<std::mutex> l(_build_lock);
+    _query_ctx = state->query_ctx();
+    // Spill before a table growth would cross the threshold, not after: the
+    // query is over its limit for as long as both copies are alive.
+    if (!is_spilled() && _query_ctx->should_spill(_table->append_memory_estimate(*chunk))) {
+        RETURN_IF_ERROR(_start_spill(state));
+    }
+    if (is_spilled()) {
+        return _spill_rows(*chunk, true, 0, _build_writer.get());
+    }
+    RETURN_IF_ERROR(_table->append_build_chunk(chunk));
+    return _update_mem_usage();
+}
+
+Status HashJoiner::finish_build(RuntimeState* state) {
+    {
+        std::lock_guard<std::mutex> l(_build_lock);
+        if (--_num_running_builders > 0) {
+            return Status::OK();
+        }
+        ScopedTimer timer(&_build_time_ns);
+        _query_ctx = state->query_ctx();
+        // The slot array may be what tips the query over; spill before
+        // allocating it rather than after.
+        if (!is_spilled() && _query_ctx->should_spill(_table->build_memory_estimate())) {
+            RETURN_IF_ERROR(_start_spill(state));
+        }
+        if (!is_spilled()) {
+            RETURN_IF_ERROR(_table->build());
+            RETURN_IF_ERROR(_update_mem_usage());
+        }
+        if (is_spilled()) {
+            RETURN_IF_ERROR(_build_writer->flush());
+            RETURN_IF_ERROR(_table->build());
+        }
+    }
+    RETURN_IF_ERROR(_publish_runtime_filters(state));
+    _build_done.store(true, std::memory_order_release);
+    state->fragment_ctx()->notify_event();
+    return Status::OK();
+}
+
+Status HashJoiner::_update_mem_usage() {
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->set(_table->memory_usage());
+    }
+    if (_query_ctx->exceeds_mem_limit() && !config::enable_spill) {
+        MemTracker* query_tracker = _query_ctx->mem_tracker();
+        return query_tracker->limit_exceeded_status(query_tracker);
+    }
+    return Status::OK();
+}
+
+Status HashJoiner::_publish_runtime_filters(RuntimeState* state) {
+    bool can_filter = !is_spilled() && (_join_type == JoinType::INNER_JOIN || _join_type == JoinType::LEFT_SEMI_JOIN);
+    const auto& param = _table->param();
+    for (size_t i = 0; i < _runtime_filters.size(); ++i) {
+        const auto& rf = _runtime_filters[i];
+        RuntimeFilterPtr filter;
+        if (can_filter && RuntimeFilter::is_supported_type(_runtime_filter_types[i])) {
+            const Chunk& build_chunk = _table->build_chunk();
+            const ColumnPtr& keys = build_chunk.get_column_by_slot_id(param.build_key_slots[rf.build_key_idx]);
+            // Skips the NULL row 0.
+            filter = RuntimeFilter::create(_runtime_filter_types[i], *keys, 1, _runtime_filter_dict_ids[i]);
+        }
+        if (rf.has_local_target) {
+            state->fragment_ctx()->runtime_filter_hub()->receive(rf.filter_id, rf.num_producers, filter);
+        }
+        RuntimeFilterWorker* worker = ExecEnv::GetInstance()->runtime_filter_worker();
+        if (!rf.remote_targets.empty() && worker != nullptr) {
+            RETURN_IF_ERROR(worker->send(rf.remote_targets, rf.filter_id, rf.num_producers, filter.get()));
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoiner::_start_spill(RuntimeState* state) {
+    ASSIGN_OR_RETURN(std::string dir, _query_ctx->spill_dir());
+    pipeline::PipelineDriverExecutor* executor = state->fragment_ctx()->executor();
+    // Drivers parked on a spill backlog or on the last writes re-check once
+    // the queue drains.
+    _spiller = std::make_shared<spill::Spiller>(std::move(dir), "hash_join", ExecEnv::GetInstance()->spill_io_thread_pool(),
+                                                state->instance_mem_tracker(), [executor] {
+                                                    if (executor != nullptr) {
+                                                        executor->wake_poller();
+                                                    }
+                                                });
+    const auto& param = _table->param();
+    size_t num_partitions = std::max(config::spill_hash_join_partitions, 1);
+    _build_writer = std::make_unique<spill::PartitionedSpillWriter>(_spiller, param.build_row_desc, num_partitions,
+                                                                    state->chunk_size());
+    _probe_writer = std::make_unique<spill::PartitionedSpillWriter>(_spiller, param.probe_row_desc, num_partitions,
+                                                                    state->chunk_size());
+
+    // Move what is already in the table to disk, skipping its NULL row 0.
+    const Chunk& build_chunk = _table->build_chunk();
+    if (build_chunk.num_rows() > 1) {
+        RETURN_IF_ERROR(_spill_rows(build_chunk, true, 1, _build_writer.get()));
+    }
+    auto table = std::make_unique<JoinHashTable>(param);
+    RETURN_IF_ERROR(table->prepare());
+    _table = std::move(table);
+    return _update_mem_usage();
+}
+
+Status HashJoiner::_spill_rows(const Chunk& chunk, bool build_side, uint32_t from,
+                               spill::PartitionedSpillWriter* writer) {
+    size_t num_rows = chunk.num_rows();
+    if (num_rows <= from) {
+        return Status::OK();
+    }
+    if (build_side) {
+        _table->prepare_build_keys(chunk, &_spill_keys);
+    } else {
+        _table->prepare_probe_keys(chunk, &_spill_keys);
+    }
+    // Re-mix the hash: hash tables of the partitions index slots by its bits.
+    _spill_partitions.resize_uninitialized(num_rows);
+    uint32_t num_partitions = writer->num_partitions();
+    for (size_t i = 0; i < num_rows; ++i) {
+        _spill_partitions[i] = HashUtil::fmix64(_spill_keys.hashes[i]) % num_partitions;
+    }
+    return writer->append(chunk, _spill_partitions.data(), from, num_rows - from);
+}
+
+bool HashJoiner::is_probe_short_circuited() const {
+    JoinType type = _join_type;
+    return is_build_done() && !is_spilled() && _table->num_build_rows() == 0 &&
+           (type == JoinType::INNER_JOIN || type == JoinType::LEFT_SEMI_JOIN);
+}
+
+bool HashJoiner::finish_probe(const Filter& matched) {
+    std::lock_guard<std::mutex> l(_probe_lock);
+    if (_build_matched.empty()) {
+        _build_matched.assign(_table->num_build_rows() + 1, 0);
+    }
+    if (!matched.empty()) {
+        uint8_t* dst = _build_matched.data();
+        const uint8_t* src = matched.data();
+        for (size_t i = 0; i < _build_matched.size(); ++i) {
+            dst[i] |= src[i];
+        }
+    }
+    return --_num_running_probers == 0;
+}
+
+Status HashJoiner::spill_probe_chunk(const ChunkPtr& chunk) {
+    std::lock_guard<std::mutex> l(_probe_lock);
+    return _spill_rows(*chunk, false, 0, _probe_writer.get());
+}
+
+Status HashJoiner::finish_probe_spill(RuntimeState* state) {
+    {
+        std::lock_guard<std::mutex> l(_probe_lock);
+        if (--_num_running_probers > 0) {
+            return Status::OK();
+        }
+        RETURN_IF_ERROR(_probe_writer->flush());
+    }
+    _probe_spill_done.store(true, std::memory_order_release);
+    state->fragment_ctx()->notify_event();
+    return Status::OK();
+}
+
+bool HashJoiner::is_probe_spill_done() const {
+    return _probe_spill_done.load(std::memory_order_acquire) && !_spiller->has_pending_writes();
+}
+
+bool HashJoiner::is_spill_backlogged() const {
+    std::lock_guard<std::mutex> l(_build_lock);
+    return _spiller != nullptr && _spiller->is_backlogged();
+}
+
+bool HashJoiner::has_pending_spill_writes() const {
+    std::lock_guard<std::mutex> l(_build_lock);
+    return _spiller != nullptr && _spiller->has_pending_writes();
+}
+
+int32_t HashJoiner::claim_spilled_partition() {
+    int32_t partition = _next_partition.fetch_add(1);
+    return partition < static_cast<int32_t>(_build_writer->num_partitions()) ? partition : -1;
+}
+
+StatusOr<spill::SpillStreamReaderPtr> HashJoiner::open_spilled_build(int32_t partition) {
+    return _spiller->open_reader(_build_writer->stream(partition));
+}
+
+StatusOr<spill::SpillStreamReaderPtr> HashJoiner::open_spilled_probe(int32_t partition) {
+    return _spiller->open_reader(_probe_writer->stream(partition));
+}
+
+} // namespace starrocks
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "exec/join_hash_map.h"
+#include "exec/runtime_filter.h"
+#include "exec/spill/spiller.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+// State of one hash join shared by its build and probe drivers.
+//
+// Build drivers append chunks concurrently; the last one to finish builds the
+// hash table, after which probe drivers, which are blocked until then, probe
+// it in parallel. For FULL OUTER JOIN each probe driver records the build rows
+// it matched, and the last probe driver to finish merges those and emits the
+// build rows nobody matched.
+//
+// The build side is charged to the query's memory budget. When the query
+// crosses its spill threshold the join turns into a grace hash join: build
+// rows, those already in the table and every later one, are split by key hash
+// into config::spill_hash_join_partitions partitions and spilled, the probe
+// drivers spill their input the same way, and once all of it is on disk the
+// probe drivers take partitions one at a time and join each with a hash table
+// of just that partition's build rows.
+//
+// Once the build is done, the join publishes its runtime filters: a summary
+// of a build key's values (see RuntimeFilter) which the scans of the probe
+// side, in this fragment instance or others, use to skip rows that cannot
+// match. Only inner and semi joins drop unmatched probe rows, so only they
+// build filters; others, and a join that spilled, publish that there is no
+// filter, so the scans do not wait for one. A filter on a key of global
+// dictionary codes carries the dictionary's id, and scans reading other codes
+// ignore it.
+class HashJoiner {
+public:
+    explicit HashJoiner(JoinHashTable::Param param);
+    ~HashJoiner();
+
+    DISALLOW_COPY_AND_MOVE(HashJoiner);
+
+    // Set before prepare().
+    void set_runtime_filters(std::vector<RuntimeFilterBuildDescriptor> descriptors) {
+        _runtime_filters = std::move(descriptors);
+    }
+
+    // Idempotent: both the build and the probe factory call it.
+    Status prepare();
+    // The build operator's tracker, which the hash table's size is reported to.
+    void set_mem_tracker(MemTracker* mem_tracker) { _mem_tracker = mem_tracker; }
+
+    // Both are called once per driver while drivers are created.
+    void set_num_builders(int32_t num_builders) { _num_running_builders = num_builders; }
+    void set_num_probers(int32_t num_probers) { _num_running_probers = num_probers; }
+
+    Status append_build_chunk(RuntimeState* state, const ChunkPtr& chunk);
+    // Builds the table when the last builder finishes and wakes the probers.
+    Status finish_build(RuntimeState* state);
+
+    bool is_build_done() const { return _build_done.load(std::memory_order_acquire); }
+    JoinType join_type() const { return _join_type; }
+    // Replaced when the join starts spilling; stable once the build is done.
+    const JoinHashTable& table() const { return *_table; }
+
+    // Probe side can be skipped entirely: inner and semi joins against an
+    // empty build side produce nothing.
+    bool is_probe_short_circuited() const;
+
+    // Merges |matched| from a finished probe driver. Returns true for the last
+    // one, which then owns emitting the unmatched build rows.
+    bool finish_probe(const Filter& matched);
+    const Filter& build_matched() const { return _build_matched; }
+
+    int64_t build_time_ns() const { return _build_time_ns; }
+
+    // Grace hash join. Only meaningful once the build is done; the table is
+    // then empty and probe drivers go through the calls below instead.
+    bool is_spilled() const { return _spiller != nullptr; }
+    Status spill_probe_chunk(const ChunkPtr& chunk);
+    // Build and probe drivers hold back input while spill writes queue up;
+    // the queued chunks count against the query's memory.
+    bool is_spill_backlogged() const;
+    // One probe driver has spilled all its input; the last one wakes the
+    // others.
+    Status finish_probe_spill(RuntimeState* state);
+    // All probe input is on disk; partitions can be joined.
+    bool is_probe_spill_done() const;
+    // Spill writes are still queued or running. Join operators do not finish
+    // before they drain: the writes account to the fragment's MemTracker.
+    bool has_pending_spill_writes() const;
+    // Hands out each partition once; returns -1 when none are left.
+    int32_t claim_spilled_partition();
+    StatusOr<spill::SpillStreamReaderPtr> open_spilled_build(int32_t partition);
+    StatusOr<spill::SpillStreamReaderPtr> open_spilled_probe(int32_t partition);
+    const spill::Spiller* spiller() const { return _spiller.get(); }
+
+private:
+    Status _update_mem_usage();
+    Status _publish_runtime_filters(RuntimeState* state);
+    Status _start_spill(RuntimeState* state);
+    Status _spill_rows(const Chunk& chunk, bool build_side, uint32_t from, spill::PartitionedSpillWriter* writer);
+
+    const JoinType _join_type;
+    std::unique_ptr<JoinHashTable> _table;
+    bool _prepared = false;
+    QueryContext* _query_ctx = nullptr;
+    MemTracker* _mem_tracker = nullptr;
+
+    mutable std::mutex _build_lock;
+    int32_t _num_running_builders = 0;
+    std::atomic<bool> _build_done{false};
+    int64_t _build_time_ns = 0;
+
+    std::mutex _probe_lock;
+    int32_t _num_running_probers = 0;
+    Filter _build_matched;
+
+    spill::SpillerPtr _spiller;
+    std::unique_ptr<spill::PartitionedSpillWriter> _build_writer;
+    std::unique_ptr<spill::PartitionedSpillWriter> _probe_writer;
+    JoinKeyBatch _spill_keys;
+    Buffer<uint32_t> _spill_partitions;
+    std::atomic<bool> _probe_spill_done{false};
+    std::atomic<int32_t> _next_partition{0};
+
+    std::vector<RuntimeFilterBuildDescriptor> _runtime_filters;
+    std::vector<LogicalType> _runtime_filter_types;
+    std::vector<uint64_t> _runtime_filter_dict_ids;
+};
+
+using HashJoinerPtr = std::shared_ptr<HashJoiner>;
+
+} // namespace starrocks
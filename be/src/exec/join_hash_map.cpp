@@ -0,0 +1,670 @@
+#include "exec/join_hash_map.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "column/column_helper.h"
+#include "common/config.h"
+#include "util/cpu_info.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+// Lookups issue a prefetch for the slot of the row this far ahead.
+static constexpr size_t kPrefetchDistance = 16;
+
+const char* join_type_name(JoinType type) {
+    switch (type) {
+    case JoinType::INNER_JOIN:
+        return "INNER JOIN";
+    case JoinType::LEFT_OUTER_JOIN:
+        return "LEFT OUTER JOIN";
+    case JoinType::LEFT_SEMI_JOIN:
+        return "LEFT SEMI JOIN";
+    case JoinType::LEFT_ANTI_JOIN:
+        return "LEFT ANTI JOIN";
+    case JoinType::FULL_OUTER_JOIN:
+        return "FULL OUTER JOIN";
+    }
+    return "UNKNOWN JOIN";
+}
+
+static size_t next_power_of_two(size_t n) {
+    size_t res = 1;
+    while (res < n) {
+        res <<= 1;
+    }
+    return res;
+}
+
+// The bits of a float key with -0.0 turned into 0.0, so the two compare equal.
+template <typename U>
+static ALWAYS_INLINE U key_bits(U bits, bool is_float) {
+    return is_float && static_cast<U>(bits << 1) == 0 ? 0 : bits;
+}
+
+template <typename U>
+static void pack_fixed_key(const Column* data, size_t num_rows, int shift, bool is_float, uint64_t* out) {
+    const U* values = reinterpret_cast<const U*>(data->raw_data());
+    for (size_t i = 0; i < num_rows; ++i) {
+        out[i] |= static_cast<uint64_t>(key_bits(values[i], is_float)) << shift;
+    }
+}
+
+template <typename U>
+static void write_float_key(const Column* data, size_t num_rows, uint8_t* bytes, uint32_t* cursor) {
+    const U* values = reinterpret_cast<const U*>(data->raw_data());
+    for (size_t i = 0; i < num_rows; ++i) {
+        U bits = key_bits(values[i], true);
+        memcpy(bytes + cursor[i], &bits, sizeof(U));
+        cursor[i] += sizeof(U);
+    }
+}
+
+JoinHashTable::JoinHashTable(Param param) : _param(std::move(param)) {}
+
+Status JoinHashTable::prepare() {
+    const auto& build_keys = _param.build_key_slots;
+    const auto& probe_keys = _param.probe_key_slots;
+    if (build_keys.empty() || build_keys.size() != probe_keys.size()) {
+        return Status::InvalidArgument("join needs the same non-zero number of build and probe keys");
+    }
+    auto find_slot = [](const RowDescriptor& desc, SlotId slot) -> StatusOr<const SlotDescriptor*> {
+        for (const auto& s : desc) {
+            if (s.id == slot) {
+                return &s;
+            }
+        }
+        return Status::NotFound("join key slot " + std::to_string(slot) + " not in row descriptor");
+    };
+
+    size_t fixed_bytes = 0;
+    bool all_fixed = true;
+    for (size_t i = 0; i < build_keys.size(); ++i) {
+        ASSIGN_OR_RETURN(const SlotDescriptor* build_slot, find_slot(_param.build_row_desc, build_keys[i]));
+        ASSIGN_OR_RETURN(const SlotDescriptor* probe_slot, find_slot(_param.probe_row_desc, probe_keys[i]));
+        LogicalType build_type = build_slot->type;
+        if (build_type != probe_slot->type) {
+            return Status::InvalidArgument(std::string("join key type mismatch: ") +
+                                           logical_type_to_string(build_type) + " vs " +
+                                           logical_type_to_string(probe_slot->type));
+        }
+        // Equal bitmaps need not serialize to equal bytes.
+        if (build_type == TYPE_BITMAP) {
+            return Status::InvalidArgument("join on the BITMAP keys " + std::to_string(build_keys[i]) + " and " +
+                                           std::to_string(probe_keys[i]));
+        }
+        // Codes of different global dictionaries stand for unrelated words.
+        if (build_slot->dict_id != probe_slot->dict_id) {
+            return Status::InvalidArgument("join keys " + std::to_string(build_keys[i]) + " and " +
+                                           std::to_string(probe_keys[i]) +
+                                           " are not codes of the same global dictionary");
+        }
+        _key_types.push_back(build_type);
+        if (is_binary_type(build_type)) {
+            all_fixed = false;
+        } else {
+            fixed_bytes += get_type_size(build_type);
+        }
+    }
+    _key_kind = all_fixed && fixed_bytes <= sizeof(uint64_t) ? JoinKeyKind::kFixed64 : JoinKeyKind::kSerialized;
+
+    bool nullable_build = _param.join_type == JoinType::LEFT_OUTER_JOIN || _param.join_type == JoinType::FULL_OUTER_JOIN;
+    _build_chunk = create_chunk_for_row_desc(_param.build_row_desc, nullable_build);
+    // Row 0: the NULL row outer joins extend unmatched probe rows with.
+    for (auto& column : _build_chunk->columns()) {
+        if (!column->append_nulls(1)) {
+            column->append_default(1);
+        }
+    }
+
+    _output_template = create_chunk_for_row_desc(_param.probe_row_desc,
+                                                 _param.join_type == JoinType::FULL_OUTER_JOIN);
+    if (output_build_columns()) {
+        for (size_t i = 0; i < _param.build_row_desc.size(); ++i) {
+            _output_template->append_column(_build_chunk->get_column_by_index(i)->clone_empty(),
+                                            _param.build_row_desc[i].id);
+        }
+    }
+
+    _build_keys.fixed_keys.push_back(0);
+    _build_keys.key_offsets.assign(2, 0);
+    _build_keys.nulls.push_back(1);
+    _build_keys.hashes.push_back(0);
+    return Status::OK();
+}
+
+bool JoinHashTable::output_build_columns() const {
+    return _param.join_type == JoinType::INNER_JOIN || _param.join_type == JoinType::LEFT_OUTER_JOIN ||
+           _param.join_type == JoinType::FULL_OUTER_JOIN;
+}
+
+ChunkPtr JoinHashTable::new_output_chunk(size_t reserve) const {
+    return _output_template->clone_empty(reserve);
+}
+
+Columns JoinHashTable::columns_by_desc(const Chunk& chunk, const RowDescriptor& desc) {
+    Columns columns;
+    columns.reserve(desc.size());
+    for (const auto& slot : desc) {
+        columns.emplace_back(
+                ColumnHelper::unfold_const_column(slot.type, chunk.num_rows(), chunk.get_column_by_slot_id(slot.id)));
+    }
+    return columns;
+}
+
+Columns JoinHashTable::_key_columns(const Chunk& chunk, const std::vector<SlotId>& key_slots) const {
+    Columns columns;
+    columns.reserve(key_slots.size());
+    for (size_t i = 0; i < key_slots.size(); ++i) {
+        columns.emplace_back(ColumnHelper::unfold_const_column(_key_types[i], chunk.num_rows(),
+                                                               chunk.get_column_by_slot_id(key_slots[i])));
+    }
+    return columns;
+}
+
+void JoinHashTable::prepare_keys(const Columns& key_columns, size_t num_rows, JoinKeyBatch* keys) const {
+    keys->nulls.assign(num_rows, 0);
+    keys->has_null = false;
+    for (const auto& column : key_columns) {
+        const NullData* nulls = ColumnHelper::get_null_data(column.get());
+        if (nulls == nullptr) {
+            continue;
+        }
+        keys->has_null = true;
+        uint8_t* dst = keys->nulls.data();
+        const uint8_t* src = nulls->data();
+        for (size_t i = 0; i < num_rows; ++i) {
+            dst[i] |= src[i];
+        }
+    }
+
+    keys->hashes.resize_uninitialized(num_rows);
+    uint64_t* hashes = keys->hashes.data();
+
+    if (_key_kind == JoinKeyKind::kFixed64) {
+        keys->fixed_keys.assign(num_rows, 0);
+        uint64_t* packed = keys->fixed_keys.data();
+        int shift = 0;
+        for (size_t k = 0; k < key_columns.size(); ++k) {
+            const Column* data = ColumnHelper::get_data_column(key_columns[k].get());
+            size_t width = get_type_size(_key_types[k]);
+            bool is_float = is_float_type(_key_types[k]);
+            switch (width) {
+            case 1:
+                pack_fixed_key<uint8_t>(data, num_rows, shift, false, packed);
+                break;
+            case 2:
+                pack_fixed_key<uint16_t>(data, num_rows, shift, false, packed);
+                break;
+            case 4:
+                pack_fixed_key<uint32_t>(data, num_rows, shift, is_float, packed);
+                break;
+            default:
+                pack_fixed_key<uint64_t>(data, num_rows, shift, is_float, packed);
+                break;
+            }
+            shift += static_cast<int>(width * 8);
+        }
+        for (size_t i = 0; i < num_rows; ++i) {
+            hashes[i] = HashUtil::hash64(packed[i]);
+        }
+        return;
+    }
+
+    // Serialized keys: size every row first, then write column by column so
+    // each pass streams through one column.
+    auto& offsets = keys->key_offsets;
+    offsets.resize_uninitialized(num_rows + 1);
+    offsets[0] = 0;
+    size_t fixed_width = 0;
+    for (size_t k = 0; k < key_columns.size(); ++k) {
+        if (!is_binary_type(_key_types[k])) {
+            fixed_width += get_type_size(_key_types[k]);
+        }
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        offsets[i + 1] = static_cast<uint32_t>(fixed_width);
+    }
+    for (size_t k = 0; k < key_columns.size(); ++k) {
+        if (is_binary_type(_key_types[k])) {
+            const auto* data = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(key_columns[k].get()));
+            const auto& src_offsets = data->get_offset();
+            for (size_t i = 0; i < num_rows; ++i) {
+                offsets[i + 1] += sizeof(uint32_t) + (src_offsets[i + 1] - src_offsets[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    keys->key_bytes.resize_uninitialized(offsets[num_rows]);
+
+    Buffer<uint32_t> cursor;
+    cursor.append(offsets.data(), num_rows);
+    uint8_t* bytes = keys->key_bytes.data();
+    for (size_t k = 0; k < key_columns.size(); ++k) {
+        const Column* data = ColumnHelper::get_data_column(key_columns[k].get());
+        if (is_binary_type(_key_types[k])) {
+            const auto* binary = static_cast<const BinaryColumn*>(data);
+            const uint8_t* src = binary->get_bytes().data();
+            const auto& src_offsets = binary->get_offset();
+            for (size_t i = 0; i < num_rows; ++i) {
+                uint32_t len = src_offsets[i + 1] - src_offsets[i];
+                memcpy(bytes + cursor[i], &len, sizeof(len));
+                memcpy(bytes + cursor[i] + sizeof(len), src + src_offsets[i], len);
+                cursor[i] += sizeof(len) + len;
+            }
+        } else if (_key_types[k] == TYPE_DOUBLE) {
+            write_float_key<uint64_t>(data, num_rows, bytes, cursor.data());
+        } else if (_key_types[k] == TYPE_FLOAT) {
+            write_float_key<uint32_t>(data, num_rows, bytes, cursor.data());
+        } else {
+            size_t width = get_type_size(_key_types[k]);
+            const uint8_t* src = data->raw_data();
+            for (size_t i = 0; i < num_rows; ++i) {
+                memcpy(bytes + cursor[i], src + i * width, width);
+                cursor[i] += width;
+            }
+        }
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        hashes[i] = HashUtil::hash_bytes(bytes + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+}
+
+void JoinHashTable::prepare_build_keys(const Chunk& chunk, JoinKeyBatch* keys) const {
+    prepare_keys(_key_columns(chunk, _param.build_key_slots), chunk.num_rows(), keys);
+}
+
+void JoinHashTable::prepare_probe_keys(const Chunk& chunk, JoinKeyBatch* keys) const {
+    // prepare() checked that probe keys have the build keys' types.
+    prepare_keys(_key_columns(chunk, _param.probe_key_slots), chunk.num_rows(), keys);
+}
+
+Status JoinHashTable::append_build_chunk(const ChunkPtr& chunk) {
+    size_t num_rows = chunk->num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    if (_num_build_rows + num_rows >= std::numeric_limits<uint32_t>::max()) {
+        return Status::NotSupported("join build side exceeds 4G rows");
+    }
+
+    JoinKeyBatch keys;
+    prepare_build_keys(*chunk, &keys);
+    if (_key_kind == JoinKeyKind::kFixed64) {
+        _build_keys.fixed_keys.append(keys.fixed_keys.data(), num_rows);
+    } else {
+        size_t base = _build_keys.key_bytes.size();
+        if (base + keys.key_bytes.size() >= std::numeric_limits<uint32_t>::max()) {
+            return Status::NotSupported("join build keys exceed 4GB");
+        }
+        _build_keys.key_bytes.append(keys.key_bytes.data(), keys.key_bytes.size());
+        for (size_t i = 1; i <= num_rows; ++i) {
+            _build_keys.key_offsets.push_back(static_cast<uint32_t>(base + keys.key_offsets[i]));
+        }
+    }
+    _build_keys.nulls.append(keys.nulls.data(), num_rows);
+    _build_keys.hashes.append(keys.hashes.data(), num_rows);
+
+    Columns columns = columns_by_desc(*chunk, _param.build_row_desc);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        _build_chunk->get_column_by_index(i)->append(*columns[i]);
+    }
+    _num_build_rows += num_rows;
+    return Status::OK();
+}
+
+void JoinHashTable::_init_partitions() {
+    size_t slot_size = _key_kind == JoinKeyKind::kFixed64 ? sizeof(FixedSlot) : sizeof(SerializedSlot);
+    size_t total_bytes = next_power_of_two(std::max<size_t>(_num_build_rows * 2, 16)) * slot_size;
+    int64_t partition_bytes = config::join_hash_table_partition_bytes > 0 ? config::join_hash_table_partition_bytes
+                                                                          : CpuInfo::l2_cache_size() / 2;
+    size_t num_partitions = 1;
+    while (num_partitions < static_cast<size_t>(config::join_hash_table_max_partitions) &&
+           total_bytes / num_partitions > static_cast<size_t>(partition_bytes)) {
+        num_partitions <<= 1;
+    }
+    _partition_bits = 0;
+    while ((size_t(1) << _partition_bits) < num_partitions) {
+        _partition_bits++;
+    }
+}
+
+template <JoinKeyKind KK>
+void JoinHashTable::_insert_rows(const uint32_t* rows, const uint64_t* hashes, const uint64_t* fixed_keys,
+                                 size_t num_rows) {
+    uint32_t* next = _next.data();
+    for (size_t k = 0; k < num_rows; ++k) {
+        if (k + kPrefetchDistance < num_rows) {
+            uint64_t ahead = hashes[k + kPrefetchDistance];
+            size_t p = _partition_of(ahead);
+            size_t pos = _partition_offsets[p] + (ahead & (_partition_offsets[p + 1] - _partition_offsets[p] - 1));
+            if constexpr (KK == JoinKeyKind::kFixed64) {
+                PREFETCH(_fixed_slots.data() + pos);
+            } else {
+                PREFETCH(_serialized_slots.data() + pos);
+            }
+        }
+        uint32_t row = rows[k];
+        uint64_t hash = hashes[k];
+        size_t p = _partition_of(hash);
+        size_t base = _partition_offsets[p];
+        size_t mask = _partition_offsets[p + 1] - base - 1;
+        size_t idx = hash & mask;
+        if constexpr (KK == JoinKeyKind::kFixed64) {
+            uint64_t key = fixed_keys[k];
+            FixedSlot* slots = _fixed_slots.data() + base;
+            while (slots[idx].head != 0 && slots[idx].key != key) {
+                idx = (idx + 1) & mask;
+            }
+            if (slots[idx].head == 0) {
+                slots[idx].key = key;
+                _num_distinct_keys++;
+            }
+            next[row] = slots[idx].head;
+            slots[idx].head = row;
+        } else {
+            uint32_t tag = static_cast<uint32_t>(hash >> 32);
+            Slice key = _build_keys.serialized_key(row);
+            SerializedSlot* slots = _serialized_slots.data() + base;
+            while (slots[idx].head != 0 &&
+                   (slots[idx].tag != tag || _build_keys.serialized_key(slots[idx].head) != key)) {
+                idx = (idx + 1) & mask;
+            }
+            if (slots[idx].head == 0) {
+                slots[idx].tag = tag;
+                _num_distinct_keys++;
+            }
+            next[row] = slots[idx].head;
+            slots[idx].head = row;
+        }
+    }
+}
+
+Status JoinHashTable::build() {
+    _init_partitions();
+    size_t num_partitions = size_t(1) << _partition_bits;
+    size_t num_rows = _num_build_rows + 1;
+    const uint64_t* hashes = _build_keys.hashes.data();
+    const uint8_t* nulls = _build_keys.nulls.data();
+
+    // Radix-scatter the non-NULL rows by partition, carrying hashes and fixed
+    // keys along so the inserts below stream through them sequentially.
+    std::vector<size_t> counts(num_partitions + 1, 0);
+    for (size_t row = 1; row < num_rows; ++row) {
+        counts[_partition_of(hashes[row]) + 1] += !nulls[row];
+    }
+    _partition_offsets.assign(num_partitions + 1, 0);
+    for (size_t p = 0; p < num_partitions; ++p) {
+        _partition_offsets[p + 1] = _partition_offsets[p] + next_power_of_two(std::max<size_t>(counts[p + 1] * 2, 8));
+        counts[p + 1] += counts[p];
+    }
+    const bool fixed = _key_kind == JoinKeyKind::kFixed64;
+    size_t num_keyed_rows = counts[num_partitions];
+    Buffer<uint32_t> rows(num_keyed_rows);
+    Buffer<uint64_t> row_hashes(num_keyed_rows);
+    Buffer<uint64_t> row_keys(fixed ? num_keyed_rows : 0);
+    for (size_t row = 1; row < num_rows; ++row) {
+        if (!nulls[row]) {
+            size_t pos = counts[_partition_of(hashes[row])]++;
+            rows[pos] = static_cast<uint32_t>(row);
+            row_hashes[pos] = hashes[row];
+            if (fixed) {
+                row_keys[pos] = _build_keys.fixed_keys[row];
+            }
+        }
+    }
+
+    _next.assign(num_rows, 0);
+    if (fixed) {
+        _fixed_slots.resize(_partition_offsets.back());
+        _insert_rows<JoinKeyKind::kFixed64>(rows.data(), row_hashes.data(), row_keys.data(), num_keyed_rows);
+        // The slots now own the keys.
+        _build_keys.fixed_keys.shrink_to_empty();
+    } else {
+        _serialized_slots.resize(_partition_offsets.back());
+        _insert_rows<JoinKeyKind::kSerialized>(rows.data(), row_hashes.data(), nullptr, num_keyed_rows);
+    }
+    _build_keys.hashes.shrink_to_empty();
+    return Status::OK();
+}
+
+template <JoinKeyKind KK>
+void JoinHashTable::_lookup(const JoinKeyBatch& keys, size_t num_rows, uint32_t* heads) const {
+    const uint64_t* hashes = keys.hashes.data();
+    const uint8_t* nulls = keys.nulls.data();
+    auto slot_index = [&](uint64_t hash, size_t* base, size_t* mask) {
+        size_t p = _partition_of(hash);
+        *base = _partition_offsets[p];
+        *mask = _partition_offsets[p + 1] - *base - 1;
+        return hash & *mask;
+    };
+
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i + kPrefetchDistance < num_rows) {
+            size_t base, mask;
+            size_t idx = slot_index(hashes[i + kPrefetchDistance], &base, &mask);
+            if constexpr (KK == JoinKeyKind::kFixed64) {
+                PREFETCH(_fixed_slots.data() + base + idx);
+            } else {
+                PREFETCH(_serialized_slots.data() + base + idx);
+            }
+        }
+        if (nulls[i]) {
+            heads[i] = 0;
+            continue;
+        }
+        uint64_t hash = hashes[i];
+        size_t base, mask;
+        size_t idx = slot_index(hash, &base, &mask);
+        if constexpr (KK == JoinKeyKind::kFixed64) {
+            uint64_t key = keys.fixed_keys[i];
+            const FixedSlot* slots = _fixed_slots.data() + base;
+            while (slots[idx].head != 0 && slots[idx].key != key) {
+                idx = (idx + 1) & mask;
+            }
+            heads[i] = slots[idx].head;
+        } else {
+            uint32_t tag = static_cast<uint32_t>(hash >> 32);
+            Slice key = keys.serialized_key(i);
+            const SerializedSlot* slots = _serialized_slots.data() + base;
+            while (slots[idx].head != 0 &&
+                   (slots[idx].tag != tag || _build_keys.serialized_key(slots[idx].head) != key)) {
+                idx = (idx + 1) & mask;
+            }
+            heads[i] = slots[idx].head;
+        }
+    }
+}
+
+void JoinHashTable::lookup(const JoinKeyBatch& keys, size_t num_rows, uint32_t* heads) const {
+    if (_key_kind == JoinKeyKind::kFixed64) {
+        _lookup<JoinKeyKind::kFixed64>(keys, num_rows, heads);
+    } else {
+        _lookup<JoinKeyKind::kSerialized>(keys, num_rows, heads);
+    }
+}
+
+ChunkPtr JoinHashTable::next_unmatched_build_chunk(const Filter& matched, uint32_t* cursor, size_t chunk_size) const {
+    size_t num_rows = _num_build_rows + 1;
+    uint32_t row = std::max<uint32_t>(*cursor, 1);
+    if (row >= num_rows) {
+        *cursor = row;
+        return nullptr;
+    }
+    Buffer<uint32_t> indexes;
+    indexes.reserve(chunk_size);
+    for (; row < num_rows && indexes.size() < chunk_size; ++row) {
+        if (matched.empty() || !matched[row]) {
+            indexes.push_back(row);
+        }
+    }
+    *cursor = row;
+
+    ChunkPtr output = new_output_chunk(indexes.size());
+    size_t num_probe_columns = _param.probe_row_desc.size();
+    for (size_t i = 0; i < num_probe_columns; ++i) {
+        (void)output->get_column_by_index(i)->append_nulls(indexes.size());
+    }
+    for (size_t i = 0; i < _build_chunk->num_columns(); ++i) {
+        output->get_column_by_index(num_probe_columns + i)
+                ->append_selective(*_build_chunk->get_column_by_index(i), indexes.data(), 0, indexes.size());
+    }
+    return output;
+}
+
+size_t JoinHashTable::memory_usage() const {
+    size_t res = _build_chunk == nullptr ? 0 : _build_chunk->memory_usage();
+    res += _build_keys.fixed_keys.allocated_bytes() + _build_keys.key_bytes.allocated_bytes() +
+           _build_keys.key_offsets.allocated_bytes() + _build_keys.nulls.allocated_bytes() +
+           _build_keys.hashes.allocated_bytes();
+    res += _next.allocated_bytes() + _fixed_slots.allocated_bytes() + _serialized_slots.allocated_bytes();
+    return res;
+}
+
+size_t JoinHashTable::append_memory_estimate(const Chunk& chunk) const {
+    size_t estimate = chunk.memory_usage();
+    // Every per-row buffer grows at about the same row count, doubling, and
+    // holds the old copy until the new one is filled.
+    if (_num_build_rows + 1 + chunk.num_rows() > _build_keys.hashes.capacity()) {
+        estimate += 2 * memory_usage();
+    }
+    return estimate;
+}
+
+size_t JoinHashTable::build_memory_estimate() const {
+    size_t num_rows = _num_build_rows + 1;
+    // Scatter buffers, the chain array, and slots at up to 4 per row.
+    size_t per_row = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+    if (_key_kind == JoinKeyKind::kFixed64) {
+        per_row += sizeof(uint64_t) + 4 * sizeof(FixedSlot);
+    } else {
+        per_row += 4 * sizeof(SerializedSlot);
+    }
+    return num_rows * per_row;
+}
+
+JoinProber::JoinProber(const JoinHashTable* table) : _table(table) {}
+
+Status JoinProber::push_probe_chunk(const ChunkPtr& chunk) {
+    size_t num_rows = chunk->num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    const auto& param = _table->param();
+    _table->prepare_probe_keys(*chunk, &_keys);
+    _heads.resize_uninitialized(num_rows);
+    _table->lookup(_keys, num_rows, _heads.data());
+
+    _probe_chunk = chunk;
+    _probe_columns = JoinHashTable::columns_by_desc(*chunk, param.probe_row_desc);
+    _probe_rows = num_rows;
+    _cursor_row = 0;
+    _cursor_build = 0;
+    if (param.join_type == JoinType::FULL_OUTER_JOIN && _build_matched.empty()) {
+        _build_matched.assign(_table->num_build_rows() + 1, 0);
+    }
+    return Status::OK();
+}
+
+void JoinProber::_reset_probe() {
+    _probe_chunk.reset();
+    _probe_columns.clear();
+    _probe_rows = 0;
+    _cursor_row = 0;
+    _cursor_build = 0;
+}
+
+void JoinProber::_emit_semi_or_anti(Chunk* output, bool want_match) {
+    _probe_index.clear();
+    _probe_index.reserve(_probe_rows);
+    for (size_t i = 0; i < _probe_rows; ++i) {
+        if ((_heads[i] != 0) == want_match) {
+            _probe_index.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    for (size_t i = 0; i < _probe_columns.size(); ++i) {
+        output->get_column_by_index(i)->append_selective(*_probe_columns[i], _probe_index.data(), 0,
+                                                         _probe_index.size());
+    }
+    _reset_probe();
+}
+
+void JoinProber::_emit_pairs(Chunk* output, size_t chunk_size) {
+    const JoinType type = _table->join_type();
+    const bool emit_unmatched = type == JoinType::LEFT_OUTER_JOIN || type == JoinType::FULL_OUTER_JOIN;
+    const bool mark_matched = type == JoinType::FULL_OUTER_JOIN;
+    const uint32_t* next = _table->next_rows();
+    uint8_t* matched = _build_matched.data();
+
+    _probe_index.resize_uninitialized(chunk_size);
+    _build_index.resize_uninitialized(chunk_size);
+    uint32_t* probe_index = _probe_index.data();
+    uint32_t* build_index = _build_index.data();
+    size_t count = 0;
+
+    while (_cursor_row < _probe_rows && count < chunk_size) {
+        uint32_t build_row = _cursor_build;
+        if (build_row == 0) {
+            build_row = _heads[_cursor_row];
+            if (build_row == 0) {
+                if (emit_unmatched) {
+                    probe_index[count] = static_cast<uint32_t>(_cursor_row);
+                    build_index[count] = 0;
+                    count++;
+                }
+                _cursor_row++;
+                continue;
+            }
+        }
+        while (build_row != 0 && count < chunk_size) {
+            probe_index[count] = static_cast<uint32_t>(_cursor_row);
+            build_index[count] = build_row;
+            count++;
+            if (mark_matched) {
+                matched[build_row] = 1;
+            }
+            build_row = next[build_row];
+        }
+        _cursor_build = build_row;
+        if (build_row == 0) {
+            _cursor_row++;
+        }
+    }
+
+    size_t num_probe_columns = _probe_columns.size();
+    for (size_t i = 0; i < num_probe_columns; ++i) {
+        output->get_column_by_index(i)->append_selective(*_probe_columns[i], probe_index, 0, count);
+    }
+    const Chunk& build_chunk = _table->build_chunk();
+    for (size_t i = 0; i < build_chunk.num_columns(); ++i) {
+        output->get_column_by_index(num_probe_columns + i)
+                ->append_selective(*build_chunk.get_column_by_index(i), build_index, 0, count);
+    }
+    if (_cursor_row >= _probe_rows) {
+        _reset_probe();
+    }
+}
+
+StatusOr<ChunkPtr> JoinProber::next_output(size_t chunk_size) {
+    if (_probe_chunk == nullptr) {
+        return nullptr;
+    }
+    ChunkPtr output = _table->new_output_chunk(chunk_size);
+    switch (_table->join_type()) {
+    case JoinType::LEFT_SEMI_JOIN:
+        _emit_semi_or_anti(output.get(), true);
+        break;
+    case JoinType::LEFT_ANTI_JOIN:
+        _emit_semi_or_anti(output.get(), false);
+        break;
+    default:
+        _emit_pairs(output.get(), chunk_size);
+        break;
+    }
+    return output;
+}
+
+} // namespace starrocks
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <vector>
+
+#include "column/chunk.h"
+#include "column/vectorized_fwd.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks {
+
+enum class JoinType {
+    INNER_JOIN,
+    LEFT_OUTER_JOIN,
+    LEFT_SEMI_JOIN,
+    LEFT_ANTI_JOIN,
+    FULL_OUTER_JOIN,
+};
+
+const char* join_type_name(JoinType type);
+
+// How the join keys of a row are laid out in the hash table.
+enum class JoinKeyKind {
+    // All keys are fixed width and fit in 8 bytes together: they are packed
+    // into one uint64_t that is stored in the slot itself.
+    kFixed64,
+    // Anything else: keys are serialized column by column into one byte
+    // string per row; slots hold a hash tag and the row id.
+    kSerialized,
+};
+
+// Join keys of a batch of rows, in the table's key layout.
+struct JoinKeyBatch {
+    Buffer<uint64_t> fixed_keys;
+    Buffer<uint8_t> key_bytes;
+    Buffer<uint32_t> key_offsets;
+    // 1 when any key of the row is NULL; such rows never match.
+    Filter nulls;
+    bool has_null = false;
+    Buffer<uint64_t> hashes;
+
+    Slice serialized_key(size_t i) const {
+        return {reinterpret_cast<const char*>(key_bytes.data()) + key_offsets[i], key_offsets[i + 1] - key_offsets[i]};
+    }
+};
+
+// Flat open-addressing hash table for equi-joins.
+//
+// Build rows are appended column-wise into one chunk whose row 0 is an all-NULL
+// row, so row ids are 1-based and id 0 doubles as "no match": probing yields,
+// per probe row, the id of the first build row with an equal key (0 if none),
+// and outer joins materialize the NULL-extended side with the same
+// append_selective() as the matches. Each distinct key occupies one slot of
+// an open-addressing, linearly probed array; rows with duplicate keys are
+// linked through the |_next| array by row id, so the table holds no pointers.
+//
+// When the slot array would not fit in L2 the table is radix-partitioned on
+// the high bits of the hash into partitions of about config::
+// join_hash_table_partition_bytes each, and build rows are scattered by
+// partition before insertion so the inserts work on one cache-resident
+// partition at a time. Probing goes one chunk at a time and hides the
+// remaining slot misses by prefetching a fixed distance ahead.
+class JoinHashTable {
+public:
+    struct Param {
+        JoinType join_type = JoinType::INNER_JOIN;
+        RowDescriptor build_row_desc;
+        std::vector<SlotId> build_key_slots;
+        RowDescriptor probe_row_desc;
+        std::vector<SlotId> probe_key_slots;
+    };
+
+    explicit JoinHashTable(Param param);
+
+    DISALLOW_COPY_AND_MOVE(JoinHashTable);
+
+    // Validates the key types; must be called before anything else.
+    Status prepare();
+
+    // Not thread-safe; HashJoiner serializes concurrent builders.
+    Status append_build_chunk(const ChunkPtr& chunk);
+
+    // Inserts every appended row. The table is read-only afterwards and may
+    // be probed from any number of threads through JoinProbers.
+    Status build();
+
+    const Param& param() const { return _param; }
+    JoinType join_type() const { return _param.join_type; }
+    JoinKeyKind key_kind() const { return _key_kind; }
+
+    // Build rows, not counting the NULL row 0.
+    size_t num_build_rows() const { return _num_build_rows; }
+    size_t num_distinct_keys() const { return _num_distinct_keys; }
+    size_t num_partitions() const { return _partition_offsets.empty() ? 0 : _partition_offsets.size() - 1; }
+    size_t memory_usage() const;
+    // Roughly what append_build_chunk(chunk) and build() allocate on top of
+    // memory_usage(), counting buffers that are reallocated in full.
+    size_t append_memory_estimate(const Chunk& chunk) const;
+    size_t build_memory_estimate() const;
+
+    // Whether output chunks carry the build side's columns.
+    bool output_build_columns() const;
+
+    // Empty chunk with the layout of this join's output.
+    ChunkPtr new_output_chunk(size_t reserve) const;
+
+    // Emits up to |chunk_size| build rows at or after *|cursor| whose
+    // |matched| byte is zero (all of them if |matched| is empty), NULL-extended
+    // on the probe side (FULL OUTER JOIN). Advances |cursor|; returns nullptr
+    // once all rows were visited.
+    ChunkPtr next_unmatched_build_chunk(const Filter& matched, uint32_t* cursor, size_t chunk_size) const;
+
+    // Computes key layout, null flags and hashes of |key_columns|.
+    void prepare_keys(const Columns& key_columns, size_t num_rows, JoinKeyBatch* keys) const;
+    // Same, for the build (probe) key slots of |chunk|.
+    void prepare_build_keys(const Chunk& chunk, JoinKeyBatch* keys) const;
+    void prepare_probe_keys(const Chunk& chunk, JoinKeyBatch* keys) const;
+
+    // Fills heads[i] with the first build row whose key equals row i's key, or
+    // 0. Slots are prefetched a fixed distance ahead of the row being looked up.
+    void lookup(const JoinKeyBatch& keys, size_t num_rows, uint32_t* heads) const;
+
+    const Chunk& build_chunk() const { return *_build_chunk; }
+    const uint32_t* next_rows() const { return _next.data(); }
+
+    // Columns of |chunk| in the order of |desc|, with constants unfolded.
+    static Columns columns_by_desc(const Chunk& chunk, const RowDescriptor& desc);
+
+private:
+    struct FixedSlot {
+        uint64_t key;
+        uint32_t head;
+        uint32_t unused;
+    };
+    struct SerializedSlot {
+        uint32_t tag;
+        uint32_t head;
+    };
+
+    Columns _key_columns(const Chunk& chunk, const std::vector<SlotId>& key_slots) const;
+    void _init_partitions();
+    size_t _partition_of(uint64_t hash) const { return _partition_bits == 0 ? 0 : hash >> (64 - _partition_bits); }
+
+    template <JoinKeyKind KK>
+    void _insert_rows(const uint32_t* rows, const uint64_t* hashes, const uint64_t* fixed_keys, size_t num_rows);
+    template <JoinKeyKind KK>
+    void _lookup(const JoinKeyBatch& keys, size_t num_rows, uint32_t* heads) const;
+
+    Param _param;
+    JoinKeyKind _key_kind = JoinKeyKind::kSerialized;
+    std::vector<LogicalType> _key_types;
+
+    ChunkPtr _build_chunk;
+    ChunkPtr _output_template;
+    size_t _num_build_rows = 0;
+    size_t _num_distinct_keys = 0;
+    // Keys of the build rows, indexed by row id. Fixed keys are dropped after
+    // build() because the slots hold them.
+    JoinKeyBatch _build_keys;
+
+    Buffer<uint32_t> _next;
+    Buffer<FixedSlot> _fixed_slots;
+    Buffer<SerializedSlot> _serialized_slots;
+    int _partition_bits = 0;
+    // Partition p owns slots [_partition_offsets[p], _partition_offsets[p + 1]),
+    // a power of two in number.
+    std::vector<size_t> _partition_offsets;
+};
+
+// Per-driver probing state over a shared, built JoinHashTable. Turns probe
+// chunks into output chunks of at most chunk_size rows, resuming inside a
+// probe chunk when it fans out to more rows than that.
+class JoinProber {
+public:
+    explicit JoinProber(const JoinHashTable* table);
+
+    Status push_probe_chunk(const ChunkPtr& chunk);
+
+    // True while the current probe chunk has not been fully emitted.
+    bool has_remaining() const { return _probe_chunk != nullptr; }
+
+    StatusOr<ChunkPtr> next_output(size_t chunk_size);
+
+    // Build rows matched by this prober (FULL OUTER JOIN only).
+    const Filter& build_matched() const { return _build_matched; }
+
+private:
+    void _emit_semi_or_anti(Chunk* output, bool want_match);
+    void _emit_pairs(Chunk* output, size_t chunk_size);
+    void _reset_probe();
+
+    const JoinHashTable* _table;
+    JoinKeyBatch _keys;
+    Buffer<uint32_t> _heads;
+    Filter _build_matched;
+
+    ChunkPtr _probe_chunk;
+    Columns _probe_columns;
+    size_t _probe_rows = 0;
+    size_t _cursor_row = 0;
+    // Next build row to emit for _cursor_row when a chain was cut short.
+    uint32_t _cursor_build = 0;
+
+    Buffer<uint32_t> _probe_index;
+    Buffer<uint32_t> _build_index;
+};
+
+} // namespace starrocks
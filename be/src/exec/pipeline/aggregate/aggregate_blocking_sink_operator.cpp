@@ -0,0 +1,40 @@
+#include "exec/pipeline/aggregate/aggregate_blocking_sink_operator.h"
+
+#include "exec/pipeline/fragment_context.h"
+#include "runtime/query_context.h"
+
+namespace starrocks::pipeline {
+
+Status AggregateBlockingSinkOperator::set_finishing(RuntimeState* state) {
+    if (_is_finished) {
+        return Status::OK();
+    }
+    _is_finished = true;
+    if (_aggregator->is_spilled() && !state->is_cancelled()) {
+        RETURN_IF_ERROR(_aggregator->finish_spill());
+    }
+    _aggregator->set_sink_complete();
+    state->fragment_ctx()->notify_event();
+    return Status::OK();
+}
+
+Status AggregateBlockingSinkOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    // Spill before the groups grow past the threshold, not after, and while
+    // there is room left for their spilled copies: a growing hash table holds
+    // its old and new slots at once, and the groups are only freed once all
+    // of them have been copied out.
+    size_t extra_bytes = _aggregator->append_memory_estimate(*chunk) + _aggregator->spill_memory_estimate();
+    if (state->query_ctx()->should_spill(extra_bytes)) {
+        RETURN_IF_ERROR(_aggregator->spill(state));
+    }
+    RETURN_IF_ERROR(_aggregator->append_chunk(*chunk));
+    _aggregator->update_mem_usage();
+    return Status::OK();
+}
+
+OperatorPtr AggregateBlockingSinkOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<AggregateBlockingSinkOperator>(this, _id, _plan_node_id, driver_sequence,
+                                                           _aggregator_factory->get_or_create(driver_sequence));
+}
+
+} // namespace starrocks::pipeline
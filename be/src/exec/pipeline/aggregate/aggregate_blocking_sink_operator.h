@@ -0,0 +1,50 @@
+#pragma once
+
+#include "exec/aggregator.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Sink of a blocking aggregation: folds every chunk into the driver's
+// Aggregator, and hands it to the source driver of the same sequence once
+// the input is exhausted. Spills the groups whenever the query crosses its
+// spill threshold, and holds back input while the writes queue up.
+class AggregateBlockingSinkOperator final : public Operator {
+public:
+    AggregateBlockingSinkOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                  int32_t driver_sequence, AggregatorPtr aggregator)
+            : Operator(factory, id, "aggregate_blocking_sink", plan_node_id, driver_sequence),
+              _aggregator(std::move(aggregator)) {}
+
+    Status prepare(RuntimeState* state) override { return _aggregator->prepare(state, mem_tracker()); }
+
+    bool has_output() const override { return false; }
+    bool need_input() const override { return !_is_finished && !_aggregator->is_spill_backlogged(); }
+    bool is_finished() const override { return _is_finished; }
+    bool pending_finish() const override { return _aggregator->has_pending_spill_writes(); }
+
+    Status set_finishing(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override {
+        return Status::InternalError("aggregate blocking sink does not produce output");
+    }
+
+private:
+    AggregatorPtr _aggregator;
+    bool _is_finished = false;
+};
+
+class AggregateBlockingSinkOperatorFactory final : public OperatorFactory {
+public:
+    AggregateBlockingSinkOperatorFactory(int32_t id, int32_t plan_node_id, AggregatorFactoryPtr aggregator_factory)
+            : OperatorFactory(id, "aggregate_blocking_sink", plan_node_id),
+              _aggregator_factory(std::move(aggregator_factory)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    AggregatorFactoryPtr _aggregator_factory;
+};
+
+} // namespace starrocks::pipeline
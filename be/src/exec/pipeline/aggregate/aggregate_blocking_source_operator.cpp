@@ -0,0 +1,25 @@
+#include "exec/pipeline/aggregate/aggregate_blocking_source_operator.h"
+
+namespace starrocks::pipeline {
+
+void AggregateBlockingSourceOperator::close(RuntimeState* state) {
+    // A cancelled sink may still be using the groups; they then go with the
+    // Aggregator.
+    if (_aggregator->is_sink_complete()) {
+        _aggregator->close();
+    }
+}
+
+StatusOr<ChunkPtr> AggregateBlockingSourceOperator::pull_chunk(RuntimeState* state) {
+    if (_aggregator->is_spilled()) {
+        return _aggregator->next_spilled_output(state->chunk_size());
+    }
+    return _aggregator->next_output(state->chunk_size());
+}
+
+OperatorPtr AggregateBlockingSourceOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<AggregateBlockingSourceOperator>(this, _id, _plan_node_id, driver_sequence,
+                                                             _aggregator_factory->get_or_create(driver_sequence));
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "exec/aggregator.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Emits the groups of a blocking aggregation. Has no output until the sink
+// driver of the same sequence is done, which keeps its driver parked in the
+// poller; its pipeline must run at the sink pipeline's degree of parallelism.
+// A spilled aggregation also waits for its spill writes to drain.
+class AggregateBlockingSourceOperator final : public SourceOperator {
+public:
+    AggregateBlockingSourceOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                    int32_t driver_sequence, AggregatorPtr aggregator)
+            : SourceOperator(factory, id, "aggregate_blocking_source", plan_node_id, driver_sequence),
+              _aggregator(std::move(aggregator)) {}
+
+    bool has_output() const override {
+        return !_is_finished && _aggregator->is_sink_complete() && !_aggregator->is_output_done() &&
+               !_aggregator->has_pending_spill_writes();
+    }
+    bool is_finished() const override {
+        return _is_finished || (_aggregator->is_sink_complete() && _aggregator->is_output_done());
+    }
+
+    Status set_finished(RuntimeState* state) override {
+        _is_finished = true;
+        return Status::OK();
+    }
+
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    void close(RuntimeState* state) override;
+
+private:
+    AggregatorPtr _aggregator;
+    bool _is_finished = false;
+};
+
+class AggregateBlockingSourceOperatorFactory final : public SourceOperatorFactory {
+public:
+    AggregateBlockingSourceOperatorFactory(int32_t id, int32_t plan_node_id, AggregatorFactoryPtr aggregator_factory)
+            : SourceOperatorFactory(id, "aggregate_blocking_source", plan_node_id),
+              _aggregator_factory(std::move(aggregator_factory)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    AggregatorFactoryPtr _aggregator_factory;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,113 @@
+#include "exec/pipeline/aggregate/aggregate_streaming_operator.h"
+
+#include "common/config.h"
+#include "runtime/query_context.h"
+#include "util/cpu_info.h"
+
+namespace starrocks::pipeline {
+
+Status AggregateStreamingOperator::prepare(RuntimeState* state) {
+    const auto& param = _aggregator->param();
+    if (param.merge_input || !param.output_intermediate) {
+        return Status::InvalidArgument("streaming aggregation must turn raw rows into intermediate values");
+    }
+    _hash_table_limit = config::streaming_agg_hash_table_bytes > 0 ? config::streaming_agg_hash_table_bytes
+                                                                   : CpuInfo::l2_cache_size();
+    return _aggregator->prepare(state, mem_tracker());
+}
+
+bool AggregateStreamingOperator::has_output() const {
+    if (_is_finished) {
+        return false;
+    }
+    return _pass_through_chunk != nullptr || _is_flushing || (_is_finishing && !_aggregator->is_output_done());
+}
+
+bool AggregateStreamingOperator::need_input() const {
+    return !_is_finishing && !_is_finished && _pass_through_chunk == nullptr && !_is_flushing;
+}
+
+bool AggregateStreamingOperator::is_finished() const {
+    if (_is_finished) {
+        return true;
+    }
+    return _is_finishing && _pass_through_chunk == nullptr && !_is_flushing && _aggregator->is_output_done();
+}
+
+Status AggregateStreamingOperator::set_finishing(RuntimeState* state) {
+    _is_finishing = true;
+    return Status::OK();
+}
+
+Status AggregateStreamingOperator::set_finished(RuntimeState* state) {
+    _is_finished = true;
+    _pass_through_chunk.reset();
+    return Status::OK();
+}
+
+Status AggregateStreamingOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    // Without GROUP BY every driver emits a single row anyway.
+    bool has_group_by = _aggregator->has_group_by();
+    if (has_group_by && (_mode == StreamingPreaggMode::FORCE_STREAMING || _pass_through_chunks_left > 0)) {
+        _pass_through_chunk = _aggregator->convert_to_intermediate(*chunk);
+        _num_pass_through_rows += chunk->num_rows();
+        if (_pass_through_chunks_left > 0) {
+            --_pass_through_chunks_left;
+        }
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_aggregator->append_chunk(*chunk));
+    _aggregator->update_mem_usage();
+    if (_mode == StreamingPreaggMode::AUTO && _should_pass_through(state)) {
+        _is_flushing = true;
+        _pass_through_chunks_left = config::streaming_agg_pass_through_chunks;
+        ++_num_flushes;
+    } else if (_mode == StreamingPreaggMode::FORCE_PREAGGREGATION && has_group_by && _aggregator->num_groups() > 0 &&
+               _is_short_of_memory(state)) {
+        // Still aggregating, but without holding the groups past the budget.
+        _is_flushing = true;
+        ++_num_flushes;
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> AggregateStreamingOperator::pull_chunk(RuntimeState* state) {
+    if (_pass_through_chunk != nullptr) {
+        return std::move(_pass_through_chunk);
+    }
+    ChunkPtr chunk = _aggregator->next_output(state->chunk_size());
+    if (chunk == nullptr && _is_flushing) {
+        _aggregator->reset();
+        _aggregator->update_mem_usage();
+        _is_flushing = false;
+    }
+    return chunk;
+}
+
+void AggregateStreamingOperator::close(RuntimeState* state) {
+    _aggregator->close();
+}
+
+bool AggregateStreamingOperator::_should_pass_through(RuntimeState* state) const {
+    size_t num_groups = _aggregator->num_groups();
+    if (!_aggregator->has_group_by() || num_groups == 0) {
+        return false;
+    }
+    // Emitting the groups early is always allowed, and frees their memory.
+    if (_is_short_of_memory(state)) {
+        return true;
+    }
+    if (_aggregator->memory_usage() <= static_cast<size_t>(_hash_table_limit)) {
+        return false;
+    }
+    return static_cast<double>(_aggregator->num_input_rows()) <
+           config::streaming_agg_min_reduction * static_cast<double>(num_groups);
+}
+
+bool AggregateStreamingOperator::_is_short_of_memory(RuntimeState* state) const {
+    // The groups are freed once they have all been emitted, so their copies
+    // must fit next to them.
+    return state->query_ctx()->should_spill(_aggregator->spill_memory_estimate());
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "exec/aggregator.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+enum class StreamingPreaggMode {
+    // Aggregate while that reduces the rows enough, pass them through otherwise.
+    AUTO,
+    FORCE_STREAMING,
+    FORCE_PREAGGREGATION,
+};
+
+// First phase of a two-phase aggregation, in front of the shuffle: folds its
+// input into intermediate values and emits them as its groups fill up or the
+// input ends, so the final phase merges partial groups from every driver.
+//
+// Aggregating only pays if it shrinks the data going to the shuffle. In AUTO
+// mode, once the hash table has outgrown the cache (or the query has to
+// spill), the operator checks how many input rows each group absorbed; when
+// that is below streaming_agg_min_reduction, as with high-cardinality keys,
+// it flushes its groups, frees them, and passes the next
+// streaming_agg_pass_through_chunks chunks through as single-row groups
+// before trying again. FORCE_PREAGGREGATION never passes rows through, but
+// flushes its groups as well when the query has to spill.
+class AggregateStreamingOperator final : public Operator {
+public:
+    AggregateStreamingOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                               const Aggregator::Param& param, StreamingPreaggMode mode)
+            : Operator(factory, id, "aggregate_streaming", plan_node_id, driver_sequence),
+              _aggregator(std::make_unique<Aggregator>(param)),
+              _mode(mode) {}
+
+    Status prepare(RuntimeState* state) override;
+
+    bool has_output() const override;
+    bool need_input() const override;
+    bool is_finished() const override;
+
+    Status set_finishing(RuntimeState* state) override;
+    Status set_finished(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    void close(RuntimeState* state) override;
+
+    int64_t num_pass_through_rows() const { return _num_pass_through_rows; }
+    int64_t num_flushes() const { return _num_flushes; }
+
+private:
+    // Whether the groups collected so far justify aggregating further.
+    bool _should_pass_through(RuntimeState* state) const;
+    // The query is about to cross its spill threshold.
+    bool _is_short_of_memory(RuntimeState* state) const;
+
+    std::unique_ptr<Aggregator> _aggregator;
+    const StreamingPreaggMode _mode;
+    int64_t _hash_table_limit = 0;
+
+    // A passed-through chunk waiting to be pulled.
+    ChunkPtr _pass_through_chunk;
+    // The groups are being emitted to start over empty.
+    bool _is_flushing = false;
+    int32_t _pass_through_chunks_left = 0;
+    bool _is_finishing = false;
+    bool _is_finished = false;
+
+    int64_t _num_pass_through_rows = 0;
+    int64_t _num_flushes = 0;
+};
+
+class AggregateStreamingOperatorFactory final : public OperatorFactory {
+public:
+    AggregateStreamingOperatorFactory(int32_t id, int32_t plan_node_id, Aggregator::Param param,
+                                      StreamingPreaggMode mode = StreamingPreaggMode::AUTO)
+            : OperatorFactory(id, "aggregate_streaming", plan_node_id), _param(std::move(param)), _mode(mode) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override {
+        return std::make_shared<AggregateStreamingOperator>(this, _id, _plan_node_id, driver_sequence, _param, _mode);
+    }
+
+private:
+    const Aggregator::Param _param;
+    const StreamingPreaggMode _mode;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,29 @@
+#include "exec/pipeline/analytic/analytic_operator.h"
+
+namespace starrocks::pipeline {
+
+Status AnalyticOperator::set_finishing(RuntimeState* state) {
+    _analytor->set_input_finished();
+    _analytor->update_mem_usage();
+    return Status::OK();
+}
+
+Status AnalyticOperator::set_finished(RuntimeState* state) {
+    _is_finished = true;
+    _analytor->close();
+    return Status::OK();
+}
+
+Status AnalyticOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    RETURN_IF_ERROR(_analytor->append_chunk(*chunk));
+    _analytor->update_mem_usage();
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> AnalyticOperator::pull_chunk(RuntimeState* state) {
+    ChunkPtr chunk = _analytor->next_output();
+    _analytor->update_mem_usage();
+    return chunk;
+}
+
+} // namespace starrocks::pipeline
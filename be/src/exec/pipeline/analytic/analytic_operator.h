@@ -0,0 +1,53 @@
+#pragma once
+
+#include "exec/analytor.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Computes window functions over its input, which arrives sorted by the
+// partition and order keys (behind a sort, see SortContext). Not blocking:
+// rows leave as soon as their frames are complete (see Analytor), and input
+// is held back while a chunk of computed rows waits to be pulled.
+class AnalyticOperator final : public Operator {
+public:
+    AnalyticOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                     const Analytor::Param& param)
+            : Operator(factory, id, "analytic", plan_node_id, driver_sequence),
+              _analytor(std::make_unique<Analytor>(param)) {}
+
+    Status prepare(RuntimeState* state) override { return _analytor->prepare(state, mem_tracker()); }
+
+    bool has_output() const override { return !_is_finished && _analytor->has_output(); }
+    bool need_input() const override { return !_is_finished && _analytor->need_input(); }
+    bool is_finished() const override { return _is_finished || _analytor->is_output_done(); }
+
+    Status set_finishing(RuntimeState* state) override;
+    Status set_finished(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    void close(RuntimeState* state) override { _analytor->close(); }
+
+    const Analytor& analytor() const { return *_analytor; }
+
+private:
+    std::unique_ptr<Analytor> _analytor;
+    bool _is_finished = false;
+};
+
+class AnalyticOperatorFactory final : public OperatorFactory {
+public:
+    AnalyticOperatorFactory(int32_t id, int32_t plan_node_id, Analytor::Param param)
+            : OperatorFactory(id, "analytic", plan_node_id), _param(std::move(param)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override {
+        return std::make_shared<AnalyticOperator>(this, _id, _plan_node_id, driver_sequence, _param);
+    }
+
+private:
+    const Analytor::Param _param;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,19 @@
+#include "exec/pipeline/dict_decode_operator.h"
+
+namespace starrocks::pipeline {
+
+Status DictDecodeOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    // The input's columns may be shared, so the words go into a new chunk.
+    auto decoded = std::make_shared<Chunk>(chunk->columns(), chunk->get_slot_id_to_index_map());
+    for (const auto& slot : _slots) {
+        if (!decoded->is_slot_exist(slot.slot_id)) {
+            return Status::InternalError("dict decode: no slot " + std::to_string(slot.slot_id) + " in the input");
+        }
+        ASSIGN_OR_RETURN(ColumnPtr words, slot.dict->decode(*decoded->get_column_by_slot_id(slot.slot_id)));
+        decoded->update_column(std::move(words), slot.slot_id);
+    }
+    _chunk = std::move(decoded);
+    return Status::OK();
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "exec/pipeline/operator.h"
+#include "storage/global_dict.h"
+
+namespace starrocks::pipeline {
+
+// A slot carrying the codes of a global dictionary (see GlobalDictionary).
+struct DictDecodeSlot {
+    SlotId slot_id;
+    GlobalDictPtr dict;
+};
+
+// Turns global dictionary codes back into strings. Scans read low-cardinality
+// VARCHAR columns as codes, which every operator after them handles as plain
+// INT values; this operator, placed where the strings are needed again,
+// usually right before the result sink, replaces the code columns of its
+// slots by the words and passes the other columns on untouched.
+class DictDecodeOperator final : public Operator {
+public:
+    DictDecodeOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                       const std::vector<DictDecodeSlot>& slots)
+            : Operator(factory, id, "dict_decode", plan_node_id, driver_sequence), _slots(slots) {}
+
+    bool has_output() const override { return _chunk != nullptr; }
+    bool need_input() const override { return _chunk == nullptr && !_is_finishing; }
+    bool is_finished() const override { return _is_finishing && _chunk == nullptr; }
+
+    Status set_finishing(RuntimeState* state) override {
+        _is_finishing = true;
+        return Status::OK();
+    }
+    Status set_finished(RuntimeState* state) override {
+        _is_finishing = true;
+        _chunk.reset();
+        return Status::OK();
+    }
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override { return std::move(_chunk); }
+
+private:
+    const std::vector<DictDecodeSlot>& _slots;
+    ChunkPtr _chunk;
+    bool _is_finishing = false;
+};
+
+class DictDecodeOperatorFactory final : public OperatorFactory {
+public:
+    DictDecodeOperatorFactory(int32_t id, int32_t plan_node_id, std::vector<DictDecodeSlot> slots)
+            : OperatorFactory(id, "dict_decode", plan_node_id), _slots(std::move(slots)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override {
+        return std::make_shared<DictDecodeOperator>(this, _id, _plan_node_id, driver_sequence, _slots);
+    }
+
+private:
+    const std::vector<DictDecodeSlot> _slots;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "exec/pipeline/pipeline_driver.h"
+
+namespace starrocks::pipeline {
+
+// Per-worker run queue of ready drivers.
+//
+// The owning worker pushes and pops at the back (LIFO), so a driver that just
+// unblocked runs again while its operators' state is still in cache. A driver
+// that yielded its time slice goes to the front, behind every other ready
+// driver of that worker. Idle workers steal from the front, taking the work
+// the owner would reach last.
+class WorkStealingDriverQueue {
+public:
+    void push_back(DriverRawPtr driver) {
+        std::lock_guard<std::mutex> l(_lock);
+        _drivers.push_back(driver);
+    }
+
+    void push_front(DriverRawPtr driver) {
+        std::lock_guard<std::mutex> l(_lock);
+        _drivers.push_front(driver);
+    }
+
+    DriverRawPtr pop_back() {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_drivers.empty()) {
+            return nullptr;
+        }
+        DriverRawPtr driver = _drivers.back();
+        _drivers.pop_back();
+        return driver;
+    }
+
+    DriverRawPtr steal() {
+        std::unique_lock<std::mutex> l(_lock, std::try_to_lock);
+        if (!l.owns_lock() || _drivers.empty()) {
+            return nullptr;
+        }
+        DriverRawPtr driver = _drivers.front();
+        _drivers.pop_front();
+        return driver;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> l(_lock);
+        return _drivers.size();
+    }
+
+private:
+    mutable std::mutex _lock;
+    std::deque<DriverRawPtr> _drivers;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,50 @@
+#include "exec/pipeline/exchange/chunk_packet.h"
+
+#include <utility>
+
+#include "exec/spill/spill_serde.h"
+
+namespace starrocks::pipeline {
+
+Status ChunkPacketEncoder::encode(const Chunk& chunk, ChunkPacket* packet) {
+    packet->num_rows = static_cast<uint32_t>(chunk.num_rows());
+    packet->compression = CompressionType::NO_COMPRESSION;
+    if (_codec == nullptr || _codec->type() == CompressionType::NO_COMPRESSION) {
+        spill::serialize_chunk(chunk, _desc, &packet->payload);
+        packet->raw_size = packet->payload.size();
+        return Status::OK();
+    }
+    spill::serialize_chunk(chunk, _desc, &_raw);
+    size_t raw_size = _raw.size();
+    packet->raw_size = raw_size;
+    packet->payload.resize_uninitialized(_codec->max_compressed_len(raw_size));
+    size_t compressed_size = 0;
+    RETURN_IF_ERROR(_codec->compress(Slice(_raw.data(), raw_size), packet->payload.data(), &compressed_size));
+    if (compressed_size < raw_size) {
+        packet->payload.resize_uninitialized(compressed_size);
+        packet->compression = _codec->type();
+    } else {
+        // Incompressible rows go raw: the scratch buffer becomes the payload
+        // and the payload's buffer the next scratch.
+        std::swap(packet->payload, _raw);
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> decode_chunk_packet(const ChunkPacket& packet, const RowDescriptor& desc,
+                                       Buffer<uint8_t>* scratch) {
+    const uint8_t* raw = packet.payload.data();
+    if (packet.compression != CompressionType::NO_COMPRESSION) {
+        ASSIGN_OR_RETURN(const BlockCompressionCodec* codec, get_block_compression_codec(packet.compression));
+        scratch->resize_uninitialized(packet.raw_size);
+        RETURN_IF_ERROR(codec->decompress(Slice(packet.payload.data(), packet.payload.size()), scratch->data(),
+                                          packet.raw_size));
+        raw = scratch->data();
+    } else if (packet.payload.size() != packet.raw_size) {
+        return Status::Corruption("exchange packet has " + std::to_string(packet.payload.size()) + " bytes, expected " +
+                                  std::to_string(packet.raw_size));
+    }
+    return spill::deserialize_chunk(raw, packet.raw_size, packet.num_rows, desc);
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+
+#include "column/buffer.h"
+#include "column/chunk.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+#include "util/block_compression.h"
+
+namespace starrocks::pipeline {
+
+// A batch of rows on its way from an exchange sink to the exchange source of
+// another fragment instance. The payload is the columnar layout of
+// spill::serialize_chunk(), compressed as a whole unless that saves nothing;
+// the receiver knows the row descriptor, so the packet carries no types.
+//
+// Packets are immutable once encoded, so a broadcast sends the same packet,
+// encoded once, to every destination.
+struct ChunkPacket {
+    // The sending driver, numbered across all instances feeding the exchange.
+    int32_t sender_id = 0;
+    // Per sender and destination, from 0. The last packet of a sender is
+    // flagged eos and carries no rows.
+    int64_t sequence = 0;
+    bool eos = false;
+    uint32_t num_rows = 0;
+    CompressionType compression = CompressionType::NO_COMPRESSION;
+    // Size of the serialized rows before compression.
+    uint64_t raw_size = 0;
+    Buffer<uint8_t> payload;
+};
+
+using ChunkPacketPtr = std::shared_ptr<const ChunkPacket>;
+
+// Encodes the chunks of one sender. The columns are copied into the payload
+// with one memcpy each; with compression they go through a scratch buffer
+// kept across calls, so a sender in its steady state only allocates payloads.
+class ChunkPacketEncoder {
+public:
+    // |codec| may be nullptr for no compression.
+    ChunkPacketEncoder(RowDescriptor desc, const BlockCompressionCodec* codec)
+            : _desc(std::move(desc)), _codec(codec) {}
+
+    // Fills the rows, compression and payload of |packet|.
+    Status encode(const Chunk& chunk, ChunkPacket* packet);
+
+    const RowDescriptor& desc() const { return _desc; }
+
+private:
+    const RowDescriptor _desc;
+    const BlockCompressionCodec* _codec;
+    Buffer<uint8_t> _raw;
+};
+
+// |scratch| holds the decompressed rows of compressed packets; callers keep
+// one per thread to reuse it.
+StatusOr<ChunkPtr> decode_chunk_packet(const ChunkPacket& packet, const RowDescriptor& desc,
+                                       Buffer<uint8_t>* scratch);
+
+} // namespace starrocks::pipeline
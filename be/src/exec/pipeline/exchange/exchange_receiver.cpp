@@ -0,0 +1,106 @@
+#include "exec/pipeline/exchange/exchange_receiver.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+
+namespace starrocks::pipeline {
+
+ExchangeReceiver::ExchangeReceiver(FragmentContext* fragment_ctx, int32_t num_senders)
+        : _fragment_ctx(fragment_ctx),
+          _max_buffered_bytes(std::max<int64_t>(config::exchange_receiver_buffer_bytes, 1)),
+          _next_sequence(num_senders, 0),
+          _num_running_senders(num_senders) {}
+
+Status ExchangeReceiver::add_packet(ChunkPacketPtr packet) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (packet->sender_id < 0 || packet->sender_id >= static_cast<int32_t>(_next_sequence.size())) {
+            return Status::InvalidArgument("exchange packet from unknown sender " + std::to_string(packet->sender_id));
+        }
+        int64_t& next = _next_sequence[packet->sender_id];
+        if (packet->sequence < next) {
+            return Status::OK();
+        }
+        if (packet->sequence > next) {
+            return Status::InternalError("exchange packet " + std::to_string(packet->sequence) + " of sender " +
+                                         std::to_string(packet->sender_id) + " arrived before " +
+                                         std::to_string(next));
+        }
+        ++next;
+        _num_packets.fetch_add(1, std::memory_order_relaxed);
+        _bytes_received.fetch_add(packet->payload.size(), std::memory_order_relaxed);
+        if (packet->eos) {
+            // The sources may be waiting for the last sender to finish.
+            wake = --_num_running_senders == 0;
+        }
+        if (!_closed && packet->num_rows > 0) {
+            wake = wake || _packets.empty();
+            _buffered_bytes += packet->payload.size();
+            _packets.emplace_back(std::move(packet));
+        }
+    }
+    if (wake) {
+        _fragment_ctx->notify_event();
+    }
+    return Status::OK();
+}
+
+bool ExchangeReceiver::is_full() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _buffered_bytes >= _max_buffered_bytes;
+}
+
+bool ExchangeReceiver::has_output() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return !_packets.empty();
+}
+
+ChunkPacketPtr ExchangeReceiver::pull() {
+    ChunkPacketPtr packet;
+    bool was_full = false;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_packets.empty()) {
+            return nullptr;
+        }
+        was_full = _buffered_bytes >= _max_buffered_bytes;
+        packet = std::move(_packets.front());
+        _packets.pop_front();
+        _buffered_bytes -= packet->payload.size();
+        was_full = was_full && _buffered_bytes < _max_buffered_bytes;
+    }
+    // Blocked senders may go on.
+    if (was_full) {
+        _fragment_ctx->notify_event();
+    }
+    return packet;
+}
+
+bool ExchangeReceiver::is_finished() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_running_senders == 0 && _packets.empty();
+}
+
+void ExchangeReceiver::set_num_sources(int32_t num_sources) {
+    std::lock_guard<std::mutex> l(_lock);
+    _num_running_sources = num_sources;
+}
+
+void ExchangeReceiver::finish_source() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (--_num_running_sources == 0) {
+        _closed = true;
+        _packets.clear();
+        _buffered_bytes = 0;
+    }
+}
+
+bool ExchangeReceiver::is_closed() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _closed;
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "exec/pipeline/exchange/chunk_packet.h"
+
+namespace starrocks::pipeline {
+
+class FragmentContext;
+
+// The receiving end of an exchange in one fragment instance. Packets from
+// the |num_senders| sending drivers queue here until the exchange source
+// drivers take them; each source decodes what it took, so decoding runs at
+// the source's degree of parallelism.
+//
+// Backpressure: while the queued payloads exceed config::
+// exchange_receiver_buffer_bytes the receiver is_full() and senders hold
+// back (see ExchangeTransport::can_send()); a sender overshoots by at most
+// the packets it was already encoding.
+class ExchangeReceiver {
+public:
+    ExchangeReceiver(FragmentContext* fragment_ctx, int32_t num_senders);
+
+    DISALLOW_COPY_AND_MOVE(ExchangeReceiver);
+
+    // Packets of one sender must come in sequence; a sequence number seen
+    // before is a resend and ignored. Packets after close are dropped.
+    Status add_packet(ChunkPacketPtr packet);
+
+    bool is_full() const;
+    bool has_output() const;
+    // nullptr when nothing is queued.
+    ChunkPacketPtr pull();
+
+    // Every sender sent eos and every packet was pulled.
+    bool is_finished() const;
+
+    // Called once the source pipeline's degree of parallelism is known.
+    void set_num_sources(int32_t num_sources);
+    // One source is done; once all are (e.g. a downstream LIMIT was
+    // reached), queued packets are dropped and the senders stop.
+    void finish_source();
+    bool is_closed() const;
+
+    int64_t num_packets() const { return _num_packets.load(std::memory_order_relaxed); }
+    int64_t bytes_received() const { return _bytes_received.load(std::memory_order_relaxed); }
+
+private:
+    FragmentContext* const _fragment_ctx;
+    const int64_t _max_buffered_bytes;
+    mutable std::mutex _lock;
+    std::deque<ChunkPacketPtr> _packets;
+    int64_t _buffered_bytes = 0;
+    std::vector<int64_t> _next_sequence;
+    int32_t _num_running_senders;
+    int32_t _num_running_sources = 0;
+    bool _closed = false;
+
+    std::atomic<int64_t> _num_packets{0};
+    std::atomic<int64_t> _bytes_received{0};
+};
+
+using ExchangeReceiverPtr = std::shared_ptr<ExchangeReceiver>;
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,260 @@
+#include "exec/pipeline/exchange/exchange_sink_operator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "column/column_helper.h"
+#include "common/config.h"
+#include "exec/spill/spill_serde.h"
+#include "util/hash_util.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::pipeline {
+
+// Stands in for the value of NULL rows, whose data is undefined.
+static constexpr uint64_t kNullHash = 0x5BD1E9955BD1E995ULL;
+
+// The bits of a FLOAT (DOUBLE) value, with -0.0 as 0.0 and one NaN for all,
+// so that rows equal as keys go to the same destination.
+template <typename T>
+static T canonical_float_bits(T bits) {
+    using F = std::conditional_t<sizeof(T) == sizeof(float), float, double>;
+    F value;
+    memcpy(&value, &bits, sizeof(T));
+    if (value == 0) {
+        return 0;
+    }
+    if (std::isnan(value)) {
+        value = std::numeric_limits<F>::quiet_NaN();
+        memcpy(&bits, &value, sizeof(T));
+    }
+    return bits;
+}
+
+template <typename T>
+static void hash_fixed(const Column* data, const NullData* nulls, size_t num_rows, bool is_float, uint64_t* hashes) {
+    const auto* values = reinterpret_cast<const T*>(data->raw_data());
+    for (size_t i = 0; i < num_rows; ++i) {
+        uint64_t value = 0;
+        if constexpr (sizeof(T) == sizeof(float) || sizeof(T) == sizeof(double)) {
+            T bits = is_float ? canonical_float_bits(values[i]) : values[i];
+            memcpy(&value, &bits, sizeof(T));
+        } else {
+            memcpy(&value, &values[i], sizeof(T));
+        }
+        value = nulls != nullptr && (*nulls)[i] ? kNullHash : value;
+        hashes[i] = HashUtil::combine(hashes[i], value);
+    }
+}
+
+ExchangeSinkOperator::ExchangeSinkOperator(ExchangeSinkOperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                           int32_t driver_sequence, int32_t sender_id)
+        : Operator(factory, id, "exchange_sink", plan_node_id, driver_sequence),
+          _sink_factory(factory),
+          _sender_id(sender_id) {}
+
+Status ExchangeSinkOperator::prepare(RuntimeState* state) {
+    size_t num_destinations = _sink_factory->destinations().size();
+    if (num_destinations == 0) {
+        return Status::InvalidArgument("exchange sink without destinations");
+    }
+    ASSIGN_OR_RETURN(const BlockCompressionCodec* codec,
+                     get_block_compression_codec(static_cast<CompressionType>(config::exchange_compression)));
+    _encoder = std::make_unique<ChunkPacketEncoder>(_sink_factory->desc(), codec);
+    size_t num_batches = _sink_factory->partition_type() == ExchangePartitionType::BROADCAST ? 1 : num_destinations;
+    for (size_t i = 0; i < num_batches; ++i) {
+        _batches.push_back(create_chunk_for_row_desc(_sink_factory->desc()));
+    }
+    _sequences.assign(num_destinations, 0);
+    const RowDescriptor& desc = _sink_factory->desc();
+    for (SlotId slot_id : _sink_factory->partition_slots()) {
+        auto it = std::find_if(desc.begin(), desc.end(),
+                               [slot_id](const SlotDescriptor& slot) { return slot.id == slot_id; });
+        if (it == desc.end()) {
+            return Status::InvalidArgument("exchange partition slot " + std::to_string(slot_id) + " is not sent");
+        }
+        _partition_columns.push_back(it - desc.begin());
+    }
+    return Status::OK();
+}
+
+bool ExchangeSinkOperator::need_input() const {
+    if (_is_finished) {
+        return false;
+    }
+    for (const auto& dest : _sink_factory->destinations()) {
+        if (!_sink_factory->transport()->can_send(dest)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ExchangeSinkOperator::is_finished() const {
+    if (_is_finished) {
+        return true;
+    }
+    for (const auto& dest : _sink_factory->destinations()) {
+        if (!_sink_factory->transport()->is_closed(dest)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status ExchangeSinkOperator::set_finishing(RuntimeState* state) {
+    if (_is_finished) {
+        return Status::OK();
+    }
+    _is_finished = true;
+    for (size_t i = 0; i < _batches.size(); ++i) {
+        RETURN_IF_ERROR(_flush(i));
+    }
+    const auto& destinations = _sink_factory->destinations();
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        auto packet = std::make_shared<ChunkPacket>();
+        packet->sender_id = _sender_id;
+        packet->sequence = _sequences[i]++;
+        packet->eos = true;
+        RETURN_IF_ERROR(_sink_factory->transport()->send(destinations[i], std::move(packet)));
+    }
+    return Status::OK();
+}
+
+Status ExchangeSinkOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    size_t num_rows = chunk->num_rows();
+    const RowDescriptor& desc = _sink_factory->desc();
+    Columns columns;
+    columns.reserve(desc.size());
+    for (const auto& slot : desc) {
+        columns.emplace_back(
+                ColumnHelper::unfold_const_column(slot.type, num_rows, chunk->get_column_by_slot_id(slot.id)));
+    }
+    if (_sink_factory->partition_type() == ExchangePartitionType::BROADCAST) {
+        return _append(0, columns, nullptr, 0, static_cast<uint32_t>(num_rows));
+    }
+
+    // Counting sort of the rows by destination.
+    _hash_rows(columns, num_rows);
+    size_t num_destinations = _batches.size();
+    uint64_t* dests = _hashes.data();
+    _counts.assign(num_destinations + 1, 0);
+    for (size_t i = 0; i < num_rows; ++i) {
+        dests[i] %= num_destinations;
+        _counts[dests[i] + 1]++;
+    }
+    for (size_t d = 0; d < num_destinations; ++d) {
+        _counts[d + 1] += _counts[d];
+    }
+    std::vector<uint32_t> cursors(_counts.begin(), _counts.end() - 1);
+    _indexes.resize_uninitialized(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        _indexes[cursors[dests[i]]++] = static_cast<uint32_t>(i);
+    }
+    for (size_t d = 0; d < num_destinations; ++d) {
+        if (_counts[d + 1] > _counts[d]) {
+            RETURN_IF_ERROR(_append(d, columns, _indexes.data(), _counts[d], _counts[d + 1] - _counts[d]));
+        }
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> ExchangeSinkOperator::pull_chunk(RuntimeState* state) {
+    return Status::InternalError("exchange sink does not produce output");
+}
+
+void ExchangeSinkOperator::_hash_rows(const Columns& columns, size_t num_rows) {
+    _hashes.assign(num_rows, HashUtil::kDefaultSeed);
+    uint64_t* hashes = _hashes.data();
+    for (size_t k : _partition_columns) {
+        const Column* column = columns[k].get();
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        const Column* data = ColumnHelper::get_data_column(column);
+        if (data->is_binary()) {
+            const auto* binary = static_cast<const BinaryColumn*>(data);
+            for (size_t i = 0; i < num_rows; ++i) {
+                Slice value = binary->get_slice(i);
+                uint64_t h = nulls != nullptr && (*nulls)[i] ? kNullHash : HashUtil::hash_bytes(value.data, value.size);
+                hashes[i] = HashUtil::combine(hashes[i], h);
+            }
+            continue;
+        }
+        bool is_float = is_float_type(_sink_factory->desc()[k].type);
+        switch (data->type_size()) {
+        case 1:
+            hash_fixed<uint8_t>(data, nulls, num_rows, false, hashes);
+            break;
+        case 2:
+            hash_fixed<uint16_t>(data, nulls, num_rows, false, hashes);
+            break;
+        case 4:
+            hash_fixed<uint32_t>(data, nulls, num_rows, is_float, hashes);
+            break;
+        default:
+            hash_fixed<uint64_t>(data, nulls, num_rows, is_float, hashes);
+            break;
+        }
+    }
+}
+
+Status ExchangeSinkOperator::_append(size_t idx, const Columns& columns, const uint32_t* indexes, uint32_t from,
+                                     uint32_t size) {
+    Chunk* batch = _batches[idx].get();
+    for (size_t k = 0; k < columns.size(); ++k) {
+        if (indexes == nullptr) {
+            batch->get_column_by_index(k)->append(*columns[k], from, size);
+        } else {
+            batch->get_column_by_index(k)->append_selective(*columns[k], indexes, from, size);
+        }
+    }
+    if (static_cast<int64_t>(spill::serialized_chunk_size(*batch, _sink_factory->desc())) >=
+        config::exchange_batch_bytes) {
+        return _flush(idx);
+    }
+    return Status::OK();
+}
+
+Status ExchangeSinkOperator::_flush(size_t idx) {
+    Chunk* batch = _batches[idx].get();
+    if (batch->is_empty()) {
+        return Status::OK();
+    }
+    auto packet = std::make_shared<ChunkPacket>();
+    packet->sender_id = _sender_id;
+    int64_t start = monotonic_nanos();
+    RETURN_IF_ERROR(_encoder->encode(*batch, packet.get()));
+    _encode_time_ns += monotonic_nanos() - start;
+    _num_packets_sent++;
+    _raw_bytes_sent += packet->raw_size;
+    _bytes_sent += packet->payload.size();
+    // Keeps the columns' capacity for the next batch.
+    batch->reset();
+    return _send(idx, std::move(packet));
+}
+
+Status ExchangeSinkOperator::_send(size_t idx, std::shared_ptr<ChunkPacket> packet) {
+    const auto& destinations = _sink_factory->destinations();
+    if (_sink_factory->partition_type() == ExchangePartitionType::HASH) {
+        packet->sequence = _sequences[idx]++;
+        return _sink_factory->transport()->send(destinations[idx], std::move(packet));
+    }
+    // Every destination has been sent the same packets, so their sequence
+    // numbers agree.
+    packet->sequence = _sequences[0];
+    ChunkPacketPtr shared = std::move(packet);
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        _sequences[i]++;
+        RETURN_IF_ERROR(_sink_factory->transport()->send(destinations[i], shared));
+    }
+    return Status::OK();
+}
+
+OperatorPtr ExchangeSinkOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<ExchangeSinkOperator>(this, _id, _plan_node_id, driver_sequence,
+                                                  _sender_id_base + driver_sequence);
+}
+
+} // namespace starrocks::pipeline
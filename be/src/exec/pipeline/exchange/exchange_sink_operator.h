@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include "exec/pipeline/exchange/exchange_transport.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+enum class ExchangePartitionType {
+    // Every destination gets every row.
+    BROADCAST,
+    // Each row goes to one destination, chosen by the hash of its partition
+    // slots, so equal keys meet in the same fragment instance.
+    HASH,
+};
+
+class ExchangeSinkOperatorFactory;
+
+// Sends the chunks of one driver to the exchange sources of other fragment
+// instances. Rows are batched per destination until config::
+// exchange_batch_bytes worth of them are serialized into one packet; a
+// broadcast encodes each batch once and sends the same packet everywhere.
+//
+// The sink takes no input while a destination is full (see
+// ExchangeReceiver), which parks its driver with OUTPUT_FULL, and finishes
+// early once every destination is closed.
+class ExchangeSinkOperator final : public Operator {
+public:
+    ExchangeSinkOperator(ExchangeSinkOperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                         int32_t driver_sequence, int32_t sender_id);
+
+    Status prepare(RuntimeState* state) override;
+
+    bool has_output() const override { return false; }
+    bool need_input() const override;
+    bool is_finished() const override;
+
+    // Sends the partial batches and then eos to every destination.
+    Status set_finishing(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    int64_t num_packets_sent() const { return _num_packets_sent; }
+    // Serialized bytes before and after compression.
+    int64_t raw_bytes_sent() const { return _raw_bytes_sent; }
+    int64_t bytes_sent() const { return _bytes_sent; }
+    int64_t encode_time_ns() const { return _encode_time_ns; }
+
+private:
+    // Appends rows |indexes[from, from + size)| of |columns|, or all of them
+    // when |indexes| is nullptr, to batch |idx|, and ships the batch once it
+    // is big enough.
+    Status _append(size_t idx, const Columns& columns, const uint32_t* indexes, uint32_t from, uint32_t size);
+    // Encodes batch |idx| and sends it to its destinations.
+    Status _flush(size_t idx);
+    Status _send(size_t idx, std::shared_ptr<ChunkPacket> packet);
+    void _hash_rows(const Columns& columns, size_t num_rows);
+
+    ExchangeSinkOperatorFactory* const _sink_factory;
+    const int32_t _sender_id;
+    std::unique_ptr<ChunkPacketEncoder> _encoder;
+    // One batch per destination; a single one for a broadcast.
+    std::vector<ChunkPtr> _batches;
+    std::vector<int64_t> _sequences;
+    // Positions of the partition slots in the row descriptor.
+    std::vector<size_t> _partition_columns;
+    bool _is_finished = false;
+
+    Buffer<uint64_t> _hashes;
+    Buffer<uint32_t> _indexes;
+    std::vector<uint32_t> _counts;
+
+    int64_t _num_packets_sent = 0;
+    int64_t _raw_bytes_sent = 0;
+    int64_t _bytes_sent = 0;
+    int64_t _encode_time_ns = 0;
+};
+
+class ExchangeSinkOperatorFactory final : public OperatorFactory {
+public:
+    // The drivers of this sink are senders |sender_id_base| to |sender_id_base|
+    // + degree_of_parallelism - 1; the planner numbers the senders of all
+    // instances feeding an exchange consecutively from 0. |partition_slots|
+    // are only used by HASH.
+    ExchangeSinkOperatorFactory(int32_t id, int32_t plan_node_id, ExchangeTransport* transport, RowDescriptor desc,
+                                ExchangePartitionType partition_type, std::vector<SlotId> partition_slots,
+                                std::vector<ExchangeDestination> destinations, int32_t sender_id_base)
+            : OperatorFactory(id, "exchange_sink", plan_node_id),
+              _transport(transport),
+              _desc(std::move(desc)),
+              _partition_type(partition_type),
+              _partition_slots(std::move(partition_slots)),
+              _destinations(std::move(destinations)),
+              _sender_id_base(sender_id_base) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+    ExchangeTransport* transport() const { return _transport; }
+    const RowDescriptor& desc() const { return _desc; }
+    ExchangePartitionType partition_type() const { return _partition_type; }
+    const std::vector<SlotId>& partition_slots() const { return _partition_slots; }
+    const std::vector<ExchangeDestination>& destinations() const { return _destinations; }
+
+private:
+    ExchangeTransport* const _transport;
+    const RowDescriptor _desc;
+    const ExchangePartitionType _partition_type;
+    const std::vector<SlotId> _partition_slots;
+    const std::vector<ExchangeDestination> _destinations;
+    const int32_t _sender_id_base;
+};
+
+} // namespace starrocks::pipeline
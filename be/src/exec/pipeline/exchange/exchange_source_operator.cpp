@@ -0,0 +1,55 @@
+#include "exec/pipeline/exchange/exchange_source_operator.h"
+
+#include "exec/pipeline/fragment_context.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::pipeline {
+
+bool ExchangeSourceOperator::has_output() const {
+    return !_is_finished && _receiver->has_output();
+}
+
+bool ExchangeSourceOperator::is_finished() const {
+    return _is_finished || _receiver->is_finished();
+}
+
+Status ExchangeSourceOperator::set_finished(RuntimeState* state) {
+    if (!_is_finished) {
+        _is_finished = true;
+        _receiver->finish_source();
+        // Senders blocked on a full receiver see it closed.
+        state->fragment_ctx()->notify_event();
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> ExchangeSourceOperator::pull_chunk(RuntimeState* state) {
+    ChunkPacketPtr packet = _receiver->pull();
+    if (packet == nullptr) {
+        return nullptr;
+    }
+    int64_t start = monotonic_nanos();
+    ASSIGN_OR_RETURN(ChunkPtr chunk, decode_chunk_packet(*packet, _desc, &_scratch));
+    _decode_time_ns += monotonic_nanos() - start;
+    return chunk;
+}
+
+Status ExchangeSourceOperatorFactory::prepare(RuntimeState* state) {
+    _receiver = std::make_shared<ExchangeReceiver>(state->fragment_ctx(), _num_senders);
+    _receiver->set_num_sources(degree_of_parallelism());
+    _dest = ExchangeDestination{state->fragment_ctx()->fragment_instance_id(), _plan_node_id};
+    _transport->register_receiver(_dest, _receiver);
+    return Status::OK();
+}
+
+void ExchangeSourceOperatorFactory::close(RuntimeState* state) {
+    if (_receiver != nullptr) {
+        _transport->unregister_receiver(_dest, _receiver.get());
+    }
+}
+
+OperatorPtr ExchangeSourceOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<ExchangeSourceOperator>(this, _id, _plan_node_id, driver_sequence, _desc, _receiver);
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "exec/pipeline/exchange/exchange_transport.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Emits the chunks exchange sinks of other fragment instances sent to this
+// plan node, decoding each packet in the driver that takes it.
+class ExchangeSourceOperator final : public SourceOperator {
+public:
+    ExchangeSourceOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                           const RowDescriptor& desc, ExchangeReceiverPtr receiver)
+            : SourceOperator(factory, id, "exchange_source", plan_node_id, driver_sequence),
+              _desc(desc),
+              _receiver(std::move(receiver)) {}
+
+    bool has_output() const override;
+    bool is_finished() const override;
+
+    Status set_finished(RuntimeState* state) override;
+
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    int64_t decode_time_ns() const { return _decode_time_ns; }
+
+private:
+    const RowDescriptor& _desc;
+    ExchangeReceiverPtr _receiver;
+    Buffer<uint8_t> _scratch;
+    bool _is_finished = false;
+    int64_t _decode_time_ns = 0;
+};
+
+class ExchangeSourceOperatorFactory final : public SourceOperatorFactory {
+public:
+    // |num_senders| counts the sink drivers of all instances sending here.
+    ExchangeSourceOperatorFactory(int32_t id, int32_t plan_node_id, ExchangeTransport* transport, RowDescriptor desc,
+                                  int32_t num_senders)
+            : SourceOperatorFactory(id, "exchange_source", plan_node_id),
+              _transport(transport),
+              _desc(std::move(desc)),
+              _num_senders(num_senders) {}
+
+    // Registers the receiver with the transport.
+    Status prepare(RuntimeState* state) override;
+    void close(RuntimeState* state) override;
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+    const ExchangeReceiverPtr& receiver() const { return _receiver; }
+
+private:
+    ExchangeTransport* const _transport;
+    const RowDescriptor _desc;
+    const int32_t _num_senders;
+    ExchangeDestination _dest;
+    ExchangeReceiverPtr _receiver;
+};
+
+} // namespace starrocks::pipeline
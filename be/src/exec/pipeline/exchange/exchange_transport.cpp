@@ -0,0 +1,44 @@
+#include "exec/pipeline/exchange/exchange_transport.h"
+
+namespace starrocks::pipeline {
+
+void LoopbackTransport::register_receiver(const ExchangeDestination& dest, ExchangeReceiverPtr receiver) {
+    std::lock_guard<std::mutex> l(_lock);
+    _receivers[Key(dest.fragment_instance_id, dest.node_id)] = std::move(receiver);
+}
+
+void LoopbackTransport::unregister_receiver(const ExchangeDestination& dest, const ExchangeReceiver* receiver) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _receivers.find(Key(dest.fragment_instance_id, dest.node_id));
+    if (it != _receivers.end() && it->second.get() == receiver) {
+        _receivers.erase(it);
+    }
+}
+
+ExchangeReceiverPtr LoopbackTransport::_find(const ExchangeDestination& dest) const {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _receivers.find(Key(dest.fragment_instance_id, dest.node_id));
+    return it == _receivers.end() ? nullptr : it->second;
+}
+
+Status LoopbackTransport::send(const ExchangeDestination& dest, ChunkPacketPtr packet) {
+    ExchangeReceiverPtr receiver = _find(dest);
+    if (receiver == nullptr) {
+        _num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return Status::OK();
+    }
+    _bytes_sent.fetch_add(packet->payload.size(), std::memory_order_relaxed);
+    return receiver->add_packet(std::move(packet));
+}
+
+bool LoopbackTransport::can_send(const ExchangeDestination& dest) const {
+    ExchangeReceiverPtr receiver = _find(dest);
+    return receiver == nullptr || !receiver->is_full();
+}
+
+bool LoopbackTransport::is_closed(const ExchangeDestination& dest) const {
+    ExchangeReceiverPtr receiver = _find(dest);
+    return receiver != nullptr && receiver->is_closed();
+}
+
+} // namespace starrocks::pipeline
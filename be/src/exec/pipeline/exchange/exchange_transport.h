@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "exec/pipeline/exchange/exchange_receiver.h"
+
+namespace starrocks::pipeline {
+
+// Exchange node |node_id| of fragment instance |fragment_instance_id|.
+struct ExchangeDestination {
+    std::string fragment_instance_id;
+    int32_t node_id;
+};
+
+// Carries packets from exchange sinks to the receivers of other fragment
+// instances. A receiver registers when its fragment is prepared, which the
+// scheduler does before starting the fragments sending to it, and
+// unregisters when the fragment closes.
+class ExchangeTransport {
+public:
+    virtual ~ExchangeTransport() = default;
+
+    virtual void register_receiver(const ExchangeDestination& dest, ExchangeReceiverPtr receiver) = 0;
+    // No-op if another receiver has been registered under |dest| since.
+    virtual void unregister_receiver(const ExchangeDestination& dest, const ExchangeReceiver* receiver) = 0;
+
+    // Packets for receivers that are not registered are dropped.
+    virtual Status send(const ExchangeDestination& dest, ChunkPacketPtr packet) = 0;
+    // False while |dest| should get no more packets for now.
+    virtual bool can_send(const ExchangeDestination& dest) const = 0;
+    // |dest| wants no more packets at all.
+    virtual bool is_closed(const ExchangeDestination& dest) const = 0;
+};
+
+// Delivers within the process, which is all a single BE needs: packets are
+// handed to the receiver by pointer, so an exchange costs its encoding and
+// decoding and no copies in between.
+class LoopbackTransport final : public ExchangeTransport {
+public:
+    void register_receiver(const ExchangeDestination& dest, ExchangeReceiverPtr receiver) override;
+    void unregister_receiver(const ExchangeDestination& dest, const ExchangeReceiver* receiver) override;
+
+    Status send(const ExchangeDestination& dest, ChunkPacketPtr packet) override;
+    bool can_send(const ExchangeDestination& dest) const override;
+    bool is_closed(const ExchangeDestination& dest) const override;
+
+    int64_t num_dropped() const { return _num_dropped.load(std::memory_order_relaxed); }
+    int64_t bytes_sent() const { return _bytes_sent.load(std::memory_order_relaxed); }
+
+private:
+    using Key = std::pair<std::string, int32_t>;
+
+    ExchangeReceiverPtr _find(const ExchangeDestination& dest) const;
+
+    mutable std::mutex _lock;
+    std::map<Key, ExchangeReceiverPtr> _receivers;
+
+    std::atomic<int64_t> _num_dropped{0};
+    std::atomic<int64_t> _bytes_sent{0};
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,151 @@
+#include "exec/pipeline/exchange/local_exchange.h"
+
+#include <algorithm>
+
+#include "exec/pipeline/fragment_context.h"
+
+namespace starrocks::pipeline {
+
+LocalExchanger::LocalExchanger(int32_t num_sinks, size_t max_buffered_chunks)
+        : _max_buffered_chunks(std::max<size_t>(max_buffered_chunks, 1)), _num_running_sinks(num_sinks) {}
+
+bool LocalExchanger::is_full() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _chunks.size() >= _max_buffered_chunks;
+}
+
+bool LocalExchanger::push(ChunkPtr chunk) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_num_running_sources == 0) {
+        return false;
+    }
+    _chunks.emplace_back(std::move(chunk));
+    return _chunks.size() == 1;
+}
+
+bool LocalExchanger::pull(ChunkPtr* chunk) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_chunks.empty()) {
+        *chunk = nullptr;
+        return false;
+    }
+    bool was_full = _chunks.size() >= _max_buffered_chunks;
+    *chunk = std::move(_chunks.front());
+    _chunks.pop_front();
+    return was_full;
+}
+
+bool LocalExchanger::has_output() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return !_chunks.empty();
+}
+
+void LocalExchanger::finish_sink() {
+    std::lock_guard<std::mutex> l(_lock);
+    _num_running_sinks--;
+}
+
+void LocalExchanger::finish_source() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (--_num_running_sources == 0) {
+        _chunks.clear();
+    }
+}
+
+bool LocalExchanger::is_source_finished() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_running_sinks == 0 && _chunks.empty();
+}
+
+bool LocalExchanger::is_sink_finished() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_running_sources == 0;
+}
+
+size_t LocalExchanger::num_buffered_chunks() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _chunks.size();
+}
+
+void LocalExchanger::set_num_sources(int32_t num_sources) {
+    std::lock_guard<std::mutex> l(_lock);
+    _num_running_sources = num_sources;
+}
+
+LocalExchangeSinkOperator::LocalExchangeSinkOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                                     int32_t driver_sequence, LocalExchangerPtr exchanger)
+        : Operator(factory, id, "local_exchange_sink", plan_node_id, driver_sequence),
+          _exchanger(std::move(exchanger)) {}
+
+bool LocalExchangeSinkOperator::need_input() const {
+    return !_is_finished && !_exchanger->is_full();
+}
+
+bool LocalExchangeSinkOperator::is_finished() const {
+    return _is_finished || _exchanger->is_sink_finished();
+}
+
+Status LocalExchangeSinkOperator::set_finishing(RuntimeState* state) {
+    if (!_is_finished) {
+        _is_finished = true;
+        _exchanger->finish_sink();
+        state->fragment_ctx()->notify_event();
+    }
+    return Status::OK();
+}
+
+Status LocalExchangeSinkOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    if (_exchanger->push(chunk)) {
+        state->fragment_ctx()->notify_event();
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> LocalExchangeSinkOperator::pull_chunk(RuntimeState* state) {
+    return Status::InternalError("local exchange sink does not produce output");
+}
+
+OperatorPtr LocalExchangeSinkOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<LocalExchangeSinkOperator>(this, _id, _plan_node_id, driver_sequence, _exchanger);
+}
+
+LocalExchangeSourceOperator::LocalExchangeSourceOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                                         int32_t driver_sequence, LocalExchangerPtr exchanger)
+        : SourceOperator(factory, id, "local_exchange_source", plan_node_id, driver_sequence),
+          _exchanger(std::move(exchanger)) {}
+
+bool LocalExchangeSourceOperator::has_output() const {
+    return !_is_finished && _exchanger->has_output();
+}
+
+bool LocalExchangeSourceOperator::is_finished() const {
+    return _is_finished || _exchanger->is_source_finished();
+}
+
+Status LocalExchangeSourceOperator::set_finished(RuntimeState* state) {
+    if (!_is_finished) {
+        _is_finished = true;
+        _exchanger->finish_source();
+        state->fragment_ctx()->notify_event();
+    }
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> LocalExchangeSourceOperator::pull_chunk(RuntimeState* state) {
+    ChunkPtr chunk;
+    if (_exchanger->pull(&chunk)) {
+        state->fragment_ctx()->notify_event();
+    }
+    return chunk;
+}
+
+Status LocalExchangeSourceOperatorFactory::prepare(RuntimeState* state) {
+    _exchanger->set_num_sources(degree_of_parallelism());
+    return Status::OK();
+}
+
+OperatorPtr LocalExchangeSourceOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<LocalExchangeSourceOperator>(this, _id, _plan_node_id, driver_sequence, _exchanger);
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include "common/compiler_util.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// In-process chunk queue connecting the sink drivers of one pipeline to the
+// source drivers of the next. It lets the two sides run at different degrees
+// of parallelism: any source driver may pop a chunk pushed by any sink.
+//
+// The queue is bounded; a full queue makes the sinks report need_input() ==
+// false so their drivers park with OUTPUT_FULL instead of growing memory.
+class LocalExchanger {
+public:
+    LocalExchanger(int32_t num_sinks, size_t max_buffered_chunks);
+
+    DISALLOW_COPY_AND_MOVE(LocalExchanger);
+
+    bool is_full() const;
+    // Both return true when the call may unblock the other side (the queue
+    // became non-empty / stopped being full), i.e. the poller should be woken.
+    bool push(ChunkPtr chunk);
+    bool pull(ChunkPtr* chunk);
+    bool has_output() const;
+
+    // One sink is done; after the last one, sources drain and finish.
+    void finish_sink();
+    // One source is done; once all are (e.g. a downstream LIMIT was
+    // reached), sinks stop early.
+    void finish_source();
+
+    bool is_source_finished() const;
+    bool is_sink_finished() const;
+
+    size_t num_buffered_chunks() const;
+
+    // Called once the source pipeline's degree of parallelism is known.
+    void set_num_sources(int32_t num_sources);
+
+private:
+    const size_t _max_buffered_chunks;
+    mutable std::mutex _lock;
+    std::deque<ChunkPtr> _chunks;
+    int32_t _num_running_sinks;
+    int32_t _num_running_sources = 0;
+};
+
+using LocalExchangerPtr = std::shared_ptr<LocalExchanger>;
+
+class LocalExchangeSinkOperator final : public Operator {
+public:
+    LocalExchangeSinkOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                              LocalExchangerPtr exchanger);
+
+    bool has_output() const override { return false; }
+    bool need_input() const override;
+    bool is_finished() const override;
+
+    Status set_finishing(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+private:
+    LocalExchangerPtr _exchanger;
+    bool _is_finished = false;
+};
+
+class LocalExchangeSinkOperatorFactory final : public OperatorFactory {
+public:
+    LocalExchangeSinkOperatorFactory(int32_t id, int32_t plan_node_id, LocalExchangerPtr exchanger)
+            : OperatorFactory(id, "local_exchange_sink", plan_node_id), _exchanger(std::move(exchanger)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    LocalExchangerPtr _exchanger;
+};
+
+class LocalExchangeSourceOperator final : public SourceOperator {
+public:
+    LocalExchangeSourceOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                                LocalExchangerPtr exchanger);
+
+    bool has_output() const override;
+    bool is_finished() const override;
+
+    Status set_finished(RuntimeState* state) override;
+
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+private:
+    LocalExchangerPtr _exchanger;
+    bool _is_finished = false;
+};
+
+class LocalExchangeSourceOperatorFactory final : public SourceOperatorFactory {
+public:
+    LocalExchangeSourceOperatorFactory(int32_t id, int32_t plan_node_id, LocalExchangerPtr exchanger)
+            : SourceOperatorFactory(id, "local_exchange_source", plan_node_id), _exchanger(std::move(exchanger)) {}
+
+    Status prepare(RuntimeState* state) override;
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    LocalExchangerPtr _exchanger;
+};
+
+} // namespace starrocks::pipeline
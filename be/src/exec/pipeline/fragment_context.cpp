@@ -0,0 +1,112 @@
+#include "exec/pipeline/fragment_context.h"
+
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "exec/runtime_filter_worker.h"
+#include "runtime/exec_env.h"
+
+namespace starrocks::pipeline {
+
+FragmentContext::FragmentContext(QueryContextPtr query_ctx, std::string fragment_instance_id)
+        : _query_ctx(std::move(query_ctx)), _fragment_instance_id(std::move(fragment_instance_id)) {
+    _mem_tracker = std::make_unique<MemTracker>(MemTracker::Type::FRAGMENT, -1, _fragment_instance_id,
+                                                _query_ctx->mem_tracker());
+    _runtime_state = std::make_unique<RuntimeState>(_query_ctx.get(), this, _mem_tracker.get());
+    _runtime_filter_hub = std::make_shared<RuntimeFilterHub>(this);
+}
+
+FragmentContext::~FragmentContext() {
+    // Deliveries in flight may still hold the hub.
+    _runtime_filter_hub->close();
+    RuntimeFilterWorker* worker = ExecEnv::GetInstance()->runtime_filter_worker();
+    if (_runtime_filters_registered && worker != nullptr) {
+        worker->unregister_fragment(_fragment_instance_id, _runtime_filter_hub.get());
+    }
+    // Drivers must not outlive the pipelines whose factories they reference.
+    _drivers.clear();
+}
+
+Status FragmentContext::prepare() {
+    if (_prepared) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_query_ctx->admit());
+    if (RuntimeFilterWorker* worker = ExecEnv::GetInstance()->runtime_filter_worker(); worker != nullptr) {
+        worker->register_fragment(_fragment_instance_id, _runtime_filter_hub);
+        _runtime_filters_registered = true;
+    }
+    RuntimeState* state = _runtime_state.get();
+    int32_t driver_id = 0;
+    for (auto& pipeline : _pipelines) {
+        for (auto& factory : pipeline->op_factories()) {
+            _operator_mem_trackers.emplace_back(std::make_unique<MemTracker>(
+                    MemTracker::Type::OPERATOR, -1, factory->name() + " (id=" + std::to_string(factory->id()) + ")",
+                    _mem_tracker.get()));
+            factory->set_mem_tracker(_operator_mem_trackers.back().get());
+        }
+        RETURN_IF_ERROR(pipeline->prepare(state));
+        int32_t dop = pipeline->degree_of_parallelism();
+        for (int32_t i = 0; i < dop; ++i) {
+            auto driver = std::make_shared<PipelineDriver>(pipeline->create_operators(dop, i), this, driver_id++);
+            RETURN_IF_ERROR(driver->prepare(state));
+            _drivers.emplace_back(std::move(driver));
+        }
+    }
+    _prepared = true;
+    return Status::OK();
+}
+
+void FragmentContext::submit(PipelineDriverExecutor* executor) {
+    _executor = executor;
+    _num_running_drivers.store(_drivers.size(), std::memory_order_release);
+    _submitted = true;
+    if (_drivers.empty()) {
+        std::lock_guard<std::mutex> l(_lock);
+        _done = true;
+        _done_cv.notify_all();
+        return;
+    }
+    for (auto& driver : _drivers) {
+        executor->submit(driver.get());
+    }
+}
+
+Status FragmentContext::run(PipelineDriverExecutor* executor) {
+    Status st = prepare();
+    if (!st.ok()) {
+        cancel(st);
+        return st;
+    }
+    submit(executor);
+    return wait();
+}
+
+Status FragmentContext::wait() {
+    std::unique_lock<std::mutex> l(_lock);
+    _done_cv.wait(l, [this] { return _done; });
+    return _query_ctx->is_cancelled() ? _query_ctx->cancel_status() : Status::OK();
+}
+
+void FragmentContext::cancel(const Status& status) {
+    _query_ctx->cancel(status);
+    notify_event();
+}
+
+void FragmentContext::notify_event() {
+    if (_executor != nullptr) {
+        _executor->wake_poller();
+    }
+}
+
+void FragmentContext::count_down_driver(PipelineDriver* driver) {
+    if (_num_running_drivers.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    for (auto& pipeline : _pipelines) {
+        pipeline->close(_runtime_state.get());
+    }
+    std::lock_guard<std::mutex> l(_lock);
+    _done = true;
+    _done_cv.notify_all();
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "exec/pipeline/pipeline.h"
+#include "exec/pipeline/pipeline_driver.h"
+#include "exec/pipeline/runtime_filter_hub.h"
+#include "runtime/query_context.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks::pipeline {
+
+class PipelineDriverExecutor;
+
+// One fragment instance of a query: its pipelines, the drivers instantiated
+// from them, and the bookkeeping to know when all of them are done.
+//
+// A fragment is split into pipelines at pipeline breakers (hash join build,
+// aggregation, local exchange); each pipeline runs as
+// degree_of_parallelism() drivers that the executor schedules independently.
+class FragmentContext {
+public:
+    FragmentContext(QueryContextPtr query_ctx, std::string fragment_instance_id);
+    ~FragmentContext();
+
+    const std::string& fragment_instance_id() const { return _fragment_instance_id; }
+    QueryContext* query_ctx() const { return _query_ctx.get(); }
+    MemTracker* mem_tracker() const { return _mem_tracker.get(); }
+    RuntimeState* runtime_state() const { return _runtime_state.get(); }
+    PipelineDriverExecutor* executor() const { return _executor; }
+    // Runtime filters for the fragment's scans; from prepare() on, other
+    // fragment instances reach it through the RuntimeFilterWorker.
+    RuntimeFilterHub* runtime_filter_hub() const { return _runtime_filter_hub.get(); }
+
+    void add_pipeline(PipelinePtr pipeline) { _pipelines.emplace_back(std::move(pipeline)); }
+    const Pipelines& pipelines() const { return _pipelines; }
+    const Drivers& drivers() const { return _drivers; }
+
+    // Admits the query, registers for runtime filters, prepares the operator
+    // factories and instantiates the drivers.
+    Status prepare();
+
+    // Hands every driver to |executor|.
+    void submit(PipelineDriverExecutor* executor);
+
+    // Convenience: prepare(), submit() and wait().
+    Status run(PipelineDriverExecutor* executor);
+
+    // Blocks until all drivers have been finalized; returns the fragment's
+    // final status.
+    Status wait();
+    bool is_done() const { return _num_running_drivers.load(std::memory_order_acquire) == 0 && _submitted; }
+
+    void cancel(const Status& status);
+
+    // Wakes the poller so parked drivers re-check their blocking condition.
+    void notify_event();
+
+    // Called by a driver once it reached a terminal state and was closed.
+    void count_down_driver(PipelineDriver* driver);
+
+private:
+    QueryContextPtr _query_ctx;
+    const std::string _fragment_instance_id;
+    std::unique_ptr<MemTracker> _mem_tracker;
+    // One per operator factory; factories and operators keep raw pointers.
+    std::vector<std::unique_ptr<MemTracker>> _operator_mem_trackers;
+    std::unique_ptr<RuntimeState> _runtime_state;
+    PipelineDriverExecutor* _executor = nullptr;
+    RuntimeFilterHubPtr _runtime_filter_hub;
+    bool _runtime_filters_registered = false;
+
+    Pipelines _pipelines;
+    Drivers _drivers;
+    bool _prepared = false;
+    bool _submitted = false;
+
+    std::atomic<size_t> _num_running_drivers{0};
+    std::mutex _lock;
+    std::condition_variable _done_cv;
+    bool _done = false;
+};
+
+using FragmentContextPtr = std::shared_ptr<FragmentContext>;
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,30 @@
+#include "exec/pipeline/hashjoin/hash_join_build_operator.h"
+
+namespace starrocks::pipeline {
+
+Status HashJoinBuildOperator::set_finishing(RuntimeState* state) {
+    if (_is_finished) {
+        return Status::OK();
+    }
+    _is_finished = true;
+    if (state->is_cancelled()) {
+        return Status::OK();
+    }
+    return _joiner->finish_build(state);
+}
+
+Status HashJoinBuildOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    return _joiner->append_build_chunk(state, chunk);
+}
+
+Status HashJoinBuildOperatorFactory::prepare(RuntimeState* state) {
+    _joiner->set_mem_tracker(mem_tracker());
+    return _joiner->prepare();
+}
+
+OperatorPtr HashJoinBuildOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    _joiner->set_num_builders(degree_of_parallelism);
+    return std::make_shared<HashJoinBuildOperator>(this, _id, _plan_node_id, driver_sequence, _joiner);
+}
+
+} // namespace starrocks::pipeline
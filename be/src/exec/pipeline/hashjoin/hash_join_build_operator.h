@@ -0,0 +1,45 @@
+#pragma once
+
+#include "exec/hash_joiner.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Sink of a join's build pipeline: hands every chunk to the shared
+// HashJoiner, and builds the hash table when the last build driver finishes.
+class HashJoinBuildOperator final : public Operator {
+public:
+    HashJoinBuildOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                          HashJoinerPtr joiner)
+            : Operator(factory, id, "hash_join_build", plan_node_id, driver_sequence), _joiner(std::move(joiner)) {}
+
+    bool has_output() const override { return false; }
+    bool need_input() const override { return !_is_finished && !_joiner->is_spill_backlogged(); }
+    bool is_finished() const override { return _is_finished; }
+    bool pending_finish() const override { return _joiner->has_pending_spill_writes(); }
+
+    Status set_finishing(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override {
+        return Status::InternalError("hash join build does not produce output");
+    }
+
+private:
+    HashJoinerPtr _joiner;
+    bool _is_finished = false;
+};
+
+class HashJoinBuildOperatorFactory final : public OperatorFactory {
+public:
+    HashJoinBuildOperatorFactory(int32_t id, int32_t plan_node_id, HashJoinerPtr joiner)
+            : OperatorFactory(id, "hash_join_build", plan_node_id), _joiner(std::move(joiner)) {}
+
+    Status prepare(RuntimeState* state) override;
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    HashJoinerPtr _joiner;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,203 @@
+#include "exec/pipeline/hashjoin/hash_join_probe_operator.h"
+
+namespace starrocks::pipeline {
+
+HashJoinProbeOperator::HashJoinProbeOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id,
+                                             int32_t driver_sequence, HashJoinerPtr joiner)
+        : Operator(factory, id, "hash_join_probe", plan_node_id, driver_sequence), _joiner(std::move(joiner)) {}
+
+bool HashJoinProbeOperator::has_output() const {
+    if (_is_finished || !_joiner->is_build_done()) {
+        return false;
+    }
+    if (_has_remaining()) {
+        return true;
+    }
+    if (_joiner->is_spilled()) {
+        return _is_finishing && !_partitions_done && (!_probe_spill_finished || _joiner->is_probe_spill_done());
+    }
+    return _is_full_join() && _is_finishing && (!_probe_done_handled || _emit_unmatched);
+}
+
+bool HashJoinProbeOperator::need_input() const {
+    if (!_joiner->is_build_done() || _is_finishing || _has_remaining() || is_finished()) {
+        return false;
+    }
+    return !_joiner->is_spill_backlogged();
+}
+
+bool HashJoinProbeOperator::is_finished() const {
+    if (_is_finished || _joiner->is_probe_short_circuited()) {
+        return true;
+    }
+    if (!_is_finishing || !_joiner->is_build_done() || _has_remaining()) {
+        return false;
+    }
+    if (_joiner->is_spilled()) {
+        return _partitions_done;
+    }
+    return !_is_full_join() || (_probe_done_handled && !_emit_unmatched);
+}
+
+Status HashJoinProbeOperator::set_finishing(RuntimeState* state) {
+    _is_finishing = true;
+    return Status::OK();
+}
+
+Status HashJoinProbeOperator::set_finished(RuntimeState* state) {
+    _is_finished = true;
+    if (!_joiner->is_build_done()) {
+        return Status::OK();
+    }
+    // Keep the prober counts right even when this driver's output is no
+    // longer wanted.
+    if (_joiner->is_spilled()) {
+        if (!_probe_spill_finished) {
+            _probe_spill_finished = true;
+            return _joiner->finish_probe_spill(state);
+        }
+    } else if (_is_full_join() && !_probe_done_handled) {
+        _probe_done_handled = true;
+        (void)_joiner->finish_probe(_prober == nullptr ? Filter() : _prober->build_matched());
+    }
+    return Status::OK();
+}
+
+void HashJoinProbeOperator::close(RuntimeState* state) {
+    _close_partition(state);
+}
+
+Status HashJoinProbeOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    if (_joiner->is_spilled()) {
+        return _joiner->spill_probe_chunk(chunk);
+    }
+    if (_prober == nullptr) {
+        _prober = std::make_unique<JoinProber>(&_joiner->table());
+    }
+    return _prober->push_probe_chunk(chunk);
+}
+
+void HashJoinProbeOperator::_on_probe_done() {
+    _probe_done_handled = true;
+    _emit_unmatched = _joiner->finish_probe(_prober == nullptr ? Filter() : _prober->build_matched());
+}
+
+StatusOr<ChunkPtr> HashJoinProbeOperator::pull_chunk(RuntimeState* state) {
+    if (_has_remaining()) {
+        return _prober->next_output(state->chunk_size());
+    }
+    if (_joiner->is_spilled()) {
+        return _pull_spilled(state);
+    }
+    if (!_is_full_join() || !_is_finishing) {
+        return nullptr;
+    }
+    if (!_probe_done_handled) {
+        _on_probe_done();
+    }
+    if (!_emit_unmatched) {
+        return nullptr;
+    }
+    ChunkPtr chunk = _joiner->table().next_unmatched_build_chunk(_joiner->build_matched(), &_unmatched_cursor,
+                                                                 state->chunk_size());
+    if (chunk == nullptr) {
+        _emit_unmatched = false;
+    }
+    return chunk;
+}
+
+StatusOr<ChunkPtr> HashJoinProbeOperator::_pull_spilled(RuntimeState* state) {
+    if (!_is_finishing) {
+        return nullptr;
+    }
+    if (!_probe_spill_finished) {
+        _probe_spill_finished = true;
+        RETURN_IF_ERROR(_joiner->finish_probe_spill(state));
+        return nullptr;
+    }
+    if (!_joiner->is_probe_spill_done()) {
+        return nullptr;
+    }
+    // Runs until there is output: restoring a partition's build side is
+    // bounded by the memory budget divided by the number of partitions.
+    while (!state->is_cancelled()) {
+        if (_partition < 0) {
+            _partition = _joiner->claim_spilled_partition();
+            if (_partition < 0) {
+                _partitions_done = true;
+                return nullptr;
+            }
+            RETURN_IF_ERROR(_open_partition(state));
+        }
+
+        if (_probe_reader != nullptr) {
+            ChunkPtr chunk;
+            Status st = _probe_reader->get_next(&chunk);
+            if (st.is_end_of_file()) {
+                _probe_reader.reset();
+                _emit_unmatched = _is_full_join();
+                _unmatched_cursor = 0;
+                continue;
+            }
+            RETURN_IF_ERROR(st);
+            RETURN_IF_ERROR(_prober->push_probe_chunk(chunk));
+            if (_prober->has_remaining()) {
+                return _prober->next_output(state->chunk_size());
+            }
+            continue;
+        }
+
+        if (_emit_unmatched) {
+            ChunkPtr chunk = _partition_table->next_unmatched_build_chunk(_prober->build_matched(),
+                                                                          &_unmatched_cursor, state->chunk_size());
+            if (chunk != nullptr) {
+                return chunk;
+            }
+            _emit_unmatched = false;
+        }
+        _close_partition(state);
+    }
+    return nullptr;
+}
+
+Status HashJoinProbeOperator::_open_partition(RuntimeState* state) {
+    _partition_table = std::make_unique<JoinHashTable>(_joiner->table().param());
+    RETURN_IF_ERROR(_partition_table->prepare());
+    ASSIGN_OR_RETURN(auto build_reader, _joiner->open_spilled_build(_partition));
+    for (;;) {
+        ChunkPtr chunk;
+        Status st = build_reader->get_next(&chunk);
+        if (st.is_end_of_file()) {
+            break;
+        }
+        RETURN_IF_ERROR(st);
+        RETURN_IF_ERROR(_partition_table->append_build_chunk(chunk));
+    }
+    RETURN_IF_ERROR(_partition_table->build());
+    _partition_mem_usage = _partition_table->memory_usage();
+    if (mem_tracker() != nullptr) {
+        mem_tracker()->consume(_partition_mem_usage);
+    }
+
+    _prober = std::make_unique<JoinProber>(_partition_table.get());
+    ASSIGN_OR_RETURN(_probe_reader, _joiner->open_spilled_probe(_partition));
+    return Status::OK();
+}
+
+void HashJoinProbeOperator::_close_partition(RuntimeState* state) {
+    _prober.reset();
+    _probe_reader.reset();
+    _partition_table.reset();
+    if (mem_tracker() != nullptr) {
+        mem_tracker()->release(_partition_mem_usage);
+    }
+    _partition_mem_usage = 0;
+    _partition = -1;
+}
+
+OperatorPtr HashJoinProbeOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    _joiner->set_num_probers(degree_of_parallelism);
+    return std::make_shared<HashJoinProbeOperator>(this, _id, _plan_node_id, driver_sequence, _joiner);
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "exec/hash_joiner.h"
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Probes the shared join hash table with the chunks of the probe pipeline.
+// Takes no input until the build side is done, which keeps its driver parked
+// in the poller rather than spinning.
+//
+// When the join spilled, input is spilled by partition instead, and once every
+// probe driver is done with that, each driver repeatedly claims a partition,
+// restores its build rows into a private hash table and probes it with the
+// partition's spilled probe rows.
+class HashJoinProbeOperator final : public Operator {
+public:
+    HashJoinProbeOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                          HashJoinerPtr joiner);
+
+    bool has_output() const override;
+    bool need_input() const override;
+    bool is_finished() const override;
+    bool pending_finish() const override { return _joiner->has_pending_spill_writes(); }
+
+    Status set_finishing(RuntimeState* state) override;
+    Status set_finished(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    void close(RuntimeState* state) override;
+
+private:
+    bool _is_full_join() const { return _joiner->join_type() == JoinType::FULL_OUTER_JOIN; }
+    bool _has_remaining() const { return _prober != nullptr && _prober->has_remaining(); }
+    void _on_probe_done();
+
+    StatusOr<ChunkPtr> _pull_spilled(RuntimeState* state);
+    Status _open_partition(RuntimeState* state);
+    void _close_partition(RuntimeState* state);
+
+    HashJoinerPtr _joiner;
+    // Over the joiner's table, or the current partition's once spilled.
+    // Created once the build is done.
+    std::unique_ptr<JoinProber> _prober;
+    bool _is_finishing = false;
+    bool _is_finished = false;
+    // FULL OUTER JOIN: this driver's matches were merged into the joiner, and
+    // whether it is the one emitting the unmatched build rows.
+    bool _probe_done_handled = false;
+    bool _emit_unmatched = false;
+    uint32_t _unmatched_cursor = 0;
+
+    // Grace hash join.
+    bool _probe_spill_finished = false;
+    bool _partitions_done = false;
+    int32_t _partition = -1;
+    std::unique_ptr<JoinHashTable> _partition_table;
+    int64_t _partition_mem_usage = 0;
+    spill::SpillStreamReaderPtr _probe_reader;
+};
+
+class HashJoinProbeOperatorFactory final : public OperatorFactory {
+public:
+    HashJoinProbeOperatorFactory(int32_t id, int32_t plan_node_id, HashJoinerPtr joiner)
+            : OperatorFactory(id, "hash_join_probe", plan_node_id), _joiner(std::move(joiner)) {}
+
+    Status prepare(RuntimeState* state) override { return _joiner->prepare(); }
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    HashJoinerPtr _joiner;
+};
+
+} // namespace starrocks::pipeline
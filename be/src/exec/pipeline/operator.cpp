@@ -0,0 +1,23 @@
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+Operator::Operator(OperatorFactory* factory, int32_t id, std::string name, int32_t plan_node_id,
+                   int32_t driver_sequence)
+        : _factory(factory),
+          _id(id),
+          _name(std::move(name)),
+          _plan_node_id(plan_node_id),
+          _driver_sequence(driver_sequence) {}
+
+MemTracker* Operator::mem_tracker() const {
+    return _factory->mem_tracker();
+}
+
+std::string Operator::debug_string() const {
+    return _name + "(id=" + std::to_string(_id) + ", plan_node_id=" + std::to_string(_plan_node_id) +
+           ", driver=" + std::to_string(_driver_sequence) + ", pushed_rows=" + std::to_string(_pushed_rows) +
+           ", pulled_rows=" + std::to_string(_pulled_rows) + ")";
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/status.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks::pipeline {
+
+class OperatorFactory;
+
+// Operator is one push-based stage of a pipeline. A PipelineDriver moves
+// chunks between adjacent operators by calling pull_chunk() on the upstream
+// one and push_chunk() on the downstream one whenever
+//     upstream->has_output() && downstream->need_input()
+// holds. Operators never block: an operator waiting on I/O, a full buffer or
+// another pipeline simply reports has_output()/need_input() == false, and the
+// driver parks itself until that changes.
+//
+// Lifecycle: prepare -> (push/pull)* -> set_finishing -> ... -> is_finished
+// -> close. set_finishing() tells an operator that its input is exhausted;
+// set_finished() tells it its output is no longer wanted.
+class Operator {
+public:
+    Operator(OperatorFactory* factory, int32_t id, std::string name, int32_t plan_node_id, int32_t driver_sequence);
+    virtual ~Operator() = default;
+
+    virtual Status prepare(RuntimeState* state) { return Status::OK(); }
+    virtual void close(RuntimeState* state) {}
+
+    virtual bool has_output() const = 0;
+    virtual bool need_input() const = 0;
+    virtual bool is_finished() const = 0;
+
+    // No more input will be pushed.
+    virtual Status set_finishing(RuntimeState* state) { return Status::OK(); }
+    // Downstream does not need more output; the operator should stop work.
+    virtual Status set_finished(RuntimeState* state) { return Status::OK(); }
+
+    // True while asynchronous work started by this operator (e.g. I/O) is
+    // still running, so the operator cannot be closed yet.
+    virtual bool pending_finish() const { return false; }
+
+    virtual Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) = 0;
+    // May return nullptr or an empty chunk when there is nothing to emit.
+    virtual StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) = 0;
+
+    int32_t id() const { return _id; }
+    const std::string& name() const { return _name; }
+    int32_t plan_node_id() const { return _plan_node_id; }
+    int32_t driver_sequence() const { return _driver_sequence; }
+    OperatorFactory* factory() const { return _factory; }
+    MemTracker* mem_tracker() const;
+
+    // Statistics maintained by the driver.
+    int64_t pushed_rows() const { return _pushed_rows; }
+    int64_t pulled_rows() const { return _pulled_rows; }
+    void update_pushed_rows(int64_t rows) { _pushed_rows += rows; }
+    void update_pulled_rows(int64_t rows) { _pulled_rows += rows; }
+    int64_t& total_time_ns() { return _total_time_ns; }
+
+    std::string debug_string() const;
+
+protected:
+    OperatorFactory* _factory;
+    const int32_t _id;
+    const std::string _name;
+    const int32_t _plan_node_id;
+    const int32_t _driver_sequence;
+
+    int64_t _pushed_rows = 0;
+    int64_t _pulled_rows = 0;
+    int64_t _total_time_ns = 0;
+};
+
+using OperatorPtr = std::shared_ptr<Operator>;
+using Operators = std::vector<OperatorPtr>;
+
+// Creates the per-driver instances of one operator. Everything shared by the
+// instances (hash tables under construction, morsel queues, exchange buffers)
+// lives in the factory or in objects it owns.
+class OperatorFactory {
+public:
+    OperatorFactory(int32_t id, std::string name, int32_t plan_node_id)
+            : _id(id), _name(std::move(name)), _plan_node_id(plan_node_id) {}
+    virtual ~OperatorFactory() = default;
+
+    virtual OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) = 0;
+
+    virtual Status prepare(RuntimeState* state) { return Status::OK(); }
+    virtual void close(RuntimeState* state) {}
+
+    int32_t id() const { return _id; }
+    const std::string& name() const { return _name; }
+    int32_t plan_node_id() const { return _plan_node_id; }
+
+    // Operator-level tracker, shared by all instances of the operator and set
+    // by the fragment before prepare(). Operators with large state report
+    // its size here (see MemTracker).
+    MemTracker* mem_tracker() const { return _mem_tracker; }
+    void set_mem_tracker(MemTracker* mem_tracker) { _mem_tracker = mem_tracker; }
+
+protected:
+    const int32_t _id;
+    const std::string _name;
+    const int32_t _plan_node_id;
+    MemTracker* _mem_tracker = nullptr;
+};
+
+using OperatorFactoryPtr = std::shared_ptr<OperatorFactory>;
+using OpFactories = std::vector<OperatorFactoryPtr>;
+
+// The first operator of a pipeline. It never receives input.
+class SourceOperator : public Operator {
+public:
+    using Operator::Operator;
+
+    bool need_input() const override { return false; }
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override {
+        return Status::InternalError("source operator does not accept input");
+    }
+};
+
+class SourceOperatorFactory : public OperatorFactory {
+public:
+    using OperatorFactory::OperatorFactory;
+
+    // Number of drivers the pipeline starting with this source is split into.
+    int32_t degree_of_parallelism() const { return _degree_of_parallelism; }
+    void set_degree_of_parallelism(int32_t dop) { _degree_of_parallelism = dop; }
+
+private:
+    int32_t _degree_of_parallelism = 1;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,33 @@
+#include "exec/pipeline/pipeline.h"
+
+#include <cassert>
+
+namespace starrocks::pipeline {
+
+Pipeline::Pipeline(int32_t id, OpFactories op_factories) : _id(id), _op_factories(std::move(op_factories)) {
+    assert(!_op_factories.empty());
+}
+
+Status Pipeline::prepare(RuntimeState* state) {
+    for (auto& factory : _op_factories) {
+        RETURN_IF_ERROR(factory->prepare(state));
+    }
+    return Status::OK();
+}
+
+void Pipeline::close(RuntimeState* state) {
+    for (auto& factory : _op_factories) {
+        factory->close(state);
+    }
+}
+
+Operators Pipeline::create_operators(int32_t degree_of_parallelism, int32_t driver_sequence) const {
+    Operators operators;
+    operators.reserve(_op_factories.size());
+    for (const auto& factory : _op_factories) {
+        operators.emplace_back(factory->create(degree_of_parallelism, driver_sequence));
+    }
+    return operators;
+}
+
+} // namespace starrocks::pipeline
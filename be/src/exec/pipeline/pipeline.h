@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// A linear chain of operator factories starting with a source. At prepare
+// time the pipeline is instantiated as degree_of_parallelism() drivers, each
+// with its own operator instances.
+class Pipeline {
+public:
+    Pipeline(int32_t id, OpFactories op_factories);
+
+    int32_t id() const { return _id; }
+    const OpFactories& op_factories() const { return _op_factories; }
+    SourceOperatorFactory* source_operator_factory() const {
+        return static_cast<SourceOperatorFactory*>(_op_factories[0].get());
+    }
+    int32_t degree_of_parallelism() const { return source_operator_factory()->degree_of_parallelism(); }
+
+    Status prepare(RuntimeState* state);
+    void close(RuntimeState* state);
+
+    // Creates the operator chain for driver |driver_sequence|.
+    Operators create_operators(int32_t degree_of_parallelism, int32_t driver_sequence) const;
+
+private:
+    const int32_t _id;
+    OpFactories _op_factories;
+};
+
+using PipelinePtr = std::shared_ptr<Pipeline>;
+using Pipelines = std::vector<PipelinePtr>;
+
+} // namespace starrocks::pipeline
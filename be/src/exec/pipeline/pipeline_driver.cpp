@@ -0,0 +1,220 @@
+#include "exec/pipeline/pipeline_driver.h"
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "runtime/current_thread.h"
+
+namespace starrocks::pipeline {
+
+const char* driver_state_name(DriverState state) {
+    switch (state) {
+    case DriverState::NOT_READY:
+        return "NOT_READY";
+    case DriverState::READY:
+        return "READY";
+    case DriverState::RUNNING:
+        return "RUNNING";
+    case DriverState::INPUT_EMPTY:
+        return "INPUT_EMPTY";
+    case DriverState::OUTPUT_FULL:
+        return "OUTPUT_FULL";
+    case DriverState::PENDING_FINISH:
+        return "PENDING_FINISH";
+    case DriverState::FINISH:
+        return "FINISH";
+    case DriverState::CANCELED:
+        return "CANCELED";
+    case DriverState::INTERNAL_ERROR:
+        return "INTERNAL_ERROR";
+    }
+    return "UNKNOWN";
+}
+
+PipelineDriver::PipelineDriver(Operators operators, FragmentContext* fragment_ctx, int32_t driver_id)
+        : _operators(std::move(operators)),
+          _fragment_ctx(fragment_ctx),
+          _driver_id(driver_id),
+          _finishing_marked(_operators.size(), 0),
+          _finished_marked(_operators.size(), 0) {}
+
+PipelineDriver::~PipelineDriver() = default;
+
+QueryContext* PipelineDriver::query_ctx() const {
+    return _fragment_ctx->query_ctx();
+}
+
+RuntimeState* PipelineDriver::runtime_state() const {
+    return _fragment_ctx->runtime_state();
+}
+
+Status PipelineDriver::prepare(RuntimeState* state) {
+    if (_operators.size() < 2) {
+        return Status::InvalidArgument("a pipeline needs a source and a sink operator");
+    }
+    for (auto& op : _operators) {
+        RETURN_IF_ERROR(op->prepare(state));
+    }
+    _state = DriverState::READY;
+    return Status::OK();
+}
+
+Status PipelineDriver::_mark_operator_finishing(size_t idx, RuntimeState* state) {
+    if (_finishing_marked[idx]) {
+        return Status::OK();
+    }
+    _finishing_marked[idx] = 1;
+    return _operators[idx]->set_finishing(state);
+}
+
+Status PipelineDriver::_mark_operator_finished(size_t idx, RuntimeState* state) {
+    RETURN_IF_ERROR(_mark_operator_finishing(idx, state));
+    if (_finished_marked[idx]) {
+        return Status::OK();
+    }
+    _finished_marked[idx] = 1;
+    return _operators[idx]->set_finished(state);
+}
+
+StatusOr<DriverState> PipelineDriver::process(RuntimeState* state, int worker_id) {
+    _last_worker_id = worker_id;
+    _schedule_count++;
+    _total_timer.start();
+    struct StopTimer {
+        MonotonicStopWatch* watch;
+        ~StopTimer() { watch->stop(); }
+    } stop_timer{&_total_timer};
+
+    // Everything allocated while the driver runs is charged to its fragment.
+    ScopedThreadMemTracker mem_scope(_fragment_ctx->mem_tracker());
+
+    const int64_t start_ns = monotonic_nanos();
+    const size_t num_operators = _operators.size();
+    int64_t total_chunks_moved = 0;
+
+    while (true) {
+        if (UNLIKELY(state->is_cancelled())) {
+            cancel_operators(state);
+            return DriverState::CANCELED;
+        }
+        if (MemTracker* exceeded = _fragment_ctx->mem_tracker()->find_limit_exceeded_tracker();
+            UNLIKELY(exceeded != nullptr)) {
+            return query_ctx()->mem_tracker()->limit_exceeded_status(exceeded);
+        }
+
+        size_t num_chunks_moved = 0;
+        size_t new_first_unfinished = _first_unfinished;
+        for (size_t i = _first_unfinished; i + 1 < num_operators; ++i) {
+            Operator* cur = _operators[i].get();
+            Operator* next = _operators[i + 1].get();
+
+            // Downstream is done (e.g. a LIMIT was reached): everything
+            // upstream of it can stop producing.
+            if (next->is_finished()) {
+                for (size_t j = new_first_unfinished; j <= i; ++j) {
+                    RETURN_IF_ERROR(_mark_operator_finished(j, state));
+                }
+                new_first_unfinished = i + 1;
+                continue;
+            }
+
+            if (cur->has_output() && next->need_input()) {
+                int64_t pull_start = monotonic_nanos();
+                ASSIGN_OR_RETURN(ChunkPtr chunk, cur->pull_chunk(state));
+                int64_t push_start = monotonic_nanos();
+                cur->total_time_ns() += push_start - pull_start;
+                if (chunk != nullptr && chunk->num_rows() > 0) {
+                    size_t rows = chunk->num_rows();
+                    cur->update_pulled_rows(rows);
+                    RETURN_IF_ERROR(next->push_chunk(state, chunk));
+                    next->update_pushed_rows(rows);
+                    next->total_time_ns() += monotonic_nanos() - push_start;
+                    num_chunks_moved++;
+                }
+            }
+
+            if (cur->is_finished()) {
+                RETURN_IF_ERROR(_mark_operator_finished(i, state));
+                RETURN_IF_ERROR(_mark_operator_finishing(i + 1, state));
+                new_first_unfinished = i + 1;
+            }
+        }
+        bool made_progress = num_chunks_moved > 0 || new_first_unfinished != _first_unfinished;
+        _first_unfinished = new_first_unfinished;
+
+        if (sink_operator()->is_finished()) {
+            for (size_t j = 0; j < num_operators; ++j) {
+                RETURN_IF_ERROR(_mark_operator_finished(j, state));
+            }
+            return DriverState::FINISH;
+        }
+
+        if (!made_progress) {
+            return sink_operator()->need_input() ? DriverState::INPUT_EMPTY : DriverState::OUTPUT_FULL;
+        }
+
+        total_chunks_moved += num_chunks_moved;
+        if (total_chunks_moved >= config::pipeline_yield_max_chunks_moved ||
+            monotonic_nanos() - start_ns >= config::pipeline_yield_max_time_spent_ns) {
+            return DriverState::READY;
+        }
+    }
+}
+
+bool PipelineDriver::is_not_blocked() {
+    if (query_ctx()->is_cancelled()) {
+        return true;
+    }
+    if (_state == DriverState::PENDING_FINISH) {
+        return !has_pending_operators();
+    }
+    // Unblocked as soon as process() could make progress somewhere in the
+    // chain, which also covers operators that wait on another pipeline.
+    const size_t num_operators = _operators.size();
+    for (size_t i = _first_unfinished; i + 1 < num_operators; ++i) {
+        Operator* cur = _operators[i].get();
+        Operator* next = _operators[i + 1].get();
+        if (next->is_finished() || cur->is_finished() || (cur->has_output() && next->need_input())) {
+            return true;
+        }
+    }
+    return sink_operator()->is_finished();
+}
+
+void PipelineDriver::cancel_operators(RuntimeState* state) {
+    for (size_t i = 0; i < _operators.size(); ++i) {
+        (void)_mark_operator_finished(i, state);
+    }
+}
+
+bool PipelineDriver::has_pending_operators() const {
+    for (const auto& op : _operators) {
+        if (op->pending_finish()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PipelineDriver::finalize(RuntimeState* state, DriverState state_to_report) {
+    for (auto& op : _operators) {
+        op->close(state);
+    }
+    _state = state_to_report;
+    _fragment_ctx->count_down_driver(this);
+}
+
+std::string PipelineDriver::to_readable_string() const {
+    std::string res = "driver(id=" + std::to_string(_driver_id) + ", state=" + driver_state_name(_state) +
+                      ", schedules=" + std::to_string(_schedule_count) +
+                      ", running_ns=" + std::to_string(total_running_time_ns()) +
+                      ", pending_ns=" + std::to_string(pending_time_ns()) + ") [";
+    for (size_t i = 0; i < _operators.size(); ++i) {
+        if (i > 0) {
+            res.append(" -> ");
+        }
+        res.append(_operators[i]->debug_string());
+    }
+    return res + "]";
+}
+
+} // namespace starrocks::pipeline
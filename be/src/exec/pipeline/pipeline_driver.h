@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exec/pipeline/operator.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::pipeline {
+
+class FragmentContext;
+
+enum class DriverState : uint32_t {
+    NOT_READY = 0,
+    READY,
+    RUNNING,
+    // Blocked states: the driver is parked in the poller until unblocked.
+    INPUT_EMPTY,
+    OUTPUT_FULL,
+    PENDING_FINISH,
+    // Terminal states.
+    FINISH,
+    CANCELED,
+    INTERNAL_ERROR,
+};
+
+const char* driver_state_name(DriverState state);
+
+inline bool is_blocked_state(DriverState state) {
+    return state == DriverState::INPUT_EMPTY || state == DriverState::OUTPUT_FULL ||
+           state == DriverState::PENDING_FINISH;
+}
+
+inline bool is_terminal_state(DriverState state) {
+    return state == DriverState::FINISH || state == DriverState::CANCELED || state == DriverState::INTERNAL_ERROR;
+}
+
+// PipelineDriver executes one instance of a pipeline. A worker thread calls
+// process(), which moves chunks through the operator chain until one of:
+//   * the driver used up its time slice or chunk budget -> READY (yield),
+//   * no chunk could be moved because the source has no data yet
+//     (INPUT_EMPTY) or the sink cannot take more (OUTPUT_FULL),
+//   * the sink finished -> FINISH (or PENDING_FINISH while async work drains).
+// Blocked drivers are handed to the poller and rescheduled once
+// is_not_blocked() turns true, so a driver waiting on I/O or on another
+// pipeline never holds a worker thread.
+class PipelineDriver {
+public:
+    PipelineDriver(Operators operators, FragmentContext* fragment_ctx, int32_t driver_id);
+    ~PipelineDriver();
+
+    Status prepare(RuntimeState* state);
+
+    StatusOr<DriverState> process(RuntimeState* state, int worker_id);
+
+    // Closes the operators and reports the driver as done to the fragment.
+    void finalize(RuntimeState* state, DriverState state_to_report);
+
+    // Called by the poller on a parked driver.
+    bool is_not_blocked();
+
+    // Drives a cancelled query's driver towards its terminal state.
+    void cancel_operators(RuntimeState* state);
+
+    // True while an operator still has asynchronous work in flight.
+    bool has_pending_operators() const;
+
+    DriverState driver_state() const { return _state; }
+    void set_driver_state(DriverState state) { _state = state; }
+
+    int32_t driver_id() const { return _driver_id; }
+    FragmentContext* fragment_ctx() const { return _fragment_ctx; }
+    QueryContext* query_ctx() const;
+    RuntimeState* runtime_state() const;
+
+    SourceOperator* source_operator() const { return static_cast<SourceOperator*>(_operators.front().get()); }
+    Operator* sink_operator() const { return _operators.back().get(); }
+    const Operators& operators() const { return _operators; }
+
+    int last_worker_id() const { return _last_worker_id; }
+
+    // Terminal state a PENDING_FINISH driver reports once it is finalized.
+    DriverState pending_final_state() const { return _pending_final_state; }
+    void set_pending_final_state(DriverState state) { _pending_final_state = state; }
+
+    // Scheduling statistics.
+    int64_t schedule_count() const { return _schedule_count; }
+    int64_t total_running_time_ns() const { return _total_timer.elapsed_time(); }
+    int64_t pending_time_ns() const { return _pending_timer.elapsed_time(); }
+    void start_pending_timer() { _pending_timer.start(); }
+    void stop_pending_timer() { _pending_timer.stop(); }
+
+    std::string to_readable_string() const;
+
+private:
+    // Marks operators [from, to) finishing; once an operator is finished its
+    // downstream neighbour will never get more input.
+    Status _mark_operator_finishing(size_t idx, RuntimeState* state);
+    Status _mark_operator_finished(size_t idx, RuntimeState* state);
+
+    Operators _operators;
+    FragmentContext* _fragment_ctx;
+    const int32_t _driver_id;
+
+    // Operators before this index are finished and need no more visits.
+    size_t _first_unfinished = 0;
+    std::vector<uint8_t> _finishing_marked;
+    std::vector<uint8_t> _finished_marked;
+
+    DriverState _state = DriverState::NOT_READY;
+    DriverState _pending_final_state = DriverState::FINISH;
+    int _last_worker_id = -1;
+    int64_t _schedule_count = 0;
+    MonotonicStopWatch _total_timer;
+    MonotonicStopWatch _pending_timer;
+};
+
+using DriverPtr = std::shared_ptr<PipelineDriver>;
+using DriverRawPtr = PipelineDriver*;
+using Drivers = std::vector<DriverPtr>;
+
+} // namespace starrocks::pipeline
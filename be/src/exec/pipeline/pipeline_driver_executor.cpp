@@ -0,0 +1,152 @@
+#include "exec/pipeline/pipeline_driver_executor.h"
+
+#include <pthread.h>
+
+#include "exec/pipeline/fragment_context.h"
+
+namespace starrocks::pipeline {
+
+PipelineDriverExecutor::PipelineDriverExecutor(int num_threads)
+        : _num_threads(num_threads < 1 ? 1 : num_threads),
+          _poller([this](DriverRawPtr driver) { submit(driver); }) {
+    for (int i = 0; i < _num_threads; ++i) {
+        _queues.emplace_back(std::make_unique<WorkStealingDriverQueue>());
+    }
+}
+
+PipelineDriverExecutor::~PipelineDriverExecutor() {
+    close();
+}
+
+void PipelineDriverExecutor::start() {
+    _poller.start();
+    for (int i = 0; i < _num_threads; ++i) {
+        _workers.emplace_back([this, i] { _worker_run(i); });
+        pthread_setname_np(_workers.back().native_handle(), "pip_exec");
+    }
+}
+
+void PipelineDriverExecutor::close() {
+    if (_stopped.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> l(_park_lock);
+    }
+    _park_cv.notify_all();
+    for (auto& t : _workers) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    _poller.shutdown();
+}
+
+void PipelineDriverExecutor::_push(int worker_id, DriverRawPtr driver, bool to_front) {
+    if (to_front) {
+        _queues[worker_id]->push_front(driver);
+    } else {
+        _queues[worker_id]->push_back(driver);
+    }
+    _num_ready.fetch_add(1, std::memory_order_release);
+    {
+        // Taking the lock orders this notify after a parking worker's check of
+        // _num_ready, so the wakeup cannot be lost.
+        std::lock_guard<std::mutex> l(_park_lock);
+    }
+    _park_cv.notify_one();
+}
+
+void PipelineDriverExecutor::submit(DriverRawPtr driver) {
+    driver->set_driver_state(driver->driver_state() == DriverState::PENDING_FINISH ? DriverState::PENDING_FINISH
+                                                                                   : DriverState::READY);
+    // Return an unblocked driver to the worker that ran it last, where its
+    // data is likely still cached; new drivers are spread round-robin.
+    int worker_id = driver->last_worker_id();
+    if (worker_id < 0) {
+        worker_id = _next_queue.fetch_add(1, std::memory_order_relaxed) % _num_threads;
+    }
+    _push(worker_id, driver, false);
+}
+
+DriverRawPtr PipelineDriverExecutor::_take(int worker_id) {
+    while (!_stopped.load(std::memory_order_acquire)) {
+        DriverRawPtr driver = _queues[worker_id]->pop_back();
+        if (driver == nullptr) {
+            for (int i = 1; i < _num_threads && driver == nullptr; ++i) {
+                driver = _queues[(worker_id + i) % _num_threads]->steal();
+            }
+            if (driver != nullptr) {
+                _num_steals.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (driver != nullptr) {
+            _num_ready.fetch_sub(1, std::memory_order_acq_rel);
+            return driver;
+        }
+        std::unique_lock<std::mutex> l(_park_lock);
+        // A steal attempt can miss a queue whose lock was held; only sleep when
+        // no driver is queued anywhere.
+        _park_cv.wait(l, [this] {
+            return _num_ready.load(std::memory_order_acquire) > 0 || _stopped.load(std::memory_order_acquire);
+        });
+    }
+    return nullptr;
+}
+
+void PipelineDriverExecutor::_on_driver_done(DriverRawPtr driver, DriverState state) {
+    // Async work (e.g. in-flight I/O) may still reference the operators; park
+    // the driver until it drains, then finalize with the real outcome.
+    if (driver->has_pending_operators()) {
+        driver->set_pending_final_state(state);
+        driver->set_driver_state(DriverState::PENDING_FINISH);
+        _poller.add_blocked_driver(driver);
+        return;
+    }
+    driver->finalize(driver->runtime_state(), state);
+}
+
+void PipelineDriverExecutor::_worker_run(int worker_id) {
+    while (true) {
+        DriverRawPtr driver = _take(worker_id);
+        if (driver == nullptr) {
+            return;
+        }
+        RuntimeState* state = driver->runtime_state();
+
+        if (driver->driver_state() == DriverState::PENDING_FINISH) {
+            _on_driver_done(driver, state->is_cancelled() && driver->pending_final_state() == DriverState::FINISH
+                                            ? DriverState::CANCELED
+                                            : driver->pending_final_state());
+            continue;
+        }
+
+        driver->set_driver_state(DriverState::RUNNING);
+        StatusOr<DriverState> res = driver->process(state, worker_id);
+        if (!res.ok()) {
+            driver->query_ctx()->cancel(res.status());
+            driver->cancel_operators(state);
+            _on_driver_done(driver, DriverState::INTERNAL_ERROR);
+            continue;
+        }
+
+        DriverState next = res.value();
+        switch (next) {
+        case DriverState::READY:
+            driver->set_driver_state(DriverState::READY);
+            // Yielded: queue behind this worker's other ready drivers.
+            _push(worker_id, driver, true);
+            break;
+        case DriverState::INPUT_EMPTY:
+        case DriverState::OUTPUT_FULL:
+            driver->set_driver_state(next);
+            _poller.add_blocked_driver(driver);
+            break;
+        default:
+            _on_driver_done(driver, next);
+            break;
+        }
+    }
+}
+
+} // namespace starrocks::pipeline
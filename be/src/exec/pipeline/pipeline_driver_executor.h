@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "exec/pipeline/driver_queue.h"
+#include "exec/pipeline/pipeline_driver_poller.h"
+
+namespace starrocks::pipeline {
+
+// Runs pipeline drivers of all queries on a fixed pool of worker threads.
+//
+// Each worker owns a WorkStealingDriverQueue. A worker takes work from its own
+// queue first and otherwise steals from the others, so a single query with
+// many drivers spreads over every core without any thread being created per
+// fragment. Drivers that block are parked in the poller and come back through
+// submit() when they can make progress.
+class PipelineDriverExecutor {
+public:
+    explicit PipelineDriverExecutor(int num_threads);
+    ~PipelineDriverExecutor();
+
+    void start();
+    void close();
+
+    // Makes |driver| runnable. Safe to call from any thread.
+    void submit(DriverRawPtr driver);
+
+    // Lets the poller re-check blocked drivers now; called by event sources
+    // (I/O completions, buffers draining) that unblock drivers.
+    void wake_poller() { _poller.wake(); }
+
+    int num_threads() const { return _num_threads; }
+    int64_t num_steals() const { return _num_steals.load(std::memory_order_relaxed); }
+    size_t num_blocked_drivers() const { return _poller.num_blocked_drivers(); }
+
+private:
+    void _worker_run(int worker_id);
+    DriverRawPtr _take(int worker_id);
+    void _push(int worker_id, DriverRawPtr driver, bool to_front);
+    void _on_driver_done(DriverRawPtr driver, DriverState state);
+
+    const int _num_threads;
+    std::vector<std::unique_ptr<WorkStealingDriverQueue>> _queues;
+    std::vector<std::thread> _workers;
+    PipelineDriverPoller _poller;
+
+    // Drivers sitting in any queue; idle workers sleep while it is zero.
+    std::atomic<int64_t> _num_ready{0};
+    std::mutex _park_lock;
+    std::condition_variable _park_cv;
+    std::atomic<bool> _stopped{false};
+
+    std::atomic<uint32_t> _next_queue{0};
+    std::atomic<int64_t> _num_steals{0};
+};
+
+} // namespace starrocks::pipeline
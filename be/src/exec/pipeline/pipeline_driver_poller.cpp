@@ -0,0 +1,88 @@
+#include "exec/pipeline/pipeline_driver_poller.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/config.h"
+
+namespace starrocks::pipeline {
+
+void PipelineDriverPoller::start() {
+    _thread = std::thread([this] { _run(); });
+}
+
+void PipelineDriverPoller::shutdown() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _cv.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void PipelineDriverPoller::add_blocked_driver(DriverRawPtr driver) {
+    driver->start_pending_timer();
+    _num_blocked.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _incoming.push_back(driver);
+        _woken = true;
+    }
+    _cv.notify_one();
+}
+
+void PipelineDriverPoller::wake() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _woken = true;
+    }
+    _cv.notify_one();
+}
+
+void PipelineDriverPoller::_run() {
+    std::list<DriverRawPtr> blocked;
+    // Back off exponentially while nothing is becoming ready, up to the
+    // configured interval; any wake() resets it.
+    int64_t idle_wait_us = 10;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> l(_lock);
+            if (!_woken && !_stopped) {
+                _cv.wait_for(l, std::chrono::microseconds(blocked.empty() ? config::pipeline_poller_max_interval_us
+                                                                          : idle_wait_us));
+            }
+            if (_stopped) {
+                return;
+            }
+            if (_woken) {
+                idle_wait_us = 10;
+            }
+            _woken = false;
+            blocked.splice(blocked.end(), _incoming);
+        }
+
+        bool any_ready = false;
+        for (auto it = blocked.begin(); it != blocked.end();) {
+            DriverRawPtr driver = *it;
+            if (driver->is_not_blocked()) {
+                driver->stop_pending_timer();
+                it = blocked.erase(it);
+                _num_blocked.fetch_sub(1, std::memory_order_relaxed);
+                _on_ready(driver);
+                any_ready = true;
+            } else {
+                ++it;
+            }
+        }
+        if (!any_ready) {
+            idle_wait_us = std::min<int64_t>(idle_wait_us * 2, config::pipeline_poller_max_interval_us);
+        }
+    }
+}
+
+} // namespace starrocks::pipeline
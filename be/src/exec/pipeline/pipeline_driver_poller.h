@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+
+#include "exec/pipeline/pipeline_driver.h"
+
+namespace starrocks::pipeline {
+
+// Holds blocked drivers off the worker threads. A single thread re-checks
+// each parked driver's is_not_blocked() and hands unblocked drivers back to
+// the executor through |on_ready|.
+//
+// The poller sleeps while nothing changes; producers of the events drivers
+// wait on (I/O completion, exchange buffers draining, a build side finishing)
+// call wake() so the wait ends immediately instead of after the poll interval.
+class PipelineDriverPoller {
+public:
+    using ReadyCallback = std::function<void(DriverRawPtr)>;
+
+    explicit PipelineDriverPoller(ReadyCallback on_ready) : _on_ready(std::move(on_ready)) {}
+    ~PipelineDriverPoller() { shutdown(); }
+
+    void start();
+    void shutdown();
+
+    void add_blocked_driver(DriverRawPtr driver);
+
+    void wake();
+
+    size_t num_blocked_drivers() const { return _num_blocked.load(std::memory_order_relaxed); }
+
+private:
+    void _run();
+
+    ReadyCallback _on_ready;
+    std::thread _thread;
+
+    std::mutex _lock;
+    std::condition_variable _cv;
+    std::list<DriverRawPtr> _incoming;
+    bool _woken = false;
+    bool _stopped = false;
+
+    std::atomic<size_t> _num_blocked{0};
+};
+
+} // namespace starrocks::pipeline
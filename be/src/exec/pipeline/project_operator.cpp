@@ -0,0 +1,10 @@
+#include "exec/pipeline/project_operator.h"
+
+namespace starrocks::pipeline {
+
+Status ProjectOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    ASSIGN_OR_RETURN(_chunk, _program.execute(_ctx.get(), chunk));
+    return Status::OK();
+}
+
+} // namespace starrocks::pipeline
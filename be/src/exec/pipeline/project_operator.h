@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "exec/pipeline/operator.h"
+#include "exprs/expr_program.h"
+
+namespace starrocks::pipeline {
+
+// Filters its input by the conjuncts of an ExprProgram and computes the
+// projections of the rows left. Chunks no row of which passes are dropped.
+class ProjectOperator final : public Operator {
+public:
+    ProjectOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                    const ExprProgram& program)
+            : Operator(factory, id, "project", plan_node_id, driver_sequence),
+              _program(program),
+              _ctx(program.create_context()) {}
+
+    bool has_output() const override { return _chunk != nullptr; }
+    bool need_input() const override { return _chunk == nullptr && !_is_finishing; }
+    bool is_finished() const override { return _is_finishing && _chunk == nullptr; }
+
+    Status set_finishing(RuntimeState* state) override {
+        _is_finishing = true;
+        return Status::OK();
+    }
+    Status set_finished(RuntimeState* state) override {
+        _is_finishing = true;
+        _chunk.reset();
+        return Status::OK();
+    }
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override { return std::move(_chunk); }
+
+    // Values of shared subexpressions used again instead of computed.
+    size_t num_reused_values() const { return _ctx->num_reused_values(); }
+
+private:
+    const ExprProgram& _program;
+    std::unique_ptr<ExprContext> _ctx;
+    ChunkPtr _chunk;
+    bool _is_finishing = false;
+};
+
+class ProjectOperatorFactory final : public OperatorFactory {
+public:
+    ProjectOperatorFactory(int32_t id, int32_t plan_node_id, std::unique_ptr<ExprProgram> program)
+            : OperatorFactory(id, "project", plan_node_id), _program(std::move(program)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override {
+        return std::make_shared<ProjectOperator>(this, _id, _plan_node_id, driver_sequence, *_program);
+    }
+
+    const ExprProgram& program() const { return *_program; }
+
+private:
+    const std::unique_ptr<ExprProgram> _program;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,124 @@
+#include "exec/pipeline/runtime_filter_hub.h"
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "runtime/current_thread.h"
+
+namespace starrocks::pipeline {
+
+RuntimeFilterProbeCollector::RuntimeFilterProbeCollector(std::vector<RuntimeFilterProbeDescriptor> descriptors)
+        : _descriptors(std::move(descriptors)), _arrived(_descriptors.size(), false) {}
+
+void RuntimeFilterProbeCollector::on_arrival(int32_t filter_id, const RuntimeFilterPtr& filter) {
+    std::lock_guard<std::mutex> l(_lock);
+    for (size_t i = 0; i < _descriptors.size(); ++i) {
+        if (_descriptors[i].filter_id != filter_id || _arrived[i]) {
+            continue;
+        }
+        // Codes of another dictionary than the column's filter nothing.
+        if (filter != nullptr && filter->dict_id() == _descriptors[i].dict_id) {
+            _predicates.emplace_back(new_runtime_filter_predicate(filter, _descriptors[i].column_id));
+        }
+        _arrived[i] = true;
+        _num_arrived.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void RuntimeFilterProbeCollector::start_waiting() {
+    int64_t expected = 0;
+    _wait_deadline_ns.compare_exchange_strong(expected,
+                                              monotonic_nanos() + config::runtime_filter_wait_timeout_ms * 1000000);
+}
+
+bool RuntimeFilterProbeCollector::is_wait_over() const {
+    if (is_ready()) {
+        return true;
+    }
+    int64_t deadline = _wait_deadline_ns.load(std::memory_order_relaxed);
+    return deadline > 0 && monotonic_nanos() >= deadline;
+}
+
+void RuntimeFilterProbeCollector::get_predicates(std::vector<const ColumnPredicate*>* predicates) const {
+    std::lock_guard<std::mutex> l(_lock);
+    for (const auto& predicate : _predicates) {
+        predicates->push_back(predicate.get());
+    }
+}
+
+void RuntimeFilterHub::subscribe(const RuntimeFilterProbeCollectorPtr& collector) {
+    std::lock_guard<std::mutex> l(_lock);
+    _collectors.push_back(collector);
+    for (const auto& [filter_id, entry] : _filters) {
+        if (entry.is_complete) {
+            collector->on_arrival(filter_id, entry.filter);
+        }
+    }
+}
+
+void RuntimeFilterHub::receive(int32_t filter_id, int32_t num_producers, RuntimeFilterPtr filter) {
+    std::lock_guard<std::mutex> l(_lock);
+    _receive_locked(filter_id, num_producers, std::move(filter));
+}
+
+Status RuntimeFilterHub::receive_serialized(int32_t filter_id, int32_t num_producers, const Slice* filter) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_closed) {
+        return Status::OK();
+    }
+    RuntimeFilterPtr part;
+    if (filter != nullptr) {
+        ScopedThreadMemTracker mem_scope(_fragment_ctx->mem_tracker());
+        Slice input = *filter;
+        ASSIGN_OR_RETURN(part, RuntimeFilter::deserialize(&input));
+    }
+    _receive_locked(filter_id, num_producers, std::move(part));
+    return Status::OK();
+}
+
+void RuntimeFilterHub::_receive_locked(int32_t filter_id, int32_t num_producers, RuntimeFilterPtr filter) {
+    if (_closed) {
+        return;
+    }
+    Entry& entry = _filters[filter_id];
+    if (entry.is_complete) {
+        return;
+    }
+    if (filter == nullptr) {
+        entry.is_broken = true;
+        entry.filter.reset();
+    } else if (!entry.is_broken) {
+        if (entry.num_received == 0) {
+            entry.filter = std::move(filter);
+        } else {
+            auto merged = RuntimeFilter::merge(*entry.filter, *filter);
+            if (merged.ok()) {
+                entry.filter = std::move(merged).value();
+            } else {
+                entry.is_broken = true;
+                entry.filter.reset();
+            }
+        }
+    }
+    if (++entry.num_received < num_producers) {
+        return;
+    }
+    entry.is_complete = true;
+    for (const auto& collector : _collectors) {
+        collector->on_arrival(filter_id, entry.filter);
+    }
+    _fragment_ctx->notify_event();
+}
+
+void RuntimeFilterHub::close() {
+    std::lock_guard<std::mutex> l(_lock);
+    _closed = true;
+    _collectors.clear();
+}
+
+RuntimeFilterPtr RuntimeFilterHub::get(int32_t filter_id) const {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _filters.find(filter_id);
+    return it != _filters.end() && it->second.is_complete ? it->second.filter : nullptr;
+}
+
+} // namespace starrocks::pipeline
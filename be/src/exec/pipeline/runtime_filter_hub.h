@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "exec/runtime_filter.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::pipeline {
+
+class FragmentContext;
+
+// The runtime filters one scan applies. Filters arrive while the scan runs;
+// each new morsel is read with the predicates of those that have arrived by
+// then (see segment_chunk_source_factory()).
+class RuntimeFilterProbeCollector {
+public:
+    explicit RuntimeFilterProbeCollector(std::vector<RuntimeFilterProbeDescriptor> descriptors);
+
+    DISALLOW_COPY_AND_MOVE(RuntimeFilterProbeCollector);
+
+    const std::vector<RuntimeFilterProbeDescriptor>& descriptors() const { return _descriptors; }
+
+    // Filter |filter_id| is complete; a null |filter| means it could not be
+    // built and there is nothing to apply. Later arrivals are ignored.
+    void on_arrival(int32_t filter_id, const RuntimeFilterPtr& filter);
+
+    // Every filter has arrived.
+    bool is_ready() const { return _num_arrived.load(std::memory_order_acquire) == _descriptors.size(); }
+    // Starts the clock for config::runtime_filter_wait_timeout_ms; the scan is
+    // ready or timed out once it has passed.
+    void start_waiting();
+    bool is_wait_over() const;
+
+    // Appends the predicates of the filters that have arrived; they live as
+    // long as the collector.
+    void get_predicates(std::vector<const ColumnPredicate*>* predicates) const;
+
+    int64_t num_arrived() const { return _num_arrived.load(std::memory_order_acquire); }
+
+private:
+    const std::vector<RuntimeFilterProbeDescriptor> _descriptors;
+    mutable std::mutex _lock;
+    std::vector<bool> _arrived;
+    std::vector<ColumnPredicatePtr> _predicates;
+    std::atomic<size_t> _num_arrived{0};
+    std::atomic<int64_t> _wait_deadline_ns{0};
+};
+
+using RuntimeFilterProbeCollectorPtr = std::shared_ptr<RuntimeFilterProbeCollector>;
+
+// Where the runtime filters applied by the scans of one fragment instance
+// arrive, from joins of the same fragment or, serialized, from other fragment
+// instances (see RuntimeFilterWorker). A filter with several producers is
+// merged as their parts come in and handed to the scans with the last one.
+class RuntimeFilterHub {
+public:
+    explicit RuntimeFilterHub(FragmentContext* fragment_ctx) : _fragment_ctx(fragment_ctx) {}
+
+    DISALLOW_COPY_AND_MOVE(RuntimeFilterHub);
+
+    // |collector| gets every filter it applies, including those that arrived
+    // earlier.
+    void subscribe(const RuntimeFilterProbeCollectorPtr& collector);
+
+    // One of the |num_producers| parts of filter |filter_id|; a null |filter|
+    // is a part that could not be built, which makes the whole filter one.
+    // Wakes the fragment's parked drivers once the filter is complete.
+    void receive(int32_t filter_id, int32_t num_producers, RuntimeFilterPtr filter);
+    // Same, for a part serialized by RuntimeFilter::serialize(), or null. It
+    // is deserialized into memory charged to the fragment.
+    Status receive_serialized(int32_t filter_id, int32_t num_producers, const Slice* filter);
+
+    // The fragment is going away; later filters are dropped.
+    void close();
+
+    // Complete filter |filter_id|, or null if it has not arrived or could not
+    // be built.
+    RuntimeFilterPtr get(int32_t filter_id) const;
+
+private:
+    struct Entry {
+        int32_t num_received = 0;
+        bool is_complete = false;
+        // Merge of the parts received; null once a part could not be built.
+        RuntimeFilterPtr filter;
+        bool is_broken = false;
+    };
+
+    void _receive_locked(int32_t filter_id, int32_t num_producers, RuntimeFilterPtr filter);
+
+    FragmentContext* _fragment_ctx;
+    mutable std::mutex _lock;
+    bool _closed = false;
+    std::unordered_map<int32_t, Entry> _filters;
+    std::vector<RuntimeFilterProbeCollectorPtr> _collectors;
+};
+
+using RuntimeFilterHubPtr = std::shared_ptr<RuntimeFilterHub>;
+
+} // namespace starrocks::pipeline
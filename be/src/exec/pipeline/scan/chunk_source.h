@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "column/chunk.h"
+#include "common/status.h"
+#include "exec/pipeline/scan/morsel.h"
+#include "io/async_io.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks::pipeline {
+
+// Reads the rows of one morsel. A ChunkSource runs on the scan I/O thread
+// pool, never on a pipeline worker, so get_next() may block on storage.
+class ChunkSource {
+public:
+    explicit ChunkSource(MorselPtr morsel) : _morsel(std::move(morsel)) {}
+    virtual ~ChunkSource() = default;
+
+    virtual Status prepare(RuntimeState* state) { return Status::OK(); }
+    virtual void close(RuntimeState* state) {}
+
+    // Produces the next chunk; returns EndOfFile once the morsel is exhausted.
+    virtual Status get_next(RuntimeState* state, ChunkPtr* chunk) = 0;
+
+    // Starts asynchronous reads, through |engine|, of about |max_bytes| of the
+    // data the next get_next() calls need. Returns whether reads started; if
+    // so, |done| runs once they have finished, and get_next() must not be
+    // called before. Sources that only read synchronously return false.
+    virtual StatusOr<bool> read_ahead(io::AsyncIoEngine* engine, int64_t max_bytes, io::ReadCallback done) {
+        return false;
+    }
+
+    Morsel* morsel() const { return _morsel.get(); }
+
+protected:
+    MorselPtr _morsel;
+};
+
+using ChunkSourcePtr = std::unique_ptr<ChunkSource>;
+using ChunkSourceFactory = std::function<ChunkSourcePtr(MorselPtr morsel)>;
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,32 @@
+#include "exec/pipeline/scan/morsel.h"
+
+#include <algorithm>
+
+namespace starrocks::pipeline {
+
+std::string ScanRangeMorsel::debug_string() const {
+    return "morsel(node=" + std::to_string(plan_node_id()) + ", source=" + std::to_string(_source_id) + ", rows=[" +
+           std::to_string(_begin) + "," + std::to_string(_end) + "))";
+}
+
+MorselPtr FixedMorselQueue::try_get() {
+    size_t idx = _next.fetch_add(1, std::memory_order_acq_rel);
+    if (idx >= _morsels.size()) {
+        return nullptr;
+    }
+    return std::move(_morsels[idx]);
+}
+
+Morsels split_scan_ranges(int32_t plan_node_id, const std::vector<ScanRange>& ranges, int64_t rows_per_morsel) {
+    rows_per_morsel = std::max<int64_t>(rows_per_morsel, 1);
+    Morsels morsels;
+    for (const auto& range : ranges) {
+        for (int64_t begin = 0; begin < range.num_rows; begin += rows_per_morsel) {
+            int64_t end = std::min(begin + rows_per_morsel, range.num_rows);
+            morsels.emplace_back(std::make_unique<ScanRangeMorsel>(plan_node_id, range.source_id, begin, end));
+        }
+    }
+    return morsels;
+}
+
+} // namespace starrocks::pipeline
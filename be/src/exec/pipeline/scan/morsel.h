@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace starrocks::pipeline {
+
+// A morsel is a small, independently scannable unit of a scan's input. All
+// drivers of a scan pipeline pull morsels from one shared MorselQueue, so
+// drivers that finish early simply take more work and a skewed scan range
+// does not leave cores idle.
+class Morsel {
+public:
+    explicit Morsel(int32_t plan_node_id) : _plan_node_id(plan_node_id) {}
+    virtual ~Morsel() = default;
+
+    int32_t plan_node_id() const { return _plan_node_id; }
+
+    virtual std::string debug_string() const { return "morsel(node=" + std::to_string(_plan_node_id) + ")"; }
+
+private:
+    int32_t _plan_node_id;
+};
+
+// Rows [begin, end) of the scan source identified by |source_id| (a tablet,
+// a segment, a file...).
+class ScanRangeMorsel final : public Morsel {
+public:
+    ScanRangeMorsel(int32_t plan_node_id, int64_t source_id, int64_t begin, int64_t end)
+            : Morsel(plan_node_id), _source_id(source_id), _begin(begin), _end(end) {}
+
+    int64_t source_id() const { return _source_id; }
+    int64_t begin() const { return _begin; }
+    int64_t end() const { return _end; }
+    int64_t num_rows() const { return _end - _begin; }
+
+    std::string debug_string() const override;
+
+private:
+    int64_t _source_id;
+    int64_t _begin;
+    int64_t _end;
+};
+
+using MorselPtr = std::unique_ptr<Morsel>;
+using Morsels = std::vector<MorselPtr>;
+
+class MorselQueue {
+public:
+    virtual ~MorselQueue() = default;
+
+    // Returns the next morsel, or nullptr once the queue is drained.
+    // Thread-safe.
+    virtual MorselPtr try_get() = 0;
+    virtual bool empty() const = 0;
+    virtual size_t num_original_morsels() const = 0;
+};
+
+using MorselQueuePtr = std::shared_ptr<MorselQueue>;
+
+// Hands out a precomputed list of morsels with a single atomic cursor.
+class FixedMorselQueue final : public MorselQueue {
+public:
+    explicit FixedMorselQueue(Morsels morsels) : _morsels(std::move(morsels)) {}
+
+    MorselPtr try_get() override;
+    bool empty() const override { return _next.load(std::memory_order_acquire) >= _morsels.size(); }
+    size_t num_original_morsels() const override { return _morsels.size(); }
+
+private:
+    Morsels _morsels;
+    std::atomic<size_t> _next{0};
+};
+
+// Cuts each (source_id, num_rows) range into ScanRangeMorsels of at most
+// |rows_per_morsel| rows.
+struct ScanRange {
+    int64_t source_id;
+    int64_t num_rows;
+};
+Morsels split_scan_ranges(int32_t plan_node_id, const std::vector<ScanRange>& ranges, int64_t rows_per_morsel);
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,260 @@
+#include "exec/pipeline/scan/scan_operator.h"
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "runtime/current_thread.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::pipeline {
+
+ScanOperator::ScanOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                           MorselQueuePtr morsel_queue, ChunkSourceFactory source_factory, ThreadPool* io_pool,
+                           io::AsyncIoEngine* io_engine, RuntimeFilterProbeCollectorPtr runtime_filters)
+        : SourceOperator(factory, id, "scan", plan_node_id, driver_sequence),
+          _morsel_queue(std::move(morsel_queue)),
+          _source_factory(std::move(source_factory)),
+          _io_pool(io_pool),
+          _io_engine(io_engine),
+          _runtime_filters(std::move(runtime_filters)),
+          _slots(std::max(config::scan_max_io_tasks_per_operator, 1)) {}
+
+ScanOperator::~ScanOperator() = default;
+
+Status ScanOperator::prepare(RuntimeState* state) {
+    _state = state;
+    if (_runtime_filters != nullptr) {
+        _runtime_filters->start_waiting();
+    }
+    return Status::OK();
+}
+
+void ScanOperator::close(RuntimeState* state) {
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto& slot : _slots) {
+        if (slot.source != nullptr) {
+            slot.source->close(state);
+            slot.source.reset();
+        }
+    }
+    _chunk_buffer.clear();
+}
+
+bool ScanOperator::has_output() const {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_chunk_buffer.empty() || !_io_status.ok()) {
+        return true;
+    }
+    // Polled by the driver and the poller; keeps the I/O pipeline full.
+    const_cast<ScanOperator*>(this)->_trigger_io_locked();
+    return false;
+}
+
+bool ScanOperator::_is_finished_locked() const {
+    if (_is_finished) {
+        return true;
+    }
+    if (!_chunk_buffer.empty() || _num_running_io > 0 || !_io_status.ok()) {
+        return false;
+    }
+    for (const auto& slot : _slots) {
+        if (slot.source != nullptr) {
+            return false;
+        }
+    }
+    return _morsel_queue->empty();
+}
+
+bool ScanOperator::is_finished() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _is_finished_locked();
+}
+
+bool ScanOperator::pending_finish() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_running_io > 0;
+}
+
+Status ScanOperator::set_finished(RuntimeState* state) {
+    std::lock_guard<std::mutex> l(_lock);
+    _is_finished = true;
+    _chunk_buffer.clear();
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> ScanOperator::pull_chunk(RuntimeState* state) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_io_status.ok()) {
+        return _io_status;
+    }
+    ChunkPtr chunk;
+    if (!_chunk_buffer.empty()) {
+        chunk = std::move(_chunk_buffer.front());
+        _chunk_buffer.pop_front();
+    }
+    _trigger_io_locked();
+    return chunk;
+}
+
+void ScanOperator::_trigger_io_locked() {
+    if (_is_finished || !_io_status.ok() || _state == nullptr) {
+        return;
+    }
+    // Re-checked by the poller; the hub wakes it when the filters arrive.
+    if (_runtime_filters != nullptr && !_runtime_filters->is_wait_over()) {
+        return;
+    }
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        if (_chunk_buffer.size() + _num_running_io >= static_cast<size_t>(config::scan_chunk_buffer_limit)) {
+            return;
+        }
+        IoSlot& slot = _slots[i];
+        if (slot.running || (slot.source == nullptr && _morsel_queue->empty())) {
+            continue;
+        }
+        slot.running = true;
+        _num_running_io++;
+        Status st = _io_pool->submit([this, i] { _run_io_task(i); });
+        if (!st.ok()) {
+            slot.running = false;
+            _num_running_io--;
+            _io_status = st;
+            return;
+        }
+        _num_io_tasks++;
+    }
+}
+
+Status ScanOperator::_read_chunks(size_t slot_idx, std::vector<ChunkPtr>* chunks, bool* reading_ahead) {
+    // Only this task touches the slot's source while slot.running is set.
+    ChunkSourcePtr& source = _slots[slot_idx].source;
+    ScopedThreadMemTracker mem_scope(_state->instance_mem_tracker());
+    if (source == nullptr) {
+        MorselPtr morsel = _morsel_queue->try_get();
+        if (morsel == nullptr) {
+            return Status::OK();
+        }
+        source = _source_factory(std::move(morsel));
+        RETURN_IF_ERROR(source->prepare(_state));
+        // Nothing of a new source is in memory yet; the next task decodes it.
+        ASSIGN_OR_RETURN(*reading_ahead, _read_ahead(slot_idx));
+        if (*reading_ahead) {
+            return Status::OK();
+        }
+    }
+    for (int i = 0; i < config::scan_io_task_batch_chunks; ++i) {
+        if (_state->is_cancelled()) {
+            break;
+        }
+        ChunkPtr chunk;
+        Status st = source->get_next(_state, &chunk);
+        if (st.is_end_of_file()) {
+            source->close(_state);
+            source.reset();
+            break;
+        }
+        RETURN_IF_ERROR(st);
+        if (chunk != nullptr && chunk->num_rows() > 0) {
+            chunks->emplace_back(std::move(chunk));
+        }
+    }
+    if (source != nullptr) {
+        ASSIGN_OR_RETURN(*reading_ahead, _read_ahead(slot_idx));
+    }
+    return Status::OK();
+}
+
+StatusOr<bool> ScanOperator::_read_ahead(size_t slot_idx) {
+    if (_io_engine == nullptr || config::scan_read_ahead_bytes <= 0 || _state->is_cancelled()) {
+        return false;
+    }
+    // Counted before the reads start, since they may finish before the
+    // source even returns.
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _num_running_io++;
+    }
+    auto started = _slots[slot_idx].source->read_ahead(
+            _io_engine, config::scan_read_ahead_bytes,
+            [this, slot_idx](Status st) { _finish_read_ahead(slot_idx, st); });
+    std::lock_guard<std::mutex> l(_lock);
+    if (!started.ok() || !started.value()) {
+        _num_running_io--;
+    } else {
+        _num_read_aheads++;
+    }
+    return started;
+}
+
+void ScanOperator::_finish_read_ahead(size_t slot_idx, const Status& st) {
+    // As in _run_io_task(): |this| may go away once the counter drops.
+    PipelineDriverExecutor* executor = _state->fragment_ctx()->executor();
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (!st.ok() && _io_status.ok()) {
+            _io_status = st;
+        }
+        _slots[slot_idx].running = false;
+        _num_running_io--;
+    }
+    if (executor != nullptr) {
+        executor->wake_poller();
+    }
+}
+
+void ScanOperator::_run_io_task(size_t slot_idx) {
+    int64_t start = monotonic_nanos();
+    std::vector<ChunkPtr> chunks;
+    bool reading_ahead = false;
+    // Reads run with the fragment's tracker installed, which must be gone
+    // from this thread before the counter below lets the fragment finish.
+    Status st = _read_chunks(slot_idx, &chunks, &reading_ahead);
+
+    // The executor outlives every fragment, unlike |this| once the counter
+    // below drops to zero, so grab it first.
+    PipelineDriverExecutor* executor = _state->fragment_ctx()->executor();
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _io_time_ns += monotonic_nanos() - start;
+        if (!st.ok() && _io_status.ok()) {
+            _io_status = st;
+        }
+        if (!_is_finished) {
+            for (auto& chunk : chunks) {
+                _chunk_buffer.emplace_back(std::move(chunk));
+            }
+        }
+        // A read-ahead in flight owns the slot now, and may even have
+        // released it already.
+        if (!reading_ahead) {
+            _slots[slot_idx].running = false;
+        }
+        _num_running_io--;
+    }
+    if (executor != nullptr) {
+        executor->wake_poller();
+    }
+}
+
+ScanOperatorFactory::ScanOperatorFactory(int32_t id, int32_t plan_node_id, MorselQueuePtr morsel_queue,
+                                         ChunkSourceFactory source_factory, ThreadPool* io_pool,
+                                         io::AsyncIoEngine* io_engine)
+        : SourceOperatorFactory(id, "scan", plan_node_id),
+          _morsel_queue(std::move(morsel_queue)),
+          _source_factory(std::move(source_factory)),
+          _io_pool(io_pool),
+          _io_engine(io_engine) {}
+
+Status ScanOperatorFactory::prepare(RuntimeState* state) {
+    if (_runtime_filters != nullptr) {
+        state->fragment_ctx()->runtime_filter_hub()->subscribe(_runtime_filters);
+    }
+    return Status::OK();
+}
+
+OperatorPtr ScanOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<ScanOperator>(this, _id, _plan_node_id, driver_sequence, _morsel_queue, _source_factory,
+                                          _io_pool, _io_engine, _runtime_filters);
+}
+
+} // namespace starrocks::pipeline
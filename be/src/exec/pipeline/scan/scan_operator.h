@@ -0,0 +1,118 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "exec/pipeline/operator.h"
+#include "exec/pipeline/runtime_filter_hub.h"
+#include "exec/pipeline/scan/chunk_source.h"
+#include "util/threadpool.h"
+
+namespace starrocks::pipeline {
+
+// Source operator that reads morsels asynchronously.
+//
+// Reading is done by I/O tasks on a dedicated thread pool; each task owns one
+// ChunkSource (one morsel) and appends the chunks it reads to the operator's
+// buffer. The driver only ever pops that buffer: when it is empty,
+// has_output() returns false and the driver parks in the poller until an I/O
+// task completes and wakes it, so storage latency never holds a worker.
+// Up to config::scan_max_io_tasks_per_operator tasks run at once and none is
+// started while config::scan_chunk_buffer_limit chunks are already buffered.
+//
+// Given an AsyncIoEngine, a task does not leave its source to read pages one
+// by one as it decodes them: before returning it has the source read ahead
+// what it decodes next, as one batch of reads in flight together. The slot
+// then stays busy until the engine reports the batch done, which wakes the
+// poller like a finished task, and the next task decodes from memory.
+//
+// A scan on the probe side of hash joins holds off reading until the joins'
+// runtime filters have arrived, or config::runtime_filter_wait_timeout_ms has
+// passed; sources opened from then on apply the filters that are there.
+class ScanOperator final : public SourceOperator {
+public:
+    ScanOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                 MorselQueuePtr morsel_queue, ChunkSourceFactory source_factory, ThreadPool* io_pool,
+                 io::AsyncIoEngine* io_engine = nullptr, RuntimeFilterProbeCollectorPtr runtime_filters = nullptr);
+    ~ScanOperator() override;
+
+    Status prepare(RuntimeState* state) override;
+    void close(RuntimeState* state) override;
+
+    bool has_output() const override;
+    bool is_finished() const override;
+    bool pending_finish() const override;
+
+    Status set_finished(RuntimeState* state) override;
+
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override;
+
+    int64_t num_io_tasks() const { return _num_io_tasks; }
+    int64_t io_time_ns() const { return _io_time_ns; }
+    int64_t num_read_aheads() const { return _num_read_aheads; }
+
+private:
+    struct IoSlot {
+        ChunkSourcePtr source;
+        bool running = false;
+    };
+
+    // Starts I/O tasks for idle slots while the buffer has room. Requires _lock.
+    void _trigger_io_locked();
+    // Reads up to config::scan_io_task_batch_chunks chunks from the slot's source,
+    // opening a source on the next morsel first if the slot has none. Sets
+    // |reading_ahead| if the source was left reading ahead.
+    Status _read_chunks(size_t slot_idx, std::vector<ChunkPtr>* chunks, bool* reading_ahead);
+    // Has the slot's source read ahead; the slot is released by
+    // _finish_read_ahead() instead of by the task if reads started.
+    StatusOr<bool> _read_ahead(size_t slot_idx);
+    void _finish_read_ahead(size_t slot_idx, const Status& st);
+    void _run_io_task(size_t slot_idx);
+    bool _is_finished_locked() const;
+
+    MorselQueuePtr _morsel_queue;
+    ChunkSourceFactory _source_factory;
+    ThreadPool* _io_pool;
+    io::AsyncIoEngine* _io_engine;
+    RuntimeFilterProbeCollectorPtr _runtime_filters;
+    RuntimeState* _state = nullptr;
+
+    mutable std::mutex _lock;
+    std::deque<ChunkPtr> _chunk_buffer;
+    std::vector<IoSlot> _slots;
+    // I/O tasks and read-aheads in flight.
+    int _num_running_io = 0;
+    bool _is_finished = false;
+    Status _io_status;
+
+    int64_t _num_io_tasks = 0;
+    int64_t _io_time_ns = 0;
+    int64_t _num_read_aheads = 0;
+};
+
+class ScanOperatorFactory final : public SourceOperatorFactory {
+public:
+    ScanOperatorFactory(int32_t id, int32_t plan_node_id, MorselQueuePtr morsel_queue,
+                        ChunkSourceFactory source_factory, ThreadPool* io_pool, io::AsyncIoEngine* io_engine = nullptr);
+
+    // The runtime filters the scan waits for; the same collector should be
+    // given to the source factory, which applies them. Set before prepare().
+    void set_runtime_filters(RuntimeFilterProbeCollectorPtr runtime_filters) {
+        _runtime_filters = std::move(runtime_filters);
+    }
+
+    Status prepare(RuntimeState* state) override;
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+    const MorselQueuePtr& morsel_queue() const { return _morsel_queue; }
+
+private:
+    MorselQueuePtr _morsel_queue;
+    ChunkSourceFactory _source_factory;
+    ThreadPool* _io_pool;
+    io::AsyncIoEngine* _io_engine;
+    RuntimeFilterProbeCollectorPtr _runtime_filters;
+};
+
+} // namespace starrocks::pipeline
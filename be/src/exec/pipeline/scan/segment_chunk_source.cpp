@@ -0,0 +1,84 @@
+#include "exec/pipeline/scan/segment_chunk_source.h"
+
+#include <unordered_set>
+
+namespace starrocks::pipeline {
+
+SegmentChunkSource::SegmentChunkSource(MorselPtr morsel, SegmentSharedPtr segment, SegmentReadOptions options)
+        : ChunkSource(std::move(morsel)) {
+    const auto* range = static_cast<const ScanRangeMorsel*>(_morsel.get());
+    options.range_begin = range->begin();
+    options.range_end = range->end();
+    _iterator = std::make_unique<SegmentIterator>(std::move(segment), std::move(options));
+}
+
+Status SegmentChunkSource::prepare(RuntimeState* state) {
+    return _iterator->init();
+}
+
+Status SegmentChunkSource::get_next(RuntimeState* state, ChunkPtr* chunk) {
+    return _iterator->get_next(chunk);
+}
+
+StatusOr<bool> SegmentChunkSource::read_ahead(io::AsyncIoEngine* engine, int64_t max_bytes, io::ReadCallback done) {
+    return _iterator->read_ahead(engine, max_bytes, std::move(done));
+}
+
+void SegmentChunkSource::close(RuntimeState* state) {}
+
+std::vector<ScanRange> segment_scan_ranges(const std::vector<SegmentSharedPtr>& segments) {
+    std::vector<ScanRange> ranges;
+    ranges.reserve(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        ranges.push_back(ScanRange{static_cast<int64_t>(i), segments[i]->num_rows()});
+    }
+    return ranges;
+}
+
+ChunkSourceFactory segment_chunk_source_factory(std::vector<SegmentSharedPtr> segments, SegmentReadOptions options,
+                                                RuntimeFilterProbeCollectorPtr runtime_filters,
+                                                std::vector<DelVectorPtr> del_vectors) {
+    // Filters of other dictionary codes than a column is read as, or of codes
+    // where it is read as words, would compare unrelated values.
+    std::unordered_set<ColumnId> mismatched_dict_columns;
+    if (runtime_filters != nullptr) {
+        for (const auto& desc : runtime_filters->descriptors()) {
+            auto dict = options.global_dicts.find(desc.column_id);
+            uint64_t dict_id = dict != options.global_dicts.end() && dict->second != nullptr ? dict->second->id() : 0;
+            if (desc.dict_id != dict_id) {
+                mismatched_dict_columns.insert(desc.column_id);
+            }
+        }
+    }
+    // The collector owns the runtime filters' predicates, so the factory
+    // holds on to it.
+    return [segments = std::move(segments), options = std::move(options),
+            mismatched_dict_columns = std::move(mismatched_dict_columns),
+            runtime_filters = std::move(runtime_filters),
+            del_vectors = std::move(del_vectors)](MorselPtr morsel) -> ChunkSourcePtr {
+        const auto* range = static_cast<const ScanRangeMorsel*>(morsel.get());
+        SegmentSharedPtr segment = segments[range->source_id()];
+        SegmentReadOptions source_options = options;
+        if (!del_vectors.empty()) {
+            source_options.del_vector = del_vectors[range->source_id()];
+        }
+        if (runtime_filters != nullptr) {
+            std::vector<const ColumnPredicate*> predicates;
+            runtime_filters->get_predicates(&predicates);
+            const RowDescriptor& schema = segment->schema();
+            for (const ColumnPredicate* predicate : predicates) {
+                ColumnId id = predicate->column_id();
+                if (id >= schema.size()) {
+                    continue;
+                }
+                LogicalType type = options.global_dicts.count(id) > 0 ? TYPE_INT : schema[id].type;
+                if (type == predicate->logical_type() && !mismatched_dict_columns.count(id)) {
+                    source_options.predicates.push_back(predicate);
+                }
+            }
+        }
+        return std::make_unique<SegmentChunkSource>(std::move(morsel), std::move(segment), std::move(source_options));
+    };
+}
+
+} // namespace starrocks::pipeline
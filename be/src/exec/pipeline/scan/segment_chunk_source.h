@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "exec/pipeline/runtime_filter_hub.h"
+#include "exec/pipeline/scan/chunk_source.h"
+#include "storage/segment/segment_iterator.h"
+
+namespace starrocks::pipeline {
+
+// Reads the rows of a ScanRangeMorsel from a segment file; the morsel's
+// source_id is the index of the segment in the scan's segment list.
+class SegmentChunkSource final : public ChunkSource {
+public:
+    SegmentChunkSource(MorselPtr morsel, SegmentSharedPtr segment, SegmentReadOptions options);
+
+    Status prepare(RuntimeState* state) override;
+    Status get_next(RuntimeState* state, ChunkPtr* chunk) override;
+    StatusOr<bool> read_ahead(io::AsyncIoEngine* engine, int64_t max_bytes, io::ReadCallback done) override;
+    void close(RuntimeState* state) override;
+
+    const SegmentReadStats& stats() const { return _iterator->stats(); }
+
+private:
+    std::unique_ptr<SegmentIterator> _iterator;
+};
+
+// One ScanRange per segment, to be cut into morsels by split_scan_ranges().
+std::vector<ScanRange> segment_scan_ranges(const std::vector<SegmentSharedPtr>& segments);
+
+// Sources reading |options.column_ids| of |segments|; the morsel's rows
+// replace the options' range. The predicates must outlive the scan. Each
+// source also applies the |runtime_filters| arrived by the time it is opened,
+// those on a column of another type or dictionary (see RuntimeFilterProbe-
+// Descriptor::dict_id) than the one read excepted. The rows of
+// segments[i] deleted by del_vectors[i], if given, are skipped (see
+// PrimaryKeyTableVersion).
+ChunkSourceFactory segment_chunk_source_factory(std::vector<SegmentSharedPtr> segments, SegmentReadOptions options,
+                                                RuntimeFilterProbeCollectorPtr runtime_filters = nullptr,
+                                                std::vector<DelVectorPtr> del_vectors = {});
+
+} // namespace starrocks::pipeline
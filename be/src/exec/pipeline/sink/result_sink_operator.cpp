@@ -0,0 +1,27 @@
+#include "exec/pipeline/sink/result_sink_operator.h"
+
+namespace starrocks::pipeline {
+
+void ResultCollector::add(ChunkPtr chunk) {
+    std::lock_guard<std::mutex> l(_lock);
+    _num_rows += chunk->num_rows();
+    _chunks.emplace_back(std::move(chunk));
+}
+
+std::vector<ChunkPtr> ResultCollector::take_chunks() {
+    std::lock_guard<std::mutex> l(_lock);
+    _num_rows = 0;
+    return std::move(_chunks);
+}
+
+size_t ResultCollector::num_rows() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_rows;
+}
+
+Status ResultSinkOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    _collector->add(chunk);
+    return Status::OK();
+}
+
+} // namespace starrocks::pipeline
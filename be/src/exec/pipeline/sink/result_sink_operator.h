@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "exec/pipeline/operator.h"
+
+namespace starrocks::pipeline {
+
+// Thread-safe destination of a fragment's final rows. Every driver of the
+// result pipeline appends to the same collector.
+class ResultCollector {
+public:
+    void add(ChunkPtr chunk);
+
+    // Moves the collected chunks out; the order across drivers is unspecified.
+    std::vector<ChunkPtr> take_chunks();
+    size_t num_rows() const;
+
+private:
+    mutable std::mutex _lock;
+    std::vector<ChunkPtr> _chunks;
+    size_t _num_rows = 0;
+};
+
+using ResultCollectorPtr = std::shared_ptr<ResultCollector>;
+
+class ResultSinkOperator final : public Operator {
+public:
+    ResultSinkOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                       ResultCollectorPtr collector)
+            : Operator(factory, id, "result_sink", plan_node_id, driver_sequence), _collector(std::move(collector)) {}
+
+    bool has_output() const override { return false; }
+    bool need_input() const override { return !_is_finished; }
+    bool is_finished() const override { return _is_finished; }
+
+    Status set_finishing(RuntimeState* state) override {
+        _is_finished = true;
+        return Status::OK();
+    }
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override {
+        return Status::InternalError("result sink does not produce output");
+    }
+
+private:
+    ResultCollectorPtr _collector;
+    bool _is_finished = false;
+};
+
+class ResultSinkOperatorFactory final : public OperatorFactory {
+public:
+    ResultSinkOperatorFactory(int32_t id, int32_t plan_node_id, ResultCollectorPtr collector)
+            : OperatorFactory(id, "result_sink", plan_node_id), _collector(std::move(collector)) {}
+
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override {
+        return std::make_shared<ResultSinkOperator>(this, _id, _plan_node_id, driver_sequence, _collector);
+    }
+
+private:
+    ResultCollectorPtr _collector;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,33 @@
+#include "exec/pipeline/sort/sort_sink_operator.h"
+
+namespace starrocks::pipeline {
+
+Status SortSinkOperator::prepare(RuntimeState* state) {
+    _sorter = _sort_ctx->create_sorter();
+    return Status::OK();
+}
+
+Status SortSinkOperator::set_finishing(RuntimeState* state) {
+    if (_is_finished) {
+        return Status::OK();
+    }
+    _is_finished = true;
+    if (state->is_cancelled()) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_sorter->done(state));
+    _sorter.reset();
+    _sort_ctx->finish_sink(state);
+    return Status::OK();
+}
+
+Status SortSinkOperator::push_chunk(RuntimeState* state, const ChunkPtr& chunk) {
+    return _sorter->append(state, chunk);
+}
+
+OperatorPtr SortSinkOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    _sort_ctx->set_num_sinkers(degree_of_parallelism);
+    return std::make_shared<SortSinkOperator>(this, _id, _plan_node_id, driver_sequence, _sort_ctx);
+}
+
+} // namespace starrocks::pipeline
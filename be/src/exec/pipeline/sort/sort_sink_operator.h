@@ -0,0 +1,50 @@
+#pragma once
+
+#include "exec/pipeline/operator.h"
+#include "exec/sort_context.h"
+
+namespace starrocks::pipeline {
+
+// Sink of an ORDER BY: sorts the driver's input into runs with a ChunksSorter
+// of its own, and hands them to the shared SortContext once the input is
+// exhausted.
+class SortSinkOperator final : public Operator {
+public:
+    SortSinkOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                     SortContextPtr sort_ctx)
+            : Operator(factory, id, "sort_sink", plan_node_id, driver_sequence), _sort_ctx(std::move(sort_ctx)) {}
+
+    Status prepare(RuntimeState* state) override;
+    void close(RuntimeState* state) override { _sorter.reset(); }
+
+    bool has_output() const override { return false; }
+    bool need_input() const override { return !_is_finished && !_sort_ctx->is_spill_backlogged(); }
+    bool is_finished() const override { return _is_finished; }
+    bool pending_finish() const override { return _sort_ctx->has_pending_spill_writes(); }
+
+    Status set_finishing(RuntimeState* state) override;
+
+    Status push_chunk(RuntimeState* state, const ChunkPtr& chunk) override;
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override {
+        return Status::InternalError("sort sink does not produce output");
+    }
+
+private:
+    SortContextPtr _sort_ctx;
+    std::unique_ptr<ChunksSorter> _sorter;
+    bool _is_finished = false;
+};
+
+class SortSinkOperatorFactory final : public OperatorFactory {
+public:
+    SortSinkOperatorFactory(int32_t id, int32_t plan_node_id, SortContextPtr sort_ctx)
+            : OperatorFactory(id, "sort_sink", plan_node_id), _sort_ctx(std::move(sort_ctx)) {}
+
+    Status prepare(RuntimeState* state) override { return _sort_ctx->prepare(); }
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    SortContextPtr _sort_ctx;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,9 @@
+#include "exec/pipeline/sort/sort_source_operator.h"
+
+namespace starrocks::pipeline {
+
+OperatorPtr SortSourceOperatorFactory::create(int32_t degree_of_parallelism, int32_t driver_sequence) {
+    return std::make_shared<SortSourceOperator>(this, _id, _plan_node_id, driver_sequence, _sort_ctx);
+}
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "exec/pipeline/operator.h"
+#include "exec/sort_context.h"
+
+namespace starrocks::pipeline {
+
+// Emits the result of an ORDER BY by merging the runs of all its sink
+// drivers. Has no output until the last of them is done and its spilled runs
+// are on disk; its pipeline runs a single driver.
+class SortSourceOperator final : public SourceOperator {
+public:
+    SortSourceOperator(OperatorFactory* factory, int32_t id, int32_t plan_node_id, int32_t driver_sequence,
+                       SortContextPtr sort_ctx)
+            : SourceOperator(factory, id, "sort_source", plan_node_id, driver_sequence),
+              _sort_ctx(std::move(sort_ctx)) {}
+
+    bool has_output() const override {
+        return !_is_finished && _sort_ctx->is_sink_complete() && !_sort_ctx->is_output_done();
+    }
+    bool is_finished() const override {
+        return _is_finished || (_sort_ctx->is_sink_complete() && _sort_ctx->is_output_done());
+    }
+
+    Status set_finished(RuntimeState* state) override {
+        _is_finished = true;
+        return Status::OK();
+    }
+
+    StatusOr<ChunkPtr> pull_chunk(RuntimeState* state) override { return _sort_ctx->next_output(state); }
+
+private:
+    SortContextPtr _sort_ctx;
+    bool _is_finished = false;
+};
+
+class SortSourceOperatorFactory final : public SourceOperatorFactory {
+public:
+    SortSourceOperatorFactory(int32_t id, int32_t plan_node_id, SortContextPtr sort_ctx)
+            : SourceOperatorFactory(id, "sort_source", plan_node_id), _sort_ctx(std::move(sort_ctx)) {}
+
+    Status prepare(RuntimeState* state) override { return _sort_ctx->prepare(); }
+    OperatorPtr create(int32_t degree_of_parallelism, int32_t driver_sequence) override;
+
+private:
+    SortContextPtr _sort_ctx;
+};
+
+} // namespace starrocks::pipeline
@@ -0,0 +1,407 @@
+#include "exec/runtime_filter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "column/const_column.h"
+#include "common/config.h"
+#include "exec/spill/spill_serde.h"
+#include "util/coding.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+namespace {
+
+enum RuntimeFilterFlag : uint8_t {
+    kHasValue = 1,
+    kHasValues = 2,
+    kHasBloom = 4,
+};
+
+void serialize_column(LogicalType type, const ColumnPtr& column, Buffer<uint8_t>* dst) {
+    RowDescriptor desc{{0, type, false}};
+    Chunk chunk;
+    chunk.append_column(column, 0);
+    Buffer<uint8_t> bytes;
+    spill::serialize_chunk(chunk, desc, &bytes);
+    put_varint64(dst, column->size());
+    put_length_prefixed_slice(dst, Slice(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+}
+
+StatusOr<ColumnPtr> deserialize_column(LogicalType type, Slice* input) {
+    uint64_t num_rows = 0;
+    Slice bytes;
+    if (!get_varint64(input, &num_rows) || !get_length_prefixed_slice(input, &bytes)) {
+        return Status::Corruption("truncated runtime filter");
+    }
+    RowDescriptor desc{{0, type, false}};
+    ASSIGN_OR_RETURN(ChunkPtr chunk, spill::deserialize_chunk(reinterpret_cast<const uint8_t*>(bytes.data),
+                                                              bytes.size, num_rows, desc));
+    return chunk->get_column_by_slot_id(0);
+}
+
+} // namespace
+
+template <LogicalType LT>
+struct RuntimeFilterHelper {
+    using CppType = RunTimeCppType<LT>;
+    using Hash = std::conditional_t<LT == TYPE_VARCHAR, SliceHash, std::hash<CppType>>;
+    using ValueSet = std::unordered_set<CppType, Hash>;
+
+    static ALWAYS_INLINE uint64_t hash(const CppType& value) {
+        if constexpr (LT == TYPE_VARCHAR) {
+            return HashUtil::hash_bytes(value.data, value.size);
+        } else {
+            uint64_t bits = 0;
+            memcpy(&bits, &value, sizeof(value));
+            return HashUtil::hash64(bits);
+        }
+    }
+
+    // |data| is a data column, never nullable.
+    static ALWAYS_INLINE CppType value_at(const Column* data, size_t idx) {
+        if constexpr (LT == TYPE_VARCHAR) {
+            return static_cast<const BinaryColumn*>(data)->get_slice(idx);
+        } else {
+            return reinterpret_cast<const CppType*>(data->raw_data())[idx];
+        }
+    }
+
+    static ColumnPtr new_column(const CppType* values, size_t n) {
+        ColumnPtr column = ColumnHelper::create_column(LT, false);
+        column->reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            column->append_datum(Datum(values[i]));
+        }
+        return column;
+    }
+
+    static ColumnPtr new_column(const ValueSet& set) {
+        std::vector<CppType> values(set.begin(), set.end());
+        return new_column(values.data(), values.size());
+    }
+
+    static void set_bounds(RuntimeFilter* filter, const CppType& min, const CppType& max) {
+        CppType bounds[2] = {min, max};
+        filter->_bounds = new_column(bounds, 2);
+    }
+
+    static void insert_values(const Column& values, BlockBloomFilter* bloom) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            bloom->insert_hash(hash(value_at(&values, i)));
+        }
+    }
+
+    static void new_bloom(const ValueSet& set, RuntimeFilter* filter) {
+        filter->_bloom.init(set.size(), config::runtime_filter_bloom_bits_per_value,
+                            config::runtime_filter_bloom_max_bytes);
+        for (const auto& v : set) {
+            filter->_bloom.insert_hash(hash(v));
+        }
+    }
+
+    static std::shared_ptr<RuntimeFilter> create(const Column& column, size_t from) {
+        std::shared_ptr<RuntimeFilter> filter(new RuntimeFilter(LT));
+        const Column* data = ColumnHelper::get_data_column(&column);
+        const NullData* nulls = ColumnHelper::get_null_data(&column);
+        size_t num_rows = column.size();
+        auto max_values = static_cast<size_t>(std::max(config::runtime_filter_in_max_values, 0));
+
+        ValueSet set;
+        bool exact = true;
+        size_t num_values = 0;
+        CppType min{};
+        CppType max{};
+        for (size_t i = from; i < num_rows; ++i) {
+            if (nulls != nullptr && (*nulls)[i]) {
+                continue;
+            }
+            CppType v = value_at(data, i);
+            if (num_values++ == 0) {
+                min = max = v;
+            } else {
+                min = std::min(min, v);
+                max = std::max(max, v);
+            }
+            if (exact) {
+                set.insert(v);
+                if (set.size() > max_values) {
+                    exact = false;
+                    set = ValueSet();
+                }
+            }
+        }
+        if (num_values == 0) {
+            return filter;
+        }
+        set_bounds(filter.get(), min, max);
+        if (exact) {
+            filter->_values = new_column(set);
+            return filter;
+        }
+        filter->_bloom.init(num_values, config::runtime_filter_bloom_bits_per_value,
+                            config::runtime_filter_bloom_max_bytes);
+        for (size_t i = from; i < num_rows; ++i) {
+            if (nulls == nullptr || !(*nulls)[i]) {
+                filter->_bloom.insert_hash(hash(value_at(data, i)));
+            }
+        }
+        return filter;
+    }
+
+    static std::shared_ptr<RuntimeFilter> merge(const RuntimeFilter& a, const RuntimeFilter& b) {
+        // Columns are never modified, so the copies share them.
+        if (a.is_empty() || b.is_empty()) {
+            return std::shared_ptr<RuntimeFilter>(new RuntimeFilter(a.is_empty() ? b : a));
+        }
+        std::shared_ptr<RuntimeFilter> filter(new RuntimeFilter(LT));
+        set_bounds(filter.get(), std::min(value_at(a._bounds.get(), 0), value_at(b._bounds.get(), 0)),
+                   std::max(value_at(a._bounds.get(), 1), value_at(b._bounds.get(), 1)));
+        if (a._values != nullptr && b._values != nullptr) {
+            ValueSet set;
+            for (const auto* values : {a._values.get(), b._values.get()}) {
+                for (size_t i = 0; i < values->size(); ++i) {
+                    set.insert(value_at(values, i));
+                }
+            }
+            if (set.size() <= static_cast<size_t>(std::max(config::runtime_filter_in_max_values, 0))) {
+                filter->_values = new_column(set);
+            } else {
+                new_bloom(set, filter.get());
+            }
+            return filter;
+        }
+        const RuntimeFilter& bloom = a._values == nullptr ? a : b;
+        const RuntimeFilter& other = a._values == nullptr ? b : a;
+        filter->_bloom = bloom._bloom;
+        if (other._values != nullptr) {
+            insert_values(*other._values, &filter->_bloom);
+        } else {
+            filter->_bloom.merge(other._bloom);
+        }
+        return filter;
+    }
+};
+
+// Passes the rows whose value is within the filter's bounds and in its
+// IN-set or bloom filter; the range check comes first, as one branch-free
+// pass, and only rows inside the range are looked up.
+template <LogicalType LT>
+class RuntimeFilterPredicate final : public ColumnPredicate {
+public:
+    using Helper = RuntimeFilterHelper<LT>;
+    using CppType = typename Helper::CppType;
+
+    RuntimeFilterPredicate(RuntimeFilterPtr filter, ColumnId id)
+            : ColumnPredicate(LT, id), _filter(std::move(filter)), _is_empty(_filter->is_empty()) {
+        if (_is_empty) {
+            return;
+        }
+        // Slices point into the filter's columns, which _filter keeps alive.
+        _min = Helper::value_at(_filter->_bounds.get(), 0);
+        _max = Helper::value_at(_filter->_bounds.get(), 1);
+        if (const Column* values = _filter->values(); values != nullptr) {
+            _is_exact = true;
+            for (size_t i = 0; i < values->size(); ++i) {
+                _set.insert(Helper::value_at(values, i));
+            }
+        }
+    }
+
+    PredicateType type() const override { return PredicateType::kRuntimeFilter; }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (column->is_constant()) {
+            const Column* value = static_cast<const ConstColumn*>(column)->data_column().get();
+            bool res = !value->only_null() && _pass(Helper::value_at(ColumnHelper::get_data_column(value), 0));
+            memset(selection + from, res, to - from);
+            return;
+        }
+        if (_is_empty) {
+            memset(selection + from, 0, to - from);
+            return;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        for (size_t i = from; i < to; ++i) {
+            CppType v = Helper::value_at(data, i);
+            selection[i] = !(v < _min) & !(_max < v);
+        }
+        for (size_t i = from; i < to; ++i) {
+            if (selection[i]) {
+                selection[i] = _contains(Helper::value_at(data, i));
+            }
+        }
+        clear_null_rows(column, selection, from, to);
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            uint8_t res = 0;
+            evaluate(column, &res, 0, 1);
+            return res ? sel_size : 0;
+        }
+        if (_is_empty) {
+            return 0;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            count += (nulls == nullptr || !(*nulls)[row]) && _pass(Helper::value_at(data, row));
+        }
+        return count;
+    }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        if (_is_empty || !zone_map.has_not_null) {
+            return false;
+        }
+        const auto& min = zone_map.min.get<CppType>();
+        const auto& max = zone_map.max.get<CppType>();
+        if (max < _min || _max < min) {
+            return false;
+        }
+        if (!_is_exact) {
+            return true;
+        }
+        for (const auto& v : _set) {
+            if (!(v < min) && !(max < v)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string debug_string() const override {
+        return "(column(" + std::to_string(_column_id) + ") " + predicate_type_name(type()) + " " +
+               _filter->debug_string() + ")";
+    }
+
+private:
+    ALWAYS_INLINE bool _contains(const CppType& v) const {
+        return _is_exact ? _set.count(v) > 0 : _filter->bloom().test_hash(Helper::hash(v));
+    }
+    ALWAYS_INLINE bool _pass(const CppType& v) const {
+        return !_is_empty && !(v < _min) && !(_max < v) && _contains(v);
+    }
+
+    const RuntimeFilterPtr _filter;
+    const bool _is_empty;
+    bool _is_exact = false;
+    CppType _min{};
+    CppType _max{};
+    typename Helper::ValueSet _set;
+};
+
+std::shared_ptr<RuntimeFilter> RuntimeFilter::create(LogicalType type, const Column& column, size_t from,
+                                                     uint64_t dict_id) {
+    auto filter = type_dispatch_all(type, [&](auto lt) {
+        return RuntimeFilterHelper<decltype(lt)::value>::create(column, from);
+    });
+    filter->_dict_id = dict_id;
+    return filter;
+}
+
+StatusOr<std::shared_ptr<RuntimeFilter>> RuntimeFilter::merge(const RuntimeFilter& a, const RuntimeFilter& b) {
+    if (a._type != b._type) {
+        return Status::InvalidArgument("cannot merge runtime filters of types " + logical_type_to_string(a._type) +
+                                       " and " + logical_type_to_string(b._type));
+    }
+    if (a._dict_id != b._dict_id) {
+        return Status::InvalidArgument("cannot merge runtime filters of codes of different global dictionaries");
+    }
+    std::shared_ptr<RuntimeFilter> filter = type_dispatch_all(
+            a._type, [&](auto lt) { return RuntimeFilterHelper<decltype(lt)::value>::merge(a, b); });
+    filter->_dict_id = a._dict_id;
+    return filter;
+}
+
+void RuntimeFilter::serialize(Buffer<uint8_t>* dst) const {
+    uint8_t flags = 0;
+    if (!is_empty()) {
+        flags |= kHasValue;
+        flags |= _values != nullptr ? kHasValues : kHasBloom;
+    }
+    put_fixed8(dst, static_cast<uint8_t>(_type));
+    put_fixed8(dst, flags);
+    put_fixed64(dst, _dict_id);
+    if (flags & kHasValue) {
+        serialize_column(_type, _bounds, dst);
+    }
+    if (flags & kHasValues) {
+        serialize_column(_type, _values, dst);
+    }
+    if (flags & kHasBloom) {
+        put_length_prefixed_slice(dst, Slice(reinterpret_cast<const char*>(_bloom.data()), _bloom.size_bytes()));
+    }
+}
+
+StatusOr<std::shared_ptr<RuntimeFilter>> RuntimeFilter::deserialize(Slice* input) {
+    uint8_t type = 0;
+    uint8_t flags = 0;
+    uint64_t dict_id = 0;
+    if (!get_fixed8(input, &type) || !get_fixed8(input, &flags) || !get_fixed64(input, &dict_id)) {
+        return Status::Corruption("truncated runtime filter");
+    }
+    auto logical_type = static_cast<LogicalType>(type);
+    if (logical_type > TYPE_VARCHAR || !is_supported_type(logical_type)) {
+        return Status::Corruption("runtime filter of unsupported type " + std::to_string(type));
+    }
+    std::shared_ptr<RuntimeFilter> filter(new RuntimeFilter(logical_type));
+    filter->_dict_id = dict_id;
+    if (!(flags & kHasValue)) {
+        return filter;
+    }
+    ASSIGN_OR_RETURN(filter->_bounds, deserialize_column(logical_type, input));
+    if (filter->_bounds->size() != 2) {
+        return Status::Corruption("runtime filter bounds of " + std::to_string(filter->_bounds->size()) + " rows");
+    }
+    if (flags & kHasValues) {
+        ASSIGN_OR_RETURN(filter->_values, deserialize_column(logical_type, input));
+    } else {
+        Slice bloom;
+        if (!get_length_prefixed_slice(input, &bloom)) {
+            return Status::Corruption("truncated runtime filter");
+        }
+        RETURN_IF_ERROR(filter->_bloom.init_from(bloom));
+    }
+    return filter;
+}
+
+size_t RuntimeFilter::memory_usage() const {
+    size_t usage = _bloom.size_bytes();
+    if (_bounds != nullptr) {
+        usage += _bounds->memory_usage();
+    }
+    if (_values != nullptr) {
+        usage += _values->memory_usage();
+    }
+    return usage;
+}
+
+std::string RuntimeFilter::debug_string() const {
+    if (is_empty()) {
+        return "EMPTY";
+    }
+    std::string res = "[" + _bounds->debug_item(0) + ", " + _bounds->debug_item(1) + "]";
+    if (_values != nullptr) {
+        res += " IN(" + std::to_string(_values->size()) + " values)";
+    } else {
+        res += " BLOOM(" + std::to_string(_bloom.size_bytes()) + " bytes)";
+    }
+    return res;
+}
+
+ColumnPredicatePtr new_runtime_filter_predicate(RuntimeFilterPtr filter, ColumnId id) {
+    return type_dispatch_all(filter->type(), [&](auto lt) -> ColumnPredicatePtr {
+        return std::make_unique<RuntimeFilterPredicate<decltype(lt)::value>>(std::move(filter), id);
+    });
+}
+
+} // namespace starrocks
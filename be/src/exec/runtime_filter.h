@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column/column.h"
+#include "column/datum.h"
+#include "common/status.h"
+#include "storage/column_predicate.h"
+#include "util/bloom_filter.h"
+
+namespace starrocks {
+
+// A runtime filter the planner attached to a hash join: once the join's build
+// side is complete, the join summarizes one of its build keys and publishes
+// the summary to the scans feeding its probe side.
+struct RuntimeFilterBuildDescriptor {
+    int32_t filter_id = -1;
+    // Position of the key among the join's build key slots.
+    size_t build_key_idx = 0;
+    // Joins publishing this filter, e.g. the instances of a shuffle join that
+    // each build from one partition of the rows. A scan applies the filter
+    // once it has received and merged all of their filters.
+    int32_t num_producers = 1;
+    // The scans of the join's own fragment instance apply it...
+    bool has_local_target = true;
+    // ...and those of these fragment instances, on this node or others.
+    std::vector<std::string> remote_targets;
+};
+
+// A runtime filter a scan applies to one of its columns.
+struct RuntimeFilterProbeDescriptor {
+    int32_t filter_id = -1;
+    // Schema position of the filtered column.
+    ColumnId column_id = 0;
+    // The dictionary id of the column as the scan reads it (see
+    // SlotDescriptor::dict_id); filters of other codes are not applied.
+    uint64_t dict_id = 0;
+};
+
+// Summary of the values of one join key on the build side of a hash join. A
+// probe row whose key it rules out cannot find a match, so scans on the probe
+// side drop it before the row is even materialized.
+//
+// The summary always holds the range of the values. Up to config::
+// runtime_filter_in_max_values distinct values it also holds the values
+// themselves, as an exact IN-set; beyond that, a bloom filter over their
+// hashes. NULL keys never match and are left out.
+//
+// Filters are immutable once built; merging makes a new one.
+class RuntimeFilter {
+public:
+    // The join compares floating-point keys bit by bit, which value
+    // comparisons would not respect (NaN, -0.0), so those get no filter;
+    // BITMAP keys it refuses.
+    static bool is_supported_type(LogicalType type) {
+        return type != TYPE_UNKNOWN && type != TYPE_BITMAP && !is_float_type(type);
+    }
+
+    // Summarizes rows [from, column.size()) of |column|, which holds codes of
+    // the global dictionary with id |dict_id| if that is not 0.
+    static std::shared_ptr<RuntimeFilter> create(LogicalType type, const Column& column, size_t from,
+                                                 uint64_t dict_id = 0);
+    // A filter passing every value either of them passes.
+    static StatusOr<std::shared_ptr<RuntimeFilter>> merge(const RuntimeFilter& a, const RuntimeFilter& b);
+
+    void serialize(Buffer<uint8_t>* dst) const;
+    static StatusOr<std::shared_ptr<RuntimeFilter>> deserialize(Slice* input);
+
+    LogicalType type() const { return _type; }
+    // See SlotDescriptor::dict_id. A scan applies the filter only to a column
+    // of the same codes.
+    uint64_t dict_id() const { return _dict_id; }
+    // No build row has a non-NULL key: no probe row can match.
+    bool is_empty() const { return _bounds == nullptr; }
+    // Bounds of the values; the filter must not be empty.
+    Datum min_value() const { return _bounds->get(0); }
+    Datum max_value() const { return _bounds->get(1); }
+    // The distinct values, or null when there are too many.
+    const Column* values() const { return _values.get(); }
+    // Non-empty when the filter is neither empty nor exact.
+    const BlockBloomFilter& bloom() const { return _bloom; }
+
+    size_t memory_usage() const;
+    std::string debug_string() const;
+
+private:
+    template <LogicalType LT>
+    friend struct RuntimeFilterHelper;
+    template <LogicalType LT>
+    friend class RuntimeFilterPredicate;
+
+    explicit RuntimeFilter(LogicalType type) : _type(type) {}
+
+    const LogicalType _type;
+    uint64_t _dict_id = 0;
+    ColumnPtr _bounds;
+    ColumnPtr _values;
+    BlockBloomFilter _bloom;
+};
+
+using RuntimeFilterPtr = std::shared_ptr<const RuntimeFilter>;
+
+// Predicate on column |id| passing the non-NULL rows whose value |filter| may
+// hold, at page level through zone maps and at row level.
+ColumnPredicatePtr new_runtime_filter_predicate(RuntimeFilterPtr filter, ColumnId id);
+
+} // namespace starrocks
@@ -0,0 +1,84 @@
+#include "exec/runtime_filter_worker.h"
+
+#include "util/coding.h"
+
+namespace starrocks {
+
+// Message layout: u32 filter_id, u32 num_producers, u8 has_filter, then the
+// filter as RuntimeFilter::serialize() writes it.
+
+RuntimeFilterWorker::RuntimeFilterWorker(int num_threads) : _pool("runtime_filter", std::max(num_threads, 1)) {}
+
+RuntimeFilterWorker::~RuntimeFilterWorker() {
+    shutdown();
+}
+
+void RuntimeFilterWorker::register_fragment(const std::string& fragment_instance_id,
+                                            pipeline::RuntimeFilterHubPtr hub) {
+    std::lock_guard<std::mutex> l(_lock);
+    _hubs[fragment_instance_id] = std::move(hub);
+}
+
+void RuntimeFilterWorker::unregister_fragment(const std::string& fragment_instance_id,
+                                              const pipeline::RuntimeFilterHub* hub) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _hubs.find(fragment_instance_id);
+    if (it != _hubs.end() && it->second.get() == hub) {
+        _hubs.erase(it);
+    }
+}
+
+Status RuntimeFilterWorker::send(const std::vector<std::string>& targets, int32_t filter_id, int32_t num_producers,
+                                 const RuntimeFilter* filter) {
+    if (targets.empty()) {
+        return Status::OK();
+    }
+    Buffer<uint8_t> buffer;
+    put_fixed32(&buffer, static_cast<uint32_t>(filter_id));
+    put_fixed32(&buffer, static_cast<uint32_t>(num_producers));
+    put_fixed8(&buffer, filter != nullptr);
+    if (filter != nullptr) {
+        filter->serialize(&buffer);
+    }
+    auto message = std::make_shared<const std::string>(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    for (const auto& target : targets) {
+        _bytes_sent.fetch_add(static_cast<int64_t>(message->size()), std::memory_order_relaxed);
+        RETURN_IF_ERROR(_pool.submit([this, target, message] { _deliver(target, *message); }));
+    }
+    return Status::OK();
+}
+
+void RuntimeFilterWorker::_deliver(const std::string& target, const std::string& message) {
+    pipeline::RuntimeFilterHubPtr hub;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _hubs.find(target);
+        if (it != _hubs.end()) {
+            hub = it->second;
+        }
+    }
+    Slice input(message);
+    uint32_t filter_id = 0;
+    uint32_t num_producers = 0;
+    uint8_t has_filter = 0;
+    if (hub == nullptr || !get_fixed32(&input, &filter_id) || !get_fixed32(&input, &num_producers) ||
+        !get_fixed8(&input, &has_filter)) {
+        _num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Status st = hub->receive_serialized(static_cast<int32_t>(filter_id), static_cast<int32_t>(num_producers),
+                                        has_filter ? &input : nullptr);
+    if (!st.ok()) {
+        // A corrupt filter is as good as none: the scans stop waiting for it
+        // after the timeout.
+        _num_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _num_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RuntimeFilterWorker::shutdown() {
+    _pool.shutdown();
+}
+
+} // namespace starrocks
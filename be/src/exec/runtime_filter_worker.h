@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "exec/pipeline/runtime_filter_hub.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+// Delivers runtime filters to the fragment instances that apply them. It
+// stands in for the RPC between nodes: a filter is serialized, shipped
+// asynchronously and deserialized at the receiving end, as it would be over
+// the network, then handed to the RuntimeFilterHub the instance registered.
+// Filters for instances that are not registered (not started yet, or done)
+// are dropped; their scans stop waiting after config::
+// runtime_filter_wait_timeout_ms and read unfiltered.
+class RuntimeFilterWorker {
+public:
+    explicit RuntimeFilterWorker(int num_threads);
+    ~RuntimeFilterWorker();
+
+    DISALLOW_COPY_AND_MOVE(RuntimeFilterWorker);
+
+    void register_fragment(const std::string& fragment_instance_id, pipeline::RuntimeFilterHubPtr hub);
+    // No-op if another hub has been registered under the id since.
+    void unregister_fragment(const std::string& fragment_instance_id, const pipeline::RuntimeFilterHub* hub);
+
+    // Sends one of the |num_producers| parts of filter |filter_id| to
+    // |targets|; a null |filter| is a part that could not be built.
+    Status send(const std::vector<std::string>& targets, int32_t filter_id, int32_t num_producers,
+                const RuntimeFilter* filter);
+
+    // Runs the queued deliveries and stops accepting new ones.
+    void shutdown();
+
+    int64_t num_delivered() const { return _num_delivered.load(std::memory_order_relaxed); }
+    int64_t num_dropped() const { return _num_dropped.load(std::memory_order_relaxed); }
+    int64_t bytes_sent() const { return _bytes_sent.load(std::memory_order_relaxed); }
+
+private:
+    void _deliver(const std::string& target, const std::string& message);
+
+    ThreadPool _pool;
+    std::mutex _lock;
+    std::unordered_map<std::string, pipeline::RuntimeFilterHubPtr> _hubs;
+
+    std::atomic<int64_t> _num_delivered{0};
+    std::atomic<int64_t> _num_dropped{0};
+    std::atomic<int64_t> _bytes_sent{0};
+};
+
+} // namespace starrocks
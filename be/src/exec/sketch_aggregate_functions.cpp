@@ -0,0 +1,640 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "exec/aggregate_function_helper.h"
+#include "runtime/mem_pool.h"
+#include "util/hash_util.h"
+#include "util/hyperloglog.h"
+#include "util/tdigest.h"
+#include "util/theta_sketch.h"
+
+namespace starrocks {
+
+// The aggregate functions over sketches. Their intermediate values, and the
+// results of all but APPROX_COUNT_DISTINCT, are serialized sketches, in the
+// format of HyperLogLog, ThetaSketch or TDigest, so the scalar functions
+// reading those (hll_cardinality(), percentile_approx()...) take them too.
+//
+// The states are plain data like those of the other functions: whatever
+// grows with the values seen - hash tables, registers, centroids - is taken
+// from the pool, a larger array replacing a full one, which stays in the pool
+// until the aggregation is done. Serialized sketches that do not parse are
+// skipped like NULLs.
+
+template <LogicalType LT>
+static uint64_t hash_value(const RunTimeCppType<LT>& value) {
+    if constexpr (is_binary_type(LT)) {
+        return HashUtil::hash_bytes(value.data, value.size);
+    } else {
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(value));
+        return HashUtil::hash64(bits);
+    }
+}
+
+template <typename T>
+static T* allocate_array(MemPool* pool, size_t n) {
+    auto* array = reinterpret_cast<T*>(pool->allocate(n * sizeof(T), alignof(T)));
+    memset(static_cast<void*>(array), 0, n * sizeof(T));
+    return array;
+}
+
+// HyperLogLog registers, of the default precision unless a sketch of a lower
+// one was merged. While few registers are set they are kept in a hash table
+// of index << 8 | rank entries, 0 marking free slots, then all of them.
+struct HllState {
+    using Sketch = HyperLogLog;
+    static constexpr bool kNullable = false;
+
+    uint32_t* sparse = nullptr;
+    uint8_t* registers = nullptr;
+    uint32_t num_sparse = 0;
+    uint32_t sparse_capacity = 0;
+    int precision = HyperLogLog::kDefaultPrecision;
+
+    size_t num_registers() const { return size_t(1) << precision; }
+
+    template <LogicalType LT>
+    void add(const RunTimeCppType<LT>& value, MemPool* pool) {
+        uint64_t hash = hash_value<LT>(value);
+        set(HyperLogLog::register_index(hash, precision), HyperLogLog::register_rank(hash, precision), pool);
+    }
+
+    void set(uint32_t index, uint8_t rank, MemPool* pool) {
+        if (registers != nullptr) {
+            registers[index] = std::max(registers[index], rank);
+            return;
+        }
+        if (sparse_capacity == 0) {
+            _resize_sparse(16, pool);
+        }
+        uint32_t mask = sparse_capacity - 1;
+        for (uint32_t slot = HashUtil::hash64(index) & mask;; slot = (slot + 1) & mask) {
+            uint32_t entry = sparse[slot];
+            if (entry == 0) {
+                sparse[slot] = index << 8 | rank;
+                if (++num_sparse * 2 > sparse_capacity) {
+                    if (num_sparse * 16 > num_registers()) {
+                        _make_dense(pool);
+                    } else {
+                        _resize_sparse(sparse_capacity * 2, pool);
+                    }
+                }
+                return;
+            }
+            if (entry >> 8 == index) {
+                sparse[slot] = std::max(entry, index << 8 | rank);
+                return;
+            }
+        }
+    }
+
+    void merge(const HyperLogLog& other, MemPool* pool) {
+        if (other.precision() < precision) {
+            HyperLogLog merged = to_sketch();
+            merged.merge(other);
+            precision = merged.precision();
+            registers = allocate_array<uint8_t>(pool, num_registers());
+            memcpy(registers, merged.registers().data(), num_registers());
+            sparse = nullptr;
+            num_sparse = sparse_capacity = 0;
+            return;
+        }
+        if (other.precision() > precision) {
+            HyperLogLog folded(precision);
+            folded.merge(other);
+            merge(folded, pool);
+            return;
+        }
+        const std::vector<uint8_t>& other_registers = other.registers();
+        for (size_t i = 0; i < other_registers.size(); ++i) {
+            if (other_registers[i] != 0) {
+                set(static_cast<uint32_t>(i), other_registers[i], pool);
+            }
+        }
+    }
+
+    int64_t estimate() const {
+        if (registers != nullptr) {
+            return HyperLogLog::estimate(registers, precision);
+        }
+        // Linear counting, as HyperLogLog::estimate() for so few registers.
+        auto m = static_cast<double>(num_registers());
+        return std::llround(m * std::log(m / (m - num_sparse)));
+    }
+
+    HyperLogLog to_sketch() const {
+        HyperLogLog sketch(precision);
+        Buffer<uint8_t> buf;
+        serialize(&buf);
+        Slice input(buf.data(), buf.size());
+        HyperLogLog::deserialize(&input, &sketch);
+        return sketch;
+    }
+
+    void serialize(Buffer<uint8_t>* dst) const {
+        std::vector<uint32_t> entries;
+        if (registers == nullptr) {
+            for (uint32_t slot = 0; slot < sparse_capacity; ++slot) {
+                if (sparse[slot] != 0) {
+                    entries.push_back(sparse[slot]);
+                }
+            }
+            std::sort(entries.begin(), entries.end());
+        } else {
+            size_t n = num_registers();
+            for (size_t i = 0; i < n && entries.size() * 4 < n; ++i) {
+                if (registers[i] != 0) {
+                    entries.push_back(static_cast<uint32_t>(i << 8 | registers[i]));
+                }
+            }
+            if (entries.size() * 4 >= n) {
+                HyperLogLog::serialize_dense(registers, precision, dst);
+                return;
+            }
+        }
+        HyperLogLog::serialize_sparse(entries.data(), entries.size(), precision, dst);
+    }
+
+    template <LogicalType LT>
+    static void serialize_value(const RunTimeCppType<LT>& value, Buffer<uint8_t>* dst) {
+        constexpr int kPrecision = HyperLogLog::kDefaultPrecision;
+        uint64_t hash = hash_value<LT>(value);
+        uint32_t entry =
+                HyperLogLog::register_index(hash, kPrecision) << 8 | HyperLogLog::register_rank(hash, kPrecision);
+        HyperLogLog::serialize_sparse(&entry, 1, kPrecision, dst);
+    }
+
+private:
+    void _resize_sparse(uint32_t capacity, MemPool* pool) {
+        uint32_t* old = sparse;
+        uint32_t old_capacity = sparse_capacity;
+        sparse = allocate_array<uint32_t>(pool, capacity);
+        sparse_capacity = capacity;
+        uint32_t mask = capacity - 1;
+        for (uint32_t i = 0; i < old_capacity; ++i) {
+            if (old[i] != 0) {
+                uint32_t slot = HashUtil::hash64(old[i] >> 8) & mask;
+                while (sparse[slot] != 0) {
+                    slot = (slot + 1) & mask;
+                }
+                sparse[slot] = old[i];
+            }
+        }
+    }
+
+    void _make_dense(MemPool* pool) {
+        registers = allocate_array<uint8_t>(pool, num_registers());
+        for (uint32_t slot = 0; slot < sparse_capacity; ++slot) {
+            if (sparse[slot] != 0) {
+                registers[sparse[slot] >> 8] = static_cast<uint8_t>(sparse[slot]);
+            }
+        }
+        sparse = nullptr;
+        num_sparse = sparse_capacity = 0;
+    }
+};
+
+// The hashes below theta, in a hash table growing up to twice
+// ThetaSketch::kNominalEntries slots, then trimmed back to the nominal number
+// of hashes whenever it is three quarters full. 0 marks free slots: a value
+// hashing to it, with a chance of 2^-64, is not counted.
+struct ThetaState {
+    using Sketch = ThetaSketch;
+    static constexpr bool kNullable = false;
+    static constexpr uint32_t kMaxCapacity = 2 * ThetaSketch::kNominalEntries;
+
+    uint64_t* table = nullptr;
+    uint32_t size = 0;
+    uint32_t capacity = 0;
+    uint64_t theta = UINT64_MAX;
+
+    template <LogicalType LT>
+    void add(const RunTimeCppType<LT>& value, MemPool* pool) {
+        add_hash(hash_value<LT>(value), pool);
+    }
+
+    void add_hash(uint64_t hash, MemPool* pool) {
+        if (hash == 0 || hash >= theta) {
+            return;
+        }
+        if (capacity == 0) {
+            _rebuild(_collect(), 16, pool);
+        }
+        uint32_t mask = capacity - 1;
+        for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            if (table[slot] == hash) {
+                return;
+            }
+            if (table[slot] == 0) {
+                table[slot] = hash;
+                break;
+            }
+        }
+        if (++size * 2 <= capacity || (capacity == kMaxCapacity && size * 4 <= capacity * 3)) {
+            return;
+        }
+        std::vector<uint64_t> hashes = _collect();
+        if (capacity < kMaxCapacity) {
+            _rebuild(std::move(hashes), capacity * 2, pool);
+            return;
+        }
+        std::nth_element(hashes.begin(), hashes.begin() + ThetaSketch::kNominalEntries, hashes.end());
+        theta = hashes[ThetaSketch::kNominalEntries];
+        hashes.resize(ThetaSketch::kNominalEntries);
+        _rebuild(std::move(hashes), capacity, pool);
+    }
+
+    void merge(const ThetaSketch& other, MemPool* pool) {
+        if (other.theta() < theta) {
+            theta = other.theta();
+            std::vector<uint64_t> hashes = _collect();
+            hashes.erase(std::remove_if(hashes.begin(), hashes.end(), [this](uint64_t h) { return h >= theta; }),
+                         hashes.end());
+            _rebuild(std::move(hashes), std::max<uint32_t>(capacity, 16), pool);
+        }
+        for (uint64_t hash : other.hashes()) {
+            add_hash(hash, pool);
+        }
+    }
+
+    // Trimmed to the nominal number of hashes, as ThetaSketch::unite() does,
+    // so the sketch does not depend on the order the values came in.
+    void serialize(Buffer<uint8_t>* dst) const {
+        std::vector<uint64_t> hashes = _collect();
+        std::sort(hashes.begin(), hashes.end());
+        uint64_t trimmed_theta = theta;
+        if (hashes.size() > ThetaSketch::kNominalEntries) {
+            trimmed_theta = hashes[ThetaSketch::kNominalEntries];
+            hashes.resize(ThetaSketch::kNominalEntries);
+        }
+        ThetaSketch::serialize(trimmed_theta, hashes.data(), hashes.size(), dst);
+    }
+
+    template <LogicalType LT>
+    static void serialize_value(const RunTimeCppType<LT>& value, Buffer<uint8_t>* dst) {
+        uint64_t hash = hash_value<LT>(value);
+        ThetaSketch::serialize(UINT64_MAX, &hash, hash != 0 && hash != UINT64_MAX, dst);
+    }
+
+private:
+    std::vector<uint64_t> _collect() const {
+        std::vector<uint64_t> hashes;
+        hashes.reserve(size);
+        for (uint32_t slot = 0; slot < capacity; ++slot) {
+            if (table[slot] != 0) {
+                hashes.push_back(table[slot]);
+            }
+        }
+        return hashes;
+    }
+
+    // Reuses the table when its capacity does not change.
+    void _rebuild(std::vector<uint64_t> hashes, uint32_t new_capacity, MemPool* pool) {
+        if (new_capacity != capacity) {
+            table = allocate_array<uint64_t>(pool, new_capacity);
+            capacity = new_capacity;
+        } else {
+            memset(table, 0, capacity * sizeof(uint64_t));
+        }
+        uint32_t mask = capacity - 1;
+        for (uint64_t hash : hashes) {
+            uint32_t slot = hash & mask;
+            while (table[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = hash;
+        }
+        size = static_cast<uint32_t>(hashes.size());
+    }
+};
+
+// The intersection of the sketches merged so far, as ascending hashes; none
+// is the whole set, so the result is NULL until the first sketch.
+struct ThetaIntersectState {
+    using Sketch = ThetaSketch;
+    static constexpr bool kNullable = true;
+
+    uint64_t* hashes = nullptr;
+    uint32_t size = 0;
+    uint64_t theta = UINT64_MAX;
+    bool has_value = false;
+
+    void merge(const ThetaSketch& other, MemPool* pool) {
+        const std::vector<uint64_t>& other_hashes = other.hashes();
+        if (!has_value) {
+            hashes = allocate_array<uint64_t>(pool, other_hashes.size());
+            std::copy(other_hashes.begin(), other_hashes.end(), hashes);
+            size = static_cast<uint32_t>(other_hashes.size());
+            theta = other.theta();
+            has_value = true;
+            return;
+        }
+        theta = std::min(theta, other.theta());
+        // In place: the hashes kept are a prefix of those compared.
+        uint32_t kept = 0;
+        auto it = other_hashes.begin();
+        for (uint32_t i = 0; i < size && hashes[i] < theta; ++i) {
+            it = std::lower_bound(it, other_hashes.end(), hashes[i]);
+            if (it != other_hashes.end() && *it == hashes[i]) {
+                hashes[kept++] = hashes[i];
+            }
+        }
+        size = kept;
+    }
+
+    void serialize(Buffer<uint8_t>* dst) const { ThetaSketch::serialize(theta, hashes, size, dst); }
+};
+
+// t-digest centroids, the values seen appended as centroids of weight 1 and
+// compressed whenever the array is full; it grows when compressing leaves it
+// more than three quarters full. NaN values are skipped.
+struct TDigestState {
+    using Sketch = TDigest;
+    using Centroid = TDigest::Centroid;
+    static constexpr bool kNullable = false;
+
+    Centroid* centroids = nullptr;
+    uint32_t size = 0;
+    uint32_t capacity = 0;
+    double min = 0;
+    double max = 0;
+
+    template <LogicalType LT>
+    void add(const RunTimeCppType<LT>& value, MemPool* pool) {
+        add_centroid({static_cast<double>(value), 1}, pool);
+    }
+
+    void add_centroid(const Centroid& centroid, MemPool* pool) {
+        if (std::isnan(centroid.mean)) {
+            return;
+        }
+        if (size == capacity) {
+            _make_room(pool);
+        }
+        min = size == 0 ? centroid.mean : std::min(min, centroid.mean);
+        max = size == 0 ? centroid.mean : std::max(max, centroid.mean);
+        centroids[size++] = centroid;
+    }
+
+    void merge(const TDigest& other, MemPool* pool) {
+        if (other.empty()) {
+            return;
+        }
+        for (const auto& centroid : other.centroids()) {
+            add_centroid(centroid, pool);
+        }
+        min = std::min(min, other.min());
+        max = std::max(max, other.max());
+    }
+
+    // Compresses the centroids first.
+    void serialize(Buffer<uint8_t>* dst) {
+        size = static_cast<uint32_t>(TDigest::compress(centroids, size));
+        TDigest::serialize(centroids, size, min, max, dst);
+    }
+
+    template <LogicalType LT>
+    static void serialize_value(const RunTimeCppType<LT>& value, Buffer<uint8_t>* dst) {
+        auto mean = static_cast<double>(value);
+        Centroid centroid{mean, 1};
+        TDigest::serialize(&centroid, !std::isnan(mean), mean, mean, dst);
+    }
+
+private:
+    void _make_room(MemPool* pool) {
+        size = static_cast<uint32_t>(TDigest::compress(centroids, size));
+        if (size * 4 <= capacity * 3 && size < capacity) {
+            return;
+        }
+        uint32_t new_capacity = std::max<uint32_t>(16, capacity * 2);
+        auto* grown = allocate_array<Centroid>(pool, new_capacity);
+        std::copy(centroids, centroids + size, grown);
+        centroids = grown;
+        capacity = new_capacity;
+    }
+};
+
+// The serialized sketch of the values merged or aggregated, as result and
+// intermediate value.
+template <typename State>
+class SketchFunction : public AggregateFunction {
+public:
+    explicit SketchFunction(AggFunctionType type) : _type(type) {}
+
+    AggFunctionType type() const override { return _type; }
+    LogicalType intermediate_type() const override { return TYPE_VARCHAR; }
+    bool is_intermediate_nullable() const override { return State::kNullable; }
+    LogicalType result_type() const override { return TYPE_VARCHAR; }
+    bool is_result_nullable() const override { return State::kNullable; }
+
+    size_t state_size() const override { return sizeof(State); }
+    size_t state_align() const override { return alignof(State); }
+    void create(AggDataPtr state) const override { new (state) State(); }
+
+    void merge_batch(const Column* intermediate, size_t num_rows, size_t offset, const AggDataPtr* states,
+                     MemPool* pool) const override {
+        const uint8_t* nulls;
+        const auto* sketches = static_cast<const BinaryColumn*>(unpack_nullable(intermediate, &nulls));
+        typename State::Sketch sketch;
+        for (size_t i = 0; i < num_rows; ++i) {
+            Slice input = sketches->get_slice(i);
+            if ((nulls == nullptr || !nulls[i]) && State::Sketch::deserialize(&input, &sketch)) {
+                state_of<State>(states[i], offset).merge(sketch, pool);
+            }
+        }
+    }
+
+    void serialize_to_column(const AggDataPtr* states, size_t num_states, size_t offset,
+                             Column* dst) const override {
+        Buffer<uint8_t> buf;
+        if constexpr (State::kNullable) {
+            auto* nullable = as_nullable(dst);
+            auto* sketches = static_cast<BinaryColumn*>(nullable->data_column().get());
+            auto& nulls = nullable->null_column_data();
+            bool has_null = false;
+            for (size_t i = 0; i < num_states; ++i) {
+                auto& s = state_of<State>(states[i], offset);
+                buf.clear();
+                if (s.has_value) {
+                    s.serialize(&buf);
+                }
+                sketches->append(Slice(buf.data(), buf.size()));
+                nulls.push_back(!s.has_value);
+                has_null |= !s.has_value;
+            }
+            nullable->set_has_null(has_null);
+        } else {
+            auto* sketches = static_cast<BinaryColumn*>(dst);
+            for (size_t i = 0; i < num_states; ++i) {
+                buf.clear();
+                state_of<State>(states[i], offset).serialize(&buf);
+                sketches->append(Slice(buf.data(), buf.size()));
+            }
+        }
+    }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        serialize_to_column(states, num_states, offset, dst);
+    }
+
+private:
+    const AggFunctionType _type;
+};
+
+// The sketch of the values of an argument of type LT.
+template <typename State, LogicalType LT>
+class SketchOfValuesFunction : public SketchFunction<State> {
+public:
+    using SketchFunction<State>::SketchFunction;
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        const uint8_t* nulls;
+        const Column* data = unpack_nullable(arg, &nulls);
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (nulls == nullptr || !nulls[i]) {
+                state_of<State>(states[i], offset).template add<LT>(value_at<LT>(data, i), pool);
+            }
+        }
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* nulls;
+        const Column* data = unpack_nullable(arg, &nulls);
+        auto* sketches = static_cast<BinaryColumn*>(dst);
+        Buffer<uint8_t> buf;
+        for (size_t i = 0; i < num_rows; ++i) {
+            buf.clear();
+            if (nulls != nullptr && nulls[i]) {
+                State().serialize(&buf);
+            } else {
+                State::template serialize_value<LT>(value_at<LT>(data, i), &buf);
+            }
+            sketches->append(Slice(buf.data(), buf.size()));
+        }
+    }
+};
+
+// The number of distinct values, estimated by a HyperLogLog.
+template <LogicalType LT>
+class ApproxCountDistinctFunction final : public SketchOfValuesFunction<HllState, LT> {
+public:
+    ApproxCountDistinctFunction() : SketchOfValuesFunction<HllState, LT>(AggFunctionType::APPROX_COUNT_DISTINCT) {}
+
+    LogicalType result_type() const override { return TYPE_BIGINT; }
+    bool is_result_nullable() const override { return false; }
+
+    void finalize_to_column(const AggDataPtr* states, size_t num_states, size_t offset, Column* dst) const override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        for (size_t i = 0; i < num_states; ++i) {
+            data.push_back(state_of<HllState>(states[i], offset).estimate());
+        }
+    }
+};
+
+// The union, or intersection, of serialized sketches: rows are merged as
+// intermediate values are.
+template <typename State>
+class SketchOfSketchesFunction final : public SketchFunction<State> {
+public:
+    using SketchFunction<State>::SketchFunction;
+
+    void update_batch(const Column* arg, size_t num_rows, size_t offset, const AggDataPtr* states,
+                      MemPool* pool) const override {
+        this->merge_batch(arg, num_rows, offset, states, pool);
+    }
+
+    void convert_to_intermediate(const Column* arg, size_t num_rows, Column* dst) const override {
+        const uint8_t* arg_nulls;
+        const auto* sketches = static_cast<const BinaryColumn*>(unpack_nullable(arg, &arg_nulls));
+        auto* nullable = State::kNullable ? as_nullable(dst) : nullptr;
+        auto* out = static_cast<BinaryColumn*>(State::kNullable ? nullable->data_column().get() : dst);
+        Buffer<uint8_t> empty;
+        State().serialize(&empty);
+        for (size_t i = 0; i < num_rows; ++i) {
+            bool is_null = arg_nulls != nullptr && arg_nulls[i];
+            if (!is_null) {
+                out->append(sketches->get_slice(i));
+            } else if (State::kNullable) {
+                out->append(Slice());
+            } else {
+                out->append(Slice(empty.data(), empty.size()));
+            }
+        }
+        if (State::kNullable) {
+            auto& nulls = nullable->null_column_data();
+            if (arg_nulls != nullptr) {
+                nulls.append(arg_nulls, num_rows);
+                nullable->set_has_null(true);
+            } else {
+                nulls.resize(nulls.size() + num_rows, 0);
+            }
+        }
+    }
+};
+
+template <typename State>
+static const AggregateFunction* sketch_of_values(AggFunctionType type, LogicalType arg_type) {
+    return type_dispatch_all(arg_type, [type](auto lt) -> const AggregateFunction* {
+        constexpr LogicalType LT = decltype(lt)::value;
+        if constexpr (std::is_same_v<State, TDigestState> && !is_integer_type(LT) && !is_float_type(LT)) {
+            return nullptr;
+        } else {
+            static const SketchOfValuesFunction<State, LT> function(type);
+            return &function;
+        }
+    });
+}
+
+StatusOr<const AggregateFunction*> get_sketch_aggregate_function(AggFunctionType type, LogicalType arg_type,
+                                                                 bool is_merge) {
+    bool of_sketches = type == AggFunctionType::HLL_UNION || type == AggFunctionType::THETA_UNION ||
+                       type == AggFunctionType::THETA_INTERSECT || type == AggFunctionType::PERCENTILE_UNION;
+    bool of_numbers = type == AggFunctionType::PERCENTILE_SKETCH;
+    if ((is_merge || of_sketches) ? arg_type != TYPE_VARCHAR
+                                  : arg_type == TYPE_UNKNOWN || arg_type == TYPE_BITMAP ||
+                                            (of_numbers && !is_integer_type(arg_type) && !is_float_type(arg_type))) {
+        return unsupported(type, arg_type, is_merge);
+    }
+    // Merging does not depend on the argument type.
+    if (is_merge) {
+        arg_type = of_numbers ? TYPE_DOUBLE : TYPE_VARCHAR;
+    }
+    switch (type) {
+    case AggFunctionType::APPROX_COUNT_DISTINCT:
+        return type_dispatch_all(arg_type, [](auto lt) -> const AggregateFunction* {
+            static const ApproxCountDistinctFunction<decltype(lt)::value> function;
+            return &function;
+        });
+    case AggFunctionType::HLL_SKETCH:
+        return sketch_of_values<HllState>(type, arg_type);
+    case AggFunctionType::THETA_SKETCH:
+        return sketch_of_values<ThetaState>(type, arg_type);
+    case AggFunctionType::PERCENTILE_SKETCH:
+        return sketch_of_values<TDigestState>(type, arg_type);
+    case AggFunctionType::HLL_UNION: {
+        static const SketchOfSketchesFunction<HllState> function(type);
+        return &function;
+    }
+    case AggFunctionType::THETA_UNION: {
+        static const SketchOfSketchesFunction<ThetaState> function(type);
+        return &function;
+    }
+    case AggFunctionType::THETA_INTERSECT: {
+        static const SketchOfSketchesFunction<ThetaIntersectState> function(type);
+        return &function;
+    }
+    case AggFunctionType::PERCENTILE_UNION: {
+        static const SketchOfSketchesFunction<TDigestState> function(type);
+        return &function;
+    }
+    default:
+        return unsupported(type, arg_type, is_merge);
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,192 @@
+#include "exec/sort_context.h"
+
+#include "common/config.h"
+#include "exec/pipeline/fragment_context.h"
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "runtime/exec_env.h"
+
+namespace starrocks {
+
+SortContext::SortContext(Param param) : _param(std::move(param)), _encoder(_param.sort_descs) {}
+
+SortContext::~SortContext() = default;
+
+Status SortContext::prepare() {
+    if (_prepared) {
+        return Status::OK();
+    }
+    if (_param.sort_descs.empty()) {
+        return Status::InvalidArgument("sort without keys");
+    }
+    if (_param.limit < -1 || _param.offset < 0) {
+        return Status::InvalidArgument("invalid LIMIT " + std::to_string(_param.limit) + " OFFSET " +
+                                       std::to_string(_param.offset));
+    }
+    RETURN_IF_ERROR(_encoder.prepare(_param.row_desc));
+    if (_topn_filter != nullptr && _topn_filter->logical_type() != _encoder.type(0)) {
+        return Status::InvalidArgument("top-n filter on " + logical_type_to_string(_topn_filter->logical_type()) +
+                                       " for a sort key of type " + logical_type_to_string(_encoder.type(0)));
+    }
+    _prepared = true;
+    return Status::OK();
+}
+
+bool SortContext::is_topn() const {
+    return _param.limit >= 0 && _param.limit + _param.offset <= config::sort_topn_max_rows;
+}
+
+std::unique_ptr<ChunksSorter> SortContext::create_sorter() {
+    if (is_topn()) {
+        return std::make_unique<ChunksSorterTopN>(this, static_cast<size_t>(max_run_rows()));
+    }
+    return std::make_unique<ChunksSorterFullSort>(this);
+}
+
+Status SortContext::add_run(RuntimeState* state, std::vector<ChunkPtr> chunks, bool spill) {
+    if (chunks.empty()) {
+        return Status::OK();
+    }
+    std::lock_guard<std::mutex> l(_lock);
+    SortedRun run;
+    if (spill) {
+        if (_spiller == nullptr) {
+            ASSIGN_OR_RETURN(std::string dir, state->query_ctx()->spill_dir());
+            pipeline::PipelineDriverExecutor* executor = state->fragment_ctx()->executor();
+            // Sink drivers parked on a spill backlog, and the source waiting
+            // for the last writes, re-check once the queue drains.
+            _spiller = std::make_shared<spill::Spiller>(std::move(dir), "sort",
+                                                        ExecEnv::GetInstance()->spill_io_thread_pool(),
+                                                        state->instance_mem_tracker(), [executor] {
+                                                            if (executor != nullptr) {
+                                                                executor->wake_poller();
+                                                            }
+                                                        });
+        }
+        run.chunks = std::move(chunks);
+        _runs.push_back(std::move(run));
+        // The runs kept in memory so far go as well: the query is short of
+        // memory either way.
+        for (auto& in_memory : _runs) {
+            if (in_memory.stream < 0) {
+                RETURN_IF_ERROR(_spill_run(&in_memory));
+            }
+        }
+    } else {
+        run.chunks = std::move(chunks);
+        _runs.push_back(std::move(run));
+    }
+    ++_num_runs;
+    return Status::OK();
+}
+
+Status SortContext::_spill_run(SortedRun* run) {
+    run->stream = static_cast<int64_t>(_spiller->add_stream(_param.row_desc));
+    for (auto& chunk : run->chunks) {
+        RETURN_IF_ERROR(_spiller->append(run->stream, std::move(chunk)));
+    }
+    run->chunks.clear();
+    ++_num_spilled_runs;
+    return Status::OK();
+}
+
+void SortContext::finish_sink(RuntimeState* state) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (--_num_running_sinkers > 0) {
+            return;
+        }
+    }
+    _sink_done.store(true, std::memory_order_release);
+    state->fragment_ctx()->notify_event();
+}
+
+bool SortContext::is_spill_backlogged() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _spiller != nullptr && _spiller->is_backlogged();
+}
+
+bool SortContext::has_pending_spill_writes() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _spiller != nullptr && _spiller->has_pending_writes();
+}
+
+bool SortContext::is_sink_complete() const {
+    return _sink_done.load(std::memory_order_acquire) && !has_pending_spill_writes();
+}
+
+size_t SortContext::num_runs() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_runs;
+}
+
+size_t SortContext::num_spilled_runs() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _num_spilled_runs;
+}
+
+Status SortContext::_start_merge() {
+    std::vector<SortedRunReader> readers;
+    for (auto& run : _runs) {
+        if (run.stream < 0) {
+            // Chunks are released as the merge moves past them.
+            readers.emplace_back([chunks = std::move(run.chunks), next = size_t(0)]() mutable -> StatusOr<ChunkPtr> {
+                return next < chunks.size() ? std::move(chunks[next++]) : nullptr;
+            });
+            continue;
+        }
+        ASSIGN_OR_RETURN(spill::SpillStreamReaderPtr reader, _spiller->open_reader(run.stream));
+        readers.emplace_back([reader = std::shared_ptr<spill::SpillStreamReader>(std::move(reader))]()
+                                     -> StatusOr<ChunkPtr> {
+            ChunkPtr chunk;
+            Status st = reader->get_next(&chunk);
+            if (st.is_end_of_file()) {
+                return nullptr;
+            }
+            RETURN_IF_ERROR(st);
+            return chunk;
+        });
+    }
+    _runs.clear();
+    _merger = std::make_unique<SortedRunsMerger>(&_encoder, std::move(readers));
+    return _merger->init();
+}
+
+StatusOr<ChunkPtr> SortContext::next_output(RuntimeState* state) {
+    if (_output_done) {
+        return nullptr;
+    }
+    if (_merger == nullptr) {
+        RETURN_IF_ERROR(_start_merge());
+    }
+    while (true) {
+        size_t max_rows = state->chunk_size();
+        if (_param.limit >= 0) {
+            int64_t remaining = _param.offset - _num_skipped + _param.limit - _num_output;
+            max_rows = std::min(max_rows, static_cast<size_t>(remaining));
+        }
+        if (max_rows == 0) {
+            _output_done = true;
+            return nullptr;
+        }
+        ASSIGN_OR_RETURN(ChunkPtr chunk, _merger->next(max_rows));
+        if (chunk == nullptr) {
+            _output_done = true;
+            return nullptr;
+        }
+        size_t num_rows = chunk->num_rows();
+        auto skipped = static_cast<size_t>(std::min<int64_t>(num_rows, _param.offset - _num_skipped));
+        _num_skipped += skipped;
+        if (skipped == num_rows) {
+            continue;
+        }
+        if (skipped > 0) {
+            ChunkPtr rest = chunk->clone_empty(num_rows - skipped);
+            rest->append(*chunk, skipped, num_rows - skipped);
+            chunk = std::move(rest);
+        }
+        _num_output += chunk->num_rows();
+        return chunk;
+    }
+}
+
+} // namespace starrocks
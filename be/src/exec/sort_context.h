@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "exec/chunks_sorter.h"
+#include "exec/sort_key.h"
+#include "exec/sorted_runs_merger.h"
+#include "exec/spill/spiller.h"
+#include "exec/topn_runtime_filter.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+// State of one ORDER BY shared by its sink drivers and its source driver.
+//
+// Sink drivers sort their input in parallel, each into sorted runs of its own
+// (see ChunksSorter); once the last of them is done, the single source driver
+// merges the runs of all of them (see SortedRunsMerger). Runs sorted while the
+// query is over its spill threshold are written to disk and read back a chunk
+// at a time by the merge.
+//
+// With a LIMIT of at most config::sort_topn_max_rows rows, OFFSET included,
+// the sink drivers keep just their first rows (see ChunksSorterTopN), and only
+// the merge applies the OFFSET; larger limits sort everything and cut each
+// run and the merge short.
+class SortContext {
+public:
+    struct Param {
+        RowDescriptor row_desc;
+        SortDescs sort_descs;
+        // -1 for no LIMIT.
+        int64_t limit = -1;
+        int64_t offset = 0;
+    };
+
+    explicit SortContext(Param param);
+    ~SortContext();
+
+    DISALLOW_COPY_AND_MOVE(SortContext);
+
+    // Set before prepare(): the filter Top-N sorts publish their cut-off to,
+    // which the planner also hands to the scan. Ignored for full sorts.
+    void set_topn_filter(TopNRuntimeFilterPtr filter) { _topn_filter = std::move(filter); }
+
+    // Idempotent: both the sink and the source factory call it.
+    Status prepare();
+
+    const Param& param() const { return _param; }
+    const SortKeyEncoder& encoder() const { return _encoder; }
+    bool is_topn() const;
+    // Rows the result can use from the start of a run; -1 for all of them.
+    int64_t max_run_rows() const { return _param.limit < 0 ? -1 : _param.limit + _param.offset; }
+    TopNRuntimeFilter* topn_filter() const { return is_topn() ? _topn_filter.get() : nullptr; }
+
+    // Called once per sink driver while drivers are created.
+    void set_num_sinkers(int32_t num_sinkers) { _num_running_sinkers = num_sinkers; }
+    std::unique_ptr<ChunksSorter> create_sorter();
+
+    // A sorted run of a sink driver, as chunks of at most the chunk size.
+    // Kept in memory until merged, unless |spill|: then it is written to
+    // disk, and so are the runs kept in memory so far.
+    Status add_run(RuntimeState* state, std::vector<ChunkPtr> chunks, bool spill);
+    // A sink driver is done; the last one wakes the source.
+    void finish_sink(RuntimeState* state);
+
+    // Sink drivers hold back input while spill writes queue up.
+    bool is_spill_backlogged() const;
+    bool has_pending_spill_writes() const;
+
+    // All runs are complete, on disk included: the source may merge.
+    bool is_sink_complete() const;
+    // The next rows of the result; nullptr after the last one.
+    StatusOr<ChunkPtr> next_output(RuntimeState* state);
+    bool is_output_done() const { return _output_done; }
+
+    size_t num_runs() const;
+    size_t num_spilled_runs() const;
+
+private:
+    struct SortedRun {
+        std::vector<ChunkPtr> chunks;
+        // The run's stream in _spiller if spilled, -1 otherwise.
+        int64_t stream = -1;
+    };
+
+    Status _spill_run(SortedRun* run);
+    Status _start_merge();
+
+    const Param _param;
+    SortKeyEncoder _encoder;
+    bool _prepared = false;
+    TopNRuntimeFilterPtr _topn_filter;
+
+    mutable std::mutex _lock;
+    std::vector<SortedRun> _runs;
+    spill::SpillerPtr _spiller;
+    int32_t _num_running_sinkers = 0;
+    size_t _num_runs = 0;
+    size_t _num_spilled_runs = 0;
+    std::atomic<bool> _sink_done{false};
+
+    // Only touched by the source driver.
+    std::unique_ptr<SortedRunsMerger> _merger;
+    int64_t _num_skipped = 0;
+    int64_t _num_output = 0;
+    bool _output_done = false;
+};
+
+using SortContextPtr = std::shared_ptr<SortContext>;
+
+} // namespace starrocks
@@ -0,0 +1,193 @@
+#include "exec/sort_key.h"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+
+namespace starrocks {
+
+namespace {
+
+constexpr uint8_t kNullFirst = 0x00;
+constexpr uint8_t kNotNull = 0x01;
+constexpr uint8_t kNullLast = 0x02;
+
+// An unsigned integer ordered as |value| is.
+template <typename CppType>
+auto ordered_bits(CppType value) {
+    if constexpr (std::is_floating_point_v<CppType>) {
+        using Bits = std::conditional_t<sizeof(CppType) == 4, uint32_t, uint64_t>;
+        constexpr Bits kSign = Bits(1) << (sizeof(Bits) * 8 - 1);
+        if (value == 0) {
+            value = 0;
+        } else if (std::isnan(value)) {
+            value = std::numeric_limits<CppType>::quiet_NaN();
+        }
+        Bits bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & kSign) ? Bits(~bits) : Bits(bits | kSign);
+    } else if constexpr (std::is_signed_v<CppType>) {
+        using Bits = std::make_unsigned_t<CppType>;
+        return Bits(static_cast<Bits>(value) ^ (Bits(1) << (sizeof(Bits) * 8 - 1)));
+    } else {
+        return value;
+    }
+}
+
+template <typename Bits>
+void store_big_endian(Bits bits, uint8_t* dst) {
+    for (size_t i = sizeof(Bits); i-- > 0;) {
+        dst[i] = static_cast<uint8_t>(bits);
+        bits = static_cast<Bits>(bits >> 7 >> 1);
+    }
+}
+
+void invert(uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = ~data[i];
+    }
+}
+
+size_t encoded_string_size(const Slice& s) {
+    size_t size = s.size + 2;
+    if (s.size == 0) {
+        return size;
+    }
+    for (const char* p = s.data; (p = static_cast<const char*>(memchr(p, 0, s.data + s.size - p))) != nullptr; ++p) {
+        ++size;
+    }
+    return size;
+}
+
+uint8_t* encode_string(const Slice& s, uint8_t* dst) {
+    for (size_t i = 0; i < s.size; ++i) {
+        *dst++ = static_cast<uint8_t>(s.data[i]);
+        if (s.data[i] == 0) {
+            *dst++ = 0xFF;
+        }
+    }
+    *dst++ = 0;
+    *dst++ = 0;
+    return dst;
+}
+
+} // namespace
+
+Status SortKeyEncoder::prepare(const RowDescriptor& row_desc) {
+    _types.clear();
+    for (const auto& desc : _descs) {
+        LogicalType type = TYPE_UNKNOWN;
+        for (const auto& slot : row_desc) {
+            if (slot.id == desc.slot_id) {
+                type = slot.type;
+            }
+        }
+        if (type == TYPE_UNKNOWN) {
+            return Status::InvalidArgument("sort slot " + std::to_string(desc.slot_id) + " is not in the input");
+        }
+        // Bitmaps have no order, and their bytes none that means anything.
+        if (type == TYPE_BITMAP) {
+            return Status::InvalidArgument("sort by the BITMAP slot " + std::to_string(desc.slot_id));
+        }
+        _types.push_back(type);
+    }
+    return Status::OK();
+}
+
+void SortKeyEncoder::encode(const Chunk& chunk, SortKeys* keys) const {
+    size_t num_rows = chunk.num_rows();
+    Columns columns;
+    for (size_t k = 0; k < _descs.size(); ++k) {
+        columns.push_back(
+                ColumnHelper::unfold_const_column(_types[k], num_rows, chunk.get_column_by_slot_id(_descs[k].slot_id)));
+    }
+
+    // Sizes first: fixed-width values add the same to every row, strings
+    // what they take escaped.
+    uint32_t fixed_size = 0;
+    bool has_string = false;
+    for (size_t k = 0; k < _descs.size(); ++k) {
+        fixed_size += 1;
+        if (is_binary_type(_types[k])) {
+            has_string = true;
+        } else {
+            fixed_size += type_dispatch_all(_types[k], [](auto lt) -> uint32_t {
+                constexpr LogicalType LT = decltype(lt)::value;
+                if constexpr (LT == TYPE_VARCHAR) {
+                    return 0;
+                } else {
+                    return sizeof(RunTimeCppType<LT>);
+                }
+            });
+        }
+    }
+    keys->offsets.resize_uninitialized(num_rows + 1);
+    uint32_t* offsets = keys->offsets.data();
+    offsets[0] = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        offsets[i + 1] = offsets[i] + fixed_size;
+    }
+    if (has_string) {
+        Buffer<uint32_t> sizes(num_rows, uint32_t{0});
+        for (size_t k = 0; k < _descs.size(); ++k) {
+            if (!is_binary_type(_types[k])) {
+                continue;
+            }
+            const auto* data = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(columns[k].get()));
+            const NullData* nulls = ColumnHelper::get_null_data(columns[k].get());
+            for (size_t i = 0; i < num_rows; ++i) {
+                sizes[i] += (nulls != nullptr && (*nulls)[i]) ? 2 : encoded_string_size(data->get_slice(i));
+            }
+        }
+        uint32_t extra = 0;
+        for (size_t i = 0; i < num_rows; ++i) {
+            extra += sizes[i];
+            offsets[i + 1] += extra;
+        }
+    }
+
+    keys->bytes.resize_uninitialized(offsets[num_rows]);
+    uint8_t* bytes = keys->bytes.data();
+    Buffer<uint32_t> cursors;
+    cursors.append(offsets, num_rows);
+    for (size_t k = 0; k < _descs.size(); ++k) {
+        const SortDesc& desc = _descs[k];
+        const Column* data = ColumnHelper::get_data_column(columns[k].get());
+        const NullData* nulls = ColumnHelper::get_null_data(columns[k].get());
+        uint8_t null_marker = desc.is_null_first ? kNullFirst : kNullLast;
+        type_dispatch_all(_types[k], [&](auto lt) {
+            constexpr LogicalType LT = decltype(lt)::value;
+            for (size_t i = 0; i < num_rows; ++i) {
+                uint8_t* dst = bytes + cursors[i];
+                bool is_null = nulls != nullptr && (*nulls)[i];
+                *dst++ = is_null ? null_marker : kNotNull;
+                uint8_t* value = dst;
+                if constexpr (LT == TYPE_VARCHAR) {
+                    if (is_null) {
+                        dst[0] = dst[1] = 0;
+                        dst += 2;
+                    } else {
+                        dst = encode_string(static_cast<const BinaryColumn*>(data)->get_slice(i), dst);
+                    }
+                } else {
+                    using CppType = RunTimeCppType<LT>;
+                    if (is_null) {
+                        memset(dst, 0, sizeof(CppType));
+                    } else {
+                        store_big_endian(ordered_bits(reinterpret_cast<const CppType*>(data->raw_data())[i]), dst);
+                    }
+                    dst += sizeof(CppType);
+                }
+                if (!desc.is_asc && !is_null) {
+                    invert(value, dst - value);
+                }
+                cursors[i] = static_cast<uint32_t>(dst - bytes);
+            }
+        });
+    }
+}
+
+} // namespace starrocks
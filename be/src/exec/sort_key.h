@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "column/buffer.h"
+#include "column/chunk.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks {
+
+// One ORDER BY item.
+struct SortDesc {
+    SlotId slot_id = -1;
+    bool is_asc = true;
+    // NULLs sort before every value, in either direction.
+    bool is_null_first = true;
+};
+
+using SortDescs = std::vector<SortDesc>;
+
+// Normalized keys of a batch of rows: row i's key is
+// bytes[offsets[i], offsets[i + 1]).
+struct SortKeys {
+    Buffer<uint8_t> bytes;
+    Buffer<uint32_t> offsets;
+
+    size_t num_rows() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    const uint8_t* data(size_t row) const { return bytes.data() + offsets[row]; }
+    uint32_t size(size_t row) const { return offsets[row + 1] - offsets[row]; }
+};
+
+// Negative, zero or positive as key |a| sorts before, with or after key |b|.
+inline int compare_sort_keys(const uint8_t* a, uint32_t a_size, const uint8_t* b, uint32_t b_size) {
+    int res = memcmp(a, b, std::min(a_size, b_size));
+    return res != 0 ? res : (a_size < b_size ? -1 : (a_size > b_size ? 1 : 0));
+}
+
+// Encodes the ORDER BY values of rows as normalized keys: byte strings whose
+// memcmp order is the sort order, so that sorting and merging compare rows
+// with one memcmp however many keys there are and whatever their types.
+//
+// Every key is a byte telling NULL from not NULL, ordered as is_null_first
+// says, and then the value:
+//  - integers big-endian with the sign bit flipped;
+//  - floating point numbers likewise, except that negative ones have all
+//    their bits flipped; -0.0 encodes as 0.0 and NaN after +inf;
+//  - strings with every 0x00 escaped as 0x00 0xFF and 0x00 0x00 appended, so
+//    that no key is a prefix of another.
+// DESC keys have their value bytes inverted. NULLs are followed by zero bytes,
+// as many as the type's width or two for strings, so that rows with equal
+// keys have equal normalized keys.
+class SortKeyEncoder {
+public:
+    explicit SortKeyEncoder(SortDescs descs) : _descs(std::move(descs)) {}
+
+    // Resolves the types of the ORDER BY slots in |row_desc|.
+    Status prepare(const RowDescriptor& row_desc);
+
+    const SortDescs& descs() const { return _descs; }
+    LogicalType type(size_t idx) const { return _types[idx]; }
+
+    // Replaces |keys| with the keys of the rows of |chunk|.
+    void encode(const Chunk& chunk, SortKeys* keys) const;
+
+private:
+    const SortDescs _descs;
+    std::vector<LogicalType> _types;
+};
+
+} // namespace starrocks
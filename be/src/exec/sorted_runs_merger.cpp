@@ -0,0 +1,113 @@
+#include "exec/sorted_runs_merger.h"
+
+namespace starrocks {
+
+SortedRunsMerger::SortedRunsMerger(const SortKeyEncoder* encoder, std::vector<SortedRunReader> runs)
+        : _encoder(encoder), _cursors(runs.size()) {
+    for (size_t i = 0; i < runs.size(); ++i) {
+        _cursors[i].reader = std::move(runs[i]);
+    }
+}
+
+Status SortedRunsMerger::init() {
+    for (auto& cursor : _cursors) {
+        RETURN_IF_ERROR(_next_chunk(&cursor));
+    }
+    _tree.assign(std::max<size_t>(_cursors.size(), 1), 0);
+    if (_cursors.size() > 1) {
+        _tree[0] = _build(1);
+    }
+    return Status::OK();
+}
+
+Status SortedRunsMerger::_next_chunk(Cursor* cursor) {
+    cursor->row = 0;
+    while (true) {
+        ASSIGN_OR_RETURN(cursor->chunk, cursor->reader());
+        if (cursor->chunk == nullptr) {
+            cursor->keys = SortKeys();
+            return Status::OK();
+        }
+        if (!cursor->chunk->is_empty()) {
+            _encoder->encode(*cursor->chunk, &cursor->keys);
+            return Status::OK();
+        }
+    }
+}
+
+bool SortedRunsMerger::_wins(size_t a, size_t b) const {
+    const Cursor& x = _cursors[a];
+    const Cursor& y = _cursors[b];
+    if (x.chunk == nullptr || y.chunk == nullptr) {
+        return y.chunk == nullptr && (x.chunk != nullptr || a < b);
+    }
+    int res = compare_sort_keys(x.keys.data(x.row), x.keys.size(x.row), y.keys.data(y.row), y.keys.size(y.row));
+    return res < 0 || (res == 0 && a < b);
+}
+
+size_t SortedRunsMerger::_build(size_t node) {
+    size_t k = _cursors.size();
+    if (node >= k) {
+        return node - k;
+    }
+    size_t left = _build(2 * node);
+    size_t right = _build(2 * node + 1);
+    if (_wins(left, right)) {
+        _tree[node] = right;
+        return left;
+    }
+    _tree[node] = left;
+    return right;
+}
+
+void SortedRunsMerger::_replay(size_t run) {
+    size_t winner = run;
+    for (size_t node = (run + _cursors.size()) / 2; node > 0; node /= 2) {
+        if (_wins(_tree[node], winner)) {
+            std::swap(_tree[node], winner);
+        }
+    }
+    _tree[0] = winner;
+}
+
+StatusOr<ChunkPtr> SortedRunsMerger::next(size_t max_rows) {
+    ChunkPtr output;
+    size_t num_rows = 0;
+    // The stretch of rows of one run not copied yet.
+    size_t stretch_run = 0;
+    size_t stretch_begin = 0;
+    size_t stretch_size = 0;
+    auto flush = [&] {
+        if (stretch_size > 0) {
+            const Chunk& chunk = *_cursors[stretch_run].chunk;
+            if (output == nullptr) {
+                output = chunk.clone_empty(max_rows);
+            }
+            output->append(chunk, stretch_begin, stretch_size);
+            stretch_size = 0;
+        }
+    };
+    while (num_rows < max_rows && !_cursors.empty()) {
+        size_t run = _tree[0];
+        Cursor& cursor = _cursors[run];
+        if (cursor.chunk == nullptr) {
+            break;
+        }
+        if (stretch_size == 0 || run != stretch_run) {
+            flush();
+            stretch_run = run;
+            stretch_begin = cursor.row;
+        }
+        ++stretch_size;
+        ++num_rows;
+        if (++cursor.row == cursor.chunk->num_rows()) {
+            flush();
+            RETURN_IF_ERROR(_next_chunk(&cursor));
+        }
+        _replay(run);
+    }
+    flush();
+    return output;
+}
+
+} // namespace starrocks
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "exec/sort_key.h"
+
+namespace starrocks {
+
+// Hands out the chunks of one sorted run in order; nullptr after the last.
+using SortedRunReader = std::function<StatusOr<ChunkPtr>()>;
+
+// K-way merge of sorted runs through a loser tree: the tree remembers the
+// loser of every match between runs, so that after the overall winner's run
+// moves on, finding the next winner replays only the matches on that run's
+// path, log2(k) comparisons of normalized keys. Stretches of consecutive
+// rows coming from one run are copied to the output in one go.
+//
+// Only the current chunk of each run is in memory, plus its keys.
+class SortedRunsMerger {
+public:
+    SortedRunsMerger(const SortKeyEncoder* encoder, std::vector<SortedRunReader> runs);
+
+    DISALLOW_COPY_AND_MOVE(SortedRunsMerger);
+
+    // Reads the first chunk of every run.
+    Status init();
+
+    // The next at most |max_rows| rows; nullptr after the last one.
+    StatusOr<ChunkPtr> next(size_t max_rows);
+
+private:
+    struct Cursor {
+        SortedRunReader reader;
+        ChunkPtr chunk;
+        SortKeys keys;
+        size_t row = 0;
+    };
+
+    // Moves |cursor| to the first row of the run's next non-empty chunk.
+    Status _next_chunk(Cursor* cursor);
+    // Whether the current row of run |a| goes before that of run |b|; runs
+    // that are done go last, ties go to the lower run.
+    bool _wins(size_t a, size_t b) const;
+    size_t _build(size_t node);
+    // The run that won last has moved on; replays its matches.
+    void _replay(size_t run);
+
+    const SortKeyEncoder* _encoder;
+    std::vector<Cursor> _cursors;
+    // _tree[0] is the winner, _tree[i] the loser of the match at inner node
+    // i; run j is leaf k + j of the implicit binary tree.
+    std::vector<size_t> _tree;
+};
+
+} // namespace starrocks
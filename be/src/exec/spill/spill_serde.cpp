@@ -0,0 +1,148 @@
+#include "exec/spill/spill_serde.h"
+
+#include <cstring>
+
+#include "column/column_helper.h"
+
+namespace starrocks::spill {
+
+static size_t serialized_column_size(const Column* column, size_t num_rows) {
+    size_t size = 1;
+    if (column->is_nullable()) {
+        size += num_rows;
+        column = ColumnHelper::get_data_column(column);
+    }
+    if (column->is_binary()) {
+        const auto* binary = static_cast<const BinaryColumn*>(column);
+        size += (num_rows + 1) * sizeof(uint32_t) + binary->get_offset()[num_rows] - binary->get_offset()[0];
+    } else {
+        size += num_rows * column->type_size();
+    }
+    return size;
+}
+
+static Columns columns_of(const Chunk& chunk, const RowDescriptor& desc) {
+    Columns columns;
+    columns.reserve(desc.size());
+    for (const auto& slot : desc) {
+        columns.emplace_back(
+                ColumnHelper::unfold_const_column(slot.type, chunk.num_rows(), chunk.get_column_by_slot_id(slot.id)));
+    }
+    return columns;
+}
+
+size_t serialized_chunk_size(const Chunk& chunk, const RowDescriptor& desc) {
+    size_t size = 0;
+    for (const auto& column : columns_of(chunk, desc)) {
+        size += serialized_column_size(column.get(), chunk.num_rows());
+    }
+    return size;
+}
+
+void serialize_chunk(const Chunk& chunk, const RowDescriptor& desc, Buffer<uint8_t>* output) {
+    size_t num_rows = chunk.num_rows();
+    Columns columns = columns_of(chunk, desc);
+    size_t total = 0;
+    for (const auto& column : columns) {
+        total += serialized_column_size(column.get(), num_rows);
+    }
+    output->resize_uninitialized(total);
+    uint8_t* p = output->data();
+
+    for (const auto& column : columns) {
+        const Column* data = column.get();
+        *p++ = column->is_nullable();
+        if (column->is_nullable()) {
+            const auto* nullable = static_cast<const NullableColumn*>(data);
+            memcpy(p, nullable->null_column_data().data(), num_rows);
+            p += num_rows;
+            data = nullable->data_column().get();
+        }
+        if (data->is_binary()) {
+            const auto* binary = static_cast<const BinaryColumn*>(data);
+            const auto& offsets = binary->get_offset();
+            uint32_t base = offsets[0];
+            if (base == 0) {
+                memcpy(p, offsets.data(), (num_rows + 1) * sizeof(uint32_t));
+                p += (num_rows + 1) * sizeof(uint32_t);
+            } else {
+                for (size_t i = 0; i <= num_rows; ++i) {
+                    uint32_t v = offsets[i] - base;
+                    memcpy(p, &v, sizeof(v));
+                    p += sizeof(v);
+                }
+            }
+            size_t len = offsets[num_rows] - base;
+            memcpy(p, binary->get_bytes().data() + base, len);
+            p += len;
+        } else {
+            size_t len = num_rows * data->type_size();
+            memcpy(p, data->raw_data(), len);
+            p += len;
+        }
+    }
+}
+
+StatusOr<ChunkPtr> deserialize_chunk(const uint8_t* data, size_t len, size_t num_rows, const RowDescriptor& desc) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    auto take = [&](size_t n) -> const uint8_t* {
+        if (static_cast<size_t>(end - p) < n) {
+            return nullptr;
+        }
+        const uint8_t* res = p;
+        p += n;
+        return res;
+    };
+
+    auto chunk = std::make_shared<Chunk>();
+    for (const auto& slot : desc) {
+        const uint8_t* flag = take(1);
+        if (flag == nullptr) {
+            return Status::Corruption("spill block truncated");
+        }
+        bool nullable = *flag != 0;
+        ColumnPtr column = ColumnHelper::create_column(slot.type, nullable);
+        Column* target = column.get();
+        if (nullable) {
+            auto* n = static_cast<NullableColumn*>(target);
+            const uint8_t* nulls = take(num_rows);
+            if (nulls == nullptr) {
+                return Status::Corruption("spill block truncated");
+            }
+            n->null_column_data().append(nulls, num_rows);
+            n->update_has_null();
+            target = n->data_column().get();
+        }
+        if (target->is_binary()) {
+            auto* binary = static_cast<BinaryColumn*>(target);
+            const uint8_t* raw_offsets = take((num_rows + 1) * sizeof(uint32_t));
+            if (raw_offsets == nullptr) {
+                return Status::Corruption("spill block truncated");
+            }
+            auto& offsets = binary->get_offset();
+            offsets.resize_uninitialized(num_rows + 1);
+            memcpy(offsets.data(), raw_offsets, (num_rows + 1) * sizeof(uint32_t));
+            const uint8_t* bytes = take(offsets[num_rows]);
+            if (offsets[0] != 0 || bytes == nullptr) {
+                return Status::Corruption("spill block has bad offsets");
+            }
+            binary->get_bytes().append(bytes, offsets[num_rows]);
+        } else {
+            size_t bytes_len = num_rows * target->type_size();
+            const uint8_t* bytes = take(bytes_len);
+            if (bytes == nullptr) {
+                return Status::Corruption("spill block truncated");
+            }
+            target->resize_uninitialized(num_rows);
+            memcpy(target->mutable_raw_data(), bytes, bytes_len);
+        }
+        chunk->append_column(std::move(column), slot.id);
+    }
+    if (p != end) {
+        return Status::Corruption("spill block has trailing bytes");
+    }
+    return chunk;
+}
+
+} // namespace starrocks::spill
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "column/buffer.h"
+#include "column/chunk.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks::spill {
+
+// Columnar wire layout of one spilled chunk. For each slot of the row
+// descriptor, in order:
+//   u8 nullable, [null map: num_rows bytes], then the data column:
+//   fixed width: num_rows * width bytes
+//   binary:      (num_rows + 1) u32 offsets starting at 0, then the bytes
+// The row count and the descriptor are known to the reader, so the layout
+// carries no types.
+size_t serialized_chunk_size(const Chunk& chunk, const RowDescriptor& desc);
+void serialize_chunk(const Chunk& chunk, const RowDescriptor& desc, Buffer<uint8_t>* output);
+StatusOr<ChunkPtr> deserialize_chunk(const uint8_t* data, size_t len, size_t num_rows, const RowDescriptor& desc);
+
+} // namespace starrocks::spill
@@ -0,0 +1,397 @@
+#include "exec/spill/spiller.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "column/column_helper.h"
+#include "common/config.h"
+#include "exec/spill/spill_serde.h"
+#include "runtime/current_thread.h"
+#include "util/hash_util.h"
+#include "util/stopwatch.h"
+
+namespace starrocks::spill {
+
+namespace {
+
+constexpr uint32_t kBlockMagic = 0x4C505352; // "RSPL"
+
+struct BlockHeader {
+    uint32_t magic;
+    // Low 32 bits of HashUtil::hash_bytes() of the stored payload.
+    uint32_t checksum;
+    uint32_t num_rows;
+    uint8_t compression;
+    uint8_t unused[3];
+    uint64_t raw_size;
+    uint64_t stored_size;
+};
+static_assert(sizeof(BlockHeader) == 32);
+
+uint32_t block_checksum(const uint8_t* data, size_t len) {
+    return static_cast<uint32_t>(HashUtil::hash_bytes(data, len));
+}
+
+Status io_error(const std::string& what) {
+    return Status::IOError(what + ": " + std::strerror(errno));
+}
+
+Status write_fully(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return io_error("spill write failed");
+        }
+        data += n;
+        len -= n;
+    }
+    return Status::OK();
+}
+
+// Returns the number of bytes read, short only at end of file.
+StatusOr<size_t> pread_fully(int fd, uint8_t* data, size_t len, int64_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(fd, data + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return io_error("spill read failed");
+        }
+        if (n == 0) {
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+std::atomic<int64_t> s_next_spiller_id{0};
+
+} // namespace
+
+SpillStreamReader::SpillStreamReader(int fd, RowDescriptor desc) : _fd(fd), _desc(std::move(desc)) {}
+
+SpillStreamReader::~SpillStreamReader() {
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+Status SpillStreamReader::get_next(ChunkPtr* chunk) {
+    if (_fd < 0) {
+        return Status::EndOfFile("spill stream is empty");
+    }
+    BlockHeader header;
+    ASSIGN_OR_RETURN(size_t n, pread_fully(_fd, reinterpret_cast<uint8_t*>(&header), sizeof(header), _offset));
+    if (n == 0) {
+        return Status::EndOfFile("end of spill stream");
+    }
+    if (n != sizeof(header) || header.magic != kBlockMagic) {
+        return Status::Corruption("bad spill block header");
+    }
+    _stored.resize_uninitialized(header.stored_size);
+    ASSIGN_OR_RETURN(n, pread_fully(_fd, _stored.data(), header.stored_size, _offset + sizeof(header)));
+    if (n != header.stored_size || block_checksum(_stored.data(), n) != header.checksum) {
+        return Status::Corruption("spill block checksum mismatch");
+    }
+    _offset += sizeof(header) + header.stored_size;
+
+    const uint8_t* raw = _stored.data();
+    auto compression = static_cast<CompressionType>(header.compression);
+    if (compression != CompressionType::NO_COMPRESSION) {
+        ASSIGN_OR_RETURN(const BlockCompressionCodec* codec, get_block_compression_codec(compression));
+        _raw.resize_uninitialized(header.raw_size);
+        RETURN_IF_ERROR(codec->decompress(Slice(_stored.data(), _stored.size()), _raw.data(), header.raw_size));
+        raw = _raw.data();
+    } else if (header.raw_size != header.stored_size) {
+        return Status::Corruption("bad spill block size");
+    }
+    ASSIGN_OR_RETURN(*chunk, deserialize_chunk(raw, header.raw_size, header.num_rows, _desc));
+    return Status::OK();
+}
+
+Spiller::Spiller(std::string dir, std::string name, ThreadPool* io_pool, MemTracker* mem_tracker,
+                 IoEventCallback on_io_event)
+        : _dir(std::move(dir)),
+          _name(std::move(name) + "-" + std::to_string(s_next_spiller_id.fetch_add(1))),
+          _io_pool(io_pool),
+          _mem_tracker(mem_tracker),
+          _on_io_event(std::move(on_io_event)) {
+    auto codec = get_block_compression_codec(static_cast<CompressionType>(config::spill_compression));
+    if (codec.ok()) {
+        _codec = codec.value();
+    }
+}
+
+Spiller::~Spiller() {
+    for (auto& stream : _streams) {
+        if (stream.fd >= 0) {
+            ::close(stream.fd);
+        }
+    }
+}
+
+size_t Spiller::add_stream(RowDescriptor desc) {
+    std::lock_guard<std::mutex> l(_lock);
+    _streams.emplace_back();
+    _streams.back().id = _streams.size() - 1;
+    _streams.back().desc = std::move(desc);
+    return _streams.size() - 1;
+}
+
+size_t Spiller::num_streams() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _streams.size();
+}
+
+Status Spiller::append(size_t stream, ChunkPtr chunk) {
+    if (chunk == nullptr || chunk->num_rows() == 0) {
+        return Status::OK();
+    }
+    int64_t bytes = chunk->memory_usage();
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (!_io_status.ok()) {
+            return _io_status;
+        }
+        _pending.push_back({stream, std::move(chunk), bytes});
+        _pending_bytes += bytes;
+        if (_writing) {
+            return Status::OK();
+        }
+        _writing = true;
+    }
+    // The task keeps the Spiller alive until the queue drains, even if its
+    // owner goes away meanwhile.
+    Status st = _io_pool->submit([self = shared_from_this()] { self->_write_task(); });
+    if (!st.ok()) {
+        std::lock_guard<std::mutex> l(_lock);
+        _writing = false;
+        _pending.clear();
+        _pending_bytes = 0;
+        _io_status = st;
+    }
+    return st;
+}
+
+bool Spiller::is_backlogged() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _pending_bytes > config::spill_max_pending_bytes;
+}
+
+bool Spiller::has_pending_writes() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _writing;
+}
+
+void Spiller::_write_task() {
+    for (;;) {
+        PendingWrite write;
+        Stream* stream;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            if (_pending.empty() || !_io_status.ok()) {
+                _pending.clear();
+                _pending_bytes = 0;
+                _writing = false;
+                break;
+            }
+            write = std::move(_pending.front());
+            _pending.pop_front();
+            stream = &_streams[write.stream];
+        }
+
+        Status st;
+        {
+            // Gone before _writing drops below, after which the owner may
+            // destroy the tracker.
+            ScopedThreadMemTracker mem_scope(_mem_tracker);
+            st = _write_block(stream, *write.chunk);
+            write.chunk.reset();
+        }
+
+        bool unblocked;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            unblocked = _pending_bytes > config::spill_max_pending_bytes;
+            _pending_bytes -= write.bytes;
+            unblocked &= _pending_bytes <= config::spill_max_pending_bytes;
+            if (!st.ok() && _io_status.ok()) {
+                _io_status = st;
+            }
+        }
+        if (unblocked && _on_io_event) {
+            _on_io_event();
+        }
+    }
+    if (_on_io_event) {
+        _on_io_event();
+    }
+}
+
+Status Spiller::_write_block(Stream* stream, const Chunk& chunk) {
+    int64_t start = monotonic_nanos();
+    if (stream->fd < 0) {
+        std::string path = _dir + "/" + _name + "-" + std::to_string(stream->id);
+        int fd = ::open(path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            return io_error("failed to create spill file " + path);
+        }
+        // Readers get their own descriptor, so the name is not needed.
+        ::unlink(path.c_str());
+        stream->fd = fd;
+    }
+
+    serialize_chunk(chunk, stream->desc, &_raw_buf);
+    size_t raw_size = _raw_buf.size();
+    BlockHeader header{};
+    header.magic = kBlockMagic;
+    header.num_rows = static_cast<uint32_t>(chunk.num_rows());
+    header.raw_size = raw_size;
+
+    size_t stored_size = raw_size;
+    header.compression = static_cast<uint8_t>(CompressionType::NO_COMPRESSION);
+    if (_codec != nullptr && _codec->type() != CompressionType::NO_COMPRESSION) {
+        _block_buf.resize_uninitialized(sizeof(header) + _codec->max_compressed_len(raw_size));
+        size_t compressed_size = 0;
+        RETURN_IF_ERROR(
+                _codec->compress(Slice(_raw_buf.data(), raw_size), _block_buf.data() + sizeof(header), &compressed_size));
+        // Keep incompressible blocks raw.
+        if (compressed_size < raw_size) {
+            stored_size = compressed_size;
+            header.compression = static_cast<uint8_t>(_codec->type());
+        }
+    }
+    if (header.compression == static_cast<uint8_t>(CompressionType::NO_COMPRESSION)) {
+        _block_buf.resize_uninitialized(sizeof(header) + raw_size);
+        memcpy(_block_buf.data() + sizeof(header), _raw_buf.data(), raw_size);
+    }
+    _block_buf.resize_uninitialized(sizeof(header) + stored_size);
+    header.stored_size = stored_size;
+    header.checksum = block_checksum(_block_buf.data() + sizeof(header), stored_size);
+    memcpy(_block_buf.data(), &header, sizeof(header));
+    RETURN_IF_ERROR(write_fully(stream->fd, _block_buf.data(), _block_buf.size()));
+
+    stream->rows += chunk.num_rows();
+    _spilled_rows.fetch_add(chunk.num_rows(), std::memory_order_relaxed);
+    _spilled_raw_bytes.fetch_add(raw_size, std::memory_order_relaxed);
+    _spilled_bytes.fetch_add(_block_buf.size(), std::memory_order_relaxed);
+    _write_time_ns.fetch_add(monotonic_nanos() - start, std::memory_order_relaxed);
+    return Status::OK();
+}
+
+StatusOr<SpillStreamReaderPtr> Spiller::open_reader(size_t stream_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_io_status.ok()) {
+        return _io_status;
+    }
+    if (_writing) {
+        return Status::InternalError("spill stream opened with writes in flight");
+    }
+    const Stream& stream = _streams[stream_id];
+    int fd = -1;
+    if (stream.fd >= 0) {
+        fd = ::dup(stream.fd);
+        if (fd < 0) {
+            return io_error("failed to open spill stream");
+        }
+    }
+    return std::make_unique<SpillStreamReader>(fd, stream.desc);
+}
+
+PartitionedSpillWriter::PartitionedSpillWriter(SpillerPtr spiller, const RowDescriptor& desc, size_t num_partitions,
+                                               size_t chunk_size)
+        : _spiller(std::move(spiller)),
+          _desc(desc),
+          _chunk_size(chunk_size),
+          _buffers(num_partitions),
+          _indexes(num_partitions) {
+    for (size_t i = 0; i < num_partitions; ++i) {
+        _streams.push_back(_spiller->add_stream(desc));
+    }
+}
+
+Status PartitionedSpillWriter::append(const Chunk& chunk, const uint32_t* partitions, uint32_t from, uint32_t size) {
+    for (auto& indexes : _indexes) {
+        indexes.clear();
+    }
+    for (uint32_t i = from; i < from + size; ++i) {
+        _indexes[partitions[i]].push_back(i);
+    }
+    Columns columns;
+    columns.reserve(_desc.size());
+    for (const auto& slot : _desc) {
+        columns.emplace_back(
+                ColumnHelper::unfold_const_column(slot.type, chunk.num_rows(), chunk.get_column_by_slot_id(slot.id)));
+    }
+    for (size_t p = 0; p < _indexes.size(); ++p) {
+        const auto& indexes = _indexes[p];
+        if (indexes.empty()) {
+            continue;
+        }
+        RETURN_IF_ERROR(_prepare_buffer(p, columns));
+        uint32_t offset = 0;
+        while (offset < indexes.size()) {
+            Chunk& buffer = *_buffers[p];
+            uint32_t n = std::min<uint32_t>(indexes.size() - offset, _chunk_size - buffer.num_rows());
+            for (size_t i = 0; i < columns.size(); ++i) {
+                buffer.get_column_by_index(i)->append_selective(*columns[i], indexes.data(), offset, n);
+            }
+            offset += n;
+            if (buffer.num_rows() >= _chunk_size) {
+                RETURN_IF_ERROR(_flush_partition(p));
+                RETURN_IF_ERROR(_prepare_buffer(p, columns));
+            }
+        }
+    }
+    return Status::OK();
+}
+
+Status PartitionedSpillWriter::_prepare_buffer(size_t partition, const Columns& columns) {
+    // Buffers take the nullability of the incoming columns, which stays the
+    // same across the chunks of one input in practice; start a new chunk if
+    // it does not.
+    ChunkPtr& buffer = _buffers[partition];
+    if (buffer != nullptr) {
+        bool same_layout = true;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            same_layout &= buffer->get_column_by_index(i)->is_nullable() == columns[i]->is_nullable();
+        }
+        if (same_layout) {
+            return Status::OK();
+        }
+        RETURN_IF_ERROR(_flush_partition(partition));
+    }
+    buffer = std::make_shared<Chunk>();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        ColumnPtr column = columns[i]->clone_empty();
+        column->reserve(_chunk_size);
+        buffer->append_column(std::move(column), _desc[i].id);
+    }
+    return Status::OK();
+}
+
+Status PartitionedSpillWriter::flush() {
+    for (size_t p = 0; p < _buffers.size(); ++p) {
+        RETURN_IF_ERROR(_flush_partition(p));
+    }
+    return Status::OK();
+}
+
+Status PartitionedSpillWriter::_flush_partition(size_t partition) {
+    ChunkPtr buffer = std::move(_buffers[partition]);
+    if (buffer == nullptr || buffer->num_rows() == 0) {
+        return Status::OK();
+    }
+    return _spiller->append(_streams[partition], std::move(buffer));
+}
+
+} // namespace starrocks::spill
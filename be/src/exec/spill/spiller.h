@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "column/buffer.h"
+#include "column/chunk.h"
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "util/block_compression.h"
+#include "util/threadpool.h"
+
+namespace starrocks::spill {
+
+// Sequential reader of one spilled stream. Reads and decompresses one block
+// per call on the calling thread; blocks are a chunk each, so a call costs
+// about one chunk worth of I/O.
+class SpillStreamReader {
+public:
+    SpillStreamReader(int fd, RowDescriptor desc);
+    ~SpillStreamReader();
+
+    DISALLOW_COPY_AND_MOVE(SpillStreamReader);
+
+    // Returns EndOfFile after the last chunk.
+    Status get_next(ChunkPtr* chunk);
+
+private:
+    const int _fd;
+    const RowDescriptor _desc;
+    int64_t _offset = 0;
+    Buffer<uint8_t> _stored;
+    Buffer<uint8_t> _raw;
+};
+
+using SpillStreamReaderPtr = std::unique_ptr<SpillStreamReader>;
+
+// Writes chunks of one operator to local disk so that it can release the
+// memory they hold, and reads them back later.
+//
+// A Spiller holds any number of streams, each an append-only sequence of
+// chunks of one RowDescriptor backed by its own file: a grace hash join
+// uses one stream per partition and side, a sort one per sorted run. Each
+// chunk becomes one block, serialized column by column and compressed with
+// config::spill_compression.
+//
+// append() only queues the chunk. Serialization, compression and the write
+// run on the spill I/O pool, one task per Spiller at a time, so a stream's
+// blocks land in append order and pipeline workers never block on disk.
+// Callers throttle themselves with is_backlogged() and are told through
+// |on_io_event| when queued writes drain, typically to wake parked drivers.
+//
+// Write tasks run with |mem_tracker| installed, so that the queued chunks they
+// release and the buffers they grow are accounted to the owner; the owner must
+// keep the tracker alive until has_pending_writes() turns false.
+//
+// Files are unlinked as soon as they are created, so they disappear with the
+// Spiller (or the process) no matter how the query ends.
+class Spiller : public std::enable_shared_from_this<Spiller> {
+public:
+    using IoEventCallback = std::function<void()>;
+
+    Spiller(std::string dir, std::string name, ThreadPool* io_pool, MemTracker* mem_tracker,
+            IoEventCallback on_io_event);
+    ~Spiller();
+
+    DISALLOW_COPY_AND_MOVE(Spiller);
+
+    // Returns the id of a new, empty stream.
+    size_t add_stream(RowDescriptor desc);
+    size_t num_streams() const;
+
+    // Queues |chunk| to be written to |stream|. Fails with the error of an
+    // earlier write, if any; the chunk must not be modified afterwards.
+    Status append(size_t stream, ChunkPtr chunk);
+
+    // More than config::spill_max_pending_bytes are queued.
+    bool is_backlogged() const;
+    bool has_pending_writes() const;
+
+    // Opens |stream| for reading; all writes must have completed.
+    StatusOr<SpillStreamReaderPtr> open_reader(size_t stream);
+
+    int64_t spilled_rows() const { return _spilled_rows.load(std::memory_order_relaxed); }
+    // Bytes before and after compression.
+    int64_t spilled_raw_bytes() const { return _spilled_raw_bytes.load(std::memory_order_relaxed); }
+    int64_t spilled_bytes() const { return _spilled_bytes.load(std::memory_order_relaxed); }
+    int64_t write_time_ns() const { return _write_time_ns.load(std::memory_order_relaxed); }
+
+private:
+    struct Stream {
+        size_t id = 0;
+        RowDescriptor desc;
+        int fd = -1;
+        int64_t rows = 0;
+    };
+    struct PendingWrite {
+        size_t stream;
+        ChunkPtr chunk;
+        int64_t bytes;
+    };
+
+    void _write_task();
+    Status _write_block(Stream* stream, const Chunk& chunk);
+
+    const std::string _dir;
+    const std::string _name;
+    ThreadPool* _io_pool;
+    MemTracker* _mem_tracker;
+    IoEventCallback _on_io_event;
+    const BlockCompressionCodec* _codec = nullptr;
+
+    mutable std::mutex _lock;
+    // Streams are only appended to; elements are stable so the write task
+    // may use one without holding |_lock|.
+    std::deque<Stream> _streams;
+    std::deque<PendingWrite> _pending;
+    int64_t _pending_bytes = 0;
+    bool _writing = false;
+    Status _io_status;
+
+    // Only touched by the write task.
+    Buffer<uint8_t> _raw_buf;
+    Buffer<uint8_t> _block_buf;
+
+    std::atomic<int64_t> _spilled_rows{0};
+    std::atomic<int64_t> _spilled_raw_bytes{0};
+    std::atomic<int64_t> _spilled_bytes{0};
+    std::atomic<int64_t> _write_time_ns{0};
+};
+
+using SpillerPtr = std::shared_ptr<Spiller>;
+
+// Splits chunks into |num_partitions| streams of a Spiller by a per-row
+// partition number, gathering rows into full chunks per partition before
+// handing them over. Not thread-safe.
+class PartitionedSpillWriter {
+public:
+    PartitionedSpillWriter(SpillerPtr spiller, const RowDescriptor& desc, size_t num_partitions, size_t chunk_size);
+
+    // Spills rows [from, from + size) of |chunk|; |partitions| holds the
+    // partition of every row of the chunk.
+    Status append(const Chunk& chunk, const uint32_t* partitions, uint32_t from, uint32_t size);
+    // Spills the partially filled chunks.
+    Status flush();
+
+    size_t num_partitions() const { return _streams.size(); }
+    size_t stream(size_t partition) const { return _streams[partition]; }
+
+private:
+    Status _prepare_buffer(size_t partition, const Columns& columns);
+    Status _flush_partition(size_t partition);
+
+    SpillerPtr _spiller;
+    const RowDescriptor _desc;
+    const size_t _chunk_size;
+    std::vector<size_t> _streams;
+    std::vector<ChunkPtr> _buffers;
+    std::vector<Buffer<uint32_t>> _indexes;
+};
+
+} // namespace starrocks::spill
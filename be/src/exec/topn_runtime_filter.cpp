@@ -0,0 +1,105 @@
+#include "exec/topn_runtime_filter.h"
+
+#include <cstring>
+
+#include "column/column_helper.h"
+
+namespace starrocks {
+
+TopNRuntimeFilter::TopNRuntimeFilter(LogicalType type, ColumnId column_id, bool is_asc, bool is_null_first)
+        : ColumnPredicate(type, column_id), _is_asc(is_asc), _is_null_first(is_null_first) {}
+
+bool TopNRuntimeFilter::_sorts_before(const Datum& a, const Datum& b) const {
+    if (a.is_null() || b.is_null()) {
+        return a.is_null() != b.is_null() && a.is_null() == _is_null_first;
+    }
+    return type_dispatch_all(_type, [&](auto lt) {
+        constexpr LogicalType LT = decltype(lt)::value;
+        using CppType = RunTimeCppType<LT>;
+        const auto& x = a.get<CppType>();
+        const auto& y = b.get<CppType>();
+        return _is_asc ? x < y : y < x;
+    });
+}
+
+void TopNRuntimeFilter::update(const Column& column, size_t row) {
+    Datum value = column.get(row);
+    std::lock_guard<std::mutex> l(_lock);
+    if (_cut_off != nullptr && !_sorts_before(value, _cut_off->get(0))) {
+        return;
+    }
+    ColumnPtr cut_off = ColumnHelper::create_column(_type, true);
+    cut_off->append_datum(value);
+    _cut_off = std::move(cut_off);
+    Datum owned = _cut_off->get(0);
+    if (owned.is_null()) {
+        // Only NULLs sort before or with a NULL, and after it everything does.
+        _predicate = _is_null_first ? new_column_null_predicate(_type, _column_id, true) : nullptr;
+    } else {
+        _predicate = new_column_cmp_predicate(_is_asc ? CompareOp::LE : CompareOp::GE, _type, _column_id, owned);
+    }
+}
+
+std::shared_ptr<const ColumnPredicate> TopNRuntimeFilter::_current() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _predicate;
+}
+
+void TopNRuntimeFilter::evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        memset(selection + from, 1, to - from);
+        return;
+    }
+    predicate->evaluate(column, selection, from, to);
+    if (!_is_null_first) {
+        return;
+    }
+    if (column->is_constant()) {
+        if (column->only_null()) {
+            memset(selection + from, 1, to - from);
+        }
+        return;
+    }
+    const NullData* nulls = ColumnHelper::get_null_data(column);
+    if (nulls != nullptr) {
+        for (size_t i = from; i < to; ++i) {
+            selection[i] |= (*nulls)[i];
+        }
+    }
+}
+
+size_t TopNRuntimeFilter::evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        return sel_size;
+    }
+    if (!_is_null_first || sel_size == 0) {
+        return predicate->evaluate_branchless(column, sel, sel_size);
+    }
+    // NULLs pass as well, which the wrapped predicate does not know about.
+    Filter selection(sel[sel_size - 1] + 1);
+    evaluate(column, selection.data(), sel[0], selection.size());
+    size_t count = 0;
+    for (size_t i = 0; i < sel_size; ++i) {
+        sel[count] = sel[i];
+        count += selection[sel[i]];
+    }
+    return count;
+}
+
+bool TopNRuntimeFilter::can_pass_null() const {
+    return _is_null_first || _current() == nullptr;
+}
+
+bool TopNRuntimeFilter::zone_map_filter(const ZoneMapDetail& zone_map) const {
+    auto predicate = _current();
+    return predicate == nullptr || (zone_map.has_null && _is_null_first) || predicate->zone_map_filter(zone_map);
+}
+
+std::string TopNRuntimeFilter::debug_string() const {
+    auto predicate = _current();
+    return "(TOP-N " + (predicate == nullptr ? std::string("no cut-off") : predicate->debug_string()) + ")";
+}
+
+} // namespace starrocks
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "column/column.h"
+#include "storage/column_predicate.h"
+
+namespace starrocks {
+
+// The cut-off of an ORDER BY ... LIMIT, published by its Top-N sort to the
+// scan below it as a predicate on the scanned column of the first sort key.
+//
+// Once a Top-N driver holds N rows, only rows sorting before the last of them
+// can still make it into the result, and those cannot have a first key that
+// sorts after that row's. The sort offers that key every time its N rows
+// change; the filter keeps the tightest offer, and scans drop rows, pages and
+// segments whose first key sorts after it. Rows with an equal first key pass:
+// later keys may still put them ahead.
+//
+// The bound only ever tightens, and is read once per batch of rows, so scans
+// running concurrently with the sort see it shrink as the sort goes.
+class TopNRuntimeFilter final : public ColumnPredicate {
+public:
+    // Value comparisons do not order NaN and -0.0 as the sort does, so
+    // floating point keys get no filter.
+    static bool is_supported_type(LogicalType type) { return type != TYPE_UNKNOWN && !is_float_type(type); }
+
+    TopNRuntimeFilter(LogicalType type, ColumnId column_id, bool is_asc, bool is_null_first);
+
+    // Offers the value at |row| of |column|, a column of the filter's type
+    // that may be nullable or constant, as the cut-off.
+    void update(const Column& column, size_t row);
+
+    PredicateType type() const override { return PredicateType::kTopN; }
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override;
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override;
+    bool can_pass_null() const override;
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override;
+    std::string debug_string() const override;
+
+private:
+    // Whether |a| sorts strictly before |b|; either may be NULL.
+    bool _sorts_before(const Datum& a, const Datum& b) const;
+    std::shared_ptr<const ColumnPredicate> _current() const;
+
+    const bool _is_asc;
+    const bool _is_null_first;
+
+    mutable std::mutex _lock;
+    // The cut-off, as a one-row nullable column; null before the first offer.
+    ColumnPtr _cut_off;
+    // Which rows pass, NULLs aside; null while all of them do.
+    std::shared_ptr<const ColumnPredicate> _predicate;
+};
+
+using TopNRuntimeFilterPtr = std::shared_ptr<TopNRuntimeFilter>;
+
+} // namespace starrocks
@@ -0,0 +1,471 @@
+#include "exec/window_function.h"
+
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "column/column_helper.h"
+
+namespace starrocks {
+
+const char* window_function_name(WindowFunctionType type) {
+    switch (type) {
+    case WindowFunctionType::ROW_NUMBER:
+        return "row_number";
+    case WindowFunctionType::RANK:
+        return "rank";
+    case WindowFunctionType::DENSE_RANK:
+        return "dense_rank";
+    case WindowFunctionType::LAG:
+        return "lag";
+    case WindowFunctionType::LEAD:
+        return "lead";
+    case WindowFunctionType::COUNT:
+        return "count";
+    case WindowFunctionType::SUM:
+        return "sum";
+    case WindowFunctionType::AVG:
+        return "avg";
+    case WindowFunctionType::MIN:
+        return "min";
+    case WindowFunctionType::MAX:
+        return "max";
+    }
+    return "unknown";
+}
+
+bool is_ranking_function(WindowFunctionType type) {
+    return type == WindowFunctionType::ROW_NUMBER || type == WindowFunctionType::RANK ||
+           type == WindowFunctionType::DENSE_RANK;
+}
+
+// Data column of |column|, and its null map or nullptr when no row is NULL.
+static const Column* unpack_nullable(const Column* column, const uint8_t** nulls) {
+    const NullData* null_data = ColumnHelper::get_null_data(column);
+    *nulls = null_data == nullptr ? nullptr : null_data->data();
+    return ColumnHelper::get_data_column(column);
+}
+
+static NullableColumn* as_nullable(Column* column) {
+    return static_cast<NullableColumn*>(column);
+}
+
+template <LogicalType LT>
+static void append_value(Column* data, const RunTimeCppType<LT>& value) {
+    if constexpr (is_binary_type(LT)) {
+        static_cast<BinaryColumn*>(data)->append(value);
+    } else {
+        static_cast<RunTimeColumnType<LT>*>(data)->get_data().push_back(value);
+    }
+}
+
+template <LogicalType LT>
+static RunTimeCppType<LT> value_at(const Column* data, size_t i) {
+    if constexpr (is_binary_type(LT)) {
+        return static_cast<const BinaryColumn*>(data)->get_slice(i);
+    } else {
+        return reinterpret_cast<const RunTimeCppType<LT>*>(data->raw_data())[i];
+    }
+}
+
+// Moves the frame kept in [*lo, *hi) to [start, end), adding the rows that
+// enter it and removing those that leave it; starts over from an empty frame
+// when the new one is not ahead of the old one or does not overlap it.
+template <typename Add, typename Remove, typename Clear>
+static void slide_frame(int64_t* lo, int64_t* hi, int64_t start, int64_t end, Add&& add, Remove&& remove,
+                        Clear&& clear) {
+    if (start < *lo || end < *hi || start >= *hi) {
+        clear();
+        *lo = *hi = start;
+    }
+    for (; *hi < end; ++*hi) {
+        add(*hi);
+    }
+    for (; *lo < start; ++*lo) {
+        remove(*lo);
+    }
+}
+
+// Local to this file: aggregate_function.cpp has a CountFunction and a
+// MinMaxFunction of its own.
+namespace {
+
+template <WindowFunctionType Type>
+class RankingFunction final : public WindowFunction {
+public:
+    WindowFunctionType type() const override { return Type; }
+    LogicalType result_type() const override { return TYPE_BIGINT; }
+    bool is_result_nullable() const override { return false; }
+
+    void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                    Column* dst) override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        size_t orig = data.size();
+        data.resize_uninitialized(orig + num_rows);
+        int64_t* values = data.data() + orig;
+        for (size_t i = 0; i < num_rows; ++i) {
+            const WindowRow& row = rows[i];
+            if constexpr (Type == WindowFunctionType::ROW_NUMBER) {
+                values[i] = row.row - row.partition_start + 1;
+            } else if constexpr (Type == WindowFunctionType::RANK) {
+                values[i] = row.peer_start - row.partition_start + 1;
+            } else {
+                if (row.peer_start != _last_peer_start) {
+                    _dense_rank = row.peer_start == row.partition_start ? 1 : _dense_rank + 1;
+                    _last_peer_start = row.peer_start;
+                }
+                values[i] = _dense_rank;
+            }
+        }
+    }
+
+    void reset() override {
+        _last_peer_start = -1;
+        _dense_rank = 0;
+    }
+
+private:
+    // DENSE_RANK: the peer group seen last, and its rank.
+    int64_t _last_peer_start = -1;
+    int64_t _dense_rank = 0;
+};
+
+// LAG and LEAD read the one row of their frame.
+template <LogicalType LT>
+class LagLeadFunction final : public WindowFunction {
+public:
+    using CppType = RunTimeCppType<LT>;
+
+    LagLeadFunction(WindowFunctionType type, const Datum& default_value)
+            : _type(type),
+              _default_is_null(default_value.is_null()),
+              _default(default_value.is_null() ? CppType() : default_value.get<CppType>()) {}
+
+    WindowFunctionType type() const override { return _type; }
+    LogicalType result_type() const override { return LT; }
+    bool is_result_nullable() const override { return true; }
+
+    void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                    Column* dst) override {
+        auto* nullable = as_nullable(dst);
+        Column* data = nullable->data_column().get();
+        auto& nulls = nullable->null_column_data();
+        const uint8_t* arg_nulls;
+        const Column* arg_data = unpack_nullable(arg, &arg_nulls);
+        bool has_null = false;
+        for (size_t i = 0; i < num_rows; ++i) {
+            const WindowRow& row = rows[i];
+            if (row.frame_start < row.frame_end) {
+                size_t idx = row.frame_start - base;
+                bool is_null = arg_nulls != nullptr && arg_nulls[idx];
+                append_value<LT>(data, is_null ? CppType() : value_at<LT>(arg_data, idx));
+                nulls.push_back(is_null);
+                has_null |= is_null;
+            } else {
+                append_value<LT>(data, _default);
+                nulls.push_back(_default_is_null);
+                has_null |= _default_is_null;
+            }
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void reset() override {}
+
+private:
+    const WindowFunctionType _type;
+    const bool _default_is_null;
+    const CppType _default;
+};
+
+// COUNT(*) without an argument, COUNT(arg) of the non-NULL values with one.
+class CountFunction final : public WindowFunction {
+public:
+    WindowFunctionType type() const override { return WindowFunctionType::COUNT; }
+    LogicalType result_type() const override { return TYPE_BIGINT; }
+    bool is_result_nullable() const override { return false; }
+
+    void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                    Column* dst) override {
+        auto& data = static_cast<Int64Column*>(dst)->get_data();
+        const uint8_t* nulls = nullptr;
+        if (arg != nullptr) {
+            unpack_nullable(arg, &nulls);
+        }
+        auto add = [&](int64_t r) { _count += nulls == nullptr || !nulls[r - base]; };
+        auto remove = [&](int64_t r) { _count -= nulls == nullptr || !nulls[r - base]; };
+        auto clear = [&] { _count = 0; };
+        for (size_t i = 0; i < num_rows; ++i) {
+            slide_frame(&_lo, &_hi, rows[i].frame_start, rows[i].frame_end, add, remove, clear);
+            data.push_back(_count);
+        }
+    }
+
+    void reset() override { _lo = _hi = _count = 0; }
+
+private:
+    int64_t _lo = 0;
+    int64_t _hi = 0;
+    int64_t _count = 0;
+};
+
+// SUM of integers is a BIGINT (wrapping around on overflow), SUM of floating
+// point values a DOUBLE; AVG is a DOUBLE either way. Integers keep a running
+// total. Floating point values are never subtracted, since taking 1e20 back
+// out of 1e20 + 1 leaves 0: the frame is split into a front, whose suffix
+// sums are computed once when its first row leaves, and a back summed as rows
+// enter, so each value is still added O(1) times. Infinities and NaNs are
+// counted rather than added.
+template <LogicalType LT, bool kIsAvg>
+class SumAvgFunction final : public WindowFunction {
+public:
+    static constexpr bool kIsFloat = is_float_type(LT);
+    static constexpr LogicalType kSumType = kIsFloat ? TYPE_DOUBLE : TYPE_BIGINT;
+
+    WindowFunctionType type() const override { return kIsAvg ? WindowFunctionType::AVG : WindowFunctionType::SUM; }
+    LogicalType result_type() const override { return kIsAvg ? TYPE_DOUBLE : kSumType; }
+    bool is_result_nullable() const override { return true; }
+
+    void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                    Column* dst) override {
+        auto* nullable = as_nullable(dst);
+        auto& nulls = nullable->null_column_data();
+        const uint8_t* arg_nulls;
+        const auto* values = reinterpret_cast<const RunTimeCppType<LT>*>(unpack_nullable(arg, &arg_nulls)->raw_data());
+        auto update = [&](int64_t r, int sign) {
+            size_t idx = r - base;
+            if (arg_nulls != nullptr && arg_nulls[idx]) {
+                return;
+            }
+            _count += sign;
+            if constexpr (kIsFloat) {
+                double value = values[idx];
+                if (std::isnan(value)) {
+                    _num_nans += sign;
+                } else if (std::isinf(value)) {
+                    (value > 0 ? _num_pos_infs : _num_neg_infs) += sign;
+                } else if (sign > 0) {
+                    _sum += value;
+                } else {
+                    _remove_oldest(values, arg_nulls, r, base);
+                }
+            } else {
+                auto value = static_cast<uint64_t>(static_cast<int64_t>(values[idx]));
+                _sum = sign > 0 ? _sum + value : _sum - value;
+            }
+        };
+        auto add = [&](int64_t r) { update(r, 1); };
+        auto remove = [&](int64_t r) { update(r, -1); };
+        auto clear = [&] { _clear(); };
+        bool has_null = false;
+        for (size_t i = 0; i < num_rows; ++i) {
+            slide_frame(&_lo, &_hi, rows[i].frame_start, rows[i].frame_end, add, remove, clear);
+            bool is_null = _count == 0;
+            if constexpr (kIsAvg) {
+                static_cast<DoubleColumn*>(nullable->data_column().get())
+                        ->get_data()
+                        .push_back(is_null ? 0 : _total() / static_cast<double>(_count));
+            } else {
+                append_value<kSumType>(nullable->data_column().get(), is_null ? 0 : _total());
+            }
+            nulls.push_back(is_null);
+            has_null |= is_null;
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void reset() override {
+        _lo = _hi = 0;
+        _clear();
+    }
+
+private:
+    using SumType = std::conditional_t<kIsFloat, double, uint64_t>;
+
+    RunTimeCppType<kSumType> _total() const {
+        if constexpr (kIsFloat) {
+            if (_num_nans > 0 || (_num_pos_infs > 0 && _num_neg_infs > 0)) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            if (_num_pos_infs > 0 || _num_neg_infs > 0) {
+                return _num_pos_infs > 0 ? std::numeric_limits<double>::infinity()
+                                         : -std::numeric_limits<double>::infinity();
+            }
+            return _front_sums.empty() ? _sum : _front_sums.back() + _sum;
+        } else {
+            return static_cast<int64_t>(_sum);
+        }
+    }
+
+    // Takes the finite value of row |r|, the oldest one in the frame, out of
+    // the sum. When the front is empty every row of the frame moves to it.
+    void _remove_oldest(const RunTimeCppType<LT>* values, const uint8_t* nulls, int64_t r, int64_t base) {
+        if (_front_sums.empty()) {
+            double suffix = 0;
+            for (int64_t q = _hi - 1; q >= r; --q) {
+                size_t idx = q - base;
+                if ((nulls == nullptr || !nulls[idx]) && std::isfinite(static_cast<double>(values[idx]))) {
+                    suffix += values[idx];
+                    _front_sums.push_back(suffix);
+                }
+            }
+            _sum = 0;
+        }
+        _front_sums.pop_back();
+    }
+
+    void _clear() {
+        _sum = 0;
+        _front_sums.clear();
+        _count = 0;
+        _num_nans = _num_pos_infs = _num_neg_infs = 0;
+    }
+
+    int64_t _lo = 0;
+    int64_t _hi = 0;
+    // Floating point: the sum of the back of the frame.
+    SumType _sum = 0;
+    // Floating point: the sums of the front of the frame from each of its
+    // finite values on, the oldest one's last.
+    std::vector<double> _front_sums;
+    int64_t _count = 0;
+    int64_t _num_nans = 0;
+    int64_t _num_pos_infs = 0;
+    int64_t _num_neg_infs = 0;
+};
+
+// The deque holds the rows of the frame that no later row of the frame beats,
+// so their values ascend (MIN) or descend (MAX) and the front is the result.
+// NaN is above every other value, as it is when sorting.
+template <LogicalType LT, bool kIsMin>
+class MinMaxFunction final : public WindowFunction {
+public:
+    using CppType = RunTimeCppType<LT>;
+
+    WindowFunctionType type() const override { return kIsMin ? WindowFunctionType::MIN : WindowFunctionType::MAX; }
+    LogicalType result_type() const override { return LT; }
+    bool is_result_nullable() const override { return true; }
+
+    void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                    Column* dst) override {
+        auto* nullable = as_nullable(dst);
+        Column* data = nullable->data_column().get();
+        auto& nulls = nullable->null_column_data();
+        const uint8_t* arg_nulls;
+        const Column* arg_data = unpack_nullable(arg, &arg_nulls);
+        auto add = [&](int64_t r) {
+            size_t idx = r - base;
+            if (arg_nulls != nullptr && arg_nulls[idx]) {
+                return;
+            }
+            CppType value = value_at<LT>(arg_data, idx);
+            while (!_candidates.empty() && !_beats(value_at<LT>(arg_data, _candidates.back() - base), value)) {
+                _candidates.pop_back();
+            }
+            _candidates.push_back(r);
+        };
+        auto remove = [&](int64_t r) {
+            if (!_candidates.empty() && _candidates.front() == r) {
+                _candidates.pop_front();
+            }
+        };
+        auto clear = [&] { _candidates.clear(); };
+        bool has_null = false;
+        for (size_t i = 0; i < num_rows; ++i) {
+            slide_frame(&_lo, &_hi, rows[i].frame_start, rows[i].frame_end, add, remove, clear);
+            bool is_null = _candidates.empty();
+            append_value<LT>(data, is_null ? CppType() : value_at<LT>(arg_data, _candidates.front() - base));
+            nulls.push_back(is_null);
+            has_null |= is_null;
+        }
+        nullable->set_has_null(has_null);
+    }
+
+    void reset() override {
+        _lo = _hi = 0;
+        _candidates.clear();
+    }
+
+private:
+    // |a| stays ahead of a later |b|: it is strictly below (MIN) or above
+    // (MAX) it. Of equal values the later one is kept, as it leaves last.
+    static bool _beats(const CppType& a, const CppType& b) {
+        if constexpr (is_float_type(LT)) {
+            if (std::isnan(a) || std::isnan(b)) {
+                return kIsMin ? !std::isnan(a) : !std::isnan(b);
+            }
+        }
+        return kIsMin ? a < b : b < a;
+    }
+
+    int64_t _lo = 0;
+    int64_t _hi = 0;
+    std::deque<int64_t> _candidates;
+};
+
+} // namespace
+
+StatusOr<WindowFunctionPtr> create_window_function(WindowFunctionType type, LogicalType arg_type,
+                                                   const Datum& default_value) {
+    auto invalid_arg = [&] {
+        return Status::InvalidArgument(std::string(window_function_name(type)) + " does not take an argument of type " +
+                                       logical_type_to_string(arg_type));
+    };
+    switch (type) {
+    case WindowFunctionType::ROW_NUMBER:
+    case WindowFunctionType::RANK:
+    case WindowFunctionType::DENSE_RANK:
+        if (arg_type != TYPE_UNKNOWN) {
+            return invalid_arg();
+        }
+        if (type == WindowFunctionType::ROW_NUMBER) {
+            return std::make_unique<RankingFunction<WindowFunctionType::ROW_NUMBER>>();
+        }
+        if (type == WindowFunctionType::RANK) {
+            return std::make_unique<RankingFunction<WindowFunctionType::RANK>>();
+        }
+        return std::make_unique<RankingFunction<WindowFunctionType::DENSE_RANK>>();
+    case WindowFunctionType::LAG:
+    case WindowFunctionType::LEAD:
+        if (arg_type == TYPE_UNKNOWN || arg_type == TYPE_BITMAP) {
+            return invalid_arg();
+        }
+        return type_dispatch_all(arg_type, [&](auto lt) -> WindowFunctionPtr {
+            constexpr LogicalType LT = decltype(lt)::value;
+            return std::make_unique<LagLeadFunction<LT>>(type, default_value);
+        });
+    case WindowFunctionType::COUNT:
+        return std::make_unique<CountFunction>();
+    case WindowFunctionType::SUM:
+    case WindowFunctionType::AVG:
+        if (!is_integer_type(arg_type) && !is_float_type(arg_type) && arg_type != TYPE_BOOLEAN) {
+            return invalid_arg();
+        }
+        return type_dispatch_all(arg_type, [&](auto lt) -> WindowFunctionPtr {
+            constexpr LogicalType LT = decltype(lt)::value;
+            if constexpr (is_binary_type(LT) || LT == TYPE_DATE || LT == TYPE_DATETIME) {
+                return nullptr;
+            } else if (type == WindowFunctionType::SUM) {
+                return std::make_unique<SumAvgFunction<LT, false>>();
+            } else {
+                return std::make_unique<SumAvgFunction<LT, true>>();
+            }
+        });
+    case WindowFunctionType::MIN:
+    case WindowFunctionType::MAX:
+        if (arg_type == TYPE_UNKNOWN || arg_type == TYPE_BITMAP) {
+            return invalid_arg();
+        }
+        return type_dispatch_all(arg_type, [&](auto lt) -> WindowFunctionPtr {
+            constexpr LogicalType LT = decltype(lt)::value;
+            if (type == WindowFunctionType::MIN) {
+                return std::make_unique<MinMaxFunction<LT, true>>();
+            }
+            return std::make_unique<MinMaxFunction<LT, false>>();
+        });
+    }
+    return Status::InvalidArgument("unknown window function");
+}
+
+} // namespace starrocks
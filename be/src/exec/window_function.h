@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "column/datum.h"
+#include "column/vectorized_fwd.h"
+#include "common/status.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+enum class WindowFunctionType {
+    ROW_NUMBER,
+    RANK,
+    DENSE_RANK,
+    LAG,
+    LEAD,
+    COUNT,
+    SUM,
+    AVG,
+    MIN,
+    MAX,
+};
+
+const char* window_function_name(WindowFunctionType type);
+
+// ROW_NUMBER, RANK and DENSE_RANK, which take no argument and no frame.
+bool is_ranking_function(WindowFunctionType type);
+
+enum class WindowFrameType {
+    ROWS,
+    // Rows by their ORDER BY key: peers are in or out together, and offsets
+    // are distances between key values.
+    RANGE,
+};
+
+struct WindowFrameBound {
+    enum Kind {
+        UNBOUNDED_PRECEDING,
+        PRECEDING,
+        CURRENT_ROW,
+        FOLLOWING,
+        UNBOUNDED_FOLLOWING,
+    };
+
+    Kind kind = CURRENT_ROW;
+    // PRECEDING and FOLLOWING: rows for ROWS frames, units of the ORDER BY key
+    // for RANGE frames (days for DATE, microseconds for DATETIME).
+    int64_t offset = 0;
+};
+
+// The SQL default: RANGE BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW, which
+// is the whole partition without ORDER BY.
+struct WindowFrame {
+    WindowFrameType type = WindowFrameType::RANGE;
+    WindowFrameBound start{WindowFrameBound::UNBOUNDED_PRECEDING};
+    WindowFrameBound end{WindowFrameBound::CURRENT_ROW};
+};
+
+// A row a window function computes a value for. Rows are numbered from the
+// start of the input; the frame is [frame_start, frame_end), already clipped
+// to the partition, and empty when the frame misses it. LAG and LEAD get the
+// row they read as a frame of one row.
+struct WindowRow {
+    int64_t row;
+    int64_t partition_start;
+    // First row with the same ORDER BY key.
+    int64_t peer_start;
+    int64_t frame_start;
+    int64_t frame_end;
+};
+
+// A window function, computing a batch of rows per call. Unlike aggregate
+// functions, instances are stateful: the aggregates keep the value of the
+// last frame and slide it to the next one, adding the rows entering it and
+// removing those leaving it, so a moving window costs amortized O(1) per row
+// however wide it is. COUNT, and SUM and AVG of integers, keep a running
+// total; SUM and AVG of floating point values keep partial sums instead, as
+// subtracting would lose precision; MIN and MAX keep the candidates for the
+// minimum (maximum) in a monotonic deque, the rows of the frame no later row
+// of it is below (above). Frames only slide forward within a partition; one
+// that does not (a new partition) is rebuilt.
+//
+// NULL arguments are skipped; an aggregate over none but NULLs is NULL,
+// except COUNT, which is 0.
+class WindowFunction {
+public:
+    virtual ~WindowFunction() = default;
+
+    virtual WindowFunctionType type() const = 0;
+    virtual LogicalType result_type() const = 0;
+    virtual bool is_result_nullable() const = 0;
+
+    // Appends the values of |rows|, in ascending order, to |dst|. Row r of the
+    // input is row r - |base| of |arg|, which holds at least every row of
+    // the frames; |arg| is null without an argument.
+    virtual void get_values(const Column* arg, int64_t base, const WindowRow* rows, size_t num_rows,
+                            Column* dst) = 0;
+
+    // Drops the state kept from earlier rows.
+    virtual void reset() = 0;
+};
+
+using WindowFunctionPtr = std::unique_ptr<WindowFunction>;
+
+// A new instance of |type| over arguments of |arg_type| (TYPE_UNKNOWN for
+// none). |default_value| is what LAG and LEAD yield past the edge of the
+// partition; string defaults must outlive the function.
+StatusOr<WindowFunctionPtr> create_window_function(WindowFunctionType type, LogicalType arg_type,
+                                                   const Datum& default_value = Datum());
+
+} // namespace starrocks
@@ -0,0 +1,145 @@
+#include <cmath>
+#include <type_traits>
+
+#include "exprs/function_helper.h"
+
+namespace starrocks {
+
+// Integer arithmetic wraps around on overflow, as two's complement does,
+// instead of being undefined. Smaller integers are widened to BIGINT and
+// FLOAT to DOUBLE by the implicit casts of the call.
+
+template <typename T>
+static T wrap(uint64_t value) {
+    return static_cast<T>(value);
+}
+
+struct AddOp {
+    template <typename R, typename T>
+    static R apply(T a, T b) {
+        if constexpr (std::is_integral_v<T>) {
+            return wrap<R>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+        } else {
+            return a + b;
+        }
+    }
+};
+
+struct SubtractOp {
+    template <typename R, typename T>
+    static R apply(T a, T b) {
+        if constexpr (std::is_integral_v<T>) {
+            return wrap<R>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+        } else {
+            return a - b;
+        }
+    }
+};
+
+struct MultiplyOp {
+    template <typename R, typename T>
+    static R apply(T a, T b) {
+        if constexpr (std::is_integral_v<T>) {
+            return wrap<R>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b));
+        } else {
+            return a * b;
+        }
+    }
+};
+
+// Division by zero is NULL.
+struct DivideOp {
+    template <typename R, typename T>
+    static R apply(T a, T b, uint8_t* is_null) {
+        *is_null = b == 0;
+        return b == 0 ? R(0) : static_cast<R>(a) / static_cast<R>(b);
+    }
+};
+
+// Integer division, truncating towards zero.
+struct IntDivideOp {
+    template <typename R, typename T>
+    static R apply(T a, T b, uint8_t* is_null) {
+        *is_null = b == 0;
+        if (b == 0) {
+            return 0;
+        }
+        // The one quotient that overflows.
+        return b == -1 ? wrap<R>(0 - static_cast<uint64_t>(a)) : a / b;
+    }
+};
+
+// The sign of the remainder is that of the dividend.
+struct ModOp {
+    template <typename R, typename T>
+    static R apply(T a, T b, uint8_t* is_null) {
+        *is_null = b == 0;
+        if (b == 0) {
+            return 0;
+        }
+        if constexpr (std::is_integral_v<T>) {
+            return b == -1 ? 0 : a % b;
+        } else {
+            return std::fmod(a, b);
+        }
+    }
+};
+
+struct NegativeOp {
+    template <typename R, typename T>
+    static R apply(T a) {
+        if constexpr (std::is_integral_v<T>) {
+            return wrap<R>(0 - static_cast<uint64_t>(a));
+        } else {
+            return -a;
+        }
+    }
+};
+
+struct AbsOp {
+    template <typename R, typename T>
+    static R apply(T a) {
+        if constexpr (std::is_integral_v<T>) {
+            return a < 0 ? wrap<R>(0 - static_cast<uint64_t>(a)) : a;
+        } else {
+            return std::fabs(a);
+        }
+    }
+};
+
+template <LogicalType LT, typename Op>
+static void add_unary(FunctionRegistry* registry, const char* name) {
+    registry->add({name, {LT}, LT, &unary_function<LT, LT, Op>});
+}
+
+template <LogicalType LT, typename Op>
+static void add_binary(FunctionRegistry* registry, const char* name) {
+    registry->add({name, {LT, LT}, LT, &binary_function<LT, LT, LT, Op>});
+}
+
+template <LogicalType LT, LogicalType ResultLT, typename Op>
+static void add_binary_nullable(FunctionRegistry* registry, const char* name) {
+    FunctionDescriptor desc{name, {LT, LT}, ResultLT, &binary_nullable_function<LT, LT, ResultLT, Op>};
+    desc.may_return_null = true;
+    registry->add(std::move(desc));
+}
+
+void register_arithmetic_functions(FunctionRegistry* registry) {
+    add_binary<TYPE_BIGINT, AddOp>(registry, "add");
+    add_binary<TYPE_DOUBLE, AddOp>(registry, "add");
+    add_binary<TYPE_BIGINT, SubtractOp>(registry, "subtract");
+    add_binary<TYPE_DOUBLE, SubtractOp>(registry, "subtract");
+    add_binary<TYPE_BIGINT, MultiplyOp>(registry, "multiply");
+    add_binary<TYPE_DOUBLE, MultiplyOp>(registry, "multiply");
+    // '/' always divides as DOUBLE; DIV is the integer division.
+    add_binary_nullable<TYPE_DOUBLE, TYPE_DOUBLE, DivideOp>(registry, "divide");
+    add_binary_nullable<TYPE_BIGINT, TYPE_BIGINT, IntDivideOp>(registry, "int_divide");
+    add_binary_nullable<TYPE_BIGINT, TYPE_BIGINT, ModOp>(registry, "mod");
+    add_binary_nullable<TYPE_DOUBLE, TYPE_DOUBLE, ModOp>(registry, "mod");
+    add_unary<TYPE_BIGINT, NegativeOp>(registry, "negative");
+    add_unary<TYPE_DOUBLE, NegativeOp>(registry, "negative");
+    add_unary<TYPE_BIGINT, AbsOp>(registry, "abs");
+    add_unary<TYPE_DOUBLE, AbsOp>(registry, "abs");
+}
+
+} // namespace starrocks
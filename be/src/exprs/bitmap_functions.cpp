@@ -0,0 +1,187 @@
+#include "exprs/function_helper.h"
+#include "runtime/mem_pool.h"
+#include "util/roaring_bitmap.h"
+
+namespace starrocks {
+
+// Functions over BITMAP values (see RoaringBitmap). A value that does not
+// parse as a bitmap yields NULL, as the bitmap aggregates skip it. The
+// bitmaps of a row are read into scratch memory, dropped every so often.
+
+static void recycle(MemPool* scratch) {
+    if (scratch->allocated_bytes() > MemPool::kMaxChunkSize) {
+        scratch->clear();
+    }
+}
+
+static bool parse_bitmap(Slice value, RoaringBitmap* bitmap, MemPool* scratch) {
+    return RoaringBitmap::deserialize(&value, bitmap, scratch);
+}
+
+static void append_bitmap(const RoaringBitmap& bitmap, Buffer<uint8_t>* buf, BinaryColumn* dst) {
+    buf->clear();
+    bitmap.serialize(buf);
+    dst->append(Slice(buf->data(), buf->size()));
+}
+
+// TO_BITMAP(value): the bitmap of one value; NULL for a negative one.
+static StatusOr<ColumnPtr> to_bitmap_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    Buffer<uint8_t> buf;
+    with_reader<TYPE_BIGINT>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            RoaringBitmap bitmap;
+            int64_t value = arg.value(i);
+            is_null[i] = value < 0;
+            if (!is_null[i]) {
+                bitmap.add(static_cast<uint64_t>(value), &scratch);
+            }
+            append_bitmap(bitmap, &buf, result.get());
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// BITMAP_COUNT(bitmap): the number of values.
+static StatusOr<ColumnPtr> bitmap_count_function(const Columns& args, size_t num_rows) {
+    auto result = Int64Column::create();
+    result->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* out = result->get_data().data();
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    RoaringBitmap bitmap;
+    with_reader<TYPE_BITMAP>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            is_null[i] = !parse_bitmap(arg.value(i), &bitmap, &scratch);
+            out[i] = static_cast<int64_t>(bitmap.cardinality());
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+static void bitmap_and(RoaringBitmap* a, const RoaringBitmap& b, MemPool* /*pool*/) {
+    a->intersect_with(b);
+}
+
+static void bitmap_or(RoaringBitmap* a, const RoaringBitmap& b, MemPool* pool) {
+    a->union_with(b, pool);
+}
+
+static void bitmap_andnot(RoaringBitmap* a, const RoaringBitmap& b, MemPool* /*pool*/) {
+    a->subtract(b);
+}
+
+// BITMAP_AND(a, b), BITMAP_OR(a, b) and BITMAP_ANDNOT(a, b).
+template <void (*kOp)(RoaringBitmap*, const RoaringBitmap&, MemPool*)>
+static StatusOr<ColumnPtr> bitmap_set_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    RoaringBitmap a;
+    RoaringBitmap b;
+    Buffer<uint8_t> buf;
+    with_readers<TYPE_BITMAP, TYPE_BITMAP>(args[0].get(), args[1].get(), [&](const auto& lhs, const auto& rhs) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (parse_bitmap(lhs.value(i), &a, &scratch) && parse_bitmap(rhs.value(i), &b, &scratch)) {
+                kOp(&a, b, &scratch);
+                append_bitmap(a, &buf, result.get());
+            } else {
+                is_null[i] = 1;
+                result->append(Slice());
+            }
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// BITMAP_CONTAINS(bitmap, value).
+static StatusOr<ColumnPtr> bitmap_contains_function(const Columns& args, size_t num_rows) {
+    auto result = BooleanColumn::create();
+    result->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* out = result->get_data().data();
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    RoaringBitmap bitmap;
+    with_readers<TYPE_BITMAP, TYPE_BIGINT>(args[0].get(), args[1].get(), [&](const auto& lhs, const auto& value) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            is_null[i] = !parse_bitmap(lhs.value(i), &bitmap, &scratch);
+            out[i] = value.value(i) >= 0 && bitmap.contains(static_cast<uint64_t>(value.value(i)));
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// BITMAP_TO_STRING(bitmap): the values, ascending, separated by commas;
+// also CAST(bitmap AS VARCHAR).
+static StatusOr<ColumnPtr> bitmap_to_string_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    RoaringBitmap bitmap;
+    with_reader<TYPE_BITMAP>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            is_null[i] = !parse_bitmap(arg.value(i), &bitmap, &scratch);
+            result->append_string(is_null[i] ? std::string() : bitmap.to_string());
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// BITMAP_FROM_STRING(text): the bitmap of comma-separated values, NULL if
+// the text is not such a list; also CAST(text AS BITMAP).
+static StatusOr<ColumnPtr> bitmap_from_string_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* is_null = nulls->get_data().data();
+    MemPool scratch;
+    RoaringBitmap bitmap;
+    Buffer<uint8_t> buf;
+    with_reader<TYPE_VARCHAR>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            is_null[i] = !RoaringBitmap::parse(arg.value(i), &bitmap, &scratch);
+            if (is_null[i]) {
+                result->append(Slice());
+            } else {
+                append_bitmap(bitmap, &buf, result.get());
+            }
+            recycle(&scratch);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+static void add_nullable(FunctionRegistry* registry, FunctionDescriptor desc) {
+    desc.may_return_null = true;
+    registry->add(std::move(desc));
+}
+
+void register_bitmap_functions(FunctionRegistry* registry) {
+    add_nullable(registry, {"to_bitmap", {TYPE_BIGINT}, TYPE_BITMAP, &to_bitmap_function});
+    add_nullable(registry, {"bitmap_count", {TYPE_BITMAP}, TYPE_BIGINT, &bitmap_count_function});
+    add_nullable(registry,
+                 {"bitmap_and", {TYPE_BITMAP, TYPE_BITMAP}, TYPE_BITMAP, &bitmap_set_function<&bitmap_and>});
+    add_nullable(registry, {"bitmap_or", {TYPE_BITMAP, TYPE_BITMAP}, TYPE_BITMAP, &bitmap_set_function<&bitmap_or>});
+    add_nullable(registry,
+                 {"bitmap_andnot", {TYPE_BITMAP, TYPE_BITMAP}, TYPE_BITMAP, &bitmap_set_function<&bitmap_andnot>});
+    add_nullable(registry, {"bitmap_contains", {TYPE_BITMAP, TYPE_BIGINT}, TYPE_BOOLEAN, &bitmap_contains_function});
+    add_nullable(registry, {"bitmap_to_string", {TYPE_BITMAP}, TYPE_VARCHAR, &bitmap_to_string_function});
+    add_nullable(registry, {"bitmap_from_string", {TYPE_VARCHAR}, TYPE_BITMAP, &bitmap_from_string_function});
+}
+
+} // namespace starrocks
@@ -0,0 +1,229 @@
+#include "exprs/case_expr.h"
+
+#include <climits>
+
+#include "column/column_helper.h"
+#include "exprs/cast_expr.h"
+#include "exprs/function_registry.h"
+
+namespace starrocks {
+
+static bool is_case_nullable(const Exprs& children, bool has_else) {
+    if (!has_else) {
+        return true;
+    }
+    // The values: every second child, and the last.
+    for (size_t i = 0; i < children.size(); ++i) {
+        if ((i % 2 == 1 || i + 1 == children.size()) && children[i]->is_nullable()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CaseExpr::CaseExpr(LogicalType type, Exprs children, bool has_else)
+        : Expr(ExprKind::CASE, type, is_case_nullable(children, has_else), std::move(children)), _has_else(has_else) {}
+
+ExprPtr CaseExpr::with_children(Exprs children) const {
+    return std::make_shared<CaseExpr>(_type, std::move(children), _has_else);
+}
+
+std::string CaseExpr::debug_string() const {
+    std::string res = "CASE";
+    for (size_t i = 0; i < num_whens(); ++i) {
+        res.append(" WHEN ").append(when(i)->debug_string()).append(" THEN ").append(then(i)->debug_string());
+    }
+    if (_has_else) {
+        res.append(" ELSE ").append(_children.back()->debug_string());
+    }
+    return res + " END";
+}
+
+// Assembles the result from the values of the branches: row r takes its
+// value from branches[r], whose column holds every row, or just the rows
+// taking the branch when compacted. A null column is NULL.
+template <LogicalType LT>
+static ColumnPtr merge_branches(size_t num_rows, const uint32_t* branches, const Columns& values,
+                                const std::vector<uint8_t>& compacted) {
+    using CppType = RunTimeCppType<LT>;
+    struct Source {
+        const Column* data = nullptr;
+        const uint8_t* nulls = nullptr;
+        bool is_null = false;
+        bool is_const = false;
+        bool is_compacted = false;
+        size_t next = 0;
+
+        CppType value(size_t i) const {
+            if constexpr (LT == TYPE_VARCHAR) {
+                return static_cast<const BinaryColumn*>(data)->get_slice(i);
+            } else {
+                return reinterpret_cast<const CppType*>(data->raw_data())[i];
+            }
+        }
+    };
+    std::vector<Source> sources(values.size());
+    for (size_t b = 0; b < values.size(); ++b) {
+        Source& s = sources[b];
+        if (values[b] == nullptr || (values[b]->is_constant() && values[b]->only_null())) {
+            s.is_null = true;
+            continue;
+        }
+        s.data = ColumnHelper::get_data_column(values[b].get());
+        s.is_const = values[b]->is_constant();
+        s.is_compacted = compacted[b];
+        if (!s.is_const) {
+            const NullData* nulls = ColumnHelper::get_null_data(values[b].get());
+            s.nulls = nulls == nullptr ? nullptr : nulls->data();
+        }
+    }
+
+    auto data = RunTimeColumnType<LT>::create();
+    data->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    uint8_t* is_null = nulls->get_data().data();
+    bool has_null = false;
+    for (size_t r = 0; r < num_rows; ++r) {
+        Source& s = sources[branches[r]];
+        size_t i = s.is_const ? 0 : s.is_compacted ? s.next++ : r;
+        if (s.is_null || (s.nulls != nullptr && s.nulls[i])) {
+            data->append_default(1);
+            is_null[r] = 1;
+            has_null = true;
+        } else {
+            data->append(s.value(i));
+        }
+    }
+    if (!has_null) {
+        return data;
+    }
+    return NullableColumn::create(std::move(data), std::move(nulls));
+}
+
+StatusOr<ColumnPtr> CaseExpr::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    const size_t num_rows = chunk->num_rows();
+    const size_t num_branches = num_whens() + 1;
+    const auto else_branch = static_cast<uint32_t>(num_whens());
+
+    // The conditions, each for the rows no earlier one took.
+    Buffer<uint8_t> undecided(num_rows, uint8_t{1});
+    Buffer<uint32_t> branches(num_rows, else_branch);
+    std::vector<size_t> num_taken(num_branches, 0);
+    size_t num_undecided = num_rows;
+    for (uint32_t b = 0; b < else_branch && num_undecided > 0; ++b) {
+        bool compacted;
+        ASSIGN_OR_RETURN(ColumnPtr cond,
+                         ctx->evaluate_selected(when(b).get(), chunk, undecided.data(), num_undecided, &compacted));
+        const uint8_t* values = ColumnHelper::get_data_column(cond.get())->raw_data();
+        if (cond->is_constant()) {
+            if (cond->only_null() || values[0] == 0) {
+                continue;
+            }
+            for (size_t r = 0; r < num_rows; ++r) {
+                if (undecided[r]) {
+                    branches[r] = b;
+                }
+            }
+            num_taken[b] = num_undecided;
+            num_undecided = 0;
+            break;
+        }
+        const NullData* nulls = ColumnHelper::get_null_data(cond.get());
+        size_t next = 0;
+        for (size_t r = 0; r < num_rows; ++r) {
+            if (!undecided[r]) {
+                continue;
+            }
+            size_t i = compacted ? next++ : r;
+            if (values[i] != 0 && (nulls == nullptr || !(*nulls)[i])) {
+                branches[r] = b;
+                undecided[r] = 0;
+                ++num_taken[b];
+            }
+        }
+        num_undecided -= num_taken[b];
+    }
+    num_taken[else_branch] = num_undecided;
+
+    // The values, each for the rows taking its branch.
+    Columns values(num_branches);
+    std::vector<uint8_t> compacted(num_branches, 0);
+    Buffer<uint8_t> taken(num_rows, uint8_t{0});
+    for (uint32_t b = 0; b < num_branches; ++b) {
+        const Expr* value = b < else_branch ? then(b).get() : else_expr();
+        if (num_taken[b] == 0) {
+            continue;
+        }
+        if (num_taken[b] == num_rows) {
+            if (value == nullptr) {
+                return ColumnHelper::create_const_null_column(num_rows, _type);
+            }
+            return ctx->evaluate(value, chunk);
+        }
+        if (value == nullptr) {
+            continue;
+        }
+        for (size_t r = 0; r < num_rows; ++r) {
+            taken[r] = branches[r] == b;
+        }
+        bool is_compacted;
+        ASSIGN_OR_RETURN(values[b], ctx->evaluate_selected(value, chunk, taken.data(), num_taken[b], &is_compacted));
+        compacted[b] = is_compacted;
+    }
+    return type_dispatch_all(_type, [&](auto lt) {
+        return merge_branches<decltype(lt)::value>(num_rows, branches.data(), values, compacted);
+    });
+}
+
+// The type every value converts to implicitly at the lowest total cost.
+static StatusOr<LogicalType> common_type(const Exprs& values) {
+    LogicalType best = TYPE_UNKNOWN;
+    int best_cost = INT_MAX;
+    for (const auto& candidate : values) {
+        int cost = 0;
+        for (const auto& value : values) {
+            int c = implicit_cast_cost(value->type(), candidate->type());
+            if (c < 0) {
+                cost = -1;
+                break;
+            }
+            cost += c;
+        }
+        if (cost >= 0 && cost < best_cost) {
+            best = candidate->type();
+            best_cost = cost;
+        }
+    }
+    if (best == TYPE_UNKNOWN) {
+        return Status::InvalidArgument("CASE values of incompatible types");
+    }
+    return best;
+}
+
+StatusOr<ExprPtr> make_case(const Exprs& whens, const Exprs& thens, ExprPtr else_expr) {
+    if (whens.empty() || whens.size() != thens.size()) {
+        return Status::InvalidArgument("CASE needs one THEN per WHEN");
+    }
+    Exprs values = thens;
+    if (else_expr != nullptr) {
+        values.push_back(else_expr);
+    }
+    ASSIGN_OR_RETURN(LogicalType type, common_type(values));
+    Exprs children;
+    for (size_t i = 0; i < whens.size(); ++i) {
+        if (whens[i]->type() != TYPE_BOOLEAN) {
+            return Status::InvalidArgument("CASE condition of type " + logical_type_to_string(whens[i]->type()));
+        }
+        children.push_back(whens[i]);
+        ASSIGN_OR_RETURN(ExprPtr value, make_cast(thens[i], type));
+        children.push_back(std::move(value));
+    }
+    if (else_expr != nullptr) {
+        ASSIGN_OR_RETURN(ExprPtr value, make_cast(std::move(else_expr), type));
+        children.push_back(std::move(value));
+    }
+    bool has_else = children.size() % 2 == 1;
+    return std::make_shared<CaseExpr>(type, std::move(children), has_else);
+}
+
+} // namespace starrocks
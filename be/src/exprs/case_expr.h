@@ -0,0 +1,45 @@
+#pragma once
+
+#include "exprs/expr.h"
+
+namespace starrocks {
+
+// CASE WHEN c1 THEN v1 WHEN c2 THEN v2 ... [ELSE e] END; a CASE comparing an
+// operand is built with eq() conditions. The children are c1, v1, c2, v2,
+// ... and e.
+//
+// Each row is only evaluated for what it needs: a condition for the rows no
+// earlier condition took, a value for the rows taking its branch. A branch
+// no row takes costs nothing; one few rows take runs over a copy of those
+// rows (see ExprContext::evaluate_selected()).
+class CaseExpr final : public Expr {
+public:
+    CaseExpr(LogicalType type, Exprs children, bool has_else);
+
+    size_t num_whens() const { return _children.size() / 2; }
+    const ExprPtr& when(size_t i) const { return _children[2 * i]; }
+    const ExprPtr& then(size_t i) const { return _children[2 * i + 1]; }
+    bool has_else() const { return _has_else; }
+    // nullptr without ELSE.
+    const Expr* else_expr() const { return _has_else ? _children.back().get() : nullptr; }
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override;
+
+protected:
+    size_t _node_hash() const override { return _has_else; }
+    bool _node_equals(const Expr& rhs) const override {
+        return _has_else == static_cast<const CaseExpr&>(rhs)._has_else;
+    }
+    void _append_node_key(Buffer<uint8_t>* dst) const override { put_fixed8(dst, _has_else); }
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const bool _has_else;
+};
+
+// The values are cast to the type all of them convert to most cheaply;
+// |else_expr| may be null.
+StatusOr<ExprPtr> make_case(const Exprs& whens, const Exprs& thens, ExprPtr else_expr);
+
+} // namespace starrocks
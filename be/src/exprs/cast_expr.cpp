@@ -0,0 +1,224 @@
+#include "exprs/cast_expr.h"
+
+#include <charconv>
+#include <limits>
+
+#include "exprs/function_helper.h"
+#include "util/date_util.h"
+
+namespace starrocks {
+
+static constexpr bool is_numeric_type(LogicalType type) {
+    return type == TYPE_BOOLEAN || is_integer_type(type) || is_float_type(type);
+}
+
+static constexpr bool is_date_type(LogicalType type) {
+    return type == TYPE_DATE || type == TYPE_DATETIME;
+}
+
+static constexpr int integer_width(LogicalType type) {
+    switch (type) {
+    case TYPE_TINYINT:
+        return 1;
+    case TYPE_SMALLINT:
+        return 2;
+    case TYPE_INT:
+        return 4;
+    case TYPE_BIGINT:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+static constexpr bool is_castable(LogicalType from, LogicalType to) {
+    return from == TYPE_VARCHAR || to == TYPE_VARCHAR || (is_numeric_type(from) && is_numeric_type(to)) ||
+           (is_date_type(from) && is_date_type(to));
+}
+
+static constexpr bool cast_may_fail(LogicalType from, LogicalType to) {
+    // A BITMAP value may not parse.
+    if (from == TYPE_BITMAP && to != TYPE_BITMAP) {
+        return true;
+    }
+    if (to == TYPE_BOOLEAN || to == TYPE_VARCHAR || from == to) {
+        return false;
+    }
+    if (from == TYPE_VARCHAR) {
+        return true;
+    }
+    // Narrowing integers and floating point values to integers.
+    return is_integer_type(to) &&
+           (is_float_type(from) || integer_width(from) > integer_width(to));
+}
+
+static Slice trim_blanks(Slice str) {
+    while (str.size > 0 && str.data[0] == ' ') {
+        str.remove_prefix(1);
+    }
+    while (str.size > 0 && str.data[str.size - 1] == ' ') {
+        --str.size;
+    }
+    return str;
+}
+
+template <typename T>
+static bool parse_number(Slice str, T* value) {
+    str = trim_blanks(str);
+    if (str.size > 1 && str.data[0] == '+' && str.data[1] != '-') {
+        str.remove_prefix(1);
+    }
+    auto [end, ec] = std::from_chars(str.data, str.data + str.size, *value);
+    return ec == std::errc() && end == str.data + str.size;
+}
+
+// Converts |value|; false if the target type cannot hold it.
+template <LogicalType FromLT, LogicalType ToLT>
+static bool convert(const RunTimeCppType<FromLT>& value, RunTimeCppType<ToLT>* out) {
+    using To = RunTimeCppType<ToLT>;
+    *out = To();
+    if constexpr (FromLT == TYPE_VARCHAR) {
+        if constexpr (ToLT == TYPE_BOOLEAN) {
+            Slice str = trim_blanks(value);
+            if (str == Slice("1") || str == Slice("true")) {
+                *out = 1;
+            } else if (!(str == Slice("0") || str == Slice("false"))) {
+                return false;
+            }
+            return true;
+        } else if constexpr (is_date_type(ToLT)) {
+            int64_t datetime;
+            if (!parse_datetime(value, &datetime)) {
+                return false;
+            }
+            *out = ToLT == TYPE_DATE ? datetime_to_date(datetime) : datetime;
+            return true;
+        } else {
+            return parse_number(value, out);
+        }
+    } else if constexpr (FromLT == TYPE_DATE && ToLT == TYPE_DATETIME) {
+        *out = date_to_datetime(value);
+        return true;
+    } else if constexpr (FromLT == TYPE_DATETIME && ToLT == TYPE_DATE) {
+        *out = datetime_to_date(value);
+        return true;
+    } else if constexpr (ToLT == TYPE_BOOLEAN) {
+        *out = value != 0;
+        return true;
+    } else if constexpr (is_integer_type(ToLT) && is_float_type(FromLT)) {
+        // Also false for NaN.
+        constexpr double kBound = -static_cast<double>(std::numeric_limits<To>::min());
+        if (!(value >= -kBound && value < kBound)) {
+            return false;
+        }
+        *out = static_cast<To>(value);
+        return true;
+    } else if constexpr (cast_may_fail(FromLT, ToLT)) {
+        if (value < std::numeric_limits<To>::min() || value > std::numeric_limits<To>::max()) {
+            return false;
+        }
+        *out = static_cast<To>(value);
+        return true;
+    } else {
+        *out = static_cast<To>(value);
+        return true;
+    }
+}
+
+template <LogicalType FromLT>
+static void append_string(const RunTimeCppType<FromLT>& value, BinaryColumn* dst) {
+    if constexpr (FromLT == TYPE_VARCHAR) {
+        dst->append(value);
+    } else if constexpr (FromLT == TYPE_DATE) {
+        dst->append_string(format_date(value));
+    } else if constexpr (FromLT == TYPE_DATETIME) {
+        dst->append_string(format_datetime(value));
+    } else {
+        // The shortest text reading back as the same value.
+        char buf[64];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        dst->append(Slice(buf, ec == std::errc() ? end - buf : 0));
+    }
+}
+
+// The argument is never constant: a constant is cast once, as a one-row
+// column (see call_with_default_nulls()).
+template <LogicalType FromLT, LogicalType ToLT>
+static StatusOr<ColumnPtr> cast_function(const Columns& args, size_t num_rows) {
+    ColumnReader<FromLT> in(args[0].get());
+    if constexpr (ToLT == TYPE_VARCHAR) {
+        auto result = BinaryColumn::create();
+        result->reserve(num_rows);
+        for (size_t i = 0; i < num_rows; ++i) {
+            append_string<FromLT>(in.value(i), result.get());
+        }
+        return result;
+    } else {
+        auto result = RunTimeColumnType<ToLT>::create();
+        result->resize_uninitialized(num_rows);
+        auto* out = result->get_data().data();
+        if constexpr (cast_may_fail(FromLT, ToLT)) {
+            auto nulls = NullColumn::create(num_rows, uint8_t{0});
+            auto* is_null = nulls->get_data().data();
+            for (size_t i = 0; i < num_rows; ++i) {
+                is_null[i] = !convert<FromLT, ToLT>(in.value(i), &out[i]);
+            }
+            return NullableColumn::create(std::move(result), std::move(nulls));
+        } else {
+            for (size_t i = 0; i < num_rows; ++i) {
+                convert<FromLT, ToLT>(in.value(i), &out[i]);
+            }
+            return result;
+        }
+    }
+}
+
+static ScalarFunction find_cast_function(LogicalType from, LogicalType to) {
+    return type_dispatch_all(from, [to](auto from_lt) {
+        return type_dispatch_all(to, [](auto to_lt) -> ScalarFunction {
+            constexpr LogicalType FromLT = decltype(from_lt)::value;
+            constexpr LogicalType ToLT = decltype(to_lt)::value;
+            if constexpr (is_castable(FromLT, ToLT)) {
+                return &cast_function<FromLT, ToLT>;
+            } else {
+                return nullptr;
+            }
+        });
+    });
+}
+
+CastExpr::CastExpr(ExprPtr child, LogicalType type, ScalarFunction fn)
+        : Expr(ExprKind::CAST, type, child->is_nullable() || cast_may_fail(child->type(), type), {child}),
+          _fn(fn) {}
+
+ExprPtr CastExpr::with_children(Exprs children) const {
+    return std::make_shared<CastExpr>(std::move(children[0]), _type, _fn);
+}
+
+StatusOr<ColumnPtr> CastExpr::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    ASSIGN_OR_RETURN(ColumnPtr arg, ctx->evaluate(_children[0].get(), chunk));
+    return call_with_default_nulls(_fn, {std::move(arg)}, chunk->num_rows(), _type);
+}
+
+StatusOr<ExprPtr> make_cast(ExprPtr child, LogicalType type) {
+    LogicalType from = child->type();
+    if (from == type) {
+        return child;
+    }
+    if (from == TYPE_UNKNOWN || type == TYPE_UNKNOWN || !is_castable(from, type)) {
+        return Status::InvalidArgument("cannot cast " + logical_type_to_string(from) + " to " +
+                                       logical_type_to_string(type));
+    }
+    ScalarFunction fn;
+    if (from == TYPE_BITMAP || type == TYPE_BITMAP) {
+        // Bitmaps are cast from and to their text form.
+        fn = FunctionRegistry::instance()
+                     .resolve(type == TYPE_BITMAP ? "bitmap_from_string" : "bitmap_to_string", {from})
+                     ->fn;
+    } else {
+        fn = find_cast_function(from, type);
+    }
+    return std::make_shared<CastExpr>(std::move(child), type, fn);
+}
+
+} // namespace starrocks
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "exprs/expr.h"
+#include "exprs/function_registry.h"
+
+namespace starrocks {
+
+// CAST(child AS type). Numbers convert to numbers, DATE to DATETIME and
+// back, and anything to and from VARCHAR. A value the target type cannot
+// hold, an unparsable string or an integer out of range, is NULL.
+class CastExpr final : public Expr {
+public:
+    CastExpr(ExprPtr child, LogicalType type, ScalarFunction fn);
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override {
+        return "cast(" + _children[0]->debug_string() + " AS " + logical_type_to_string(_type) + ")";
+    }
+
+protected:
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const ScalarFunction _fn;
+};
+
+// |child| as |type|; |child| itself when it already is.
+StatusOr<ExprPtr> make_cast(ExprPtr child, LogicalType type);
+
+} // namespace starrocks
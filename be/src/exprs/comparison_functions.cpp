@@ -0,0 +1,114 @@
+#include "exprs/function_helper.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+using simd::CompareOp;
+
+// The same comparison with its operands swapped.
+static constexpr CompareOp swap_operands(CompareOp op) {
+    switch (op) {
+    case CompareOp::LT:
+        return CompareOp::GT;
+    case CompareOp::LE:
+        return CompareOp::GE;
+    case CompareOp::GT:
+        return CompareOp::LT;
+    case CompareOp::GE:
+        return CompareOp::LE;
+    default:
+        return op;
+    }
+}
+
+template <CompareOp Op, typename T>
+static bool compare(const T& a, const T& b) {
+    if constexpr (Op == CompareOp::EQ) {
+        return a == b;
+    } else if constexpr (Op == CompareOp::NE) {
+        return a != b;
+    } else if constexpr (Op == CompareOp::LT) {
+        return a < b;
+    } else if constexpr (Op == CompareOp::LE) {
+        return a <= b;
+    } else if constexpr (Op == CompareOp::GT) {
+        return a > b;
+    } else {
+        return a >= b;
+    }
+}
+
+// A column compared with a constant, the common case of a filter, runs the
+// SIMD predicate kernels of the scans.
+template <LogicalType LT, CompareOp Op>
+static StatusOr<ColumnPtr> compare_function(const Columns& args, size_t num_rows) {
+    auto result = BooleanColumn::create();
+    result->resize_uninitialized(num_rows);
+    uint8_t* out = result->get_data().data();
+    const Column* lhs = args[0].get();
+    const Column* rhs = args[1].get();
+    if constexpr (LT != TYPE_VARCHAR) {
+        using T = RunTimeCppType<LT>;
+        if (!lhs->is_constant() && rhs->is_constant()) {
+            simd::compare(Op, reinterpret_cast<const T*>(lhs->raw_data()), num_rows, ConstReader<LT>(rhs).value(0),
+                          out);
+            return result;
+        }
+        if (lhs->is_constant() && !rhs->is_constant()) {
+            simd::compare(swap_operands(Op), reinterpret_cast<const T*>(rhs->raw_data()), num_rows,
+                          ConstReader<LT>(lhs).value(0), out);
+            return result;
+        }
+    }
+    with_readers<LT, LT>(lhs, rhs, [&](const auto& a, const auto& b) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            out[i] = compare<Op>(a.value(i), b.value(i));
+        }
+    });
+    return result;
+}
+
+// IS NULL and IS NOT NULL, never NULL themselves.
+template <bool kIsNull>
+static StatusOr<ColumnPtr> is_null_function(const Columns& args, size_t num_rows) {
+    const Column* arg = args[0].get();
+    if (arg->is_constant()) {
+        return ColumnHelper::create_const_column<TYPE_BOOLEAN>(arg->only_null() == kIsNull, num_rows);
+    }
+    const NullData* nulls = ColumnHelper::get_null_data(arg);
+    if (nulls == nullptr) {
+        return ColumnHelper::create_const_column<TYPE_BOOLEAN>(!kIsNull, num_rows);
+    }
+    auto result = BooleanColumn::create();
+    result->resize_uninitialized(num_rows);
+    uint8_t* out = result->get_data().data();
+    for (size_t i = 0; i < num_rows; ++i) {
+        out[i] = kIsNull ? (*nulls)[i] : !(*nulls)[i];
+    }
+    return result;
+}
+
+template <LogicalType LT>
+static void add_comparisons(FunctionRegistry* registry) {
+    registry->add({"eq", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::EQ>});
+    registry->add({"ne", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::NE>});
+    registry->add({"lt", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::LT>});
+    registry->add({"le", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::LE>});
+    registry->add({"gt", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::GT>});
+    registry->add({"ge", {LT, LT}, TYPE_BOOLEAN, &compare_function<LT, CompareOp::GE>});
+    FunctionDescriptor is_null{"is_null", {LT}, TYPE_BOOLEAN, &is_null_function<true>};
+    is_null.handles_nulls = true;
+    registry->add(std::move(is_null));
+    FunctionDescriptor is_not_null{"is_not_null", {LT}, TYPE_BOOLEAN, &is_null_function<false>};
+    is_not_null.handles_nulls = true;
+    registry->add(std::move(is_not_null));
+}
+
+void register_comparison_functions(FunctionRegistry* registry) {
+    for (LogicalType type : {TYPE_BOOLEAN, TYPE_TINYINT, TYPE_SMALLINT, TYPE_INT, TYPE_BIGINT, TYPE_FLOAT,
+                             TYPE_DOUBLE, TYPE_DATE, TYPE_DATETIME, TYPE_VARCHAR}) {
+        type_dispatch_all(type, [registry](auto lt) { add_comparisons<decltype(lt)::value>(registry); });
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,135 @@
+#include "exprs/compound_predicate.h"
+
+#include "exprs/function_helper.h"
+
+namespace starrocks {
+
+static bool is_any_nullable(const Exprs& children) {
+    for (const auto& child : children) {
+        if (child->is_nullable()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CompoundPredicate::CompoundPredicate(CompoundOp op, Exprs children)
+        : Expr(ExprKind::COMPOUND_PREDICATE, TYPE_BOOLEAN, is_any_nullable(children), std::move(children)), _op(op) {}
+
+ExprPtr CompoundPredicate::with_children(Exprs children) const {
+    return std::make_shared<CompoundPredicate>(_op, std::move(children));
+}
+
+std::string CompoundPredicate::debug_string() const {
+    if (_op == CompoundOp::NOT) {
+        return "NOT " + _children[0]->debug_string();
+    }
+    return "(" + _children[0]->debug_string() + (_op == CompoundOp::AND ? " AND " : " OR ") +
+           _children[1]->debug_string() + ")";
+}
+
+struct NotOp {
+    template <typename R>
+    static R apply(uint8_t value) {
+        return value == 0;
+    }
+};
+
+// Values and NULLs of a BOOLEAN column, constant or not.
+class BooleanView {
+public:
+    explicit BooleanView(const Column* column)
+            : _values(ColumnHelper::get_data_column(column)->raw_data()), _is_const(column->is_constant()) {
+        if (_is_const) {
+            _const_null = column->only_null();
+        } else {
+            const NullData* nulls = ColumnHelper::get_null_data(column);
+            _nulls = nulls == nullptr ? nullptr : nulls->data();
+        }
+    }
+
+    bool is_null(size_t i) const { return _is_const ? _const_null : _nulls != nullptr && _nulls[i]; }
+    bool value(size_t i) const { return _values[_is_const ? 0 : i] != 0; }
+    // TRUE for |decisive| TRUE, FALSE otherwise.
+    bool is(size_t i, bool decisive) const { return !is_null(i) && value(i) == decisive; }
+
+private:
+    const uint8_t* _values;
+    const uint8_t* _nulls = nullptr;
+    bool _is_const;
+    bool _const_null = false;
+};
+
+StatusOr<ColumnPtr> CompoundPredicate::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    const size_t num_rows = chunk->num_rows();
+    ASSIGN_OR_RETURN(ColumnPtr lhs, ctx->evaluate(_children[0].get(), chunk));
+    if (_op == CompoundOp::NOT) {
+        return call_with_default_nulls(&unary_function<TYPE_BOOLEAN, TYPE_BOOLEAN, NotOp>, {std::move(lhs)}, num_rows,
+                                       TYPE_BOOLEAN);
+    }
+    // The value deciding the result alone: FALSE for AND, TRUE for OR.
+    const bool decisive = _op == CompoundOp::OR;
+    BooleanView left(lhs.get());
+    if (lhs->is_constant() && !left.is_null(0)) {
+        if (left.value(0) == decisive) {
+            return lhs;
+        }
+        return ctx->evaluate(_children[1].get(), chunk);
+    }
+
+    Buffer<uint8_t> undecided(num_rows);
+    for (size_t r = 0; r < num_rows; ++r) {
+        undecided[r] = !left.is(r, decisive);
+    }
+    size_t num_undecided = ColumnHelper::count_nonzero(undecided.data(), num_rows);
+    if (num_undecided == 0) {
+        return lhs;
+    }
+    bool compacted;
+    ASSIGN_OR_RETURN(ColumnPtr rhs, ctx->evaluate_selected(_children[1].get(), chunk, undecided.data(),
+                                                           num_undecided, &compacted));
+    BooleanView right(rhs.get());
+
+    auto data = BooleanColumn::create();
+    data->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    uint8_t* out = data->get_data().data();
+    uint8_t* is_null = nulls->get_data().data();
+    bool has_null = false;
+    size_t next = 0;
+    for (size_t r = 0; r < num_rows; ++r) {
+        if (!undecided[r]) {
+            out[r] = decisive;
+            continue;
+        }
+        size_t i = compacted ? next++ : r;
+        if (right.is(i, decisive)) {
+            out[r] = decisive;
+        } else if (left.is_null(r) || right.is_null(i)) {
+            out[r] = 0;
+            is_null[r] = 1;
+            has_null = true;
+        } else {
+            out[r] = !decisive;
+        }
+    }
+    if (!has_null) {
+        return data;
+    }
+    return NullableColumn::create(std::move(data), std::move(nulls));
+}
+
+StatusOr<ExprPtr> make_compound_predicate(CompoundOp op, Exprs children) {
+    size_t num_children = op == CompoundOp::NOT ? 1 : 2;
+    if (children.size() != num_children) {
+        return Status::InvalidArgument("compound predicate with " + std::to_string(children.size()) + " operands");
+    }
+    for (const auto& child : children) {
+        if (child->type() != TYPE_BOOLEAN) {
+            return Status::InvalidArgument("compound predicate over " + logical_type_to_string(child->type()));
+        }
+    }
+    return std::make_shared<CompoundPredicate>(op, std::move(children));
+}
+
+} // namespace starrocks
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "exprs/expr.h"
+
+namespace starrocks {
+
+enum class CompoundOp {
+    AND,
+    OR,
+    NOT,
+};
+
+// AND, OR and NOT in three-valued logic: FALSE AND NULL is FALSE, TRUE OR
+// NULL is TRUE. The right side of AND (OR) is only evaluated for the rows
+// the left side did not make FALSE (TRUE), and not at all when it made all
+// of them so.
+class CompoundPredicate final : public Expr {
+public:
+    CompoundPredicate(CompoundOp op, Exprs children);
+
+    CompoundOp op() const { return _op; }
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override;
+
+protected:
+    size_t _node_hash() const override { return static_cast<size_t>(_op); }
+    bool _node_equals(const Expr& rhs) const override {
+        return _op == static_cast<const CompoundPredicate&>(rhs)._op;
+    }
+    void _append_node_key(Buffer<uint8_t>* dst) const override { put_fixed8(dst, static_cast<uint8_t>(_op)); }
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const CompoundOp _op;
+};
+
+// AND and OR take two BOOLEAN children, NOT one.
+StatusOr<ExprPtr> make_compound_predicate(CompoundOp op, Exprs children);
+
+} // namespace starrocks
@@ -0,0 +1,107 @@
+#include <type_traits>
+
+#include "exprs/function_helper.h"
+#include "util/date_util.h"
+
+namespace starrocks {
+
+// DATE values are int32_t days and DATETIME values int64_t microseconds, so
+// the operations below tell them apart by their C++ type.
+template <typename T>
+static int32_t day_of(T value) {
+    if constexpr (std::is_same_v<T, int64_t>) {
+        return datetime_to_date(value);
+    } else {
+        return value;
+    }
+}
+
+struct YearOp {
+    template <typename R, typename T>
+    static R apply(T value) {
+        return civil_from_days(day_of(value)).year;
+    }
+};
+
+struct MonthOp {
+    template <typename R, typename T>
+    static R apply(T value) {
+        return civil_from_days(day_of(value)).month;
+    }
+};
+
+struct DayOp {
+    template <typename R, typename T>
+    static R apply(T value) {
+        return civil_from_days(day_of(value)).day;
+    }
+};
+
+struct HourOp {
+    template <typename R>
+    static R apply(int64_t value) {
+        return static_cast<R>(datetime_time_of_day(value) / (3600 * kMicrosPerSecond));
+    }
+};
+
+struct MinuteOp {
+    template <typename R>
+    static R apply(int64_t value) {
+        return static_cast<R>(datetime_time_of_day(value) / (60 * kMicrosPerSecond) % 60);
+    }
+};
+
+struct SecondOp {
+    template <typename R>
+    static R apply(int64_t value) {
+        return static_cast<R>(datetime_time_of_day(value) / kMicrosPerSecond % 60);
+    }
+};
+
+struct ToDateOp {
+    template <typename R>
+    static R apply(int64_t value) {
+        return datetime_to_date(value);
+    }
+};
+
+template <int64_t kSign>
+struct DaysAddOp {
+    template <typename R, typename T>
+    static R apply(T value, int64_t days) {
+        if constexpr (std::is_same_v<T, int64_t>) {
+            return value + kSign * days * kMicrosPerDay;
+        } else {
+            return static_cast<R>(value + kSign * days);
+        }
+    }
+};
+
+// Days from the second date to the first, ignoring the times of day.
+struct DateDiffOp {
+    template <typename R, typename T>
+    static R apply(T lhs, T rhs) {
+        return static_cast<R>(day_of(lhs)) - day_of(rhs);
+    }
+};
+
+template <LogicalType LT>
+static void add_date_functions(FunctionRegistry* registry) {
+    registry->add({"year", {LT}, TYPE_INT, &unary_function<LT, TYPE_INT, YearOp>});
+    registry->add({"month", {LT}, TYPE_INT, &unary_function<LT, TYPE_INT, MonthOp>});
+    registry->add({"day", {LT}, TYPE_INT, &unary_function<LT, TYPE_INT, DayOp>});
+    registry->add({"days_add", {LT, TYPE_BIGINT}, LT, &binary_function<LT, TYPE_BIGINT, LT, DaysAddOp<1>>});
+    registry->add({"days_sub", {LT, TYPE_BIGINT}, LT, &binary_function<LT, TYPE_BIGINT, LT, DaysAddOp<-1>>});
+    registry->add({"datediff", {LT, LT}, TYPE_BIGINT, &binary_function<LT, LT, TYPE_BIGINT, DateDiffOp>});
+}
+
+void register_date_functions(FunctionRegistry* registry) {
+    add_date_functions<TYPE_DATE>(registry);
+    add_date_functions<TYPE_DATETIME>(registry);
+    registry->add({"hour", {TYPE_DATETIME}, TYPE_INT, &unary_function<TYPE_DATETIME, TYPE_INT, HourOp>});
+    registry->add({"minute", {TYPE_DATETIME}, TYPE_INT, &unary_function<TYPE_DATETIME, TYPE_INT, MinuteOp>});
+    registry->add({"second", {TYPE_DATETIME}, TYPE_INT, &unary_function<TYPE_DATETIME, TYPE_INT, SecondOp>});
+    registry->add({"to_date", {TYPE_DATETIME}, TYPE_DATE, &unary_function<TYPE_DATETIME, TYPE_DATE, ToDateOp>});
+}
+
+} // namespace starrocks
@@ -0,0 +1,214 @@
+#include "exprs/expr.h"
+
+#include <algorithm>
+
+#include "column/column_helper.h"
+#include "common/config.h"
+#include "simd/predicate_kernels.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+Expr::Expr(ExprKind kind, LogicalType type, bool nullable, Exprs&& children)
+        : _kind(kind), _type(type), _nullable(nullable), _children(std::move(children)) {
+    for (const auto& child : _children) {
+        _is_constant = _is_constant && child->is_constant();
+    }
+}
+
+size_t Expr::shallow_hash() const {
+    if (_hash == 0) {
+        uint64_t h = HashUtil::hash64(static_cast<uint64_t>(_kind) << 32 | static_cast<uint64_t>(_type));
+        h = HashUtil::combine(h, _node_hash());
+        for (const auto& child : _children) {
+            h = HashUtil::combine(h, reinterpret_cast<uintptr_t>(child.get()));
+        }
+        _hash = h == 0 ? 1 : h;
+    }
+    return _hash;
+}
+
+bool Expr::shallow_equals(const Expr& rhs) const {
+    if (_kind != rhs._kind || _type != rhs._type || _nullable != rhs._nullable ||
+        _children.size() != rhs._children.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < _children.size(); ++i) {
+        if (_children[i] != rhs._children[i]) {
+            return false;
+        }
+    }
+    return _node_equals(rhs);
+}
+
+void Expr::append_shallow_key(Buffer<uint8_t>* dst) const {
+    put_fixed8(dst, static_cast<uint8_t>(_kind));
+    put_fixed32(dst, static_cast<uint32_t>(_type));
+    put_fixed8(dst, _nullable);
+    put_varint64(dst, _children.size());
+    _append_node_key(dst);
+}
+
+void Expr::get_slot_ids(std::vector<SlotId>* slot_ids) const {
+    if (_kind == ExprKind::COLUMN_REF) {
+        slot_ids->push_back(static_cast<const ColumnRef*>(this)->slot_id());
+        return;
+    }
+    for (const auto& child : _children) {
+        child->get_slot_ids(slot_ids);
+    }
+}
+
+void ExprContext::reset(const Chunk* chunk) {
+    _chunk = chunk;
+    _values.clear();
+}
+
+void ExprContext::select_rows(const uint32_t* indexes, size_t size, const Chunk* chunk) {
+    for (auto& [expr, value] : _values) {
+        value = ColumnHelper::select_rows(value, indexes, size);
+    }
+    _chunk = chunk;
+}
+
+StatusOr<ColumnPtr> ExprContext::evaluate(const Expr* expr, const Chunk* chunk) {
+    // Values are only kept for the whole chunk, not for the subsets of it
+    // evaluate_selected() works on.
+    if (_shared.empty() || chunk != _chunk || _shared.count(expr) == 0) {
+        return expr->_evaluate(this, chunk);
+    }
+    auto it = _values.find(expr);
+    if (it != _values.end()) {
+        ++_num_reused_values;
+        return it->second;
+    }
+    ASSIGN_OR_RETURN(ColumnPtr value, expr->_evaluate(this, chunk));
+    _values.emplace(expr, value);
+    return value;
+}
+
+StatusOr<ColumnPtr> ExprContext::evaluate_selected(const Expr* expr, const Chunk* chunk, const uint8_t* selected,
+                                                   size_t num_selected, bool* compacted) {
+    size_t num_rows = chunk->num_rows();
+    *compacted = false;
+    if (num_selected == num_rows || expr->is_constant() ||
+        static_cast<double>(num_selected) > config::expr_selective_eval_ratio * static_cast<double>(num_rows) ||
+        (chunk == _chunk && _values.count(expr) > 0)) {
+        return evaluate(expr, chunk);
+    }
+    std::vector<SlotId> slot_ids;
+    expr->get_slot_ids(&slot_ids);
+    std::sort(slot_ids.begin(), slot_ids.end());
+    slot_ids.erase(std::unique(slot_ids.begin(), slot_ids.end()), slot_ids.end());
+
+    _indexes.resize(num_rows);
+    size_t n = simd::filter_to_selection(selected, 0, num_rows, _indexes.data());
+    Chunk rows;
+    for (SlotId slot_id : slot_ids) {
+        rows.append_column(ColumnHelper::select_rows(chunk->get_column_by_slot_id(slot_id), _indexes.data(), n),
+                           slot_id);
+    }
+    *compacted = true;
+    return evaluate(expr, &rows);
+}
+
+ColumnRef::ColumnRef(const SlotDescriptor& slot)
+        : Expr(ExprKind::COLUMN_REF, slot.type, slot.nullable), _slot_id(slot.id) {
+    _is_constant = false;
+}
+
+ExprPtr ColumnRef::with_children(Exprs children) const {
+    return std::make_shared<ColumnRef>(*this);
+}
+
+StatusOr<ColumnPtr> ColumnRef::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    if (!chunk->is_slot_exist(_slot_id)) {
+        return Status::InternalError("no slot " + std::to_string(_slot_id) + " in the chunk");
+    }
+    return chunk->get_column_by_slot_id(_slot_id);
+}
+
+Literal::Literal(LogicalType type, ColumnPtr value)
+        : Expr(ExprKind::LITERAL, type, value->only_null()), _value(std::move(value)) {}
+
+ExprPtr Literal::with_children(Exprs children) const {
+    return std::make_shared<Literal>(*this);
+}
+
+size_t Literal::_node_hash() const {
+    if (is_null()) {
+        return 0;
+    }
+    if (_value->is_binary()) {
+        Slice value = static_cast<const BinaryColumn*>(_value.get())->get_slice(0);
+        return HashUtil::hash_bytes(value.data, value.size);
+    }
+    return HashUtil::hash_bytes(_value->raw_data(), _value->type_size());
+}
+
+bool Literal::_node_equals(const Expr& rhs) const {
+    const auto& other = static_cast<const Literal&>(rhs);
+    if (is_null() || other.is_null()) {
+        return is_null() == other.is_null();
+    }
+    return _value->compare_at(0, 0, *other._value, 1) == 0;
+}
+
+void Literal::_append_node_key(Buffer<uint8_t>* dst) const {
+    put_fixed8(dst, is_null());
+    if (is_null()) {
+        return;
+    }
+    if (_value->is_binary()) {
+        put_length_prefixed_slice(dst, static_cast<const BinaryColumn*>(_value.get())->get_slice(0));
+        return;
+    }
+    // The exact bits: 1e-7 and 2e-7, or 0.0 and -0.0, are different keys.
+    dst->append(_value->raw_data(), _value->type_size());
+}
+
+StatusOr<ColumnPtr> Literal::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    return ConstColumn::create(_value, chunk->num_rows());
+}
+
+ExprPtr make_column_ref(const SlotDescriptor& slot) {
+    return std::make_shared<ColumnRef>(slot);
+}
+
+ExprPtr make_literal(LogicalType type, const Datum& value) {
+    ColumnPtr column = ColumnHelper::create_column(type, value.is_null());
+    column->append_datum(value);
+    return std::make_shared<Literal>(type, std::move(column));
+}
+
+ExprPtr make_literal(LogicalType type, const ColumnPtr& value) {
+    const Column* data = value.get();
+    if (data->is_constant()) {
+        data = static_cast<const ConstColumn*>(data)->data_column().get();
+    }
+    if (data->only_null()) {
+        return std::make_shared<Literal>(type, data->clone());
+    }
+    if (data->is_nullable()) {
+        data = static_cast<const NullableColumn*>(data)->data_column().get();
+    }
+    ColumnPtr column = data->clone_empty();
+    column->append(*data, 0, 1);
+    return std::make_shared<Literal>(type, std::move(column));
+}
+
+bool is_literal_true(const Expr& expr) {
+    return expr.kind() == ExprKind::LITERAL && expr.type() == TYPE_BOOLEAN &&
+           !static_cast<const Literal&>(expr).is_null() && static_cast<const Literal&>(expr).datum().get_uint8() != 0;
+}
+
+bool is_literal_false(const Expr& expr) {
+    return expr.kind() == ExprKind::LITERAL && expr.type() == TYPE_BOOLEAN &&
+           !static_cast<const Literal&>(expr).is_null() && static_cast<const Literal&>(expr).datum().get_uint8() == 0;
+}
+
+bool is_literal_null(const Expr& expr) {
+    return expr.kind() == ExprKind::LITERAL && static_cast<const Literal&>(expr).is_null();
+}
+
+} // namespace starrocks
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "column/chunk.h"
+#include "column/datum.h"
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+#include "types/logical_type.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+class Expr;
+class ExprContext;
+
+using ExprPtr = std::shared_ptr<const Expr>;
+using Exprs = std::vector<ExprPtr>;
+
+enum class ExprKind {
+    COLUMN_REF,
+    LITERAL,
+    CAST,
+    FUNCTION_CALL,
+    CASE,
+    COMPOUND_PREDICATE,
+};
+
+// A scalar expression, evaluated a chunk at a time into a column with one
+// value per row. Expressions are immutable trees, or DAGs once ExprProgram
+// has merged their common subexpressions: rewrites build new nodes.
+//
+// The column an expression yields is of type() and has the rows of the
+// chunk, but its shape is whatever is cheapest: a ConstColumn when every row
+// has the same value, not nullable when no row is NULL even if
+// is_nullable(), and possibly a column of the chunk itself. Callers must not
+// modify it.
+class Expr {
+public:
+    virtual ~Expr() = default;
+
+    ExprKind kind() const { return _kind; }
+    LogicalType type() const { return _type; }
+    // Whether some row may be NULL.
+    bool is_nullable() const { return _nullable; }
+    const Exprs& children() const { return _children; }
+    const ExprPtr& child(size_t i) const { return _children[i]; }
+
+    // No column is read: every row has the same value.
+    bool is_constant() const { return _is_constant; }
+
+    // Hash and equality of this node over the same child instances; children
+    // are compared by identity, so whole trees compare equal once their
+    // subtrees have been merged bottom up.
+    size_t shallow_hash() const;
+    bool shallow_equals(const Expr& rhs) const;
+    // Appends what shallow_equals() compares, bar the child instances, as
+    // fixed-width integers and length-prefixed bytes; the child count makes
+    // a whole tree written in preorder unambiguous.
+    void append_shallow_key(Buffer<uint8_t>* dst) const;
+
+    // A copy of this node over |children|, of the same types.
+    virtual ExprPtr with_children(Exprs children) const = 0;
+
+    // Appends the slots read by this expression, with repeats.
+    void get_slot_ids(std::vector<SlotId>* slot_ids) const;
+
+    virtual std::string debug_string() const = 0;
+
+protected:
+    Expr(ExprKind kind, LogicalType type, bool nullable, Exprs&& children = {});
+
+    virtual size_t _node_hash() const { return 0; }
+    // |rhs| is of the same kind.
+    virtual bool _node_equals(const Expr& rhs) const { return true; }
+    virtual void _append_node_key(Buffer<uint8_t>* dst) const {}
+
+    // Evaluates the node; children are evaluated through |ctx|.
+    virtual StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const = 0;
+
+    const ExprKind _kind;
+    const LogicalType _type;
+    const bool _nullable;
+    const Exprs _children;
+    bool _is_constant = true;
+
+private:
+    friend class ExprContext;
+
+    mutable size_t _hash = 0;
+};
+
+// Evaluation state of the expressions of one ExprProgram, reused for chunk
+// after chunk by one driver. The subexpressions several of them share are
+// computed once per chunk: their values are kept until the next chunk,
+// following the rows as the program filters them.
+class ExprContext {
+public:
+    ExprContext() = default;
+    explicit ExprContext(std::unordered_set<const Expr*> shared) : _shared(std::move(shared)) {}
+
+    DISALLOW_COPY_AND_MOVE(ExprContext);
+
+    // Starts over on |chunk|, dropping the values kept for the previous one.
+    void reset(const Chunk* chunk);
+    // The current chunk was narrowed to its rows |indexes[0..size)| as
+    // |chunk|.
+    void select_rows(const uint32_t* indexes, size_t size, const Chunk* chunk);
+
+    StatusOr<ColumnPtr> evaluate(const Expr* expr, const Chunk* chunk);
+
+    // Evaluates |expr| for the rows of |chunk| whose byte of |selected| is
+    // set, |num_selected| > 0 of them, typically the rows still undecided by
+    // CASE, AND or OR. A small enough share of the rows is evaluated over a
+    // copy of just those rows, and the result holds them in order, with
+    // *|compacted| set; otherwise all rows are evaluated and those not
+    // selected hold arbitrary values.
+    StatusOr<ColumnPtr> evaluate_selected(const Expr* expr, const Chunk* chunk, const uint8_t* selected,
+                                          size_t num_selected, bool* compacted);
+
+    size_t num_reused_values() const { return _num_reused_values; }
+
+private:
+    std::unordered_set<const Expr*> _shared;
+    const Chunk* _chunk = nullptr;
+    std::unordered_map<const Expr*, ColumnPtr> _values;
+    Buffer<uint32_t> _indexes;
+    size_t _num_reused_values = 0;
+};
+
+class ColumnRef final : public Expr {
+public:
+    explicit ColumnRef(const SlotDescriptor& slot);
+
+    SlotId slot_id() const { return _slot_id; }
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override { return "slot#" + std::to_string(_slot_id); }
+
+protected:
+    size_t _node_hash() const override { return std::hash<SlotId>()(_slot_id); }
+    bool _node_equals(const Expr& rhs) const override {
+        return _slot_id == static_cast<const ColumnRef&>(rhs)._slot_id;
+    }
+    void _append_node_key(Buffer<uint8_t>* dst) const override { put_fixed32(dst, _slot_id); }
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const SlotId _slot_id;
+};
+
+class Literal final : public Expr {
+public:
+    // |value| is a column holding just the value, nullable if it is NULL.
+    Literal(LogicalType type, ColumnPtr value);
+
+    bool is_null() const { return _value->only_null(); }
+    // The value as a one-row column.
+    const ColumnPtr& value() const { return _value; }
+    Datum datum() const { return _value->get(0); }
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override { return _value->debug_item(0); }
+
+protected:
+    size_t _node_hash() const override;
+    bool _node_equals(const Expr& rhs) const override;
+    void _append_node_key(Buffer<uint8_t>* dst) const override;
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const ColumnPtr _value;
+};
+
+ExprPtr make_column_ref(const SlotDescriptor& slot);
+// A NULL literal when |value| is null; string values are copied.
+ExprPtr make_literal(LogicalType type, const Datum& value);
+// The value of the one-row column |value|.
+ExprPtr make_literal(LogicalType type, const ColumnPtr& value);
+
+// Whether |expr| is the BOOLEAN literal TRUE, FALSE, or a NULL literal.
+bool is_literal_true(const Expr& expr);
+bool is_literal_false(const Expr& expr);
+bool is_literal_null(const Expr& expr);
+
+} // namespace starrocks
@@ -0,0 +1,299 @@
+#include "exprs/expr_program.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "column/column_helper.h"
+#include "exprs/case_expr.h"
+#include "exprs/compound_predicate.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+// Evaluates a constant expression over a chunk of one row no expression
+// reads.
+static ExprPtr evaluate_constant(const ExprPtr& expr) {
+    Chunk chunk;
+    chunk.append_column(BooleanColumn::create(1, uint8_t{0}));
+    ExprContext ctx;
+    ctx.reset(&chunk);
+    StatusOr<ColumnPtr> value = ctx.evaluate(expr.get(), &chunk);
+    if (!value.ok()) {
+        return expr;
+    }
+    return make_literal(expr->type(), value.value());
+}
+
+static ExprPtr simplify_compound(const ExprPtr& expr) {
+    const auto& predicate = static_cast<const CompoundPredicate&>(*expr);
+    if (predicate.op() == CompoundOp::NOT) {
+        return expr;
+    }
+    // FALSE decides AND and TRUE decides OR; the other value is neutral.
+    const bool decisive = predicate.op() == CompoundOp::OR;
+    auto is_decisive = [decisive](const Expr& e) { return decisive ? is_literal_true(e) : is_literal_false(e); };
+    auto is_neutral = [decisive](const Expr& e) { return decisive ? is_literal_false(e) : is_literal_true(e); };
+    const ExprPtr& lhs = predicate.child(0);
+    const ExprPtr& rhs = predicate.child(1);
+    if (is_decisive(*lhs)) {
+        return lhs;
+    }
+    if (is_decisive(*rhs)) {
+        return rhs;
+    }
+    if (is_neutral(*lhs)) {
+        return rhs;
+    }
+    if (is_neutral(*rhs)) {
+        return lhs;
+    }
+    return expr;
+}
+
+static ExprPtr simplify_case(const ExprPtr& expr) {
+    const auto& case_expr = static_cast<const CaseExpr&>(*expr);
+    Exprs children;
+    bool has_else = case_expr.has_else();
+    ExprPtr else_value = has_else ? case_expr.children().back() : nullptr;
+    bool changed = false;
+    for (size_t i = 0; i < case_expr.num_whens(); ++i) {
+        const Expr& when = *case_expr.when(i);
+        if (is_literal_false(when) || is_literal_null(when)) {
+            changed = true;
+            continue;
+        }
+        if (is_literal_true(when)) {
+            // Later branches are never taken.
+            else_value = case_expr.then(i);
+            has_else = true;
+            changed = true;
+            break;
+        }
+        children.push_back(case_expr.when(i));
+        children.push_back(case_expr.then(i));
+    }
+    if (!changed) {
+        return expr;
+    }
+    if (children.empty()) {
+        return has_else ? else_value : make_literal(expr->type(), Datum());
+    }
+    if (has_else) {
+        children.push_back(std::move(else_value));
+    }
+    return std::make_shared<CaseExpr>(expr->type(), std::move(children), has_else);
+}
+
+ExprPtr fold_constants(const ExprPtr& expr) {
+    if (expr->kind() == ExprKind::COLUMN_REF || expr->kind() == ExprKind::LITERAL) {
+        return expr;
+    }
+    Exprs children;
+    children.reserve(expr->children().size());
+    bool changed = false;
+    for (const auto& child : expr->children()) {
+        children.push_back(fold_constants(child));
+        changed = changed || children.back() != child;
+    }
+    ExprPtr node = changed ? expr->with_children(std::move(children)) : expr;
+    if (node->is_constant()) {
+        return evaluate_constant(node);
+    }
+    if (node->kind() == ExprKind::COMPOUND_PREDICATE) {
+        return simplify_compound(node);
+    }
+    if (node->kind() == ExprKind::CASE) {
+        return simplify_case(node);
+    }
+    return node;
+}
+
+// Merges equal subtrees bottom up: each node is replaced by the first node
+// seen equal to it, so children are equal only when identical and one level
+// of comparison suffices.
+class ExprMerger {
+public:
+    ExprPtr merge(const ExprPtr& expr) {
+        auto it = _merged.find(expr.get());
+        if (it != _merged.end()) {
+            return it->second;
+        }
+        Exprs children;
+        children.reserve(expr->children().size());
+        bool changed = false;
+        for (const auto& child : expr->children()) {
+            children.push_back(merge(child));
+            changed = changed || children.back() != child;
+        }
+        ExprPtr node = changed ? expr->with_children(std::move(children)) : expr;
+        Exprs& bucket = _nodes[node->shallow_hash()];
+        auto equal = std::find_if(bucket.begin(), bucket.end(),
+                                  [&](const ExprPtr& e) { return e->shallow_equals(*node); });
+        if (equal != bucket.end()) {
+            node = *equal;
+        } else {
+            bucket.push_back(node);
+        }
+        _merged.emplace(expr.get(), node);
+        return node;
+    }
+
+private:
+    std::unordered_map<const Expr*, ExprPtr> _merged;
+    std::unordered_map<size_t, Exprs> _nodes;
+};
+
+static void split_conjuncts(const ExprPtr& expr, Exprs* conjuncts) {
+    if (expr->kind() == ExprKind::COMPOUND_PREDICATE &&
+        static_cast<const CompoundPredicate&>(*expr).op() == CompoundOp::AND) {
+        split_conjuncts(expr->child(0), conjuncts);
+        split_conjuncts(expr->child(1), conjuncts);
+        return;
+    }
+    conjuncts->push_back(expr);
+}
+
+// Counts the uses of each node of the DAG, one per parent and one per root.
+static void count_uses(const Expr* expr, std::unordered_map<const Expr*, int>* uses) {
+    if ((*uses)[expr]++ > 0) {
+        return;
+    }
+    for (const auto& child : expr->children()) {
+        count_uses(child.get(), uses);
+    }
+}
+
+StatusOr<std::unique_ptr<ExprProgram>> ExprProgram::create(const Exprs& conjuncts,
+                                                           const std::vector<Projection>& projections) {
+    std::unique_ptr<ExprProgram> program(new ExprProgram());
+    for (const auto& conjunct : conjuncts) {
+        if (conjunct->type() != TYPE_BOOLEAN) {
+            return Status::InvalidArgument("conjunct of type " + logical_type_to_string(conjunct->type()));
+        }
+        Exprs split;
+        split_conjuncts(fold_constants(conjunct), &split);
+        for (auto& expr : split) {
+            if (is_literal_true(*expr)) {
+                continue;
+            }
+            if (is_literal_false(*expr) || is_literal_null(*expr)) {
+                program->_always_false = true;
+            }
+            program->_conjuncts.push_back(std::move(expr));
+        }
+    }
+    for (const auto& projection : projections) {
+        program->_projections.push_back({projection.slot_id, fold_constants(projection.expr)});
+    }
+
+    ExprMerger merger;
+    for (auto& conjunct : program->_conjuncts) {
+        conjunct = merger.merge(conjunct);
+    }
+    for (auto& projection : program->_projections) {
+        projection.expr = merger.merge(projection.expr);
+    }
+    // A node with several uses is worth keeping, unless it is as cheap to
+    // get again as to look up.
+    std::unordered_map<const Expr*, int> uses;
+    for (const auto& conjunct : program->_conjuncts) {
+        count_uses(conjunct.get(), &uses);
+    }
+    for (const auto& projection : program->_projections) {
+        count_uses(projection.expr.get(), &uses);
+    }
+    for (const auto& [expr, num_uses] : uses) {
+        if (num_uses > 1 && expr->kind() != ExprKind::COLUMN_REF && expr->kind() != ExprKind::LITERAL) {
+            program->_shared.insert(expr);
+        }
+    }
+
+    for (const auto& projection : program->_projections) {
+        program->_output_row_desc.push_back(
+                {projection.slot_id, projection.expr->type(), projection.expr->is_nullable()});
+    }
+    std::vector<SlotId> live;
+    for (const auto& projection : program->_projections) {
+        projection.expr->get_slot_ids(&live);
+    }
+    program->_live_slots.resize(program->_conjuncts.size());
+    for (size_t i = program->_conjuncts.size(); i-- > 0;) {
+        std::sort(live.begin(), live.end());
+        live.erase(std::unique(live.begin(), live.end()), live.end());
+        program->_live_slots[i] = live;
+        program->_conjuncts[i]->get_slot_ids(&live);
+    }
+    return program;
+}
+
+std::unique_ptr<ExprContext> ExprProgram::create_context() const {
+    return std::make_unique<ExprContext>(_shared);
+}
+
+// A full column of |slot|'s nullability.
+static ColumnPtr materialize(ColumnPtr column, const SlotDescriptor& slot, size_t num_rows) {
+    column = ColumnHelper::unfold_const_column(slot.type, num_rows, column);
+    if (slot.nullable && !column->is_nullable()) {
+        return NullableColumn::create(std::move(column), NullColumn::create(num_rows, uint8_t{0}));
+    }
+    return column;
+}
+
+StatusOr<ChunkPtr> ExprProgram::execute(ExprContext* ctx, const ChunkPtr& chunk) const {
+    if (_always_false || chunk->is_empty()) {
+        return nullptr;
+    }
+    ctx->reset(chunk.get());
+    ChunkPtr rows = chunk;
+    Filter filter;
+    Buffer<uint32_t> indexes;
+    for (size_t i = 0; i < _conjuncts.size(); ++i) {
+        ASSIGN_OR_RETURN(ColumnPtr cond, ctx->evaluate(_conjuncts[i].get(), rows.get()));
+        const size_t num_rows = rows->num_rows();
+        const uint8_t* values = ColumnHelper::get_data_column(cond.get())->raw_data();
+        if (cond->is_constant()) {
+            if (cond->only_null() || values[0] == 0) {
+                return nullptr;
+            }
+            continue;
+        }
+        filter.resize(num_rows);
+        memcpy(filter.data(), values, num_rows);
+        if (const NullData* nulls = ColumnHelper::get_null_data(cond.get()); nulls != nullptr) {
+            simd::and_not_filter(filter.data(), nulls->data(), num_rows);
+        }
+        size_t num_kept = ColumnHelper::count_nonzero(filter);
+        if (num_kept == 0) {
+            return nullptr;
+        }
+        if (num_kept == num_rows) {
+            continue;
+        }
+        // The kept rows of the columns still needed.
+        indexes.resize(num_rows);
+        simd::filter_to_selection(filter.data(), 0, num_rows, indexes.data());
+        auto kept = std::make_shared<Chunk>();
+        for (SlotId slot_id : _live_slots[i]) {
+            const ColumnPtr& column = rows->get_column_by_slot_id(slot_id);
+            kept->append_column(ColumnHelper::select_rows(column, indexes.data(), num_kept), slot_id);
+        }
+        if (kept->num_columns() == 0) {
+            // Nothing is read anymore, but the chunk still has to count the
+            // rows for the constants.
+            kept->append_column(ColumnHelper::create_const_column<TYPE_BOOLEAN>(0, num_kept));
+        }
+        ctx->select_rows(indexes.data(), num_kept, kept.get());
+        rows = std::move(kept);
+    }
+
+    auto output = std::make_shared<Chunk>();
+    const size_t num_rows = rows->num_rows();
+    for (size_t i = 0; i < _projections.size(); ++i) {
+        ASSIGN_OR_RETURN(ColumnPtr column, ctx->evaluate(_projections[i].expr.get(), rows.get()));
+        output->append_column(materialize(std::move(column), _output_row_desc[i], num_rows), _projections[i].slot_id);
+    }
+    return output;
+}
+
+} // namespace starrocks
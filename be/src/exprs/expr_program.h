@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "exprs/expr.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks {
+
+// |expr| with its constant subexpressions evaluated into literals, and AND,
+// OR and CASE reduced around constant operands (x AND TRUE is x, a WHEN
+// FALSE branch goes away). A constant that fails to evaluate is left for
+// execution to report.
+ExprPtr fold_constants(const ExprPtr& expr);
+
+// The expressions of one operator: conjuncts keeping the rows they are all
+// TRUE for, then projections computing the output columns from those rows.
+// They are compiled together:
+//  * constants are folded (see fold_constants()), and a conjunct folded to
+//    TRUE dropped;
+//  * conjuncts are split at AND and run one after another, each over the
+//    rows the previous ones kept, so projections and later conjuncts are
+//    only computed for rows that are still alive;
+//  * equal subexpressions, within one expression or across conjuncts and
+//    projections, are merged into one node, which the ExprContext computes
+//    once per chunk and narrows along with the rows.
+class ExprProgram {
+public:
+    struct Projection {
+        SlotId slot_id;
+        ExprPtr expr;
+    };
+
+    static StatusOr<std::unique_ptr<ExprProgram>> create(const Exprs& conjuncts,
+                                                         const std::vector<Projection>& projections);
+
+    // The compiled expressions.
+    const Exprs& conjuncts() const { return _conjuncts; }
+    const std::vector<Projection>& projections() const { return _projections; }
+    // Subexpressions evaluated once for several uses.
+    size_t num_shared_exprs() const { return _shared.size(); }
+    // A conjunct is constantly FALSE or NULL: no row ever passes.
+    bool is_always_false() const { return _always_false; }
+
+    // The projections, in order, typed and nullable as their expressions.
+    const RowDescriptor& output_row_desc() const { return _output_row_desc; }
+
+    // One per driver.
+    std::unique_ptr<ExprContext> create_context() const;
+
+    // The projection of the rows of |chunk| passing the conjuncts, nullptr if
+    // none does. Output columns are full columns of the nullability of
+    // output_row_desc(), possibly shared with |chunk|.
+    StatusOr<ChunkPtr> execute(ExprContext* ctx, const ChunkPtr& chunk) const;
+
+private:
+    ExprProgram() = default;
+
+    Exprs _conjuncts;
+    std::vector<Projection> _projections;
+    RowDescriptor _output_row_desc;
+    std::unordered_set<const Expr*> _shared;
+    bool _always_false = false;
+    // The slots read after conjunct i: what the rows it keeps are copied with.
+    std::vector<std::vector<SlotId>> _live_slots;
+};
+
+} // namespace starrocks
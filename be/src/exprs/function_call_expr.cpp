@@ -0,0 +1,73 @@
+#include "exprs/function_call_expr.h"
+
+#include "exprs/cast_expr.h"
+
+namespace starrocks {
+
+static bool is_call_nullable(const FunctionDescriptor* function, const Exprs& args) {
+    if (function->handles_nulls || function->may_return_null) {
+        return function->may_return_null;
+    }
+    for (const auto& arg : args) {
+        if (arg->is_nullable()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FunctionCallExpr::FunctionCallExpr(const FunctionDescriptor* function, Exprs args)
+        : Expr(ExprKind::FUNCTION_CALL, function->return_type, is_call_nullable(function, args), std::move(args)),
+          _function(function) {}
+
+ExprPtr FunctionCallExpr::with_children(Exprs children) const {
+    return std::make_shared<FunctionCallExpr>(_function, std::move(children));
+}
+
+std::string FunctionCallExpr::debug_string() const {
+    std::string res = _function->name + "(";
+    for (size_t i = 0; i < _children.size(); ++i) {
+        if (i > 0) {
+            res.append(", ");
+        }
+        res.append(_children[i]->debug_string());
+    }
+    res.append(")");
+    return res;
+}
+
+StatusOr<ColumnPtr> FunctionCallExpr::_evaluate(ExprContext* ctx, const Chunk* chunk) const {
+    Columns args;
+    args.reserve(_children.size());
+    for (const auto& child : _children) {
+        ASSIGN_OR_RETURN(ColumnPtr arg, ctx->evaluate(child.get(), chunk));
+        args.push_back(std::move(arg));
+    }
+    if (_function->handles_nulls) {
+        return _function->fn(args, chunk->num_rows());
+    }
+    return call_with_default_nulls(_function->fn, args, chunk->num_rows(), _type);
+}
+
+StatusOr<ExprPtr> make_function_call(const std::string& name, Exprs args) {
+    std::vector<LogicalType> arg_types;
+    arg_types.reserve(args.size());
+    for (const auto& arg : args) {
+        arg_types.push_back(arg->type());
+    }
+    const FunctionDescriptor* function = FunctionRegistry::instance().resolve(name, arg_types);
+    if (function == nullptr) {
+        std::string signature = name + "(";
+        for (size_t i = 0; i < arg_types.size(); ++i) {
+            signature.append(i > 0 ? ", " : "").append(logical_type_to_string(arg_types[i]));
+        }
+        return Status::NotFound("no function " + signature + ")");
+    }
+    size_t num_params = function->arg_types.size();
+    for (size_t i = 0; i < args.size(); ++i) {
+        ASSIGN_OR_RETURN(args[i], make_cast(std::move(args[i]), function->arg_types[std::min(i, num_params - 1)]));
+    }
+    return std::make_shared<FunctionCallExpr>(function, std::move(args));
+}
+
+} // namespace starrocks
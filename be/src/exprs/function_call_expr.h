@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+#include "exprs/expr.h"
+#include "exprs/function_registry.h"
+
+namespace starrocks {
+
+// A call of a built-in scalar function. Constant arguments and arguments
+// without NULLs take the specialized paths of call_with_default_nulls()
+// chunk by chunk, whatever the declared nullability.
+class FunctionCallExpr final : public Expr {
+public:
+    // |args| are of the parameter types of |function|.
+    FunctionCallExpr(const FunctionDescriptor* function, Exprs args);
+
+    const FunctionDescriptor& function() const { return *_function; }
+
+    ExprPtr with_children(Exprs children) const override;
+    std::string debug_string() const override;
+
+protected:
+    size_t _node_hash() const override { return std::hash<const void*>()(_function); }
+    bool _node_equals(const Expr& rhs) const override {
+        return _function == static_cast<const FunctionCallExpr&>(rhs)._function;
+    }
+    // Descriptors live in the registry, one per overload, for the process's lifetime.
+    void _append_node_key(Buffer<uint8_t>* dst) const override {
+        put_fixed64(dst, reinterpret_cast<uintptr_t>(_function));
+    }
+    StatusOr<ColumnPtr> _evaluate(ExprContext* ctx, const Chunk* chunk) const override;
+
+private:
+    const FunctionDescriptor* const _function;
+};
+
+// A call of the overload of |name| matching the types of |args|, which are
+// cast to its parameter types where they differ.
+StatusOr<ExprPtr> make_function_call(const std::string& name, Exprs args);
+
+} // namespace starrocks
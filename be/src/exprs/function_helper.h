@@ -0,0 +1,116 @@
+#pragma once
+
+#include "column/column_helper.h"
+#include "exprs/function_registry.h"
+
+namespace starrocks {
+
+// Building blocks of the scalar functions. The arguments of a function hold
+// either every row or, as a ConstColumn, one value for all of them (see
+// ScalarFunction); each combination gets its own loop, so a constant operand
+// is loaded once instead of once per row.
+
+// Values of an argument holding every row.
+template <LogicalType LT>
+class ColumnReader {
+public:
+    using CppType = RunTimeCppType<LT>;
+
+    explicit ColumnReader(const Column* column) {
+        if constexpr (is_binary_type(LT)) {
+            _binary = static_cast<const BinaryColumn*>(column);
+        } else {
+            _data = reinterpret_cast<const CppType*>(column->raw_data());
+        }
+    }
+
+    CppType value(size_t i) const {
+        if constexpr (is_binary_type(LT)) {
+            return _binary->get_slice(i);
+        } else {
+            return _data[i];
+        }
+    }
+
+private:
+    const BinaryColumn* _binary = nullptr;
+    const CppType* _data = nullptr;
+};
+
+// The value of a constant argument.
+template <LogicalType LT>
+class ConstReader {
+public:
+    using CppType = RunTimeCppType<LT>;
+
+    explicit ConstReader(const Column* column)
+            : _value(ColumnReader<LT>(static_cast<const ConstColumn*>(column)->data_column().get()).value(0)) {}
+
+    CppType value(size_t /*i*/) const { return _value; }
+
+private:
+    const CppType _value;
+};
+
+// Calls |fn| with the reader matching |column|.
+template <LogicalType LT, typename Fn>
+auto with_reader(const Column* column, Fn&& fn) {
+    if (column->is_constant()) {
+        return fn(ConstReader<LT>(column));
+    }
+    return fn(ColumnReader<LT>(column));
+}
+
+template <LogicalType LT1, LogicalType LT2, typename Fn>
+auto with_readers(const Column* column1, const Column* column2, Fn&& fn) {
+    return with_reader<LT1>(column1, [&](const auto& reader1) {
+        return with_reader<LT2>(column2, [&](const auto& reader2) { return fn(reader1, reader2); });
+    });
+}
+
+// out[i] = Op::apply(args[0][i]), for a fixed-length result.
+template <LogicalType ArgLT, LogicalType ResultLT, typename Op>
+StatusOr<ColumnPtr> unary_function(const Columns& args, size_t num_rows) {
+    auto result = RunTimeColumnType<ResultLT>::create();
+    result->resize_uninitialized(num_rows);
+    auto* out = result->get_data().data();
+    with_reader<ArgLT>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            out[i] = Op::template apply<RunTimeCppType<ResultLT>>(arg.value(i));
+        }
+    });
+    return result;
+}
+
+// out[i] = Op::apply(args[0][i], args[1][i]), for a fixed-length result.
+template <LogicalType LT1, LogicalType LT2, LogicalType ResultLT, typename Op>
+StatusOr<ColumnPtr> binary_function(const Columns& args, size_t num_rows) {
+    auto result = RunTimeColumnType<ResultLT>::create();
+    result->resize_uninitialized(num_rows);
+    auto* out = result->get_data().data();
+    with_readers<LT1, LT2>(args[0].get(), args[1].get(), [&](const auto& lhs, const auto& rhs) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            out[i] = Op::template apply<RunTimeCppType<ResultLT>>(lhs.value(i), rhs.value(i));
+        }
+    });
+    return result;
+}
+
+// As binary_function(), Op::apply() setting its last argument to 1 for the
+// rows yielding NULL.
+template <LogicalType LT1, LogicalType LT2, LogicalType ResultLT, typename Op>
+StatusOr<ColumnPtr> binary_nullable_function(const Columns& args, size_t num_rows) {
+    auto result = RunTimeColumnType<ResultLT>::create();
+    result->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* out = result->get_data().data();
+    auto* is_null = nulls->get_data().data();
+    with_readers<LT1, LT2>(args[0].get(), args[1].get(), [&](const auto& lhs, const auto& rhs) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            out[i] = Op::template apply<RunTimeCppType<ResultLT>>(lhs.value(i), rhs.value(i), &is_null[i]);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+} // namespace starrocks
@@ -0,0 +1,143 @@
+#include "exprs/function_registry.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "column/column_helper.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+const FunctionRegistry& FunctionRegistry::instance() {
+    static const FunctionRegistry registry = [] {
+        FunctionRegistry r;
+        register_arithmetic_functions(&r);
+        register_comparison_functions(&r);
+        register_string_functions(&r);
+        register_date_functions(&r);
+        register_sketch_functions(&r);
+        register_bitmap_functions(&r);
+        return r;
+    }();
+    return registry;
+}
+
+void FunctionRegistry::add(FunctionDescriptor desc) {
+    std::string name = desc.name;
+    _functions[name].push_back(std::move(desc));
+}
+
+const FunctionDescriptor* FunctionRegistry::resolve(const std::string& name,
+                                                    const std::vector<LogicalType>& arg_types) const {
+    auto it = _functions.find(name);
+    if (it == _functions.end()) {
+        return nullptr;
+    }
+    const FunctionDescriptor* best = nullptr;
+    int best_cost = INT_MAX;
+    for (const auto& desc : it->second) {
+        size_t num_params = desc.arg_types.size();
+        if (desc.is_variadic ? arg_types.size() < num_params : arg_types.size() != num_params) {
+            continue;
+        }
+        int cost = 0;
+        for (size_t i = 0; i < arg_types.size() && cost >= 0; ++i) {
+            int c = implicit_cast_cost(arg_types[i], desc.arg_types[std::min(i, num_params - 1)]);
+            cost = c < 0 ? -1 : cost + c;
+        }
+        if (cost >= 0 && cost < best_cost) {
+            best = &desc;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+static int numeric_rank(LogicalType type) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return 1;
+    case TYPE_TINYINT:
+        return 2;
+    case TYPE_SMALLINT:
+        return 3;
+    case TYPE_INT:
+        return 4;
+    case TYPE_BIGINT:
+        return 5;
+    case TYPE_FLOAT:
+        return 6;
+    case TYPE_DOUBLE:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+int implicit_cast_cost(LogicalType from, LogicalType to) {
+    if (from == to) {
+        return 0;
+    }
+    if (from == TYPE_DATE && to == TYPE_DATETIME) {
+        return 1;
+    }
+    int from_rank = numeric_rank(from);
+    int to_rank = numeric_rank(to);
+    if (from_rank == 0 || to_rank <= from_rank) {
+        return -1;
+    }
+    return to_rank - from_rank;
+}
+
+StatusOr<ColumnPtr> call_with_default_nulls(ScalarFunction fn, const Columns& args, size_t num_rows,
+                                            LogicalType return_type) {
+    for (const auto& arg : args) {
+        if (arg->is_constant() && arg->only_null()) {
+            return ColumnHelper::create_const_null_column(num_rows, return_type);
+        }
+    }
+    // A constant value is computed for one row.
+    bool all_const = ColumnHelper::is_all_const(args);
+    size_t rows = all_const ? 1 : num_rows;
+    Columns data;
+    data.reserve(args.size());
+    NullColumnPtr nulls;
+    for (const auto& arg : args) {
+        if (arg->is_constant()) {
+            ColumnPtr value = static_cast<const ConstColumn*>(arg.get())->data_column();
+            if (value->is_nullable()) {
+                value = static_cast<const NullableColumn*>(value.get())->data_column();
+            }
+            data.push_back(all_const ? std::move(value) : ConstColumn::create(std::move(value), num_rows));
+        } else if (arg->is_nullable()) {
+            const auto* nullable = static_cast<const NullableColumn*>(arg.get());
+            data.push_back(nullable->data_column());
+            if (!nullable->has_null()) {
+                continue;
+            }
+            if (nulls == nullptr) {
+                nulls = std::static_pointer_cast<NullColumn>(nullable->null_column()->clone());
+            } else {
+                simd::or_filter(nulls->get_data().data(), nullable->null_column_data().data(), num_rows);
+            }
+        } else {
+            data.push_back(arg);
+        }
+    }
+    ASSIGN_OR_RETURN(ColumnPtr result, fn(data, rows));
+    if (nulls != nullptr) {
+        if (result->is_nullable()) {
+            auto* nullable = static_cast<NullableColumn*>(result.get());
+            simd::or_filter(nullable->null_column_data().data(), nulls->get_data().data(), num_rows);
+            nullable->set_has_null(true);
+        } else {
+            result = NullableColumn::create(std::move(result), std::move(nulls));
+        }
+    }
+    if (all_const) {
+        return ConstColumn::create(std::move(result), num_rows);
+    }
+    return result;
+}
+
+} // namespace starrocks
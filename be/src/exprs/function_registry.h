@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "column/vectorized_fwd.h"
+#include "common/status.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+// Computes a scalar function for |num_rows| rows, each argument holding
+// either every row or, as a ConstColumn, a single value for all of them.
+// Unless the function handles NULLs itself, the arguments have no NULLs and
+// the function may still yield NULL for some rows (division by zero) by
+// returning a nullable column.
+using ScalarFunction = StatusOr<ColumnPtr> (*)(const Columns& args, size_t num_rows);
+
+struct FunctionDescriptor {
+    std::string name;
+    std::vector<LogicalType> arg_types;
+    LogicalType return_type;
+    ScalarFunction fn;
+    // The last argument repeats any number of times (CONCAT).
+    bool is_variadic = false;
+    // The function gets nullable arguments as they are and decides what NULL
+    // yields (IS NULL); otherwise a NULL argument yields NULL.
+    bool handles_nulls = false;
+    // The function yields NULL for some arguments that are not.
+    bool may_return_null = false;
+};
+
+// The built-in scalar functions, by name and argument types. Calls whose
+// arguments match no overload exactly take the one reachable by the
+// cheapest implicit casts (see implicit_cast_cost()).
+class FunctionRegistry {
+public:
+    static const FunctionRegistry& instance();
+
+    void add(FunctionDescriptor desc);
+
+    // The overload of |name| for arguments of |arg_types|, nullptr if none.
+    const FunctionDescriptor* resolve(const std::string& name, const std::vector<LogicalType>& arg_types) const;
+
+private:
+    std::unordered_map<std::string, std::vector<FunctionDescriptor>> _functions;
+};
+
+// Cost of converting |from| to |to| implicitly, -1 if it is not allowed:
+// numbers widen to wider numbers, and DATE to DATETIME.
+int implicit_cast_cost(LogicalType from, LogicalType to);
+
+// Runs |fn| with the default handling of constant and NULL arguments: when
+// every argument is constant, |fn| computes the value once for a
+// ConstColumn; otherwise it runs on the data columns of the nullable
+// arguments, and the result is NULL where one of them is, the null maps being
+// merged only for the arguments that have NULLs.
+StatusOr<ColumnPtr> call_with_default_nulls(ScalarFunction fn, const Columns& args, size_t num_rows,
+                                            LogicalType return_type);
+
+// The built-in functions, one file each.
+void register_arithmetic_functions(FunctionRegistry* registry);
+void register_comparison_functions(FunctionRegistry* registry);
+void register_string_functions(FunctionRegistry* registry);
+void register_date_functions(FunctionRegistry* registry);
+void register_sketch_functions(FunctionRegistry* registry);
+void register_bitmap_functions(FunctionRegistry* registry);
+
+} // namespace starrocks
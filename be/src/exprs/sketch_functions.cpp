@@ -0,0 +1,98 @@
+#include "exprs/function_helper.h"
+#include "util/hyperloglog.h"
+#include "util/tdigest.h"
+#include "util/theta_sketch.h"
+
+namespace starrocks {
+
+// Functions reading the serialized sketches the sketch aggregates yield (see
+// sketch_aggregate_functions.cpp). A value that is not a sketch of the kind
+// the function reads yields NULL, as the aggregates skip it.
+
+template <typename Sketch>
+static bool parse_sketch(Slice value, Sketch* sketch) {
+    return Sketch::deserialize(&value, sketch);
+}
+
+// HLL_CARDINALITY(sketch) and THETA_ESTIMATE(sketch): the estimated number of
+// distinct values.
+template <typename Sketch>
+static StatusOr<ColumnPtr> estimate_function(const Columns& args, size_t num_rows) {
+    auto result = Int64Column::create();
+    result->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* out = result->get_data().data();
+    auto* is_null = nulls->get_data().data();
+    Sketch sketch;
+    with_reader<TYPE_VARCHAR>(args[0].get(), [&](const auto& arg) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            is_null[i] = !parse_sketch(arg.value(i), &sketch);
+            out[i] = is_null[i] ? 0 : sketch.estimate();
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// THETA_UNION(a, b), THETA_INTERSECT(a, b) and THETA_A_NOT_B(a, b).
+template <ThetaSketch (*kOp)(const ThetaSketch&, const ThetaSketch&)>
+static StatusOr<ColumnPtr> theta_set_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* is_null = nulls->get_data().data();
+    ThetaSketch a;
+    ThetaSketch b;
+    Buffer<uint8_t> buf;
+    with_readers<TYPE_VARCHAR, TYPE_VARCHAR>(args[0].get(), args[1].get(), [&](const auto& lhs, const auto& rhs) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            buf.clear();
+            if (parse_sketch(lhs.value(i), &a) && parse_sketch(rhs.value(i), &b)) {
+                kOp(a, b).serialize(&buf);
+            } else {
+                is_null[i] = 1;
+            }
+            result->append(Slice(buf.data(), buf.size()));
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+// PERCENTILE_APPROX(sketch, q): the value below which a fraction |q| of the
+// values lie; NULL for an empty sketch or |q| outside [0, 1].
+static StatusOr<ColumnPtr> percentile_approx_function(const Columns& args, size_t num_rows) {
+    auto result = DoubleColumn::create();
+    result->resize_uninitialized(num_rows);
+    auto nulls = NullColumn::create(num_rows, uint8_t{0});
+    auto* out = result->get_data().data();
+    auto* is_null = nulls->get_data().data();
+    TDigest digest;
+    with_readers<TYPE_VARCHAR, TYPE_DOUBLE>(args[0].get(), args[1].get(), [&](const auto& sketch, const auto& q) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            double fraction = q.value(i);
+            is_null[i] = !(fraction >= 0 && fraction <= 1) || !parse_sketch(sketch.value(i), &digest) ||
+                         digest.empty();
+            out[i] = is_null[i] ? 0 : digest.quantile(fraction);
+        }
+    });
+    return NullableColumn::create(std::move(result), std::move(nulls));
+}
+
+static void add_nullable(FunctionRegistry* registry, FunctionDescriptor desc) {
+    desc.may_return_null = true;
+    registry->add(std::move(desc));
+}
+
+void register_sketch_functions(FunctionRegistry* registry) {
+    add_nullable(registry, {"hll_cardinality", {TYPE_VARCHAR}, TYPE_BIGINT, &estimate_function<HyperLogLog>});
+    add_nullable(registry, {"theta_estimate", {TYPE_VARCHAR}, TYPE_BIGINT, &estimate_function<ThetaSketch>});
+    add_nullable(registry, {"theta_union", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_VARCHAR,
+                            &theta_set_function<&ThetaSketch::unite>});
+    add_nullable(registry, {"theta_intersect", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_VARCHAR,
+                            &theta_set_function<&ThetaSketch::intersect>});
+    add_nullable(registry, {"theta_a_not_b", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_VARCHAR,
+                            &theta_set_function<&ThetaSketch::a_not_b>});
+    add_nullable(registry,
+                 {"percentile_approx", {TYPE_VARCHAR, TYPE_DOUBLE}, TYPE_DOUBLE, &percentile_approx_function});
+}
+
+} // namespace starrocks
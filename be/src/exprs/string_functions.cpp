@@ -0,0 +1,261 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "exprs/function_helper.h"
+
+namespace starrocks {
+
+// Strings are bytes: lengths and positions count bytes, and UPPER and LOWER
+// only map ASCII letters.
+
+struct LengthOp {
+    template <typename R>
+    static R apply(Slice str) {
+        return static_cast<R>(str.size);
+    }
+};
+
+struct StartsWithOp {
+    template <typename R>
+    static R apply(Slice str, Slice prefix) {
+        return str.size >= prefix.size && Slice(str.data, prefix.size) == prefix;
+    }
+};
+
+struct EndsWithOp {
+    template <typename R>
+    static R apply(Slice str, Slice suffix) {
+        return str.size >= suffix.size && Slice(str.data + str.size - suffix.size, suffix.size) == suffix;
+    }
+};
+
+// Same lengths in and out: the bytes are copied and mapped in place.
+template <bool kUpper>
+static StatusOr<ColumnPtr> change_case(const Columns& args, size_t num_rows) {
+    auto result = std::make_shared<BinaryColumn>(*static_cast<const BinaryColumn*>(args[0].get()));
+    auto& bytes = result->get_bytes();
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        uint8_t c = bytes[i];
+        if (kUpper ? (c >= 'a' && c <= 'z') : (c >= 'A' && c <= 'Z')) {
+            bytes[i] = c ^ 0x20;
+        }
+    }
+    return result;
+}
+
+// SUBSTR(str, pos[, len]): |pos| counts from 1, or from the end when
+// negative; a position outside the string, or a negative length, yields ''.
+static Slice substr(Slice str, int64_t pos, int64_t len) {
+    auto size = static_cast<int64_t>(str.size);
+    if (pos == 0 || pos > size || -pos > size || len <= 0) {
+        return Slice();
+    }
+    int64_t start = pos > 0 ? pos - 1 : size + pos;
+    return Slice(str.data + start, static_cast<size_t>(std::min(len, size - start)));
+}
+
+template <bool kHasLength>
+static StatusOr<ColumnPtr> substr_function(const Columns& args, size_t num_rows) {
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows);
+    with_readers<TYPE_VARCHAR, TYPE_BIGINT>(args[0].get(), args[1].get(), [&](const auto& str, const auto& pos) {
+        if constexpr (kHasLength) {
+            with_reader<TYPE_BIGINT>(args[2].get(), [&](const auto& len) {
+                for (size_t i = 0; i < num_rows; ++i) {
+                    result->append(substr(str.value(i), pos.value(i), len.value(i)));
+                }
+            });
+        } else {
+            for (size_t i = 0; i < num_rows; ++i) {
+                result->append(substr(str.value(i), pos.value(i), INT64_MAX));
+            }
+        }
+    });
+    return result;
+}
+
+static StatusOr<ColumnPtr> concat_function(const Columns& args, size_t num_rows) {
+    std::vector<const BinaryColumn*> columns;
+    std::vector<Slice> values(args.size());
+    size_t bytes = 0;
+    for (size_t j = 0; j < args.size(); ++j) {
+        if (args[j]->is_constant()) {
+            columns.push_back(nullptr);
+            values[j] = ConstReader<TYPE_VARCHAR>(args[j].get()).value(0);
+            bytes += values[j].size * num_rows;
+        } else {
+            columns.push_back(static_cast<const BinaryColumn*>(args[j].get()));
+            bytes += columns[j]->get_bytes().size();
+        }
+    }
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows, bytes);
+    auto& out = result->get_bytes();
+    auto& offsets = result->get_offset();
+    for (size_t i = 0; i < num_rows; ++i) {
+        for (size_t j = 0; j < args.size(); ++j) {
+            Slice value = columns[j] == nullptr ? values[j] : columns[j]->get_slice(i);
+            out.append(reinterpret_cast<const uint8_t*>(value.data), value.size);
+        }
+        offsets.push_back(static_cast<uint32_t>(out.size()));
+    }
+    return result;
+}
+
+template <bool kLeft, bool kRight>
+static StatusOr<ColumnPtr> trim_function(const Columns& args, size_t num_rows) {
+    const auto* str = static_cast<const BinaryColumn*>(args[0].get());
+    auto result = BinaryColumn::create();
+    result->reserve(num_rows, str->get_bytes().size());
+    for (size_t i = 0; i < num_rows; ++i) {
+        Slice value = str->get_slice(i);
+        while (kLeft && value.size > 0 && value.data[0] == ' ') {
+            value.remove_prefix(1);
+        }
+        while (kRight && value.size > 0 && value.data[value.size - 1] == ' ') {
+            --value.size;
+        }
+        result->append(value);
+    }
+    return result;
+}
+
+// A LIKE pattern: '%' matches any run of bytes, '_' any one byte, and '\'
+// makes the next byte match itself. The common shapes, a constant string, a
+// prefix, a suffix or an infix, are matched without the general matcher.
+class LikePattern {
+public:
+    explicit LikePattern(Slice pattern) {
+        for (size_t i = 0; i < pattern.size; ++i) {
+            char c = pattern[i];
+            if (c == '\\' && i + 1 < pattern.size) {
+                _tokens.push_back({LITERAL, pattern[++i]});
+            } else if (c == '%') {
+                // Consecutive '%' match what one does.
+                if (_tokens.empty() || _tokens.back().kind != ANY_RUN) {
+                    _tokens.push_back({ANY_RUN, 0});
+                }
+            } else {
+                _tokens.push_back({c == '_' ? ANY_BYTE : LITERAL, c});
+            }
+        }
+        _classify();
+    }
+
+    bool match(Slice str) const {
+        std::string_view s = str.to_string_view();
+        switch (_shape) {
+        case EXACT:
+            return s == _needle;
+        case PREFIX:
+            return s.substr(0, _needle.size()) == _needle;
+        case SUFFIX:
+            return s.size() >= _needle.size() && s.substr(s.size() - _needle.size()) == _needle;
+        case INFIX:
+            return s.find(_needle) != std::string_view::npos;
+        default:
+            return _match_general(s);
+        }
+    }
+
+private:
+    enum TokenKind { LITERAL, ANY_BYTE, ANY_RUN };
+    enum Shape { EXACT, PREFIX, SUFFIX, INFIX, GENERAL };
+
+    struct Token {
+        TokenKind kind;
+        char c;
+    };
+
+    void _classify() {
+        size_t begin = 0;
+        size_t end = _tokens.size();
+        bool leading = begin < end && _tokens[begin].kind == ANY_RUN;
+        begin += leading;
+        bool trailing = begin < end && _tokens[end - 1].kind == ANY_RUN;
+        end -= trailing;
+        for (size_t i = begin; i < end; ++i) {
+            if (_tokens[i].kind != LITERAL) {
+                _shape = GENERAL;
+                return;
+            }
+            _needle.push_back(_tokens[i].c);
+        }
+        _shape = leading ? (trailing ? INFIX : SUFFIX) : (trailing ? PREFIX : EXACT);
+    }
+
+    // Backtracks to the last '%' only: a later '%' can always take over what
+    // an earlier one would have matched.
+    bool _match_general(std::string_view s) const {
+        size_t si = 0;
+        size_t ti = 0;
+        size_t run = SIZE_MAX;
+        size_t run_start = 0;
+        while (si < s.size()) {
+            if (ti < _tokens.size() && _tokens[ti].kind == ANY_RUN) {
+                run = ti++;
+                run_start = si;
+            } else if (ti < _tokens.size() && (_tokens[ti].kind == ANY_BYTE || _tokens[ti].c == s[si])) {
+                ++si;
+                ++ti;
+            } else if (run != SIZE_MAX) {
+                ti = run + 1;
+                si = ++run_start;
+            } else {
+                return false;
+            }
+        }
+        while (ti < _tokens.size() && _tokens[ti].kind == ANY_RUN) {
+            ++ti;
+        }
+        return ti == _tokens.size();
+    }
+
+    std::vector<Token> _tokens;
+    Shape _shape = GENERAL;
+    std::string _needle;
+};
+
+// A constant pattern, nearly always the case, is compiled once per chunk.
+static StatusOr<ColumnPtr> like_function(const Columns& args, size_t num_rows) {
+    auto result = BooleanColumn::create();
+    result->resize_uninitialized(num_rows);
+    uint8_t* out = result->get_data().data();
+    if (args[1]->is_constant()) {
+        LikePattern pattern(ConstReader<TYPE_VARCHAR>(args[1].get()).value(0));
+        with_reader<TYPE_VARCHAR>(args[0].get(), [&](const auto& str) {
+            for (size_t i = 0; i < num_rows; ++i) {
+                out[i] = pattern.match(str.value(i));
+            }
+        });
+        return result;
+    }
+    with_readers<TYPE_VARCHAR, TYPE_VARCHAR>(args[0].get(), args[1].get(), [&](const auto& str, const auto& pattern) {
+        for (size_t i = 0; i < num_rows; ++i) {
+            out[i] = LikePattern(pattern.value(i)).match(str.value(i));
+        }
+    });
+    return result;
+}
+
+void register_string_functions(FunctionRegistry* registry) {
+    registry->add({"length", {TYPE_VARCHAR}, TYPE_BIGINT, &unary_function<TYPE_VARCHAR, TYPE_BIGINT, LengthOp>});
+    registry->add({"upper", {TYPE_VARCHAR}, TYPE_VARCHAR, &change_case<true>});
+    registry->add({"lower", {TYPE_VARCHAR}, TYPE_VARCHAR, &change_case<false>});
+    registry->add({"substr", {TYPE_VARCHAR, TYPE_BIGINT}, TYPE_VARCHAR, &substr_function<false>});
+    registry->add({"substr", {TYPE_VARCHAR, TYPE_BIGINT, TYPE_BIGINT}, TYPE_VARCHAR, &substr_function<true>});
+    FunctionDescriptor concat{"concat", {TYPE_VARCHAR}, TYPE_VARCHAR, &concat_function};
+    concat.is_variadic = true;
+    registry->add(std::move(concat));
+    registry->add({"trim", {TYPE_VARCHAR}, TYPE_VARCHAR, &trim_function<true, true>});
+    registry->add({"ltrim", {TYPE_VARCHAR}, TYPE_VARCHAR, &trim_function<true, false>});
+    registry->add({"rtrim", {TYPE_VARCHAR}, TYPE_VARCHAR, &trim_function<false, true>});
+    registry->add({"like", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_BOOLEAN, &like_function});
+    registry->add({"starts_with", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_BOOLEAN,
+                   &binary_function<TYPE_VARCHAR, TYPE_VARCHAR, TYPE_BOOLEAN, StartsWithOp>});
+    registry->add({"ends_with", {TYPE_VARCHAR, TYPE_VARCHAR}, TYPE_BOOLEAN,
+                   &binary_function<TYPE_VARCHAR, TYPE_VARCHAR, TYPE_BOOLEAN, EndsWithOp>});
+}
+
+} // namespace starrocks
@@ -0,0 +1,186 @@
+#include "formats/csv_parser.h"
+
+#include <cstring>
+#include <vector>
+
+#include "column/buffer.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+// Delimiter positions are collected this many bytes of text at a time.
+static constexpr size_t kIndexWindow = 64 * 1024;
+// Invalid records are quoted in errors up to this many bytes.
+static constexpr size_t kMaxQuotedRecord = 64;
+
+CsvParser::CsvParser(size_t num_columns, CsvFormatOptions options) : _num_columns(num_columns), _options(options) {}
+
+size_t CsvParser::whole_records_size(const Slice& data) const {
+    if (_options.enclose == 0) {
+        const void* last = memrchr(data.data, _options.row_delimiter, data.size);
+        return last == nullptr ? 0 : static_cast<const char*>(last) - data.data + 1;
+    }
+    // A delimiter within an enclosed field does not end the record. Fields are
+    // followed as parse() does: an enclose char opens one only at the start
+    // of a field, and within it either closes it or, doubled, stands for
+    // itself; anywhere else it is data.
+    const uint8_t chars[] = {static_cast<uint8_t>(_options.row_delimiter),
+                             static_cast<uint8_t>(_options.column_separator),
+                             static_cast<uint8_t>(_options.enclose)};
+    Buffer<uint32_t> positions;
+    positions.resize_uninitialized(kIndexWindow);
+    bool enclosed = false;
+    size_t field_begin = 0;
+    // Positions below this were consumed as the second of a doubled pair.
+    size_t skip_to = 0;
+    size_t end = 0;
+    for (size_t base = 0; base < data.size; base += kIndexWindow) {
+        size_t n = std::min(kIndexWindow, data.size - base);
+        size_t count = simd::index_bytes(reinterpret_cast<const uint8_t*>(data.data + base), n, chars, 3,
+                                         positions.data());
+        for (size_t k = 0; k < count; ++k) {
+            size_t p = base + positions[k];
+            if (p < skip_to) {
+                continue;
+            }
+            char c = data.data[p];
+            if (enclosed) {
+                if (c != _options.enclose) {
+                    continue;
+                }
+                if (p + 1 < data.size && data.data[p + 1] == _options.enclose) {
+                    skip_to = p + 2;
+                } else {
+                    enclosed = false;
+                }
+            } else if (c == _options.enclose) {
+                enclosed = p == field_begin;
+            } else {
+                field_begin = p + 1;
+                if (c == _options.row_delimiter) {
+                    end = p + 1;
+                }
+            }
+        }
+    }
+    return end;
+}
+
+static std::string quote_record(const char* begin, const char* end) {
+    size_t size = std::min<size_t>(end - begin, kMaxQuotedRecord);
+    return "'" + std::string(begin, size) + (begin + size < end ? "...'" : "'");
+}
+
+void CsvParser::parse(const Slice& block, ParsedRecords* records) const {
+    ParsedRecordsBuilder builder(_num_columns);
+    const char* data = block.data;
+    const size_t size = block.size;
+    const char separator = _options.column_separator;
+    const char delimiter = _options.row_delimiter;
+    const char enclose = _options.enclose;
+    const uint8_t chars[] = {static_cast<uint8_t>(separator), static_cast<uint8_t>(delimiter),
+                             static_cast<uint8_t>(enclose)};
+    const size_t num_chars = enclose != 0 ? 3 : 2;
+
+    std::vector<Slice> values(_num_columns);
+    std::vector<uint8_t> nulls(_num_columns);
+    // Enclosed fields with doubled enclose chars, unescaped.
+    std::vector<std::string> unescaped(_num_columns);
+    size_t num_fields = 0;
+    size_t record_begin = 0;
+    size_t field_begin = 0;
+    // Inside an enclosed field.
+    bool enclosed = false;
+    // The current field is enclosed, and where it was closed, if it was.
+    bool was_enclosed = false;
+    size_t enclosed_end = SIZE_MAX;
+    bool has_doubled = false;
+
+    auto end_field = [&](size_t end) {
+        size_t idx = num_fields++;
+        if (idx < _num_columns) {
+            Slice value(data + field_begin, end - field_begin);
+            nulls[idx] = 0;
+            if (was_enclosed) {
+                value = Slice(data + field_begin + 1, std::min(enclosed_end, end) - field_begin - 1);
+                if (has_doubled) {
+                    std::string& str = unescaped[idx];
+                    str.clear();
+                    for (size_t i = 0; i < value.size; ++i) {
+                        str.push_back(value.data[i]);
+                        i += value.data[i] == enclose;
+                    }
+                    value = Slice(str);
+                }
+            } else if (value.size == 2 && value.data[0] == '\\' && value.data[1] == 'N') {
+                nulls[idx] = 1;
+            }
+            values[idx] = value;
+        }
+        was_enclosed = false;
+        enclosed_end = SIZE_MAX;
+        has_doubled = false;
+    };
+    auto end_record = [&](size_t end) {
+        if (delimiter == '\n' && !was_enclosed && end > field_begin && data[end - 1] == '\r') {
+            --end;
+        }
+        if (num_fields > 0 || end > record_begin) {
+            end_field(end);
+            if (num_fields == _num_columns) {
+                builder.add(values.data(), nulls.data());
+            } else {
+                builder.add_invalid("expected " + std::to_string(_num_columns) + " columns but got " +
+                                    std::to_string(num_fields) + ": " +
+                                    quote_record(data + record_begin, data + end));
+            }
+        }
+        num_fields = 0;
+    };
+
+    Buffer<uint32_t> positions;
+    positions.resize_uninitialized(kIndexWindow);
+    // Positions below this were consumed as the second of a doubled pair.
+    size_t skip_to = 0;
+    for (size_t base = 0; base < size; base += kIndexWindow) {
+        size_t n = std::min(kIndexWindow, size - base);
+        size_t count = simd::index_bytes(reinterpret_cast<const uint8_t*>(data + base), n, chars, num_chars,
+                                         positions.data());
+        for (size_t k = 0; k < count; ++k) {
+            size_t p = base + positions[k];
+            if (p < skip_to) {
+                continue;
+            }
+            char c = data[p];
+            if (enclosed) {
+                if (c != enclose) {
+                    continue;
+                }
+                if (p + 1 < size && data[p + 1] == enclose) {
+                    has_doubled = true;
+                    skip_to = p + 2;
+                } else {
+                    enclosed = false;
+                    enclosed_end = p;
+                }
+            } else if (c == enclose) {
+                // Anywhere but at the start of a field it is data.
+                if (p == field_begin) {
+                    enclosed = was_enclosed = true;
+                }
+            } else if (c == separator) {
+                end_field(p);
+                field_begin = p + 1;
+            } else {
+                end_record(p);
+                record_begin = field_begin = p + 1;
+            }
+        }
+    }
+    if (field_begin < size || num_fields > 0) {
+        end_record(size);
+    }
+    builder.finish(records);
+}
+
+} // namespace starrocks
@@ -0,0 +1,352 @@
+#include "formats/json_parser.h"
+
+#include <cstring>
+
+#include "column/buffer.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+// Newline positions are collected this many bytes of text at a time.
+static constexpr size_t kIndexWindow = 64 * 1024;
+// Invalid records are quoted in errors up to this many bytes.
+static constexpr size_t kMaxQuotedRecord = 64;
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static void append_utf8(uint32_t code_point, std::string* out) {
+    if (code_point < 0x80) {
+        out->push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+// Parses one record into the fields of a JsonParser; reused for the records
+// of a block.
+class JsonParser::RecordParser {
+public:
+    explicit RecordParser(const JsonParser* parser)
+            : _parser(parser),
+              _values(parser->_keys.size()),
+              _nulls(parser->_keys.size()),
+              _unescaped(parser->_keys.size()) {}
+
+    const Slice* values() const { return _values.data(); }
+    const uint8_t* nulls() const { return _nulls.data(); }
+
+    // Fills the fields from the object in [begin, end); false with |error|
+    // set if it is not one.
+    bool parse(const char* begin, const char* end, std::string* error) {
+        _record = _pos = begin;
+        _end = end;
+        _nulls.assign(_nulls.size(), 1);
+        _skip_blanks();
+        if (!_consume('{')) {
+            return _fail("expected an object", error);
+        }
+        _skip_blanks();
+        if (!_consume('}')) {
+            while (true) {
+                _skip_blanks();
+                Slice key;
+                if (_pos == _end || *_pos != '"' || !_parse_string(&_key, &key)) {
+                    return _fail("expected a member name", error);
+                }
+                _skip_blanks();
+                if (!_consume(':')) {
+                    return _fail("expected ':'", error);
+                }
+                _skip_blanks();
+                auto it = _parser->_key_index.find(key.to_string_view());
+                size_t idx = it != _parser->_key_index.end() ? it->second : SIZE_MAX;
+                if (!_parse_value(idx)) {
+                    return _fail("invalid value", error);
+                }
+                _skip_blanks();
+                if (_consume('}')) {
+                    break;
+                }
+                if (!_consume(',')) {
+                    return _fail("expected ',' or '}'", error);
+                }
+            }
+        }
+        _skip_blanks();
+        if (_pos != _end) {
+            return _fail("unexpected text after the object", error);
+        }
+        return true;
+    }
+
+private:
+    void _skip_blanks() {
+        while (_pos < _end && is_blank(*_pos)) {
+            ++_pos;
+        }
+    }
+
+    bool _consume(char c) {
+        if (_pos < _end && *_pos == c) {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool _fail(const char* what, std::string* error) const {
+        *error = std::string(what) + " at offset " + std::to_string(_pos - _record);
+        return false;
+    }
+
+    // The string at _pos, after its opening quote: a slice of the text
+    // unless it has escapes, else of |scratch|.
+    bool _parse_string(std::string* scratch, Slice* value) {
+        const char* begin = ++_pos;
+        while (_pos < _end && *_pos != '"' && *_pos != '\\') {
+            ++_pos;
+        }
+        if (_pos == _end) {
+            return false;
+        }
+        if (*_pos == '"') {
+            *value = Slice(begin, _pos++ - begin);
+            return true;
+        }
+        scratch->assign(begin, _pos - begin);
+        while (_pos < _end && *_pos != '"') {
+            if (*_pos != '\\') {
+                scratch->push_back(*_pos++);
+                continue;
+            }
+            if (++_pos == _end) {
+                return false;
+            }
+            char c = *_pos++;
+            switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                scratch->push_back(c);
+                break;
+            case 'b':
+                scratch->push_back('\b');
+                break;
+            case 'f':
+                scratch->push_back('\f');
+                break;
+            case 'n':
+                scratch->push_back('\n');
+                break;
+            case 'r':
+                scratch->push_back('\r');
+                break;
+            case 't':
+                scratch->push_back('\t');
+                break;
+            case 'u': {
+                uint32_t code_point;
+                if (!_parse_hex4(&code_point)) {
+                    return false;
+                }
+                // A high surrogate and the low one following it.
+                if (code_point >= 0xD800 && code_point < 0xDC00) {
+                    uint32_t low;
+                    if (_end - _pos < 2 || _pos[0] != '\\' || _pos[1] != 'u') {
+                        return false;
+                    }
+                    _pos += 2;
+                    if (!_parse_hex4(&low) || low < 0xDC00 || low >= 0xE000) {
+                        return false;
+                    }
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                }
+                append_utf8(code_point, scratch);
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        if (_pos == _end) {
+            return false;
+        }
+        ++_pos;
+        *value = Slice(*scratch);
+        return true;
+    }
+
+    bool _parse_hex4(uint32_t* value) {
+        if (_end - _pos < 4) {
+            return false;
+        }
+        *value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *_pos++;
+            uint32_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                digit = c - 'A' + 10;
+            } else {
+                return false;
+            }
+            *value = *value << 4 | digit;
+        }
+        return true;
+    }
+
+    // Skips an object or array, strings and all.
+    bool _skip_nested() {
+        int depth = 0;
+        while (_pos < _end) {
+            char c = *_pos;
+            if (c == '"') {
+                Slice ignored;
+                if (!_parse_string(&_key, &ignored)) {
+                    return false;
+                }
+                continue;
+            }
+            ++_pos;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool _literal(const char* word) {
+        size_t len = strlen(word);
+        if (static_cast<size_t>(_end - _pos) < len || memcmp(_pos, word, len) != 0) {
+            return false;
+        }
+        _pos += len;
+        return true;
+    }
+
+    // The value at _pos becomes field |idx|, unless that is SIZE_MAX.
+    bool _parse_value(size_t idx) {
+        if (_pos == _end) {
+            return false;
+        }
+        const char* begin = _pos;
+        Slice value;
+        bool is_null = false;
+        char c = *_pos;
+        if (c == '"') {
+            if (!_parse_string(idx != SIZE_MAX ? &_unescaped[idx] : &_key, &value)) {
+                return false;
+            }
+        } else if (c == '{' || c == '[') {
+            if (!_skip_nested()) {
+                return false;
+            }
+            value = Slice(begin, _pos - begin);
+        } else if (c == 'n') {
+            if (!_literal("null")) {
+                return false;
+            }
+            is_null = true;
+        } else if (c == 't' || c == 'f') {
+            if (!_literal(c == 't' ? "true" : "false")) {
+                return false;
+            }
+            value = Slice(begin, _pos - begin);
+        } else {
+            while (_pos < _end && (*_pos == '-' || *_pos == '+' || *_pos == '.' || *_pos == 'e' || *_pos == 'E' ||
+                                   (*_pos >= '0' && *_pos <= '9'))) {
+                ++_pos;
+            }
+            if (_pos == begin) {
+                return false;
+            }
+            value = Slice(begin, _pos - begin);
+        }
+        if (idx != SIZE_MAX) {
+            _values[idx] = value;
+            _nulls[idx] = is_null;
+        }
+        return true;
+    }
+
+    const JsonParser* _parser;
+    const char* _record = nullptr;
+    const char* _pos = nullptr;
+    const char* _end = nullptr;
+    std::vector<Slice> _values;
+    std::vector<uint8_t> _nulls;
+    std::vector<std::string> _unescaped;
+    std::string _key;
+};
+
+JsonParser::JsonParser(std::vector<std::string> keys) : _keys(std::move(keys)) {
+    for (size_t i = 0; i < _keys.size(); ++i) {
+        _key_index.emplace(_keys[i], i);
+    }
+}
+
+size_t JsonParser::whole_records_size(const Slice& data) const {
+    const void* last = memrchr(data.data, '\n', data.size);
+    return last == nullptr ? 0 : static_cast<const char*>(last) - data.data + 1;
+}
+
+void JsonParser::parse(const Slice& block, ParsedRecords* records) const {
+    ParsedRecordsBuilder builder(_keys.size());
+    RecordParser parser(this);
+    std::string error;
+    auto parse_record = [&](const char* begin, const char* end) {
+        const char* p = begin;
+        while (p < end && is_blank(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return;
+        }
+        if (parser.parse(begin, end, &error)) {
+            builder.add(parser.values(), parser.nulls());
+        } else {
+            size_t size = std::min<size_t>(end - begin, kMaxQuotedRecord);
+            builder.add_invalid(error + ": '" + std::string(begin, size) + (begin + size < end ? "...'" : "'"));
+        }
+    };
+
+    const uint8_t newline = '\n';
+    Buffer<uint32_t> positions;
+    positions.resize_uninitialized(kIndexWindow);
+    size_t record_begin = 0;
+    for (size_t base = 0; base < block.size; base += kIndexWindow) {
+        size_t n = std::min(kIndexWindow, block.size - base);
+        size_t count = simd::index_bytes(reinterpret_cast<const uint8_t*>(block.data + base), n, &newline, 1,
+                                         positions.data());
+        for (size_t k = 0; k < count; ++k) {
+            size_t p = base + positions[k];
+            parse_record(block.data + record_begin, block.data + p);
+            record_begin = p + 1;
+        }
+    }
+    if (record_begin < block.size) {
+        parse_record(block.data + record_begin, block.data + block.size);
+    }
+    builder.finish(records);
+}
+
+} // namespace starrocks
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "formats/text_parser.h"
+
+namespace starrocks {
+
+// Parses newline-delimited JSON: one object per line, whose members named
+// |keys[i]| fill field i. Missing members and nulls are NULL, other members
+// are ignored. Strings are unescaped, numbers and true/false are kept as
+// written, and nested objects and arrays are kept as JSON text.
+//
+// A newline never occurs within a JSON text except as whitespace, so blocks
+// are cut at the last one, found with memrchr(), and records are split with
+// simd::index_bytes(); objects are then parsed by a single pass of recursive
+// descent with no intermediate document.
+class JsonParser final : public TextParser {
+public:
+    explicit JsonParser(std::vector<std::string> keys);
+
+    size_t whole_records_size(const Slice& data) const override;
+    void parse(const Slice& block, ParsedRecords* records) const override;
+
+private:
+    class RecordParser;
+
+    const std::vector<std::string> _keys;
+    std::unordered_map<std::string_view, size_t> _key_index;
+};
+
+} // namespace starrocks
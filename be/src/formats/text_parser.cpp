@@ -0,0 +1,45 @@
+#include "formats/text_parser.h"
+
+#include "column/nullable_column.h"
+
+namespace starrocks {
+
+ParsedRecordsBuilder::ParsedRecordsBuilder(size_t num_columns) {
+    for (size_t i = 0; i < num_columns; ++i) {
+        _values.push_back(BinaryColumn::create());
+        _nulls.push_back(NullColumn::create());
+    }
+}
+
+void ParsedRecordsBuilder::add(const Slice* values, const uint8_t* nulls) {
+    for (size_t i = 0; i < _values.size(); ++i) {
+        _values[i]->append(nulls[i] ? Slice() : values[i]);
+        _nulls[i]->append(nulls[i]);
+    }
+    _valid.push_back(1);
+}
+
+void ParsedRecordsBuilder::add_invalid(std::string error) {
+    for (size_t i = 0; i < _values.size(); ++i) {
+        _values[i]->append(Slice());
+        _nulls[i]->append(1);
+    }
+    _valid.push_back(0);
+    if (_num_invalid++ == 0) {
+        _first_error = std::move(error);
+    }
+}
+
+void ParsedRecordsBuilder::finish(ParsedRecords* records) {
+    records->fields.clear();
+    for (size_t i = 0; i < _values.size(); ++i) {
+        auto column = NullableColumn::create(std::move(_values[i]), std::move(_nulls[i]));
+        column->update_has_null();
+        records->fields.push_back(std::move(column));
+    }
+    records->valid = std::move(_valid);
+    records->num_invalid = _num_invalid;
+    records->first_error = std::move(_first_error);
+}
+
+} // namespace starrocks
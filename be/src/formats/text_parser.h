@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "column/binary_column.h"
+#include "column/column.h"
+#include "column/fixed_length_column.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// The records of one block of loaded text, split into their fields.
+struct ParsedRecords {
+    // One nullable VARCHAR column per slot of the load's schema, with a row
+    // per record.
+    Columns fields;
+    // 0 for the records that could not be parsed; their fields are NULL.
+    Filter valid;
+    size_t num_invalid = 0;
+    // What was wrong with the first invalid record.
+    std::string first_error;
+};
+
+// Collects the records of a block as parsers split them.
+class ParsedRecordsBuilder {
+public:
+    explicit ParsedRecordsBuilder(size_t num_columns);
+
+    // A record with fields |values|, NULL where |nulls| is set.
+    void add(const Slice* values, const uint8_t* nulls);
+    void add_invalid(std::string error);
+
+    void finish(ParsedRecords* records);
+
+private:
+    std::vector<BinaryColumn::Ptr> _values;
+    std::vector<NullColumnPtr> _nulls;
+    Filter _valid;
+    size_t _num_invalid = 0;
+    std::string _first_error;
+};
+
+// Splits text records into fields, for loads. A load cuts its input into
+// blocks of whole records with whole_records_size() and parses the blocks on
+// several threads at once, so parse() must be thread-safe.
+class TextParser {
+public:
+    virtual ~TextParser() = default;
+
+    // The size of the longest prefix of |data| made of whole records, each
+    // with its delimiter; 0 if the first record does not end in |data|.
+    virtual size_t whole_records_size(const Slice& data) const = 0;
+
+    // Parses the records of |block|, the last of which may lack its
+    // delimiter. Blank records are skipped.
+    virtual void parse(const Slice& block, ParsedRecords* records) const = 0;
+};
+
+} // namespace starrocks
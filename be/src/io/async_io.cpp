@@ -0,0 +1,79 @@
+#include "io/async_io.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/config.h"
+#include "io/io_uring_engine.h"
+#include "util/cpu_info.h"
+
+namespace starrocks::io {
+
+Status pread_fully(int fd, uint8_t* data, size_t len, int64_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(fd, data + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Status::IOError(std::string("pread failed: ") + std::strerror(errno));
+        }
+        if (n == 0) {
+            return Status::IOError("pread past the end of the file");
+        }
+        done += n;
+    }
+    return Status::OK();
+}
+
+void ReadBatch::finish_one(const Status& st) {
+    if (!st.ok()) {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_status.ok()) {
+            _status = st;
+        }
+    }
+    if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // The last read; the others have all published their status.
+        std::lock_guard<std::mutex> l(_lock);
+        _done(std::move(_status));
+    }
+}
+
+Status ThreadPoolIoEngine::submit(std::vector<ReadRequest> reads, ReadCallback done) {
+    if (reads.empty()) {
+        return Status::InvalidArgument("empty read batch");
+    }
+    auto batch = std::make_shared<ReadBatch>(reads.size(), std::move(done));
+    for (size_t i = 0; i < reads.size(); ++i) {
+        const ReadRequest& read = reads[i];
+        Status st = _pool.submit([read, batch] { batch->finish_one(pread_fully(read.fd, read.data, read.size, read.offset)); });
+        if (!st.ok()) {
+            if (i == 0) {
+                return st;
+            }
+            // Shut down midway: the reads already queued still run.
+            for (; i < reads.size(); ++i) {
+                batch->finish_one(st);
+            }
+            break;
+        }
+    }
+    return Status::OK();
+}
+
+std::unique_ptr<AsyncIoEngine> create_async_io_engine() {
+    if (config::enable_io_uring) {
+        auto engine = IoUringEngine::create(std::max(config::io_uring_queue_depth, 1));
+        if (engine.ok()) {
+            return std::move(engine).value();
+        }
+    }
+    int num_threads = config::async_io_thread_num > 0 ? config::async_io_thread_num : 4 * CpuInfo::num_cores();
+    return std::make_unique<ThreadPoolIoEngine>(num_threads);
+}
+
+} // namespace starrocks::io
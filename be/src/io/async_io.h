@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "util/threadpool.h"
+
+namespace starrocks::io {
+
+// One positional read of |size| bytes into caller-owned memory.
+struct ReadRequest {
+    int fd = -1;
+    int64_t offset = 0;
+    size_t size = 0;
+    uint8_t* data = nullptr;
+};
+
+// Runs once every read of a batch has finished, with the first error if any.
+// It runs on an engine thread, so it must be quick and must not block.
+using ReadCallback = std::function<void(Status)>;
+
+// Asynchronous file reads. A caller submits a batch of reads and is called
+// back when all of them have landed, so one thread can keep many reads in
+// flight instead of blocking in pread() on each in turn.
+class AsyncIoEngine {
+public:
+    virtual ~AsyncIoEngine() = default;
+
+    virtual const char* name() const = 0;
+
+    // Starts |reads|, which must not be empty, and returns without waiting.
+    // Their buffers must stay valid until |done| runs. Fails only once the
+    // engine is shut down, and |done| is not called then.
+    virtual Status submit(std::vector<ReadRequest> reads, ReadCallback done) = 0;
+
+    // Stops accepting reads and waits for those in flight to complete.
+    virtual void shutdown() = 0;
+};
+
+// io_uring when config::enable_io_uring is set and the kernel supports it,
+// otherwise a ThreadPoolIoEngine of config::async_io_thread_num threads.
+std::unique_ptr<AsyncIoEngine> create_async_io_engine();
+
+// Fallback for kernels without io_uring: each read is a blocking pread() on
+// a thread of its own pool.
+class ThreadPoolIoEngine final : public AsyncIoEngine {
+public:
+    explicit ThreadPoolIoEngine(int num_threads) : _pool("async_io", num_threads) {}
+
+    const char* name() const override { return "thread_pool"; }
+    Status submit(std::vector<ReadRequest> reads, ReadCallback done) override;
+    void shutdown() override { _pool.shutdown(); }
+
+private:
+    ThreadPool _pool;
+};
+
+// Completion state of the reads of one submit() call, shared by them.
+class ReadBatch {
+public:
+    ReadBatch(size_t num_reads, ReadCallback done) : _remaining(num_reads), _done(std::move(done)) {}
+
+    DISALLOW_COPY_AND_MOVE(ReadBatch);
+
+    // Records the outcome of one read; the last one runs the callback.
+    void finish_one(const Status& st);
+
+private:
+    std::atomic<size_t> _remaining;
+    std::mutex _lock;
+    Status _status;
+    ReadCallback _done;
+};
+
+// Reads exactly |len| bytes at |offset|; reading past the end of the file
+// is an error.
+Status pread_fully(int fd, uint8_t* data, size_t len, int64_t offset);
+
+} // namespace starrocks::io
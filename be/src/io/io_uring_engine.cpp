@@ -0,0 +1,260 @@
+#include "io/io_uring_engine.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace starrocks::io {
+
+// One SQE reads at most this much; longer reads complete in several parts.
+static constexpr size_t kMaxReadPerEntry = 1U << 30;
+
+static int ring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int ring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int ring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+static Status errno_status(const char* what, int err) {
+    return Status::IOError(std::string(what) + ": " + std::strerror(err));
+}
+
+StatusOr<std::unique_ptr<IoUringEngine>> IoUringEngine::create(uint32_t queue_depth) {
+    std::unique_ptr<IoUringEngine> engine(new IoUringEngine());
+    RETURN_IF_ERROR(engine->_setup(queue_depth));
+    engine->_reaper = std::thread([e = engine.get()] { e->_reap(); });
+    return engine;
+}
+
+Status IoUringEngine::_setup(uint32_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _ring_fd = ring_setup(queue_depth, &params);
+    if (_ring_fd < 0) {
+        return Status::NotSupported(std::string("io_uring_setup failed: ") + std::strerror(errno));
+    }
+
+    // The probe itself is a 5.6 addition, as is IORING_OP_READ.
+    constexpr unsigned kProbeOps = 256;
+    std::vector<uint8_t> probe_buf(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(probe_buf.data());
+    if (ring_register(_ring_fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0 || probe->last_op < IORING_OP_READ ||
+        !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)) {
+        return Status::NotSupported("io_uring does not support IORING_OP_READ");
+    }
+
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+    _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                      IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        _sq_ring = nullptr;
+        return errno_status("failed to map the io_uring submission queue", errno);
+    }
+    if (single_mmap) {
+        _cq_ring = _sq_ring;
+    } else {
+        _cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                          IORING_OFF_CQ_RING);
+        if (_cq_ring == MAP_FAILED) {
+            _cq_ring = nullptr;
+            return errno_status("failed to map the io_uring completion queue", errno);
+        }
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return errno_status("failed to map the io_uring submission entries", errno);
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<uint8_t*>(_sq_ring);
+    _sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    auto* cq = static_cast<uint8_t*>(_cq_ring);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    // The kernel rounds the depth up to a power of two; honour the request.
+    _max_inflight = std::min(queue_depth, params.cq_entries);
+    return Status::OK();
+}
+
+IoUringEngine::~IoUringEngine() {
+    if (_reaper.joinable()) {
+        shutdown();
+    }
+    if (_sqes != nullptr) {
+        ::munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+        ::munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != nullptr) {
+        ::munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_ring_fd >= 0) {
+        ::close(_ring_fd);
+    }
+}
+
+Status IoUringEngine::submit(std::vector<ReadRequest> reads, ReadCallback done) {
+    if (reads.empty()) {
+        return Status::InvalidArgument("empty read batch");
+    }
+    auto batch = std::make_shared<ReadBatch>(reads.size(), std::move(done));
+    std::lock_guard<std::mutex> l(_lock);
+    if (_shutdown) {
+        return Status::Cancelled("io_uring engine is shut down");
+    }
+    for (const ReadRequest& read : reads) {
+        _queued.push_back(new Read{read, batch});
+    }
+    _flush_locked();
+    return Status::OK();
+}
+
+void IoUringEngine::shutdown() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_shutdown) {
+            return;
+        }
+        _shutdown = true;
+        _queued.push_back(nullptr);
+        _flush_locked();
+    }
+    _reaper.join();
+}
+
+void IoUringEngine::_flush_locked() {
+    // Only submitters, serialized by _lock, move the tail; the kernel moves
+    // the head as it consumes entries.
+    unsigned tail = *_sq_tail;
+    unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+    unsigned added = 0;
+    while (!_queued.empty() && tail - head < _sq_entries && _inflight < _max_inflight) {
+        Read* read = _queued.front();
+        _queued.pop_front();
+        unsigned idx = tail & _sq_mask;
+        io_uring_sqe* sqe = &_sqes[idx];
+        memset(sqe, 0, sizeof(*sqe));
+        if (read == nullptr) {
+            sqe->opcode = IORING_OP_NOP;
+        } else {
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = read->request.fd;
+            sqe->off = read->request.offset;
+            sqe->addr = reinterpret_cast<uint64_t>(read->request.data);
+            sqe->len = static_cast<uint32_t>(std::min(read->request.size, kMaxReadPerEntry));
+        }
+        sqe->user_data = reinterpret_cast<uint64_t>(read);
+        _sq_array[idx] = idx;
+        ++tail;
+        ++added;
+        ++_inflight;
+    }
+    if (added == 0) {
+        return;
+    }
+    __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+    // Also submits entries a failed call earlier left in the ring.
+    while (true) {
+        unsigned pending = tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        if (pending == 0) {
+            break;
+        }
+        int ret = ring_enter(_ring_fd, pending, 0, 0);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            // Left in the ring for the next flush.
+            break;
+        }
+        if (ret < 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void IoUringEngine::_reap() {
+    std::vector<io_uring_cqe> completions;
+    std::vector<Read*> resubmit;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            if (_shutdown && _inflight == 0 && _queued.empty()) {
+                return;
+            }
+        }
+        int ret = ring_enter(_ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            std::this_thread::yield();
+        }
+
+        completions.clear();
+        unsigned head = *_cq_head;
+        unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            completions.push_back(_cqes[head & _cq_mask]);
+        }
+        __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        if (completions.empty()) {
+            continue;
+        }
+
+        resubmit.clear();
+        std::vector<std::pair<Read*, Status>> finished;
+        for (const io_uring_cqe& cqe : completions) {
+            auto* read = reinterpret_cast<Read*>(cqe.user_data);
+            if (read == nullptr) {
+                continue;
+            }
+            int res = cqe.res;
+            if (res == -EINTR || res == -EAGAIN) {
+                resubmit.push_back(read);
+            } else if (res < 0) {
+                finished.emplace_back(read, errno_status("io_uring read failed", -res));
+            } else if (res == 0) {
+                finished.emplace_back(read, Status::IOError("io_uring read past the end of the file"));
+            } else if (static_cast<size_t>(res) < read->request.size) {
+                read->request.offset += res;
+                read->request.data += res;
+                read->request.size -= res;
+                resubmit.push_back(read);
+            } else {
+                finished.emplace_back(read, Status::OK());
+            }
+        }
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            _inflight -= completions.size();
+            _queued.insert(_queued.begin(), resubmit.begin(), resubmit.end());
+            _flush_locked();
+        }
+        // Callbacks may submit again, so they run without the lock.
+        for (auto& [read, st] : finished) {
+            read->batch->finish_one(st);
+            delete read;
+        }
+    }
+}
+
+} // namespace starrocks::io
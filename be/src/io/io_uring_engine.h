@@ -0,0 +1,77 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "io/async_io.h"
+
+namespace starrocks::io {
+
+// AsyncIoEngine on one io_uring instance, driven through the raw system
+// calls. Submitters fill the submission queue under a lock and enter the
+// kernel once per batch; a reaper thread waits for completions, resubmits
+// short reads and runs the batch callbacks. At most |queue_depth| reads are
+// in flight, so the completion queue cannot overflow; reads beyond that wait
+// in the engine until completions make room.
+class IoUringEngine final : public AsyncIoEngine {
+public:
+    // Fails with NotSupported on kernels without io_uring or its plain read
+    // operation (before 5.6), and when a sandbox forbids it.
+    static StatusOr<std::unique_ptr<IoUringEngine>> create(uint32_t queue_depth);
+
+    ~IoUringEngine() override;
+
+    DISALLOW_COPY_AND_MOVE(IoUringEngine);
+
+    const char* name() const override { return "io_uring"; }
+    Status submit(std::vector<ReadRequest> reads, ReadCallback done) override;
+    void shutdown() override;
+
+private:
+    struct Read {
+        // Moves past the bytes of partial completions.
+        ReadRequest request;
+        std::shared_ptr<ReadBatch> batch;
+    };
+
+    IoUringEngine() = default;
+
+    Status _setup(uint32_t queue_depth);
+    // Moves queued reads into the submission queue while there is room and
+    // submits them. Requires _lock.
+    void _flush_locked();
+    void _reap();
+
+    int _ring_fd = -1;
+    void* _sq_ring = nullptr;
+    size_t _sq_ring_size = 0;
+    void* _cq_ring = nullptr;
+    size_t _cq_ring_size = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqes_size = 0;
+
+    unsigned* _sq_head = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned _sq_entries = 0;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+    unsigned _cq_mask = 0;
+    unsigned _max_inflight = 0;
+
+    std::mutex _lock;
+    // Reads waiting for room in the ring; nullptr stands for the no-op that
+    // wakes the reaper on shutdown.
+    std::deque<Read*> _queued;
+    unsigned _inflight = 0;
+    bool _shutdown = false;
+    std::thread _reaper;
+};
+
+} // namespace starrocks::io
@@ -0,0 +1,41 @@
+#include "io/object_store.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "io/random_access_file.h"
+
+namespace starrocks::io {
+
+void LocalObjectStore::_request() {
+    _num_requests.fetch_add(1, std::memory_order_relaxed);
+    if (_request_latency_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(_request_latency_us));
+    }
+}
+
+StatusOr<int64_t> LocalObjectStore::object_size(const std::string& key) {
+    _request();
+    struct stat st;
+    if (::stat(_path(key).c_str(), &st) != 0) {
+        if (errno == ENOENT) {
+            return Status::NotFound("object " + key + " does not exist");
+        }
+        return Status::IOError("failed to stat object " + key + ": " + std::strerror(errno));
+    }
+    return static_cast<int64_t>(st.st_size);
+}
+
+Status LocalObjectStore::read_object(const std::string& key, int64_t offset, size_t len, uint8_t* data) {
+    _request();
+    ASSIGN_OR_RETURN(auto file, LocalFile::open(_path(key)));
+    RETURN_IF_ERROR(file->read_at(offset, data, len));
+    _bytes_read.fetch_add(len, std::memory_order_relaxed);
+    return Status::OK();
+}
+
+} // namespace starrocks::io
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "common/status.h"
+
+namespace starrocks::io {
+
+// Immutable objects read by byte range, the way lake tables live on S3-like
+// storage. Every call is a request to the store, and so costs a round trip.
+// Implementations must be thread-safe.
+class ObjectStore {
+public:
+    virtual ~ObjectStore() = default;
+
+    virtual StatusOr<int64_t> object_size(const std::string& key) = 0;
+    // Reads exactly |len| bytes at |offset| of object |key|.
+    virtual Status read_object(const std::string& key, int64_t offset, size_t len, uint8_t* data) = 0;
+};
+
+// Stand-in for a remote store: objects are the files under |root_dir|, and
+// each request first waits |request_latency_us|, as a round trip to object
+// storage would.
+class LocalObjectStore final : public ObjectStore {
+public:
+    explicit LocalObjectStore(std::string root_dir, int64_t request_latency_us = 0)
+            : _root_dir(std::move(root_dir)), _request_latency_us(request_latency_us) {}
+
+    StatusOr<int64_t> object_size(const std::string& key) override;
+    Status read_object(const std::string& key, int64_t offset, size_t len, uint8_t* data) override;
+
+    int64_t num_requests() const { return _num_requests.load(std::memory_order_relaxed); }
+    int64_t bytes_read() const { return _bytes_read.load(std::memory_order_relaxed); }
+
+private:
+    std::string _path(const std::string& key) const { return _root_dir + "/" + key; }
+    void _request();
+
+    const std::string _root_dir;
+    const int64_t _request_latency_us;
+    std::atomic<int64_t> _num_requests{0};
+    std::atomic<int64_t> _bytes_read{0};
+};
+
+} // namespace starrocks::io
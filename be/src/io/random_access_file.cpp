@@ -0,0 +1,48 @@
+#include "io/random_access_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace starrocks::io {
+
+StatusOr<RandomAccessFilePtr> LocalFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return Status::IOError("failed to open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        Status status = Status::IOError("failed to stat " + path + ": " + std::strerror(errno));
+        ::close(fd);
+        return status;
+    }
+    return RandomAccessFilePtr(new LocalFile(path, fd, st.st_size));
+}
+
+LocalFile::~LocalFile() {
+    ::close(_fd);
+}
+
+Status LocalFile::read_at(int64_t offset, uint8_t* data, size_t len) const {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(_fd, data + done, len - done, offset + done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Status::IOError("failed to read " + _path + ": " + std::strerror(errno));
+        }
+        if (n == 0) {
+            return Status::Corruption(_path + " is truncated");
+        }
+        done += n;
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks::io
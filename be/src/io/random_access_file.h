@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/status.h"
+
+namespace starrocks::io {
+
+// Read-only file with positional reads, usable from several threads at once.
+class RandomAccessFile {
+public:
+    virtual ~RandomAccessFile() = default;
+
+    // Path or object key, for messages.
+    virtual const std::string& name() const = 0;
+    virtual int64_t size() const = 0;
+
+    // Reads exactly |len| bytes at |offset|.
+    virtual Status read_at(int64_t offset, uint8_t* data, size_t len) const = 0;
+
+    // Descriptor AsyncIoEngine reads may target directly; -1 for files that
+    // are not local.
+    virtual int fd() const { return -1; }
+};
+
+using RandomAccessFilePtr = std::unique_ptr<RandomAccessFile>;
+
+class LocalFile final : public RandomAccessFile {
+public:
+    static StatusOr<RandomAccessFilePtr> open(const std::string& path);
+
+    ~LocalFile() override;
+
+    const std::string& name() const override { return _path; }
+    int64_t size() const override { return _size; }
+    Status read_at(int64_t offset, uint8_t* data, size_t len) const override;
+    int fd() const override { return _fd; }
+
+private:
+    LocalFile(std::string path, int fd, int64_t size) : _path(std::move(path)), _fd(fd), _size(size) {}
+
+    const std::string _path;
+    const int _fd;
+    const int64_t _size;
+};
+
+} // namespace starrocks::io
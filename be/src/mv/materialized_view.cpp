@@ -0,0 +1,233 @@
+#include "mv/materialized_view.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "storage/segment/segment_iterator.h"
+
+namespace starrocks {
+
+StatusOr<MaterializedViewPtr> MaterializedView::create(std::string name, SpjgQuery definition, std::string dir,
+                                                       SegmentWriterOptions writer_options) {
+    if (!definition.has_aggregation()) {
+        return Status::InvalidArgument("materialized view " + name + " does not aggregate");
+    }
+    if (!definition.outputs.empty()) {
+        return Status::InvalidArgument("materialized view " + name + " has outputs of its own");
+    }
+    ASSIGN_OR_RETURN(auto executor, SpjgExecutor::create(std::move(definition)));
+    const SpjgQuery& query = executor->query();
+    int partition_column = -1;
+    int base_column = query.tables[0].table->partition_column();
+    if (base_column >= 0) {
+        SlotId base_slot = query.tables[0].slot_ids[base_column];
+        for (size_t i = 0; i < query.group_by.size(); ++i) {
+            const Expr& key = *query.group_by[i].expr;
+            if (key.kind() == ExprKind::COLUMN_REF && static_cast<const ColumnRef&>(key).slot_id() == base_slot) {
+                partition_column = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+    return MaterializedViewPtr(new MaterializedView(std::move(name), std::move(executor), std::move(dir),
+                                                    writer_options, partition_column));
+}
+
+std::shared_ptr<const MaterializedView::Version> MaterializedView::_current_version() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _version;
+}
+
+std::vector<TablePartition> MaterializedView::partitions() const {
+    std::shared_ptr<const Version> version = _current_version();
+    std::vector<TablePartition> partitions;
+    for (const auto& [id, partition] : version->partitions) {
+        partitions.push_back(TablePartition{id, partition.version});
+    }
+    return partitions;
+}
+
+int64_t MaterializedView::num_rows() const {
+    std::shared_ptr<const Version> version = _current_version();
+    int64_t num_rows = 0;
+    for (const auto& [id, partition] : version->partitions) {
+        num_rows += partition.segment != nullptr ? partition.segment->num_rows() : 0;
+    }
+    return num_rows;
+}
+
+Status MaterializedView::scan(const std::vector<uint32_t>& columns, const std::vector<SlotId>& slot_ids,
+                              const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const {
+    std::shared_ptr<const Version> version = _current_version();
+    std::vector<SegmentSharedPtr> segments;
+    for (const auto& [id, partition] : version->partitions) {
+        bool selected = partition_ids == nullptr ||
+                        std::find(partition_ids->begin(), partition_ids->end(), id) != partition_ids->end();
+        if (selected && partition.segment != nullptr) {
+            segments.push_back(partition.segment);
+        }
+    }
+    for (const auto& segment : segments) {
+        SegmentReadOptions options;
+        options.column_ids.assign(columns.begin(), columns.end());
+        SegmentIterator iterator(segment, std::move(options));
+        RETURN_IF_ERROR(iterator.init());
+        while (true) {
+            ChunkPtr chunk;
+            Status st = iterator.get_next(&chunk);
+            if (st.is_end_of_file()) {
+                break;
+            }
+            RETURN_IF_ERROR(st);
+            auto rows = std::make_shared<Chunk>();
+            for (size_t i = 0; i < slot_ids.size(); ++i) {
+                rows->append_column(chunk->get_column_by_index(i), slot_ids[i]);
+            }
+            RETURN_IF_ERROR(consumer(rows));
+        }
+    }
+    return Status::OK();
+}
+
+std::vector<std::vector<TablePartition>> MaterializedView::_base_partitions() const {
+    std::vector<std::vector<TablePartition>> base_partitions;
+    for (const auto& table : definition().tables) {
+        std::vector<TablePartition> partitions = table.table->partitions();
+        std::sort(partitions.begin(), partitions.end(),
+                  [](const TablePartition& a, const TablePartition& b) { return a.id < b.id; });
+        base_partitions.push_back(std::move(partitions));
+    }
+    return base_partitions;
+}
+
+static bool same_partitions(const std::vector<TablePartition>& a, const std::vector<TablePartition>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const TablePartition& x, const TablePartition& y) {
+        return x.id == y.id && x.version == y.version;
+    });
+}
+
+MaterializedView::StalePartitions MaterializedView::_stale_partitions(
+        const Version& version, const std::vector<std::vector<TablePartition>>& base_partitions) const {
+    StalePartitions result;
+    bool others_changed = !version.refreshed;
+    for (size_t t = 1; t < base_partitions.size() && !others_changed; ++t) {
+        others_changed = !same_partitions(base_partitions[t], version.base_partitions[t]);
+    }
+    if (_partition_column < 0) {
+        if (others_changed || !same_partitions(base_partitions[0], version.base_partitions[0])) {
+            result.stale.push_back(TablePartition{0, 0});
+            result.full = true;
+        }
+        return result;
+    }
+    result.full = others_changed;
+    for (const auto& base : base_partitions[0]) {
+        auto it = version.partitions.find(base.id);
+        if (others_changed || it == version.partitions.end() || it->second.base_version != base.version) {
+            result.stale.push_back(base);
+        }
+    }
+    for (const auto& [id, partition] : version.partitions) {
+        bool exists = std::any_of(base_partitions[0].begin(), base_partitions[0].end(),
+                                  [id = id](const TablePartition& base) { return base.id == id; });
+        if (!exists) {
+            result.dropped.push_back(id);
+        }
+    }
+    return result;
+}
+
+bool MaterializedView::is_fresh() const {
+    std::shared_ptr<const Version> version = _current_version();
+    StalePartitions work = _stale_partitions(*version, _base_partitions());
+    return work.stale.empty() && work.dropped.empty();
+}
+
+StatusOr<SegmentSharedPtr> MaterializedView::_compute_partition(int64_t partition_id, int64_t* num_rows) {
+    std::vector<int64_t> partition_ids{partition_id};
+    ASSIGN_OR_RETURN(auto chunks, _executor->execute(_partition_column >= 0 ? &partition_ids : nullptr));
+    *num_rows = 0;
+    for (const auto& chunk : chunks) {
+        *num_rows += chunk->num_rows();
+    }
+    if (*num_rows == 0) {
+        return SegmentSharedPtr();
+    }
+    std::string path = _dir + "/" + _name + "_" + std::to_string(_next_file_id++) + ".seg";
+    SegmentWriter writer(path, schema(), _writer_options);
+    RETURN_IF_ERROR(writer.init());
+    for (const auto& chunk : chunks) {
+        RETURN_IF_ERROR(writer.append_chunk(*chunk));
+    }
+    RETURN_IF_ERROR(writer.finalize());
+    auto segment = Segment::open(path);
+    if (!segment.ok()) {
+        ::unlink(path.c_str());
+    }
+    return segment;
+}
+
+Status MaterializedView::refresh(MvRefreshStats* stats) {
+    std::lock_guard<std::mutex> refresh_guard(_refresh_lock);
+    // Before any scan: the rows computed are at least this new.
+    std::vector<std::vector<TablePartition>> base_partitions = _base_partitions();
+    std::shared_ptr<const Version> current = _current_version();
+    StalePartitions work = _stale_partitions(*current, base_partitions);
+    MvRefreshStats local;
+    local.full_refresh = work.full;
+    if (work.stale.empty() && work.dropped.empty()) {
+        if (stats != nullptr) {
+            *stats = local;
+        }
+        return Status::OK();
+    }
+
+    auto next = std::make_shared<Version>(*current);
+    next->refreshed = true;
+    next->base_partitions = std::move(base_partitions);
+    std::vector<std::string> written;
+    std::vector<std::string> obsolete;
+    for (const auto& base : work.stale) {
+        int64_t num_rows = 0;
+        auto segment = _compute_partition(base.id, &num_rows);
+        if (!segment.ok()) {
+            for (const auto& path : written) {
+                ::unlink(path.c_str());
+            }
+            return segment.status();
+        }
+        if (segment.value() != nullptr) {
+            written.push_back(segment.value()->path());
+        }
+        Partition& partition = next->partitions[base.id];
+        if (partition.segment != nullptr) {
+            obsolete.push_back(partition.segment->path());
+        }
+        partition = Partition{base.version, _next_version++, segment.value()};
+        local.partitions_refreshed++;
+        local.rows_written += num_rows;
+    }
+    for (int64_t id : work.dropped) {
+        auto it = next->partitions.find(id);
+        if (it->second.segment != nullptr) {
+            obsolete.push_back(it->second.segment->path());
+        }
+        next->partitions.erase(it);
+        local.partitions_dropped++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _version = std::move(next);
+    }
+    // Scans of the previous version hold the segments open.
+    for (const auto& path : obsolete) {
+        ::unlink(path.c_str());
+    }
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks
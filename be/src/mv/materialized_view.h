@@ -0,0 +1,122 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mv/spjg_query.h"
+#include "storage/segment/segment.h"
+#include "storage/segment/segment_writer.h"
+
+namespace starrocks {
+
+struct MvRefreshStats {
+    int64_t partitions_refreshed = 0;
+    int64_t partitions_dropped = 0;
+    int64_t rows_written = 0;
+    // Every partition was stale: a table other than the first one changed.
+    bool full_refresh = false;
+};
+
+// A materialized view: the result of an aggregating SpjgQuery, stored in a
+// directory as one segment per partition, which queries matching the view's
+// definition read instead of joining and aggregating the base tables again
+// (see rewrite_with_view()).
+//
+// The view is refreshed asynchronously from the queries, incrementally by
+// partition. When the definition groups by the partition column of its
+// first table - typically the fact table, partitioned by day - each
+// partition of the view holds the groups of one partition of that table,
+// and only the partitions whose base partition changed, by version, are
+// recomputed: a load into one day's data recomputes that day alone. A
+// change of any other table, or a view not grouped by the partition column,
+// recomputes everything. Refreshes replace a partition's segment under a new
+// name, so scans running meanwhile keep reading the one they opened.
+//
+// Column i of the view is the ith group-by key, then come the aggregates.
+class MaterializedView final : public TableSource {
+public:
+    // |definition| aggregates and has no outputs of its own. The view is
+    // empty until refreshed.
+    static StatusOr<std::shared_ptr<MaterializedView>> create(std::string name, SpjgQuery definition, std::string dir,
+                                                              SegmentWriterOptions writer_options = {});
+
+    DISALLOW_COPY_AND_MOVE(MaterializedView);
+
+    const SpjgQuery& definition() const { return _executor->query(); }
+
+    const std::string& name() const override { return _name; }
+    const RowDescriptor& schema() const override { return _executor->output_row_desc(); }
+    int partition_column() const override { return _partition_column; }
+    std::vector<TablePartition> partitions() const override;
+    Status scan(const std::vector<uint32_t>& columns, const std::vector<SlotId>& slot_ids,
+                const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const override;
+
+    // Whether every partition holds the current rows of the base tables:
+    // queries are only answered from fresh views.
+    bool is_fresh() const;
+    // Recomputes the stale partitions and drops those whose base partition
+    // is gone. Refreshes of one view run one at a time.
+    Status refresh(MvRefreshStats* stats = nullptr);
+
+    int64_t num_rows() const;
+
+private:
+    struct Partition {
+        // Of the base partition it was computed from.
+        int64_t base_version = 0;
+        // Of the partition, as a TableSource.
+        int64_t version = 0;
+        // nullptr for a partition without rows.
+        SegmentSharedPtr segment;
+    };
+    struct Version {
+        bool refreshed = false;
+        std::map<int64_t, Partition> partitions;
+        // The partitions of each table when last refreshed, by id.
+        std::vector<std::vector<TablePartition>> base_partitions;
+    };
+    struct StalePartitions {
+        // With the base version to compute them from.
+        std::vector<TablePartition> stale;
+        std::vector<int64_t> dropped;
+        bool full = false;
+    };
+
+    MaterializedView(std::string name, std::unique_ptr<SpjgExecutor> executor, std::string dir,
+                     SegmentWriterOptions writer_options, int partition_column)
+            : _name(std::move(name)),
+              _executor(std::move(executor)),
+              _dir(std::move(dir)),
+              _writer_options(writer_options),
+              _partition_column(partition_column),
+              _version(std::make_shared<Version>()) {}
+
+    std::shared_ptr<const Version> _current_version() const;
+    // The partitions of the base tables, in id order.
+    std::vector<std::vector<TablePartition>> _base_partitions() const;
+    StalePartitions _stale_partitions(const Version& version,
+                                      const std::vector<std::vector<TablePartition>>& base_partitions) const;
+    // Computes the view's partition |partition_id|, from that partition of
+    // the first table, or from all of it when the view is unpartitioned.
+    StatusOr<SegmentSharedPtr> _compute_partition(int64_t partition_id, int64_t* num_rows);
+
+    const std::string _name;
+    const std::unique_ptr<SpjgExecutor> _executor;
+    const std::string _dir;
+    const SegmentWriterOptions _writer_options;
+    const int _partition_column;
+
+    mutable std::mutex _lock;
+    std::shared_ptr<const Version> _version;
+
+    std::mutex _refresh_lock;
+    int64_t _next_file_id = 0;
+    int64_t _next_version = 1;
+};
+
+using MaterializedViewPtr = std::shared_ptr<MaterializedView>;
+
+} // namespace starrocks
@@ -0,0 +1,160 @@
+#include "mv/mv_manager.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/config.h"
+#include "mv/mv_rewriter.h"
+
+namespace starrocks {
+
+MaterializedViewManager::~MaterializedViewManager() {
+    stop();
+}
+
+Status MaterializedViewManager::start() {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_stopped) {
+        return Status::OK();
+    }
+    _stopped = false;
+    _pool = std::make_unique<ThreadPool>("mv_refresh", std::max(config::mv_refresh_thread_num, 1));
+    _scheduler = std::thread([this] { _schedule_loop(); });
+    return Status::OK();
+}
+
+void MaterializedViewManager::stop() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _cv.notify_all();
+    _scheduler.join();
+    // Queued refreshes see the manager stopped and return at once.
+    _pool->shutdown();
+}
+
+Status MaterializedViewManager::register_view(MaterializedViewPtr view) {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (const auto& entry : _views) {
+            if (entry.view->name() == view->name()) {
+                return Status::AlreadyExist("materialized view " + view->name() + " exists");
+            }
+        }
+        _views.push_back(ViewEntry{std::move(view), false});
+        _wakeup = true;
+    }
+    _cv.notify_all();
+    return Status::OK();
+}
+
+void MaterializedViewManager::drop_view(const std::string& name) {
+    std::lock_guard<std::mutex> guard(_lock);
+    _views.erase(std::remove_if(_views.begin(), _views.end(),
+                                [&name](const ViewEntry& entry) { return entry.view->name() == name; }),
+                 _views.end());
+}
+
+MaterializedViewPtr MaterializedViewManager::get_view(const std::string& name) const {
+    std::lock_guard<std::mutex> guard(_lock);
+    for (const auto& entry : _views) {
+        if (entry.view->name() == name) {
+            return entry.view;
+        }
+    }
+    return nullptr;
+}
+
+void MaterializedViewManager::schedule() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _wakeup = true;
+    }
+    _cv.notify_all();
+}
+
+void MaterializedViewManager::_schedule_loop() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (true) {
+        _cv.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(config::mv_refresh_check_interval_ms, 1)),
+                     [this] { return _stopped || _wakeup; });
+        if (_stopped) {
+            return;
+        }
+        _wakeup = false;
+        // A view with nothing stale returns from refresh() at once.
+        for (auto& entry : _views) {
+            if (entry.refreshing) {
+                continue;
+            }
+            if (_pool->submit([this, view = entry.view] { _refresh(view); }).ok()) {
+                entry.refreshing = true;
+            }
+        }
+    }
+}
+
+void MaterializedViewManager::_refresh(MaterializedViewPtr view) {
+    bool stopped;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        stopped = _stopped;
+    }
+    if (!stopped) {
+        MvRefreshStats stats;
+        Status st = view->refresh(&stats);
+        if (!st.ok()) {
+            _num_refresh_failures.fetch_add(1, std::memory_order_relaxed);
+        } else if (stats.partitions_refreshed > 0 || stats.partitions_dropped > 0) {
+            _num_refreshes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    for (auto& entry : _views) {
+        if (entry.view == view) {
+            entry.refreshing = false;
+        }
+    }
+}
+
+StatusOr<SpjgQuery> MaterializedViewManager::rewrite(const SpjgQuery& query) const {
+    std::vector<MaterializedViewPtr> views;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (const auto& entry : _views) {
+            views.push_back(entry.view);
+        }
+    }
+    StatusOr<SpjgQuery> best = Status::NotFound("no fresh materialized view answers the query");
+    int64_t best_rows = 0;
+    for (const auto& view : views) {
+        if (!view->is_fresh()) {
+            continue;
+        }
+        int64_t num_rows = view->num_rows();
+        if (best.ok() && num_rows >= best_rows) {
+            continue;
+        }
+        auto rewritten = rewrite_with_view(query, view);
+        if (rewritten.ok()) {
+            best = std::move(rewritten);
+            best_rows = num_rows;
+        }
+    }
+    return best;
+}
+
+StatusOr<std::vector<ChunkPtr>> MaterializedViewManager::execute(const SpjgQuery& query) const {
+    auto rewritten = rewrite(query);
+    if (rewritten.ok()) {
+        _num_rewrites.fetch_add(1, std::memory_order_relaxed);
+    }
+    ASSIGN_OR_RETURN(auto executor, SpjgExecutor::create(rewritten.ok() ? std::move(rewritten).value() : query));
+    return executor->execute();
+}
+
+} // namespace starrocks
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mv/materialized_view.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+// The materialized views of the process. Every config::
+// mv_refresh_check_interval_ms - or when asked to - it refreshes the views
+// whose base tables changed, at most config::mv_refresh_thread_num at a
+// time, and it answers queries from the views that are fresh: the same
+// join-and-aggregate run hundreds of times a minute reads a few rows of a
+// view instead.
+class MaterializedViewManager {
+public:
+    MaterializedViewManager() = default;
+    ~MaterializedViewManager();
+
+    DISALLOW_COPY_AND_MOVE(MaterializedViewManager);
+
+    Status start();
+    // Waits for the running refreshes.
+    void stop();
+
+    Status register_view(MaterializedViewPtr view);
+    void drop_view(const std::string& name);
+    MaterializedViewPtr get_view(const std::string& name) const;
+    // Refreshes the stale views now.
+    void schedule();
+
+    // |query| rewritten to read the fresh view with the fewest rows that
+    // answers it (see rewrite_with_view()); NotFound when none does.
+    StatusOr<SpjgQuery> rewrite(const SpjgQuery& query) const;
+    // The rows of |query|, read from a view when one answers it.
+    StatusOr<std::vector<ChunkPtr>> execute(const SpjgQuery& query) const;
+
+    int64_t num_refreshes() const { return _num_refreshes.load(std::memory_order_relaxed); }
+    int64_t num_refresh_failures() const { return _num_refresh_failures.load(std::memory_order_relaxed); }
+    int64_t num_rewrites() const { return _num_rewrites.load(std::memory_order_relaxed); }
+
+private:
+    struct ViewEntry {
+        MaterializedViewPtr view;
+        bool refreshing = false;
+    };
+
+    void _schedule_loop();
+    void _refresh(MaterializedViewPtr view);
+
+    std::unique_ptr<ThreadPool> _pool;
+    std::thread _scheduler;
+
+    mutable std::mutex _lock;
+    std::condition_variable _cv;
+    bool _stopped = true;
+    bool _wakeup = false;
+    std::vector<ViewEntry> _views;
+
+    std::atomic<int64_t> _num_refreshes{0};
+    std::atomic<int64_t> _num_refresh_failures{0};
+    mutable std::atomic<int64_t> _num_rewrites{0};
+};
+
+} // namespace starrocks
@@ -0,0 +1,475 @@
+#include "mv/mv_rewriter.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "exprs/case_expr.h"
+#include "exprs/cast_expr.h"
+#include "exprs/compound_predicate.h"
+#include "exprs/function_call_expr.h"
+
+namespace starrocks {
+
+// Whole trees, unlike Expr::shallow_equals().
+static bool expr_equals(const Expr& a, const Expr& b) {
+    if (&a == &b) {
+        return true;
+    }
+    if (a.kind() != b.kind() || a.type() != b.type() || a.children().size() != b.children().size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.children().size(); ++i) {
+        if (!expr_equals(*a.child(i), *b.child(i))) {
+            return false;
+        }
+    }
+    return a.with_children(b.children())->shallow_equals(b);
+}
+
+// |expr| with its column refs replaced by their entries in |refs|; nullptr
+// when it reads a slot without one.
+static ExprPtr replace_slots(const ExprPtr& expr, const std::unordered_map<SlotId, ExprPtr>& refs) {
+    if (expr->kind() == ExprKind::COLUMN_REF) {
+        auto it = refs.find(static_cast<const ColumnRef&>(*expr).slot_id());
+        return it != refs.end() ? it->second : nullptr;
+    }
+    Exprs children;
+    bool changed = false;
+    for (const auto& child : expr->children()) {
+        ExprPtr replaced = replace_slots(child, refs);
+        if (replaced == nullptr) {
+            return nullptr;
+        }
+        changed |= replaced != child;
+        children.push_back(std::move(replaced));
+    }
+    return changed ? expr->with_children(std::move(children)) : expr;
+}
+
+// A view key expression and the view column holding its values.
+using ViewKey = std::pair<ExprPtr, ExprPtr>;
+
+// |expr| computed from the view columns of |keys|; nullptr when it reads a
+// column not among them.
+static ExprPtr replace_keys(const ExprPtr& expr, const std::vector<ViewKey>& keys) {
+    for (const auto& [key, column] : keys) {
+        if (expr_equals(*expr, *key)) {
+            return column;
+        }
+    }
+    if (expr->kind() == ExprKind::COLUMN_REF) {
+        return nullptr;
+    }
+    Exprs children;
+    bool changed = false;
+    for (const auto& child : expr->children()) {
+        ExprPtr replaced = replace_keys(child, keys);
+        if (replaced == nullptr) {
+            return nullptr;
+        }
+        changed |= replaced != child;
+        children.push_back(std::move(replaced));
+    }
+    return changed ? expr->with_children(std::move(children)) : expr;
+}
+
+static void split_conjuncts(const ExprPtr& expr, Exprs* conjuncts) {
+    if (expr->kind() == ExprKind::COMPOUND_PREDICATE &&
+        static_cast<const CompoundPredicate&>(*expr).op() == CompoundOp::AND) {
+        for (const auto& child : expr->children()) {
+            split_conjuncts(child, conjuncts);
+        }
+    } else {
+        conjuncts->push_back(expr);
+    }
+}
+
+// A comparison of a column with a constant: column <op> value.
+struct ColumnBound {
+    SlotId slot_id;
+    // eq, lt, le, gt or ge.
+    std::string op;
+    const Literal* value;
+};
+
+static bool parse_bound(const Expr& expr, ColumnBound* bound) {
+    static const std::unordered_map<std::string, std::string> kFlipped = {
+            {"eq", "eq"}, {"lt", "gt"}, {"le", "ge"}, {"gt", "lt"}, {"ge", "le"}};
+    if (expr.kind() != ExprKind::FUNCTION_CALL || expr.children().size() != 2) {
+        return false;
+    }
+    const std::string& name = static_cast<const FunctionCallExpr&>(expr).function().name;
+    auto it = kFlipped.find(name);
+    if (it == kFlipped.end()) {
+        return false;
+    }
+    const Expr* column = expr.child(0).get();
+    const Expr* value = expr.child(1).get();
+    std::string op = name;
+    if (column->kind() == ExprKind::LITERAL && value->kind() == ExprKind::COLUMN_REF) {
+        std::swap(column, value);
+        op = it->second;
+    }
+    if (column->kind() != ExprKind::COLUMN_REF || value->kind() != ExprKind::LITERAL ||
+        static_cast<const Literal*>(value)->is_null()) {
+        return false;
+    }
+    *bound = ColumnBound{static_cast<const ColumnRef*>(column)->slot_id(), op, static_cast<const Literal*>(value)};
+    return true;
+}
+
+// Whether every value within |narrow| is within |wide|.
+static bool bound_implies(const ColumnBound& narrow, const ColumnBound& wide) {
+    if (narrow.slot_id != wide.slot_id || narrow.value->type() != wide.value->type()) {
+        return false;
+    }
+    int cmp = narrow.value->value()->compare_at(0, 0, *wide.value->value(), 1);
+    if (wide.op == "eq") {
+        return narrow.op == "eq" && cmp == 0;
+    }
+    bool lower = wide.op == "gt" || wide.op == "ge";
+    if (narrow.op != "eq" && (narrow.op == "gt" || narrow.op == "ge") != lower) {
+        return false;
+    }
+    bool narrow_inclusive = narrow.op != "gt" && narrow.op != "lt";
+    bool wide_inclusive = wide.op == "ge" || wide.op == "le";
+    if (cmp == 0) {
+        return wide_inclusive || !narrow_inclusive;
+    }
+    return lower ? cmp > 0 : cmp < 0;
+}
+
+// Classes of slots equal by join conditions.
+class SlotClasses {
+public:
+    SlotId find(SlotId slot_id) {
+        auto it = _parents.find(slot_id);
+        if (it == _parents.end() || it->second == slot_id) {
+            return slot_id;
+        }
+        SlotId root = find(it->second);
+        _parents[slot_id] = root;
+        return root;
+    }
+    void merge(SlotId a, SlotId b) {
+        SlotId root_a = find(a);
+        SlotId root_b = find(b);
+        if (root_a != root_b) {
+            _parents[root_a] = root_b;
+        }
+    }
+
+private:
+    std::unordered_map<SlotId, SlotId> _parents;
+};
+
+static SlotId max_slot_id(const SpjgQuery& query) {
+    SlotId max_id = 0;
+    for (const auto& table : query.tables) {
+        for (SlotId slot_id : table.slot_ids) {
+            max_id = std::max(max_id, slot_id);
+        }
+    }
+    for (const auto& projection : query.group_by) {
+        max_id = std::max(max_id, projection.slot_id);
+    }
+    for (const auto& aggregate : query.aggregates) {
+        max_id = std::max(max_id, aggregate.output_slot);
+    }
+    for (const auto& projection : query.outputs) {
+        max_id = std::max(max_id, projection.slot_id);
+    }
+    return max_id;
+}
+
+// The aggregate rolling up the sketches or bitmaps a view stores for |type|.
+static AggFunctionType sketch_roll_up(AggFunctionType type) {
+    switch (type) {
+    case AggFunctionType::BITMAP_AGG:
+        return AggFunctionType::BITMAP_UNION;
+    case AggFunctionType::HLL_SKETCH:
+        return AggFunctionType::HLL_UNION;
+    case AggFunctionType::THETA_SKETCH:
+        return AggFunctionType::THETA_UNION;
+    case AggFunctionType::PERCENTILE_SKETCH:
+        return AggFunctionType::PERCENTILE_UNION;
+    default:
+        return type;
+    }
+}
+
+StatusOr<SpjgQuery> rewrite_with_view(const SpjgQuery& query, const MaterializedViewPtr& view) {
+    const SpjgQuery& def = view->definition();
+    if (!query.has_aggregation()) {
+        return Status::NotFound("the query does not aggregate");
+    }
+    if (query.tables.size() != def.tables.size()) {
+        return Status::NotFound("the view joins other tables");
+    }
+
+    // Each slot of the query's tables as the view definition's slot.
+    std::unordered_map<SlotId, SlotId> view_slot_ids;
+    std::unordered_map<SlotId, ExprPtr> view_refs;
+    for (const auto& table : query.tables) {
+        auto same_table = [&table](const SpjgTable& other) { return other.table == table.table; };
+        auto def_table = std::find_if(def.tables.begin(), def.tables.end(), same_table);
+        if (def_table == def.tables.end() ||
+            std::count_if(def.tables.begin(), def.tables.end(), same_table) != 1 ||
+            std::count_if(query.tables.begin(), query.tables.end(), same_table) != 1) {
+            return Status::NotFound("the view does not read table " + table.table->name() + " once like the query");
+        }
+        const RowDescriptor& schema = table.table->schema();
+        for (size_t c = 0; c < schema.size(); ++c) {
+            SlotId slot_id = def_table->slot_ids[c];
+            view_slot_ids[table.slot_ids[c]] = slot_id;
+            view_refs[table.slot_ids[c]] = make_column_ref(SlotDescriptor{slot_id, schema[c].type, schema[c].nullable});
+        }
+    }
+
+    SlotClasses query_classes;
+    SlotClasses view_classes;
+    for (const auto& join : query.joins) {
+        auto left = view_slot_ids.find(join.left);
+        auto right = view_slot_ids.find(join.right);
+        if (left == view_slot_ids.end() || right == view_slot_ids.end()) {
+            return Status::NotFound("a join condition of the query reads a slot of no table");
+        }
+        query_classes.merge(left->second, right->second);
+    }
+    for (const auto& join : def.joins) {
+        view_classes.merge(join.left, join.right);
+    }
+    for (const auto& join : query.joins) {
+        if (view_classes.find(view_slot_ids[join.left]) != view_classes.find(view_slot_ids[join.right])) {
+            return Status::NotFound("the view joins on other columns");
+        }
+    }
+    for (const auto& join : def.joins) {
+        if (query_classes.find(join.left) != query_classes.find(join.right)) {
+            return Status::NotFound("the view joins on other columns");
+        }
+    }
+
+    Exprs query_conjuncts;
+    for (const auto& predicate : query.predicates) {
+        ExprPtr replaced = replace_slots(predicate, view_refs);
+        if (replaced == nullptr) {
+            return Status::NotFound("a predicate of the query reads a slot of no table");
+        }
+        split_conjuncts(replaced, &query_conjuncts);
+    }
+    Exprs view_conjuncts;
+    for (const auto& predicate : def.predicates) {
+        split_conjuncts(predicate, &view_conjuncts);
+    }
+    std::vector<bool> in_view(query_conjuncts.size(), false);
+    for (const auto& view_conjunct : view_conjuncts) {
+        bool implied = false;
+        for (size_t i = 0; i < query_conjuncts.size() && !implied; ++i) {
+            if (expr_equals(*query_conjuncts[i], *view_conjunct)) {
+                in_view[i] = true;
+                implied = true;
+            }
+        }
+        ColumnBound view_bound;
+        if (!implied && parse_bound(*view_conjunct, &view_bound)) {
+            for (size_t i = 0; i < query_conjuncts.size() && !implied; ++i) {
+                ColumnBound query_bound;
+                implied = parse_bound(*query_conjuncts[i], &query_bound) && bound_implies(query_bound, view_bound);
+                // The same range written differently (0 < x for x > 0).
+                in_view[i] = in_view[i] || (implied && bound_implies(view_bound, query_bound));
+            }
+        }
+        if (!implied) {
+            return Status::NotFound("the query does not imply the view's predicate " + view_conjunct->debug_string());
+        }
+    }
+
+    const RowDescriptor& view_schema = view->schema();
+    SlotId next_slot_id = max_slot_id(query) + 1;
+    std::vector<SlotId> view_column_slots;
+    std::vector<ExprPtr> view_columns;
+    for (const auto& column : view_schema) {
+        view_column_slots.push_back(next_slot_id++);
+        view_columns.push_back(make_column_ref(SlotDescriptor{view_column_slots.back(), column.type, column.nullable}));
+    }
+    std::vector<ViewKey> keys;
+    for (size_t i = 0; i < def.group_by.size(); ++i) {
+        keys.emplace_back(def.group_by[i].expr, view_columns[i]);
+    }
+
+    SpjgQuery rewritten;
+    rewritten.tables.push_back(SpjgTable{view, view_column_slots});
+    for (size_t i = 0; i < query_conjuncts.size(); ++i) {
+        if (in_view[i]) {
+            continue;
+        }
+        ExprPtr residual = replace_keys(query_conjuncts[i], keys);
+        if (residual == nullptr) {
+            return Status::NotFound("the view does not group by what predicate " + query_conjuncts[i]->debug_string() +
+                                    " reads");
+        }
+        rewritten.predicates.push_back(std::move(residual));
+    }
+
+    // The view is read as it is when the query groups by exactly its keys.
+    bool roll_up = query.group_by.size() != def.group_by.size();
+    std::vector<bool> key_used(def.group_by.size(), false);
+    Exprs group_by;
+    for (const auto& projection : query.group_by) {
+        ExprPtr key = replace_slots(projection.expr, view_refs);
+        ExprPtr replaced = key != nullptr ? replace_keys(key, keys) : nullptr;
+        if (replaced == nullptr) {
+            return Status::NotFound("the view does not group by " + projection.expr->debug_string());
+        }
+        auto column = std::find(view_columns.begin(), view_columns.begin() + def.group_by.size(), replaced);
+        size_t idx = column - view_columns.begin();
+        if (idx == def.group_by.size() || key_used[idx]) {
+            roll_up = true;
+        } else {
+            key_used[idx] = true;
+        }
+        group_by.push_back(std::move(replaced));
+    }
+
+    auto find_aggregate = [&def](AggFunctionType type, const ExprPtr& arg) -> int {
+        for (size_t j = 0; j < def.aggregates.size(); ++j) {
+            const SpjgAggregate& aggregate = def.aggregates[j];
+            if (aggregate.type == type && (aggregate.arg == nullptr) == (arg == nullptr) &&
+                (arg == nullptr || expr_equals(*aggregate.arg, *arg))) {
+                return static_cast<int>(j);
+            }
+        }
+        return -1;
+    };
+    auto aggregate_column = [&](int j) { return view_columns[def.group_by.size() + j]; };
+    // |value| aggregated by |type| over the view's groups each query group
+    // takes in; |value| itself when there is no rollup.
+    auto roll_up_value = [&](AggFunctionType type, const ExprPtr& value) -> StatusOr<ExprPtr> {
+        if (!roll_up) {
+            return value;
+        }
+        ASSIGN_OR_RETURN(const AggregateFunction* function, get_aggregate_function(type, value->type(), false));
+        rewritten.aggregates.push_back(SpjgAggregate{type, value, next_slot_id++});
+        return make_column_ref(SlotDescriptor{rewritten.aggregates.back().output_slot, function->result_type(), true});
+    };
+
+    std::unordered_map<SlotId, ExprPtr> outputs;
+    for (const auto& aggregate : query.aggregates) {
+        ExprPtr arg;
+        if (aggregate.arg != nullptr && (arg = replace_slots(aggregate.arg, view_refs)) == nullptr) {
+            return Status::NotFound("an aggregate of the query reads a slot of no table");
+        }
+        ExprPtr value;
+        int j;
+        switch (aggregate.type) {
+        case AggFunctionType::COUNT:
+            if ((j = find_aggregate(AggFunctionType::COUNT, arg)) >= 0) {
+                ASSIGN_OR_RETURN(value, roll_up_value(AggFunctionType::SUM, aggregate_column(j)));
+                // Without GROUP BY there is a row even over no groups, and
+                // their SUM is NULL where COUNT is 0.
+                if (roll_up && query.group_by.empty()) {
+                    ASSIGN_OR_RETURN(ExprPtr is_null, make_function_call("is_null", {value}));
+                    ExprPtr zero = make_literal(TYPE_BIGINT, Datum(int64_t{0}));
+                    ASSIGN_OR_RETURN(value, make_case({is_null}, {zero}, value));
+                }
+            }
+            break;
+        case AggFunctionType::SUM:
+        case AggFunctionType::MIN:
+        case AggFunctionType::MAX:
+            if ((j = find_aggregate(aggregate.type, arg)) >= 0) {
+                ASSIGN_OR_RETURN(value, roll_up_value(aggregate.type, aggregate_column(j)));
+            } else if (aggregate.type != AggFunctionType::SUM && arg != nullptr) {
+                // The extremes of a key are those of the view's groups.
+                if (ExprPtr key = replace_keys(arg, keys); key != nullptr) {
+                    ASSIGN_OR_RETURN(value, roll_up_value(aggregate.type, key));
+                }
+            }
+            break;
+        case AggFunctionType::AVG: {
+            if (!roll_up && (j = find_aggregate(AggFunctionType::AVG, arg)) >= 0) {
+                value = aggregate_column(j);
+                break;
+            }
+            int sum = find_aggregate(AggFunctionType::SUM, arg);
+            int count = find_aggregate(AggFunctionType::COUNT, arg);
+            if (sum >= 0 && count >= 0) {
+                ASSIGN_OR_RETURN(ExprPtr sum_value, roll_up_value(AggFunctionType::SUM, aggregate_column(sum)));
+                ASSIGN_OR_RETURN(ExprPtr count_value, roll_up_value(AggFunctionType::SUM, aggregate_column(count)));
+                ASSIGN_OR_RETURN(value, make_function_call("divide", {sum_value, count_value}));
+            }
+            break;
+        }
+        case AggFunctionType::APPROX_COUNT_DISTINCT:
+            if (!roll_up && (j = find_aggregate(aggregate.type, arg)) >= 0) {
+                value = aggregate_column(j);
+            } else if ((j = find_aggregate(AggFunctionType::HLL_SKETCH, arg)) >= 0) {
+                ASSIGN_OR_RETURN(ExprPtr sketch, roll_up_value(AggFunctionType::HLL_UNION, aggregate_column(j)));
+                ASSIGN_OR_RETURN(value, make_function_call("hll_cardinality", {sketch}));
+            }
+            break;
+        case AggFunctionType::HLL_SKETCH:
+        case AggFunctionType::HLL_UNION:
+        case AggFunctionType::THETA_SKETCH:
+        case AggFunctionType::THETA_UNION:
+        case AggFunctionType::THETA_INTERSECT:
+        case AggFunctionType::PERCENTILE_SKETCH:
+        case AggFunctionType::PERCENTILE_UNION:
+        case AggFunctionType::BITMAP_AGG:
+        case AggFunctionType::BITMAP_UNION:
+        case AggFunctionType::BITMAP_INTERSECT:
+            if ((j = find_aggregate(aggregate.type, arg)) >= 0) {
+                ASSIGN_OR_RETURN(value, roll_up_value(sketch_roll_up(aggregate.type), aggregate_column(j)));
+            }
+            break;
+        case AggFunctionType::BITMAP_UNION_COUNT:
+            if (!roll_up && (j = find_aggregate(aggregate.type, arg)) >= 0) {
+                value = aggregate_column(j);
+            } else if ((j = find_aggregate(AggFunctionType::BITMAP_UNION, arg)) >= 0) {
+                ASSIGN_OR_RETURN(ExprPtr bitmap, roll_up_value(AggFunctionType::BITMAP_UNION, aggregate_column(j)));
+                ASSIGN_OR_RETURN(value, make_function_call("bitmap_count", {bitmap}));
+            }
+            break;
+        }
+        if (value == nullptr) {
+            return Status::NotFound(std::string("the view does not aggregate what ") +
+                                    agg_function_name(aggregate.type) + " of the query needs");
+        }
+        ASSIGN_OR_RETURN(const AggregateFunction* function,
+                         get_aggregate_function(aggregate.type, arg != nullptr ? arg->type() : TYPE_BIGINT, false));
+        if (value->type() != function->result_type()) {
+            ASSIGN_OR_RETURN(value, make_cast(value, function->result_type()));
+        }
+        outputs[aggregate.output_slot] = std::move(value);
+    }
+
+    for (size_t i = 0; i < query.group_by.size(); ++i) {
+        SlotId slot_id = query.group_by[i].slot_id;
+        if (roll_up) {
+            rewritten.group_by.push_back({slot_id, group_by[i]});
+            outputs[slot_id] =
+                    make_column_ref(SlotDescriptor{slot_id, group_by[i]->type(), group_by[i]->is_nullable()});
+        } else {
+            outputs[slot_id] = group_by[i];
+        }
+    }
+    if (query.outputs.empty()) {
+        for (const auto& projection : query.group_by) {
+            rewritten.outputs.push_back({projection.slot_id, outputs[projection.slot_id]});
+        }
+        for (const auto& aggregate : query.aggregates) {
+            rewritten.outputs.push_back({aggregate.output_slot, outputs[aggregate.output_slot]});
+        }
+    }
+    for (const auto& projection : query.outputs) {
+        ExprPtr output = replace_slots(projection.expr, outputs);
+        if (output == nullptr) {
+            return Status::NotFound("an output of the query reads a slot it does not aggregate");
+        }
+        rewritten.outputs.push_back({projection.slot_id, std::move(output)});
+    }
+    return rewritten;
+}
+
+} // namespace starrocks
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mv/materialized_view.h"
+
+namespace starrocks {
+
+// |query| rewritten to read |view| instead of joining and aggregating its
+// tables, with the same output slots and types; NotFound, giving the reason,
+// when the view cannot answer it. The view answers an aggregating query
+// that:
+//  * reads the same tables, each once, joined on the same columns (join
+//    conditions are compared as classes of equal columns);
+//  * implies every predicate of the view, either by having it too or by a
+//    narrower range on the same column (x > 10 implies x >= 5). The query's
+//    other predicates are evaluated over the view, so they may only read
+//    expressions the view groups by;
+//  * groups by expressions of the view's keys: by all of them, and the view
+//    is read as it is, or by fewer - or functions of them, year(day) over a
+//    view grouped by day - and the view's groups are rolled up: COUNT and
+//    SUM add up, MIN and MAX take the least and greatest, AVG divides a
+//    rolled-up SUM by a rolled-up COUNT, and sketches and bitmaps are
+//    united (or intersected, for THETA_INTERSECT and BITMAP_INTERSECT);
+//  * aggregates what the view aggregates, takes MIN or MAX of a key,
+//    counts distinct values approximately where the view keeps their
+//    HLL_SKETCH, or counts the values of bitmaps the view keeps the
+//    BITMAP_UNION of.
+// Whether the view is fresh is up to the caller.
+StatusOr<SpjgQuery> rewrite_with_view(const SpjgQuery& query, const MaterializedViewPtr& view);
+
+} // namespace starrocks
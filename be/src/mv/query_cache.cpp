@@ -0,0 +1,224 @@
+#include "mv/query_cache.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+static ExprPtr renumber_slots(const ExprPtr& expr, const std::unordered_map<SlotId, SlotId>& slots) {
+    if (expr->kind() == ExprKind::COLUMN_REF) {
+        auto it = slots.find(static_cast<const ColumnRef&>(*expr).slot_id());
+        if (it == slots.end()) {
+            return expr;
+        }
+        return make_column_ref(SlotDescriptor{it->second, expr->type(), expr->is_nullable()});
+    }
+    Exprs children;
+    bool changed = false;
+    for (const auto& child : expr->children()) {
+        children.push_back(renumber_slots(child, slots));
+        changed = changed || children.back() != child;
+    }
+    return changed ? expr->with_children(std::move(children)) : expr;
+}
+
+// |expr| in preorder, each node by its shallow key.
+static void put_expr(Buffer<uint8_t>* dst, const Expr& expr) {
+    expr.append_shallow_key(dst);
+    for (const auto& child : expr.children()) {
+        put_expr(dst, *child);
+    }
+}
+
+static std::string normalize_expr(const ExprPtr& expr, const std::unordered_map<SlotId, SlotId>& slots) {
+    Buffer<uint8_t> key;
+    put_expr(&key, *renumber_slots(expr, slots));
+    return {reinterpret_cast<const char*>(key.data()), key.size()};
+}
+
+// What the partial results of |query| depend on, save the rows: the tables
+// and the columns they are read as, the joins, predicates, keys and
+// aggregates, with the slots numbered by the position of their columns.
+// Lists are prefixed with their length and names and expressions with their
+// size, so different queries never share a key.
+static Buffer<uint8_t> normalize_query(const SpjgQuery& query) {
+    std::unordered_map<SlotId, SlotId> slots;
+    Buffer<uint8_t> key;
+    put_varint64(&key, query.tables.size());
+    for (const auto& table : query.tables) {
+        put_length_prefixed_slice(&key, table.table->name());
+        const RowDescriptor& schema = table.table->schema();
+        put_varint64(&key, schema.size());
+        for (size_t c = 0; c < schema.size(); ++c) {
+            put_varint64(&key, schema[c].type);
+            slots.emplace(table.slot_ids[c], static_cast<SlotId>(slots.size()));
+        }
+    }
+    std::vector<std::pair<SlotId, SlotId>> joins;
+    for (const auto& join : query.joins) {
+        SlotId left = slots.at(join.left);
+        SlotId right = slots.at(join.right);
+        joins.emplace_back(std::min(left, right), std::max(left, right));
+    }
+    std::sort(joins.begin(), joins.end());
+    joins.erase(std::unique(joins.begin(), joins.end()), joins.end());
+    put_varint64(&key, joins.size());
+    for (const auto& [left, right] : joins) {
+        put_varint64(&key, left);
+        put_varint64(&key, right);
+    }
+    std::vector<std::string> predicates;
+    for (const auto& predicate : query.predicates) {
+        predicates.push_back(normalize_expr(predicate, slots));
+    }
+    std::sort(predicates.begin(), predicates.end());
+    put_varint64(&key, predicates.size());
+    for (const auto& predicate : predicates) {
+        put_length_prefixed_slice(&key, predicate);
+    }
+    put_varint64(&key, query.group_by.size());
+    for (const auto& projection : query.group_by) {
+        put_length_prefixed_slice(&key, normalize_expr(projection.expr, slots));
+    }
+    put_varint64(&key, query.aggregates.size());
+    for (const auto& aggregate : query.aggregates) {
+        put_varint64(&key, static_cast<uint64_t>(aggregate.type));
+        put_fixed8(&key, aggregate.arg != nullptr);
+        if (aggregate.arg != nullptr) {
+            put_length_prefixed_slice(&key, normalize_expr(aggregate.arg, slots));
+        }
+    }
+    return key;
+}
+
+// The columns of |chunk| in slots desc[i].id; the partials are cached in
+// slots numbered by position, for queries numbering theirs differently.
+static ChunkPtr relabel_chunk(const Chunk& chunk, const RowDescriptor& desc) {
+    auto relabeled = std::make_shared<Chunk>();
+    for (size_t i = 0; i < desc.size(); ++i) {
+        relabeled->append_column(chunk.get_column_by_index(i), desc[i].id);
+    }
+    return relabeled;
+}
+
+QueryCache::QueryCache(int64_t capacity_bytes, MemTracker* mem_tracker)
+        : _capacity_bytes(capacity_bytes), _mem_tracker(mem_tracker) {}
+
+QueryCache::~QueryCache() {
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(_usage_bytes);
+    }
+}
+
+int64_t QueryCache::usage_bytes() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _usage_bytes;
+}
+
+size_t QueryCache::num_entries() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _entries.size();
+}
+
+bool QueryCache::_lookup(const std::string& key, int64_t version, std::vector<ChunkPtr>* partials) {
+    std::lock_guard<std::mutex> guard(_lock);
+    auto it = _entries.find(key);
+    if (it == _entries.end() || it->second->version != version) {
+        _num_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    *partials = it->second->partials;
+    _num_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void QueryCache::_erase(std::list<Entry>::iterator it) {
+    _usage_bytes -= it->bytes;
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(it->bytes);
+    }
+    _entries.erase(it->key);
+    _lru.erase(it);
+}
+
+void QueryCache::_insert(std::string key, int64_t version, std::vector<ChunkPtr> partials, int64_t bytes) {
+    std::lock_guard<std::mutex> guard(_lock);
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        // A concurrent query may have cached a newer version already.
+        if (it->second->version > version) {
+            return;
+        }
+        _erase(it->second);
+    }
+    _lru.push_front(Entry{key, version, std::move(partials), bytes});
+    _entries.emplace(std::move(key), _lru.begin());
+    _usage_bytes += bytes;
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->consume(bytes);
+    }
+    while (_usage_bytes > _capacity_bytes && !_lru.empty()) {
+        _erase(std::prev(_lru.end()));
+    }
+}
+
+StatusOr<std::vector<ChunkPtr>> QueryCache::execute(const SpjgQuery& query, QueryCacheStats* stats) {
+    if (!query.has_aggregation()) {
+        return Status::NotSupported("query without aggregation has no partial results to cache");
+    }
+    ASSIGN_OR_RETURN(auto executor, SpjgExecutor::create(query));
+    // Read before any scan: the rows computed are at least this new.
+    Buffer<uint8_t> prefix = normalize_query(query);
+    for (size_t t = 1; t < query.tables.size(); ++t) {
+        std::vector<TablePartition> partitions = query.tables[t].table->partitions();
+        std::sort(partitions.begin(), partitions.end(),
+                  [](const TablePartition& a, const TablePartition& b) { return a.id < b.id; });
+        put_varint64(&prefix, partitions.size());
+        for (const auto& partition : partitions) {
+            put_fixed64(&prefix, partition.id);
+            put_fixed64(&prefix, partition.version);
+        }
+    }
+    std::vector<TablePartition> partitions = query.tables[0].table->partitions();
+
+    RowDescriptor positional = executor->partial_row_desc();
+    for (size_t i = 0; i < positional.size(); ++i) {
+        positional[i].id = static_cast<SlotId>(i);
+    }
+    QueryCacheStats local;
+    std::vector<ChunkPtr> partials;
+    for (const auto& partition : partitions) {
+        Buffer<uint8_t> key_bytes(prefix);
+        put_fixed64(&key_bytes, partition.id);
+        std::string key(reinterpret_cast<const char*>(key_bytes.data()), key_bytes.size());
+        std::vector<ChunkPtr> cached;
+        if (_lookup(key, partition.version, &cached)) {
+            for (const auto& chunk : cached) {
+                partials.push_back(relabel_chunk(*chunk, executor->partial_row_desc()));
+            }
+            local.partitions_hit++;
+            continue;
+        }
+        std::vector<int64_t> partition_ids{partition.id};
+        ASSIGN_OR_RETURN(auto computed, executor->execute_partial(&partition_ids));
+        local.partitions_computed++;
+        int64_t bytes = 0;
+        for (auto& chunk : computed) {
+            bytes += static_cast<int64_t>(chunk->memory_usage());
+            cached.push_back(relabel_chunk(*chunk, positional));
+            partials.push_back(std::move(chunk));
+        }
+        if (bytes <= config::query_cache_entry_max_bytes) {
+            _insert(std::move(key), partition.version, std::move(cached), bytes);
+        }
+    }
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return executor->merge_partials(partials);
+}
+
+} // namespace starrocks
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mv/spjg_query.h"
+#include "runtime/mem_tracker.h"
+
+namespace starrocks {
+
+struct QueryCacheStats {
+    // Partitions of the first table whose partial results were read from
+    // the cache, and computed.
+    int64_t partitions_hit = 0;
+    int64_t partitions_computed = 0;
+};
+
+// Cache of the partial results of aggregating SpjgQueries: the groups of
+// the rows of one partition of the query's first table, with intermediate
+// aggregate values (see SpjgExecutor::execute_partial()). A query reads the
+// partials of the partitions that have not changed since they were cached,
+// computes those of the others - typically the few that had rows appended
+// since the dashboard last refreshed - and merges them all.
+//
+// Entries are keyed by the normalized query - its slots renumbered, its
+// conjuncts and join conditions in a canonical order, without the
+// expressions it outputs over the groups - the versions of all partitions of
+// the other tables, and the partition; an entry holds the partition version
+// it was computed at and is only read at that version. Partials larger than
+// config::query_cache_entry_max_bytes are used once and not kept. The least
+// recently used entries go first once the cache holds more than its
+// capacity, which is charged to |mem_tracker|, usually the process tracker.
+class QueryCache {
+public:
+    // |mem_tracker| may be null.
+    QueryCache(int64_t capacity_bytes, MemTracker* mem_tracker);
+    ~QueryCache();
+
+    DISALLOW_COPY_AND_MOVE(QueryCache);
+
+    // The rows of |query|, which must aggregate.
+    StatusOr<std::vector<ChunkPtr>> execute(const SpjgQuery& query, QueryCacheStats* stats = nullptr);
+
+    int64_t capacity_bytes() const { return _capacity_bytes; }
+    int64_t usage_bytes() const;
+    size_t num_entries() const;
+    int64_t num_hits() const { return _num_hits.load(std::memory_order_relaxed); }
+    int64_t num_misses() const { return _num_misses.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::string key;
+        int64_t version = 0;
+        std::vector<ChunkPtr> partials;
+        int64_t bytes = 0;
+    };
+
+    // Whether |key| has partials at |version|, copied to |partials|.
+    bool _lookup(const std::string& key, int64_t version, std::vector<ChunkPtr>* partials);
+    void _insert(std::string key, int64_t version, std::vector<ChunkPtr> partials, int64_t bytes);
+    // Under _lock.
+    void _erase(std::list<Entry>::iterator it);
+
+    const int64_t _capacity_bytes;
+    MemTracker* const _mem_tracker;
+
+    mutable std::mutex _lock;
+    // Most recently used first.
+    std::list<Entry> _lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> _entries;
+    int64_t _usage_bytes = 0;
+
+    std::atomic<int64_t> _num_hits{0};
+    std::atomic<int64_t> _num_misses{0};
+};
+
+} // namespace starrocks
@@ -0,0 +1,406 @@
+#include "mv/spjg_query.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "runtime/query_context.h"
+#include "runtime/runtime_state.h"
+
+namespace starrocks {
+
+SpjgJoinTreePtr SpjgJoinTree::leaf(int table) {
+    auto tree = std::make_shared<SpjgJoinTree>();
+    tree->table = table;
+    return tree;
+}
+
+SpjgJoinTreePtr SpjgJoinTree::join(SpjgJoinTreePtr probe, SpjgJoinTreePtr build) {
+    auto tree = std::make_shared<SpjgJoinTree>();
+    tree->probe = std::move(probe);
+    tree->build = std::move(build);
+    return tree;
+}
+
+SpjgJoinTreePtr SpjgJoinTree::left_deep(size_t num_tables) {
+    SpjgJoinTreePtr tree = leaf(0);
+    for (size_t t = 1; t < num_tables; ++t) {
+        tree = join(std::move(tree), leaf(static_cast<int>(t)));
+    }
+    return tree;
+}
+
+std::string SpjgJoinTree::debug_string() const {
+    if (table >= 0) {
+        return "t" + std::to_string(table);
+    }
+    return "(" + probe->debug_string() + " JOIN " + build->debug_string() + ")";
+}
+
+StatusOr<std::unique_ptr<SpjgExecutor>> SpjgExecutor::create(SpjgQuery query, SpjgJoinTreePtr join_tree) {
+    if (join_tree == nullptr) {
+        join_tree = SpjgJoinTree::left_deep(query.tables.size());
+    }
+    std::unique_ptr<SpjgExecutor> executor(new SpjgExecutor(std::move(query), std::move(join_tree)));
+    RETURN_IF_ERROR(executor->_init());
+    return executor;
+}
+
+static void add_slot_ids(const ExprPtr& expr, std::unordered_set<SlotId>* slot_ids) {
+    std::vector<SlotId> ids;
+    expr->get_slot_ids(&ids);
+    slot_ids->insert(ids.begin(), ids.end());
+}
+
+Status SpjgExecutor::_init() {
+    const SpjgQuery& query = _query;
+    size_t num_tables = query.tables.size();
+    if (num_tables == 0) {
+        return Status::InvalidArgument("query over no table");
+    }
+    if (!query.has_aggregation() && query.outputs.empty()) {
+        return Status::InvalidArgument("query without output");
+    }
+    // Table and column of each slot of a table.
+    std::unordered_map<SlotId, std::pair<size_t, size_t>> table_slots;
+    SlotId max_slot_id = 0;
+    for (size_t t = 0; t < num_tables; ++t) {
+        const SpjgTable& table = query.tables[t];
+        if (table.slot_ids.size() != table.table->schema().size()) {
+            return Status::InvalidArgument("slots of table " + table.table->name() + " do not match its columns");
+        }
+        for (size_t c = 0; c < table.slot_ids.size(); ++c) {
+            if (!table_slots.emplace(table.slot_ids[c], std::make_pair(t, c)).second) {
+                return Status::InvalidArgument("slot #" + std::to_string(table.slot_ids[c]) + " used twice");
+            }
+            max_slot_id = std::max(max_slot_id, table.slot_ids[c]);
+        }
+    }
+    for (const auto& projection : query.group_by) {
+        max_slot_id = std::max(max_slot_id, projection.slot_id);
+    }
+    for (const auto& aggregate : query.aggregates) {
+        max_slot_id = std::max(max_slot_id, aggregate.output_slot);
+    }
+    for (const auto& projection : query.outputs) {
+        max_slot_id = std::max(max_slot_id, projection.slot_id);
+    }
+    auto table_of = [&](SlotId slot_id) -> StatusOr<size_t> {
+        auto it = table_slots.find(slot_id);
+        if (it == table_slots.end()) {
+            return Status::InvalidArgument("slot #" + std::to_string(slot_id) + " is of no table");
+        }
+        return it->second.first;
+    };
+
+    std::vector<JoinCondition> conditions;
+    std::unordered_set<SlotId> needed;
+    for (const auto& join : query.joins) {
+        ASSIGN_OR_RETURN(size_t left, table_of(join.left));
+        ASSIGN_OR_RETURN(size_t right, table_of(join.right));
+        if (left == right) {
+            return Status::InvalidArgument("join condition within table " + query.tables[left].table->name());
+        }
+        conditions.push_back(JoinCondition{left, right, join});
+        needed.insert(join.left);
+        needed.insert(join.right);
+    }
+
+    std::vector<Exprs> pushed_down(num_tables);
+    Exprs residual;
+    for (const auto& predicate : query.predicates) {
+        std::unordered_set<SlotId> slot_ids;
+        add_slot_ids(predicate, &slot_ids);
+        std::unordered_set<size_t> tables;
+        for (SlotId slot_id : slot_ids) {
+            ASSIGN_OR_RETURN(size_t t, table_of(slot_id));
+            tables.insert(t);
+        }
+        if (tables.size() == 1) {
+            pushed_down[*tables.begin()].push_back(predicate);
+        } else {
+            residual.push_back(predicate);
+            needed.insert(slot_ids.begin(), slot_ids.end());
+        }
+    }
+    if (query.has_aggregation()) {
+        for (const auto& projection : query.group_by) {
+            add_slot_ids(projection.expr, &needed);
+        }
+        for (const auto& aggregate : query.aggregates) {
+            if (aggregate.arg != nullptr) {
+                add_slot_ids(aggregate.arg, &needed);
+            }
+        }
+    } else {
+        for (const auto& projection : query.outputs) {
+            add_slot_ids(projection.expr, &needed);
+        }
+    }
+
+    for (size_t t = 0; t < num_tables; ++t) {
+        const SpjgTable& table = query.tables[t];
+        const RowDescriptor& schema = table.table->schema();
+        std::unordered_set<SlotId> filtered;
+        for (const auto& predicate : pushed_down[t]) {
+            add_slot_ids(predicate, &filtered);
+        }
+        TableScan scan;
+        std::vector<ExprProgram::Projection> projections;
+        RowDescriptor read_desc;
+        for (size_t c = 0; c < schema.size(); ++c) {
+            SlotId slot_id = table.slot_ids[c];
+            SlotDescriptor slot{slot_id, schema[c].type, schema[c].nullable};
+            if (needed.count(slot_id) > 0) {
+                projections.push_back({slot_id, make_column_ref(slot)});
+            } else if (filtered.count(slot_id) == 0) {
+                continue;
+            }
+            scan.columns.push_back(static_cast<uint32_t>(c));
+            scan.slot_ids.push_back(slot_id);
+            read_desc.push_back(slot);
+        }
+        // Rows are still counted with no column needed: read the first.
+        if (projections.empty() && !schema.empty()) {
+            SlotDescriptor slot{table.slot_ids[0], schema[0].type, schema[0].nullable};
+            projections.push_back({slot.id, make_column_ref(slot)});
+            if (filtered.count(slot.id) == 0) {
+                scan.columns.insert(scan.columns.begin(), 0);
+                scan.slot_ids.insert(scan.slot_ids.begin(), slot.id);
+                read_desc.insert(read_desc.begin(), slot);
+            }
+        }
+        if (pushed_down[t].empty()) {
+            scan.row_desc = std::move(read_desc);
+        } else {
+            ASSIGN_OR_RETURN(scan.program, ExprProgram::create(pushed_down[t], projections));
+            scan.row_desc = scan.program->output_row_desc();
+        }
+        _scans.push_back(std::move(scan));
+    }
+
+    // The root comes last.
+    std::vector<size_t> tree_tables;
+    ASSIGN_OR_RETURN(int root, _add_join_node(*_join_tree, conditions, &tree_tables));
+    std::sort(tree_tables.begin(), tree_tables.end());
+    bool each_once = tree_tables.size() == num_tables;
+    for (size_t t = 0; t < tree_tables.size() && each_once; ++t) {
+        each_once = tree_tables[t] == t;
+    }
+    if (!each_once) {
+        return Status::InvalidArgument("join tree " + _join_tree->debug_string() + " does not read each table once");
+    }
+    const RowDescriptor& joined = _nodes[root].row_desc;
+
+    if (!query.has_aggregation()) {
+        ASSIGN_OR_RETURN(_program, ExprProgram::create(residual, query.outputs));
+        _output_row_desc = _program->output_row_desc();
+        return Status::OK();
+    }
+    std::vector<ExprProgram::Projection> projections = query.group_by;
+    _agg_param.group_by_slots.clear();
+    for (const auto& projection : query.group_by) {
+        _agg_param.group_by_slots.push_back(projection.slot_id);
+    }
+    for (const auto& aggregate : query.aggregates) {
+        AggregateCall call{aggregate.type, -1, aggregate.output_slot};
+        if (aggregate.arg != nullptr) {
+            call.arg_slot = ++max_slot_id;
+            projections.push_back({call.arg_slot, aggregate.arg});
+        }
+        _agg_param.aggregates.push_back(call);
+    }
+    // A chunk without columns has no rows to count.
+    if (projections.empty()) {
+        projections.push_back({++max_slot_id, make_column_ref(joined[0])});
+    }
+    ASSIGN_OR_RETURN(_program, ExprProgram::create(residual, projections));
+    _agg_param.input_row_desc = _program->output_row_desc();
+    ASSIGN_OR_RETURN(_output_row_desc, Aggregator::output_row_desc(_agg_param));
+    _partial_agg_param = _agg_param;
+    _partial_agg_param.output_intermediate = true;
+    ASSIGN_OR_RETURN(_merge_agg_param.input_row_desc, Aggregator::output_row_desc(_partial_agg_param));
+    _merge_agg_param.group_by_slots = _agg_param.group_by_slots;
+    for (const auto& call : _agg_param.aggregates) {
+        // The partial results hold the intermediate values of a call in its
+        // output slot.
+        _merge_agg_param.aggregates.push_back(AggregateCall{call.type, call.output_slot, call.output_slot});
+    }
+    _merge_agg_param.merge_input = true;
+    if (!query.outputs.empty()) {
+        ASSIGN_OR_RETURN(_output_program, ExprProgram::create({}, query.outputs));
+        _output_row_desc = _output_program->output_row_desc();
+    }
+    return Status::OK();
+}
+
+StatusOr<int> SpjgExecutor::_add_join_node(const SpjgJoinTree& tree, const std::vector<JoinCondition>& conditions,
+                                           std::vector<size_t>* tables) {
+    JoinNode node;
+    if (tree.table >= 0) {
+        if (static_cast<size_t>(tree.table) >= _scans.size()) {
+            return Status::InvalidArgument("join tree reads table #" + std::to_string(tree.table) + " of none");
+        }
+        node.table = tree.table;
+        node.row_desc = _scans[tree.table].row_desc;
+        tables->push_back(tree.table);
+        _nodes.push_back(std::move(node));
+        return static_cast<int>(_nodes.size()) - 1;
+    }
+    if (tree.probe == nullptr || tree.build == nullptr) {
+        return Status::InvalidArgument("join tree with a join of one side");
+    }
+    std::vector<size_t> probe_tables;
+    std::vector<size_t> build_tables;
+    ASSIGN_OR_RETURN(node.probe, _add_join_node(*tree.probe, conditions, &probe_tables));
+    ASSIGN_OR_RETURN(node.build, _add_join_node(*tree.build, conditions, &build_tables));
+    auto contains = [](const std::vector<size_t>& set, size_t table) {
+        return std::find(set.begin(), set.end(), table) != set.end();
+    };
+    // The conditions between the two sides; those within one side were
+    // joined on below.
+    std::vector<SlotId> probe_keys;
+    std::vector<SlotId> build_keys;
+    for (const auto& condition : conditions) {
+        if (contains(probe_tables, condition.left_table) && contains(build_tables, condition.right_table)) {
+            probe_keys.push_back(condition.join.left);
+            build_keys.push_back(condition.join.right);
+        } else if (contains(probe_tables, condition.right_table) && contains(build_tables, condition.left_table)) {
+            probe_keys.push_back(condition.join.right);
+            build_keys.push_back(condition.join.left);
+        }
+    }
+    if (build_keys.empty()) {
+        return Status::InvalidArgument("no join condition between the sides of " + tree.debug_string());
+    }
+    const RowDescriptor& probe_desc = _nodes[node.probe].row_desc;
+    const RowDescriptor& build_desc = _nodes[node.build].row_desc;
+    node.param = JoinHashTable::Param{JoinType::INNER_JOIN, build_desc, build_keys, probe_desc, probe_keys};
+    // Checks the key types.
+    JoinHashTable table(node.param);
+    RETURN_IF_ERROR(table.prepare());
+    node.row_desc = probe_desc;
+    node.row_desc.insert(node.row_desc.end(), build_desc.begin(), build_desc.end());
+    tables->insert(tables->end(), probe_tables.begin(), probe_tables.end());
+    tables->insert(tables->end(), build_tables.begin(), build_tables.end());
+    _nodes.push_back(std::move(node));
+    return static_cast<int>(_nodes.size()) - 1;
+}
+
+Status SpjgExecutor::_scan(size_t table_idx, const std::vector<int64_t>* partition_ids,
+                           const ChunkConsumer& consumer) const {
+    const TableScan& scan = _scans[table_idx];
+    std::unique_ptr<ExprContext> ctx = scan.program != nullptr ? scan.program->create_context() : nullptr;
+    return _query.tables[table_idx].table->scan(
+            scan.columns, scan.slot_ids, partition_ids, [&](const ChunkPtr& chunk) -> Status {
+                if (chunk->num_rows() == 0) {
+                    return Status::OK();
+                }
+                if (scan.program == nullptr) {
+                    return consumer(chunk);
+                }
+                ASSIGN_OR_RETURN(ChunkPtr rows, scan.program->execute(ctx.get(), chunk));
+                return rows != nullptr ? consumer(rows) : Status::OK();
+            });
+}
+
+Status SpjgExecutor::_run(int node_idx, const std::vector<int64_t>* partition_ids,
+                          const ChunkConsumer& consumer) const {
+    const JoinNode& node = _nodes[node_idx];
+    if (node.table >= 0) {
+        return _scan(node.table, node.table == 0 ? partition_ids : nullptr, consumer);
+    }
+    JoinHashTable table(node.param);
+    RETURN_IF_ERROR(table.prepare());
+    RETURN_IF_ERROR(
+            _run(node.build, partition_ids, [&](const ChunkPtr& chunk) { return table.append_build_chunk(chunk); }));
+    RETURN_IF_ERROR(table.build());
+    JoinProber prober(&table);
+    return _run(node.probe, partition_ids, [&](const ChunkPtr& chunk) -> Status {
+        RETURN_IF_ERROR(prober.push_probe_chunk(chunk));
+        while (prober.has_remaining()) {
+            ASSIGN_OR_RETURN(ChunkPtr joined, prober.next_output(DEFAULT_CHUNK_SIZE));
+            if (joined != nullptr && joined->num_rows() > 0) {
+                RETURN_IF_ERROR(consumer(joined));
+            }
+        }
+        return Status::OK();
+    });
+}
+
+Status SpjgExecutor::_run_query(const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const {
+    std::unique_ptr<ExprContext> ctx = _program->create_context();
+    return _run(static_cast<int>(_nodes.size()) - 1, partition_ids, [&](const ChunkPtr& chunk) -> Status {
+        ASSIGN_OR_RETURN(ChunkPtr rows, _program->execute(ctx.get(), chunk));
+        return rows != nullptr ? consumer(rows) : Status::OK();
+    });
+}
+
+StatusOr<std::vector<ChunkPtr>> SpjgExecutor::_aggregate(const Aggregator::Param& param,
+                                                         const std::function<Status(Aggregator*)>& feed,
+                                                         bool finalize) const {
+    // Groups live in the query's arena.
+    QueryContext query_ctx("spjg");
+    RuntimeState state(&query_ctx, nullptr, nullptr);
+    Aggregator aggregator(param);
+    RETURN_IF_ERROR(aggregator.prepare(&state, nullptr));
+    RETURN_IF_ERROR(feed(&aggregator));
+    const ExprProgram* output_program = finalize ? _output_program.get() : nullptr;
+    std::unique_ptr<ExprContext> output_ctx = output_program != nullptr ? output_program->create_context() : nullptr;
+    std::vector<ChunkPtr> output;
+    while (ChunkPtr chunk = aggregator.next_output(DEFAULT_CHUNK_SIZE)) {
+        if (output_program != nullptr) {
+            ASSIGN_OR_RETURN(chunk, output_program->execute(output_ctx.get(), chunk));
+        }
+        if (chunk != nullptr && chunk->num_rows() > 0) {
+            output.push_back(std::move(chunk));
+        }
+    }
+    return output;
+}
+
+StatusOr<std::vector<ChunkPtr>> SpjgExecutor::execute(const std::vector<int64_t>* partition_ids) const {
+    if (!_query.has_aggregation()) {
+        std::vector<ChunkPtr> output;
+        RETURN_IF_ERROR(_run_query(partition_ids, [&](const ChunkPtr& rows) {
+            output.push_back(rows);
+            return Status::OK();
+        }));
+        return output;
+    }
+    return _aggregate(
+            _agg_param,
+            [&](Aggregator* aggregator) {
+                return _run_query(partition_ids, [&](const ChunkPtr& rows) { return aggregator->append_chunk(*rows); });
+            },
+            true);
+}
+
+StatusOr<std::vector<ChunkPtr>> SpjgExecutor::execute_partial(const std::vector<int64_t>* partition_ids) const {
+    if (!_query.has_aggregation()) {
+        return Status::NotSupported("query without aggregation has no partial results");
+    }
+    return _aggregate(
+            _partial_agg_param,
+            [&](Aggregator* aggregator) {
+                return _run_query(partition_ids, [&](const ChunkPtr& rows) { return aggregator->append_chunk(*rows); });
+            },
+            false);
+}
+
+StatusOr<std::vector<ChunkPtr>> SpjgExecutor::merge_partials(const std::vector<ChunkPtr>& partials) const {
+    if (!_query.has_aggregation()) {
+        return Status::NotSupported("query without aggregation has no partial results");
+    }
+    return _aggregate(
+            _merge_agg_param,
+            [&](Aggregator* aggregator) {
+                for (const auto& partial : partials) {
+                    RETURN_IF_ERROR(aggregator->append_chunk(*partial));
+                }
+                return Status::OK();
+            },
+            true);
+}
+
+} // namespace starrocks
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exec/aggregator.h"
+#include "exec/join_hash_map.h"
+#include "exprs/expr_program.h"
+#include "mv/table_source.h"
+
+namespace starrocks {
+
+struct SpjgTable {
+    TableSourcePtr table;
+    // The slot of each column of the table.
+    std::vector<SlotId> slot_ids;
+};
+
+// An inner equi-join condition: left = right.
+struct SpjgJoin {
+    SlotId left;
+    SlotId right;
+};
+
+struct SpjgAggregate {
+    AggFunctionType type = AggFunctionType::COUNT;
+    // nullptr for COUNT(*).
+    ExprPtr arg;
+    SlotId output_slot = -1;
+};
+
+// A select-project-join-group-by query: the rows of the inner join of
+// |tables| on |joins| that pass |predicates|, grouped by |group_by| and
+// aggregated by |aggregates| - the shape of the join-and-aggregate queries
+// materialized views are defined by and answer. Slot ids are distinct across
+// the query.
+struct SpjgQuery {
+    std::vector<SpjgTable> tables;
+    std::vector<SpjgJoin> joins;
+    // Conjuncts over the slots of the tables.
+    Exprs predicates;
+    std::vector<ExprProgram::Projection> group_by;
+    std::vector<SpjgAggregate> aggregates;
+    // The output, over the group-by and aggregate slots - or the slots of the
+    // tables when there is neither. Empty for the group-by slots, then the
+    // aggregate slots.
+    std::vector<ExprProgram::Projection> outputs;
+
+    bool has_aggregation() const { return !group_by.empty() || !aggregates.empty(); }
+};
+
+struct SpjgJoinTree;
+using SpjgJoinTreePtr = std::shared_ptr<const SpjgJoinTree>;
+
+// The order the tables of an SpjgQuery are joined in. A leaf reads a table;
+// a join builds a hash table of the rows of |build| and probes it with the
+// rows of |probe|, on all the join conditions between the tables of the two
+// sides - there must be at least one.
+struct SpjgJoinTree {
+    // The index of the table read by a leaf; -1 for a join.
+    int table = -1;
+    SpjgJoinTreePtr probe;
+    SpjgJoinTreePtr build;
+
+    static SpjgJoinTreePtr leaf(int table);
+    static SpjgJoinTreePtr join(SpjgJoinTreePtr probe, SpjgJoinTreePtr build);
+    // The first table probing hash tables of the others in turn; each table
+    // must be joined with one before it.
+    static SpjgJoinTreePtr left_deep(size_t num_tables);
+
+    std::string debug_string() const;
+};
+
+// Runs an SpjgQuery, in one thread, joining its tables in the order of a
+// join tree: the build side of a join is run to completion before its probe
+// side, and the rows of the probe side are pushed through the join as they
+// come. Predicates over the columns of one table are evaluated while it is
+// scanned, the others after the joins.
+class SpjgExecutor {
+public:
+    // |join_tree| reads each table of |query| once; the left-deep tree when
+    // nullptr.
+    static StatusOr<std::unique_ptr<SpjgExecutor>> create(SpjgQuery query, SpjgJoinTreePtr join_tree = nullptr);
+
+    DISALLOW_COPY_AND_MOVE(SpjgExecutor);
+
+    const SpjgQuery& query() const { return _query; }
+    const SpjgJoinTreePtr& join_tree() const { return _join_tree; }
+    const RowDescriptor& output_row_desc() const { return _output_row_desc; }
+
+    // The rows of the query over |partition_ids| of the first table, or all
+    // of it when nullptr.
+    StatusOr<std::vector<ChunkPtr>> execute(const std::vector<int64_t>* partition_ids = nullptr) const;
+
+    // Two-phase execution of an aggregating query: the groups of the rows
+    // over |partition_ids| of the first table, with intermediate aggregate
+    // values (see Aggregator) in the layout of partial_row_desc(); and the
+    // rows of the query from the partial results of disjoint sets of
+    // partitions, all of them between them.
+    StatusOr<std::vector<ChunkPtr>> execute_partial(const std::vector<int64_t>* partition_ids) const;
+    StatusOr<std::vector<ChunkPtr>> merge_partials(const std::vector<ChunkPtr>& partials) const;
+    const RowDescriptor& partial_row_desc() const { return _merge_agg_param.input_row_desc; }
+
+private:
+    struct TableScan {
+        std::vector<uint32_t> columns;
+        std::vector<SlotId> slot_ids;
+        // Filters the rows and drops the columns read only for that; nullptr
+        // without predicates.
+        std::unique_ptr<ExprProgram> program;
+        RowDescriptor row_desc;
+    };
+
+    // A node of the join tree: a leaf reads |table|, a join probes the hash
+    // table of node |build| with the rows of node |probe|.
+    struct JoinNode {
+        int table = -1;
+        int probe = -1;
+        int build = -1;
+        JoinHashTable::Param param;
+        RowDescriptor row_desc;
+    };
+
+    SpjgExecutor(SpjgQuery query, SpjgJoinTreePtr join_tree)
+            : _query(std::move(query)), _join_tree(std::move(join_tree)) {}
+
+    Status _init();
+    struct JoinCondition {
+        size_t left_table;
+        size_t right_table;
+        SpjgJoin join;
+    };
+
+    // Appends the nodes of |tree|, after those of its sides, and returns the
+    // index of its own; |tables| gets the tables it reads.
+    StatusOr<int> _add_join_node(const SpjgJoinTree& tree, const std::vector<JoinCondition>& conditions,
+                                 std::vector<size_t>* tables);
+    Status _scan(size_t table_idx, const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const;
+    Status _run(int node, const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const;
+    // The joined rows passing all predicates, through |_program|.
+    Status _run_query(const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const;
+    // The groups of the rows |feed| appends; with |finalize|, through the
+    // output program.
+    StatusOr<std::vector<ChunkPtr>> _aggregate(const Aggregator::Param& param,
+                                               const std::function<Status(Aggregator*)>& feed, bool finalize) const;
+
+    const SpjgQuery _query;
+    const SpjgJoinTreePtr _join_tree;
+    std::vector<TableScan> _scans;
+    std::vector<JoinNode> _nodes;
+    // Predicates over several tables, and the group-by keys and aggregate
+    // arguments; or the output.
+    std::unique_ptr<ExprProgram> _program;
+    Aggregator::Param _agg_param;
+    Aggregator::Param _partial_agg_param;
+    Aggregator::Param _merge_agg_param;
+    std::unique_ptr<ExprProgram> _output_program;
+    RowDescriptor _output_row_desc;
+};
+
+} // namespace starrocks
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks {
+
+struct TablePartition {
+    int64_t id = 0;
+    // Changes whenever the rows of the partition do.
+    int64_t version = 0;
+};
+
+using ChunkConsumer = std::function<Status(const ChunkPtr& chunk)>;
+
+// A table as the queries materialized views answer see it: the base tables
+// a view is defined over, and the view itself. Its rows are split into
+// partitions, each the rows of a disjoint set of values of the partition
+// column, and versioned, so that a view can tell which of its partitions a
+// change made stale.
+class TableSource {
+public:
+    virtual ~TableSource() = default;
+
+    virtual const std::string& name() const = 0;
+    // The columns, in order; the slot ids are unused.
+    virtual const RowDescriptor& schema() const = 0;
+    // Position of the partition column; -1 for an unpartitioned table, which
+    // has one partition.
+    virtual int partition_column() const = 0;
+    // Read before scanning: a scan returns rows at least as new.
+    virtual std::vector<TablePartition> partitions() const = 0;
+
+    // Hands the rows of |partition_ids|, or of every partition when nullptr,
+    // to |consumer| in chunks whose slot slot_ids[i] holds column
+    // columns[i].
+    virtual Status scan(const std::vector<uint32_t>& columns, const std::vector<SlotId>& slot_ids,
+                        const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const = 0;
+};
+
+using TableSourcePtr = std::shared_ptr<TableSource>;
+
+} // namespace starrocks
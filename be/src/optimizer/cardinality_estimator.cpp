@@ -0,0 +1,338 @@
+#include "optimizer/cardinality_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+#include "exprs/compound_predicate.h"
+#include "exprs/function_call_expr.h"
+
+namespace starrocks {
+
+// Rows assumed of a table without statistics.
+static constexpr double kDefaultTableRows = 1000;
+// Fractions of the rows assumed to pass a predicate the statistics say
+// nothing about: an equality, and anything else.
+static constexpr double kDefaultEqualSelectivity = 0.1;
+static constexpr double kDefaultSelectivity = 0.25;
+
+double estimate_selectivity(const Expr& predicate,
+                            const std::function<const ColumnStatistics*(SlotId)>& column_stats) {
+    if (predicate.kind() == ExprKind::LITERAL) {
+        return is_literal_true(predicate) ? 1 : 0;
+    }
+    if (predicate.kind() == ExprKind::COMPOUND_PREDICATE) {
+        const auto& compound = static_cast<const CompoundPredicate&>(predicate);
+        double left = estimate_selectivity(*compound.child(0), column_stats);
+        switch (compound.op()) {
+        case CompoundOp::AND:
+            return left * estimate_selectivity(*compound.child(1), column_stats);
+        case CompoundOp::OR: {
+            double right = estimate_selectivity(*compound.child(1), column_stats);
+            return left + right - left * right;
+        }
+        case CompoundOp::NOT:
+            return 1 - left;
+        }
+    }
+    if (predicate.kind() != ExprKind::FUNCTION_CALL) {
+        return kDefaultSelectivity;
+    }
+    const std::string& name = static_cast<const FunctionCallExpr&>(predicate).function().name;
+    const Expr* column = predicate.children().empty() ? nullptr : predicate.child(0).get();
+    const ColumnStatistics* stats = nullptr;
+    if (column != nullptr && column->kind() == ExprKind::COLUMN_REF) {
+        stats = column_stats(static_cast<const ColumnRef*>(column)->slot_id());
+    }
+    if (name == "is_null" || name == "is_not_null") {
+        if (stats == nullptr) {
+            return kDefaultSelectivity;
+        }
+        return name == "is_null" ? stats->null_fraction : 1 - stats->null_fraction;
+    }
+    static const std::unordered_map<std::string, std::string> kFlipped = {
+            {"eq", "eq"}, {"ne", "ne"}, {"lt", "gt"}, {"le", "ge"}, {"gt", "lt"}, {"ge", "le"}};
+    auto it = kFlipped.find(name);
+    if (it == kFlipped.end() || predicate.children().size() != 2) {
+        return kDefaultSelectivity;
+    }
+    const Expr* value = predicate.child(1).get();
+    std::string op = name;
+    if (column->kind() == ExprKind::LITERAL && value->kind() == ExprKind::COLUMN_REF) {
+        std::swap(column, value);
+        op = it->second;
+        stats = column_stats(static_cast<const ColumnRef*>(column)->slot_id());
+    }
+    double fallback = op == "eq" ? kDefaultEqualSelectivity : op == "ne" ? 1 - kDefaultEqualSelectivity
+                                                                         : kDefaultSelectivity;
+    if (column->kind() != ExprKind::COLUMN_REF || value->kind() != ExprKind::LITERAL || stats == nullptr) {
+        return fallback;
+    }
+    const auto* literal = static_cast<const Literal*>(value);
+    if (literal->is_null()) {
+        return 0;
+    }
+    double v = statistics_value(literal->type(), literal->datum());
+    if (op == "eq") {
+        return stats->equal_selectivity(v);
+    }
+    if (op == "ne") {
+        return std::max(1 - stats->null_fraction - stats->equal_selectivity(v), 0.0);
+    }
+    if (op == "lt" || op == "le") {
+        return stats->range_selectivity(nullptr, false, &v, op == "le");
+    }
+    return stats->range_selectivity(&v, op == "ge", nullptr, false);
+}
+
+StatusOr<CardinalityEstimator> CardinalityEstimator::create(const SpjgQuery& query,
+                                                            const std::vector<TableStatisticsPtr>& stats) {
+    size_t num_tables = query.tables.size();
+    if (num_tables > 64) {
+        return Status::NotSupported("join of " + std::to_string(num_tables) + " tables");
+    }
+    if (stats.size() != num_tables) {
+        return Status::InvalidArgument("statistics of " + std::to_string(stats.size()) + " tables for a join of " +
+                                       std::to_string(num_tables));
+    }
+    // Table and column of each slot of a table.
+    std::unordered_map<SlotId, std::pair<size_t, size_t>> table_slots;
+    for (size_t t = 0; t < num_tables; ++t) {
+        const SpjgTable& table = query.tables[t];
+        if (stats[t] != nullptr && stats[t]->columns.size() != table.slot_ids.size()) {
+            return Status::InvalidArgument("statistics of table " + table.table->name() + " do not match its columns");
+        }
+        for (size_t c = 0; c < table.slot_ids.size(); ++c) {
+            table_slots.emplace(table.slot_ids[c], std::make_pair(t, c));
+        }
+    }
+    auto column_stats = [&](SlotId slot_id) -> const ColumnStatistics* {
+        auto it = table_slots.find(slot_id);
+        if (it == table_slots.end() || stats[it->second.first] == nullptr) {
+            return nullptr;
+        }
+        return &stats[it->second.first]->columns[it->second.second];
+    };
+    auto tables_of = [&](const Expr& expr, TableSet* tables) -> Status {
+        std::vector<SlotId> slot_ids;
+        expr.get_slot_ids(&slot_ids);
+        for (SlotId slot_id : slot_ids) {
+            auto it = table_slots.find(slot_id);
+            if (it == table_slots.end()) {
+                return Status::InvalidArgument("slot #" + std::to_string(slot_id) + " is of no table");
+            }
+            *tables |= TableSet(1) << it->second.first;
+        }
+        return Status::OK();
+    };
+
+    CardinalityEstimator estimator;
+    estimator._tables.resize(num_tables);
+    std::vector<double> selectivities(num_tables, 1.0);
+    for (const auto& predicate : query.predicates) {
+        TableSet tables = 0;
+        RETURN_IF_ERROR(tables_of(*predicate, &tables));
+        double selectivity = estimate_selectivity(*predicate, column_stats);
+        if (__builtin_popcountll(tables) == 1) {
+            selectivities[__builtin_ctzll(tables)] *= selectivity;
+        } else {
+            // Mostly comparisons of columns, which the statistics know
+            // nothing of.
+            estimator._residuals.push_back(Residual{tables, std::min(selectivity, kDefaultSelectivity)});
+        }
+    }
+
+    // The columns read above the scans.
+    std::vector<SlotId> read_slots;
+    auto add_read_slots = [&](const ExprPtr& expr) {
+        if (expr != nullptr) {
+            expr->get_slot_ids(&read_slots);
+        }
+    };
+    for (const auto& join : query.joins) {
+        read_slots.push_back(join.left);
+        read_slots.push_back(join.right);
+    }
+    for (const auto& predicate : query.predicates) {
+        add_read_slots(predicate);
+    }
+    for (const auto& projection : query.group_by) {
+        add_read_slots(projection.expr);
+    }
+    for (const auto& aggregate : query.aggregates) {
+        add_read_slots(aggregate.arg);
+    }
+    if (!query.has_aggregation()) {
+        for (const auto& projection : query.outputs) {
+            add_read_slots(projection.expr);
+        }
+    }
+    std::sort(read_slots.begin(), read_slots.end());
+    read_slots.erase(std::unique(read_slots.begin(), read_slots.end()), read_slots.end());
+
+    for (size_t t = 0; t < num_tables; ++t) {
+        TableEstimate& table = estimator._tables[t];
+        table.scanned_rows = stats[t] != nullptr ? static_cast<double>(stats[t]->row_count) : kDefaultTableRows;
+        table.rows = std::max(table.scanned_rows * selectivities[t], 1.0);
+    }
+    for (SlotId slot_id : read_slots) {
+        auto it = table_slots.find(slot_id);
+        if (it == table_slots.end()) {
+            return Status::InvalidArgument("slot #" + std::to_string(slot_id) + " is of no table");
+        }
+        const ColumnStatistics* column = column_stats(slot_id);
+        LogicalType type = query.tables[it->second.first].table->schema()[it->second.second].type;
+        double default_size = is_binary_type(type) ? 16 : static_cast<double>(get_type_size(type));
+        estimator._tables[it->second.first].row_size += column != nullptr ? column->avg_size : default_size;
+    }
+
+    // Classes of equal columns, by union-find over the join conditions.
+    std::unordered_map<SlotId, SlotId> parents;
+    std::function<SlotId(SlotId)> find = [&](SlotId slot_id) {
+        auto it = parents.find(slot_id);
+        if (it == parents.end() || it->second == slot_id) {
+            return slot_id;
+        }
+        it->second = find(it->second);
+        return it->second;
+    };
+    for (const auto& join : query.joins) {
+        for (SlotId slot_id : {join.left, join.right}) {
+            if (table_slots.count(slot_id) == 0) {
+                return Status::InvalidArgument("slot #" + std::to_string(slot_id) + " is of no table");
+            }
+            parents.emplace(slot_id, slot_id);
+        }
+        parents[find(join.left)] = find(join.right);
+    }
+    std::unordered_map<SlotId, int> class_ids;
+    std::vector<SlotId> join_slots;
+    for (const auto& [slot_id, parent] : parents) {
+        join_slots.push_back(slot_id);
+    }
+    // In a stable order, for stable plans.
+    std::sort(join_slots.begin(), join_slots.end());
+    for (SlotId slot_id : join_slots) {
+        auto [it, inserted] = class_ids.emplace(find(slot_id), static_cast<int>(estimator._classes.size()));
+        if (inserted) {
+            estimator._classes.emplace_back();
+        }
+        size_t t = table_slots[slot_id].first;
+        const TableEstimate& table = estimator._tables[t];
+        const ColumnStatistics* column = column_stats(slot_id);
+        double ndv = column != nullptr ? column->ndv : table.scanned_rows;
+        // Distinct values among the rows kept, were they picked at random.
+        double kept = table.rows / std::max(table.scanned_rows, 1.0);
+        if (ndv > 0 && kept < 1) {
+            ndv *= 1 - std::pow(1 - kept, table.scanned_rows / ndv);
+        }
+        ndv = std::clamp(ndv, 1.0, table.rows);
+        estimator._classes[it->second].push_back(ClassMember{t, slot_id, ndv});
+    }
+    for (const auto& members : estimator._classes) {
+        TableSet tables = 0;
+        for (const auto& member : members) {
+            tables |= TableSet(1) << member.table;
+        }
+        for (const auto& member : members) {
+            estimator._tables[member.table].neighbors |= tables & ~(TableSet(1) << member.table);
+        }
+    }
+    return estimator;
+}
+
+double CardinalityEstimator::row_size(TableSet tables) const {
+    double size = 0;
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        if (tables & (TableSet(1) << t)) {
+            size += _tables[t].row_size;
+        }
+    }
+    return size;
+}
+
+double CardinalityEstimator::join_rows(TableSet tables) const {
+    double rows = 1;
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        if (tables & (TableSet(1) << t)) {
+            rows *= _tables[t].rows;
+        }
+    }
+    std::vector<double> ndvs;
+    for (const auto& members : _classes) {
+        ndvs.clear();
+        for (const auto& member : members) {
+            if (tables & (TableSet(1) << member.table)) {
+                ndvs.push_back(member.ndv);
+            }
+        }
+        // k equal columns keep the rows matching the one with the fewest
+        // values: 1 / ndv of each of the other k - 1.
+        if (ndvs.size() >= 2) {
+            std::sort(ndvs.begin(), ndvs.end());
+            for (size_t i = 1; i < ndvs.size(); ++i) {
+                rows /= ndvs[i];
+            }
+        }
+    }
+    for (const auto& residual : _residuals) {
+        if ((residual.tables & tables) == residual.tables) {
+            rows *= residual.selectivity;
+        }
+    }
+    return std::max(rows, 1.0);
+}
+
+TableSet CardinalityEstimator::neighbors(TableSet tables) const {
+    TableSet result = 0;
+    for (size_t t = 0; t < _tables.size(); ++t) {
+        if (tables & (TableSet(1) << t)) {
+            result |= _tables[t].neighbors;
+        }
+    }
+    return result & ~tables;
+}
+
+bool CardinalityEstimator::is_connected(TableSet tables) const {
+    if (tables == 0) {
+        return false;
+    }
+    TableSet reached = tables & -tables;
+    while (true) {
+        TableSet next = (reached | neighbors(reached)) & tables;
+        if (next == reached) {
+            return reached == tables;
+        }
+        reached = next;
+    }
+}
+
+std::vector<int> CardinalityEstimator::join_classes(TableSet a, TableSet b) const {
+    std::vector<int> classes;
+    for (size_t k = 0; k < _classes.size(); ++k) {
+        if (class_slot(static_cast<int>(k), a) >= 0 && class_slot(static_cast<int>(k), b) >= 0) {
+            classes.push_back(static_cast<int>(k));
+        }
+    }
+    return classes;
+}
+
+SlotId CardinalityEstimator::class_slot(int key_class, TableSet tables) const {
+    for (const auto& member : _classes[key_class]) {
+        if (tables & (TableSet(1) << member.table)) {
+            return member.slot_id;
+        }
+    }
+    return -1;
+}
+
+std::vector<SpjgJoin> CardinalityEstimator::join_conditions(TableSet a, TableSet b) const {
+    std::vector<SpjgJoin> conditions;
+    for (int key_class : join_classes(a, b)) {
+        conditions.push_back(SpjgJoin{class_slot(key_class, a), class_slot(key_class, b)});
+    }
+    return conditions;
+}
+
+} // namespace starrocks
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "mv/spjg_query.h"
+#include "optimizer/statistics.h"
+
+namespace starrocks {
+
+// A set of the tables of a query, bit i for table i.
+using TableSet = uint64_t;
+
+// Fraction of the rows passing |predicate|, from the statistics of the
+// columns it compares with constants; |column_stats| gives those of a slot,
+// or nullptr. Conjuncts and disjuncts are taken as independent.
+double estimate_selectivity(const Expr& predicate,
+                            const std::function<const ColumnStatistics*(SlotId)>& column_stats);
+
+// Estimates the rows of the joins of the tables of an SpjgQuery. The join
+// conditions are taken as classes of equal columns, so that a = b and b = c
+// also join the tables of a and c; a join on a class keeps 1 / ndv of the
+// pairs of rows, the ndv being the larger of the two sides' after their
+// predicates. Predicates over several tables apply, at a default
+// selectivity, to every join reading all of them. Estimates only depend on
+// the set of tables joined, never on the order, so every plan of a set
+// agrees on its rows.
+class CardinalityEstimator {
+public:
+    // |stats| has the statistics of each table of |query|, or nullptr.
+    static StatusOr<CardinalityEstimator> create(const SpjgQuery& query, const std::vector<TableStatisticsPtr>& stats);
+
+    size_t num_tables() const { return _tables.size(); }
+    // Rows of table |t| before and after its predicates.
+    double scanned_rows(size_t t) const { return _tables[t].scanned_rows; }
+    double table_rows(size_t t) const { return _tables[t].rows; }
+    // Bytes of the columns of |tables| the query reads, per row.
+    double row_size(TableSet tables) const;
+
+    // Rows of the join of |tables|.
+    double join_rows(TableSet tables) const;
+
+    // The tables joined with one of |tables|, themselves excluded.
+    TableSet neighbors(TableSet tables) const;
+    // Whether |tables| are joined without a cross product.
+    bool is_connected(TableSet tables) const;
+
+    // The classes of equal columns joining |a| with |b|.
+    std::vector<int> join_classes(TableSet a, TableSet b) const;
+    // A slot of class |key_class| in |tables|, -1 when none is.
+    SlotId class_slot(int key_class, TableSet tables) const;
+    // One join condition between |a| and |b| per class joining them,
+    // whether the query states it or it follows from the conditions it does.
+    std::vector<SpjgJoin> join_conditions(TableSet a, TableSet b) const;
+
+private:
+    struct TableEstimate {
+        double scanned_rows = 0;
+        double rows = 0;
+        double row_size = 0;
+        TableSet neighbors = 0;
+    };
+
+    struct ClassMember {
+        size_t table;
+        SlotId slot_id;
+        // Distinct values left after the predicates of the table.
+        double ndv;
+    };
+
+    struct Residual {
+        TableSet tables;
+        double selectivity;
+    };
+
+    std::vector<TableEstimate> _tables;
+    std::vector<std::vector<ClassMember>> _classes;
+    std::vector<Residual> _residuals;
+};
+
+} // namespace starrocks
@@ -0,0 +1,140 @@
+#include "optimizer/memo.h"
+
+#include <algorithm>
+
+namespace starrocks {
+
+Memo::Memo(const CardinalityEstimator* estimator, CostModel cost_model)
+        : _estimator(estimator), _cost_model(cost_model) {}
+
+int Memo::group(TableSet tables) {
+    auto [it, inserted] = _group_ids.emplace(tables, static_cast<int>(_groups.size()));
+    if (inserted) {
+        Group group;
+        group.tables = tables;
+        group.rows = _estimator->join_rows(tables);
+        group.row_size = _estimator->row_size(tables);
+        _groups.push_back(std::move(group));
+    }
+    return it->second;
+}
+
+int Memo::find_group(TableSet tables) const {
+    auto it = _group_ids.find(tables);
+    return it != _group_ids.end() ? it->second : -1;
+}
+
+void Memo::add_join(TableSet probe, TableSet build) {
+    GroupExpression expression{group(probe), group(build), _estimator->join_classes(probe, build)};
+    _groups[group(probe | build)].expressions.push_back(std::move(expression));
+    _num_expressions++;
+}
+
+double Memo::_join_cost(const Group& group, const Group& probe, const Group& build, int build_copies) const {
+    double copies = build_copies;
+    return probe.rows * _cost_model.probe_row + build.rows * copies * _cost_model.build_row +
+           build.rows * build.row_size * copies * _cost_model.hash_table_byte + group.rows * _cost_model.output_row;
+}
+
+double Memo::_shuffle_cost(const Group& group) const {
+    return group.rows * group.row_size * _cost_model.network_byte;
+}
+
+double Memo::_broadcast_cost(const Group& group) const {
+    return _shuffle_cost(group) * std::max(_cost_model.num_backends, 1);
+}
+
+const Memo::Winner& Memo::_optimize(int group_id, int required) {
+    // Winners stay where they are as the map grows.
+    auto it = _groups[group_id].winners.find(required);
+    if (it != _groups[group_id].winners.end()) {
+        return it->second;
+    }
+    Winner best;
+    best.cost = -1;
+    auto consider = [&best](const Winner& candidate) {
+        if (best.cost < 0 || candidate.cost < best.cost) {
+            best = candidate;
+        }
+    };
+    const Group& group = _groups[group_id];
+    if (group.expressions.empty() && required == kAnyDistribution) {
+        int table = __builtin_ctzll(group.tables);
+        consider(Winner{Winner::Choice::SCAN, _estimator->scanned_rows(table) * _cost_model.scan_row});
+    }
+    int backends = std::max(_cost_model.num_backends, 1);
+    for (size_t e = 0; e < group.expressions.size(); ++e) {
+        const GroupExpression& expression = group.expressions[e];
+        const Group& probe = _groups[expression.probe];
+        const Group& build = _groups[expression.build];
+        double broadcast = _optimize(expression.probe, required).cost +
+                           _optimize(expression.build, kAnyDistribution).cost +
+                           _broadcast_cost(build) + _join_cost(group, probe, build, backends);
+        consider(Winner{Winner::Choice::BROADCAST_JOIN, broadcast, static_cast<int>(e)});
+        for (int key_class : expression.key_classes) {
+            if (required != kAnyDistribution && required != key_class) {
+                continue;
+            }
+            double shuffle = _optimize(expression.probe, key_class).cost +
+                             _optimize(expression.build, key_class).cost + _join_cost(group, probe, build, 1);
+            consider(Winner{Winner::Choice::SHUFFLE_JOIN, shuffle, static_cast<int>(e), key_class});
+        }
+    }
+    if (required != kAnyDistribution) {
+        double enforced = _optimize(group_id, kAnyDistribution).cost + _shuffle_cost(group);
+        consider(Winner{Winner::Choice::ENFORCE, enforced, -1, required});
+    }
+    return _groups[group_id].winners.emplace(required, best).first->second;
+}
+
+PlanNodePtr Memo::_extract(int group_id, int required) {
+    const Winner winner = _optimize(group_id, required);
+    const Group& group = _groups[group_id];
+    auto node = std::make_shared<PlanNode>();
+    node->rows = group.rows;
+    node->cost = winner.cost;
+    switch (winner.choice) {
+    case Winner::Choice::SCAN:
+        node->type = PlanNode::Type::SCAN;
+        node->table = __builtin_ctzll(group.tables);
+        break;
+    case Winner::Choice::ENFORCE:
+        node->type = PlanNode::Type::EXCHANGE;
+        node->partition_type = pipeline::ExchangePartitionType::HASH;
+        node->partition_slots.push_back(_estimator->class_slot(winner.key_class, group.tables));
+        node->children.push_back(_extract(group_id, kAnyDistribution));
+        break;
+    case Winner::Choice::BROADCAST_JOIN:
+    case Winner::Choice::SHUFFLE_JOIN: {
+        const GroupExpression& expression = group.expressions[winner.expression];
+        const Group& probe = _groups[expression.probe];
+        const Group& build = _groups[expression.build];
+        node->type = PlanNode::Type::HASH_JOIN;
+        node->conditions = _estimator->join_conditions(probe.tables, build.tables);
+        if (winner.choice == Winner::Choice::BROADCAST_JOIN) {
+            node->distribution = JoinDistribution::BROADCAST;
+            node->children.push_back(_extract(expression.probe, required));
+            auto exchange = std::make_shared<PlanNode>();
+            exchange->type = PlanNode::Type::EXCHANGE;
+            exchange->partition_type = pipeline::ExchangePartitionType::BROADCAST;
+            exchange->children.push_back(_extract(expression.build, kAnyDistribution));
+            exchange->rows = build.rows;
+            exchange->cost = exchange->children[0]->cost + _broadcast_cost(build);
+            node->children.push_back(std::move(exchange));
+        } else {
+            node->distribution = JoinDistribution::SHUFFLE;
+            node->children.push_back(_extract(expression.probe, winner.key_class));
+            node->children.push_back(_extract(expression.build, winner.key_class));
+        }
+        break;
+    }
+    }
+    return node;
+}
+
+PlanNodePtr Memo::best_plan(TableSet tables) {
+    int group_id = find_group(tables);
+    return group_id >= 0 ? _extract(group_id, kAnyDistribution) : nullptr;
+}
+
+} // namespace starrocks
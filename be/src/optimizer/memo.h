@@ -0,0 +1,101 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "optimizer/cardinality_estimator.h"
+#include "optimizer/physical_plan.h"
+
+namespace starrocks {
+
+// Costs, in units of a row probing a hash table.
+struct CostModel {
+    int32_t num_backends = 1;
+    double scan_row = 1;
+    double probe_row = 1;
+    double build_row = 2;
+    double output_row = 1;
+    double network_byte = 0.1;
+    double hash_table_byte = 0.01;
+};
+
+// The memo of a Cascades-style search over the join orders of a query. A
+// group holds every plan joining one set of tables - a leaf group scans one
+// table - as group expressions, each a join of two smaller groups, one
+// probing a hash table of the other. Since a group stands for all of its
+// plans, n tables need at most 2^n groups however many orders there are.
+//
+// The physical search picks, for each group and each distribution its
+// parent requires of its rows - anywhere, or hash-partitioned on a class of
+// join keys - the cheapest plan delivering it, and keeps it as the group's
+// winner for that distribution: a broadcast join, passing the requirement
+// on to its probe side; a shuffle join on one of its join keys, requiring
+// both sides partitioned on it; or an exchange enforcing the distribution
+// over the group's cheapest plan.
+class Memo {
+public:
+    Memo(const CardinalityEstimator* estimator, CostModel cost_model);
+
+    // The group of |tables|, created when new.
+    int group(TableSet tables);
+    // -1 when there is none.
+    int find_group(TableSet tables) const;
+    // Adds the join of the groups of |probe| and |build| to the group of
+    // both; the tables must be joined on at least one column.
+    void add_join(TableSet probe, TableSet build);
+
+    size_t num_groups() const { return _groups.size(); }
+    size_t num_expressions() const { return _num_expressions; }
+
+    // The cheapest plan of the group of |tables|, with its rows anywhere.
+    PlanNodePtr best_plan(TableSet tables);
+
+private:
+    // Rows anywhere, or partitioned on the join key class of this number.
+    static constexpr int kAnyDistribution = -1;
+
+    struct GroupExpression {
+        int probe;
+        int build;
+        // Of the conditions between the two sides.
+        std::vector<int> key_classes;
+    };
+
+    struct Winner {
+        enum class Choice {
+            SCAN,
+            BROADCAST_JOIN,
+            SHUFFLE_JOIN,
+            ENFORCE,
+        };
+
+        Choice choice = Choice::SCAN;
+        double cost = 0;
+        int expression = -1;
+        // The key class of a shuffle join or an enforcer.
+        int key_class = kAnyDistribution;
+    };
+
+    struct Group {
+        TableSet tables = 0;
+        double rows = 0;
+        double row_size = 0;
+        std::vector<GroupExpression> expressions;
+        // By required distribution.
+        std::unordered_map<int, Winner> winners;
+    };
+
+    const Winner& _optimize(int group, int required);
+    PlanNodePtr _extract(int group, int required);
+    double _join_cost(const Group& group, const Group& probe, const Group& build, int build_copies) const;
+    double _shuffle_cost(const Group& group) const;
+    double _broadcast_cost(const Group& group) const;
+
+    const CardinalityEstimator* _estimator;
+    const CostModel _cost_model;
+    std::vector<Group> _groups;
+    std::unordered_map<TableSet, int> _group_ids;
+    size_t _num_expressions = 0;
+};
+
+} // namespace starrocks
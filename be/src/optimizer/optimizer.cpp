@@ -0,0 +1,113 @@
+#include "optimizer/optimizer.h"
+
+#include <algorithm>
+
+namespace starrocks {
+
+// The dynamic programming keeps a flag per subset of the tables.
+static constexpr int kMaxDpTables = 20;
+
+static void enumerate_connected_splits(const CardinalityEstimator& estimator, Memo* memo) {
+    size_t num_tables = estimator.num_tables();
+    TableSet all = (TableSet(1) << num_tables) - 1;
+    std::vector<TableSet> neighbors(num_tables);
+    for (size_t t = 0; t < num_tables; ++t) {
+        neighbors[t] = estimator.neighbors(TableSet(1) << t);
+    }
+    auto neighbors_of = [&](TableSet tables) {
+        TableSet result = 0;
+        for (TableSet rest = tables; rest != 0; rest &= rest - 1) {
+            result |= neighbors[__builtin_ctzll(rest)];
+        }
+        return result;
+    };
+    std::vector<bool> connected(all + 1);
+    // Subsets come after their subsets, so each split joins two groups
+    // already planned.
+    for (TableSet tables = 1; tables <= all; ++tables) {
+        connected[tables] = estimator.is_connected(tables);
+        if (!connected[tables] || (tables & (tables - 1)) == 0) {
+            continue;
+        }
+        for (TableSet probe = (tables - 1) & tables; probe != 0; probe = (probe - 1) & tables) {
+            TableSet build = tables ^ probe;
+            if (connected[probe] && connected[build] && (neighbors_of(probe) & build) != 0) {
+                memo->add_join(probe, build);
+            }
+        }
+    }
+}
+
+static void join_greedily(const CardinalityEstimator& estimator, Memo* memo) {
+    std::vector<TableSet> trees;
+    for (size_t t = 0; t < estimator.num_tables(); ++t) {
+        trees.push_back(TableSet(1) << t);
+    }
+    while (trees.size() > 1) {
+        size_t best_left = 0;
+        size_t best_right = 0;
+        double best_rows = -1;
+        for (size_t i = 0; i < trees.size(); ++i) {
+            TableSet neighbors = estimator.neighbors(trees[i]);
+            for (size_t j = i + 1; j < trees.size(); ++j) {
+                if ((neighbors & trees[j]) == 0) {
+                    continue;
+                }
+                double rows = estimator.join_rows(trees[i] | trees[j]);
+                if (best_rows < 0 || rows < best_rows) {
+                    best_left = i;
+                    best_right = j;
+                    best_rows = rows;
+                }
+            }
+        }
+        // Either side may build.
+        memo->add_join(trees[best_left], trees[best_right]);
+        memo->add_join(trees[best_right], trees[best_left]);
+        trees[best_left] |= trees[best_right];
+        trees.erase(trees.begin() + best_right);
+    }
+}
+
+static void collect_conditions(const PlanNode& node, std::vector<SpjgJoin>* conditions) {
+    conditions->insert(conditions->end(), node.conditions.begin(), node.conditions.end());
+    for (const auto& child : node.children) {
+        collect_conditions(*child, conditions);
+    }
+}
+
+StatusOr<OptimizedPlan> optimize_query(const SpjgQuery& query, const std::vector<TableStatisticsPtr>& stats,
+                                       const OptimizerOptions& options) {
+    size_t num_tables = query.tables.size();
+    if (num_tables == 0) {
+        return Status::InvalidArgument("query over no table");
+    }
+    ASSIGN_OR_RETURN(CardinalityEstimator estimator, CardinalityEstimator::create(query, stats));
+    TableSet all = num_tables == 64 ? ~TableSet(0) : (TableSet(1) << num_tables) - 1;
+    if (!estimator.is_connected(all)) {
+        return Status::InvalidArgument("the tables of the query are not all joined");
+    }
+    CostModel cost_model;
+    cost_model.num_backends = options.num_backends;
+    Memo memo(&estimator, cost_model);
+    for (size_t t = 0; t < num_tables; ++t) {
+        memo.group(TableSet(1) << t);
+    }
+    OptimizedPlan plan;
+    plan.exhaustive = static_cast<int>(num_tables) <= std::min(options.dp_join_reorder_max_tables, kMaxDpTables);
+    if (plan.exhaustive) {
+        enumerate_connected_splits(estimator, &memo);
+    } else {
+        join_greedily(estimator, &memo);
+    }
+    plan.root = memo.best_plan(all);
+    plan.join_tree = to_join_tree(*plan.root);
+    plan.query = query;
+    plan.query.joins.clear();
+    collect_conditions(*plan.root, &plan.query.joins);
+    plan.num_groups = memo.num_groups();
+    plan.num_expressions = memo.num_expressions();
+    return plan;
+}
+
+} // namespace starrocks
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "optimizer/memo.h"
+
+namespace starrocks {
+
+struct OptimizerOptions {
+    int32_t num_backends = config::optimizer_num_backends;
+    int32_t dp_join_reorder_max_tables = config::optimizer_dp_join_reorder_max_tables;
+};
+
+struct OptimizedPlan {
+    // The query joined on the conditions of the plan's joins: one per class
+    // of equal columns between the two sides of each, so a join of tables
+    // linked only through a third one, a = b and b = c for a and c, needs no
+    // cross product.
+    SpjgQuery query;
+    PlanNodePtr root;
+    // For SpjgExecutor.
+    SpjgJoinTreePtr join_tree;
+    // Every connected subset of the tables was planned, rather than those
+    // picked greedily.
+    bool exhaustive = false;
+    size_t num_groups = 0;
+    size_t num_expressions = 0;
+
+    std::string explain() const { return explain_plan(*root, query); }
+};
+
+// The cheapest plan of the joins of |query| by the estimates of a
+// CardinalityEstimator over |stats|, the statistics of each table, or
+// nullptr. Joins of up to dp_join_reorder_max_tables tables are planned by
+// dynamic programming: the memo gets every connected subset of the tables,
+// each with every split into two connected, joined subsets. Larger joins are
+// planned greedily, each step joining the two subsets whose join has the
+// fewest rows. Then each join is a broadcast or a shuffle join, whichever
+// is cheaper with the rows of its sides where the joins below put them.
+//
+// Queries whose tables cannot all be joined without a cross product are
+// refused.
+StatusOr<OptimizedPlan> optimize_query(const SpjgQuery& query, const std::vector<TableStatisticsPtr>& stats,
+                                       const OptimizerOptions& options = {});
+
+} // namespace starrocks
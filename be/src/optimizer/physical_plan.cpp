@@ -0,0 +1,67 @@
+#include "optimizer/physical_plan.h"
+
+#include <cstdio>
+
+namespace starrocks {
+
+static std::string format_estimates(const PlanNode& node) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), " rows=%.0f cost=%.0f", node.rows, node.cost);
+    return buf;
+}
+
+static void explain_node(const PlanNode& node, const SpjgQuery& query, int depth, std::string* out) {
+    out->append(static_cast<size_t>(depth) * 2, ' ');
+    switch (node.type) {
+    case PlanNode::Type::SCAN:
+        out->append("SCAN " + query.tables[node.table].table->name());
+        break;
+    case PlanNode::Type::HASH_JOIN: {
+        out->append(node.distribution == JoinDistribution::BROADCAST ? "HASH JOIN (BROADCAST)"
+                                                                     : "HASH JOIN (SHUFFLE)");
+        std::string sep = " ";
+        for (const auto& condition : node.conditions) {
+            out->append(sep + "slot#" + std::to_string(condition.left) + " = slot#" +
+                        std::to_string(condition.right));
+            sep = ", ";
+        }
+        break;
+    }
+    case PlanNode::Type::EXCHANGE:
+        if (node.partition_type == pipeline::ExchangePartitionType::BROADCAST) {
+            out->append("EXCHANGE BROADCAST");
+        } else {
+            out->append("EXCHANGE HASH(");
+            for (size_t i = 0; i < node.partition_slots.size(); ++i) {
+                out->append((i > 0 ? ", slot#" : "slot#") + std::to_string(node.partition_slots[i]));
+            }
+            out->append(")");
+        }
+        break;
+    }
+    out->append(format_estimates(node));
+    out->append("\n");
+    for (const auto& child : node.children) {
+        explain_node(*child, query, depth + 1, out);
+    }
+}
+
+std::string explain_plan(const PlanNode& root, const SpjgQuery& query) {
+    std::string out;
+    explain_node(root, query, 0, &out);
+    return out;
+}
+
+SpjgJoinTreePtr to_join_tree(const PlanNode& root) {
+    switch (root.type) {
+    case PlanNode::Type::SCAN:
+        return SpjgJoinTree::leaf(root.table);
+    case PlanNode::Type::HASH_JOIN:
+        return SpjgJoinTree::join(to_join_tree(*root.children[0]), to_join_tree(*root.children[1]));
+    case PlanNode::Type::EXCHANGE:
+        break;
+    }
+    return to_join_tree(*root.children[0]);
+}
+
+} // namespace starrocks
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exec/pipeline/exchange/exchange_sink_operator.h"
+#include "mv/spjg_query.h"
+
+namespace starrocks {
+
+// How the two sides of a hash join meet across backends.
+enum class JoinDistribution {
+    // The build side is sent whole to every backend holding probe rows,
+    // which stay where they are.
+    BROADCAST,
+    // Both sides are hash-partitioned on the join keys, unless already so,
+    // and each backend joins its partition.
+    SHUFFLE,
+};
+
+struct PlanNode;
+using PlanNodePtr = std::shared_ptr<const PlanNode>;
+
+// A node of the physical plan of the joins of an SpjgQuery, as picked by
+// optimize_query(). Estimates are the optimizer's.
+struct PlanNode {
+    enum class Type {
+        SCAN,
+        HASH_JOIN,
+        EXCHANGE,
+    };
+
+    Type type = Type::SCAN;
+    // SCAN: the index of the table.
+    int table = -1;
+    // HASH_JOIN: children[0] probes the hash table of children[1] on
+    // |conditions|, whose left slots are of the probe side.
+    JoinDistribution distribution = JoinDistribution::BROADCAST;
+    std::vector<SpjgJoin> conditions;
+    // EXCHANGE: sends the rows of children[0] across the backends.
+    pipeline::ExchangePartitionType partition_type = pipeline::ExchangePartitionType::HASH;
+    std::vector<SlotId> partition_slots;
+    std::vector<PlanNodePtr> children;
+
+    double rows = 0;
+    // Of the whole subtree.
+    double cost = 0;
+};
+
+// One line per node, children indented below their parent.
+std::string explain_plan(const PlanNode& root, const SpjgQuery& query);
+
+// The order |root| joins the tables in, without its exchanges.
+SpjgJoinTreePtr to_join_tree(const PlanNode& root);
+
+} // namespace starrocks
@@ -0,0 +1,226 @@
+#include "optimizer/statistics.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "column/column_helper.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+static double slice_value(const Slice& slice) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value = (value << 8) | (i < slice.size ? static_cast<uint8_t>(slice.data[i]) : 0);
+    }
+    return static_cast<double>(value);
+}
+
+double statistics_value(LogicalType type, const Datum& value) {
+    return type_dispatch_all(type, [&](auto tag) -> double {
+        constexpr LogicalType LT = decltype(tag)::value;
+        if constexpr (is_binary_type(LT)) {
+            return slice_value(value.get_slice());
+        } else {
+            return static_cast<double>(value.get<RunTimeCppType<LT>>());
+        }
+    });
+}
+
+Histogram Histogram::build(std::vector<double> values, size_t num_buckets) {
+    std::vector<Bucket> buckets;
+    if (values.empty() || num_buckets == 0) {
+        return Histogram();
+    }
+    std::sort(values.begin(), values.end());
+    auto total = static_cast<double>(values.size());
+    size_t per_bucket = std::max<size_t>((values.size() + num_buckets - 1) / num_buckets, 1);
+    size_t begin = 0;
+    while (begin < values.size()) {
+        // Ends after the last repeat of the value the bucket is full at.
+        size_t end = std::min(begin + per_bucket, values.size());
+        while (end < values.size() && values[end] == values[end - 1]) {
+            ++end;
+        }
+        Bucket bucket;
+        bucket.lower = values[begin];
+        bucket.upper = values[end - 1];
+        bucket.count = static_cast<double>(end - begin) / total;
+        size_t upper_begin = end - 1;
+        while (upper_begin > begin && values[upper_begin - 1] == bucket.upper) {
+            --upper_begin;
+        }
+        bucket.upper_count = static_cast<double>(end - upper_begin) / total;
+        for (size_t i = begin; i < end; ++i) {
+            bucket.ndv += i == begin || values[i] != values[i - 1];
+        }
+        buckets.push_back(bucket);
+        begin = end;
+    }
+    return Histogram(std::move(buckets));
+}
+
+double Histogram::equal_fraction(double value) const {
+    auto it = std::lower_bound(_buckets.begin(), _buckets.end(), value,
+                               [](const Bucket& bucket, double v) { return bucket.upper < v; });
+    if (it == _buckets.end() || value < it->lower) {
+        return 0;
+    }
+    if (value == it->upper) {
+        return it->upper_count;
+    }
+    // The other values of the bucket share the rest evenly.
+    return (it->count - it->upper_count) / std::max(it->ndv - 1, 1.0);
+}
+
+double Histogram::less_fraction(double value, bool inclusive) const {
+    double fraction = 0;
+    for (const auto& bucket : _buckets) {
+        if (value > bucket.upper) {
+            fraction += bucket.count;
+            continue;
+        }
+        if (value == bucket.upper) {
+            fraction += inclusive ? bucket.count : bucket.count - bucket.upper_count;
+        } else if (value > bucket.lower) {
+            fraction += (bucket.count - bucket.upper_count) * (value - bucket.lower) / (bucket.upper - bucket.lower);
+        } else if (value == bucket.lower && inclusive) {
+            fraction += equal_fraction(value);
+        }
+        break;
+    }
+    return std::clamp(fraction, 0.0, 1.0);
+}
+
+double ColumnStatistics::equal_selectivity(double value) const {
+    if (ndv <= 0 || value < min || value > max) {
+        return 0;
+    }
+    double fraction = histogram.empty() ? 0 : histogram.equal_fraction(value);
+    // A value the sample missed is still at least as frequent as one in
+    // ndv; one it caught is no more frequent than its share of the sample.
+    fraction = std::max(fraction, 1 / ndv);
+    return std::min(fraction, 1.0) * (1 - null_fraction);
+}
+
+double ColumnStatistics::range_selectivity(const double* lower, bool lower_inclusive, const double* upper,
+                                           bool upper_inclusive) const {
+    if (ndv <= 0) {
+        return 0;
+    }
+    auto less = [&](double value, bool inclusive) {
+        if (!histogram.empty()) {
+            return histogram.less_fraction(value, inclusive);
+        }
+        if (value < min || (value == min && !inclusive)) {
+            return 0.0;
+        }
+        return max > min ? std::min((value - min) / (max - min), 1.0) : 1.0;
+    };
+    double fraction = upper != nullptr ? less(*upper, upper_inclusive) : 1.0;
+    if (lower != nullptr) {
+        fraction -= less(*lower, !lower_inclusive);
+    }
+    return std::clamp(fraction, 0.0, 1.0) * (1 - null_fraction);
+}
+
+TableStatisticsBuilder::TableStatisticsBuilder(RowDescriptor schema, StatisticsOptions options)
+        : _schema(std::move(schema)), _options(options) {
+    for (const auto& slot : _schema) {
+        _columns.emplace_back(slot.type);
+    }
+}
+
+void TableStatisticsBuilder::_add_value(ColumnState* state, double value, uint64_t hash, size_t size) {
+    if (state->num_values == 0) {
+        state->min = value;
+        state->max = value;
+    } else {
+        state->min = std::min(state->min, value);
+        state->max = std::max(state->max, value);
+    }
+    state->num_values++;
+    state->total_size += static_cast<double>(size);
+    state->distinct.add_hash(hash);
+    auto sample_rows = static_cast<size_t>(std::max<int64_t>(_options.sample_rows, 1));
+    if (state->sample.size() < sample_rows) {
+        state->sample.push_back(value);
+        return;
+    }
+    // Keeps each value seen with the same chance.
+    uint64_t slot = _random() % static_cast<uint64_t>(state->num_values);
+    if (slot < sample_rows) {
+        state->sample[slot] = value;
+    }
+}
+
+void TableStatisticsBuilder::add_chunk(const Chunk& chunk) {
+    size_t num_rows = chunk.num_rows();
+    _row_count += static_cast<int64_t>(num_rows);
+    for (size_t c = 0; c < _columns.size(); ++c) {
+        ColumnState* state = &_columns[c];
+        ColumnPtr column = ColumnHelper::unfold_const_column(state->type, num_rows, chunk.get_column_by_index(c));
+        const NullData* nulls = ColumnHelper::get_null_data(column.get());
+        const Column* data = ColumnHelper::get_data_column(column.get());
+        type_dispatch_all(state->type, [&](auto tag) {
+            constexpr LogicalType LT = decltype(tag)::value;
+            const auto* values = static_cast<const RunTimeColumnType<LT>*>(data);
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (nulls != nullptr && (*nulls)[i]) {
+                    state->num_nulls++;
+                    continue;
+                }
+                if constexpr (is_binary_type(LT)) {
+                    Slice value = values->get_slice(i);
+                    _add_value(state, slice_value(value), HashUtil::hash_bytes(value.data, value.size), value.size);
+                } else {
+                    RunTimeCppType<LT> value = values->get_data()[i];
+                    uint64_t bits = 0;
+                    memcpy(&bits, &value, sizeof(value));
+                    _add_value(state, static_cast<double>(value), HashUtil::hash64(bits), sizeof(value));
+                }
+            }
+        });
+    }
+}
+
+TableStatistics TableStatisticsBuilder::finish() const {
+    TableStatistics stats;
+    stats.row_count = _row_count;
+    for (const auto& state : _columns) {
+        ColumnStatistics column;
+        if (_row_count > 0) {
+            column.null_fraction = static_cast<double>(state.num_nulls) / static_cast<double>(_row_count);
+        }
+        if (state.num_values > 0) {
+            // The sketch is off by a few percent either way.
+            column.ndv = std::clamp(static_cast<double>(state.distinct.estimate()), 1.0,
+                                    static_cast<double>(state.num_values));
+            column.min = state.min;
+            column.max = state.max;
+            column.avg_size = state.total_size / static_cast<double>(state.num_values);
+            column.histogram =
+                    Histogram::build(state.sample, static_cast<size_t>(std::max(_options.histogram_buckets, 0)));
+        }
+        stats.columns.push_back(std::move(column));
+    }
+    return stats;
+}
+
+StatusOr<TableStatistics> collect_table_statistics(const TableSource& table, const StatisticsOptions& options) {
+    const RowDescriptor& schema = table.schema();
+    TableStatisticsBuilder builder(schema, options);
+    std::vector<uint32_t> columns;
+    std::vector<SlotId> slot_ids;
+    for (size_t c = 0; c < schema.size(); ++c) {
+        columns.push_back(static_cast<uint32_t>(c));
+        slot_ids.push_back(static_cast<SlotId>(c));
+    }
+    RETURN_IF_ERROR(table.scan(columns, slot_ids, nullptr, [&](const ChunkPtr& chunk) {
+        builder.add_chunk(*chunk);
+        return Status::OK();
+    }));
+    return builder.finish();
+}
+
+} // namespace starrocks
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "column/chunk.h"
+#include "column/datum.h"
+#include "common/config.h"
+#include "mv/table_source.h"
+#include "util/hyperloglog.h"
+
+namespace starrocks {
+
+// The position of |value| of |type| on the line the statistics of a column
+// are kept on: numbers, dates and datetimes are themselves, strings are
+// their first eight bytes read as a big-endian integer, which keeps their
+// order save for ties.
+double statistics_value(LogicalType type, const Datum& value);
+
+// Equi-height histogram over the non-null values of a column: each bucket
+// holds about as many values, so frequent values get narrow buckets. A value
+// is never split across two buckets.
+class Histogram {
+public:
+    struct Bucket {
+        double lower = 0;
+        double upper = 0;
+        // Fractions of the non-null values within the bucket, and equal to
+        // |upper|.
+        double count = 0;
+        double upper_count = 0;
+        // Distinct values within the bucket.
+        double ndv = 0;
+    };
+
+    Histogram() = default;
+    explicit Histogram(std::vector<Bucket> buckets) : _buckets(std::move(buckets)) {}
+
+    // The histogram of a sample of the values, in at most |num_buckets|
+    // buckets.
+    static Histogram build(std::vector<double> values, size_t num_buckets);
+
+    bool empty() const { return _buckets.empty(); }
+    const std::vector<Bucket>& buckets() const { return _buckets; }
+
+    // Fraction of the values equal to |value|.
+    double equal_fraction(double value) const;
+    // Fraction of the values less than |value|, or equal too with
+    // |inclusive|; values within a bucket are taken as evenly spread.
+    double less_fraction(double value, bool inclusive) const;
+
+private:
+    std::vector<Bucket> _buckets;
+};
+
+struct ColumnStatistics {
+    double null_fraction = 0;
+    // Distinct non-null values; 0 for a column of NULLs.
+    double ndv = 0;
+    // Of the non-null values, as statistics_value().
+    double min = 0;
+    double max = 0;
+    // Bytes per value.
+    double avg_size = 8;
+    Histogram histogram;
+
+    // Fractions of the rows equal to |value|, and within the bounds given,
+    // each included with its flag. NULL is in no range.
+    double equal_selectivity(double value) const;
+    double range_selectivity(const double* lower, bool lower_inclusive, const double* upper,
+                             bool upper_inclusive) const;
+};
+
+struct TableStatistics {
+    int64_t row_count = 0;
+    // In the order of the table's columns.
+    std::vector<ColumnStatistics> columns;
+};
+
+using TableStatisticsPtr = std::shared_ptr<const TableStatistics>;
+
+struct StatisticsOptions {
+    // Values sampled per column for its histogram.
+    int64_t sample_rows = config::optimizer_statistics_sample_rows;
+    int32_t histogram_buckets = config::optimizer_histogram_buckets;
+};
+
+// Gathers the statistics of a table from its rows, a chunk at a time: exact
+// row and null counts, sizes and bounds, a HyperLogLog of the distinct
+// values and a histogram of a uniform (reservoir) sample of the values of
+// each column.
+class TableStatisticsBuilder {
+public:
+    TableStatisticsBuilder(RowDescriptor schema, StatisticsOptions options = {});
+
+    // The columns of |chunk| are those of the schema, in order.
+    void add_chunk(const Chunk& chunk);
+
+    TableStatistics finish() const;
+
+private:
+    struct ColumnState {
+        explicit ColumnState(LogicalType type) : type(type) {}
+
+        LogicalType type;
+        int64_t num_nulls = 0;
+        int64_t num_values = 0;
+        double total_size = 0;
+        double min = 0;
+        double max = 0;
+        HyperLogLog distinct;
+        std::vector<double> sample;
+    };
+
+    void _add_value(ColumnState* state, double value, uint64_t hash, size_t size);
+
+    const RowDescriptor _schema;
+    const StatisticsOptions _options;
+    std::mt19937_64 _random{0};
+    int64_t _row_count = 0;
+    std::vector<ColumnState> _columns;
+};
+
+// The statistics of every column of |table|, from a full scan.
+StatusOr<TableStatistics> collect_table_statistics(const TableSource& table, const StatisticsOptions& options = {});
+
+} // namespace starrocks
@@ -0,0 +1,124 @@
+#include "runtime/arena.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace starrocks {
+
+static void* aligned_system_alloc(size_t size) {
+    return std::aligned_alloc(COLUMN_BUFFER_ALIGNMENT,
+                              (size + COLUMN_BUFFER_ALIGNMENT - 1) & ~(COLUMN_BUFFER_ALIGNMENT - 1));
+}
+
+Arena::~Arena() {
+    for (void* block : _blocks) {
+        std::free(block);
+    }
+}
+
+int Arena::size_class(size_t size) {
+    if (size <= kMinAllocSize) {
+        return 0;
+    }
+    // ceil(log2(size)) - log2(kMinAllocSize)
+    return 64 - __builtin_clzl(size - 1) - 6;
+}
+
+size_t Arena::alloc_size(size_t size) {
+    if (size > kMaxPooledSize) {
+        return (size + COLUMN_BUFFER_ALIGNMENT - 1) & ~(COLUMN_BUFFER_ALIGNMENT - 1);
+    }
+    return kMinAllocSize << size_class(size);
+}
+
+void Arena::_update_peak(size_t now) {
+    size_t peak = _peak_allocated_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !_peak_allocated_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void* Arena::_allocate_from_block(size_t size) {
+    if (static_cast<size_t>(_block_end - _block_pos) < size) {
+        // The tail of the current block is donated to the free lists so it is
+        // not lost; every size class is a multiple of the minimum alignment.
+        while (_block_end - _block_pos >= static_cast<ptrdiff_t>(kMinAllocSize)) {
+            size_t remain = _block_end - _block_pos;
+            size_t chunk = kMinAllocSize << (63 - __builtin_clzl(remain / kMinAllocSize));
+            int cls = size_class(chunk);
+            auto* node = reinterpret_cast<FreeNode*>(_block_pos);
+            node->next = _free_lists[cls];
+            _free_lists[cls] = node;
+            _block_pos += chunk;
+        }
+        void* block = aligned_system_alloc(kBlockSize);
+        if (block == nullptr) {
+            return nullptr;
+        }
+        _blocks.push_back(block);
+        _reserved_bytes.fetch_add(kBlockSize, std::memory_order_relaxed);
+        _block_pos = static_cast<uint8_t*>(block);
+        _block_end = _block_pos + kBlockSize;
+    }
+    void* res = _block_pos;
+    _block_pos += size;
+    return res;
+}
+
+void* Arena::allocate(size_t size) {
+    size_t bytes = alloc_size(size);
+    void* res = nullptr;
+    if (bytes > kMaxPooledSize) {
+        res = aligned_system_alloc(bytes);
+        if (res == nullptr) {
+            return nullptr;
+        }
+        _reserved_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+        int cls = size_class(bytes);
+        std::lock_guard<std::mutex> l(_lock);
+        if (_free_lists[cls] != nullptr) {
+            FreeNode* node = _free_lists[cls];
+            _free_lists[cls] = node->next;
+            res = node;
+        } else {
+            res = _allocate_from_block(bytes);
+            if (res == nullptr) {
+                return nullptr;
+            }
+        }
+    }
+    _update_peak(_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    return res;
+}
+
+void Arena::free(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    size_t bytes = alloc_size(size);
+    _allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    if (bytes > kMaxPooledSize) {
+        std::free(ptr);
+        _reserved_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        return;
+    }
+    int cls = size_class(bytes);
+    std::lock_guard<std::mutex> l(_lock);
+    auto* node = static_cast<FreeNode*>(ptr);
+    node->next = _free_lists[cls];
+    _free_lists[cls] = node;
+}
+
+void* Arena::reallocate(void* ptr, size_t old_size, size_t new_size) {
+    if (ptr != nullptr && alloc_size(old_size) == alloc_size(new_size)) {
+        return ptr;
+    }
+    void* res = allocate(new_size);
+    if (res != nullptr && ptr != nullptr) {
+        memcpy(res, ptr, old_size < new_size ? old_size : new_size);
+        free(ptr, old_size);
+    }
+    return res;
+}
+
+} // namespace starrocks
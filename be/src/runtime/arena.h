@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "common/constexpr.h"
+
+namespace starrocks {
+
+// Arena is a per-query memory pool that backs column buffers, hash tables and
+// aggregate states.
+//
+// Memory is carved out of large 64-byte-aligned blocks. Freed allocations are
+// kept on power-of-two size-class free lists and handed out again, so a query
+// that streams millions of chunks through its operators reaches a steady state
+// without calling malloc per chunk (let alone per row). Allocations above
+// kMaxPooledSize bypass the pool and go straight to the system allocator.
+//
+// Every allocation is at least COLUMN_BUFFER_ALIGNMENT aligned. The arena is
+// thread-safe: operators of the same query run on different pipeline workers.
+// All memory is returned to the system when the arena is destroyed, so it must
+// outlive every buffer allocated from it.
+class Arena {
+public:
+    static constexpr size_t kMinAllocSize = COLUMN_BUFFER_ALIGNMENT;
+    static constexpr size_t kMaxPooledSize = 1UL << 20;
+    static constexpr size_t kBlockSize = 4UL << 20;
+
+    Arena() = default;
+    ~Arena();
+
+    DISALLOW_COPY_AND_MOVE(Arena);
+
+    // Returns at least |size| bytes, 64-byte aligned. Returns nullptr only if
+    // the system allocator fails.
+    void* allocate(size_t size);
+
+    // Returns memory obtained from allocate(). |size| must be the size that was
+    // requested when the memory was allocated.
+    void free(void* ptr, size_t size);
+
+    // Grows an allocation, copying |old_size| bytes. The old block is released.
+    void* reallocate(void* ptr, size_t old_size, size_t new_size);
+
+    // Bytes handed out to callers and not yet freed (rounded to size classes).
+    size_t allocated_bytes() const { return _allocated_bytes.load(std::memory_order_relaxed); }
+    // Bytes held from the system allocator, including free-list caches.
+    size_t reserved_bytes() const { return _reserved_bytes.load(std::memory_order_relaxed); }
+    size_t peak_allocated_bytes() const { return _peak_allocated_bytes.load(std::memory_order_relaxed); }
+
+    // Rounds |size| to the granularity used for the allocation.
+    static size_t alloc_size(size_t size);
+
+private:
+    static constexpr int kNumSizeClasses = 15; // 64B .. 1MB
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    static int size_class(size_t size);
+
+    void* _allocate_from_block(size_t size);
+    void _update_peak(size_t now);
+
+    std::mutex _lock;
+    FreeNode* _free_lists[kNumSizeClasses] = {};
+    std::vector<void*> _blocks;
+    uint8_t* _block_pos = nullptr;
+    uint8_t* _block_end = nullptr;
+
+    std::atomic<size_t> _allocated_bytes{0};
+    std::atomic<size_t> _reserved_bytes{0};
+    std::atomic<size_t> _peak_allocated_bytes{0};
+};
+
+} // namespace starrocks
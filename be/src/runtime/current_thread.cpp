@@ -0,0 +1,27 @@
+#include "runtime/current_thread.h"
+
+#include "common/config.h"
+#include "runtime/mem_tracker.h"
+
+namespace starrocks {
+
+void CurrentThread::_flush(State& s) {
+    // Frees on a thread working for nobody are dropped: whichever tracker was
+    // charged for the memory gives it back when it is destroyed.
+    if (s.tracker != nullptr && s.cached != 0) {
+        s.tracker->consume(s.cached);
+    }
+    s.cached = 0;
+    s.batch_bytes = s.tracker == nullptr ? INT64_MAX : config::mem_tracker_thread_cache_bytes;
+}
+
+MemTracker* CurrentThread::set_mem_tracker(MemTracker* tracker) {
+    State& s = _state;
+    MemTracker* prev = s.tracker;
+    _flush(s);
+    s.tracker = tracker;
+    s.batch_bytes = tracker == nullptr ? INT64_MAX : config::mem_tracker_thread_cache_bytes;
+    return prev;
+}
+
+} // namespace starrocks
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+class MemTracker;
+
+// Per-thread memory accounting. Allocations are charged to the thread's
+// current MemTracker, but only through a thread-local counter that is
+// flushed to the tracker tree once it drifts config::
+// mem_tracker_thread_cache_bytes away from zero, so a thread allocating
+// column buffers in a loop touches the shared atomics once per batch instead
+// of once per allocation. Trackers therefore lag each thread by up to one
+// batch.
+class CurrentThread {
+public:
+    static void mem_consume(int64_t bytes) {
+        State& s = _state;
+        s.cached += bytes;
+        if (UNLIKELY(s.cached >= s.batch_bytes || s.cached <= -s.batch_bytes)) {
+            _flush(s);
+        }
+    }
+    static void mem_release(int64_t bytes) { mem_consume(-bytes); }
+
+    static MemTracker* mem_tracker() { return _state.tracker; }
+    // Flushes the cached delta to the current tracker and installs |tracker|;
+    // returns the previous one. nullptr stops accounting on this thread.
+    static MemTracker* set_mem_tracker(MemTracker* tracker);
+    // Pushes the cached delta to the current tracker.
+    static void flush_mem() { _flush(_state); }
+
+private:
+    // Zero-initialized like any thread_local; a batch of 0 makes the first
+    // call flush and set the real batch size.
+    struct State {
+        MemTracker* tracker;
+        int64_t cached;
+        int64_t batch_bytes;
+    };
+
+    static void _flush(State& s);
+
+    static inline thread_local State _state;
+};
+
+// Installs |tracker| on the current thread for the scope, e.g. while a
+// driver runs or an I/O task works for a fragment.
+class ScopedThreadMemTracker {
+public:
+    explicit ScopedThreadMemTracker(MemTracker* tracker) : _prev(CurrentThread::set_mem_tracker(tracker)) {}
+    ~ScopedThreadMemTracker() { CurrentThread::set_mem_tracker(_prev); }
+
+    DISALLOW_COPY_AND_MOVE(ScopedThreadMemTracker);
+
+private:
+    MemTracker* _prev;
+};
+
+} // namespace starrocks
@@ -0,0 +1,15 @@
+#include "runtime/descriptors.h"
+
+#include "column/column_helper.h"
+
+namespace starrocks {
+
+ChunkPtr create_chunk_for_row_desc(const RowDescriptor& desc, bool force_nullable, Arena* arena) {
+    auto chunk = std::make_shared<Chunk>();
+    for (const auto& slot : desc) {
+        chunk->append_column(ColumnHelper::create_column(slot.type, slot.nullable || force_nullable, arena), slot.id);
+    }
+    return chunk;
+}
+
+} // namespace starrocks
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "column/chunk.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+// A column produced by some plan node, identified by its slot id.
+struct SlotDescriptor {
+    SlotId id;
+    LogicalType type;
+    bool nullable;
+    // The id() of the GlobalDictionary whose codes an INT slot carries in
+    // place of a VARCHAR column's values; 0 for any other slot.
+    uint64_t dict_id = 0;
+};
+
+// Ordered layout of the chunks flowing out of a plan node.
+using RowDescriptor = std::vector<SlotDescriptor>;
+
+// Creates an empty chunk with one column per slot of |desc|, in order.
+// |force_nullable| wraps every column in a NullableColumn (outer join sides).
+ChunkPtr create_chunk_for_row_desc(const RowDescriptor& desc, bool force_nullable = false, Arena* arena = nullptr);
+
+} // namespace starrocks
@@ -0,0 +1,95 @@
+#include "runtime/exec_env.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "exec/pipeline/exchange/exchange_transport.h"
+#include "exec/pipeline/pipeline_driver_executor.h"
+#include "exec/runtime_filter_worker.h"
+#include "mv/mv_manager.h"
+#include "mv/query_cache.h"
+#include "storage/compaction.h"
+#include "util/cpu_info.h"
+#include "util/mem_info.h"
+
+namespace starrocks {
+
+ExecEnv* ExecEnv::GetInstance() {
+    static ExecEnv s_exec_env;
+    return &s_exec_env;
+}
+
+static int64_t process_mem_limit() {
+    return config::mem_limit > 0 ? config::mem_limit : MemInfo::physical_mem() / 10 * 9;
+}
+
+ExecEnv::ExecEnv()
+        : _process_mem_tracker(std::make_unique<MemTracker>(MemTracker::Type::PROCESS, process_mem_limit(), "process")),
+          _exchange_transport(std::make_unique<pipeline::LoopbackTransport>()) {}
+
+ExecEnv::~ExecEnv() {
+    stop();
+}
+
+Status ExecEnv::init() {
+    if (_initialized) {
+        return Status::OK();
+    }
+    _process_mem_tracker->set_limit(process_mem_limit());
+    if (config::block_cache_enable && _block_cache == nullptr) {
+        BlockCacheOptions options;
+        options.mem_capacity_bytes = config::block_cache_mem_size;
+        options.disk_capacity_bytes = config::block_cache_disk_size;
+        options.disk_path = config::block_cache_disk_path;
+        options.block_size = config::block_cache_block_size;
+        options.lru_k = config::block_cache_lru_k;
+        options.correlated_reference_period_ns = config::block_cache_correlated_reference_period_ms * 1000000;
+        ASSIGN_OR_RETURN(_block_cache, BlockCache::create(std::move(options), _process_mem_tracker.get()));
+    }
+    if (config::query_cache_enable && _query_cache == nullptr) {
+        _query_cache = std::make_unique<QueryCache>(config::query_cache_capacity, _process_mem_tracker.get());
+    }
+    int num_cores = CpuInfo::num_cores();
+    int exec_threads = config::pipeline_exec_thread_pool_thread_num > 0 ? config::pipeline_exec_thread_pool_thread_num
+                                                                        : num_cores;
+    int io_threads = config::scan_io_thread_num > 0 ? config::scan_io_thread_num : 2 * num_cores;
+    int spill_threads = config::spill_io_thread_num > 0 ? config::spill_io_thread_num : num_cores;
+    int parse_threads = config::stream_load_parse_thread_num > 0 ? config::stream_load_parse_thread_num : num_cores;
+
+    _scan_io_thread_pool = std::make_unique<ThreadPool>("scan_io", io_threads);
+    _spill_io_thread_pool = std::make_unique<ThreadPool>("spill_io", spill_threads);
+    _stream_load_thread_pool = std::make_unique<ThreadPool>("stream_load", parse_threads);
+    _memtable_flush_thread_pool =
+            std::make_unique<ThreadPool>("memtable_flush", std::max(config::memtable_flush_thread_num, 1));
+    _async_io_engine = io::create_async_io_engine();
+    _runtime_filter_worker = std::make_unique<RuntimeFilterWorker>(config::runtime_filter_worker_thread_num);
+    _driver_executor = std::make_unique<pipeline::PipelineDriverExecutor>(exec_threads);
+    _driver_executor->start();
+    _compaction_manager = std::make_unique<CompactionManager>();
+    RETURN_IF_ERROR(_compaction_manager->start());
+    _mv_manager = std::make_unique<MaterializedViewManager>();
+    RETURN_IF_ERROR(_mv_manager->start());
+    _initialized = true;
+    return Status::OK();
+}
+
+void ExecEnv::stop() {
+    if (!_initialized) {
+        return;
+    }
+    _mv_manager->stop();
+    _compaction_manager->stop();
+    // Drivers may be waiting on scan or spill I/O, so stop the executor first.
+    _driver_executor->close();
+    _scan_io_thread_pool->shutdown();
+    // After the scan tasks, which issue the reads.
+    _async_io_engine->shutdown();
+    _spill_io_thread_pool->shutdown();
+    // Parse tasks feed the flushes.
+    _stream_load_thread_pool->shutdown();
+    _memtable_flush_thread_pool->shutdown();
+    _runtime_filter_worker->shutdown();
+    _initialized = false;
+}
+
+} // namespace starrocks
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+
+#include "block_cache/block_cache.h"
+#include "common/status.h"
+#include "io/async_io.h"
+#include "runtime/mem_tracker.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+namespace pipeline {
+class ExchangeTransport;
+class PipelineDriverExecutor;
+} // namespace pipeline
+class CompactionManager;
+class MaterializedViewManager;
+class QueryCache;
+class RuntimeFilterWorker;
+
+// Process-wide execution resources shared by all queries: the pipeline
+// driver executor, the thread pools serving scan I/O, spill I/O and loads, the
+// asynchronous read engine, the block cache of lake table data, the delivery
+// of runtime filters and exchanged rows between fragment instances, the
+// background compaction of primary-key tables, the materialized views, the
+// cache of partial query results, and the root of the memory tracker tree.
+class ExecEnv {
+public:
+    static ExecEnv* GetInstance();
+
+    // Creates and starts the resources, sized from config. Idempotent.
+    Status init();
+    void stop();
+
+    pipeline::PipelineDriverExecutor* driver_executor() const { return _driver_executor.get(); }
+    ThreadPool* scan_io_thread_pool() const { return _scan_io_thread_pool.get(); }
+    ThreadPool* spill_io_thread_pool() const { return _spill_io_thread_pool.get(); }
+    // Parse the text of stream loads, and flush their memtables.
+    ThreadPool* stream_load_thread_pool() const { return _stream_load_thread_pool.get(); }
+    ThreadPool* memtable_flush_thread_pool() const { return _memtable_flush_thread_pool.get(); }
+    io::AsyncIoEngine* async_io_engine() const { return _async_io_engine.get(); }
+    // nullptr when config::block_cache_enable is off.
+    BlockCache* block_cache() const { return _block_cache.get(); }
+    // nullptr before init().
+    RuntimeFilterWorker* runtime_filter_worker() const { return _runtime_filter_worker.get(); }
+    // Carries the packets of exchanges between the fragment instances of the
+    // process. Exists before init().
+    pipeline::ExchangeTransport* exchange_transport() const { return _exchange_transport.get(); }
+    // nullptr before init().
+    CompactionManager* compaction_manager() const { return _compaction_manager.get(); }
+    // nullptr before init().
+    MaterializedViewManager* mv_manager() const { return _mv_manager.get(); }
+    // nullptr when config::query_cache_enable is off.
+    QueryCache* query_cache() const { return _query_cache.get(); }
+    // Exists before init() so that queries can always be tracked.
+    MemTracker* process_mem_tracker() const { return _process_mem_tracker.get(); }
+
+private:
+    ExecEnv();
+    ~ExecEnv();
+
+    bool _initialized = false;
+    std::unique_ptr<MemTracker> _process_mem_tracker;
+    std::unique_ptr<pipeline::PipelineDriverExecutor> _driver_executor;
+    std::unique_ptr<ThreadPool> _scan_io_thread_pool;
+    std::unique_ptr<ThreadPool> _spill_io_thread_pool;
+    std::unique_ptr<ThreadPool> _stream_load_thread_pool;
+    std::unique_ptr<ThreadPool> _memtable_flush_thread_pool;
+    std::unique_ptr<io::AsyncIoEngine> _async_io_engine;
+    std::unique_ptr<BlockCache> _block_cache;
+    std::unique_ptr<RuntimeFilterWorker> _runtime_filter_worker;
+    std::unique_ptr<pipeline::ExchangeTransport> _exchange_transport;
+    std::unique_ptr<CompactionManager> _compaction_manager;
+    std::unique_ptr<MaterializedViewManager> _mv_manager;
+    std::unique_ptr<QueryCache> _query_cache;
+};
+
+} // namespace starrocks
@@ -0,0 +1,53 @@
+#include "runtime/mem_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/constexpr.h"
+#include "runtime/arena.h"
+#include "runtime/current_thread.h"
+
+namespace starrocks {
+
+uint8_t* MemPool::_allocate_from_new_chunk(size_t size) {
+    // Chunks start 64-byte aligned, which covers every supported alignment.
+    size_t chunk_size = std::max(_next_chunk_size, size);
+    void* data;
+    if (_arena != nullptr) {
+        data = _arena->allocate(chunk_size);
+    } else {
+        data = std::aligned_alloc(COLUMN_BUFFER_ALIGNMENT,
+                                  (chunk_size + COLUMN_BUFFER_ALIGNMENT - 1) & ~(COLUMN_BUFFER_ALIGNMENT - 1));
+    }
+    if (data == nullptr) {
+        return nullptr;
+    }
+    CurrentThread::mem_consume(chunk_size);
+    _chunks.push_back({static_cast<uint8_t*>(data), chunk_size});
+    _reserved_bytes += chunk_size;
+    _next_chunk_size = std::min(_next_chunk_size * 2, kMaxChunkSize);
+
+    _pos = static_cast<uint8_t*>(data) + size;
+    _end = static_cast<uint8_t*>(data) + chunk_size;
+    _allocated_bytes += size;
+    return static_cast<uint8_t*>(data);
+}
+
+void MemPool::clear() {
+    for (const auto& chunk : _chunks) {
+        if (_arena != nullptr) {
+            _arena->free(chunk.data, chunk.size);
+        } else {
+            std::free(chunk.data);
+        }
+        CurrentThread::mem_release(chunk.size);
+    }
+    _chunks.clear();
+    _pos = nullptr;
+    _end = nullptr;
+    _next_chunk_size = kInitialChunkSize;
+    _allocated_bytes = 0;
+    _reserved_bytes = 0;
+}
+
+} // namespace starrocks
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+class Arena;
+
+// Single-threaded bump allocator for many small objects that die together,
+// such as the aggregate states and copied keys of one hash table.
+//
+// Memory is taken from an Arena (or the heap) in chunks that double in size
+// up to kMaxChunkSize and is only given back, all at once, by clear() or the
+// destructor; allocating is a pointer bump. Chunks are charged to the
+// allocating thread's MemTracker, like Buffer memory.
+class MemPool {
+public:
+    static constexpr size_t kInitialChunkSize = 4 * 1024;
+    static constexpr size_t kMaxChunkSize = 512 * 1024;
+
+    explicit MemPool(Arena* arena = nullptr) : _arena(arena) {}
+    ~MemPool() { clear(); }
+
+    DISALLOW_COPY_AND_MOVE(MemPool);
+
+    // Returns |size| bytes aligned to |alignment|, a power of two of at most
+    // 64. Returns nullptr only if the underlying allocator fails.
+    uint8_t* allocate(size_t size, size_t alignment = 16) {
+        auto pos = reinterpret_cast<uintptr_t>(_pos);
+        uintptr_t aligned = (pos + alignment - 1) & ~(alignment - 1);
+        if (LIKELY(_pos != nullptr && aligned + size <= reinterpret_cast<uintptr_t>(_end))) {
+            _pos = reinterpret_cast<uint8_t*>(aligned + size);
+            _allocated_bytes += size;
+            return reinterpret_cast<uint8_t*>(aligned);
+        }
+        return _allocate_from_new_chunk(size);
+    }
+
+    // Releases every chunk.
+    void clear();
+
+    // Bytes handed out since the last clear().
+    size_t allocated_bytes() const { return _allocated_bytes; }
+    // Bytes of the chunks held.
+    size_t reserved_bytes() const { return _reserved_bytes; }
+
+private:
+    struct MemChunk {
+        uint8_t* data;
+        size_t size;
+    };
+
+    uint8_t* _allocate_from_new_chunk(size_t size);
+
+    Arena* const _arena;
+    std::vector<MemChunk> _chunks;
+    uint8_t* _pos = nullptr;
+    uint8_t* _end = nullptr;
+    size_t _next_chunk_size = kInitialChunkSize;
+    size_t _allocated_bytes = 0;
+    size_t _reserved_bytes = 0;
+};
+
+} // namespace starrocks
@@ -0,0 +1,114 @@
+#include "runtime/mem_tracker.h"
+
+namespace starrocks {
+
+const char* mem_tracker_type_name(MemTracker::Type type) {
+    switch (type) {
+    case MemTracker::Type::PROCESS:
+        return "process";
+    case MemTracker::Type::QUERY:
+        return "query";
+    case MemTracker::Type::FRAGMENT:
+        return "fragment";
+    case MemTracker::Type::OPERATOR:
+        return "operator";
+    }
+    return "unknown";
+}
+
+MemTracker::MemTracker(Type type, int64_t limit, std::string label, MemTracker* parent)
+        : _type(type), _label(std::move(label)), _parent(parent), _limit(limit) {
+    if (_parent != nullptr) {
+        std::lock_guard<std::mutex> l(_parent->_child_lock);
+        _child_it = _parent->_children.insert(_parent->_children.end(), this);
+    }
+}
+
+MemTracker::~MemTracker() {
+    if (_parent == nullptr) {
+        return;
+    }
+    if (_type != Type::OPERATOR) {
+        _parent->release(consumption());
+    }
+    std::lock_guard<std::mutex> l(_parent->_child_lock);
+    _parent->_children.erase(_child_it);
+}
+
+void MemTracker::consume(int64_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    for (MemTracker* tracker = this; tracker != nullptr; tracker = tracker->_parent) {
+        int64_t now = tracker->_consumption.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        if (bytes > 0) {
+            int64_t peak = tracker->_peak_consumption.load(std::memory_order_relaxed);
+            while (now > peak &&
+                   !tracker->_peak_consumption.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+            }
+        }
+        if (tracker->_type == Type::OPERATOR) {
+            break;
+        }
+    }
+}
+
+MemTracker* MemTracker::find_limit_exceeded_tracker() {
+    for (MemTracker* tracker = this; tracker != nullptr; tracker = tracker->_parent) {
+        if (tracker->limit_exceeded()) {
+            return tracker;
+        }
+    }
+    return nullptr;
+}
+
+MemTracker* MemTracker::largest_operator_tracker() {
+    MemTracker* largest = _type == Type::OPERATOR ? this : nullptr;
+    std::lock_guard<std::mutex> l(_child_lock);
+    for (MemTracker* child : _children) {
+        MemTracker* candidate = child->largest_operator_tracker();
+        if (candidate != nullptr && (largest == nullptr || candidate->consumption() > largest->consumption())) {
+            largest = candidate;
+        }
+    }
+    return largest;
+}
+
+Status MemTracker::limit_exceeded_status(MemTracker* exceeded) {
+    std::string msg = std::string(mem_tracker_type_name(exceeded->type())) + " " + exceeded->label() +
+                      " uses " + std::to_string(exceeded->consumption()) + " bytes, over its limit of " +
+                      std::to_string(exceeded->limit());
+    // The process tracker spans every query; blame an operator of this one.
+    MemTracker* largest = largest_operator_tracker();
+    if (largest != nullptr) {
+        msg += "; largest operator: " + largest->label() + " with " + std::to_string(largest->consumption()) +
+               " bytes";
+    }
+    return Status::MemoryLimitExceeded(msg);
+}
+
+std::string MemTracker::debug_string(int max_depth) const {
+    std::string out;
+    _debug_string(0, max_depth, &out);
+    return out;
+}
+
+void MemTracker::_debug_string(int depth, int max_depth, std::string* out) const {
+    out->append(depth * 2, ' ');
+    out->append(mem_tracker_type_name(_type)).append(" ").append(_label);
+    out->append(": consumption=").append(std::to_string(consumption()));
+    out->append(" peak=").append(std::to_string(peak_consumption()));
+    if (has_limit()) {
+        out->append(" limit=").append(std::to_string(limit()));
+    }
+    out->append("\n");
+    if (depth + 1 >= max_depth) {
+        return;
+    }
+    std::lock_guard<std::mutex> l(_child_lock);
+    for (const MemTracker* child : _children) {
+        child->_debug_string(depth + 1, max_depth, out);
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include "common/compiler_util.h"
+#include "common/status.h"
+
+namespace starrocks {
+
+// Tree of memory counters: process -> query -> fragment instance -> operator.
+//
+// Process, query and fragment trackers form the accounting chain: consuming
+// on one charges it and all its ancestors, so each level sees the total of
+// its subtree, and each may carry a limit. Column buffers are charged to the
+// tracker of the thread that allocates them through the thread-local batched
+// counters of CurrentThread; pipeline drivers run with their fragment's
+// tracker installed.
+//
+// Operator trackers attribute memory within a fragment: an operator holding
+// large state (a hash table, spill buffers) reports its size there so that a
+// query going over its budget can name the operator responsible. That memory
+// is already charged to the fragment by the allocation hooks, so operator
+// trackers keep their count to themselves instead of propagating it.
+//
+// A tracker releases whatever it still accounts for from its ancestors when
+// it is destroyed, so frees that happen after a query ended (or on another
+// thread) do not leave the process counter drifting.
+class MemTracker {
+public:
+    enum class Type {
+        PROCESS,
+        QUERY,
+        FRAGMENT,
+        OPERATOR,
+    };
+
+    // |limit| < 0 means unlimited.
+    MemTracker(Type type, int64_t limit, std::string label, MemTracker* parent = nullptr);
+    ~MemTracker();
+
+    DISALLOW_COPY_AND_MOVE(MemTracker);
+
+    void consume(int64_t bytes);
+    void release(int64_t bytes) { consume(-bytes); }
+    // Sets the consumption of an operator tracker to |bytes|.
+    void set(int64_t bytes) { consume(bytes - consumption()); }
+
+    Type type() const { return _type; }
+    const std::string& label() const { return _label; }
+    MemTracker* parent() const { return _parent; }
+
+    int64_t consumption() const { return _consumption.load(std::memory_order_relaxed); }
+    int64_t peak_consumption() const { return _peak_consumption.load(std::memory_order_relaxed); }
+    int64_t limit() const { return _limit.load(std::memory_order_relaxed); }
+    void set_limit(int64_t limit) { _limit.store(limit, std::memory_order_relaxed); }
+    bool has_limit() const { return limit() >= 0; }
+    bool limit_exceeded() const { return has_limit() && consumption() > limit(); }
+
+    // This tracker or the closest ancestor over its limit, or nullptr.
+    MemTracker* find_limit_exceeded_tracker();
+
+    // Operator tracker with the largest consumption in this subtree, or
+    // nullptr when there is none.
+    MemTracker* largest_operator_tracker();
+
+    // MemoryLimitExceeded naming |exceeded|, a tracker over its limit, and the
+    // operator of this subtree using the most memory.
+    Status limit_exceeded_status(MemTracker* exceeded);
+
+    // One line per tracker in this subtree, down to |max_depth| levels.
+    std::string debug_string(int max_depth = 4) const;
+
+private:
+    void _debug_string(int depth, int max_depth, std::string* out) const;
+
+    const Type _type;
+    const std::string _label;
+    MemTracker* const _parent;
+    std::atomic<int64_t> _limit;
+    std::atomic<int64_t> _consumption{0};
+    std::atomic<int64_t> _peak_consumption{0};
+
+    mutable std::mutex _child_lock;
+    std::list<MemTracker*> _children;
+    // Position in the parent's _children.
+    std::list<MemTracker*>::iterator _child_it;
+};
+
+const char* mem_tracker_type_name(MemTracker::Type type);
+
+} // namespace starrocks
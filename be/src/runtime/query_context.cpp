@@ -0,0 +1,72 @@
+#include "runtime/query_context.h"
+
+#include <filesystem>
+
+#include "common/config.h"
+#include "runtime/exec_env.h"
+
+namespace starrocks {
+
+QueryContext::QueryContext(std::string query_id)
+        : _query_id(std::move(query_id)),
+          _mem_tracker(std::make_unique<MemTracker>(MemTracker::Type::QUERY,
+                                                    config::query_mem_limit > 0 ? config::query_mem_limit : -1,
+                                                    _query_id, ExecEnv::GetInstance()->process_mem_tracker())) {}
+
+QueryContext::~QueryContext() {
+    if (!_spill_dir.empty()) {
+        std::error_code ec;
+        std::filesystem::remove_all(_spill_dir, ec);
+    }
+}
+
+void QueryContext::cancel(const Status& status) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_cancelled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    _cancel_status = status.ok() ? Status::Cancelled("query cancelled") : status;
+    _cancelled.store(true, std::memory_order_release);
+}
+
+Status QueryContext::cancel_status() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _cancel_status;
+}
+
+bool QueryContext::should_spill(int64_t extra_bytes) const {
+    return config::enable_spill && _mem_tracker->has_limit() &&
+           mem_usage() + extra_bytes > static_cast<int64_t>(_mem_tracker->limit() * config::spill_mem_limit_threshold);
+}
+
+Status QueryContext::admit() {
+    if (_admitted.load(std::memory_order_acquire)) {
+        return Status::OK();
+    }
+    MemTracker* process = _mem_tracker->parent();
+    if (process != nullptr && process->has_limit() &&
+        process->consumption() > static_cast<int64_t>(process->limit() * config::query_admission_mem_ratio)) {
+        return Status::MemoryLimitExceeded("query " + _query_id + " rejected: process memory usage " +
+                                           std::to_string(process->consumption()) + " is above " +
+                                           std::to_string(config::query_admission_mem_ratio) + " of its limit " +
+                                           std::to_string(process->limit()));
+    }
+    _admitted.store(true, std::memory_order_release);
+    return Status::OK();
+}
+
+StatusOr<std::string> QueryContext::spill_dir() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_spill_dir.empty()) {
+        std::string dir = config::spill_local_storage_dir + "/" + _query_id;
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (ec) {
+            return Status::IOError("failed to create spill dir " + dir + ": " + ec.message());
+        }
+        _spill_dir = std::move(dir);
+    }
+    return _spill_dir;
+}
+
+} // namespace starrocks
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/status.h"
+#include "runtime/arena.h"
+#include "runtime/mem_tracker.h"
+
+namespace starrocks {
+
+// State shared by every fragment instance of one query on this node: the
+// query's arena, its memory tracker and budget, and its cancellation flag.
+class QueryContext {
+public:
+    explicit QueryContext(std::string query_id);
+    ~QueryContext();
+
+    const std::string& query_id() const { return _query_id; }
+
+    Arena* arena() { return &_arena; }
+
+    // Memory budget, enforced on the query's MemTracker. Pipeline drivers fail
+    // the query once it goes over the budget; operators holding large state
+    // spill before that. A limit of 0 means unlimited.
+    MemTracker* mem_tracker() const { return _mem_tracker.get(); }
+    int64_t mem_limit() const { return std::max<int64_t>(_mem_tracker->limit(), 0); }
+    void set_mem_limit(int64_t limit) { _mem_tracker->set_limit(limit > 0 ? limit : -1); }
+    int64_t mem_usage() const { return _mem_tracker->consumption(); }
+    int64_t peak_mem_usage() const { return _mem_tracker->peak_consumption(); }
+    bool exceeds_mem_limit() const { return _mem_tracker->limit_exceeded(); }
+    // True once usage, plus |extra_bytes| about to be allocated, crosses
+    // config::spill_mem_limit_threshold of the budget and spilling is enabled.
+    bool should_spill(int64_t extra_bytes = 0) const;
+
+    // Admission control, run when a fragment of the query is prepared:
+    // rejects a query that has not started yet while the process uses more
+    // than config::query_admission_mem_ratio of its memory limit.
+    Status admit();
+
+    // Per-query directory for spill files, created on first use and removed
+    // with the query.
+    StatusOr<std::string> spill_dir();
+
+    // Cancels the query. The first non-OK status wins and is reported by
+    // cancel_status(); pipeline drivers observe the flag between chunks.
+    void cancel(const Status& status);
+    bool is_cancelled() const { return _cancelled.load(std::memory_order_acquire); }
+    Status cancel_status() const;
+
+private:
+    const std::string _query_id;
+    std::unique_ptr<MemTracker> _mem_tracker;
+    Arena _arena;
+    std::atomic<bool> _admitted{false};
+    std::string _spill_dir;
+    std::atomic<bool> _cancelled{false};
+    mutable std::mutex _lock;
+    Status _cancel_status;
+};
+
+using QueryContextPtr = std::shared_ptr<QueryContext>;
+
+} // namespace starrocks
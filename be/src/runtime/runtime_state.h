@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/constexpr.h"
+#include "runtime/query_context.h"
+
+namespace starrocks {
+
+namespace pipeline {
+class FragmentContext;
+}
+
+// Per-fragment-instance state handed to every operator call.
+class RuntimeState {
+public:
+    RuntimeState(QueryContext* query_ctx, pipeline::FragmentContext* fragment_ctx, MemTracker* instance_mem_tracker)
+            : _query_ctx(query_ctx), _fragment_ctx(fragment_ctx), _instance_mem_tracker(instance_mem_tracker) {}
+
+    QueryContext* query_ctx() const { return _query_ctx; }
+    pipeline::FragmentContext* fragment_ctx() const { return _fragment_ctx; }
+    // Tracker of this fragment instance; operator trackers hang off it.
+    MemTracker* instance_mem_tracker() const { return _instance_mem_tracker; }
+    Arena* arena() const { return _query_ctx->arena(); }
+
+    size_t chunk_size() const { return _chunk_size; }
+    void set_chunk_size(size_t chunk_size) { _chunk_size = chunk_size; }
+
+    bool is_cancelled() const { return _query_ctx->is_cancelled(); }
+
+private:
+    QueryContext* _query_ctx;
+    pipeline::FragmentContext* _fragment_ctx;
+    MemTracker* _instance_mem_tracker;
+    size_t _chunk_size = DEFAULT_CHUNK_SIZE;
+};
+
+} // namespace starrocks
@@ -0,0 +1,354 @@
+#include "runtime/stream_load.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "column/column_helper.h"
+#include "column/nullable_column.h"
+#include "common/config.h"
+#include "exprs/cast_expr.h"
+#include "formats/json_parser.h"
+#include "runtime/exec_env.h"
+#include "storage/compaction.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+StreamLoader::StreamLoader(StreamLoadOptions options)
+        : _options(std::move(options)), _sort_keys([this] {
+              SortDescs descs;
+              for (size_t k = 0; k < std::min(_options.num_key_columns, _options.schema.size()); ++k) {
+                  descs.push_back(SortDesc{_options.schema[k].id, true, true});
+              }
+              return descs;
+          }()) {}
+
+StreamLoader::~StreamLoader() {
+    if (!_finished) {
+        cancel();
+    }
+}
+
+StatusOr<std::unique_ptr<StreamLoader>> StreamLoader::create(StreamLoadOptions options) {
+    std::unique_ptr<StreamLoader> loader(new StreamLoader(std::move(options)));
+    RETURN_IF_ERROR(loader->_init());
+    return loader;
+}
+
+Status StreamLoader::_init() {
+    const RowDescriptor& schema = _options.schema;
+    if (schema.empty() || _options.num_key_columns == 0 || _options.num_key_columns > schema.size()) {
+        return Status::InvalidArgument("stream load of " + std::to_string(schema.size()) + " columns with " +
+                                       std::to_string(_options.num_key_columns) + " key columns");
+    }
+    if (_options.tablet_dirs.empty() == _options.tables.empty()) {
+        return Status::InvalidArgument("stream load needs either tablet directories or tables");
+    }
+    for (const auto& table : _options.tables) {
+        const RowDescriptor& table_schema = table->schema();
+        bool same_schema = table_schema.size() == schema.size();
+        for (size_t i = 0; same_schema && i < schema.size(); ++i) {
+            same_schema = table_schema[i].id == schema[i].id && table_schema[i].type == schema[i].type &&
+                          table_schema[i].nullable == schema[i].nullable;
+        }
+        if (!same_schema || table->num_key_columns() != _options.num_key_columns) {
+            return Status::InvalidArgument("stream load into the table in " + table->dir() +
+                                           ", which has other columns or keys");
+        }
+    }
+    if (_options.format == LoadFormat::CSV) {
+        const CsvFormatOptions& csv = _options.csv;
+        if (csv.column_separator == csv.row_delimiter || csv.enclose == csv.column_separator ||
+            csv.enclose == csv.row_delimiter) {
+            return Status::InvalidArgument("CSV separator, delimiter and enclose char must differ");
+        }
+        _parser = std::make_unique<CsvParser>(schema.size(), csv);
+        _header_rows_left = csv.skip_header;
+    } else {
+        if (_options.json_keys.size() != schema.size()) {
+            return Status::InvalidArgument("stream load of " + std::to_string(schema.size()) + " columns from " +
+                                           std::to_string(_options.json_keys.size()) + " JSON keys");
+        }
+        _parser = std::make_unique<JsonParser>(_options.json_keys);
+    }
+    RETURN_IF_ERROR(_sort_keys.prepare(schema));
+    for (const auto& slot : schema) {
+        ExprPtr cast;
+        if (slot.type != TYPE_VARCHAR) {
+            ASSIGN_OR_RETURN(cast, make_cast(make_column_ref(SlotDescriptor{slot.id, TYPE_VARCHAR, true}), slot.type));
+        }
+        _casts.push_back(std::move(cast));
+    }
+
+    ExecEnv* env = ExecEnv::GetInstance();
+    _parse_pool = env->stream_load_thread_pool();
+    ThreadPool* flush_pool = env->memtable_flush_thread_pool();
+    if (_parse_pool == nullptr || flush_pool == nullptr) {
+        return Status::InternalError("stream load before the ExecEnv is initialized");
+    }
+    // Enough blocks queued to keep every parse thread busy while the client
+    // sends the next ones.
+    _max_pending_blocks = 2 * _parse_pool->num_threads();
+    _cut_size = std::max<int64_t>(config::stream_load_block_bytes, 1);
+    for (const auto& dir : _options.tablet_dirs) {
+        _writers.push_back(std::make_unique<DeltaWriter>(dir, _options.label + "_", schema, &_sort_keys, flush_pool,
+                                                         _options.writer_options));
+    }
+    for (const auto& table : _options.tables) {
+        _writers.push_back(std::make_unique<DeltaWriter>(table->dir(), _options.label + "_", schema, &_sort_keys,
+                                                         flush_pool, _options.writer_options));
+        if (env->compaction_manager() != nullptr) {
+            env->compaction_manager()->register_table(table);
+        }
+    }
+    return Status::OK();
+}
+
+Status StreamLoader::append(const Slice& data) {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_finished) {
+            return Status::InternalError("append to a finished stream load");
+        }
+        RETURN_IF_ERROR(_status);
+    }
+    _bytes += data.size;
+    _block.append(reinterpret_cast<const uint8_t*>(data.data), data.size);
+    _skip_header();
+    while (_header_rows_left == 0 && _block.size() >= _cut_size) {
+        size_t end = _parser->whole_records_size(Slice(_block.data(), _block.size()));
+        if (end == 0) {
+            // A record longer than a block; wait for twice as much text
+            // rather than scanning it again for every piece.
+            _cut_size = 2 * _block.size();
+            break;
+        }
+        auto block = std::make_shared<Buffer<uint8_t>>();
+        block->append(_block.data() + end, _block.size() - end);
+        std::swap(*block, _block);
+        block->resize(end);
+        _cut_size = std::max<int64_t>(config::stream_load_block_bytes, 1);
+        RETURN_IF_ERROR(_submit(std::move(block)));
+    }
+    return Status::OK();
+}
+
+void StreamLoader::_skip_header() {
+    size_t skipped = 0;
+    while (_header_rows_left > 0) {
+        const void* end = memchr(_block.data() + skipped, _options.csv.row_delimiter, _block.size() - skipped);
+        if (end == nullptr) {
+            break;
+        }
+        skipped = static_cast<const uint8_t*>(end) - _block.data() + 1;
+        _header_rows_left--;
+    }
+    if (skipped > 0) {
+        Buffer<uint8_t> rest;
+        rest.append(_block.data() + skipped, _block.size() - skipped);
+        std::swap(rest, _block);
+    }
+}
+
+Status StreamLoader::_submit(std::shared_ptr<Buffer<uint8_t>> block) {
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _cv.wait(lock, [this] { return _pending_blocks < _max_pending_blocks || !_status.ok(); });
+        RETURN_IF_ERROR(_status);
+        _pending_blocks++;
+    }
+    int64_t seq = _num_blocks++;
+    Status st = _parse_pool->submit([this, block, seq] {
+        Status st = _load_block(Slice(block->data(), block->size()), seq);
+        // Notified under the lock: once it is released, finish() may return
+        // and the loader go away.
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!st.ok() && _status.ok()) {
+            _status = st;
+        }
+        _pending_blocks--;
+        _cv.notify_all();
+    });
+    if (!st.ok()) {
+        std::lock_guard<std::mutex> guard(_lock);
+        _pending_blocks--;
+    }
+    return st;
+}
+
+Status StreamLoader::_load_block(const Slice& block, int64_t seq) {
+    ParsedRecords records;
+    _parser->parse(block, &records);
+    ASSIGN_OR_RETURN(ChunkPtr chunk, _convert(&records));
+    if (records.num_invalid > 0) {
+        chunk->filter(records.valid);
+    }
+    RETURN_IF_ERROR(_write(*chunk));
+    std::lock_guard<std::mutex> guard(_lock);
+    _rows_loaded += chunk->num_rows();
+    if (records.num_invalid > 0 && seq < _first_error_block) {
+        _first_error = records.first_error;
+        _first_error_block = seq;
+    }
+    _rows_filtered += records.num_invalid;
+    return Status::OK();
+}
+
+StatusOr<ChunkPtr> StreamLoader::_convert(ParsedRecords* records) {
+    const RowDescriptor& schema = _options.schema;
+    size_t num_rows = records->valid.size();
+    Chunk fields;
+    for (size_t i = 0; i < schema.size(); ++i) {
+        fields.append_column(records->fields[i], schema[i].id);
+    }
+    ExprContext ctx;
+    auto chunk = std::make_shared<Chunk>();
+    uint8_t* valid = records->valid.data();
+    auto invalidate = [&](size_t row, std::string error) {
+        valid[row] = 0;
+        if (records->num_invalid++ == 0) {
+            records->first_error = std::move(error);
+        }
+    };
+    for (size_t i = 0; i < schema.size(); ++i) {
+        const SlotDescriptor& slot = schema[i];
+        const auto* field = static_cast<const NullableColumn*>(records->fields[i].get());
+        ColumnPtr column = records->fields[i];
+        if (_casts[i] != nullptr) {
+            ASSIGN_OR_RETURN(column, ctx.evaluate(_casts[i].get(), &fields));
+            column = ColumnHelper::unfold_const_column(slot.type, num_rows, column);
+        }
+        // A cast yields NULL for text it cannot convert, which only an empty
+        // field may.
+        const NullData* nulls = ColumnHelper::get_null_data(column.get());
+        const auto* text = static_cast<const BinaryColumn*>(field->data_column().get());
+        for (size_t r = 0; nulls != nullptr && r < num_rows; ++r) {
+            if (!valid[r] || !(*nulls)[r]) {
+                continue;
+            }
+            Slice value = text->get_slice(r);
+            if (!field->is_null(r) && value.size > 0) {
+                invalidate(r, "cannot convert '" + value.to_string() + "' to " + logical_type_to_string(slot.type) +
+                                      " for column " + std::to_string(i));
+            } else if (!slot.nullable) {
+                invalidate(r, "NULL for column " + std::to_string(i) + ", which is not nullable");
+            }
+        }
+        if (slot.nullable && !column->is_nullable()) {
+            column = NullableColumn::create(column, NullColumn::create(num_rows, uint8_t{0}));
+        } else if (!slot.nullable && column->is_nullable()) {
+            column = static_cast<const NullableColumn*>(column.get())->data_column();
+        }
+        chunk->append_column(std::move(column), slot.id);
+    }
+    return chunk;
+}
+
+Status StreamLoader::_write(const Chunk& chunk) {
+    size_t num_rows = chunk.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    size_t num_tablets = _writers.size();
+    std::vector<uint32_t> indexes(num_rows);
+    if (num_tablets == 1) {
+        for (size_t r = 0; r < num_rows; ++r) {
+            indexes[r] = static_cast<uint32_t>(r);
+        }
+        return _writers[0]->write(chunk, indexes.data(), 0, static_cast<uint32_t>(num_rows));
+    }
+    // Rows are grouped by tablet with a counting sort on the key hashes.
+    SortKeys keys;
+    _sort_keys.encode(chunk, &keys);
+    std::vector<uint32_t> tablets(num_rows);
+    std::vector<uint32_t> offsets(num_tablets + 1, 0);
+    for (size_t r = 0; r < num_rows; ++r) {
+        tablets[r] = HashUtil::hash_bytes(keys.data(r), keys.size(r)) % num_tablets;
+        offsets[tablets[r] + 1]++;
+    }
+    for (size_t t = 0; t < num_tablets; ++t) {
+        offsets[t + 1] += offsets[t];
+    }
+    std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t r = 0; r < num_rows; ++r) {
+        indexes[cursors[tablets[r]]++] = static_cast<uint32_t>(r);
+    }
+    for (size_t t = 0; t < num_tablets; ++t) {
+        if (offsets[t + 1] > offsets[t]) {
+            RETURN_IF_ERROR(_writers[t]->write(chunk, indexes.data(), offsets[t], offsets[t + 1] - offsets[t]));
+        }
+    }
+    return Status::OK();
+}
+
+StatusOr<StreamLoadResult> StreamLoader::finish() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_finished) {
+            return Status::InternalError("stream load finished twice");
+        }
+    }
+    auto result = _finish();
+    if (!result.ok()) {
+        cancel();
+    }
+    return result;
+}
+
+StatusOr<StreamLoadResult> StreamLoader::_finish() {
+    // Only header rows are left if some still are.
+    if (_header_rows_left == 0 && _block.size() > 0) {
+        auto block = std::make_shared<Buffer<uint8_t>>();
+        std::swap(*block, _block);
+        RETURN_IF_ERROR(_submit(std::move(block)));
+    }
+    StreamLoadResult result;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _cv.wait(lock, [this] { return _pending_blocks == 0; });
+        RETURN_IF_ERROR(_status);
+        result.bytes = _bytes;
+        result.rows_loaded = _rows_loaded;
+        result.rows_filtered = _rows_filtered;
+        result.first_error = _first_error;
+    }
+    int64_t num_rows = result.rows_loaded + result.rows_filtered;
+    if (result.rows_filtered > _options.max_filter_ratio * num_rows) {
+        return Status::InvalidArgument("stream load filtered " + std::to_string(result.rows_filtered) + " of " +
+                                       std::to_string(num_rows) + " rows, first because: " + result.first_error);
+    }
+    // The last memtables of all tablets flush at once.
+    for (auto& writer : _writers) {
+        RETURN_IF_ERROR(writer->flush());
+    }
+    for (auto& writer : _writers) {
+        ASSIGN_OR_RETURN(auto segments, writer->close());
+        result.segments.push_back(std::move(segments));
+    }
+    // Each segment commits on its own, in the order it was written, so that
+    // later rows of a key replace earlier ones.
+    for (size_t t = 0; t < _options.tables.size(); ++t) {
+        for (const auto& path : result.segments[t]) {
+            RETURN_IF_ERROR(_options.tables[t]->ingest(path));
+        }
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    _finished = true;
+    return result;
+}
+
+void StreamLoader::cancel() {
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (_status.ok()) {
+            _status = Status::Cancelled("stream load cancelled");
+        }
+        _cv.wait(lock, [this] { return _pending_blocks == 0; });
+        _finished = true;
+    }
+    for (auto& writer : _writers) {
+        writer->cancel();
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "column/buffer.h"
+#include "common/status.h"
+#include "exec/sort_key.h"
+#include "exprs/expr.h"
+#include "formats/csv_parser.h"
+#include "formats/text_parser.h"
+#include "runtime/descriptors.h"
+#include "storage/delta_writer.h"
+#include "storage/primary_key_table.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+enum class LoadFormat { CSV, JSON };
+
+struct StreamLoadOptions {
+    LoadFormat format = LoadFormat::CSV;
+    CsvFormatOptions csv;
+    // The member of each JSON record loaded into each slot of the schema.
+    std::vector<std::string> json_keys;
+    // The columns loaded; for CSV, in the order of the fields.
+    RowDescriptor schema;
+    // Rows are spread over the tablets by the hash of the first
+    // |num_key_columns| slots, and sorted by them within each segment.
+    size_t num_key_columns = 1;
+    // The directory of each tablet loaded into...
+    std::vector<std::string> tablet_dirs;
+    // ...or, instead, primary-key tables, one per tablet, with the schema
+    // and key columns above. Segments are written to a table's directory as
+    // to a tablet's, then committed into it (see PrimaryKeyTable::ingest())
+    // by finish(), and the tables are registered with ExecEnv::
+    // compaction_manager(), which merges the segments loads leave.
+    std::vector<std::shared_ptr<PrimaryKeyTable>> tables;
+    // Segments are named <label>_<n>.seg in their tablet's directory.
+    std::string label;
+    // The load fails if a larger fraction of the rows is filtered out.
+    double max_filter_ratio = 0;
+    DeltaWriterOptions writer_options;
+};
+
+struct StreamLoadResult {
+    int64_t bytes = 0;
+    int64_t rows_loaded = 0;
+    // Rows that could not be parsed or did not fit the schema.
+    int64_t rows_filtered = 0;
+    // Why the first of them was filtered.
+    std::string first_error;
+    // The segments written to each tablet, in order; those committed into
+    // a table have been moved into it under other names.
+    std::vector<std::vector<std::string>> segments;
+};
+
+// Loads CSV or JSON text, streamed in by a client in pieces of any size, into
+// the tablets of a table. The text is cut into blocks of about config::
+// stream_load_block_bytes at record boundaries, and each block is parsed on
+// ExecEnv::stream_load_thread_pool() while the next one arrives: split into
+// fields (see TextParser), converted to the schema's types by CAST
+// expressions, a column at a time, and spread over the tablets' DeltaWriters,
+// which sort and flush their memtables on ExecEnv::
+// memtable_flush_thread_pool(). Every stage runs on all cores at once, and
+// a client sending faster than the parsers keep up blocks in append().
+//
+// Rows whose fields cannot be parsed or converted, or are NULL for a column
+// that is not nullable, are filtered out. A load that fails, or is
+// cancelled, removes the segments it wrote, except those a failure while
+// committing into tables left committed.
+class StreamLoader {
+public:
+    // Needs an initialized ExecEnv.
+    static StatusOr<std::unique_ptr<StreamLoader>> create(StreamLoadOptions options);
+
+    // Cancels the load unless it finished.
+    ~StreamLoader();
+
+    DISALLOW_COPY_AND_MOVE(StreamLoader);
+
+    // Takes the next bytes of the text; records may span calls.
+    Status append(const Slice& data);
+    // Loads the rest of the text, the last record of which may lack its
+    // delimiter, and waits until every row is written.
+    StatusOr<StreamLoadResult> finish();
+    void cancel();
+
+private:
+    explicit StreamLoader(StreamLoadOptions options);
+
+    Status _init();
+    void _skip_header();
+    Status _submit(std::shared_ptr<Buffer<uint8_t>> block);
+    // Parses, converts and writes the rows of |block|, the |seq|th one.
+    Status _load_block(const Slice& block, int64_t seq);
+    // The rows of |records| in the schema's types; rows that do not fit are
+    // marked invalid in |records|.
+    StatusOr<ChunkPtr> _convert(ParsedRecords* records);
+    Status _write(const Chunk& chunk);
+    StatusOr<StreamLoadResult> _finish();
+
+    const StreamLoadOptions _options;
+    std::unique_ptr<TextParser> _parser;
+    SortKeyEncoder _sort_keys;
+    // Per slot, the conversion from VARCHAR; nullptr for VARCHAR slots.
+    std::vector<ExprPtr> _casts;
+    std::vector<std::unique_ptr<DeltaWriter>> _writers;
+    ThreadPool* _parse_pool = nullptr;
+    int _max_pending_blocks = 0;
+
+    // Text not handed to a parse task yet.
+    Buffer<uint8_t> _block;
+    // Look for the end of a block once _block is this large.
+    size_t _cut_size = 0;
+    int64_t _header_rows_left = 0;
+    int64_t _bytes = 0;
+    int64_t _num_blocks = 0;
+
+    std::mutex _lock;
+    std::condition_variable _cv;
+    int _pending_blocks = 0;
+    Status _status;
+    int64_t _rows_loaded = 0;
+    int64_t _rows_filtered = 0;
+    std::string _first_error;
+    // The block _first_error is from: blocks finish out of order.
+    int64_t _first_error_block = INT64_MAX;
+    bool _finished = false;
+};
+
+} // namespace starrocks
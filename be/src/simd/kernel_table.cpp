@@ -0,0 +1,25 @@
+#include "simd/kernel_table.h"
+
+#include "util/cpu_info.h"
+
+namespace starrocks::simd {
+
+static KernelTable make_kernel_table() {
+    KernelTable table;
+    if (CpuInfo::is_supported(CpuInfo::AVX512F) && CpuInfo::is_supported(CpuInfo::AVX512BW) &&
+        CpuInfo::is_supported(CpuInfo::AVX512VL) && CpuInfo::is_supported(CpuInfo::BMI2)) {
+        avx512::init_kernel_table(&table);
+    } else if (CpuInfo::is_supported(CpuInfo::AVX2) && CpuInfo::is_supported(CpuInfo::BMI2)) {
+        avx2::init_kernel_table(&table);
+    } else {
+        scalar::init_kernel_table(&table);
+    }
+    return table;
+}
+
+const KernelTable& kernel_table() {
+    static const KernelTable table = make_kernel_table();
+    return table;
+}
+
+} // namespace starrocks::simd
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace starrocks::simd {
+
+enum class CompareOp : uint8_t { EQ, NE, LT, LE, GT, GE };
+
+// IN-lists up to this many values are evaluated by the linear in_list
+// kernel; longer lists are cheaper to probe through a hash set.
+constexpr size_t kInListLinearLimit = 16;
+
+// At most this many distinct bytes are looked for by index_bytes.
+constexpr size_t kIndexBytesMaxChars = 4;
+
+template <typename T>
+struct TypedKernels {
+    void (*compare)(CompareOp op, const T* data, size_t n, T value, uint8_t* out);
+    void (*between)(const T* data, size_t n, T lo, T hi, uint8_t* out);
+    void (*in_list)(const T* data, size_t n, const T* values, size_t num_values, uint8_t* out);
+    size_t (*compare_select)(CompareOp op, const T* data, size_t from, size_t to, T value, uint32_t* sel);
+    size_t (*between_select)(const T* data, size_t from, size_t to, T lo, T hi, uint32_t* sel);
+};
+
+// Function table for one instruction-set level. The kernel translation units
+// (predicate_kernels_{scalar,avx2,avx512}.cpp) are compiled with different
+// target flags and each fills one table; kernel_table() returns the widest
+// table the running CPU supports.
+struct KernelTable {
+    const char* name;
+
+    TypedKernels<int8_t> i8;
+    TypedKernels<uint8_t> u8;
+    TypedKernels<int16_t> i16;
+    TypedKernels<int32_t> i32;
+    TypedKernels<int64_t> i64;
+    TypedKernels<float> f32;
+    TypedKernels<double> f64;
+
+    void (*and_filter)(uint8_t* dst, const uint8_t* src, size_t n);
+    void (*or_filter)(uint8_t* dst, const uint8_t* src, size_t n);
+    void (*and_not_filter)(uint8_t* dst, const uint8_t* src, size_t n);
+    size_t (*filter_to_selection)(const uint8_t* filter, size_t from, size_t to, uint32_t* sel);
+    size_t (*count_nonzero)(const uint8_t* data, size_t n);
+    size_t (*index_bytes)(const uint8_t* data, size_t n, const uint8_t* chars, size_t num_chars, uint32_t* positions);
+
+    template <typename T>
+    const TypedKernels<T>& get() const {
+        if constexpr (std::is_same_v<T, int8_t>) {
+            return i8;
+        } else if constexpr (std::is_same_v<T, uint8_t>) {
+            return u8;
+        } else if constexpr (std::is_same_v<T, int16_t>) {
+            return i16;
+        } else if constexpr (std::is_same_v<T, int32_t>) {
+            return i32;
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return i64;
+        } else if constexpr (std::is_same_v<T, float>) {
+            return f32;
+        } else {
+            static_assert(std::is_same_v<T, double>, "no predicate kernels for this type");
+            return f64;
+        }
+    }
+};
+
+namespace scalar {
+void init_kernel_table(KernelTable* table);
+}
+namespace avx2 {
+void init_kernel_table(KernelTable* table);
+}
+namespace avx512 {
+void init_kernel_table(KernelTable* table);
+}
+
+const KernelTable& kernel_table();
+
+} // namespace starrocks::simd
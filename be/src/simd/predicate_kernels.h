@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd/kernel_table.h"
+
+namespace starrocks::simd {
+
+// Vectorized predicate kernels over raw column data.
+//
+// Every kernel exists in a scalar, an AVX2 and an AVX-512 build; the widest
+// variant the host CPU supports is bound once at startup (see kernel_table.h),
+// so callers pay one indirect call per column batch, never per row.
+//
+// Two output shapes are provided:
+//  * filter kernels write one byte per row (1 = row passes), the same layout
+//    as Filter and NullColumn, so results combine with and_filter/or_filter;
+//  * select kernels append the absolute indexes of passing rows in
+//    [from, to) to a selection vector and return how many were written.
+//    |sel| must have room for (to - from) entries.
+
+template <typename T>
+inline void compare(CompareOp op, const T* data, size_t n, T value, uint8_t* out) {
+    kernel_table().get<T>().compare(op, data, n, value, out);
+}
+
+// out[i] = lo <= data[i] <= hi
+template <typename T>
+inline void between(const T* data, size_t n, T lo, T hi, uint8_t* out) {
+    kernel_table().get<T>().between(data, n, lo, hi, out);
+}
+
+// out[i] = data[i] is one of values[0..num_values). Intended for short lists
+// (see kInListLinearLimit); longer lists should probe a hash set instead.
+template <typename T>
+inline void in_list(const T* data, size_t n, const T* values, size_t num_values, uint8_t* out) {
+    kernel_table().get<T>().in_list(data, n, values, num_values, out);
+}
+
+template <typename T>
+inline size_t compare_select(CompareOp op, const T* data, size_t from, size_t to, T value, uint32_t* sel) {
+    return kernel_table().get<T>().compare_select(op, data, from, to, value, sel);
+}
+
+template <typename T>
+inline size_t between_select(const T* data, size_t from, size_t to, T lo, T hi, uint32_t* sel) {
+    return kernel_table().get<T>().between_select(data, from, to, lo, hi, sel);
+}
+
+// dst[i] &= src[i]
+inline void and_filter(uint8_t* dst, const uint8_t* src, size_t n) {
+    kernel_table().and_filter(dst, src, n);
+}
+
+// dst[i] |= src[i]
+inline void or_filter(uint8_t* dst, const uint8_t* src, size_t n) {
+    kernel_table().or_filter(dst, src, n);
+}
+
+// dst[i] &= !src[i]; used to clear rows whose null flag is set.
+inline void and_not_filter(uint8_t* dst, const uint8_t* src, size_t n) {
+    kernel_table().and_not_filter(dst, src, n);
+}
+
+// Appends the indexes of non-zero bytes in filter[from, to) to |sel|.
+inline size_t filter_to_selection(const uint8_t* filter, size_t from, size_t to, uint32_t* sel) {
+    return kernel_table().filter_to_selection(filter, from, to, sel);
+}
+
+inline size_t count_nonzero(const uint8_t* data, size_t n) {
+    return kernel_table().count_nonzero(data, n);
+}
+
+// Appends to |positions| the indexes of the bytes of data[0, n) equal to one
+// of chars[0, num_chars), 1 <= num_chars <= kIndexBytesMaxChars, in order,
+// and returns how many were written. |positions| must have room for n
+// entries. Text parsers use it to find every delimiter of a block in one
+// pass and then only visit those.
+inline size_t index_bytes(const uint8_t* data, size_t n, const uint8_t* chars, size_t num_chars, uint32_t* positions) {
+    return kernel_table().index_bytes(data, n, chars, num_chars, positions);
+}
+
+} // namespace starrocks::simd
@@ -0,0 +1,70 @@
+// AVX2 + BMI2 build of the predicate kernels; compiled with -mavx2 -mbmi2.
+
+#define SIMD_ARCH avx2
+#include <immintrin.h>
+
+#include "simd/predicate_kernels_impl.h"
+
+namespace starrocks::simd::avx2 {
+
+// Compacts eight filter bytes per step: the non-zero lanes are turned into a
+// bit mask, PEXT gathers the matching lane numbers out of 0x0706..00 and the
+// eight byte-indexes are widened to 32 bits and stored in one go.
+static size_t filter_to_selection(const uint8_t* filter, size_t from, size_t to, uint32_t* sel) {
+    size_t count = 0;
+    size_t i = from;
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= to; i += 8) {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(filter + i));
+        uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero))) & 0xFF;
+        if (mask == 0) {
+            continue;
+        }
+        uint64_t lanes = _pdep_u64(mask, 0x0101010101010101ULL) * 0xFF;
+        uint64_t packed = _pext_u64(0x0706050403020100ULL, lanes);
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<int64_t>(packed)));
+        idx = _mm256_add_epi32(idx, _mm256_set1_epi32(static_cast<int>(i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sel + count), idx);
+        count += __builtin_popcount(mask);
+    }
+    for (; i < to; ++i) {
+        sel[count] = static_cast<uint32_t>(i);
+        count += filter[i] != 0;
+    }
+    return count;
+}
+
+// Compares 32 bytes at a time against each char and walks the set bits of
+// the combined mask; delimiters are sparse, so most steps find none.
+static size_t index_bytes(const uint8_t* data, size_t n, const uint8_t* chars, size_t num_chars, uint32_t* positions) {
+    __m256i needles[kIndexBytesMaxChars];
+    for (size_t c = 0; c < kIndexBytesMaxChars; ++c) {
+        needles[c] = _mm256_set1_epi8(static_cast<char>(chars[c < num_chars ? c : 0]));
+    }
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, needles[0]), _mm256_cmpeq_epi8(v, needles[1]));
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, needles[2]));
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, needles[3]));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        while (mask != 0) {
+            positions[count++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    size_t tail = generic_index_bytes(data + i, n - i, chars, num_chars, positions + count);
+    for (size_t k = count; k < count + tail; ++k) {
+        positions[k] += static_cast<uint32_t>(i);
+    }
+    return count + tail;
+}
+
+void init_kernel_table(KernelTable* table) {
+    table->name = "avx2";
+    fill_generic_table<&filter_to_selection>(table);
+    table->index_bytes = &index_bytes;
+}
+
+} // namespace starrocks::simd::avx2
@@ -0,0 +1,251 @@
+// AVX-512 build of the predicate kernels; compiled with
+// -mavx512f -mavx512bw -mavx512vl -mavx2 -mbmi2.
+//
+// Select kernels for 32/64-bit types are hand-written here: a compare yields
+// a lane mask directly and VPCOMPRESSD stores the indexes of the passing
+// lanes, so predicate evaluation and selection-vector compaction happen in
+// one pass with no intermediate byte filter. Tails use masked loads instead of
+// a scalar epilogue.
+
+#define SIMD_ARCH avx512
+#include <immintrin.h>
+
+#include "simd/predicate_kernels_impl.h"
+
+namespace starrocks::simd::avx512 {
+
+template <CompareOp OP>
+constexpr int int_predicate() {
+    switch (OP) {
+    case CompareOp::EQ:
+        return _MM_CMPINT_EQ;
+    case CompareOp::NE:
+        return _MM_CMPINT_NE;
+    case CompareOp::LT:
+        return _MM_CMPINT_LT;
+    case CompareOp::LE:
+        return _MM_CMPINT_LE;
+    case CompareOp::GT:
+        return _MM_CMPINT_NLE;
+    default:
+        return _MM_CMPINT_NLT;
+    }
+}
+
+template <typename T>
+struct Vec;
+
+template <>
+struct Vec<int32_t> {
+    static constexpr size_t kLanes = 16;
+    using Reg = __m512i;
+    using Mask = __mmask16;
+    using Index = __m512i;
+    static Reg set1(int32_t v) { return _mm512_set1_epi32(v); }
+    static Reg load(Mask m, const int32_t* p) { return _mm512_maskz_loadu_epi32(m, p); }
+    template <CompareOp OP>
+    static Mask cmp(Reg a, Reg b) {
+        return _mm512_cmp_epi32_mask(a, b, int_predicate<OP>());
+    }
+    static Index iota(uint32_t base) {
+        return _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(base)),
+                                _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+    static Index advance(Index idx) { return _mm512_add_epi32(idx, _mm512_set1_epi32(kLanes)); }
+    static void compress_store(uint32_t* dst, Mask m, Index idx) { _mm512_mask_compressstoreu_epi32(dst, m, idx); }
+};
+
+template <>
+struct Vec<int64_t> {
+    static constexpr size_t kLanes = 8;
+    using Reg = __m512i;
+    using Mask = __mmask8;
+    using Index = __m256i;
+    static Reg set1(int64_t v) { return _mm512_set1_epi64(v); }
+    static Reg load(Mask m, const int64_t* p) { return _mm512_maskz_loadu_epi64(m, p); }
+    template <CompareOp OP>
+    static Mask cmp(Reg a, Reg b) {
+        return _mm512_cmp_epi64_mask(a, b, int_predicate<OP>());
+    }
+    static Index iota(uint32_t base) {
+        return _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+    static Index advance(Index idx) { return _mm256_add_epi32(idx, _mm256_set1_epi32(kLanes)); }
+    static void compress_store(uint32_t* dst, Mask m, Index idx) { _mm256_mask_compressstoreu_epi32(dst, m, idx); }
+};
+
+// Ordered predicates are false on NaN, NE is true on NaN, matching the C++
+// operators used by the generic kernels.
+template <CompareOp OP>
+constexpr int float_predicate() {
+    switch (OP) {
+    case CompareOp::EQ:
+        return _CMP_EQ_OQ;
+    case CompareOp::NE:
+        return _CMP_NEQ_UQ;
+    case CompareOp::LT:
+        return _CMP_LT_OQ;
+    case CompareOp::LE:
+        return _CMP_LE_OQ;
+    case CompareOp::GT:
+        return _CMP_GT_OQ;
+    default:
+        return _CMP_GE_OQ;
+    }
+}
+
+template <>
+struct Vec<float> {
+    static constexpr size_t kLanes = 16;
+    using Reg = __m512;
+    using Mask = __mmask16;
+    using Index = __m512i;
+    static Reg set1(float v) { return _mm512_set1_ps(v); }
+    static Reg load(Mask m, const float* p) { return _mm512_maskz_loadu_ps(m, p); }
+    template <CompareOp OP>
+    static Mask cmp(Reg a, Reg b) {
+        return _mm512_cmp_ps_mask(a, b, float_predicate<OP>());
+    }
+    static Index iota(uint32_t base) { return Vec<int32_t>::iota(base); }
+    static Index advance(Index idx) { return Vec<int32_t>::advance(idx); }
+    static void compress_store(uint32_t* dst, Mask m, Index idx) { Vec<int32_t>::compress_store(dst, m, idx); }
+};
+
+template <>
+struct Vec<double> {
+    static constexpr size_t kLanes = 8;
+    using Reg = __m512d;
+    using Mask = __mmask8;
+    using Index = __m256i;
+    static Reg set1(double v) { return _mm512_set1_pd(v); }
+    static Reg load(Mask m, const double* p) { return _mm512_maskz_loadu_pd(m, p); }
+    template <CompareOp OP>
+    static Mask cmp(Reg a, Reg b) {
+        return _mm512_cmp_pd_mask(a, b, float_predicate<OP>());
+    }
+    static Index iota(uint32_t base) { return Vec<int64_t>::iota(base); }
+    static Index advance(Index idx) { return Vec<int64_t>::advance(idx); }
+    static void compress_store(uint32_t* dst, Mask m, Index idx) { Vec<int64_t>::compress_store(dst, m, idx); }
+};
+
+template <typename V>
+static typename V::Mask tail_mask(size_t n) {
+    return static_cast<typename V::Mask>((1ULL << n) - 1);
+}
+
+template <typename T, CompareOp OP>
+static size_t compare_select_impl(const T* data, size_t from, size_t to, T value, uint32_t* sel) {
+    using V = Vec<T>;
+    using Mask = typename V::Mask;
+    const auto v = V::set1(value);
+    const Mask all = static_cast<Mask>(~Mask(0));
+    auto idx = V::iota(static_cast<uint32_t>(from));
+    size_t count = 0;
+    size_t i = from;
+    for (; i + V::kLanes <= to; i += V::kLanes) {
+        Mask m = V::template cmp<OP>(V::load(all, data + i), v);
+        V::compress_store(sel + count, m, idx);
+        count += __builtin_popcount(m);
+        idx = V::advance(idx);
+    }
+    if (i < to) {
+        Mask live = tail_mask<V>(to - i);
+        Mask m = V::template cmp<OP>(V::load(live, data + i), v) & live;
+        V::compress_store(sel + count, m, idx);
+        count += __builtin_popcount(m);
+    }
+    return count;
+}
+
+template <typename T>
+static size_t compare_select(CompareOp op, const T* data, size_t from, size_t to, T value, uint32_t* sel) {
+    switch (op) {
+    case CompareOp::EQ:
+        return compare_select_impl<T, CompareOp::EQ>(data, from, to, value, sel);
+    case CompareOp::NE:
+        return compare_select_impl<T, CompareOp::NE>(data, from, to, value, sel);
+    case CompareOp::LT:
+        return compare_select_impl<T, CompareOp::LT>(data, from, to, value, sel);
+    case CompareOp::LE:
+        return compare_select_impl<T, CompareOp::LE>(data, from, to, value, sel);
+    case CompareOp::GT:
+        return compare_select_impl<T, CompareOp::GT>(data, from, to, value, sel);
+    default:
+        return compare_select_impl<T, CompareOp::GE>(data, from, to, value, sel);
+    }
+}
+
+template <typename T>
+static size_t between_select(const T* data, size_t from, size_t to, T lo, T hi, uint32_t* sel) {
+    using V = Vec<T>;
+    using Mask = typename V::Mask;
+    const auto vlo = V::set1(lo);
+    const auto vhi = V::set1(hi);
+    const Mask all = static_cast<Mask>(~Mask(0));
+    auto idx = V::iota(static_cast<uint32_t>(from));
+    size_t count = 0;
+    size_t i = from;
+    for (; i < to; i += V::kLanes) {
+        Mask live = i + V::kLanes <= to ? all : tail_mask<V>(to - i);
+        auto x = V::load(live, data + i);
+        Mask m = V::template cmp<CompareOp::GE>(x, vlo) & V::template cmp<CompareOp::LE>(x, vhi) & live;
+        V::compress_store(sel + count, m, idx);
+        count += __builtin_popcount(m);
+        idx = V::advance(idx);
+    }
+    return count;
+}
+
+static size_t filter_to_selection(const uint8_t* filter, size_t from, size_t to, uint32_t* sel) {
+    auto idx = Vec<int32_t>::iota(static_cast<uint32_t>(from));
+    size_t count = 0;
+    for (size_t i = from; i < to; i += 16) {
+        __mmask16 live = i + 16 <= to ? static_cast<__mmask16>(0xFFFF) : tail_mask<Vec<int32_t>>(to - i);
+        __m128i v = _mm_maskz_loadu_epi8(live, filter + i);
+        __mmask16 m = _mm_test_epi8_mask(v, v);
+        _mm512_mask_compressstoreu_epi32(sel + count, m, idx);
+        count += __builtin_popcount(m);
+        idx = Vec<int32_t>::advance(idx);
+    }
+    return count;
+}
+
+template <typename T>
+static void override_select_kernels(TypedKernels<T>* kernels) {
+    kernels->compare_select = &compare_select<T>;
+    kernels->between_select = &between_select<T>;
+}
+
+// 64 bytes a step; VPCMPEQB yields the bit mask directly, and the tail is a
+// masked load.
+static size_t index_bytes(const uint8_t* data, size_t n, const uint8_t* chars, size_t num_chars, uint32_t* positions) {
+    __m512i needles[kIndexBytesMaxChars];
+    for (size_t c = 0; c < kIndexBytesMaxChars; ++c) {
+        needles[c] = _mm512_set1_epi8(static_cast<char>(chars[c < num_chars ? c : 0]));
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += 64) {
+        __mmask64 valid = n - i >= 64 ? ~__mmask64{0} : (__mmask64{1} << (n - i)) - 1;
+        __m512i v = _mm512_maskz_loadu_epi8(valid, data + i);
+        uint64_t mask = _mm512_cmpeq_epi8_mask(v, needles[0]) | _mm512_cmpeq_epi8_mask(v, needles[1]) |
+                        _mm512_cmpeq_epi8_mask(v, needles[2]) | _mm512_cmpeq_epi8_mask(v, needles[3]);
+        mask &= valid;
+        while (mask != 0) {
+            positions[count++] = static_cast<uint32_t>(i + __builtin_ctzll(mask));
+            mask &= mask - 1;
+        }
+    }
+    return count;
+}
+
+void init_kernel_table(KernelTable* table) {
+    table->name = "avx512";
+    fill_generic_table<&filter_to_selection>(table);
+    override_select_kernels(&table->i32);
+    override_select_kernels(&table->i64);
+    override_select_kernels(&table->f32);
+    override_select_kernels(&table->f64);
+    table->index_bytes = &index_bytes;
+}
+
+} // namespace starrocks::simd::avx512
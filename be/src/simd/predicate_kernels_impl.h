@@ -0,0 +1,178 @@
+// Portable kernel bodies shared by every instruction-set build.
+//
+// This header is included only by predicate_kernels_{scalar,avx2,avx512}.cpp,
+// each of which defines SIMD_ARCH to its own namespace before including it, so
+// the same loops are compiled once per target and auto-vectorized to that
+// target's register width without colliding at link time. Keep it free of
+// standard-library calls: an out-of-line std:: helper instantiated here would
+// be compiled with wide-target flags and could be picked by the linker for
+// callers on older CPUs.
+
+#ifndef SIMD_ARCH
+#error "SIMD_ARCH must be defined before including predicate_kernels_impl.h"
+#endif
+
+#include "simd/kernel_table.h"
+
+namespace starrocks::simd::SIMD_ARCH {
+
+template <typename T>
+void generic_compare(CompareOp op, const T* __restrict data, size_t n, T value, uint8_t* __restrict out) {
+    switch (op) {
+    case CompareOp::EQ:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] == value;
+        break;
+    case CompareOp::NE:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] != value;
+        break;
+    case CompareOp::LT:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] < value;
+        break;
+    case CompareOp::LE:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] <= value;
+        break;
+    case CompareOp::GT:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] > value;
+        break;
+    case CompareOp::GE:
+        for (size_t i = 0; i < n; ++i) out[i] = data[i] >= value;
+        break;
+    }
+}
+
+template <typename T>
+void generic_between(const T* __restrict data, size_t n, T lo, T hi, uint8_t* __restrict out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (data[i] >= lo) & (data[i] <= hi);
+    }
+}
+
+template <typename T>
+void generic_in_list(const T* __restrict data, size_t n, const T* __restrict values, size_t num_values,
+                     uint8_t* __restrict out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = 0;
+    }
+    // One pass per list value keeps the inner loop a plain vectorizable compare.
+    for (size_t v = 0; v < num_values; ++v) {
+        const T value = values[v];
+        for (size_t i = 0; i < n; ++i) {
+            out[i] |= data[i] == value;
+        }
+    }
+}
+
+inline size_t generic_filter_to_selection(const uint8_t* __restrict filter, size_t from, size_t to,
+                                          uint32_t* __restrict sel) {
+    size_t count = 0;
+    for (size_t i = from; i < to; ++i) {
+        sel[count] = static_cast<uint32_t>(i);
+        count += filter[i] != 0;
+    }
+    return count;
+}
+
+// Select kernels without a hand-written variant evaluate a block into a byte
+// filter and compact it; the block stays in L1 between the two passes.
+constexpr size_t kSelectBlock = 1024;
+
+template <typename T, typename FilterToSelection>
+size_t generic_compare_select(CompareOp op, const T* data, size_t from, size_t to, T value, uint32_t* sel,
+                              FilterToSelection to_selection) {
+    uint8_t block[kSelectBlock];
+    size_t count = 0;
+    for (size_t start = from; start < to; start += kSelectBlock) {
+        size_t n = to - start < kSelectBlock ? to - start : kSelectBlock;
+        generic_compare<T>(op, data + start, n, value, block);
+        size_t m = to_selection(block, 0, n, sel + count);
+        for (size_t i = 0; i < m; ++i) {
+            sel[count + i] += static_cast<uint32_t>(start);
+        }
+        count += m;
+    }
+    return count;
+}
+
+template <typename T, typename FilterToSelection>
+size_t generic_between_select(const T* data, size_t from, size_t to, T lo, T hi, uint32_t* sel,
+                              FilterToSelection to_selection) {
+    uint8_t block[kSelectBlock];
+    size_t count = 0;
+    for (size_t start = from; start < to; start += kSelectBlock) {
+        size_t n = to - start < kSelectBlock ? to - start : kSelectBlock;
+        generic_between<T>(data + start, n, lo, hi, block);
+        size_t m = to_selection(block, 0, n, sel + count);
+        for (size_t i = 0; i < m; ++i) {
+            sel[count + i] += static_cast<uint32_t>(start);
+        }
+        count += m;
+    }
+    return count;
+}
+
+inline void generic_and_filter(uint8_t* __restrict dst, const uint8_t* __restrict src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] &= src[i];
+}
+
+inline void generic_or_filter(uint8_t* __restrict dst, const uint8_t* __restrict src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] |= src[i];
+}
+
+inline void generic_and_not_filter(uint8_t* __restrict dst, const uint8_t* __restrict src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] &= !src[i];
+}
+
+inline size_t generic_count_nonzero(const uint8_t* __restrict data, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) count += data[i] != 0;
+    return count;
+}
+
+// Branch-free: every position is stored and the count only moves past the
+// matching ones.
+inline size_t generic_index_bytes(const uint8_t* __restrict data, size_t n, const uint8_t* chars, size_t num_chars,
+                                  uint32_t* __restrict positions) {
+    uint8_t is_char[256];
+    for (size_t c = 0; c < 256; ++c) is_char[c] = 0;
+    for (size_t c = 0; c < num_chars; ++c) is_char[chars[c]] = 1;
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        positions[count] = static_cast<uint32_t>(i);
+        count += is_char[data[i]];
+    }
+    return count;
+}
+
+// Fills |kernels| with the generic bodies; the arch file then overrides the
+// entries it has hand-written versions for.
+template <typename T, size_t (*ToSelection)(const uint8_t*, size_t, size_t, uint32_t*)>
+void fill_generic_kernels(TypedKernels<T>* kernels) {
+    kernels->compare = &generic_compare<T>;
+    kernels->between = &generic_between<T>;
+    kernels->in_list = &generic_in_list<T>;
+    kernels->compare_select = [](CompareOp op, const T* data, size_t from, size_t to, T value, uint32_t* sel) {
+        return generic_compare_select<T>(op, data, from, to, value, sel, ToSelection);
+    };
+    kernels->between_select = [](const T* data, size_t from, size_t to, T lo, T hi, uint32_t* sel) {
+        return generic_between_select<T>(data, from, to, lo, hi, sel, ToSelection);
+    };
+}
+
+template <size_t (*ToSelection)(const uint8_t*, size_t, size_t, uint32_t*)>
+void fill_generic_table(KernelTable* table) {
+    fill_generic_kernels<int8_t, ToSelection>(&table->i8);
+    fill_generic_kernels<uint8_t, ToSelection>(&table->u8);
+    fill_generic_kernels<int16_t, ToSelection>(&table->i16);
+    fill_generic_kernels<int32_t, ToSelection>(&table->i32);
+    fill_generic_kernels<int64_t, ToSelection>(&table->i64);
+    fill_generic_kernels<float, ToSelection>(&table->f32);
+    fill_generic_kernels<double, ToSelection>(&table->f64);
+    table->and_filter = &generic_and_filter;
+    table->or_filter = &generic_or_filter;
+    table->and_not_filter = &generic_and_not_filter;
+    table->filter_to_selection = ToSelection;
+    table->count_nonzero = &generic_count_nonzero;
+    table->index_bytes = &generic_index_bytes;
+}
+
+} // namespace starrocks::simd::SIMD_ARCH
@@ -0,0 +1,14 @@
+// Baseline (SSE2) build of the predicate kernels. The loops in
+// predicate_kernels_impl.h still auto-vectorize to 128-bit registers here.
+
+#define SIMD_ARCH scalar
+#include "simd/predicate_kernels_impl.h"
+
+namespace starrocks::simd::scalar {
+
+void init_kernel_table(KernelTable* table) {
+    table->name = "scalar";
+    fill_generic_table<&generic_filter_to_selection>(table);
+}
+
+} // namespace starrocks::simd::scalar
@@ -0,0 +1,269 @@
+#include <cstring>
+#include <functional>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "simd/predicate_kernels.h"
+#include "storage/column_predicate.h"
+
+namespace starrocks {
+
+template <typename T>
+static ALWAYS_INLINE bool compare_value(CompareOp op, const T& a, const T& b) {
+    switch (op) {
+    case CompareOp::EQ:
+        return a == b;
+    case CompareOp::NE:
+        return a != b;
+    case CompareOp::LT:
+        return a < b;
+    case CompareOp::LE:
+        return a <= b;
+    case CompareOp::GT:
+        return a > b;
+    default:
+        return a >= b;
+    }
+}
+
+static PredicateType to_predicate_type(CompareOp op) {
+    switch (op) {
+    case CompareOp::EQ:
+        return PredicateType::kEQ;
+    case CompareOp::NE:
+        return PredicateType::kNE;
+    case CompareOp::LT:
+        return PredicateType::kLT;
+    case CompareOp::LE:
+        return PredicateType::kLE;
+    case CompareOp::GT:
+        return PredicateType::kGT;
+    default:
+        return PredicateType::kGE;
+    }
+}
+
+// Copies a VARCHAR operand into |holder| so the predicate owns its bytes.
+template <typename CppType>
+static CppType own_value(const Datum& datum, std::string* holder) {
+    if constexpr (std::is_same_v<CppType, Slice>) {
+        *holder = datum.get_slice().to_string();
+        return Slice(*holder);
+    } else {
+        return datum.get<CppType>();
+    }
+}
+
+// Evaluates a const column once and broadcasts the result.
+static bool evaluate_const(const Column* column, uint8_t* selection, size_t from, size_t to,
+                           const std::function<bool(const Column*, size_t)>& pass) {
+    if (!column->is_constant()) {
+        return false;
+    }
+    const Column* value = static_cast<const ConstColumn*>(column)->data_column().get();
+    bool res = !value->only_null() && pass(ColumnHelper::get_data_column(value), 0);
+    memset(selection + from, res, to - from);
+    return true;
+}
+
+template <LogicalType LT>
+class ColumnCmpPredicate final : public ColumnPredicate {
+public:
+    using CppType = RunTimeCppType<LT>;
+    using ColumnType = RunTimeColumnType<LT>;
+
+    ColumnCmpPredicate(CompareOp op, ColumnId id, const Datum& value)
+            : ColumnPredicate(LT, id), _op(op), _value(own_value<CppType>(value, &_holder)) {}
+
+    PredicateType type() const override { return to_predicate_type(_op); }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (evaluate_const(column, selection, from, to,
+                           [this](const Column* c, size_t i) { return compare_value(_op, value_at(c, i), _value); })) {
+            return;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        if constexpr (LT == TYPE_VARCHAR) {
+            const auto* binary = static_cast<const BinaryColumn*>(data);
+            for (size_t i = from; i < to; ++i) {
+                selection[i] = compare_value(_op, binary->get_slice(i), _value);
+            }
+        } else {
+            const auto* values = reinterpret_cast<const CppType*>(data->raw_data());
+            simd::compare<CppType>(_op, values + from, to - from, _value, selection + from);
+        }
+        clear_null_rows(column, selection, from, to);
+    }
+
+    size_t evaluate_select(const Column* column, uint32_t* sel, size_t from, size_t to) const override {
+        if constexpr (LT != TYPE_VARCHAR) {
+            if (!column->is_constant() && !column->has_null()) {
+                const auto* values = reinterpret_cast<const CppType*>(column->raw_data());
+                return simd::compare_select<CppType>(_op, values, from, to, _value, sel);
+            }
+        }
+        return ColumnPredicate::evaluate_select(column, sel, from, to);
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            uint8_t pass = 0;
+            evaluate(column, &pass, 0, 1);
+            return pass ? sel_size : 0;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            count += compare_value(_op, value_at(data, row), _value) & (nulls == nullptr || !(*nulls)[row]);
+        }
+        return count;
+    }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        if (!zone_map.has_not_null) {
+            return false;
+        }
+        const auto& min = zone_map.min.get<CppType>();
+        const auto& max = zone_map.max.get<CppType>();
+        switch (_op) {
+        case CompareOp::EQ:
+            return min <= _value && _value <= max;
+        case CompareOp::NE:
+            return !(min == _value && max == _value);
+        case CompareOp::LT:
+            return min < _value;
+        case CompareOp::LE:
+            return min <= _value;
+        case CompareOp::GT:
+            return max > _value;
+        default:
+            return max >= _value;
+        }
+    }
+
+    std::string debug_string() const override {
+        return "(column(" + std::to_string(_column_id) + ") " + predicate_type_name(type()) + " " +
+               value_string(_value) + ")";
+    }
+
+    static CppType value_at(const Column* data, size_t idx) {
+        if constexpr (LT == TYPE_VARCHAR) {
+            return static_cast<const BinaryColumn*>(data)->get_slice(idx);
+        } else {
+            return reinterpret_cast<const CppType*>(data->raw_data())[idx];
+        }
+    }
+
+    static std::string value_string(const CppType& value) {
+        if constexpr (LT == TYPE_VARCHAR) {
+            return "'" + value.to_string() + "'";
+        } else {
+            return std::to_string(value);
+        }
+    }
+
+private:
+    const CompareOp _op;
+    std::string _holder;
+    const CppType _value;
+};
+
+template <LogicalType LT>
+class ColumnBetweenPredicate final : public ColumnPredicate {
+public:
+    using CppType = RunTimeCppType<LT>;
+    using Cmp = ColumnCmpPredicate<LT>;
+
+    ColumnBetweenPredicate(ColumnId id, const Datum& lo, const Datum& hi)
+            : ColumnPredicate(LT, id),
+              _lo(own_value<CppType>(lo, &_lo_holder)),
+              _hi(own_value<CppType>(hi, &_hi_holder)) {}
+
+    PredicateType type() const override { return PredicateType::kBetween; }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (evaluate_const(column, selection, from, to, [this](const Column* c, size_t i) { return pass(c, i); })) {
+            return;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        if constexpr (LT == TYPE_VARCHAR) {
+            for (size_t i = from; i < to; ++i) {
+                selection[i] = pass(data, i);
+            }
+        } else {
+            const auto* values = reinterpret_cast<const CppType*>(data->raw_data());
+            simd::between<CppType>(values + from, to - from, _lo, _hi, selection + from);
+        }
+        clear_null_rows(column, selection, from, to);
+    }
+
+    size_t evaluate_select(const Column* column, uint32_t* sel, size_t from, size_t to) const override {
+        if constexpr (LT != TYPE_VARCHAR) {
+            if (!column->is_constant() && !column->has_null()) {
+                const auto* values = reinterpret_cast<const CppType*>(column->raw_data());
+                return simd::between_select<CppType>(values, from, to, _lo, _hi, sel);
+            }
+        }
+        return ColumnPredicate::evaluate_select(column, sel, from, to);
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            uint8_t res = 0;
+            evaluate(column, &res, 0, 1);
+            return res ? sel_size : 0;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            count += pass(data, row) & (nulls == nullptr || !(*nulls)[row]);
+        }
+        return count;
+    }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        return zone_map.has_not_null && _lo <= zone_map.max.get<CppType>() && zone_map.min.get<CppType>() <= _hi;
+    }
+
+    std::string debug_string() const override {
+        return "(column(" + std::to_string(_column_id) + ") BETWEEN " + Cmp::value_string(_lo) + " AND " +
+               Cmp::value_string(_hi) + ")";
+    }
+
+private:
+    bool pass(const Column* data, size_t idx) const {
+        CppType v = Cmp::value_at(data, idx);
+        return (_lo <= v) & (v <= _hi);
+    }
+
+    std::string _lo_holder;
+    std::string _hi_holder;
+    const CppType _lo;
+    const CppType _hi;
+};
+
+ColumnPredicatePtr new_column_cmp_predicate(CompareOp op, LogicalType type, ColumnId id, const Datum& value) {
+    if (type == TYPE_BITMAP) {
+        return nullptr;
+    }
+    return type_dispatch_all(type, [&](auto lt) -> ColumnPredicatePtr {
+        return std::make_unique<ColumnCmpPredicate<decltype(lt)::value>>(op, id, value);
+    });
+}
+
+ColumnPredicatePtr new_column_between_predicate(LogicalType type, ColumnId id, const Datum& lo, const Datum& hi) {
+    if (type == TYPE_BITMAP) {
+        return nullptr;
+    }
+    return type_dispatch_all(type, [&](auto lt) -> ColumnPredicatePtr {
+        return std::make_unique<ColumnBetweenPredicate<decltype(lt)::value>>(id, lo, hi);
+    });
+}
+
+} // namespace starrocks
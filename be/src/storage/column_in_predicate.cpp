@@ -0,0 +1,145 @@
+#include <cstring>
+#include <unordered_set>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "simd/predicate_kernels.h"
+#include "storage/column_predicate.h"
+
+namespace starrocks {
+
+// col [NOT] IN (v1, v2, ...). Short fixed-width lists are evaluated with the
+// linear SIMD in_list kernel; longer lists and strings probe a hash set.
+template <LogicalType LT>
+class ColumnInPredicate final : public ColumnPredicate {
+public:
+    using CppType = RunTimeCppType<LT>;
+    using Hash = std::conditional_t<LT == TYPE_VARCHAR, SliceHash, std::hash<CppType>>;
+
+    ColumnInPredicate(ColumnId id, const std::vector<Datum>& values, bool is_not_in)
+            : ColumnPredicate(LT, id), _is_not_in(is_not_in) {
+        if constexpr (LT == TYPE_VARCHAR) {
+            _holders.reserve(values.size());
+            for (const auto& v : values) {
+                _holders.emplace_back(v.get_slice().to_string());
+            }
+            for (const auto& s : _holders) {
+                _set.emplace(Slice(s));
+            }
+        } else {
+            for (const auto& v : values) {
+                _set.emplace(v.get<CppType>());
+            }
+        }
+        _values.assign(_set.begin(), _set.end());
+    }
+
+    PredicateType type() const override { return _is_not_in ? PredicateType::kNotInList : PredicateType::kInList; }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (column->is_constant()) {
+            const Column* value = static_cast<const ConstColumn*>(column)->data_column().get();
+            bool res = !value->only_null() && pass(ColumnHelper::get_data_column(value), 0);
+            memset(selection + from, res, to - from);
+            return;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        bool use_kernel = false;
+        if constexpr (LT != TYPE_VARCHAR) {
+            use_kernel = _values.size() <= simd::kInListLinearLimit;
+            if (use_kernel) {
+                const auto* values = reinterpret_cast<const CppType*>(data->raw_data());
+                simd::in_list<CppType>(values + from, to - from, _values.data(), _values.size(), selection + from);
+                if (_is_not_in) {
+                    for (size_t i = from; i < to; ++i) {
+                        selection[i] ^= 1;
+                    }
+                }
+            }
+        }
+        if (!use_kernel) {
+            for (size_t i = from; i < to; ++i) {
+                selection[i] = pass(data, i);
+            }
+        }
+        clear_null_rows(column, selection, from, to);
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            uint8_t res = 0;
+            evaluate(column, &res, 0, 1);
+            return res ? sel_size : 0;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            count += pass(data, row) & (nulls == nullptr || !(*nulls)[row]);
+        }
+        return count;
+    }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        if (!zone_map.has_not_null) {
+            return false;
+        }
+        const auto& min = zone_map.min.get<CppType>();
+        const auto& max = zone_map.max.get<CppType>();
+        if (_is_not_in) {
+            // Only a range holding a single listed value is ruled out.
+            return !(min == max && _set.count(min) > 0);
+        }
+        for (const auto& v : _values) {
+            if (min <= v && v <= max) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string debug_string() const override {
+        std::string res = "(column(" + std::to_string(_column_id) + ") " + predicate_type_name(type()) + " (";
+        for (size_t i = 0; i < _values.size(); ++i) {
+            if (i > 0) {
+                res.append(",");
+            }
+            if constexpr (LT == TYPE_VARCHAR) {
+                res.append("'").append(_values[i].to_string()).append("'");
+            } else {
+                res.append(std::to_string(_values[i]));
+            }
+        }
+        return res + "))";
+    }
+
+private:
+    bool pass(const Column* data, size_t idx) const {
+        bool found;
+        if constexpr (LT == TYPE_VARCHAR) {
+            found = _set.count(static_cast<const BinaryColumn*>(data)->get_slice(idx)) > 0;
+        } else {
+            found = _set.count(reinterpret_cast<const CppType*>(data->raw_data())[idx]) > 0;
+        }
+        return found != _is_not_in;
+    }
+
+    const bool _is_not_in;
+    std::vector<std::string> _holders;
+    std::unordered_set<CppType, Hash> _set;
+    std::vector<CppType> _values;
+};
+
+ColumnPredicatePtr new_column_in_predicate(LogicalType type, ColumnId id, const std::vector<Datum>& values,
+                                           bool is_not_in) {
+    if (type == TYPE_BITMAP) {
+        return nullptr;
+    }
+    return type_dispatch_all(type, [&](auto lt) -> ColumnPredicatePtr {
+        return std::make_unique<ColumnInPredicate<decltype(lt)::value>>(id, values, is_not_in);
+    });
+}
+
+} // namespace starrocks
@@ -0,0 +1,70 @@
+#include <cstring>
+
+#include "column/column_helper.h"
+#include "storage/column_predicate.h"
+
+namespace starrocks {
+
+// col IS [NOT] NULL. Reads only the null map, never the data column.
+class ColumnNullPredicate final : public ColumnPredicate {
+public:
+    ColumnNullPredicate(LogicalType type, ColumnId id, bool is_null) : ColumnPredicate(type, id), _is_null(is_null) {}
+
+    PredicateType type() const override { return _is_null ? PredicateType::kIsNull : PredicateType::kNotNull; }
+
+    bool can_pass_null() const override { return _is_null; }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (column->is_constant()) {
+            memset(selection + from, column->only_null() == _is_null, to - from);
+            return;
+        }
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        if (nulls == nullptr) {
+            memset(selection + from, !_is_null, to - from);
+            return;
+        }
+        const uint8_t* n = nulls->data();
+        if (_is_null) {
+            memcpy(selection + from, n + from, to - from);
+        } else {
+            for (size_t i = from; i < to; ++i) {
+                selection[i] = !n[i];
+            }
+        }
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            return column->only_null() == _is_null ? sel_size : 0;
+        }
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        if (nulls == nullptr) {
+            return _is_null ? 0 : sel_size;
+        }
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            count += ((*nulls)[row] != 0) == _is_null;
+        }
+        return count;
+    }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        return _is_null ? zone_map.has_null : zone_map.has_not_null;
+    }
+
+    std::string debug_string() const override {
+        return "(column(" + std::to_string(_column_id) + ") " + predicate_type_name(type()) + ")";
+    }
+
+private:
+    const bool _is_null;
+};
+
+ColumnPredicatePtr new_column_null_predicate(LogicalType type, ColumnId id, bool is_null) {
+    return std::make_unique<ColumnNullPredicate>(type, id, is_null);
+}
+
+} // namespace starrocks
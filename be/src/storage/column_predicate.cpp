@@ -0,0 +1,74 @@
+#include "storage/column_predicate.h"
+
+#include "column/nullable_column.h"
+#include "simd/predicate_kernels.h"
+
+namespace starrocks {
+
+const char* predicate_type_name(PredicateType type) {
+    switch (type) {
+    case PredicateType::kEQ:
+        return "=";
+    case PredicateType::kNE:
+        return "!=";
+    case PredicateType::kLT:
+        return "<";
+    case PredicateType::kLE:
+        return "<=";
+    case PredicateType::kGT:
+        return ">";
+    case PredicateType::kGE:
+        return ">=";
+    case PredicateType::kBetween:
+        return "BETWEEN";
+    case PredicateType::kInList:
+        return "IN";
+    case PredicateType::kNotInList:
+        return "NOT IN";
+    case PredicateType::kIsNull:
+        return "IS NULL";
+    case PredicateType::kNotNull:
+        return "IS NOT NULL";
+    case PredicateType::kRuntimeFilter:
+        return "RUNTIME FILTER";
+    case PredicateType::kDictCode:
+        return "DICT CODE";
+    case PredicateType::kTopN:
+        return "TOP-N";
+    }
+    return "?";
+}
+
+// Scratch filter reused by the default and/or/select implementations.
+static uint8_t* scratch_filter(size_t size) {
+    thread_local Buffer<uint8_t> buffer;
+    buffer.resize_uninitialized(size);
+    return buffer.data();
+}
+
+void ColumnPredicate::evaluate_and(const Column* column, uint8_t* selection, size_t from, size_t to) const {
+    uint8_t* tmp = scratch_filter(to);
+    evaluate(column, tmp, from, to);
+    simd::and_filter(selection + from, tmp + from, to - from);
+}
+
+void ColumnPredicate::evaluate_or(const Column* column, uint8_t* selection, size_t from, size_t to) const {
+    uint8_t* tmp = scratch_filter(to);
+    evaluate(column, tmp, from, to);
+    simd::or_filter(selection + from, tmp + from, to - from);
+}
+
+size_t ColumnPredicate::evaluate_select(const Column* column, uint32_t* sel, size_t from, size_t to) const {
+    uint8_t* tmp = scratch_filter(to);
+    evaluate(column, tmp, from, to);
+    return simd::filter_to_selection(tmp, from, to, sel);
+}
+
+void ColumnPredicate::clear_null_rows(const Column* column, uint8_t* selection, size_t from, size_t to) {
+    if (column->is_nullable() && column->has_null()) {
+        const auto& nulls = static_cast<const NullableColumn*>(column)->null_column_data();
+        simd::and_not_filter(selection + from, nulls.data() + from, to - from);
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column/column.h"
+#include "column/datum.h"
+#include "simd/kernel_table.h"
+#include "storage/zone_map_detail.h"
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+using ColumnId = uint32_t;
+using simd::CompareOp;
+
+enum class PredicateType {
+    kEQ,
+    kNE,
+    kLT,
+    kLE,
+    kGT,
+    kGE,
+    kBetween,
+    kInList,
+    kNotInList,
+    kIsNull,
+    kNotNull,
+    // Values of a join's build side (see RuntimeFilter).
+    kRuntimeFilter,
+    // A VARCHAR predicate on the codes of a global dictionary (see
+    // new_dict_code_predicate()).
+    kDictCode,
+    // The threshold of a Top-N sort (see TopNRuntimeFilter).
+    kTopN,
+};
+
+const char* predicate_type_name(PredicateType type);
+
+// ColumnPredicate is a single-column filter (`col op constant`) that scans
+// evaluate directly on the Column they just decoded, before any row is
+// materialized into a Chunk. Comparisons against NULL rows are false, except
+// for IS NULL.
+//
+// Fixed-width types are evaluated by the vectorized kernels in simd/ over the
+// whole column batch; the null map is applied afterwards as a second
+// vectorized pass, so a nullable column costs one extra AND per batch rather
+// than a branch per row.
+class ColumnPredicate {
+public:
+    ColumnPredicate(LogicalType type, ColumnId column_id) : _type(type), _column_id(column_id) {}
+    virtual ~ColumnPredicate() = default;
+
+    virtual PredicateType type() const = 0;
+    LogicalType logical_type() const { return _type; }
+    ColumnId column_id() const { return _column_id; }
+
+    // Sets selection[i] to 1 for passing rows in [from, to) and 0 otherwise.
+    virtual void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const = 0;
+
+    // selection[i] &= pass(i)
+    virtual void evaluate_and(const Column* column, uint8_t* selection, size_t from, size_t to) const;
+    // selection[i] |= pass(i)
+    virtual void evaluate_or(const Column* column, uint8_t* selection, size_t from, size_t to) const;
+
+    // Writes the indexes of passing rows in [from, to) to |sel| (room for
+    // to - from entries) and returns their count.
+    virtual size_t evaluate_select(const Column* column, uint32_t* sel, size_t from, size_t to) const;
+
+    // Keeps only the entries of |sel| whose rows pass; returns the new size.
+    // Used when an earlier predicate already discarded most rows, so only the
+    // survivors are looked at.
+    virtual size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const = 0;
+
+    // True if NULL rows can pass this predicate.
+    virtual bool can_pass_null() const { return false; }
+
+    // False if no row summarized by |zone_map| can pass, so a scan may skip
+    // the page (or segment) without reading it.
+    virtual bool zone_map_filter(const ZoneMapDetail& zone_map) const { return true; }
+
+    virtual std::string debug_string() const = 0;
+
+protected:
+    // selection[i] &= !null[i] for nullable columns.
+    static void clear_null_rows(const Column* column, uint8_t* selection, size_t from, size_t to);
+
+    LogicalType _type;
+    ColumnId _column_id;
+};
+
+using ColumnPredicatePtr = std::unique_ptr<ColumnPredicate>;
+
+// BITMAP values have no order, and equal ones need not be equal bytes: the
+// comparisons below return nullptr for them.
+//
+// col <op> value
+ColumnPredicatePtr new_column_cmp_predicate(CompareOp op, LogicalType type, ColumnId id, const Datum& value);
+// lo <= col <= hi
+ColumnPredicatePtr new_column_between_predicate(LogicalType type, ColumnId id, const Datum& lo, const Datum& hi);
+// col [NOT] IN (values...)
+ColumnPredicatePtr new_column_in_predicate(LogicalType type, ColumnId id, const std::vector<Datum>& values,
+                                           bool is_not_in = false);
+// col IS [NOT] NULL
+ColumnPredicatePtr new_column_null_predicate(LogicalType type, ColumnId id, bool is_null);
+
+} // namespace starrocks
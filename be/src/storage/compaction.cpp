@@ -0,0 +1,180 @@
+#include "storage/compaction.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/config.h"
+#include "storage/primary_key_table.h"
+
+namespace starrocks {
+
+CompactionPlan pick_compaction(const PrimaryKeyTableVersion& version) {
+    CompactionPlan plan;
+    int64_t target_bytes = config::compaction_target_segment_bytes;
+    auto max_inputs = static_cast<size_t>(std::max(config::compaction_max_input_segments, 1));
+    int64_t live_bytes = 0;
+    bool mostly_deleted = false;
+    // Rows are unique across the segments of a primary-key table, so any of
+    // them may be merged, not only neighbors.
+    for (size_t i = 0; i < version.segments.size(); ++i) {
+        const auto& segment = version.segments[i];
+        int64_t num_rows = segment->num_rows();
+        double deleted_ratio =
+                num_rows > 0 ? static_cast<double>(version.del_vectors[i]->cardinality()) / num_rows : 0;
+        bool is_mostly_deleted = deleted_ratio > config::compaction_delete_ratio_threshold;
+        if (segment->file_size() >= target_bytes / 4 && !is_mostly_deleted) {
+            continue;
+        }
+        plan.segment_ids.push_back(version.segment_ids[i]);
+        plan.score += deleted_ratio;
+        live_bytes += static_cast<int64_t>(segment->file_size() * (1 - deleted_ratio));
+        mostly_deleted |= is_mostly_deleted;
+        if (live_bytes >= target_bytes || plan.segment_ids.size() >= max_inputs) {
+            break;
+        }
+    }
+    if (plan.segment_ids.empty() ||
+        (plan.segment_ids.size() < static_cast<size_t>(config::compaction_min_input_segments) && !mostly_deleted)) {
+        return {};
+    }
+    plan.score += plan.segment_ids.size() - 1;
+    return plan;
+}
+
+CompactionManager::CompactionManager() : _io_limiter(config::compaction_io_bytes_per_second) {}
+
+CompactionManager::~CompactionManager() {
+    stop();
+}
+
+Status CompactionManager::start() {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_stopped) {
+        return Status::OK();
+    }
+    _stopped = false;
+    _pool = std::make_unique<ThreadPool>("compaction", std::max(config::compaction_max_concurrency, 1));
+    _scheduler = std::thread([this] { _schedule_loop(); });
+    return Status::OK();
+}
+
+void CompactionManager::stop() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _cv.notify_all();
+    _scheduler.join();
+    // Queued compactions see the manager stopped and return at once.
+    _pool->shutdown();
+}
+
+void CompactionManager::register_table(const std::shared_ptr<PrimaryKeyTable>& table) {
+    std::lock_guard<std::mutex> guard(_lock);
+    for (const auto& entry : _tables) {
+        if (entry.key == table.get() && !entry.table.expired()) {
+            return;
+        }
+    }
+    _tables.push_back(TableEntry{table, table.get(), false});
+}
+
+void CompactionManager::schedule() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _wakeup = true;
+    }
+    _cv.notify_all();
+}
+
+int CompactionManager::running_compactions() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _running;
+}
+
+void CompactionManager::_schedule_loop() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (true) {
+        _cv.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(config::compaction_check_interval_ms, 1)),
+                     [this] { return _stopped || _wakeup; });
+        if (_stopped) {
+            return;
+        }
+        _wakeup = false;
+        _io_limiter.set_rate(config::compaction_io_bytes_per_second);
+        _tables.erase(std::remove_if(_tables.begin(), _tables.end(),
+                                     [](const TableEntry& entry) { return entry.table.expired(); }),
+                      _tables.end());
+        int slots = std::max(config::compaction_max_concurrency, 1) - _running;
+        if (slots <= 0) {
+            continue;
+        }
+        std::vector<std::pair<CompactionPlan, size_t>> plans;
+        for (size_t i = 0; i < _tables.size(); ++i) {
+            std::shared_ptr<PrimaryKeyTable> table = _tables[i].table.lock();
+            if (table == nullptr || _tables[i].compacting) {
+                continue;
+            }
+            CompactionPlan plan = pick_compaction(*table->current_version());
+            if (!plan.segment_ids.empty()) {
+                plans.emplace_back(std::move(plan), i);
+            }
+        }
+        std::sort(plans.begin(), plans.end(),
+                  [](const auto& a, const auto& b) { return a.first.score > b.first.score; });
+        for (size_t i = 0; i < plans.size() && slots > 0; ++i) {
+            TableEntry& entry = _tables[plans[i].second];
+            std::shared_ptr<PrimaryKeyTable> table = entry.table.lock();
+            if (table == nullptr) {
+                continue;
+            }
+            auto task = [this, table, plan = std::move(plans[i].first)]() mutable {
+                _run(std::move(table), std::move(plan));
+            };
+            if (_pool->submit(std::move(task)).ok()) {
+                entry.compacting = true;
+                _running++;
+                slots--;
+            }
+        }
+    }
+}
+
+void CompactionManager::_run(std::shared_ptr<PrimaryKeyTable> table, CompactionPlan plan) {
+    bool stopped;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        stopped = _stopped;
+    }
+    bool succeeded = false;
+    if (!stopped) {
+        CompactionOptions options;
+        options.memory_limit_bytes =
+                config::compaction_memory_limit_bytes / std::max(config::compaction_max_concurrency, 1);
+        options.io_limiter = &_io_limiter;
+        CompactionStats stats;
+        Status st = table->compact(plan.segment_ids, options, &stats);
+        succeeded = st.ok();
+        (succeeded ? _num_compactions : _num_failures).fetch_add(1, std::memory_order_relaxed);
+        _bytes_read.fetch_add(stats.bytes_read, std::memory_order_relaxed);
+        _bytes_written.fetch_add(stats.bytes_written, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (auto& entry : _tables) {
+            if (entry.key == table.get()) {
+                entry.compacting = false;
+            }
+        }
+        _running--;
+        // The table may have more to compact, and a slot is free. A failed
+        // compaction waits for the next round instead of retrying at once.
+        _wakeup |= succeeded;
+    }
+    _cv.notify_all();
+}
+
+} // namespace starrocks
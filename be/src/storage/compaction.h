@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/status.h"
+#include "util/rate_limiter.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+class PrimaryKeyTable;
+struct PrimaryKeyTableVersion;
+
+// Segments of a table worth merging into one, and what that gains.
+struct CompactionPlan {
+    // In segment id order.
+    std::vector<uint32_t> segment_ids;
+    // Read amplification removed: every scan opens num_inputs - 1 segments
+    // fewer, and skips the deleted rows of the inputs, counted in whole
+    // segments (a half-deleted segment adds 0.5).
+    double score = 0;
+};
+
+// Picks the small segments of |version| - below a quarter of config::
+// compaction_target_segment_bytes - and those with more than config::
+// compaction_delete_ratio_threshold of their rows deleted, oldest first,
+// until their live bytes reach the target size or config::
+// compaction_max_input_segments. Fewer than config::
+// compaction_min_input_segments are only worth it for mostly deleted
+// segments; otherwise the plan is empty.
+CompactionPlan pick_compaction(const PrimaryKeyTableVersion& version);
+
+struct CompactionOptions {
+    // Bounds the buffers of the column groups rewritten at a time.
+    int64_t memory_limit_bytes = 256L * 1024 * 1024;
+    // Charged the bytes read and written; may be nullptr.
+    RateLimiter* io_limiter = nullptr;
+};
+
+struct CompactionStats {
+    int64_t input_segments = 0;
+    // Rows copied, and deleted rows of the inputs dropped.
+    int64_t input_rows = 0;
+    int64_t deleted_rows = 0;
+    int64_t column_groups = 0;
+    int64_t bytes_read = 0;
+    int64_t bytes_written = 0;
+};
+
+// Compacts the primary-key tables registered with it in the background.
+// Every config::compaction_check_interval_ms - or as soon as a compaction
+// ends - it plans a compaction for each table not compacting already and
+// runs the highest-scoring plans first, at most config::
+// compaction_max_concurrency at a time. Those share config::
+// compaction_memory_limit_bytes equally, and config::
+// compaction_io_bytes_per_second of disk bandwidth through one RateLimiter,
+// so that compaction never starves the queries it exists to speed up.
+//
+// Tables are held weakly; a table being destroyed is not compacted any more,
+// and one being compacted lives until the compaction ends.
+class CompactionManager {
+public:
+    CompactionManager();
+    ~CompactionManager();
+
+    DISALLOW_COPY_AND_MOVE(CompactionManager);
+
+    Status start();
+    // Waits for the running compactions.
+    void stop();
+
+    // Registering a table again does nothing.
+    void register_table(const std::shared_ptr<PrimaryKeyTable>& table);
+    // Plans and starts compactions now.
+    void schedule();
+
+    int64_t num_compactions() const { return _num_compactions.load(std::memory_order_relaxed); }
+    int64_t num_failures() const { return _num_failures.load(std::memory_order_relaxed); }
+    int64_t bytes_read() const { return _bytes_read.load(std::memory_order_relaxed); }
+    int64_t bytes_written() const { return _bytes_written.load(std::memory_order_relaxed); }
+    int running_compactions() const;
+
+private:
+    struct TableEntry {
+        std::weak_ptr<PrimaryKeyTable> table;
+        // Identifies the table once it expired.
+        const PrimaryKeyTable* key;
+        bool compacting = false;
+    };
+
+    void _schedule_loop();
+    void _run(std::shared_ptr<PrimaryKeyTable> table, CompactionPlan plan);
+
+    RateLimiter _io_limiter;
+    std::unique_ptr<ThreadPool> _pool;
+    std::thread _scheduler;
+
+    mutable std::mutex _lock;
+    std::condition_variable _cv;
+    bool _stopped = true;
+    bool _wakeup = false;
+    int _running = 0;
+    std::vector<TableEntry> _tables;
+
+    std::atomic<int64_t> _num_compactions{0};
+    std::atomic<int64_t> _num_failures{0};
+    std::atomic<int64_t> _bytes_read{0};
+    std::atomic<int64_t> _bytes_written{0};
+};
+
+} // namespace starrocks
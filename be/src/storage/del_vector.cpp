@@ -0,0 +1,58 @@
+#include "storage/del_vector.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "util/coding.h"
+
+namespace starrocks {
+
+bool DelVector::contains(uint32_t rowid) const {
+    return std::binary_search(_rowids.begin(), _rowids.end(), rowid);
+}
+
+size_t DelVector::count_range(uint32_t begin, uint32_t end) const {
+    auto first = std::lower_bound(_rowids.begin(), _rowids.end(), begin);
+    return std::lower_bound(first, _rowids.end(), end) - first;
+}
+
+DelVectorPtr DelVector::add(std::vector<uint32_t> rowids) const {
+    std::sort(rowids.begin(), rowids.end());
+    auto result = std::make_shared<DelVector>();
+    result->_rowids.reserve(_rowids.size() + rowids.size());
+    std::set_union(_rowids.begin(), _rowids.end(), rowids.begin(), rowids.end(), std::back_inserter(result->_rowids));
+    result->_rowids.erase(std::unique(result->_rowids.begin(), result->_rowids.end()), result->_rowids.end());
+    return result;
+}
+
+void DelVector::serialize(Buffer<uint8_t>* dst) const {
+    put_varint64(dst, _rowids.size());
+    uint32_t prev = 0;
+    for (uint32_t rowid : _rowids) {
+        put_varint64(dst, rowid - prev);
+        prev = rowid;
+    }
+}
+
+bool DelVector::deserialize(Slice* input, DelVector* del_vector) {
+    uint64_t count;
+    if (!get_varint64(input, &count) || count > input->size) {
+        return false;
+    }
+    del_vector->_rowids.resize(count);
+    uint64_t rowid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t gap;
+        if (!get_varint64(input, &gap) || (i > 0 && gap == 0)) {
+            return false;
+        }
+        rowid += gap;
+        if (rowid > UINT32_MAX) {
+            return false;
+        }
+        del_vector->_rowids[i] = static_cast<uint32_t>(rowid);
+    }
+    return true;
+}
+
+} // namespace starrocks
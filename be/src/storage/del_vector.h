@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "column/buffer.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+class DelVector;
+using DelVectorPtr = std::shared_ptr<const DelVector>;
+
+// Rows of one segment of a primary-key table that later writes replaced or
+// deleted, as sorted row ids. A shared DelVector is never modified: a write
+// deleting more rows installs a new one, so scans keep reading the version
+// they started with.
+class DelVector {
+public:
+    DelVector() = default;
+
+    size_t cardinality() const { return _rowids.size(); }
+    bool empty() const { return _rowids.empty(); }
+    const std::vector<uint32_t>& rowids() const { return _rowids; }
+    bool contains(uint32_t rowid) const;
+    // Deleted rows among [begin, end).
+    size_t count_range(uint32_t begin, uint32_t end) const;
+
+    // A copy with |rowids| deleted as well; they may be in any order, repeat,
+    // or be deleted already.
+    DelVectorPtr add(std::vector<uint32_t> rowids) const;
+
+    // Row count, then the gaps between consecutive row ids, as varints.
+    void serialize(Buffer<uint8_t>* dst) const;
+    static bool deserialize(Slice* input, DelVector* del_vector);
+
+private:
+    std::vector<uint32_t> _rowids;
+};
+
+} // namespace starrocks
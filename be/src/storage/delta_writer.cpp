@@ -0,0 +1,110 @@
+#include "storage/delta_writer.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace starrocks {
+
+DeltaWriter::DeltaWriter(std::string dir, std::string prefix, RowDescriptor schema, const SortKeyEncoder* sort_keys,
+                         ThreadPool* flush_pool, DeltaWriterOptions options)
+        : _dir(std::move(dir)),
+          _prefix(std::move(prefix)),
+          _schema(std::move(schema)),
+          _sort_keys(sort_keys),
+          _flush_pool(flush_pool),
+          _options(options),
+          _mem_table(_new_mem_table()) {}
+
+DeltaWriter::~DeltaWriter() {
+    if (!_closed) {
+        cancel();
+    }
+}
+
+std::unique_ptr<MemTable> DeltaWriter::_new_mem_table() const {
+    return std::make_unique<MemTable>(_schema, _sort_keys);
+}
+
+Status DeltaWriter::write(const Chunk& chunk, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_closed) {
+        return Status::InternalError("write to a closed delta writer");
+    }
+    RETURN_IF_ERROR(_flush_status);
+    _mem_table->insert(chunk, indexes, from, size);
+    _num_rows += size;
+    if (static_cast<int64_t>(_mem_table->memory_usage()) >= _options.write_buffer_size) {
+        return _flush_locked(lock);
+    }
+    return Status::OK();
+}
+
+Status DeltaWriter::flush() {
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_closed) {
+        return Status::InternalError("flush of a closed delta writer");
+    }
+    return _flush_locked(lock);
+}
+
+Status DeltaWriter::_flush_locked(std::unique_lock<std::mutex>& lock) {
+    int max_flushing = std::max(_options.max_flushing_memtables, 1);
+    _cv.wait(lock, [this, max_flushing] { return _num_flushing < max_flushing; });
+    RETURN_IF_ERROR(_flush_status);
+    // Another writer may have flushed it while this one waited.
+    if (_mem_table->num_rows() == 0) {
+        return Status::OK();
+    }
+    std::shared_ptr<MemTable> mem_table = std::move(_mem_table);
+    _mem_table = _new_mem_table();
+    std::string path = _dir + "/" + _prefix + std::to_string(_segments.size()) + ".seg";
+    _segments.push_back(path);
+    _num_flushing++;
+    Status st = _flush_pool->submit([this, mem_table, path] {
+        Status st = mem_table->flush(path, _options.writer_options);
+        // Notified under the lock: once it is released, close() may return
+        // and the writer go away.
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!st.ok() && _flush_status.ok()) {
+            _flush_status = st;
+        }
+        _num_flushing--;
+        _cv.notify_all();
+    });
+    if (!st.ok()) {
+        _num_flushing--;
+        _segments.pop_back();
+    }
+    return st;
+}
+
+StatusOr<std::vector<std::string>> DeltaWriter::close() {
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_closed) {
+        return Status::InternalError("delta writer closed twice");
+    }
+    Status st = _flush_locked(lock);
+    _cv.wait(lock, [this] { return _num_flushing == 0; });
+    RETURN_IF_ERROR(st);
+    RETURN_IF_ERROR(_flush_status);
+    _closed = true;
+    return _segments;
+}
+
+void DeltaWriter::cancel() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _cv.wait(lock, [this] { return _num_flushing == 0; });
+    for (const auto& path : _segments) {
+        ::unlink(path.c_str());
+    }
+    _segments.clear();
+    _closed = true;
+}
+
+int64_t DeltaWriter::num_rows() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _num_rows;
+}
+
+} // namespace starrocks
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/status.h"
+#include "storage/mem_table.h"
+#include "util/threadpool.h"
+
+namespace starrocks {
+
+struct DeltaWriterOptions {
+    // A memtable is flushed once it takes this much memory.
+    int64_t write_buffer_size = config::write_buffer_size;
+    // Memtables flushing at once before writes wait for one to finish.
+    int32_t max_flushing_memtables = config::memtable_max_flushing;
+    SegmentWriterOptions writer_options;
+};
+
+// Writes the rows a load sends one tablet into new segments of the tablet's
+// directory, named <prefix><n>.seg. Rows gather in a MemTable; a full one is
+// sorted and written on |flush_pool| while the next one fills, so the
+// threads feeding the writer only wait for the disk when flushes fall
+// behind. Thread-safe: several parse threads write to it at once.
+class DeltaWriter {
+public:
+    // |sort_keys| is prepared for |schema| and outlives the writer.
+    DeltaWriter(std::string dir, std::string prefix, RowDescriptor schema, const SortKeyEncoder* sort_keys,
+                ThreadPool* flush_pool, DeltaWriterOptions options = {});
+    // Cancels the writer unless it was closed.
+    ~DeltaWriter();
+
+    DISALLOW_COPY_AND_MOVE(DeltaWriter);
+
+    // Appends rows indexes[from, from + size) of |chunk|.
+    Status write(const Chunk& chunk, const uint32_t* indexes, uint32_t from, uint32_t size);
+    // Starts flushing the current memtable, if it has rows.
+    Status flush();
+    // Flushes the last rows and waits for every flush; returns the segments
+    // written, in order.
+    StatusOr<std::vector<std::string>> close();
+    // Waits for the running flushes and removes the segments written.
+    void cancel();
+
+    int64_t num_rows() const;
+
+private:
+    Status _flush_locked(std::unique_lock<std::mutex>& lock);
+    std::unique_ptr<MemTable> _new_mem_table() const;
+
+    const std::string _dir;
+    const std::string _prefix;
+    const RowDescriptor _schema;
+    const SortKeyEncoder* _sort_keys;
+    ThreadPool* _flush_pool;
+    const DeltaWriterOptions _options;
+
+    mutable std::mutex _lock;
+    std::condition_variable _cv;
+    std::unique_ptr<MemTable> _mem_table;
+    int _num_flushing = 0;
+    Status _flush_status;
+    std::vector<std::string> _segments;
+    int64_t _num_rows = 0;
+    bool _closed = false;
+};
+
+} // namespace starrocks
@@ -0,0 +1,270 @@
+#include "storage/global_dict.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "column/column_helper.h"
+#include "column/const_column.h"
+#include "common/config.h"
+#include "storage/segment/segment_iterator.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+StatusOr<std::shared_ptr<GlobalDictionary>> GlobalDictionary::build(const std::vector<SegmentSharedPtr>& segments,
+                                                                    ColumnId column_id) {
+    auto max_words = static_cast<size_t>(std::max(config::global_dict_max_words, 0));
+    std::unordered_set<std::string> distinct;
+    for (const auto& segment : segments) {
+        if (column_id >= segment->num_columns() || segment->schema()[column_id].type != TYPE_VARCHAR) {
+            return Status::InvalidArgument("segment " + segment->path() + " has no VARCHAR column " +
+                                           std::to_string(column_id));
+        }
+        SegmentReadOptions options;
+        options.column_ids = {column_id};
+        SegmentIterator iter(segment, std::move(options));
+        RETURN_IF_ERROR(iter.init());
+        while (true) {
+            ChunkPtr chunk;
+            Status st = iter.get_next(&chunk);
+            if (st.is_end_of_file()) {
+                break;
+            }
+            RETURN_IF_ERROR(st);
+            const Column* column = chunk->get_column_by_index(0).get();
+            const auto* words = static_cast<const BinaryColumn*>(ColumnHelper::get_data_column(column));
+            const NullData* nulls = ColumnHelper::get_null_data(column);
+            for (size_t i = 0; i < words->size(); ++i) {
+                if (nulls == nullptr || !(*nulls)[i]) {
+                    distinct.insert(words->get_slice(i).to_string());
+                }
+            }
+            if (distinct.size() > max_words) {
+                return nullptr;
+            }
+        }
+    }
+    BinaryColumn words;
+    for (const auto& word : distinct) {
+        words.append(Slice(word));
+    }
+    return create(words);
+}
+
+StatusOr<std::shared_ptr<GlobalDictionary>> GlobalDictionary::create(const BinaryColumn& words) {
+    std::vector<Slice> sorted(words.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        sorted[i] = words.get_slice(i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.size() > static_cast<size_t>(INT32_MAX)) {
+        return Status::InvalidArgument("too many words for a global dictionary");
+    }
+    std::shared_ptr<GlobalDictionary> dict(new GlobalDictionary());
+    dict->_words.append_strings(sorted.data(), sorted.size());
+    // The words' bytes stay put from now on, so the map can point into them.
+    dict->_codes.reserve(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        dict->_codes.emplace(dict->_words.get_slice(i), static_cast<int32_t>(i));
+    }
+    uint64_t id = HashUtil::hash64(sorted.size());
+    for (const Slice& word : sorted) {
+        id = HashUtil::combine(id, HashUtil::hash_bytes(word.data, word.size));
+    }
+    dict->_id = id != 0 ? id : 1;
+    return dict;
+}
+
+int32_t GlobalDictionary::code_of(const Slice& word) const {
+    auto it = _codes.find(word);
+    return it == _codes.end() ? -1 : it->second;
+}
+
+void GlobalDictionary::encode(const BinaryColumn& words, int32_t* codes) const {
+    for (size_t i = 0; i < words.size(); ++i) {
+        codes[i] = code_of(words.get_slice(i));
+    }
+}
+
+StatusOr<ColumnPtr> GlobalDictionary::decode(const Column& codes) const {
+    size_t num_rows = codes.size();
+    ColumnPtr unfolded;
+    const Column* column = &codes;
+    if (codes.is_constant()) {
+        unfolded = ColumnHelper::unfold_const_column(TYPE_INT, num_rows, codes.clone());
+        column = unfolded.get();
+    }
+    const auto* data = reinterpret_cast<const int32_t*>(ColumnHelper::get_data_column(column)->raw_data());
+    const NullData* nulls = ColumnHelper::get_null_data(column);
+    Buffer<Slice> words;
+    words.resize_uninitialized(num_rows);
+    auto size = static_cast<uint32_t>(_words.size());
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (nulls != nullptr && (*nulls)[i]) {
+            words[i] = Slice();
+        } else if (static_cast<uint32_t>(data[i]) < size) {
+            words[i] = _words.get_slice(data[i]);
+        } else {
+            return Status::InvalidArgument("code " + std::to_string(data[i]) + " is not in the global dictionary");
+        }
+    }
+    auto decoded = BinaryColumn::create();
+    decoded->append_strings(words.data(), num_rows);
+    if (!column->is_nullable()) {
+        return ColumnPtr(std::move(decoded));
+    }
+    const auto* nullable = static_cast<const NullableColumn*>(column);
+    auto null_column = std::static_pointer_cast<NullColumn>(nullable->null_column()->clone());
+    auto result = NullableColumn::create(std::move(decoded), std::move(null_column));
+    result->set_has_null(nullable->has_null());
+    return ColumnPtr(std::move(result));
+}
+
+ZoneMapDetail GlobalDictionary::code_zone_map(const ZoneMapDetail& zone_map) const {
+    ZoneMapDetail codes;
+    codes.has_null = zone_map.has_null;
+    codes.has_not_null = zone_map.has_not_null;
+    if (!zone_map.has_not_null) {
+        return codes;
+    }
+    auto word_at = [this](int32_t code) { return _words.get_slice(code); };
+    auto num_words = static_cast<int32_t>(_words.size());
+    // Codes of the words in [min, max]: the first word >= min to the last <= max.
+    int32_t lo = 0;
+    for (int32_t count = num_words; count > 0;) {
+        int32_t half = count / 2;
+        if (word_at(lo + half) < zone_map.min.get_slice()) {
+            lo += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    int32_t hi = lo;
+    for (int32_t count = num_words - lo; count > 0;) {
+        int32_t half = count / 2;
+        if (word_at(hi + half) <= zone_map.max.get_slice()) {
+            hi += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    if (lo < hi) {
+        codes.min.set(lo);
+        codes.max.set(hi - 1);
+    } else {
+        // None of the values is in the dictionary: reading them fails, which
+        // is better than pruning them.
+        codes.min.set(int32_t{0});
+        codes.max.set(std::max(num_words - 1, 0));
+    }
+    return codes;
+}
+
+size_t GlobalDictionary::memory_usage() const {
+    return _words.memory_usage() + _codes.size() * (sizeof(Slice) + sizeof(int32_t) + 2 * sizeof(void*));
+}
+
+namespace {
+
+class DictCodePredicate final : public ColumnPredicate {
+public:
+    DictCodePredicate(const ColumnPredicate& predicate, GlobalDictPtr dict)
+            : ColumnPredicate(TYPE_INT, predicate.column_id()),
+              _dict(std::move(dict)),
+              _pass_null(predicate.can_pass_null()),
+              _debug(predicate.debug_string()) {
+        size_t num_words = _dict->size();
+        _pass.assign(num_words, 0);
+        if (num_words > 0) {
+            predicate.evaluate(&_dict->words(), _pass.data(), 0, num_words);
+        }
+        _passed_before.resize_uninitialized(num_words + 1);
+        _passed_before[0] = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            _passed_before[i + 1] = _passed_before[i] + _pass[i];
+        }
+    }
+
+    PredicateType type() const override { return PredicateType::kDictCode; }
+
+    void evaluate(const Column* column, uint8_t* selection, size_t from, size_t to) const override {
+        if (column->is_constant()) {
+            const Column* value = static_cast<const ConstColumn*>(column)->data_column().get();
+            bool res = value->only_null() ? _pass_null : _pass_code(ColumnHelper::get_data_column(value), 0);
+            memset(selection + from, res, to - from);
+            return;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        for (size_t i = from; i < to; ++i) {
+            selection[i] = _pass_code(data, i);
+        }
+        if (column->is_nullable() && column->has_null()) {
+            const auto& nulls = static_cast<const NullableColumn*>(column)->null_column_data();
+            for (size_t i = from; i < to; ++i) {
+                selection[i] = nulls[i] ? _pass_null : selection[i];
+            }
+        }
+    }
+
+    size_t evaluate_branchless(const Column* column, uint32_t* sel, size_t sel_size) const override {
+        if (column->is_constant()) {
+            uint8_t res = 0;
+            evaluate(column, &res, 0, 1);
+            return res ? sel_size : 0;
+        }
+        const Column* data = ColumnHelper::get_data_column(column);
+        const NullData* nulls = ColumnHelper::get_null_data(column);
+        size_t count = 0;
+        for (size_t i = 0; i < sel_size; ++i) {
+            uint32_t row = sel[i];
+            sel[count] = row;
+            bool is_null = nulls != nullptr && (*nulls)[row];
+            count += is_null ? _pass_null : _pass_code(data, row);
+        }
+        return count;
+    }
+
+    bool can_pass_null() const override { return _pass_null; }
+
+    bool zone_map_filter(const ZoneMapDetail& zone_map) const override {
+        if (zone_map.has_null && _pass_null) {
+            return true;
+        }
+        if (!zone_map.has_not_null) {
+            return false;
+        }
+        auto num_words = static_cast<int32_t>(_dict->size());
+        int32_t lo = std::max(zone_map.min.get_int32(), 0);
+        int32_t hi = std::min(zone_map.max.get_int32(), num_words - 1);
+        return lo <= hi && _passed_before[hi + 1] > _passed_before[lo];
+    }
+
+    std::string debug_string() const override { return "(codes of " + _debug + ")"; }
+
+private:
+    // Codes under NULL rows are arbitrary, hence the bounds check.
+    bool _pass_code(const Column* data, size_t idx) const {
+        auto code = static_cast<uint32_t>(reinterpret_cast<const int32_t*>(data->raw_data())[idx]);
+        return code < _pass.size() && _pass[code];
+    }
+
+    const GlobalDictPtr _dict;
+    const bool _pass_null;
+    const std::string _debug;
+    // Whether the word of each code passes.
+    Filter _pass;
+    // Codes below each code whose words pass.
+    Buffer<uint32_t> _passed_before;
+};
+
+} // namespace
+
+ColumnPredicatePtr new_dict_code_predicate(const ColumnPredicate& predicate, GlobalDictPtr dict) {
+    return std::make_unique<DictCodePredicate>(predicate, std::move(dict));
+}
+
+} // namespace starrocks
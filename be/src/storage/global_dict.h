@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "column/binary_column.h"
+#include "common/status.h"
+#include "storage/column_predicate.h"
+#include "storage/segment/segment.h"
+
+namespace starrocks {
+
+// Dictionary of the distinct values of a low-cardinality VARCHAR column across
+// a whole table, e.g. country or device names. Scans given one (see
+// SegmentReadOptions::global_dicts) return the column as INT codes into it, so
+// filters, hash tables, sorts and exchanges handle four-byte integers instead
+// of strings; a DictDecodeOperator turns the codes back into strings at the
+// output.
+//
+// Words are sorted and a word's code is its position, so codes compare as the
+// words do: ORDER BY, MIN/MAX and range predicates can run on the codes
+// as-is. Codes of two columns only compare equal as their words do when they
+// share the dictionary, which joins on coded keys therefore need; build it
+// from the segments of both tables. Slots of codes carry the dictionary's id
+// (SlotDescriptor::dict_id), and joins and runtime filters refuse to compare
+// codes of different dictionaries.
+//
+// A dictionary is immutable. Once rows with new values are loaded, scans
+// reading them fail with NotFound, and the dictionary has to be rebuilt.
+class GlobalDictionary {
+public:
+    // The distinct non-NULL values of column |column_id| of |segments|, or
+    // nullptr when there are more than config::global_dict_max_words.
+    static StatusOr<std::shared_ptr<GlobalDictionary>> build(const std::vector<SegmentSharedPtr>& segments,
+                                                             ColumnId column_id);
+    // Of the distinct values of |words|, a non-nullable VARCHAR column.
+    static StatusOr<std::shared_ptr<GlobalDictionary>> create(const BinaryColumn& words);
+
+    // Identifies the dictionary by its words, so that dictionaries built
+    // from the same values anywhere share it. Codes of two columns compare
+    // as their words do exactly when their dictionaries' ids are equal.
+    // Never 0.
+    uint64_t id() const { return _id; }
+    size_t size() const { return _words.size(); }
+    const BinaryColumn& words() const { return _words; }
+    Slice word(int32_t code) const { return _words.get_slice(code); }
+    // The code of |word|, or -1 if it is not in the dictionary.
+    int32_t code_of(const Slice& word) const;
+
+    // Writes the codes of the values of |words|, a non-nullable VARCHAR
+    // column, to |codes|; -1 for those not in the dictionary.
+    void encode(const BinaryColumn& words, int32_t* codes) const;
+    // The VARCHAR column of the words of |codes|, an INT column of codes that
+    // may be nullable; NULL rows stay NULL.
+    StatusOr<ColumnPtr> decode(const Column& codes) const;
+
+    // Zone map of the codes of the values a VARCHAR |zone_map| covers.
+    ZoneMapDetail code_zone_map(const ZoneMapDetail& zone_map) const;
+
+    size_t memory_usage() const;
+
+private:
+    GlobalDictionary() = default;
+
+    uint64_t _id = 0;
+    BinaryColumn _words;
+    std::unordered_map<Slice, int32_t, SliceHash> _codes;
+};
+
+using GlobalDictPtr = std::shared_ptr<const GlobalDictionary>;
+
+// |predicate|, on a VARCHAR column, as a predicate on the column's codes in
+// |dict|: the predicate is evaluated once on every word, after which each row
+// costs one lookup of its code.
+ColumnPredicatePtr new_dict_code_predicate(const ColumnPredicate& predicate, GlobalDictPtr dict);
+
+} // namespace starrocks
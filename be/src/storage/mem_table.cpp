@@ -0,0 +1,40 @@
+#include "storage/mem_table.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace starrocks {
+
+MemTable::MemTable(RowDescriptor schema, const SortKeyEncoder* sort_keys)
+        : _schema(std::move(schema)), _sort_keys(sort_keys), _rows(create_chunk_for_row_desc(_schema)) {}
+
+void MemTable::insert(const Chunk& chunk, const uint32_t* indexes, uint32_t from, uint32_t size) {
+    for (const auto& slot : _schema) {
+        _rows->get_column_by_slot_id(slot.id)->append_selective(*chunk.get_column_by_slot_id(slot.id), indexes, from,
+                                                                 size);
+    }
+}
+
+Status MemTable::flush(const std::string& path, const SegmentWriterOptions& options) {
+    SortKeys keys;
+    _sort_keys->encode(*_rows, &keys);
+    std::vector<uint32_t> order(_rows->num_rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+        return compare_sort_keys(keys.data(a), keys.size(a), keys.data(b), keys.size(b)) < 0;
+    });
+
+    SegmentWriter writer(path, _schema, options);
+    RETURN_IF_ERROR(writer.init());
+    ChunkUniquePtr sorted = _rows->clone_empty(DEFAULT_CHUNK_SIZE);
+    for (size_t from = 0; from < order.size(); from += DEFAULT_CHUNK_SIZE) {
+        sorted->reset();
+        auto size = static_cast<uint32_t>(std::min(DEFAULT_CHUNK_SIZE, order.size() - from));
+        sorted->append_selective(*_rows, order.data(), static_cast<uint32_t>(from), size);
+        RETURN_IF_ERROR(writer.append_chunk(*sorted));
+    }
+    return writer.finalize();
+}
+
+} // namespace starrocks
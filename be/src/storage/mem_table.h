@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include "column/chunk.h"
+#include "common/status.h"
+#include "exec/sort_key.h"
+#include "runtime/descriptors.h"
+#include "storage/segment/segment_writer.h"
+
+namespace starrocks {
+
+// Rows buffered for one tablet by a load, written out as one segment sorted
+// by the tablet's sort key once enough have accumulated. Rows are only
+// sorted when flushed: on normalized keys (see SortKeyEncoder) encoded for
+// all of them at once, so each comparison is one memcmp.
+class MemTable {
+public:
+    // |sort_keys| is prepared for |schema| and outlives the memtable.
+    MemTable(RowDescriptor schema, const SortKeyEncoder* sort_keys);
+
+    // Appends rows indexes[from, from + size) of |chunk|, which holds a
+    // column for every slot of the schema.
+    void insert(const Chunk& chunk, const uint32_t* indexes, uint32_t from, uint32_t size);
+
+    size_t num_rows() const { return _rows->num_rows(); }
+    size_t memory_usage() const { return _rows->memory_usage(); }
+
+    // Writes the rows, sorted, to a new segment at |path|.
+    Status flush(const std::string& path, const SegmentWriterOptions& options);
+
+private:
+    const RowDescriptor _schema;
+    const SortKeyEncoder* _sort_keys;
+    ChunkPtr _rows;
+};
+
+} // namespace starrocks
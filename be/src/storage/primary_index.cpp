@@ -0,0 +1,519 @@
+#include "storage/primary_index.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/config.h"
+#include "util/coding.h"
+#include "util/hash_util.h"
+
+namespace starrocks {
+
+// Layout of the L1 file of a persistent primary index:
+//
+//   magic
+//   pages of buckets 0, 1, ...; an empty bucket has no page
+//   bucket offsets (u64 each, one more than there are buckets)
+//   bucket bits (u32) | covered segments (u32) | offsets checksum (u32) | magic
+//
+// A page is a checksum (u32) of the entries that follow it, each the key as a
+// length-prefixed slice and its location (u64).
+constexpr uint32_t kPrimaryIndexMagic = 0x49504B52; // "RKPI"
+constexpr size_t kPrimaryIndexTrailerSize = 16;
+constexpr uint32_t kMaxBucketBits = 40;
+// Written out once this many bytes are buffered.
+constexpr size_t kWriteBufferBytes = 1024 * 1024;
+
+static Status io_error(const std::string& what) {
+    return Status::IOError(what + ": " + std::strerror(errno));
+}
+
+static ALWAYS_INLINE uint64_t key_hash(const Slice& key) {
+    return HashUtil::hash_bytes(key.data, key.size);
+}
+
+static ALWAYS_INLINE size_t bucket_of(uint64_t hash, uint32_t bits) {
+    return bits == 0 ? 0 : hash >> (64 - bits);
+}
+
+static uint32_t page_checksum(const uint8_t* data, size_t len) {
+    return static_cast<uint32_t>(HashUtil::hash_bytes(data, len));
+}
+
+PrimaryHashTable::Slot* PrimaryHashTable::find(const Slice& key, uint64_t hash) {
+    if (_slots.empty()) {
+        return nullptr;
+    }
+    for (size_t idx = hash & _mask;; idx = (idx + 1) & _mask) {
+        Slot* slot = _slots.data() + idx;
+        if (slot->key.size == 0) {
+            return nullptr;
+        }
+        if (slot->hash == hash && slot->key == key) {
+            return slot;
+        }
+    }
+}
+
+PrimaryHashTable::Slot* PrimaryHashTable::emplace(const Slice& key, uint64_t hash, bool* inserted) {
+    if (UNLIKELY((_size + 1) * 2 > _slots.size())) {
+        _grow();
+    }
+    for (size_t idx = hash & _mask;; idx = (idx + 1) & _mask) {
+        Slot* slot = _slots.data() + idx;
+        if (slot->key.size == 0) {
+            uint8_t* copy = _pool.allocate(key.size, 1);
+            memcpy(copy, key.data, key.size);
+            slot->key = Slice(copy, key.size);
+            slot->hash = hash;
+            slot->location = kNoRowLocation;
+            _size++;
+            *inserted = true;
+            return slot;
+        }
+        if (slot->hash == hash && slot->key == key) {
+            *inserted = false;
+            return slot;
+        }
+    }
+}
+
+void PrimaryHashTable::erase(Slot* slot) {
+    size_t hole = slot - _slots.data();
+    for (size_t idx = (hole + 1) & _mask;; idx = (idx + 1) & _mask) {
+        Slot& next = _slots[idx];
+        if (next.key.size == 0) {
+            break;
+        }
+        // |next| may move into the hole unless its home lies cyclically in
+        // (hole, idx].
+        size_t home = next.hash & _mask;
+        bool stays = hole <= idx ? (hole < home && home <= idx) : (hole < home || home <= idx);
+        if (!stays) {
+            _slots[hole] = next;
+            hole = idx;
+        }
+    }
+    _slots[hole].key = Slice();
+    _size--;
+}
+
+void PrimaryHashTable::clear() {
+    _slots.shrink_to_empty();
+    _mask = 0;
+    _size = 0;
+    _pool.clear();
+}
+
+void PrimaryHashTable::_grow() {
+    Buffer<Slot> slots;
+    slots.resize(_slots.empty() ? kInitialCapacity : _slots.size() * 2);
+    size_t mask = slots.size() - 1;
+    for (const Slot& slot : _slots) {
+        if (slot.key.size != 0) {
+            size_t idx = slot.hash & mask;
+            while (slots[idx].key.size != 0) {
+                idx = (idx + 1) & mask;
+            }
+            slots[idx] = slot;
+        }
+    }
+    _slots.swap(slots);
+    _mask = mask;
+}
+
+// Writes a new L1 file sequentially, bucket by bucket.
+class PrimaryIndexFileWriter {
+public:
+    PrimaryIndexFileWriter(std::string path, uint32_t bucket_bits)
+            : _path(std::move(path)), _bucket_bits(bucket_bits) {
+        _offsets.reserve((size_t{1} << bucket_bits) + 1);
+    }
+
+    ~PrimaryIndexFileWriter() {
+        if (_fd >= 0) {
+            ::close(_fd);
+            ::unlink(_path.c_str());
+        }
+    }
+
+    Status init() {
+        _fd = ::open(_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+        if (_fd < 0) {
+            return io_error("failed to create primary index file " + _path);
+        }
+        put_fixed32(&_buf, kPrimaryIndexMagic);
+        return Status::OK();
+    }
+
+    // Entries must come in bucket order.
+    Status add(const Slice& key, uint64_t hash, RowLocation location) {
+        size_t bucket = bucket_of(hash, _bucket_bits);
+        if (bucket != _bucket) {
+            RETURN_IF_ERROR(_finish_buckets(bucket));
+        }
+        put_length_prefixed_slice(&_page, key);
+        put_fixed64(&_page, location);
+        return Status::OK();
+    }
+
+    // Writes the offsets and the trailer and syncs the file.
+    Status finish(uint32_t covered_segments) {
+        RETURN_IF_ERROR(_finish_buckets(size_t{1} << _bucket_bits));
+        _offsets.push_back(_file_size + _buf.size());
+        size_t offsets_begin = _buf.size();
+        for (uint64_t offset : _offsets) {
+            put_fixed64(&_buf, offset);
+        }
+        uint32_t checksum = page_checksum(_buf.data() + offsets_begin, _buf.size() - offsets_begin);
+        put_fixed32(&_buf, _bucket_bits);
+        put_fixed32(&_buf, covered_segments);
+        put_fixed32(&_buf, checksum);
+        put_fixed32(&_buf, kPrimaryIndexMagic);
+        RETURN_IF_ERROR(_flush_buf());
+        if (::fsync(_fd) != 0) {
+            return io_error("failed to sync primary index file " + _path);
+        }
+        ::close(_fd);
+        _fd = -1;
+        return Status::OK();
+    }
+
+private:
+    // Ends the page of the current bucket and every bucket below |bucket|.
+    Status _finish_buckets(size_t bucket) {
+        while (_bucket < bucket) {
+            _offsets.push_back(_file_size + _buf.size());
+            if (!_page.empty()) {
+                put_fixed32(&_buf, page_checksum(_page.data(), _page.size()));
+                _buf.append(_page.data(), _page.size());
+                _page.clear();
+            }
+            _bucket++;
+        }
+        return _buf.size() >= kWriteBufferBytes ? _flush_buf() : Status::OK();
+    }
+
+    Status _flush_buf() {
+        const uint8_t* data = _buf.data();
+        size_t len = _buf.size();
+        while (len > 0) {
+            ssize_t n = ::write(_fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return io_error("failed to write primary index file " + _path);
+            }
+            data += n;
+            len -= n;
+        }
+        _file_size += _buf.size();
+        _buf.clear();
+        return Status::OK();
+    }
+
+    const std::string _path;
+    const uint32_t _bucket_bits;
+    int _fd = -1;
+    uint64_t _file_size = 0;
+    size_t _bucket = 0;
+    std::vector<uint64_t> _offsets;
+    Buffer<uint8_t> _page;
+    Buffer<uint8_t> _buf;
+};
+
+PrimaryIndex::PrimaryIndex(std::string path) : _path(std::move(path)) {}
+
+PrimaryIndex::~PrimaryIndex() = default;
+
+StatusOr<uint32_t> PrimaryIndex::load() {
+    _l0.clear();
+    struct stat st;
+    if (!is_persistent() || ::stat(_path.c_str(), &st) != 0) {
+        return 0;
+    }
+    ASSIGN_OR_RETURN(auto file, io::LocalFile::open(_path));
+    auto corrupted = [this](const char* what) {
+        return Status::Corruption("primary index file " + _path + ": " + what);
+    };
+    int64_t file_size = file->size();
+    if (file_size < static_cast<int64_t>(sizeof(uint32_t) + kPrimaryIndexTrailerSize)) {
+        return corrupted("too short");
+    }
+    uint8_t trailer[kPrimaryIndexTrailerSize];
+    RETURN_IF_ERROR(file->read_at(file_size - kPrimaryIndexTrailerSize, trailer, sizeof(trailer)));
+    Slice input(trailer, sizeof(trailer));
+    uint32_t bucket_bits, covered_segments, checksum, magic;
+    get_fixed32(&input, &bucket_bits);
+    get_fixed32(&input, &covered_segments);
+    get_fixed32(&input, &checksum);
+    get_fixed32(&input, &magic);
+    if (magic != kPrimaryIndexMagic || bucket_bits > kMaxBucketBits) {
+        return corrupted("bad trailer");
+    }
+    size_t num_offsets = (size_t{1} << bucket_bits) + 1;
+    int64_t offsets_size = num_offsets * sizeof(uint64_t);
+    int64_t offsets_begin = file_size - kPrimaryIndexTrailerSize - offsets_size;
+    if (offsets_begin < static_cast<int64_t>(sizeof(uint32_t))) {
+        return corrupted("too short");
+    }
+    std::vector<uint64_t> offsets(num_offsets);
+    RETURN_IF_ERROR(file->read_at(offsets_begin, reinterpret_cast<uint8_t*>(offsets.data()), offsets_size));
+    if (page_checksum(reinterpret_cast<const uint8_t*>(offsets.data()), offsets_size) != checksum) {
+        return corrupted("checksum mismatch of the bucket offsets");
+    }
+    if (offsets.front() != sizeof(uint32_t) || offsets.back() != static_cast<uint64_t>(offsets_begin) ||
+        !std::is_sorted(offsets.begin(), offsets.end())) {
+        return corrupted("bad bucket offsets");
+    }
+    _l1_file = std::move(file);
+    _l1_offsets = std::move(offsets);
+    _l1_bucket_bits = bucket_bits;
+    return covered_segments;
+}
+
+void PrimaryIndex::_hash_keys(const Slice* keys, size_t num_keys) {
+    _hashes.resize_uninitialized(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        _hashes[i] = key_hash(keys[i]);
+    }
+}
+
+Status PrimaryIndex::upsert(const Slice* keys, size_t num_keys, const RowLocation* locations,
+                            std::vector<RowLocation>* replaced) {
+    _hash_keys(keys, num_keys);
+    // Keys new to L0 may still be in L1.
+    std::vector<uint32_t> l1_keys;
+    for (size_t i = 0; i < num_keys; ++i) {
+        bool inserted;
+        auto* slot = _l0.emplace(keys[i], _hashes[i], &inserted);
+        if (inserted) {
+            if (_l1_file != nullptr) {
+                l1_keys.push_back(static_cast<uint32_t>(i));
+            }
+        } else if (slot->location != kNoRowLocation) {
+            replaced->push_back(slot->location);
+        }
+        slot->location = locations[i];
+    }
+    if (l1_keys.empty()) {
+        return Status::OK();
+    }
+    std::vector<RowLocation> found(num_keys, kNoRowLocation);
+    RETURN_IF_ERROR(_l1_get(l1_keys, keys, found.data()));
+    for (uint32_t i : l1_keys) {
+        if (found[i] != kNoRowLocation) {
+            replaced->push_back(found[i]);
+        }
+    }
+    return Status::OK();
+}
+
+Status PrimaryIndex::erase(const Slice* keys, size_t num_keys, std::vector<RowLocation>* erased) {
+    _hash_keys(keys, num_keys);
+    std::vector<uint32_t> l1_keys;
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto* slot = _l0.find(keys[i], _hashes[i]);
+        if (slot == nullptr) {
+            if (_l1_file != nullptr) {
+                l1_keys.push_back(static_cast<uint32_t>(i));
+            }
+            continue;
+        }
+        if (slot->location != kNoRowLocation) {
+            erased->push_back(slot->location);
+        }
+        // Only a persistent index needs the slot, to mask the key in L1.
+        if (_l1_file != nullptr) {
+            slot->location = kNoRowLocation;
+        } else {
+            _l0.erase(slot);
+        }
+    }
+    if (l1_keys.empty()) {
+        return Status::OK();
+    }
+    std::vector<RowLocation> found(num_keys, kNoRowLocation);
+    RETURN_IF_ERROR(_l1_get(l1_keys, keys, found.data()));
+    for (uint32_t i : l1_keys) {
+        if (found[i] == kNoRowLocation) {
+            continue;
+        }
+        // A key erased twice in the batch is found in L1 both times.
+        bool inserted;
+        _l0.emplace(keys[i], _hashes[i], &inserted);
+        if (inserted) {
+            erased->push_back(found[i]);
+        }
+    }
+    return Status::OK();
+}
+
+Status PrimaryIndex::get(const Slice* keys, size_t num_keys, RowLocation* locations) {
+    _hash_keys(keys, num_keys);
+    std::vector<uint32_t> l1_keys;
+    for (size_t i = 0; i < num_keys; ++i) {
+        auto* slot = _l0.find(keys[i], _hashes[i]);
+        locations[i] = slot != nullptr ? slot->location : kNoRowLocation;
+        if (slot == nullptr && _l1_file != nullptr) {
+            l1_keys.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return l1_keys.empty() ? Status::OK() : _l1_get(l1_keys, keys, locations);
+}
+
+Status PrimaryIndex::_read_l1_page(size_t bucket, Buffer<uint8_t>* page) {
+    uint64_t begin = _l1_offsets[bucket];
+    uint64_t size = _l1_offsets[bucket + 1] - begin;
+    page->resize_uninitialized(size);
+    if (size == 0) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_l1_file->read_at(begin, page->data(), size));
+    _stats.l1_pages_read++;
+    Slice input(page->data(), size);
+    uint32_t checksum;
+    if (!get_fixed32(&input, &checksum) || page_checksum(page->data() + sizeof(checksum), input.size) != checksum) {
+        return Status::Corruption("primary index file " + _path + ": checksum mismatch of bucket " +
+                                  std::to_string(bucket));
+    }
+    return Status::OK();
+}
+
+Status PrimaryIndex::_l1_get(const std::vector<uint32_t>& indexes, const Slice* keys, RowLocation* locations) {
+    std::vector<std::pair<size_t, uint32_t>> lookups;
+    lookups.reserve(indexes.size());
+    for (uint32_t i : indexes) {
+        lookups.emplace_back(bucket_of(_hashes[i], _l1_bucket_bits), i);
+    }
+    std::sort(lookups.begin(), lookups.end());
+    for (size_t begin = 0; begin < lookups.size();) {
+        size_t bucket = lookups[begin].first;
+        size_t end = begin + 1;
+        while (end < lookups.size() && lookups[end].first == bucket) {
+            ++end;
+        }
+        RETURN_IF_ERROR(_read_l1_page(bucket, &_page));
+        Slice input(_page.data(), _page.size());
+        if (!input.empty()) {
+            input.remove_prefix(sizeof(uint32_t));
+        }
+        while (!input.empty()) {
+            Slice key;
+            uint64_t location;
+            if (!get_length_prefixed_slice(&input, &key) || !get_fixed64(&input, &location)) {
+                return Status::Corruption("primary index file " + _path + ": bad entry in bucket " +
+                                          std::to_string(bucket));
+            }
+            for (size_t j = begin; j < end; ++j) {
+                if (keys[lookups[j].second] == key) {
+                    locations[lookups[j].second] = location;
+                }
+            }
+        }
+        begin = end;
+    }
+    return Status::OK();
+}
+
+bool PrimaryIndex::need_flush() const {
+    return is_persistent() && static_cast<int64_t>(_l0.memory_usage()) > config::primary_index_l0_max_bytes;
+}
+
+Status PrimaryIndex::flush(uint32_t covered_segments) {
+    if (!is_persistent()) {
+        return Status::OK();
+    }
+    // Size the buckets for L1 plus every key of L0, an upper bound.
+    uint64_t data_bytes = _l1_offsets.empty() ? 0 : _l1_offsets.back();
+    for (const auto& slot : _l0.slots()) {
+        data_bytes += slot.key.size == 0 ? 0 : slot.key.size + 2 * sizeof(uint64_t);
+    }
+    uint64_t num_pages = data_bytes / std::max<int64_t>(config::primary_index_page_bytes, 1);
+    uint32_t bucket_bits = _l1_bucket_bits;
+    while (bucket_bits < kMaxBucketBits && (uint64_t{1} << bucket_bits) < num_pages) {
+        bucket_bits++;
+    }
+
+    // Slots of L0, in hash order and so in bucket order for any bucket count.
+    std::vector<const PrimaryHashTable::Slot*> l0_slots;
+    l0_slots.reserve(_l0.size());
+    for (const auto& slot : _l0.slots()) {
+        if (slot.key.size != 0) {
+            l0_slots.push_back(&slot);
+        }
+    }
+    std::sort(l0_slots.begin(), l0_slots.end(), [](const auto* a, const auto* b) { return a->hash < b->hash; });
+
+    std::string tmp_path = _path + ".tmp";
+    PrimaryIndexFileWriter writer(tmp_path, bucket_bits);
+    RETURN_IF_ERROR(writer.init());
+    struct Entry {
+        Slice key;
+        uint64_t hash;
+        RowLocation location;
+    };
+    std::vector<Entry> entries;
+    auto next_l0 = l0_slots.begin();
+    size_t num_old_buckets = std::max<size_t>(_l1_num_buckets(), 1);
+    for (size_t bucket = 0; bucket < num_old_buckets; ++bucket) {
+        entries.clear();
+        if (_l1_file != nullptr) {
+            RETURN_IF_ERROR(_read_l1_page(bucket, &_page));
+            Slice input(_page.data(), _page.size());
+            if (!input.empty()) {
+                input.remove_prefix(sizeof(uint32_t));
+            }
+            while (!input.empty()) {
+                Entry entry;
+                if (!get_length_prefixed_slice(&input, &entry.key) || !get_fixed64(&input, &entry.location)) {
+                    return Status::Corruption("primary index file " + _path + ": bad entry in bucket " +
+                                              std::to_string(bucket));
+                }
+                entry.hash = key_hash(entry.key);
+                // L0 holds the newer state of the key.
+                if (_l0.find(entry.key, entry.hash) == nullptr) {
+                    entries.push_back(entry);
+                }
+            }
+        }
+        for (; next_l0 != l0_slots.end() && bucket_of((*next_l0)->hash, _l1_bucket_bits) == bucket; ++next_l0) {
+            if ((*next_l0)->location != kNoRowLocation) {
+                entries.push_back({(*next_l0)->key, (*next_l0)->hash, (*next_l0)->location});
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+        for (const Entry& entry : entries) {
+            RETURN_IF_ERROR(writer.add(entry.key, entry.hash, entry.location));
+        }
+    }
+    RETURN_IF_ERROR(writer.finish(covered_segments));
+    if (::rename(tmp_path.c_str(), _path.c_str()) != 0) {
+        return io_error("failed to publish primary index file " + _path);
+    }
+    _l1_file.reset();
+    _l1_offsets.clear();
+    _l1_bucket_bits = 0;
+    RETURN_IF_ERROR(load().status());
+    _stats.flushes++;
+    return Status::OK();
+}
+
+Status PrimaryIndex::reset() {
+    _l0.clear();
+    _l1_file.reset();
+    _l1_offsets.clear();
+    _l1_bucket_bits = 0;
+    if (is_persistent() && ::unlink(_path.c_str()) != 0 && errno != ENOENT) {
+        return io_error("failed to remove primary index file " + _path);
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "column/buffer.h"
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "io/random_access_file.h"
+#include "runtime/mem_pool.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Where a row of a primary-key table lives: the segment id in the high 32
+// bits, the row id within the segment in the low ones.
+using RowLocation = uint64_t;
+constexpr RowLocation kNoRowLocation = UINT64_MAX;
+
+inline RowLocation make_row_location(uint32_t segment_id, uint32_t rowid) {
+    return static_cast<uint64_t>(segment_id) << 32 | rowid;
+}
+inline uint32_t row_location_segment(RowLocation location) {
+    return static_cast<uint32_t>(location >> 32);
+}
+inline uint32_t row_location_rowid(RowLocation location) {
+    return static_cast<uint32_t>(location);
+}
+
+// Open-addressing, linearly probed table from encoded primary keys to row
+// locations, kept at most half full. Keys are copied to a pool; a slot is
+// empty while its key is, which an encoded key never is.
+class PrimaryHashTable {
+public:
+    struct Slot {
+        Slice key;
+        uint64_t hash;
+        RowLocation location;
+    };
+
+    static constexpr size_t kInitialCapacity = 1024;
+
+    PrimaryHashTable() = default;
+
+    DISALLOW_COPY_AND_MOVE(PrimaryHashTable);
+
+    size_t size() const { return _size; }
+    const Buffer<Slot>& slots() const { return _slots; }
+    size_t memory_usage() const { return _slots.allocated_bytes() + _pool.reserved_bytes(); }
+
+    void prefetch(uint64_t hash) const { PREFETCH(_slots.data() + (hash & _mask)); }
+
+    // nullptr if |key| has no slot.
+    Slot* find(const Slice& key, uint64_t hash);
+    // The slot of |key|; if there was none, a new one with location
+    // kNoRowLocation and *|inserted| set.
+    Slot* emplace(const Slice& key, uint64_t hash, bool* inserted);
+    // Frees |slot|, shifting back the slots probed past it.
+    void erase(Slot* slot);
+
+    void clear();
+
+private:
+    void _grow();
+
+    Buffer<Slot> _slots;
+    size_t _mask = 0;
+    size_t _size = 0;
+    MemPool _pool;
+};
+
+struct PrimaryIndexStats {
+    // Pages of the on-disk part read by lookups.
+    int64_t l1_pages_read = 0;
+    // Merges of the in-memory part into the on-disk part.
+    int64_t flushes = 0;
+};
+
+// Maps the encoded primary key of every row of a primary-key table to its
+// location, so a write learns which older rows its keys replace and can mark
+// them deleted there and then; reads never merge versions of a row.
+//
+// Without a path the index lives in memory. With one it is persistent, in
+// two levels: L0, an in-memory hash table of the changes since the last
+// flush(), where an erased key keeps its slot with location kNoRowLocation to
+// mask older entries; and L1, a file of hash buckets of about config::
+// primary_index_page_bytes each, of which only the bucket offsets stay in
+// memory - some 2 bytes per KB of keys. A lookup missing L0 reads the page of
+// its bucket; a batch reads each page once. flush() rewrites L1 with L0
+// merged in, bucket by bucket, so it needs no more memory than one page
+// beyond L0.
+//
+// Buckets are numbered by the high bits of the key hash and their count is a
+// power of two, so when L1 grows every old bucket splits into consecutive
+// new ones and the merge stays a single pass.
+//
+// Not thread-safe; a table serializes its writes.
+class PrimaryIndex {
+public:
+    explicit PrimaryIndex(std::string path = "");
+    ~PrimaryIndex();
+
+    bool is_persistent() const { return !_path.empty(); }
+
+    // Drops L0 and loads L1 if its file exists. Returns the number of
+    // segments L1 covers (see flush()); the writes to later ones have to be
+    // replayed.
+    StatusOr<uint32_t> load();
+
+    // Points keys[i] at locations[i], in order, and appends the locations
+    // the keys had, if any, to |replaced|.
+    Status upsert(const Slice* keys, size_t num_keys, const RowLocation* locations,
+                  std::vector<RowLocation>* replaced);
+    // Removes the keys and appends the locations they had, if any, to
+    // |erased|.
+    Status erase(const Slice* keys, size_t num_keys, std::vector<RowLocation>* erased);
+    // kNoRowLocation for absent keys.
+    Status get(const Slice* keys, size_t num_keys, RowLocation* locations);
+
+    // Whether L0 outgrew config::primary_index_l0_max_bytes.
+    bool need_flush() const;
+    // Merges L0 into a new L1, which covers the writes to the segments with
+    // ids below |covered_segments|. A no-op for an in-memory index.
+    Status flush(uint32_t covered_segments);
+
+    // Forgets every key, in memory and on disk.
+    Status reset();
+
+    size_t memory_usage() const { return _l0.memory_usage() + _l1_offsets.capacity() * sizeof(uint64_t); }
+    const PrimaryIndexStats& stats() const { return _stats; }
+
+private:
+    // Looks the keys at |indexes| up in L1, setting locations[i] for each
+    // key i found.
+    Status _l1_get(const std::vector<uint32_t>& indexes, const Slice* keys, RowLocation* locations);
+    Status _read_l1_page(size_t bucket, Buffer<uint8_t>* page);
+    size_t _l1_num_buckets() const { return _l1_offsets.empty() ? 0 : _l1_offsets.size() - 1; }
+    void _hash_keys(const Slice* keys, size_t num_keys);
+
+    const std::string _path;
+    PrimaryHashTable _l0;
+
+    io::RandomAccessFilePtr _l1_file;
+    // Bucket b is bytes [_l1_offsets[b], _l1_offsets[b + 1]) of the file.
+    std::vector<uint64_t> _l1_offsets;
+    uint32_t _l1_bucket_bits = 0;
+
+    Buffer<uint64_t> _hashes;
+    Buffer<uint8_t> _page;
+    PrimaryIndexStats _stats;
+};
+
+} // namespace starrocks
@@ -0,0 +1,644 @@
+#include "storage/primary_key_table.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+
+#include "column/column_helper.h"
+#include "column/nullable_column.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+// Layout of the meta file of a primary-key table:
+//
+//   version, next segment id, segment count (varints)
+//   per segment: id (varint), delete vector (see DelVector::serialize())
+//   checksum (u32) | magic
+constexpr uint32_t kPrimaryKeyMetaMagic = 0x4D4B5052; // "RPKM"
+
+// Page-sized buffers a column being compacted needs: the page, its encodings
+// and its compressed form.
+constexpr int64_t kCompactionBuffersPerColumn = 6;
+
+static Status io_error(const std::string& what) {
+    return Status::IOError(what + ": " + std::strerror(errno));
+}
+
+// Writes |data| to a temporary file and moves it to |path| once synced.
+static Status write_file_atomically(const std::string& path, const Buffer<uint8_t>& data) {
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return io_error("failed to create " + tmp_path);
+    }
+    const uint8_t* p = data.data();
+    size_t len = data.size();
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            Status st = io_error("failed to write " + tmp_path);
+            ::close(fd);
+            ::unlink(tmp_path.c_str());
+            return st;
+        }
+        p += n;
+        len -= n;
+    }
+    if (::fsync(fd) != 0 || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        Status st = io_error("failed to publish " + path);
+        ::close(fd);
+        ::unlink(tmp_path.c_str());
+        return st;
+    }
+    ::close(fd);
+    return Status::OK();
+}
+
+int64_t PrimaryKeyTableVersion::num_rows() const {
+    int64_t rows = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        rows += segments[i]->num_rows() - del_vectors[i]->cardinality();
+    }
+    return rows;
+}
+
+PrimaryKeyTable::PrimaryKeyTable(std::string dir, RowDescriptor schema, PrimaryKeyTableOptions options)
+        : _dir(std::move(dir)),
+          _schema(std::move(schema)),
+          _options(std::move(options)),
+          _index(_options.persistent_index ? _dir + "/primary_index" : "") {}
+
+PrimaryKeyTable::~PrimaryKeyTable() = default;
+
+StatusOr<std::unique_ptr<PrimaryKeyTable>> PrimaryKeyTable::open(std::string dir, RowDescriptor schema,
+                                                                 PrimaryKeyTableOptions options) {
+    if (options.num_key_columns == 0 || options.num_key_columns > schema.size()) {
+        return Status::InvalidArgument("primary key of " + std::to_string(options.num_key_columns) +
+                                       " columns for a table of " + std::to_string(schema.size()));
+    }
+    for (size_t k = 0; k < options.num_key_columns; ++k) {
+        if (schema[k].nullable) {
+            return Status::InvalidArgument("primary key column " + std::to_string(k) + " is nullable");
+        }
+    }
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        return io_error("failed to create primary key table directory " + dir);
+    }
+    std::unique_ptr<PrimaryKeyTable> table(new PrimaryKeyTable(std::move(dir), std::move(schema), options));
+    for (size_t k = 0; k < table->_options.num_key_columns; ++k) {
+        table->_key_layout.types.push_back(table->_schema[k].type);
+        table->_key_layout.nullable.push_back(0);
+    }
+    RETURN_IF_ERROR(table->_load());
+    return table;
+}
+
+std::string PrimaryKeyTable::_segment_path(uint32_t segment_id) const {
+    return _dir + "/" + std::to_string(segment_id) + ".seg";
+}
+
+Status PrimaryKeyTable::_load() {
+    auto version = std::make_shared<PrimaryKeyTableVersion>();
+    std::string path = _dir + "/meta";
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0) {
+        ASSIGN_OR_RETURN(auto file, io::LocalFile::open(path));
+        Buffer<uint8_t> data;
+        data.resize_uninitialized(file->size());
+        RETURN_IF_ERROR(file->read_at(0, data.data(), data.size()));
+        auto corrupted = [&path]() { return Status::Corruption("primary key table meta file " + path); };
+        if (data.size() < 2 * sizeof(uint32_t)) {
+            return corrupted();
+        }
+        Slice trailer(data.data() + data.size() - 2 * sizeof(uint32_t), 2 * sizeof(uint32_t));
+        uint32_t checksum, magic;
+        get_fixed32(&trailer, &checksum);
+        get_fixed32(&trailer, &magic);
+        size_t body_size = data.size() - 2 * sizeof(uint32_t);
+        if (magic != kPrimaryKeyMetaMagic ||
+            static_cast<uint32_t>(HashUtil::hash_bytes(data.data(), body_size)) != checksum) {
+            return corrupted();
+        }
+        Slice input(data.data(), body_size);
+        uint64_t version_number, next_segment_id, num_segments;
+        if (!get_varint64(&input, &version_number) || !get_varint64(&input, &next_segment_id) ||
+            !get_varint64(&input, &num_segments) || num_segments > input.size) {
+            return corrupted();
+        }
+        version->version = static_cast<int64_t>(version_number);
+        version->next_segment_id = static_cast<uint32_t>(next_segment_id);
+        for (size_t i = 0; i < num_segments; ++i) {
+            uint64_t id;
+            auto del_vector = std::make_shared<DelVector>();
+            if (!get_varint64(&input, &id) || id >= next_segment_id ||
+                !DelVector::deserialize(&input, del_vector.get())) {
+                return corrupted();
+            }
+            ASSIGN_OR_RETURN(auto segment, Segment::open(_segment_path(id)));
+            if (segment->num_columns() != _schema.size()) {
+                return Status::Corruption("segment " + segment->path() + " does not match its table's schema");
+            }
+            version->segment_ids.push_back(static_cast<uint32_t>(id));
+            version->segments.push_back(std::move(segment));
+            version->del_vectors.push_back(std::move(del_vector));
+        }
+    }
+    RETURN_IF_ERROR(_load_index(*version));
+    _version = std::move(version);
+    return Status::OK();
+}
+
+Status PrimaryKeyTable::_load_index(const PrimaryKeyTableVersion& version) {
+    ASSIGN_OR_RETURN(uint32_t covered, _index.load());
+    // An index ahead of the table would point at rows it never committed.
+    if (covered > version.next_segment_id) {
+        RETURN_IF_ERROR(_index.reset());
+        covered = 0;
+    }
+    SegmentReadOptions options;
+    for (size_t k = 0; k < _options.num_key_columns; ++k) {
+        options.column_ids.push_back(static_cast<ColumnId>(k));
+    }
+    Buffer<uint8_t> bytes;
+    std::vector<Slice> keys;
+    std::vector<RowLocation> locations;
+    std::vector<RowLocation> replaced;
+    for (size_t s = 0; s < version.segments.size(); ++s) {
+        uint32_t segment_id = version.segment_ids[s];
+        if (segment_id < covered) {
+            continue;
+        }
+        const DelVector& del_vector = *version.del_vectors[s];
+        SegmentIterator iter(version.segments[s], options);
+        RETURN_IF_ERROR(iter.init());
+        uint32_t rowid = 0;
+        while (true) {
+            ChunkPtr chunk;
+            Status st = iter.get_next(&chunk);
+            if (st.is_end_of_file()) {
+                break;
+            }
+            RETURN_IF_ERROR(st);
+            RETURN_IF_ERROR(_encode_keys(*chunk, &bytes, &_key_offsets, &keys));
+            // Only the live rows; keys are unique among them.
+            size_t num_live = 0;
+            locations.resize(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i, ++rowid) {
+                if (!del_vector.contains(rowid)) {
+                    keys[num_live] = keys[i];
+                    locations[num_live++] = make_row_location(segment_id, rowid);
+                }
+            }
+            replaced.clear();
+            RETURN_IF_ERROR(_index.upsert(keys.data(), num_live, locations.data(), &replaced));
+        }
+    }
+    return Status::OK();
+}
+
+Status PrimaryKeyTable::_save_meta(const PrimaryKeyTableVersion& version) {
+    Buffer<uint8_t> data;
+    put_varint64(&data, version.version);
+    put_varint64(&data, version.next_segment_id);
+    put_varint64(&data, version.segments.size());
+    for (size_t i = 0; i < version.segments.size(); ++i) {
+        put_varint64(&data, version.segment_ids[i]);
+        version.del_vectors[i]->serialize(&data);
+    }
+    put_fixed32(&data, static_cast<uint32_t>(HashUtil::hash_bytes(data.data(), data.size())));
+    put_fixed32(&data, kPrimaryKeyMetaMagic);
+    return write_file_atomically(_dir + "/meta", data);
+}
+
+Status PrimaryKeyTable::_encode_keys(const Chunk& chunk, Buffer<uint8_t>* bytes, Buffer<uint32_t>* offsets,
+                                     std::vector<Slice>* keys) const {
+    size_t num_rows = chunk.num_rows();
+    Columns columns;
+    for (size_t k = 0; k < _options.num_key_columns; ++k) {
+        const SlotDescriptor& slot = _schema[k];
+        ColumnPtr column = ColumnHelper::unfold_const_column(slot.type, num_rows, chunk.get_column_by_slot_id(slot.id));
+        if (column->is_nullable()) {
+            if (column->has_null()) {
+                return Status::InvalidArgument("NULL in primary key column " + std::to_string(k));
+            }
+            column = static_cast<const NullableColumn*>(column.get())->data_column();
+        }
+        columns.push_back(std::move(column));
+    }
+    serialize_keys(columns, _key_layout, num_rows, bytes, offsets);
+    keys->resize(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        (*keys)[i] = Slice(bytes->data() + (*offsets)[i], (*offsets)[i + 1] - (*offsets)[i]);
+    }
+    return Status::OK();
+}
+
+Status PrimaryKeyTable::upsert(const Chunk& chunk) {
+    return _write(chunk, nullptr, false);
+}
+
+Status PrimaryKeyTable::erase(const Chunk& keys) {
+    return _write(keys, nullptr, true);
+}
+
+Status PrimaryKeyTable::apply(const Chunk& chunk, const Filter& deletes) {
+    if (deletes.size() != chunk.num_rows()) {
+        return Status::InvalidArgument("change log of " + std::to_string(chunk.num_rows()) + " rows with " +
+                                       std::to_string(deletes.size()) + " delete flags");
+    }
+    return _write(chunk, &deletes, false);
+}
+
+Status PrimaryKeyTable::_write(const Chunk& chunk, const Filter* deletes, bool keys_only) {
+    size_t num_rows = chunk.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    for (size_t k = 0; k < (keys_only ? _options.num_key_columns : _schema.size()); ++k) {
+        if (!chunk.is_slot_exist(_schema[k].id)) {
+            return Status::InvalidArgument("write to a primary key table misses slot " +
+                                           std::to_string(_schema[k].id));
+        }
+    }
+    std::lock_guard<std::mutex> write_guard(_write_lock);
+    Buffer<uint8_t> bytes;
+    std::vector<Slice> keys;
+    RETURN_IF_ERROR(_encode_keys(chunk, &bytes, &_key_offsets, &keys));
+
+    // The upserted rows go to a new segment, in order.
+    size_t num_upserts = keys_only ? 0 : num_rows;
+    ChunkPtr rows;
+    if (!keys_only) {
+        rows = std::make_shared<Chunk>();
+        for (const auto& slot : _schema) {
+            rows->append_column(
+                    ColumnHelper::unfold_const_column(slot.type, num_rows, chunk.get_column_by_slot_id(slot.id)),
+                    slot.id);
+        }
+        if (deletes != nullptr) {
+            Filter upserts(num_rows);
+            for (size_t i = 0; i < num_rows; ++i) {
+                upserts[i] = !(*deletes)[i];
+            }
+            rows = rows->clone();
+            num_upserts = rows->filter(upserts);
+        }
+    }
+    PrimaryKeyTableVersionPtr base = current_version();
+    uint32_t segment_id = base->next_segment_id;
+    SegmentSharedPtr segment;
+    if (num_upserts > 0) {
+        SegmentWriter writer(_segment_path(segment_id), _schema, _options.writer_options);
+        RETURN_IF_ERROR(writer.init());
+        RETURN_IF_ERROR(writer.append_chunk(*rows));
+        RETURN_IF_ERROR(writer.finalize());
+        ASSIGN_OR_RETURN(segment, Segment::open(writer.path()));
+    }
+    return _commit(keys, deletes, keys_only, base, segment);
+}
+
+Status PrimaryKeyTable::ingest(const std::string& path) {
+    std::lock_guard<std::mutex> write_guard(_write_lock);
+    PrimaryKeyTableVersionPtr base = current_version();
+    std::string segment_path = _segment_path(base->next_segment_id);
+    if (::rename(path.c_str(), segment_path.c_str()) != 0) {
+        Status st = io_error("rename " + path + " to " + segment_path);
+        ::unlink(path.c_str());
+        return st;
+    }
+    auto segment = Segment::open(segment_path);
+    if (!segment.ok()) {
+        ::unlink(segment_path.c_str());
+        return segment.status();
+    }
+    const RowDescriptor& schema = segment.value()->schema();
+    bool same_schema = schema.size() == _schema.size();
+    for (size_t i = 0; same_schema && i < schema.size(); ++i) {
+        same_schema = schema[i].id == _schema[i].id && schema[i].type == _schema[i].type &&
+                      schema[i].nullable == _schema[i].nullable;
+    }
+    if (!same_schema) {
+        ::unlink(segment_path.c_str());
+        return Status::InvalidArgument("segment " + path + " does not have the schema of the table in " + _dir);
+    }
+    // The keys of all rows at once: they go through the index in one run.
+    SegmentReadOptions options;
+    for (size_t k = 0; k < _options.num_key_columns; ++k) {
+        options.column_ids.push_back(static_cast<ColumnId>(k));
+    }
+    SegmentIterator iter(segment.value(), options);
+    ChunkPtr keys_chunk;
+    Status st = iter.init();
+    while (st.ok()) {
+        ChunkPtr chunk;
+        st = iter.get_next(&chunk);
+        if (st.ok() && keys_chunk == nullptr) {
+            keys_chunk = std::move(chunk);
+        } else if (st.ok()) {
+            keys_chunk->append(*chunk, 0, chunk->num_rows());
+        }
+    }
+    if (!st.is_end_of_file()) {
+        ::unlink(segment_path.c_str());
+        return st;
+    }
+    if (keys_chunk == nullptr) {
+        ::unlink(segment_path.c_str());
+        return Status::OK();
+    }
+    Buffer<uint8_t> bytes;
+    std::vector<Slice> keys;
+    st = _encode_keys(*keys_chunk, &bytes, &_key_offsets, &keys);
+    if (!st.ok()) {
+        ::unlink(segment_path.c_str());
+        return st;
+    }
+    return _commit(keys, nullptr, false, base, segment.value());
+}
+
+Status PrimaryKeyTable::_commit(const std::vector<Slice>& keys, const Filter* deletes, bool keys_only,
+                                const PrimaryKeyTableVersionPtr& base, const SegmentSharedPtr& segment) {
+    size_t num_rows = keys.size();
+    uint32_t segment_id = base->next_segment_id;
+    auto drop_segment = [&]() {
+        if (segment != nullptr) {
+            ::unlink(segment->path().c_str());
+        }
+    };
+
+    // Runs of upserts and deletes go through the index in order; every
+    // location they displace, including those of earlier rows of this write,
+    // gets deleted.
+    std::vector<RowLocation> deleted;
+    std::vector<RowLocation> locations;
+    uint32_t rowid = 0;
+    Status st;
+    for (size_t begin = 0; begin < num_rows && st.ok();) {
+        bool is_delete = keys_only || (deletes != nullptr && (*deletes)[begin]);
+        size_t end = begin + 1;
+        while (end < num_rows && (keys_only || (deletes != nullptr && (*deletes)[end] != 0)) == is_delete) {
+            ++end;
+        }
+        if (is_delete) {
+            st = _index.erase(keys.data() + begin, end - begin, &deleted);
+        } else {
+            locations.resize(end - begin);
+            for (size_t i = 0; i < locations.size(); ++i) {
+                locations[i] = make_row_location(segment_id, rowid++);
+            }
+            st = _index.upsert(keys.data() + begin, end - begin, locations.data(), &deleted);
+        }
+        begin = end;
+    }
+    if (!st.ok()) {
+        drop_segment();
+        RETURN_IF_ERROR(_load_index(*base));
+        return st;
+    }
+
+    std::map<uint32_t, std::vector<uint32_t>> deleted_rows;
+    for (RowLocation location : deleted) {
+        deleted_rows[row_location_segment(location)].push_back(row_location_rowid(location));
+    }
+    auto version = std::make_shared<PrimaryKeyTableVersion>();
+    version->version = base->version + 1;
+    version->next_segment_id = segment_id + (segment != nullptr);
+    std::vector<std::string> dropped;
+    auto add_segment = [&](uint32_t id, const SegmentSharedPtr& seg, DelVectorPtr del_vector) {
+        // Locations of dropped segments may linger in an index reloaded from
+        // disk; deleting them again is a no-op.
+        auto it = deleted_rows.find(id);
+        if (it != deleted_rows.end()) {
+            del_vector = del_vector->add(std::move(it->second));
+        }
+        if (static_cast<int64_t>(del_vector->cardinality()) == seg->num_rows()) {
+            dropped.push_back(seg->path());
+            return;
+        }
+        version->segment_ids.push_back(id);
+        version->segments.push_back(seg);
+        version->del_vectors.push_back(std::move(del_vector));
+    };
+    for (size_t i = 0; i < base->segments.size(); ++i) {
+        add_segment(base->segment_ids[i], base->segments[i], base->del_vectors[i]);
+    }
+    if (segment != nullptr) {
+        add_segment(segment_id, segment, std::make_shared<DelVector>());
+    }
+    st = _save_meta(*version);
+    if (!st.ok()) {
+        drop_segment();
+        RETURN_IF_ERROR(_load_index(*base));
+        return st;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_version_lock);
+        _version = version;
+    }
+    for (const auto& path : dropped) {
+        ::unlink(path.c_str());
+    }
+    // The write is committed whether or not the flush succeeds; a failed one
+    // leaves the old index file, which the replay completes.
+    if (_index.need_flush()) {
+        st = _index.flush(version->next_segment_id);
+        if (!st.ok()) {
+            RETURN_IF_ERROR(_load_index(*version));
+        }
+    }
+    return Status::OK();
+}
+
+Status PrimaryKeyTable::compact(const std::vector<uint32_t>& segment_ids, const CompactionOptions& options,
+                                CompactionStats* stats) {
+    std::lock_guard<std::mutex> compaction_guard(_compaction_lock);
+    PrimaryKeyTableVersionPtr base = current_version();
+    std::vector<size_t> inputs;
+    for (uint32_t id : segment_ids) {
+        auto it = std::find(base->segment_ids.begin(), base->segment_ids.end(), id);
+        if (it != base->segment_ids.end()) {
+            inputs.push_back(it - base->segment_ids.begin());
+        }
+    }
+    if (inputs.empty()) {
+        return Status::OK();
+    }
+    stats->input_segments = inputs.size();
+
+    int64_t column_bytes = std::max<int64_t>(kCompactionBuffersPerColumn * _options.writer_options.page_size_bytes, 1);
+    auto group_width = static_cast<size_t>(std::max<int64_t>(options.memory_limit_bytes / column_bytes, 1));
+    std::vector<std::pair<size_t, size_t>> groups{{0, _options.num_key_columns}};
+    for (size_t first = _options.num_key_columns; first < _schema.size(); first += group_width) {
+        groups.emplace_back(first, std::min(group_width, _schema.size() - first));
+    }
+    stats->column_groups = groups.size();
+
+    // The output is only numbered when it commits.
+    SegmentWriter writer(_dir + "/compaction.seg", _schema, _options.writer_options);
+    RETURN_IF_ERROR(writer.init());
+    // The keys of the rows copied, in output order.
+    Buffer<uint8_t> key_bytes;
+    std::vector<size_t> key_offsets{0};
+    Buffer<uint8_t> bytes;
+    Buffer<uint32_t> offsets;
+    std::vector<Slice> keys;
+    for (const auto& [first, num_columns] : groups) {
+        SegmentReadOptions read_options;
+        for (size_t c = first; c < first + num_columns; ++c) {
+            read_options.column_ids.push_back(static_cast<ColumnId>(c));
+        }
+        for (size_t input : inputs) {
+            read_options.del_vector = base->del_vectors[input];
+            SegmentIterator iter(base->segments[input], read_options);
+            RETURN_IF_ERROR(iter.init());
+            while (true) {
+                int64_t bytes_read = iter.stats().bytes_read;
+                int64_t bytes_written = writer.file_size();
+                ChunkPtr chunk;
+                Status st = iter.get_next(&chunk);
+                if (st.is_end_of_file()) {
+                    break;
+                }
+                RETURN_IF_ERROR(st);
+                RETURN_IF_ERROR(writer.append_columns(first, chunk->columns()));
+                if (first == 0) {
+                    RETURN_IF_ERROR(_encode_keys(*chunk, &bytes, &offsets, &keys));
+                    for (const Slice& key : keys) {
+                        key_bytes.append(reinterpret_cast<const uint8_t*>(key.data), key.size);
+                        key_offsets.push_back(key_bytes.size());
+                    }
+                }
+                bytes_read = iter.stats().bytes_read - bytes_read;
+                stats->bytes_read += bytes_read;
+                if (options.io_limiter != nullptr) {
+                    options.io_limiter->acquire(bytes_read + writer.file_size() - bytes_written);
+                }
+            }
+        }
+        RETURN_IF_ERROR(writer.finish_columns(first, num_columns));
+    }
+    RETURN_IF_ERROR(writer.finalize());
+    stats->bytes_written = writer.file_size();
+    stats->input_rows = writer.num_rows();
+    for (size_t input : inputs) {
+        stats->deleted_rows += base->del_vectors[input]->cardinality();
+    }
+
+    std::lock_guard<std::mutex> write_guard(_write_lock);
+    PrimaryKeyTableVersionPtr cur = current_version();
+    uint32_t output_id = cur->next_segment_id;
+    std::string output_path = _segment_path(output_id);
+    if (::rename(writer.path().c_str(), output_path.c_str()) != 0) {
+        Status st = io_error("failed to publish " + output_path);
+        ::unlink(writer.path().c_str());
+        return st;
+    }
+    auto output = Segment::open(output_path);
+    if (!output.ok()) {
+        ::unlink(output_path.c_str());
+        return output.status();
+    }
+
+    // Rows the writes since |base| deleted from the inputs are deleted from
+    // the output; the others move there in the index.
+    std::vector<uint32_t> output_deleted;
+    keys.clear();
+    std::vector<RowLocation> locations;
+    uint32_t output_rowid = 0;
+    for (size_t input : inputs) {
+        auto it = std::find(cur->segment_ids.begin(), cur->segment_ids.end(), base->segment_ids[input]);
+        // A segment gone meanwhile had all its rows deleted.
+        const DelVector* cur_del_vector =
+                it != cur->segment_ids.end() ? cur->del_vectors[it - cur->segment_ids.begin()].get() : nullptr;
+        const DelVector& base_del_vector = *base->del_vectors[input];
+        auto num_rows = static_cast<uint32_t>(base->segments[input]->num_rows());
+        for (uint32_t rowid = 0; rowid < num_rows; ++rowid) {
+            if (base_del_vector.contains(rowid)) {
+                continue;
+            }
+            if (cur_del_vector == nullptr || cur_del_vector->contains(rowid)) {
+                output_deleted.push_back(output_rowid);
+            } else {
+                keys.emplace_back(key_bytes.data() + key_offsets[output_rowid],
+                                  key_offsets[output_rowid + 1] - key_offsets[output_rowid]);
+                locations.push_back(make_row_location(output_id, output_rowid));
+            }
+            ++output_rowid;
+        }
+    }
+    std::vector<RowLocation> replaced;
+    Status st = _index.upsert(keys.data(), keys.size(), locations.data(), &replaced);
+
+    auto version = std::make_shared<PrimaryKeyTableVersion>();
+    version->version = cur->version + 1;
+    version->next_segment_id = output_id + 1;
+    std::vector<std::string> dropped;
+    for (size_t i = 0; i < cur->segments.size(); ++i) {
+        if (std::find(segment_ids.begin(), segment_ids.end(), cur->segment_ids[i]) != segment_ids.end()) {
+            dropped.push_back(cur->segments[i]->path());
+            continue;
+        }
+        version->segment_ids.push_back(cur->segment_ids[i]);
+        version->segments.push_back(cur->segments[i]);
+        version->del_vectors.push_back(cur->del_vectors[i]);
+    }
+    if (keys.empty()) {
+        dropped.push_back(output_path);
+    } else {
+        version->segment_ids.push_back(output_id);
+        version->segments.push_back(std::move(output).value());
+        version->del_vectors.push_back(DelVector().add(std::move(output_deleted)));
+    }
+    if (st.ok()) {
+        st = _save_meta(*version);
+    }
+    if (!st.ok()) {
+        ::unlink(output_path.c_str());
+        RETURN_IF_ERROR(_load_index(*cur));
+        return st;
+    }
+    {
+        std::lock_guard<std::mutex> guard(_version_lock);
+        _version = version;
+    }
+    for (const auto& path : dropped) {
+        ::unlink(path.c_str());
+    }
+    if (_index.need_flush()) {
+        st = _index.flush(version->next_segment_id);
+        if (!st.ok()) {
+            RETURN_IF_ERROR(_load_index(*version));
+        }
+    }
+    return Status::OK();
+}
+
+PrimaryKeyTableVersionPtr PrimaryKeyTable::current_version() const {
+    std::lock_guard<std::mutex> guard(_version_lock);
+    return _version;
+}
+
+StatusOr<std::vector<std::unique_ptr<SegmentIterator>>> PrimaryKeyTable::new_iterators(
+        const SegmentReadOptions& options) const {
+    PrimaryKeyTableVersionPtr version = current_version();
+    std::vector<std::unique_ptr<SegmentIterator>> iterators;
+    for (size_t i = 0; i < version->segments.size(); ++i) {
+        SegmentReadOptions segment_options = options;
+        segment_options.del_vector = version->del_vectors[i];
+        auto iter = std::make_unique<SegmentIterator>(version->segments[i], std::move(segment_options));
+        RETURN_IF_ERROR(iter->init());
+        iterators.push_back(std::move(iter));
+    }
+    return iterators;
+}
+
+} // namespace starrocks
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/config.h"
+#include "common/status.h"
+#include "exec/agg_hash_map.h"
+#include "runtime/descriptors.h"
+#include "storage/compaction.h"
+#include "storage/del_vector.h"
+#include "storage/primary_index.h"
+#include "storage/segment/segment_iterator.h"
+#include "storage/segment/segment_writer.h"
+
+namespace starrocks {
+
+struct PrimaryKeyTableOptions {
+    // The first |num_key_columns| slots of the schema form the primary key;
+    // they must not be nullable.
+    size_t num_key_columns = 1;
+    // Keep the primary index on disk, in the table's directory.
+    bool persistent_index = config::enable_persistent_index;
+    SegmentWriterOptions writer_options;
+};
+
+// The segments of a primary-key table after some write, in write order, with
+// the rows later writes deleted from each. Immutable: scans read the version
+// they started with while writes install new ones.
+struct PrimaryKeyTableVersion {
+    int64_t version = 0;
+    // Id the next segment written gets; ids are never reused.
+    uint32_t next_segment_id = 0;
+    std::vector<uint32_t> segment_ids;
+    std::vector<SegmentSharedPtr> segments;
+    std::vector<DelVectorPtr> del_vectors;
+
+    // Rows not deleted.
+    int64_t num_rows() const;
+};
+using PrimaryKeyTableVersionPtr = std::shared_ptr<const PrimaryKeyTableVersion>;
+
+// A table holding at most one row per primary key, kept in a directory of
+// segment files. Conflicts are resolved as rows are written, not as they are
+// read: every write appends one segment, looks its keys up in the
+// PrimaryIndex and marks the rows they replace in the delete vectors of their
+// segments. A scan therefore reads each segment on its own, skipping the
+// deleted rows, with no merging of row versions and every predicate pushed
+// down - which is what keeps a table fed by a change stream (CDC) as cheap to
+// query as an append-only one.
+//
+// A write is durable once it returns: its segment is published, then a meta
+// file listing the segments and their delete vectors replaces the old one.
+// A persistent index records how many segments it covers; opening the table
+// replays the keys of the newer ones into it. Segments whose rows are all
+// deleted are dropped.
+//
+// Small segments, and those mostly deleted, are merged by compact(), usually
+// from a CompactionManager.
+//
+// Writes are serialized; scans may run alongside them, and a compaction
+// alongside both.
+class PrimaryKeyTable {
+public:
+    // Opens the table in |dir|, creating it if there is none yet.
+    static StatusOr<std::unique_ptr<PrimaryKeyTable>> open(std::string dir, RowDescriptor schema,
+                                                           PrimaryKeyTableOptions options = {});
+
+    ~PrimaryKeyTable();
+
+    const std::string& dir() const { return _dir; }
+    const RowDescriptor& schema() const { return _schema; }
+    size_t num_key_columns() const { return _options.num_key_columns; }
+
+    // Writes the rows of |chunk|, which holds a column for every slot of the
+    // schema, replacing those with the same keys. Within the chunk the last
+    // row of a key wins.
+    Status upsert(const Chunk& chunk);
+    // Deletes the rows with the keys in |keys|, which holds the key columns.
+    Status erase(const Chunk& keys);
+    // Applies a change log in row order: row i deletes its key if
+    // deletes[i] is set and is upserted otherwise.
+    Status apply(const Chunk& chunk, const Filter& deletes);
+    // Commits the segment file at |path|, written with the table's schema
+    // elsewhere (by a load's DeltaWriter, say), as if its rows were
+    // upserted in order. The file is moved into the table's directory, so
+    // it must be on the same file system; it is removed if the commit fails.
+    Status ingest(const std::string& path);
+
+    // Merges the live rows of the segments |segment_ids| of the current
+    // version, those still there, into one new segment. The rows are copied
+    // vertically, a group of columns at a time, as many as fit in
+    // options.memory_limit_bytes of page buffers; keys are unique, so there
+    // is nothing to merge-sort. Writes may commit meanwhile: the rows they
+    // delete from the inputs are deleted from the output when it commits.
+    Status compact(const std::vector<uint32_t>& segment_ids, const CompactionOptions& options,
+                   CompactionStats* stats);
+
+    PrimaryKeyTableVersionPtr current_version() const;
+
+    // Iterators over the rows of the current version, one per segment;
+    // options.del_vector is set for each.
+    StatusOr<std::vector<std::unique_ptr<SegmentIterator>>> new_iterators(const SegmentReadOptions& options) const;
+
+    const PrimaryIndex& index() const { return _index; }
+
+private:
+    PrimaryKeyTable(std::string dir, RowDescriptor schema, PrimaryKeyTableOptions options);
+
+    std::string _segment_path(uint32_t segment_id) const;
+    Status _load();
+    // Loads the index from disk and replays the segments of |version| it
+    // does not cover.
+    Status _load_index(const PrimaryKeyTableVersion& version);
+    Status _save_meta(const PrimaryKeyTableVersion& version);
+    // |deletes| is nullptr when every row is an upsert; |keys_only| when every
+    // row is a delete and |chunk| only holds the key columns.
+    Status _write(const Chunk& chunk, const Filter* deletes, bool keys_only);
+    // Applies |keys| to the index, as _write() describes them, and installs
+    // the version after |base| with |segment|, the upserted rows if there
+    // are any, numbered base->next_segment_id. Holds _write_lock.
+    Status _commit(const std::vector<Slice>& keys, const Filter* deletes, bool keys_only,
+                   const PrimaryKeyTableVersionPtr& base, const SegmentSharedPtr& segment);
+    // Encodes the keys of the rows of |chunk| into |bytes|; |offsets| is
+    // scratch space.
+    Status _encode_keys(const Chunk& chunk, Buffer<uint8_t>* bytes, Buffer<uint32_t>* offsets,
+                        std::vector<Slice>* keys) const;
+
+    const std::string _dir;
+    const RowDescriptor _schema;
+    const PrimaryKeyTableOptions _options;
+    AggKeyLayout _key_layout;
+
+    // One compaction at a time.
+    std::mutex _compaction_lock;
+    // Serializes writes, which alone use the index, and the commits of
+    // compactions.
+    std::mutex _write_lock;
+    PrimaryIndex _index;
+    Buffer<uint32_t> _key_offsets;
+
+    mutable std::mutex _version_lock;
+    PrimaryKeyTableVersionPtr _version;
+};
+
+} // namespace starrocks
@@ -0,0 +1,632 @@
+#include "storage/segment/encoding.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "column/binary_column.h"
+#include "column/fixed_length_column.h"
+#include "util/bit_packing.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+const char* encoding_type_name(EncodingType type) {
+    switch (type) {
+    case EncodingType::PLAIN:
+        return "PLAIN";
+    case EncodingType::DICT:
+        return "DICT";
+    case EncodingType::RLE:
+        return "RLE";
+    case EncodingType::BIT_PACKED:
+        return "BIT_PACKED";
+    case EncodingType::DELTA:
+        return "DELTA";
+    }
+    return "UNKNOWN";
+}
+
+// Types encoded through their int64 value: BIT_PACKED and DELTA apply.
+static constexpr bool is_integral_storage_type(LogicalType type) {
+    return type != TYPE_FLOAT && type != TYPE_DOUBLE && !is_binary_type(type);
+}
+
+// Values are shifted and packed as uint64; int64 wrap-around keeps the
+// differences exact even when they overflow the signed range.
+template <typename T>
+static ALWAYS_INLINE uint64_t to_u64(T v) {
+    return static_cast<uint64_t>(static_cast<int64_t>(v));
+}
+
+static Status bad_page(const char* encoding) {
+    return Status::Corruption(std::string("malformed ") + encoding + " segment page");
+}
+
+// ---- encoders ----
+
+template <typename T>
+static size_t count_runs(const T* values, size_t n) {
+    size_t runs = n > 0;
+    for (size_t i = 1; i < n; ++i) {
+        // Bitwise comparison, so NaNs form runs too.
+        runs += memcmp(&values[i], &values[i - 1], sizeof(T)) != 0;
+    }
+    return runs;
+}
+
+template <LogicalType LT, typename T = RunTimeCppType<LT>>
+static EncodingType choose_fixed_encoding(const T* values, size_t n) {
+    if (n == 0) {
+        return EncodingType::PLAIN;
+    }
+    EncodingType best = EncodingType::PLAIN;
+    size_t best_size = n * sizeof(T);
+    auto consider = [&](EncodingType encoding, size_t size) {
+        if (size < best_size) {
+            best = encoding;
+            best_size = size;
+        }
+    };
+    // A run costs its value plus a varint length, typically one or two bytes.
+    consider(EncodingType::RLE, 4 + count_runs(values, n) * (sizeof(T) + 2));
+    if constexpr (is_integral_storage_type(LT)) {
+        int64_t min = values[0];
+        int64_t max = values[0];
+        int64_t min_delta = 0;
+        int64_t max_delta = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int64_t v = values[i];
+            min = std::min(min, v);
+            max = std::max(max, v);
+            if (i > 0) {
+                auto delta = static_cast<int64_t>(to_u64(values[i]) - to_u64(values[i - 1]));
+                min_delta = i == 1 ? delta : std::min(min_delta, delta);
+                max_delta = i == 1 ? delta : std::max(max_delta, delta);
+            }
+        }
+        int bits = bits_required(static_cast<uint64_t>(max) - static_cast<uint64_t>(min));
+        consider(EncodingType::BIT_PACKED, 9 + bit_packed_size(n, bits));
+        int delta_bits = bits_required(static_cast<uint64_t>(max_delta) - static_cast<uint64_t>(min_delta));
+        consider(EncodingType::DELTA, 17 + bit_packed_size(n - 1, delta_bits));
+    }
+    return best;
+}
+
+EncodingType choose_page_encoding(LogicalType type, const Column& data) {
+    if (is_binary_type(type)) {
+        return EncodingType::PLAIN;
+    }
+    return type_dispatch_all(type, [&](auto lt) -> EncodingType {
+        constexpr LogicalType LT = decltype(lt)::value;
+        if constexpr (LT == TYPE_VARCHAR) {
+            return EncodingType::PLAIN;
+        } else {
+            using T = RunTimeCppType<LT>;
+            const auto* values = reinterpret_cast<const T*>(data.raw_data());
+            return choose_fixed_encoding<LT>(values, data.size());
+        }
+    });
+}
+
+static void encode_plain_binary(const BinaryColumn& data, Buffer<uint8_t>* dst) {
+    const auto& offsets = data.get_offset();
+    size_t n = data.size();
+    uint32_t base = offsets[0];
+    for (size_t i = 0; i <= n; ++i) {
+        put_fixed32(dst, offsets[i] - base);
+    }
+    dst->append(data.get_bytes().data() + base, offsets[n] - base);
+}
+
+template <typename T>
+static void encode_rle(const T* values, size_t n, Buffer<uint8_t>* dst) {
+    put_varint64(dst, count_runs(values, n));
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && memcmp(&values[j], &values[i], sizeof(T)) == 0) {
+            ++j;
+        }
+        put_varint64(dst, j - i);
+        dst->append(reinterpret_cast<const uint8_t*>(&values[i]), sizeof(T));
+        i = j;
+    }
+}
+
+template <typename T>
+static void encode_bit_packed(const T* values, size_t n, Buffer<uint8_t>* dst) {
+    uint64_t min = n > 0 ? to_u64(*std::min_element(values, values + n)) : 0;
+    Buffer<uint64_t> packed(n);
+    uint64_t range = 0;
+    for (size_t i = 0; i < n; ++i) {
+        packed[i] = to_u64(values[i]) - min;
+        range = std::max(range, packed[i]);
+    }
+    int bits = bits_required(range);
+    put_fixed64(dst, min);
+    put_fixed8(dst, bits);
+    bit_pack(packed.data(), n, bits, dst);
+}
+
+template <typename T>
+static void encode_delta(const T* values, size_t n, Buffer<uint8_t>* dst) {
+    size_t num_deltas = n > 0 ? n - 1 : 0;
+    Buffer<uint64_t> deltas(num_deltas);
+    int64_t min_delta = 0;
+    for (size_t i = 0; i < num_deltas; ++i) {
+        deltas[i] = to_u64(values[i + 1]) - to_u64(values[i]);
+        min_delta = i == 0 ? static_cast<int64_t>(deltas[i]) : std::min(min_delta, static_cast<int64_t>(deltas[i]));
+    }
+    uint64_t range = 0;
+    for (size_t i = 0; i < num_deltas; ++i) {
+        deltas[i] -= static_cast<uint64_t>(min_delta);
+        range = std::max(range, deltas[i]);
+    }
+    int bits = bits_required(range);
+    put_fixed64(dst, n > 0 ? to_u64(values[0]) : 0);
+    put_fixed64(dst, static_cast<uint64_t>(min_delta));
+    put_fixed8(dst, bits);
+    bit_pack(deltas.data(), num_deltas, bits, dst);
+}
+
+Status encode_page_values(EncodingType encoding, LogicalType type, const Column& data, Buffer<uint8_t>* dst) {
+    return type_dispatch_all(type, [&](auto lt) -> Status {
+        constexpr LogicalType LT = decltype(lt)::value;
+        if constexpr (LT == TYPE_VARCHAR) {
+            if (encoding != EncodingType::PLAIN) {
+                return Status::NotSupported(std::string("VARCHAR pages cannot use ") + encoding_type_name(encoding));
+            }
+            encode_plain_binary(static_cast<const BinaryColumn&>(data), dst);
+            return Status::OK();
+        } else {
+            using T = RunTimeCppType<LT>;
+            const auto* values = reinterpret_cast<const T*>(data.raw_data());
+            size_t n = data.size();
+            switch (encoding) {
+            case EncodingType::PLAIN:
+                dst->append(data.raw_data(), n * sizeof(T));
+                return Status::OK();
+            case EncodingType::RLE:
+                encode_rle(values, n, dst);
+                return Status::OK();
+            case EncodingType::BIT_PACKED:
+            case EncodingType::DELTA:
+                if constexpr (is_integral_storage_type(LT)) {
+                    if (encoding == EncodingType::BIT_PACKED) {
+                        encode_bit_packed(values, n, dst);
+                    } else {
+                        encode_delta(values, n, dst);
+                    }
+                    return Status::OK();
+                }
+                break;
+            case EncodingType::DICT:
+                break;
+            }
+            return Status::NotSupported(logical_type_to_string(LT) + " pages cannot use " +
+                                        encoding_type_name(encoding));
+        }
+    });
+}
+
+void encode_dict_codes(const uint32_t* codes, size_t n, uint32_t dict_size, Buffer<uint8_t>* dst) {
+    int bits = bits_required(dict_size > 0 ? dict_size - 1 : 0);
+    Buffer<uint64_t> values(n);
+    std::copy(codes, codes + n, values.data());
+    put_fixed8(dst, bits);
+    bit_pack(values.data(), n, bits, dst);
+}
+
+void encode_null_runs(const uint8_t* nulls, size_t n, Buffer<uint8_t>* dst) {
+    Buffer<uint8_t> runs;
+    size_t num_runs = 0;
+    bool is_null = false;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && (nulls[j] != 0) == is_null) {
+            ++j;
+        }
+        put_varint64(&runs, j - i);
+        ++num_runs;
+        is_null = !is_null;
+        i = j;
+    }
+    put_varint64(dst, num_runs);
+    dst->append(runs.data(), runs.size());
+}
+
+// ---- decoders ----
+
+template <typename T>
+class PlainFixedPageDecoder final : public PageDecoder {
+public:
+    PlainFixedPageDecoder(const uint8_t* data, size_t num_values) : PageDecoder(num_values), _data(data) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        size_t old = dst->size();
+        dst->resize_uninitialized(old + n);
+        memcpy(dst->mutable_raw_data() + old * sizeof(T), _data + _pos * sizeof(T), n * sizeof(T));
+        _pos += n;
+        return Status::OK();
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        _pos += n;
+        return Status::OK();
+    }
+
+private:
+    const uint8_t* _data;
+};
+
+class PlainBinaryPageDecoder final : public PageDecoder {
+public:
+    PlainBinaryPageDecoder(const uint32_t* offsets, const uint8_t* bytes, size_t num_values)
+            : PageDecoder(num_values), _offsets(offsets), _bytes(bytes) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        auto* binary = static_cast<BinaryColumn*>(dst);
+        auto& bytes = binary->get_bytes();
+        auto& offsets = binary->get_offset();
+        uint32_t begin = _offsets[_pos];
+        uint32_t end = _offsets[_pos + n];
+        // Page offsets are rebased onto the end of the column's bytes.
+        uint32_t rebase = static_cast<uint32_t>(bytes.size()) - begin;
+        bytes.append(_bytes + begin, end - begin);
+        size_t old = offsets.size();
+        offsets.resize_uninitialized(old + n);
+        for (size_t i = 0; i < n; ++i) {
+            offsets[old + i] = _offsets[_pos + i + 1] + rebase;
+        }
+        _pos += n;
+        return Status::OK();
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        _pos += n;
+        return Status::OK();
+    }
+
+private:
+    const uint32_t* _offsets;
+    const uint8_t* _bytes;
+};
+
+class DictPageDecoder final : public PageDecoder {
+public:
+    DictPageDecoder(const uint8_t* packed, int bits, size_t num_values, const BinaryColumn* dict)
+            : PageDecoder(num_values), _packed(packed), _bits(bits), _dict(dict) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        _codes.resize_uninitialized(n);
+        RETURN_IF_ERROR(next_dict_codes(n, _codes.data()));
+        _words.resize_uninitialized(n);
+        for (size_t i = 0; i < n; ++i) {
+            _words[i] = _dict->get_slice(_codes[i]);
+        }
+        static_cast<BinaryColumn*>(dst)->append_strings(_words.data(), n);
+        return Status::OK();
+    }
+
+    Status next_dict_codes(size_t n, uint32_t* codes) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        bit_unpack(_packed, _bits, _pos, n, codes);
+        size_t dict_size = _dict->size();
+        for (size_t i = 0; i < n; ++i) {
+            if (codes[i] >= dict_size) {
+                return bad_page("DICT");
+            }
+        }
+        _pos += n;
+        return Status::OK();
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        _pos += n;
+        return Status::OK();
+    }
+
+private:
+    const uint8_t* _packed;
+    const int _bits;
+    const BinaryColumn* _dict;
+    Buffer<uint32_t> _codes;
+    Buffer<Slice> _words;
+};
+
+template <typename T>
+class RlePageDecoder final : public PageDecoder {
+public:
+    RlePageDecoder(const Slice& runs, size_t num_values) : PageDecoder(num_values), _runs(runs) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        size_t old = dst->size();
+        dst->resize_uninitialized(old + n);
+        T* out = reinterpret_cast<T*>(dst->mutable_raw_data()) + old;
+        return _consume(n, out);
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        return _consume(n, nullptr);
+    }
+
+private:
+    // Copies the next |n| values to |out| unless it is nullptr.
+    Status _consume(size_t n, T* out) {
+        while (n > 0) {
+            if (_run_left == 0) {
+                uint64_t len;
+                if (!get_varint64(&_runs, &len) || _runs.size < sizeof(T) || len == 0) {
+                    return bad_page("RLE");
+                }
+                memcpy(&_run_value, _runs.data, sizeof(T));
+                _runs.remove_prefix(sizeof(T));
+                _run_left = len;
+            }
+            size_t take = std::min<size_t>(n, _run_left);
+            if (out != nullptr) {
+                std::fill(out, out + take, _run_value);
+                out += take;
+            }
+            _run_left -= take;
+            _pos += take;
+            n -= take;
+        }
+        return Status::OK();
+    }
+
+    Slice _runs;
+    size_t _run_left = 0;
+    T _run_value{};
+};
+
+// Values are unpacked through a small stack buffer in batches of this size.
+static constexpr size_t kUnpackBatch = 256;
+
+template <typename T>
+class BitPackedPageDecoder final : public PageDecoder {
+public:
+    BitPackedPageDecoder(uint64_t min, int bits, const uint8_t* packed, size_t num_values)
+            : PageDecoder(num_values), _min(min), _bits(bits), _packed(packed) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        size_t old = dst->size();
+        dst->resize_uninitialized(old + n);
+        T* out = reinterpret_cast<T*>(dst->mutable_raw_data()) + old;
+        uint64_t buf[kUnpackBatch];
+        for (size_t done = 0; done < n;) {
+            size_t batch = std::min(kUnpackBatch, n - done);
+            bit_unpack(_packed, _bits, _pos + done, batch, buf);
+            for (size_t i = 0; i < batch; ++i) {
+                out[done + i] = static_cast<T>(static_cast<int64_t>(_min + buf[i]));
+            }
+            done += batch;
+        }
+        _pos += n;
+        return Status::OK();
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        _pos += n;
+        return Status::OK();
+    }
+
+private:
+    const uint64_t _min;
+    const int _bits;
+    const uint8_t* _packed;
+};
+
+// Each value depends on the previous one, so skipping still walks the deltas.
+template <typename T>
+class DeltaPageDecoder final : public PageDecoder {
+public:
+    DeltaPageDecoder(uint64_t first, uint64_t min_delta, int bits, const uint8_t* packed, size_t num_values)
+            : PageDecoder(num_values), _value(first), _min_delta(min_delta), _bits(bits), _packed(packed) {}
+
+    Status next_batch(size_t n, Column* dst) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        size_t old = dst->size();
+        dst->resize_uninitialized(old + n);
+        _consume(n, reinterpret_cast<T*>(dst->mutable_raw_data()) + old);
+        return Status::OK();
+    }
+
+    Status skip(size_t n) override {
+        RETURN_IF_ERROR(check_remaining(n));
+        _consume(n, nullptr);
+        return Status::OK();
+    }
+
+private:
+    void _consume(size_t n, T* out) {
+        if (n > 0 && _pos == 0) {
+            // The first value is stored as-is, the rest as deltas 0..n-2.
+            if (out != nullptr) {
+                *out++ = static_cast<T>(static_cast<int64_t>(_value));
+            }
+            ++_pos;
+            --n;
+        }
+        uint64_t buf[kUnpackBatch];
+        while (n > 0) {
+            size_t batch = std::min(kUnpackBatch, n);
+            bit_unpack(_packed, _bits, _pos - 1, batch, buf);
+            for (size_t i = 0; i < batch; ++i) {
+                _value += _min_delta + buf[i];
+                if (out != nullptr) {
+                    *out++ = static_cast<T>(static_cast<int64_t>(_value));
+                }
+            }
+            _pos += batch;
+            n -= batch;
+        }
+    }
+
+    uint64_t _value;
+    const uint64_t _min_delta;
+    const int _bits;
+    const uint8_t* _packed;
+};
+
+// Reads the bit width of a packed payload and checks it fits in |data|.
+static bool read_packed_header(Slice* data, size_t n, int* bits) {
+    uint8_t b;
+    if (!get_fixed8(data, &b) || b > 64 || data->size < bit_packed_size(n, b)) {
+        return false;
+    }
+    *bits = b;
+    return true;
+}
+
+StatusOr<PageDecoderPtr> create_page_decoder(EncodingType encoding, LogicalType type, const Slice& data,
+                                             size_t num_values, const BinaryColumn* dict) {
+    const char* name = encoding_type_name(encoding);
+    return type_dispatch_all(type, [&](auto lt) -> StatusOr<PageDecoderPtr> {
+        constexpr LogicalType LT = decltype(lt)::value;
+        Slice input = data;
+        if constexpr (LT == TYPE_VARCHAR) {
+            if (encoding == EncodingType::PLAIN) {
+                size_t offsets_size = (num_values + 1) * sizeof(uint32_t);
+                if (input.size < offsets_size) {
+                    return bad_page(name);
+                }
+                // Values start the page body, which is read into a 64-byte
+                // aligned buffer, so the offsets are aligned.
+                const auto* offsets = reinterpret_cast<const uint32_t*>(input.data);
+                if (offsets[0] != 0 || offsets[num_values] > input.size - offsets_size) {
+                    return bad_page(name);
+                }
+                const auto* bytes = reinterpret_cast<const uint8_t*>(input.data) + offsets_size;
+                return PageDecoderPtr(std::make_unique<PlainBinaryPageDecoder>(offsets, bytes, num_values));
+            }
+            if (encoding == EncodingType::DICT) {
+                int bits;
+                if (dict == nullptr || !read_packed_header(&input, num_values, &bits)) {
+                    return bad_page(name);
+                }
+                return PageDecoderPtr(std::make_unique<DictPageDecoder>(
+                        reinterpret_cast<const uint8_t*>(input.data), bits, num_values, dict));
+            }
+        } else {
+            using T = RunTimeCppType<LT>;
+            const auto* raw = reinterpret_cast<const uint8_t*>(input.data);
+            switch (encoding) {
+            case EncodingType::PLAIN:
+                if (input.size < num_values * sizeof(T)) {
+                    return bad_page(name);
+                }
+                return PageDecoderPtr(std::make_unique<PlainFixedPageDecoder<T>>(raw, num_values));
+            case EncodingType::RLE: {
+                uint64_t num_runs;
+                if (!get_varint64(&input, &num_runs)) {
+                    return bad_page(name);
+                }
+                return PageDecoderPtr(std::make_unique<RlePageDecoder<T>>(input, num_values));
+            }
+            case EncodingType::BIT_PACKED:
+                if constexpr (is_integral_storage_type(LT)) {
+                    uint64_t min;
+                    int bits;
+                    if (!get_fixed64(&input, &min) || !read_packed_header(&input, num_values, &bits)) {
+                        return bad_page(name);
+                    }
+                    return PageDecoderPtr(std::make_unique<BitPackedPageDecoder<T>>(
+                            min, bits, reinterpret_cast<const uint8_t*>(input.data), num_values));
+                }
+                break;
+            case EncodingType::DELTA:
+                if constexpr (is_integral_storage_type(LT)) {
+                    uint64_t first;
+                    uint64_t min_delta;
+                    int bits;
+                    if (!get_fixed64(&input, &first) || !get_fixed64(&input, &min_delta) ||
+                        !read_packed_header(&input, num_values > 0 ? num_values - 1 : 0, &bits)) {
+                        return bad_page(name);
+                    }
+                    return PageDecoderPtr(std::make_unique<DeltaPageDecoder<T>>(
+                            first, min_delta, bits, reinterpret_cast<const uint8_t*>(input.data), num_values));
+                }
+                break;
+            case EncodingType::DICT:
+                break;
+            }
+        }
+        return Status::Corruption(logical_type_to_string(LT) + " segment page with unsupported encoding " + name);
+    });
+}
+
+// ---- null map ----
+
+Status NullRunDecoder::init(const Slice& data, size_t num_values) {
+    _data = data;
+    uint64_t num_runs;
+    if (!get_varint64(&_data, &num_runs)) {
+        return Status::Corruption("malformed segment page null map");
+    }
+    _remaining = num_values;
+    _run_left = 0;
+    _run_is_null = true;
+    return Status::OK();
+}
+
+Status NullRunDecoder::_next_run() {
+    do {
+        uint64_t len;
+        if (!get_varint64(&_data, &len)) {
+            return Status::Corruption("malformed segment page null map");
+        }
+        _run_left = len;
+        _run_is_null = !_run_is_null;
+    } while (_run_left == 0);
+    return Status::OK();
+}
+
+StatusOr<bool> NullRunDecoder::next_batch(size_t n, Buffer<uint8_t>* dst) {
+    if (n > _remaining) {
+        return Status::Corruption("read past the end of a segment page null map");
+    }
+    bool has_null = false;
+    size_t old = dst->size();
+    dst->resize_uninitialized(old + n);
+    uint8_t* out = dst->data() + old;
+    while (n > 0) {
+        if (_run_left == 0) {
+            RETURN_IF_ERROR(_next_run());
+        }
+        size_t take = std::min(n, _run_left);
+        memset(out, _run_is_null, take);
+        has_null |= _run_is_null;
+        out += take;
+        _run_left -= take;
+        _remaining -= take;
+        n -= take;
+    }
+    return has_null;
+}
+
+Status NullRunDecoder::skip(size_t n) {
+    if (n > _remaining) {
+        return Status::Corruption("read past the end of a segment page null map");
+    }
+    while (n > 0) {
+        if (_run_left == 0) {
+            RETURN_IF_ERROR(_next_run());
+        }
+        size_t take = std::min(n, _run_left);
+        _run_left -= take;
+        _remaining -= take;
+        n -= take;
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "column/buffer.h"
+#include "column/column.h"
+#include "common/status.h"
+#include "types/logical_type.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// How the values of one segment page are laid out. Pages of one column may use
+// different encodings; the writer picks the smallest for each page.
+enum class EncodingType : uint8_t {
+    // Fixed-width values as-is; VARCHAR as page-relative offsets plus bytes.
+    PLAIN = 0,
+    // VARCHAR only: bit-packed codes into the column's dictionary page.
+    DICT = 1,
+    // Fixed-width types: (run length, value) pairs.
+    RLE = 2,
+    // Integer types: frame of reference, i.e. the page minimum followed by the
+    // bit-packed differences from it.
+    BIT_PACKED = 3,
+    // Integer types: the first value, then bit-packed differences between
+    // consecutive values (offset by their minimum). Suits sorted columns.
+    DELTA = 4,
+};
+
+const char* encoding_type_name(EncodingType type);
+
+// Smallest encoding of the |data| values of a page of a |type| column;
+// VARCHAR pages are dictionary-encoded by the column writer, never here.
+EncodingType choose_page_encoding(LogicalType type, const Column& data);
+
+// Appends the values of |data|, a non-nullable column of |type|.
+Status encode_page_values(EncodingType encoding, LogicalType type, const Column& data, Buffer<uint8_t>* dst);
+
+// Appends a DICT page holding |codes|, each below |dict_size|.
+void encode_dict_codes(const uint32_t* codes, size_t n, uint32_t dict_size, Buffer<uint8_t>* dst);
+
+// Appends the null map of a page as alternating run lengths, starting with a
+// (possibly empty) run of non-NULL rows.
+void encode_null_runs(const uint8_t* nulls, size_t n, Buffer<uint8_t>* dst);
+
+// Decodes the values of one page in order, straight into the buffers of a
+// destination column. |data| is not copied and must outlive the decoder.
+class PageDecoder {
+public:
+    virtual ~PageDecoder() = default;
+
+    // Appends the next |n| values to |dst|, a non-nullable column of the
+    // page's type.
+    virtual Status next_batch(size_t n, Column* dst) = 0;
+    virtual Status skip(size_t n) = 0;
+    // DICT pages only: writes the codes of the next |n| values, positions in
+    // the column's dictionary, to |codes| instead of looking up the words.
+    virtual Status next_dict_codes(size_t n, uint32_t* codes) {
+        return Status::NotSupported("segment page is not dictionary-encoded");
+    }
+
+    size_t num_values() const { return _num_values; }
+    size_t position() const { return _pos; }
+    size_t remaining() const { return _num_values - _pos; }
+
+protected:
+    explicit PageDecoder(size_t num_values) : _num_values(num_values) {}
+
+    Status check_remaining(size_t n) const {
+        return n <= remaining() ? Status::OK() : Status::Corruption("read past the end of a segment page");
+    }
+
+    const size_t _num_values;
+    size_t _pos = 0;
+};
+
+using PageDecoderPtr = std::unique_ptr<PageDecoder>;
+
+// |dict| holds the column's dictionary words for DICT pages, else nullptr.
+StatusOr<PageDecoderPtr> create_page_decoder(EncodingType encoding, LogicalType type, const Slice& data,
+                                             size_t num_values, const BinaryColumn* dict);
+
+// Decodes a null map written by encode_null_runs().
+class NullRunDecoder {
+public:
+    Status init(const Slice& data, size_t num_values);
+
+    // Appends the next |n| entries (1 = NULL) to |dst|; returns whether any
+    // of them is NULL.
+    StatusOr<bool> next_batch(size_t n, Buffer<uint8_t>* dst);
+    Status skip(size_t n);
+
+private:
+    // Moves to the next non-empty run.
+    Status _next_run();
+
+    Slice _data;
+    size_t _remaining = 0;
+    size_t _run_left = 0;
+    // The current run is NULL; runs alternate, starting with non-NULL.
+    bool _run_is_null = true;
+};
+
+} // namespace starrocks
@@ -0,0 +1,161 @@
+#include "storage/segment/segment.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "storage/segment/encoding.h"
+#include "util/block_compression.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+size_t SegmentColumnMeta::page_of_ordinal(uint64_t ordinal) const {
+    auto it = std::upper_bound(pages.begin(), pages.end(), ordinal,
+                               [](uint64_t o, const SegmentPageMeta& page) { return o < page.first_ordinal; });
+    return it - pages.begin() - 1;
+}
+
+StatusOr<SegmentSharedPtr> Segment::open(const std::string& path) {
+    ASSIGN_OR_RETURN(auto file, io::LocalFile::open(path));
+    return open(std::move(file));
+}
+
+StatusOr<SegmentSharedPtr> Segment::open(io::RandomAccessFilePtr file) {
+    SegmentSharedPtr segment(new Segment(std::move(file)));
+    RETURN_IF_ERROR(segment->_parse_footer(segment->_file->size()));
+    return segment;
+}
+
+Segment::~Segment() = default;
+
+Status Segment::_parse_footer(int64_t file_size) {
+    auto corrupted = [this](const std::string& what) {
+        return Status::Corruption("segment file " + path() + ": " + what);
+    };
+    if (file_size < static_cast<int64_t>(sizeof(uint32_t) + kSegmentTrailerSize)) {
+        return corrupted("too small");
+    }
+    uint8_t trailer[kSegmentTrailerSize];
+    RETURN_IF_ERROR(_file->read_at(file_size - sizeof(trailer), trailer, sizeof(trailer)));
+    uint32_t footer_size;
+    uint32_t checksum;
+    uint32_t magic;
+    memcpy(&footer_size, trailer, 4);
+    memcpy(&checksum, trailer + 4, 4);
+    memcpy(&magic, trailer + 8, 4);
+    if (magic != kSegmentMagic) {
+        return corrupted("bad magic");
+    }
+    if (footer_size > file_size - sizeof(trailer) - sizeof(uint32_t)) {
+        return corrupted("bad footer size");
+    }
+    _footer.resize_uninitialized(footer_size);
+    RETURN_IF_ERROR(_file->read_at(file_size - sizeof(trailer) - footer_size, _footer.data(), footer_size));
+    if (segment_checksum(_footer.data(), footer_size) != checksum) {
+        return corrupted("footer checksum mismatch");
+    }
+
+    Slice input(_footer.data(), _footer.size());
+    uint32_t version;
+    uint64_t num_rows;
+    uint64_t num_columns;
+    if (!get_fixed32(&input, &version) || !get_varint64(&input, &num_rows) || !get_varint64(&input, &num_columns)) {
+        return corrupted("truncated footer");
+    }
+    if (version != kSegmentFormatVersion) {
+        return Status::NotSupported("segment file " + path() + " has unsupported format version " +
+                                    std::to_string(version));
+    }
+    _num_rows = num_rows;
+    _columns.resize(num_columns);
+    for (auto& column : _columns) {
+        uint32_t slot_id;
+        uint8_t type;
+        uint8_t nullable;
+        uint8_t has_dict;
+        uint64_t num_pages;
+        if (!get_fixed32(&input, &slot_id) || !get_fixed8(&input, &type) || !get_fixed8(&input, &nullable) ||
+            type == TYPE_UNKNOWN || type > TYPE_BITMAP) {
+            return corrupted("bad column descriptor");
+        }
+        column.slot = SlotDescriptor{static_cast<SlotId>(slot_id), static_cast<LogicalType>(type), nullable != 0};
+        if (!decode_zone_map(column.slot.type, &input, &column.zone_map) || !get_fixed8(&input, &has_dict) ||
+            (has_dict && !decode_page_pointer(&input, &column.dict_page)) || !get_varint64(&input, &num_pages)) {
+            return corrupted("bad column metadata");
+        }
+        column.has_dict = has_dict;
+        column.pages.resize(num_pages);
+        uint64_t ordinal = 0;
+        for (auto& page : column.pages) {
+            if (!decode_page_pointer(&input, &page.pointer) || !get_varint32(&input, &page.num_rows) ||
+                !decode_zone_map(column.slot.type, &input, &page.zone_map)) {
+                return corrupted("bad page index");
+            }
+            page.first_ordinal = ordinal;
+            ordinal += page.num_rows;
+        }
+        if (ordinal != num_rows) {
+            return corrupted("page index does not cover the segment's rows");
+        }
+        _schema.push_back(column.slot);
+    }
+    _dicts.resize(num_columns);
+    return Status::OK();
+}
+
+Status Segment::read_page(const PagePointer& pointer, PageData* page) const {
+    page->stored.resize_uninitialized(pointer.size);
+    RETURN_IF_ERROR(_file->read_at(pointer.offset, page->stored.data(), pointer.size));
+    return finish_page_read(pointer, page);
+}
+
+io::ReadRequest Segment::page_read_request(const PagePointer& pointer, PageData* page) const {
+    page->stored.resize_uninitialized(pointer.size);
+    return io::ReadRequest{_file->fd(), static_cast<int64_t>(pointer.offset), pointer.size, page->stored.data()};
+}
+
+Status Segment::finish_page_read(const PagePointer& pointer, PageData* page) const {
+    if (pointer.size < sizeof(PageHeader) || page->stored.size() != pointer.size) {
+        return Status::Corruption("segment file " + path() + ": bad page pointer");
+    }
+    PageHeader& header = page->header;
+    memcpy(&header, page->stored.data(), sizeof(header));
+    const uint8_t* stored = page->stored.data() + sizeof(header);
+    if (header.stored_size != pointer.size - sizeof(header) || page_checksum(header, stored) != header.checksum ||
+        header.null_map_size > header.raw_size) {
+        return Status::Corruption("segment file " + path() + ": page checksum mismatch at offset " +
+                                  std::to_string(pointer.offset));
+    }
+    auto compression = static_cast<CompressionType>(header.compression);
+    page->body.resize_uninitialized(header.raw_size);
+    if (compression == CompressionType::NO_COMPRESSION) {
+        if (header.raw_size != header.stored_size) {
+            return Status::Corruption("segment file " + path() + ": bad page size");
+        }
+        memcpy(page->body.data(), stored, header.raw_size);
+        return Status::OK();
+    }
+    ASSIGN_OR_RETURN(const BlockCompressionCodec* codec, get_block_compression_codec(compression));
+    return codec->decompress(Slice(stored, header.stored_size), page->body.data(), header.raw_size);
+}
+
+StatusOr<const BinaryColumn*> Segment::dictionary(size_t idx) {
+    const SegmentColumnMeta& column = _columns[idx];
+    if (!column.has_dict) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> l(_dict_lock);
+    if (_dicts[idx] == nullptr) {
+        PageData page;
+        RETURN_IF_ERROR(read_page(column.dict_page, &page));
+        size_t num_words = page.header.num_rows;
+        ASSIGN_OR_RETURN(auto decoder, create_page_decoder(static_cast<EncodingType>(page.header.encoding),
+                                                           TYPE_VARCHAR, page.values(), num_words, nullptr));
+        auto words = std::make_unique<BinaryColumn>();
+        RETURN_IF_ERROR(decoder->next_batch(num_words, words.get()));
+        _dicts[idx] = std::move(words);
+    }
+    return _dicts[idx].get();
+}
+
+} // namespace starrocks
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "column/binary_column.h"
+#include "column/buffer.h"
+#include "common/status.h"
+#include "io/async_io.h"
+#include "io/random_access_file.h"
+#include "runtime/descriptors.h"
+#include "storage/segment/segment_format.h"
+#include "storage/zone_map_detail.h"
+
+namespace starrocks {
+
+struct SegmentPageMeta {
+    PagePointer pointer;
+    uint64_t first_ordinal = 0;
+    uint32_t num_rows = 0;
+    ZoneMapDetail zone_map;
+};
+
+struct SegmentColumnMeta {
+    SlotDescriptor slot;
+    // Covers the whole segment.
+    ZoneMapDetail zone_map;
+    bool has_dict = false;
+    PagePointer dict_page;
+    // In row order.
+    std::vector<SegmentPageMeta> pages;
+
+    // Index of the page holding row |ordinal|, which must be below the
+    // segment's row count.
+    size_t page_of_ordinal(uint64_t ordinal) const;
+};
+
+// A page read from disk, verified and decompressed.
+struct PageData {
+    PageHeader header;
+    Buffer<uint8_t> body;
+    // Compressed body, kept to reuse its allocation.
+    Buffer<uint8_t> stored;
+
+    Slice values() const { return Slice(body.data(), header.raw_size - header.null_map_size); }
+    Slice null_map() const { return Slice(body.data() + header.raw_size - header.null_map_size, header.null_map_size); }
+};
+
+class Segment;
+using SegmentSharedPtr = std::shared_ptr<Segment>;
+
+// An open, immutable segment file (see segment_format.h). Opening it reads
+// only the footer; pages are read on demand by SegmentIterators, which may
+// share a Segment across threads.
+class Segment {
+public:
+    static StatusOr<SegmentSharedPtr> open(const std::string& path);
+    // Reads the segment through |file|, e.g. an object of a lake table.
+    static StatusOr<SegmentSharedPtr> open(io::RandomAccessFilePtr file);
+
+    ~Segment();
+
+    const std::string& path() const { return _file->name(); }
+    int64_t file_size() const { return _file->size(); }
+    int64_t num_rows() const { return _num_rows; }
+    size_t num_columns() const { return _columns.size(); }
+    // Slots the segment was written with, in column order.
+    const RowDescriptor& schema() const { return _schema; }
+    const SegmentColumnMeta& column(size_t idx) const { return _columns[idx]; }
+
+    Status read_page(const PagePointer& pointer, PageData* page) const;
+    // read_page() in two steps, for callers doing the I/O themselves:
+    // page_read_request() sizes |page|'s buffer and returns the read filling
+    // it, finish_page_read() verifies and decompresses the page once read.
+    // Only for local segments, which AsyncIoEngine reads can target.
+    bool is_local() const { return _file->fd() >= 0; }
+    io::ReadRequest page_read_request(const PagePointer& pointer, PageData* page) const;
+    Status finish_page_read(const PagePointer& pointer, PageData* page) const;
+
+    // Dictionary words of column |idx|, read on first use; nullptr for
+    // columns without a dictionary.
+    StatusOr<const BinaryColumn*> dictionary(size_t idx);
+
+private:
+    explicit Segment(io::RandomAccessFilePtr file) : _file(std::move(file)) {}
+
+    Status _parse_footer(int64_t file_size);
+
+    const io::RandomAccessFilePtr _file;
+    // Zone maps of VARCHAR columns point into the footer.
+    Buffer<uint8_t> _footer;
+    int64_t _num_rows = 0;
+    RowDescriptor _schema;
+    std::vector<SegmentColumnMeta> _columns;
+
+    std::mutex _dict_lock;
+    std::vector<std::unique_ptr<BinaryColumn>> _dicts;
+};
+
+} // namespace starrocks
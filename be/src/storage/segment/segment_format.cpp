@@ -0,0 +1,71 @@
+#include "storage/segment/segment_format.h"
+
+#include <cstring>
+
+#include "util/coding.h"
+
+namespace starrocks {
+
+void encode_page_pointer(const PagePointer& pointer, Buffer<uint8_t>* dst) {
+    put_varint64(dst, pointer.offset);
+    put_varint64(dst, pointer.size);
+}
+
+bool decode_page_pointer(Slice* input, PagePointer* pointer) {
+    return get_varint64(input, &pointer->offset) && get_varint32(input, &pointer->size);
+}
+
+void encode_zone_map(LogicalType type, const ZoneMapDetail& zone_map, Buffer<uint8_t>* dst) {
+    put_fixed8(dst, static_cast<uint8_t>(zone_map.has_null) | static_cast<uint8_t>(zone_map.has_not_null) << 1);
+    if (!zone_map.has_not_null) {
+        return;
+    }
+    type_dispatch_all(type, [&](auto lt) {
+        using CppType = RunTimeCppType<decltype(lt)::value>;
+        for (const Datum* bound : {&zone_map.min, &zone_map.max}) {
+            if constexpr (std::is_same_v<CppType, Slice>) {
+                put_length_prefixed_slice(dst, bound->get_slice());
+            } else {
+                CppType v = bound->get<CppType>();
+                dst->append(reinterpret_cast<const uint8_t*>(&v), sizeof(v));
+            }
+        }
+    });
+}
+
+bool decode_zone_map(LogicalType type, Slice* input, ZoneMapDetail* zone_map) {
+    uint8_t flags;
+    if (!get_fixed8(input, &flags)) {
+        return false;
+    }
+    zone_map->has_null = flags & 1;
+    zone_map->has_not_null = flags & 2;
+    zone_map->min.set_null();
+    zone_map->max.set_null();
+    if (!zone_map->has_not_null) {
+        return true;
+    }
+    return type_dispatch_all(type, [&](auto lt) {
+        using CppType = RunTimeCppType<decltype(lt)::value>;
+        for (Datum* bound : {&zone_map->min, &zone_map->max}) {
+            if constexpr (std::is_same_v<CppType, Slice>) {
+                Slice v;
+                if (!get_length_prefixed_slice(input, &v)) {
+                    return false;
+                }
+                bound->set(v);
+            } else {
+                CppType v;
+                if (input->size < sizeof(v)) {
+                    return false;
+                }
+                memcpy(&v, input->data, sizeof(v));
+                input->remove_prefix(sizeof(v));
+                bound->set(v);
+            }
+        }
+        return true;
+    });
+}
+
+} // namespace starrocks
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+#include "column/buffer.h"
+#include "storage/zone_map_detail.h"
+#include "types/logical_type.h"
+#include "util/hash_util.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// On-disk layout of a segment file:
+//
+//   magic
+//   data pages of column 0, data pages of column 1, ...
+//   dictionary pages of the dictionary-encoded columns
+//   footer
+//   footer size (u32) | footer checksum (u32) | magic
+//
+// A page is a PageHeader followed by its stored (possibly compressed) body.
+// Uncompressed, the body holds the encoded values, then the null map when
+// the page has NULLs.
+//
+// The footer holds, for each column, its type, the segment-wide zone map, the
+// location of its dictionary and one entry per page: location, row count and
+// zone map. Pages are listed in row order, so the first row ordinal of each
+// page is the running sum of the row counts; readers binary-search it to seek.
+// Integers are little-endian; counts and offsets in the footer are varints.
+
+constexpr uint32_t kSegmentMagic = 0x47455352; // "RSEG"
+constexpr uint32_t kSegmentFormatVersion = 1;
+// Footer size, footer checksum and magic.
+constexpr size_t kSegmentTrailerSize = 12;
+
+struct PageHeader {
+    // See page_checksum().
+    uint32_t checksum;
+    uint32_t num_rows;
+    uint8_t encoding;
+    uint8_t compression;
+    uint8_t unused[2];
+    // Bytes of the uncompressed body taken by the null map; 0 without NULLs.
+    uint32_t null_map_size;
+    uint32_t raw_size;
+    uint32_t stored_size;
+};
+static_assert(sizeof(PageHeader) == 24);
+
+struct PagePointer {
+    uint64_t offset = 0;
+    // Header included.
+    uint32_t size = 0;
+};
+
+inline uint32_t segment_checksum(const uint8_t* data, size_t len) {
+    return static_cast<uint32_t>(HashUtil::hash_bytes(data, len));
+}
+
+// Covers the header fields after the checksum and the stored body.
+inline uint32_t page_checksum(const PageHeader& header, const uint8_t* stored) {
+    constexpr size_t kOffset = sizeof(header.checksum);
+    uint64_t seed = HashUtil::hash_bytes(reinterpret_cast<const uint8_t*>(&header) + kOffset, sizeof(header) - kOffset);
+    return static_cast<uint32_t>(HashUtil::hash_bytes(stored, header.stored_size, seed));
+}
+
+void encode_page_pointer(const PagePointer& pointer, Buffer<uint8_t>* dst);
+bool decode_page_pointer(Slice* input, PagePointer* pointer);
+
+// Bounds of fixed-width types are stored as their raw bytes, VARCHAR bounds
+// as the strings themselves.
+void encode_zone_map(LogicalType type, const ZoneMapDetail& zone_map, Buffer<uint8_t>* dst);
+// VARCHAR bounds of the decoded zone map point into |input|'s bytes.
+bool decode_zone_map(LogicalType type, Slice* input, ZoneMapDetail* zone_map);
+
+} // namespace starrocks
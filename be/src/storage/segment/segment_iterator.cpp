@@ -0,0 +1,522 @@
+#include "storage/segment/segment_iterator.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "column/column_helper.h"
+#include "column/nullable_column.h"
+#include "storage/segment/encoding.h"
+
+namespace starrocks {
+
+// Reads one column sequentially from a position set by seek(), loading and
+// decoding one page at a time. Pages read ahead wait in a queue, in page
+// order, until the column reaches them; those it skips are dropped.
+class SegmentIterator::ColumnIterator {
+public:
+    ColumnIterator(Segment* segment, size_t column_idx, const GlobalDictionary* global_dict, SegmentReadStats* stats)
+            : _segment(segment),
+              _column_idx(column_idx),
+              _meta(segment->column(column_idx)),
+              _global_dict(global_dict),
+              _stats(stats) {}
+
+    Status init() {
+        ASSIGN_OR_RETURN(_dict, _segment->dictionary(_column_idx));
+        if (_global_dict != nullptr && _dict != nullptr) {
+            _dict_codes.resize_uninitialized(_dict->size());
+            _global_dict->encode(*_dict, _dict_codes.data());
+        }
+        return Status::OK();
+    }
+
+    uint64_t ordinal() const { return _ordinal; }
+
+    Status seek(uint64_t ordinal) {
+        size_t page_idx = _meta.page_of_ordinal(ordinal);
+        const SegmentPageMeta& page = _meta.pages[page_idx];
+        // Decoders only move forward; going back means starting the page over.
+        if (_decoder == nullptr || page_idx != _page_idx || ordinal < page.first_ordinal + _decoder->position()) {
+            RETURN_IF_ERROR(_load_page(page_idx));
+        }
+        size_t skip = ordinal - page.first_ordinal - _decoder->position();
+        RETURN_IF_ERROR(_decoder->skip(skip));
+        if (_page_has_null) {
+            RETURN_IF_ERROR(_nulls.skip(skip));
+        }
+        _ordinal = ordinal;
+        return Status::OK();
+    }
+
+    // Appends the next |n| rows to |dst|, which is nullable iff the column is.
+    Status next_batch(size_t n, Column* dst) {
+        while (n > 0) {
+            if (_decoder == nullptr || _decoder->remaining() == 0) {
+                RETURN_IF_ERROR(_load_page(_decoder == nullptr ? _meta.page_of_ordinal(_ordinal) : _page_idx + 1));
+            }
+            size_t take = std::min(n, _decoder->remaining());
+            Column* values = dst;
+            const uint8_t* nulls = nullptr;
+            if (_meta.slot.nullable) {
+                auto* nullable = static_cast<NullableColumn*>(dst);
+                values = nullable->data_column().get();
+                RETURN_IF_ERROR(_next_values(take, values));
+                NullData& null_data = nullable->null_column_data();
+                if (_page_has_null) {
+                    ASSIGN_OR_RETURN(bool has_null, _nulls.next_batch(take, &null_data));
+                    nullable->set_has_null(has_null);
+                    nulls = null_data.data() + null_data.size() - take;
+                } else {
+                    null_data.resize(null_data.size() + take, 0);
+                }
+            } else {
+                RETURN_IF_ERROR(_next_values(take, values));
+            }
+            if (_global_dict != nullptr) {
+                int32_t* codes = static_cast<Int32Column*>(values)->get_data().data() + values->size() - take;
+                RETURN_IF_ERROR(_check_codes(codes, nulls, take));
+            }
+            _ordinal += take;
+            n -= take;
+        }
+        return Status::OK();
+    }
+
+    // Adds to |reads| the reads of the pages holding the rows of |ranges|
+    // from |from| on that were not read ahead yet, stopping once they reach
+    // |max_bytes|.
+    void read_ahead(const std::vector<RowRange>& ranges, size_t range_idx, uint64_t from, int64_t max_bytes,
+                    std::vector<io::ReadRequest>* reads) {
+        int64_t bytes = 0;
+        for (size_t i = range_idx; i < ranges.size() && bytes < max_bytes; ++i) {
+            uint64_t begin = i == range_idx ? from : ranges[i].begin;
+            size_t last = _meta.page_of_ordinal(ranges[i].end - 1);
+            for (size_t p = _meta.page_of_ordinal(begin); p <= last && bytes < max_bytes; ++p) {
+                if (p < _read_ahead_end || (_decoder != nullptr && p == _page_idx)) {
+                    continue;
+                }
+                const PagePointer& pointer = _meta.pages[p].pointer;
+                _read_ahead.push_back({p, PageData()});
+                reads->push_back(_segment->page_read_request(pointer, &_read_ahead.back().page));
+                _read_ahead_end = p + 1;
+                bytes += pointer.size;
+            }
+        }
+    }
+
+private:
+    struct ReadAheadPage {
+        size_t page_idx;
+        PageData page;
+    };
+
+    // Appends the next |n| values of the page to |dst|, as their codes in the
+    // global dictionary if there is one; -1 for values not in it.
+    Status _next_values(size_t n, Column* dst) {
+        if (_global_dict == nullptr) {
+            return _decoder->next_batch(n, dst);
+        }
+        auto& codes = static_cast<Int32Column*>(dst)->get_data();
+        size_t old = codes.size();
+        codes.resize_uninitialized(old + n);
+        if (static_cast<EncodingType>(_page.header.encoding) == EncodingType::DICT) {
+            _segment_codes.resize_uninitialized(n);
+            RETURN_IF_ERROR(_decoder->next_dict_codes(n, _segment_codes.data()));
+            for (size_t i = 0; i < n; ++i) {
+                codes[old + i] = _dict_codes[_segment_codes[i]];
+            }
+        } else {
+            _words.reset_column();
+            RETURN_IF_ERROR(_decoder->next_batch(n, &_words));
+            _global_dict->encode(_words, codes.data() + old);
+        }
+        return Status::OK();
+    }
+
+    // Fails on a value missing from the global dictionary. The values under
+    // NULL rows need not be in it and get code 0.
+    Status _check_codes(int32_t* codes, const uint8_t* nulls, size_t n) const {
+        for (size_t i = 0; i < n; ++i) {
+            if (codes[i] >= 0) {
+                continue;
+            }
+            if (nulls == nullptr || !nulls[i]) {
+                return Status::NotFound("segment file " + _segment->path() + ": column " +
+                                        std::to_string(_column_idx) + " has values missing from its global dictionary");
+            }
+            codes[i] = 0;
+        }
+        return Status::OK();
+    }
+
+    Status _load_page(size_t page_idx) {
+        if (page_idx >= _meta.pages.size()) {
+            return Status::InternalError("segment column read past its last page");
+        }
+        const SegmentPageMeta& meta = _meta.pages[page_idx];
+        _decoder.reset();
+        while (!_read_ahead.empty() && _read_ahead.front().page_idx < page_idx) {
+            _read_ahead.pop_front();
+        }
+        if (!_read_ahead.empty() && _read_ahead.front().page_idx == page_idx) {
+            std::swap(_page, _read_ahead.front().page);
+            _read_ahead.pop_front();
+            RETURN_IF_ERROR(_segment->finish_page_read(meta.pointer, &_page));
+            ++_stats->pages_read_ahead;
+        } else {
+            RETURN_IF_ERROR(_segment->read_page(meta.pointer, &_page));
+        }
+        if (_page.header.num_rows != meta.num_rows) {
+            return Status::Corruption("segment file " + _segment->path() + ": page row count mismatch");
+        }
+        ASSIGN_OR_RETURN(_decoder, create_page_decoder(static_cast<EncodingType>(_page.header.encoding),
+                                                       _meta.slot.type, _page.values(), meta.num_rows, _dict));
+        _page_has_null = _page.header.null_map_size > 0;
+        if (_page_has_null) {
+            RETURN_IF_ERROR(_nulls.init(_page.null_map(), meta.num_rows));
+        }
+        _page_idx = page_idx;
+        ++_stats->pages_read;
+        _stats->bytes_read += meta.pointer.size;
+        return Status::OK();
+    }
+
+    Segment* _segment;
+    const size_t _column_idx;
+    const SegmentColumnMeta& _meta;
+    const GlobalDictionary* _global_dict;
+    SegmentReadStats* _stats;
+    const BinaryColumn* _dict = nullptr;
+    // With a global dictionary: the global code of each word of _dict, and
+    // scratch space for decoding.
+    Buffer<int32_t> _dict_codes;
+    Buffer<uint32_t> _segment_codes;
+    BinaryColumn _words;
+
+    size_t _page_idx = 0;
+    PageData _page;
+    PageDecoderPtr _decoder;
+    NullRunDecoder _nulls;
+    bool _page_has_null = false;
+    // Next row to read.
+    uint64_t _ordinal = 0;
+
+    std::deque<ReadAheadPage> _read_ahead;
+    // Pages below it were read ahead, or passed before they could be.
+    size_t _read_ahead_end = 0;
+};
+
+SegmentIterator::SegmentIterator(SegmentSharedPtr segment, SegmentReadOptions options)
+        : _segment(std::move(segment)), _options(std::move(options)) {}
+
+SegmentIterator::~SegmentIterator() = default;
+
+void SegmentIterator::_intersect_ranges(const std::vector<RowRange>& a, const std::vector<RowRange>& b,
+                                        std::vector<RowRange>* out) {
+    out->clear();
+    for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+        uint64_t begin = std::max(a[i].begin, b[j].begin);
+        uint64_t end = std::min(a[i].end, b[j].end);
+        if (begin < end) {
+            out->push_back({begin, end});
+        }
+        if (a[i].end < b[j].end) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+}
+
+void SegmentIterator::_subtract_deleted(const std::vector<RowRange>& ranges, const DelVector& del_vector,
+                                        std::vector<RowRange>* out) {
+    out->clear();
+    const std::vector<uint32_t>& rowids = del_vector.rowids();
+    auto it = rowids.begin();
+    for (const RowRange& range : ranges) {
+        uint64_t begin = range.begin;
+        it = std::lower_bound(it, rowids.end(), begin);
+        for (; it != rowids.end() && *it < range.end; ++it) {
+            if (begin < *it) {
+                out->push_back({begin, *it});
+            }
+            begin = *it + 1;
+        }
+        if (begin < range.end) {
+            out->push_back({begin, range.end});
+        }
+    }
+}
+
+Status SegmentIterator::init() {
+    size_t num_columns = _segment->num_columns();
+    if (_options.column_ids.empty()) {
+        return Status::InvalidArgument("segment scan returns no column");
+    }
+    if (_options.chunk_size == 0) {
+        return Status::InvalidArgument("segment scan chunk size is 0");
+    }
+    for (ColumnId id : _options.column_ids) {
+        if (id >= num_columns) {
+            return Status::InvalidArgument("segment has no column " + std::to_string(id));
+        }
+        if (std::find(_read_columns.begin(), _read_columns.end(), id) != _read_columns.end()) {
+            return Status::InvalidArgument("segment column " + std::to_string(id) + " requested twice");
+        }
+        _read_columns.push_back(id);
+    }
+    for (const auto& [id, dict] : _options.global_dicts) {
+        if (id >= num_columns || _segment->column(id).slot.type != TYPE_VARCHAR || dict == nullptr) {
+            return Status::InvalidArgument("global dictionary for segment column " + std::to_string(id) +
+                                           ", which is not VARCHAR");
+        }
+    }
+    for (const ColumnPredicate* predicate : _options.predicates) {
+        ColumnId id = predicate->column_id();
+        if (id >= num_columns) {
+            return Status::InvalidArgument("predicate " + predicate->debug_string() + " does not match the segment");
+        }
+        auto it = std::find(_read_columns.begin(), _read_columns.end(), id);
+        if (it == _read_columns.end()) {
+            it = _read_columns.insert(_read_columns.end(), id);
+        }
+        _predicate_columns.push_back(it - _read_columns.begin());
+    }
+    for (ColumnId id : _read_columns) {
+        auto it = _options.global_dicts.find(id);
+        _read_dicts.push_back(it != _options.global_dicts.end() ? it->second.get() : nullptr);
+    }
+    for (size_t i = 0; i < _options.predicates.size(); ++i) {
+        const ColumnPredicate* predicate = _options.predicates[i];
+        if (predicate->logical_type() != _read_type(_predicate_columns[i])) {
+            return Status::InvalidArgument("predicate " + predicate->debug_string() + " does not match the segment");
+        }
+    }
+    _is_eager.assign(_read_columns.size(), false);
+    for (size_t i : _predicate_columns) {
+        if (!_is_eager[i]) {
+            _is_eager[i] = true;
+            _eager_columns.push_back(i);
+        }
+    }
+
+    auto num_rows = static_cast<uint64_t>(_segment->num_rows());
+    uint64_t begin = std::min<uint64_t>(std::max<int64_t>(_options.range_begin, 0), num_rows);
+    uint64_t end = _options.range_end < 0 ? num_rows : std::min<uint64_t>(_options.range_end, num_rows);
+    if (begin < end) {
+        _ranges.push_back({begin, end});
+    }
+    std::vector<RowRange> narrowed;
+    for (const ColumnPredicate* predicate : _options.predicates) {
+        if (_ranges.empty()) {
+            break;
+        }
+        _intersect_ranges(_ranges, _zone_map_ranges(predicate, begin, end), &narrowed);
+        _ranges.swap(narrowed);
+    }
+    uint64_t remaining = 0;
+    for (const auto& range : _ranges) {
+        remaining += range.end - range.begin;
+    }
+    _stats.rows_pruned = begin < end ? end - begin - remaining : 0;
+    if (_options.del_vector != nullptr && !_options.del_vector->empty() && !_ranges.empty()) {
+        _subtract_deleted(_ranges, *_options.del_vector, &narrowed);
+        _ranges.swap(narrowed);
+        uint64_t live = 0;
+        for (const auto& range : _ranges) {
+            live += range.end - range.begin;
+        }
+        _stats.rows_deleted = remaining - live;
+    }
+    _next_ordinal = _ranges.empty() ? 0 : _ranges[0].begin;
+
+    for (size_t i = 0; i < _read_columns.size(); ++i) {
+        _column_iterators.emplace_back(
+                std::make_unique<ColumnIterator>(_segment.get(), _read_columns[i], _read_dicts[i], &_stats));
+        RETURN_IF_ERROR(_column_iterators.back()->init());
+    }
+    return Status::OK();
+}
+
+LogicalType SegmentIterator::_read_type(size_t idx) const {
+    return _read_dicts[idx] != nullptr ? TYPE_INT : _segment->column(_read_columns[idx]).slot.type;
+}
+
+std::vector<SegmentIterator::RowRange> SegmentIterator::_zone_map_ranges(const ColumnPredicate* predicate,
+                                                                         uint64_t begin, uint64_t end) {
+    std::vector<RowRange> ranges;
+    const SegmentColumnMeta& meta = _segment->column(predicate->column_id());
+    auto it = _options.global_dicts.find(predicate->column_id());
+    const GlobalDictionary* dict = it != _options.global_dicts.end() ? it->second.get() : nullptr;
+    auto zone_map_filter = [predicate, dict](const ZoneMapDetail& zone_map) {
+        return predicate->zone_map_filter(dict != nullptr ? dict->code_zone_map(zone_map) : zone_map);
+    };
+    if (!zone_map_filter(meta.zone_map)) {
+        _stats.pages_pruned += meta.pages.size();
+        return ranges;
+    }
+    for (size_t i = meta.page_of_ordinal(begin); i < meta.pages.size(); ++i) {
+        const SegmentPageMeta& page = meta.pages[i];
+        if (page.first_ordinal >= end) {
+            break;
+        }
+        if (!zone_map_filter(page.zone_map)) {
+            ++_stats.pages_pruned;
+            continue;
+        }
+        uint64_t page_begin = std::max(page.first_ordinal, begin);
+        uint64_t page_end = std::min(page.first_ordinal + page.num_rows, end);
+        if (!ranges.empty() && ranges.back().end == page_begin) {
+            ranges.back().end = page_end;
+        } else {
+            ranges.push_back({page_begin, page_end});
+        }
+    }
+    return ranges;
+}
+
+StatusOr<bool> SegmentIterator::read_ahead(io::AsyncIoEngine* engine, int64_t max_bytes, io::ReadCallback done) {
+    if (_range_idx >= _ranges.size() || max_bytes <= 0 || !_segment->is_local()) {
+        return false;
+    }
+    // The columns every row is decoded for; the others are read only where
+    // rows pass, which is not known ahead.
+    std::vector<size_t> columns = _eager_columns;
+    if (_predicate_columns.empty()) {
+        columns.resize(_read_columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i] = i;
+        }
+    }
+    int64_t column_bytes = std::max<int64_t>(max_bytes / columns.size(), 1);
+    std::vector<io::ReadRequest> reads;
+    for (size_t i : columns) {
+        _column_iterators[i]->read_ahead(_ranges, _range_idx, _next_ordinal, column_bytes, &reads);
+    }
+    if (reads.empty()) {
+        return false;
+    }
+    RETURN_IF_ERROR(engine->submit(std::move(reads), std::move(done)));
+    return true;
+}
+
+Status SegmentIterator::_read_column(size_t idx, uint64_t start, size_t n, Column* dst) {
+    ColumnIterator* iter = _column_iterators[idx].get();
+    if (iter->ordinal() != start) {
+        RETURN_IF_ERROR(iter->seek(start));
+    }
+    return iter->next_batch(n, dst);
+}
+
+void SegmentIterator::_append_selected_ranges(uint64_t start, const uint8_t* selection, size_t n) {
+    for (size_t i = 0; i < n;) {
+        if (!selection[i]) {
+            ++i;
+            continue;
+        }
+        size_t j = i + 1;
+        while (j < n && selection[j]) {
+            ++j;
+        }
+        if (!_selected_ranges.empty() && _selected_ranges.back().end == start + i) {
+            _selected_ranges.back().end = start + j;
+        } else {
+            _selected_ranges.push_back({start + i, start + j});
+        }
+        i = j;
+    }
+}
+
+Status SegmentIterator::get_next(ChunkPtr* chunk) {
+    const RowDescriptor& schema = _segment->schema();
+    size_t num_outputs = _options.column_ids.size();
+    Columns columns(num_outputs);
+    for (size_t i = 0; i < num_outputs; ++i) {
+        columns[i] = ColumnHelper::create_column(_read_type(i), schema[_read_columns[i]].nullable);
+    }
+
+    // Evaluate the predicates batch by batch until half a chunk of rows pass,
+    // so that selective scans still return reasonably sized chunks.
+    _selected_ranges.clear();
+    size_t selected = 0;
+    size_t min_selected = std::max<size_t>(_options.chunk_size / 2, 1);
+    Columns batch(_read_columns.size());
+    while (selected < min_selected && _range_idx < _ranges.size()) {
+        const RowRange& range = _ranges[_range_idx];
+        uint64_t start = _next_ordinal;
+        size_t n = std::min<uint64_t>(_options.chunk_size - selected, range.end - start);
+        _next_ordinal += n;
+        if (_next_ordinal == range.end && ++_range_idx < _ranges.size()) {
+            _next_ordinal = _ranges[_range_idx].begin;
+        }
+        _stats.rows_read += n;
+        if (_predicate_columns.empty()) {
+            _selection.assign(n, 1);
+            _append_selected_ranges(start, _selection.data(), n);
+            selected += n;
+            continue;
+        }
+
+        for (size_t i : _eager_columns) {
+            batch[i] = ColumnHelper::create_column(_read_type(i), schema[_read_columns[i]].nullable);
+            RETURN_IF_ERROR(_read_column(i, start, n, batch[i].get()));
+        }
+        _selection.assign(n, 1);
+        for (size_t i = 0; i < _options.predicates.size(); ++i) {
+            _options.predicates[i]->evaluate_and(batch[_predicate_columns[i]].get(), _selection.data(), 0, n);
+        }
+        size_t passed = ColumnHelper::count_nonzero(_selection);
+        if (passed == 0) {
+            continue;
+        }
+        for (size_t i : _eager_columns) {
+            if (i >= num_outputs) {
+                continue;
+            }
+            if (passed < n) {
+                batch[i]->filter(_selection);
+            }
+            columns[i]->append(*batch[i], 0, passed);
+        }
+        _append_selected_ranges(start, _selection.data(), n);
+        selected += passed;
+    }
+    if (selected == 0) {
+        return Status::EndOfFile("end of segment range");
+    }
+
+    // Only now decode the other columns, for the selected rows alone.
+    for (size_t i = 0; i < num_outputs; ++i) {
+        if (_is_eager[i]) {
+            continue;
+        }
+        columns[i]->reserve(selected);
+        for (const RowRange& range : _selected_ranges) {
+            RETURN_IF_ERROR(_read_column(i, range.begin, range.end - range.begin, columns[i].get()));
+        }
+    }
+
+    auto result = std::make_shared<Chunk>();
+    for (size_t i = 0; i < num_outputs; ++i) {
+        result->append_column(std::move(columns[i]), schema[_read_columns[i]].id);
+    }
+    _stats.rows_returned += selected;
+    *chunk = std::move(result);
+    return Status::OK();
+}
+
+RowDescriptor segment_read_row_desc(const Segment& segment, const SegmentReadOptions& options) {
+    RowDescriptor desc;
+    desc.reserve(options.column_ids.size());
+    for (ColumnId id : options.column_ids) {
+        SlotDescriptor slot = segment.schema()[id];
+        if (auto it = options.global_dicts.find(id); it != options.global_dicts.end() && it->second != nullptr) {
+            slot.type = TYPE_INT;
+            slot.dict_id = it->second->id();
+        }
+        desc.push_back(slot);
+    }
+    return desc;
+}
+
+} // namespace starrocks
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/constexpr.h"
+#include "common/status.h"
+#include "storage/column_predicate.h"
+#include "storage/del_vector.h"
+#include "storage/global_dict.h"
+#include "storage/segment/segment.h"
+
+namespace starrocks {
+
+struct SegmentReadOptions {
+    // Schema positions of the columns to return, in output order; distinct.
+    std::vector<ColumnId> column_ids;
+    // Filters ANDed together. Their column_id is a schema position too, and
+    // the column need not be among the returned ones. Not owned.
+    std::vector<const ColumnPredicate*> predicates;
+    // VARCHAR columns read as the INT codes of their words in these
+    // dictionaries, keyed by schema position; predicates on them must be on
+    // the codes (see new_dict_code_predicate()).
+    std::unordered_map<ColumnId, GlobalDictPtr> global_dicts;
+    // Rows [range_begin, range_end) of the segment; range_end < 0 means up to
+    // the last row.
+    int64_t range_begin = 0;
+    int64_t range_end = -1;
+    // Rows to skip, deleted by later writes to a primary-key table.
+    DelVectorPtr del_vector;
+    size_t chunk_size = DEFAULT_CHUNK_SIZE;
+};
+
+struct SegmentReadStats {
+    // Rows of the requested range ruled out by zone maps without being read.
+    int64_t rows_pruned = 0;
+    // Rows of the range left after pruning that options.del_vector skipped.
+    int64_t rows_deleted = 0;
+    // Rows the predicates were evaluated on (every row of the range left
+    // after pruning), and rows that passed them. Columns without predicates
+    // are only decoded for the rows that passed.
+    int64_t rows_read = 0;
+    int64_t rows_returned = 0;
+    // Pages of the predicate columns ruled out by their zone maps.
+    int64_t pages_pruned = 0;
+    int64_t pages_read = 0;
+    // Pages among pages_read that read_ahead() had fetched.
+    int64_t pages_read_ahead = 0;
+    int64_t bytes_read = 0;
+};
+
+// Scans a range of rows of a segment. Predicates are first checked against
+// the segment's and each page's zone maps, narrowing the range down to the
+// runs of pages that may hold matching rows; the ordinal index then seeks
+// every column straight to those rows, so pages outside them are never read.
+// Deleted rows are cut out of the ranges the same way, so a primary-key
+// table's replaced rows cost no merge on read.
+//
+// Materialization is late: only the predicate columns are decoded for every
+// row of the remaining range. The rows passing the predicates form a set of
+// row ranges, and the other returned columns are decoded for those ranges
+// alone, so at low selectivity most of their pages are neither read nor
+// decoded. Pages that are read decode straight into the output columns.
+//
+// Columns with a global dictionary are decoded to codes: dictionary-encoded
+// pages by mapping the segment's codes to the global ones, which costs no
+// string at all, plain pages by looking each string up. Their zone maps are
+// translated to codes too, so any INT predicate can prune them.
+class SegmentIterator {
+public:
+    SegmentIterator(SegmentSharedPtr segment, SegmentReadOptions options);
+    ~SegmentIterator();
+
+    Status init();
+
+    // Returns EndOfFile once the range is exhausted. Chunks hold the columns
+    // of options.column_ids, keyed by the segment schema's slot ids, and only
+    // rows passing all predicates.
+    Status get_next(ChunkPtr* chunk);
+
+    // Starts reading, through |engine|, the pages the next get_next() calls
+    // decode for every row they scan: those of the predicate columns, or of
+    // all returned columns without predicates. Reads cover the rows from the
+    // next one to scan on, about |max_bytes| of pages beyond those already
+    // read ahead; only local segments are. Returns whether any read started;
+    // if so, |done| runs once they have all finished, and get_next() must not
+    // be called before. After a failed read the iterator must not be used
+    // any further.
+    StatusOr<bool> read_ahead(io::AsyncIoEngine* engine, int64_t max_bytes, io::ReadCallback done);
+
+    const SegmentReadStats& stats() const { return _stats; }
+
+private:
+    class ColumnIterator;
+
+    struct RowRange {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // Rows in both |a| and |b|.
+    static void _intersect_ranges(const std::vector<RowRange>& a, const std::vector<RowRange>& b,
+                                  std::vector<RowRange>* out);
+    // Type the column at |idx| of _read_columns is returned as.
+    LogicalType _read_type(size_t idx) const;
+    // Rows of |ranges| not deleted by |del_vector|.
+    static void _subtract_deleted(const std::vector<RowRange>& ranges, const DelVector& del_vector,
+                                  std::vector<RowRange>* out);
+    // Rows of [begin, end) in pages whose zone maps |predicate| accepts.
+    std::vector<RowRange> _zone_map_ranges(const ColumnPredicate* predicate, uint64_t begin, uint64_t end);
+    // Appends rows [start, start + n) of _read_columns[idx] to |dst|.
+    Status _read_column(size_t idx, uint64_t start, size_t n, Column* dst);
+    // Adds the rows of [start, start + n) selected by |selection| to
+    // _selected_ranges.
+    void _append_selected_ranges(uint64_t start, const uint8_t* selection, size_t n);
+
+    SegmentSharedPtr _segment;
+    SegmentReadOptions _options;
+    SegmentReadStats _stats;
+
+    // Disjoint and in row order.
+    std::vector<RowRange> _ranges;
+    size_t _range_idx = 0;
+    uint64_t _next_ordinal = 0;
+
+    // Columns read: the returned ones, then predicate-only ones.
+    std::vector<ColumnId> _read_columns;
+    // The global dictionary of each, if any.
+    std::vector<const GlobalDictionary*> _read_dicts;
+    std::vector<std::unique_ptr<ColumnIterator>> _column_iterators;
+    // Position in _read_columns of each predicate's column.
+    std::vector<size_t> _predicate_columns;
+    // Distinct positions of the predicate columns, decoded for every row.
+    std::vector<size_t> _eager_columns;
+    std::vector<bool> _is_eager;
+    Filter _selection;
+    // Rows of the chunk being built that passed the predicates.
+    std::vector<RowRange> _selected_ranges;
+};
+
+// Layout of the chunks a SegmentIterator over |segment| with |options|
+// returns. Columns read as global dictionary codes are INT slots carrying
+// their dictionary's id.
+RowDescriptor segment_read_row_desc(const Segment& segment, const SegmentReadOptions& options);
+
+} // namespace starrocks
@@ -0,0 +1,503 @@
+#include "storage/segment/segment_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "column/nullable_column.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+static Status io_error(const std::string& what) {
+    return Status::IOError(what + ": " + std::strerror(errno));
+}
+
+template <LogicalType LT>
+static ALWAYS_INLINE RunTimeCppType<LT> value_at(const Column& data, size_t idx) {
+    if constexpr (LT == TYPE_VARCHAR) {
+        return static_cast<const BinaryColumn&>(data).get_slice(idx);
+    } else {
+        return reinterpret_cast<const RunTimeCppType<LT>*>(data.raw_data())[idx];
+    }
+}
+
+// Zone map of the |n| values of |data|; |nulls| is nullptr when none is NULL.
+// VARCHAR bounds point into |data|.
+static ZoneMapDetail page_zone_map(LogicalType type, const Column& data, const uint8_t* nulls, size_t n) {
+    ZoneMapDetail zone_map;
+    type_dispatch_all(type, [&](auto lt) {
+        constexpr LogicalType LT = decltype(lt)::value;
+        using CppType = RunTimeCppType<LT>;
+        CppType min{};
+        CppType max{};
+        bool has_value = false;
+        bool has_nan = false;
+        for (size_t i = 0; i < n; ++i) {
+            if (nulls != nullptr && nulls[i]) {
+                zone_map.has_null = true;
+                continue;
+            }
+            zone_map.has_not_null = true;
+            // Bitmaps are not ordered; they keep empty bounds.
+            if (type == TYPE_BITMAP) {
+                continue;
+            }
+            CppType v = value_at<LT>(data, i);
+            if constexpr (std::is_floating_point_v<CppType>) {
+                if (std::isnan(v)) {
+                    has_nan = true;
+                    continue;
+                }
+            }
+            if (!has_value) {
+                min = max = v;
+                has_value = true;
+            } else {
+                min = v < min ? v : min;
+                max = max < v ? v : max;
+            }
+        }
+        if constexpr (std::is_floating_point_v<CppType>) {
+            // NaN is unordered; widening the bounds keeps every predicate
+            // conservative on pages that hold one.
+            if (has_nan) {
+                min = -std::numeric_limits<CppType>::infinity();
+                max = std::numeric_limits<CppType>::infinity();
+            }
+        }
+        if (zone_map.has_not_null) {
+            zone_map.min.set(min);
+            zone_map.max.set(max);
+        }
+    });
+    return zone_map;
+}
+
+// Overwrites the NULL slots of a fixed-width column with the preceding value
+// (the first non-NULL one for leading NULLs), so that they neither widen the
+// bit-packing frame nor break runs.
+static void fill_null_slots(LogicalType type, Column* data, const uint8_t* nulls, size_t n) {
+    type_dispatch_all(type, [&](auto lt) {
+        constexpr LogicalType LT = decltype(lt)::value;
+        if constexpr (LT != TYPE_VARCHAR) {
+            using CppType = RunTimeCppType<LT>;
+            auto* values = reinterpret_cast<CppType*>(data->mutable_raw_data());
+            size_t first = 0;
+            while (first < n && nulls[first]) {
+                ++first;
+            }
+            CppType last = first < n ? values[first] : CppType{};
+            for (size_t i = 0; i < n; ++i) {
+                if (nulls[i]) {
+                    values[i] = last;
+                } else {
+                    last = values[i];
+                }
+            }
+        }
+    });
+}
+
+// Rows of |column| starting at |from| (at least one, at most |count|) that
+// take up |budget| bytes.
+static size_t rows_for_bytes(const Column& column, size_t from, size_t count, size_t budget) {
+    if (column.byte_size(from, count) <= budget) {
+        return count;
+    }
+    size_t lo = 1;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (column.byte_size(from, mid) >= budget) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Buffers the rows of one column until they fill a page, then encodes and
+// writes the page. VARCHAR columns share one dictionary across their pages
+// until it grows too large or turns out not to pay off.
+class SegmentWriter::ColumnWriter {
+public:
+    ColumnWriter(SegmentWriter* writer, const SlotDescriptor& slot)
+            : _writer(writer),
+              _slot(slot),
+              _page_column(ColumnHelper::create_column(slot.type, slot.nullable)),
+              _use_dict(slot.type == TYPE_VARCHAR) {}
+
+    size_t num_rows() const { return _num_rows; }
+    bool is_finished() const { return _finished; }
+
+    Status append(const Column& column, size_t from, size_t count) {
+        if (_finished) {
+            return Status::InternalError("append to finished segment column of slot " + std::to_string(_slot.id));
+        }
+        _num_rows += count;
+        const Column* src = &column;
+        if (!_slot.nullable && column.is_nullable()) {
+            const NullData& nulls = static_cast<const NullableColumn&>(column).null_column_data();
+            if (column.has_null() && ColumnHelper::count_nonzero(nulls.data() + from, count) > 0) {
+                return Status::InvalidArgument("NULL written to non-nullable segment column of slot " +
+                                               std::to_string(_slot.id));
+            }
+            src = ColumnHelper::get_data_column(&column);
+        }
+        auto page_size = static_cast<size_t>(std::max<int64_t>(_writer->_options.page_size_bytes, 1));
+        while (count > 0) {
+            size_t used = _page_column->byte_size();
+            size_t take = rows_for_bytes(*src, from, count, used < page_size ? page_size - used : 0);
+            _page_column->append(*src, from, take);
+            if (_page_column->byte_size() >= page_size) {
+                RETURN_IF_ERROR(_flush_page());
+            }
+            from += take;
+            count -= take;
+        }
+        return Status::OK();
+    }
+
+    // Flushes the last page and writes the dictionary.
+    Status finish() {
+        if (_finished) {
+            return Status::OK();
+        }
+        _finished = true;
+        RETURN_IF_ERROR(_flush_page());
+        if (_num_dict_pages > 0) {
+            BinaryColumn words;
+            for (const auto& word : _dict_words) {
+                words.append(Slice(word));
+            }
+            _page_buf.clear();
+            RETURN_IF_ERROR(encode_page_values(EncodingType::PLAIN, TYPE_VARCHAR, words, &_page_buf));
+            ASSIGN_OR_RETURN(_dict_page, _writer->_write_page(words.size(), EncodingType::PLAIN, 0, _page_buf));
+        }
+        _clear_dict();
+        _page_buf.shrink_to_empty();
+        _page_column.reset();
+        return Status::OK();
+    }
+
+    void encode_meta(Buffer<uint8_t>* footer) const {
+        put_fixed32(footer, static_cast<uint32_t>(_slot.id));
+        put_fixed8(footer, static_cast<uint8_t>(_slot.type));
+        put_fixed8(footer, _slot.nullable);
+        encode_zone_map(_slot.type, _zone_map, footer);
+        put_fixed8(footer, _num_dict_pages > 0);
+        if (_num_dict_pages > 0) {
+            encode_page_pointer(_dict_page, footer);
+        }
+        put_varint64(footer, _num_pages);
+        footer->append(_page_index.data(), _page_index.size());
+    }
+
+private:
+    Status _flush_page() {
+        size_t n = _page_column->size();
+        if (n == 0) {
+            return Status::OK();
+        }
+        Column* data = ColumnHelper::get_data_column(_page_column.get());
+        const uint8_t* nulls = nullptr;
+        if (_page_column->has_null()) {
+            nulls = static_cast<NullableColumn*>(_page_column.get())->null_column_data().data();
+            fill_null_slots(_slot.type, data, nulls, n);
+        }
+        ZoneMapDetail zone_map = page_zone_map(_slot.type, *data, nulls, n);
+
+        _page_buf.clear();
+        EncodingType encoding;
+        if (_use_dict && _dict_encode(static_cast<const BinaryColumn&>(*data))) {
+            encoding = EncodingType::DICT;
+            encode_dict_codes(_codes.data(), n, static_cast<uint32_t>(_dict_words.size()), &_page_buf);
+            ++_num_dict_pages;
+        } else {
+            encoding = choose_page_encoding(_slot.type, *data);
+            RETURN_IF_ERROR(encode_page_values(encoding, _slot.type, *data, &_page_buf));
+        }
+        size_t null_map_size = 0;
+        if (nulls != nullptr) {
+            size_t values_size = _page_buf.size();
+            encode_null_runs(nulls, n, &_page_buf);
+            null_map_size = _page_buf.size() - values_size;
+        }
+        ASSIGN_OR_RETURN(PagePointer pointer, _writer->_write_page(n, encoding, null_map_size, _page_buf));
+
+        encode_page_pointer(pointer, &_page_index);
+        put_varint64(&_page_index, n);
+        encode_zone_map(_slot.type, zone_map, &_page_index);
+        ++_num_pages;
+        _merge_zone_map(zone_map);
+        _page_column->reset_column();
+        return Status::OK();
+    }
+
+    // Maps the page's strings to dictionary codes in _codes. Returns false,
+    // leaving the dictionary as it was, if the page should be stored plain;
+    // dictionary encoding then stays off for the rest of the column.
+    bool _dict_encode(const BinaryColumn& data) {
+        size_t n = data.size();
+        size_t old_words = _dict_words.size();
+        size_t old_bytes = _dict_bytes;
+        _codes.resize_uninitialized(n);
+        for (size_t i = 0; i < n; ++i) {
+            Slice value = data.get_slice(i);
+            auto it = _dict_index.find(value);
+            if (it == _dict_index.end()) {
+                // Deque elements never move, so the key may point into them.
+                _dict_words.emplace_back(value.data, value.size);
+                it = _dict_index.emplace(Slice(_dict_words.back()), _dict_words.size() - 1).first;
+                _dict_bytes += value.size;
+            }
+            _codes[i] = it->second;
+        }
+        bool too_large = static_cast<int64_t>(_dict_bytes) > config::segment_dict_max_bytes;
+        bool too_distinct = _num_pages == 0 && _dict_words.size() > n * config::segment_dict_max_distinct_ratio;
+        if (!too_large && !too_distinct) {
+            return true;
+        }
+        _use_dict = false;
+        if (_num_dict_pages == 0) {
+            _clear_dict();
+            return false;
+        }
+        while (_dict_words.size() > old_words) {
+            _dict_index.erase(Slice(_dict_words.back()));
+            _dict_words.pop_back();
+        }
+        _dict_bytes = old_bytes;
+        return false;
+    }
+
+    void _clear_dict() {
+        _dict_index = {};
+        _dict_words = {};
+        _dict_bytes = 0;
+        _codes.shrink_to_empty();
+    }
+
+    void _merge_zone_map(const ZoneMapDetail& page) {
+        _zone_map.has_null |= page.has_null;
+        if (!page.has_not_null) {
+            return;
+        }
+        type_dispatch_all(_slot.type, [&](auto lt) {
+            using CppType = RunTimeCppType<decltype(lt)::value>;
+            bool first = !_zone_map.has_not_null;
+            const auto& page_min = page.min.get<CppType>();
+            const auto& page_max = page.max.get<CppType>();
+            if (first || page_min < _zone_map.min.get<CppType>()) {
+                _set_bound(&_zone_map.min, page_min, &_min_holder);
+            }
+            if (first || _zone_map.max.get<CppType>() < page_max) {
+                _set_bound(&_zone_map.max, page_max, &_max_holder);
+            }
+        });
+        _zone_map.has_not_null = true;
+    }
+
+    // VARCHAR bounds are copied into |holder|: the page they come from is reused.
+    template <typename CppType>
+    static void _set_bound(Datum* bound, const CppType& value, std::string* holder) {
+        if constexpr (std::is_same_v<CppType, Slice>) {
+            holder->assign(value.data, value.size);
+            bound->set(Slice(*holder));
+        } else {
+            bound->set(value);
+        }
+    }
+
+    SegmentWriter* const _writer;
+    const SlotDescriptor _slot;
+    size_t _num_rows = 0;
+    bool _finished = false;
+    ColumnPtr _page_column;
+    Buffer<uint8_t> _page_buf;
+    // Footer entries of the pages written so far.
+    Buffer<uint8_t> _page_index;
+    size_t _num_pages = 0;
+    ZoneMapDetail _zone_map;
+    std::string _min_holder;
+    std::string _max_holder;
+
+    bool _use_dict;
+    size_t _num_dict_pages = 0;
+    std::deque<std::string> _dict_words;
+    std::unordered_map<Slice, uint32_t, SliceHash> _dict_index;
+    size_t _dict_bytes = 0;
+    Buffer<uint32_t> _codes;
+    PagePointer _dict_page;
+};
+
+SegmentWriter::SegmentWriter(std::string path, RowDescriptor schema, SegmentWriterOptions options)
+        : _path(std::move(path)), _tmp_path(_path + ".tmp"), _schema(std::move(schema)), _options(options) {}
+
+SegmentWriter::~SegmentWriter() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        ::unlink(_tmp_path.c_str());
+    }
+}
+
+Status SegmentWriter::init() {
+    if (_options.compression != CompressionType::NO_COMPRESSION) {
+        ASSIGN_OR_RETURN(_codec, get_block_compression_codec(_options.compression));
+    }
+    _fd = ::open(_tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        return io_error("failed to create segment file " + _tmp_path);
+    }
+    for (const auto& slot : _schema) {
+        _column_writers.emplace_back(std::make_unique<ColumnWriter>(this, slot));
+    }
+    uint32_t magic = kSegmentMagic;
+    return _write(reinterpret_cast<const uint8_t*>(&magic), sizeof(magic));
+}
+
+Status SegmentWriter::append_chunk(const Chunk& chunk) {
+    if (_fd < 0) {
+        return Status::InternalError("segment writer is not open");
+    }
+    size_t num_rows = chunk.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    for (size_t i = 0; i < _schema.size(); ++i) {
+        const SlotDescriptor& slot = _schema[i];
+        if (!chunk.is_slot_exist(slot.id)) {
+            return Status::InvalidArgument("chunk has no column for slot " + std::to_string(slot.id));
+        }
+        ColumnPtr column = ColumnHelper::unfold_const_column(slot.type, num_rows, chunk.get_column_by_slot_id(slot.id));
+        RETURN_IF_ERROR(_column_writers[i]->append(*column, 0, num_rows));
+    }
+    _num_rows += num_rows;
+    return Status::OK();
+}
+
+Status SegmentWriter::append_columns(size_t first_column, const Columns& columns) {
+    if (_fd < 0) {
+        return Status::InternalError("segment writer is not open");
+    }
+    if (first_column + columns.size() > _schema.size()) {
+        return Status::InvalidArgument("segment has no column " + std::to_string(first_column + columns.size() - 1));
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        size_t num_rows = columns[i]->size();
+        ColumnPtr column = ColumnHelper::unfold_const_column(_schema[first_column + i].type, num_rows, columns[i]);
+        RETURN_IF_ERROR(_column_writers[first_column + i]->append(*column, 0, num_rows));
+    }
+    if (first_column == 0 && !columns.empty()) {
+        _num_rows += columns[0]->size();
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::finish_columns(size_t first_column, size_t num_columns) {
+    if (_fd < 0) {
+        return Status::InternalError("segment writer is not open");
+    }
+    for (size_t i = first_column; i < std::min(first_column + num_columns, _column_writers.size()); ++i) {
+        RETURN_IF_ERROR(_column_writers[i]->finish());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::finalize() {
+    if (_fd < 0) {
+        return Status::InternalError("segment writer is not open");
+    }
+    for (auto& writer : _column_writers) {
+        if (writer->num_rows() != static_cast<size_t>(_num_rows)) {
+            return Status::InvalidArgument("segment columns of different row counts");
+        }
+        RETURN_IF_ERROR(writer->finish());
+    }
+    Buffer<uint8_t> footer;
+    put_fixed32(&footer, kSegmentFormatVersion);
+    put_varint64(&footer, _num_rows);
+    put_varint64(&footer, _column_writers.size());
+    for (const auto& writer : _column_writers) {
+        writer->encode_meta(&footer);
+    }
+    uint32_t footer_size = static_cast<uint32_t>(footer.size());
+    uint32_t checksum = segment_checksum(footer.data(), footer.size());
+    put_fixed32(&footer, footer_size);
+    put_fixed32(&footer, checksum);
+    put_fixed32(&footer, kSegmentMagic);
+    RETURN_IF_ERROR(_write(footer.data(), footer.size()));
+    _column_writers.clear();
+
+    if (::fsync(_fd) != 0) {
+        return io_error("failed to sync segment file " + _tmp_path);
+    }
+    if (::rename(_tmp_path.c_str(), _path.c_str()) != 0) {
+        return io_error("failed to publish segment file " + _path);
+    }
+    ::close(_fd);
+    _fd = -1;
+    return Status::OK();
+}
+
+StatusOr<PagePointer> SegmentWriter::_write_page(size_t num_rows, EncodingType encoding, size_t null_map_size,
+                                                 const Buffer<uint8_t>& body) {
+    PageHeader header{};
+    header.num_rows = static_cast<uint32_t>(num_rows);
+    header.encoding = static_cast<uint8_t>(encoding);
+    header.null_map_size = static_cast<uint32_t>(null_map_size);
+    header.raw_size = static_cast<uint32_t>(body.size());
+    header.compression = static_cast<uint8_t>(CompressionType::NO_COMPRESSION);
+
+    const uint8_t* stored = body.data();
+    size_t stored_size = body.size();
+    if (_codec != nullptr) {
+        _compressed_buf.resize_uninitialized(_codec->max_compressed_len(body.size()));
+        size_t compressed_size = 0;
+        RETURN_IF_ERROR(_codec->compress(Slice(body.data(), body.size()), _compressed_buf.data(), &compressed_size));
+        // Keep incompressible pages raw.
+        if (compressed_size < body.size()) {
+            stored = _compressed_buf.data();
+            stored_size = compressed_size;
+            header.compression = static_cast<uint8_t>(_codec->type());
+        }
+    }
+    header.stored_size = static_cast<uint32_t>(stored_size);
+    header.checksum = page_checksum(header, stored);
+
+    PagePointer pointer;
+    pointer.offset = _file_size;
+    pointer.size = static_cast<uint32_t>(sizeof(header) + stored_size);
+    RETURN_IF_ERROR(_write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)));
+    RETURN_IF_ERROR(_write(stored, stored_size));
+    return pointer;
+}
+
+Status SegmentWriter::_write(const uint8_t* data, size_t len) {
+    _file_size += len;
+    while (len > 0) {
+        ssize_t n = ::write(_fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return io_error("failed to write segment file " + _tmp_path);
+        }
+        data += n;
+        len -= n;
+    }
+    return Status::OK();
+}
+
+} // namespace starrocks
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "column/chunk.h"
+#include "common/config.h"
+#include "common/status.h"
+#include "runtime/descriptors.h"
+#include "storage/segment/encoding.h"
+#include "storage/segment/segment_format.h"
+#include "util/block_compression.h"
+
+namespace starrocks {
+
+struct SegmentWriterOptions {
+    // Target uncompressed size of one column page.
+    int64_t page_size_bytes = config::segment_page_size_bytes;
+    CompressionType compression = static_cast<CompressionType>(config::segment_compression);
+};
+
+// Writes rows of |schema| into a new segment file (see segment_format.h).
+// Each column is cut into pages of about options.page_size_bytes; every page
+// is encoded with whichever encoding is smallest for its values, compressed
+// when that saves space, and summarized by a zone map in the footer.
+//
+// Rows are either appended whole with append_chunk(), or column by column:
+// vertical writing appends all the rows of a group of columns with
+// append_columns() and closes the group with finish_columns() before moving
+// on, so only one group's page buffers are alive at a time and the pages of
+// each column end up contiguous.
+//
+// The file is written under a temporary name and only appears at |path| once
+// finalize() succeeds.
+class SegmentWriter {
+public:
+    SegmentWriter(std::string path, RowDescriptor schema, SegmentWriterOptions options = {});
+    ~SegmentWriter();
+
+    Status init();
+
+    // |chunk| holds (at least) a column for every slot of the schema.
+    Status append_chunk(const Chunk& chunk);
+
+    // Appends |columns| to the schema's columns |first_column| on, in order.
+    Status append_columns(size_t first_column, const Columns& columns);
+    // Flushes the last pages of columns [first_column, first_column +
+    // num_columns), which take no more rows, and frees their buffers.
+    Status finish_columns(size_t first_column, size_t num_columns);
+
+    // Flushes the last pages, writes the footer and publishes the file. Every
+    // column must have as many rows.
+    Status finalize();
+
+    const std::string& path() const { return _path; }
+    // Rows appended so far; to column 0 when writing vertically.
+    int64_t num_rows() const { return _num_rows; }
+    // Bytes written so far; the size of the file after finalize().
+    int64_t file_size() const { return _file_size; }
+
+private:
+    class ColumnWriter;
+
+    // Compresses and writes a page whose uncompressed body is |body|; returns
+    // where it went.
+    StatusOr<PagePointer> _write_page(size_t num_rows, EncodingType encoding, size_t null_map_size,
+                                      const Buffer<uint8_t>& body);
+    Status _write(const uint8_t* data, size_t len);
+
+    const std::string _path;
+    const std::string _tmp_path;
+    const RowDescriptor _schema;
+    const SegmentWriterOptions _options;
+    const BlockCompressionCodec* _codec = nullptr;
+
+    int _fd = -1;
+    int64_t _num_rows = 0;
+    int64_t _file_size = 0;
+    std::vector<std::unique_ptr<ColumnWriter>> _column_writers;
+    Buffer<uint8_t> _compressed_buf;
+};
+
+} // namespace starrocks
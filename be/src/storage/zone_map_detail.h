@@ -0,0 +1,18 @@
+#pragma once
+
+#include "column/datum.h"
+
+namespace starrocks {
+
+// Min/max summary of the values in a range of rows (a storage page or a whole
+// segment). Bounds are only meaningful when has_not_null is set; they are
+// inclusive and cover every non-NULL value, so a predicate that no value in
+// [min, max] can satisfy rules out the whole range.
+struct ZoneMapDetail {
+    bool has_null = false;
+    bool has_not_null = false;
+    Datum min;
+    Datum max;
+};
+
+} // namespace starrocks
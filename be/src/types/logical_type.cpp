@@ -0,0 +1,54 @@
+#include "types/logical_type.h"
+
+namespace starrocks {
+
+size_t get_type_size(LogicalType type) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+        return 1;
+    case TYPE_SMALLINT:
+        return 2;
+    case TYPE_INT:
+    case TYPE_DATE:
+    case TYPE_FLOAT:
+        return 4;
+    case TYPE_BIGINT:
+    case TYPE_DATETIME:
+    case TYPE_DOUBLE:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+std::string logical_type_to_string(LogicalType type) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return "BOOLEAN";
+    case TYPE_TINYINT:
+        return "TINYINT";
+    case TYPE_SMALLINT:
+        return "SMALLINT";
+    case TYPE_INT:
+        return "INT";
+    case TYPE_BIGINT:
+        return "BIGINT";
+    case TYPE_FLOAT:
+        return "FLOAT";
+    case TYPE_DOUBLE:
+        return "DOUBLE";
+    case TYPE_DATE:
+        return "DATE";
+    case TYPE_DATETIME:
+        return "DATETIME";
+    case TYPE_VARCHAR:
+        return "VARCHAR";
+    case TYPE_BITMAP:
+        return "BITMAP";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+} // namespace starrocks
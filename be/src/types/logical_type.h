@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Logical (SQL-level) type of a column. Each type maps onto exactly one
+// in-memory column implementation through RunTimeTypeTraits.
+enum LogicalType : int {
+    TYPE_UNKNOWN = 0,
+    TYPE_BOOLEAN,
+    TYPE_TINYINT,
+    TYPE_SMALLINT,
+    TYPE_INT,
+    TYPE_BIGINT,
+    TYPE_FLOAT,
+    TYPE_DOUBLE,
+    TYPE_DATE,     // days since 1970-01-01, int32
+    TYPE_DATETIME, // microseconds since epoch, int64
+    TYPE_VARCHAR,
+    // A set of BIGINT values as a serialized RoaringBitmap; held like a
+    // VARCHAR, but neither compared nor cast other than to and from one.
+    TYPE_BITMAP,
+};
+
+template <typename T>
+class FixedLengthColumn;
+class BinaryColumn;
+
+template <LogicalType LT>
+struct RunTimeTypeTraits {};
+
+#define DEFINE_RUNTIME_TYPE_TRAITS(LT, CPP)         \
+    template <>                                     \
+    struct RunTimeTypeTraits<LT> {                  \
+        using CppType = CPP;                        \
+        using ColumnType = FixedLengthColumn<CPP>;  \
+    }
+
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_BOOLEAN, uint8_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_TINYINT, int8_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_SMALLINT, int16_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_INT, int32_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_BIGINT, int64_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_FLOAT, float);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_DOUBLE, double);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_DATE, int32_t);
+DEFINE_RUNTIME_TYPE_TRAITS(TYPE_DATETIME, int64_t);
+
+#undef DEFINE_RUNTIME_TYPE_TRAITS
+
+template <>
+struct RunTimeTypeTraits<TYPE_VARCHAR> {
+    using CppType = Slice;
+    using ColumnType = BinaryColumn;
+};
+
+template <>
+struct RunTimeTypeTraits<TYPE_BITMAP> {
+    using CppType = Slice;
+    using ColumnType = BinaryColumn;
+};
+
+template <LogicalType LT>
+using RunTimeCppType = typename RunTimeTypeTraits<LT>::CppType;
+template <LogicalType LT>
+using RunTimeColumnType = typename RunTimeTypeTraits<LT>::ColumnType;
+
+constexpr bool is_binary_type(LogicalType type) {
+    return type == TYPE_VARCHAR || type == TYPE_BITMAP;
+}
+
+constexpr bool is_integer_type(LogicalType type) {
+    return type == TYPE_TINYINT || type == TYPE_SMALLINT || type == TYPE_INT || type == TYPE_BIGINT;
+}
+
+constexpr bool is_float_type(LogicalType type) {
+    return type == TYPE_FLOAT || type == TYPE_DOUBLE;
+}
+
+// Width in bytes of a fixed-length type, 0 for variable-length types.
+size_t get_type_size(LogicalType type);
+
+std::string logical_type_to_string(LogicalType type);
+
+// Invokes |fn| with a std::integral_constant<LogicalType, LT> for the runtime
+// type |type|; used to turn a runtime type into a template instantiation.
+// BITMAP values are handled as the VARCHAR bytes they are stored as.
+template <typename Fn>
+auto type_dispatch_all(LogicalType type, Fn&& fn) {
+#define DISPATCH_CASE(LT) \
+    case LT:              \
+        return fn(std::integral_constant<LogicalType, LT>());
+    switch (type) {
+        DISPATCH_CASE(TYPE_BOOLEAN)
+        DISPATCH_CASE(TYPE_TINYINT)
+        DISPATCH_CASE(TYPE_SMALLINT)
+        DISPATCH_CASE(TYPE_INT)
+        DISPATCH_CASE(TYPE_BIGINT)
+        DISPATCH_CASE(TYPE_FLOAT)
+        DISPATCH_CASE(TYPE_DOUBLE)
+        DISPATCH_CASE(TYPE_DATE)
+        DISPATCH_CASE(TYPE_DATETIME)
+    default:
+        return fn(std::integral_constant<LogicalType, TYPE_VARCHAR>());
+    }
+#undef DISPATCH_CASE
+}
+
+} // namespace starrocks
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "column/buffer.h"
+
+namespace starrocks {
+
+// Fixed-width bit packing of unsigned integers into a little-endian bit
+// stream: value i occupies bits [i * bits, (i + 1) * bits). Packed data is
+// followed by kBitPackPadding zero bytes so the decoder can always load a
+// whole 64-bit word.
+
+constexpr size_t kBitPackPadding = 8;
+
+// Bits needed to represent |max_value|; 0 for 0.
+inline int bits_required(uint64_t max_value) {
+    return max_value == 0 ? 0 : 64 - __builtin_clzll(max_value);
+}
+
+// Bytes produced by bit_pack(), including the padding.
+inline size_t bit_packed_size(size_t n, int bits) {
+    return (n * bits + 7) / 8 + kBitPackPadding;
+}
+
+// Appends |n| values, each of which must fit in |bits| bits.
+inline void bit_pack(const uint64_t* values, size_t n, int bits, Buffer<uint8_t>* dst) {
+    size_t start = dst->size();
+    dst->resize(start + bit_packed_size(n, bits));
+    if (bits == 0) {
+        return;
+    }
+    uint8_t* out = dst->data() + start;
+    uint64_t acc = 0;
+    int acc_bits = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc |= values[i] << acc_bits;
+        if (acc_bits + bits >= 64) {
+            memcpy(out, &acc, sizeof(acc));
+            out += sizeof(acc);
+            // Bits of values[i] that did not fit; a full shift by 64 is UB.
+            int used = 64 - acc_bits;
+            acc = used == 64 ? 0 : values[i] >> used;
+            acc_bits = acc_bits + bits - 64;
+        } else {
+            acc_bits += bits;
+        }
+    }
+    if (acc_bits > 0) {
+        memcpy(out, &acc, (acc_bits + 7) / 8);
+    }
+}
+
+// Decodes the |n| values starting at index |start| of a bit_pack()ed stream.
+template <typename T>
+inline void bit_unpack(const uint8_t* packed, int bits, size_t start, size_t n, T* out) {
+    if (bits == 0) {
+        memset(static_cast<void*>(out), 0, n * sizeof(T));
+        return;
+    }
+    const uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    size_t bit_pos = start * bits;
+    for (size_t i = 0; i < n; ++i, bit_pos += bits) {
+        const uint8_t* p = packed + bit_pos / 8;
+        int shift = bit_pos % 8;
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        uint64_t v = word >> shift;
+        if (shift + bits > 64) {
+            v |= static_cast<uint64_t>(p[8]) << (64 - shift);
+        }
+        out[i] = static_cast<T>(v & mask);
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,229 @@
+#include "util/block_compression.h"
+
+#include <cstring>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+const char* compression_type_name(CompressionType type) {
+    switch (type) {
+    case CompressionType::NO_COMPRESSION:
+        return "NONE";
+    case CompressionType::LZ4:
+        return "LZ4";
+    }
+    return "UNKNOWN";
+}
+
+namespace {
+
+class NoCompressionCodec final : public BlockCompressionCodec {
+public:
+    CompressionType type() const override { return CompressionType::NO_COMPRESSION; }
+    size_t max_compressed_len(size_t len) const override { return len; }
+
+    Status compress(const Slice& input, uint8_t* output, size_t* output_len) const override {
+        memcpy(output, input.data, input.size);
+        *output_len = input.size;
+        return Status::OK();
+    }
+
+    Status decompress(const Slice& input, uint8_t* output, size_t output_len) const override {
+        if (input.size != output_len) {
+            return Status::Corruption("uncompressed block size mismatch");
+        }
+        memcpy(output, input.data, input.size);
+        return Status::OK();
+    }
+};
+
+// LZ4 block format: a sequence of (token, literals, match) where the token
+// holds the literal length and match length - 4 in its two nibbles, 15 in a
+// nibble means "more length bytes follow", and a match is a 16-bit little
+// endian back-reference offset. The last 5 bytes are always literals and no
+// match starts in the last 12 bytes.
+class Lz4Codec final : public BlockCompressionCodec {
+public:
+    CompressionType type() const override { return CompressionType::LZ4; }
+    size_t max_compressed_len(size_t len) const override { return len + len / 255 + 16; }
+
+    Status compress(const Slice& input, uint8_t* output, size_t* output_len) const override {
+        *output_len = _compress(reinterpret_cast<const uint8_t*>(input.data), input.size, output);
+        return Status::OK();
+    }
+
+    Status decompress(const Slice& input, uint8_t* output, size_t output_len) const override;
+
+private:
+    static constexpr int kHashLog = 12;
+    static constexpr size_t kMinMatch = 4;
+    static constexpr size_t kLastLiterals = 5;
+    static constexpr size_t kMatchFindLimit = 12;
+    static constexpr size_t kMaxOffset = 65535;
+
+    static ALWAYS_INLINE uint32_t _read32(const uint8_t* p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    static ALWAYS_INLINE uint32_t _hash(uint32_t seq) { return (seq * 2654435761U) >> (32 - kHashLog); }
+
+    static uint8_t* _write_length(uint8_t* op, size_t len) {
+        while (len >= 255) {
+            *op++ = 255;
+            len -= 255;
+        }
+        *op++ = static_cast<uint8_t>(len);
+        return op;
+    }
+
+    static uint8_t* _write_sequence(uint8_t* op, const uint8_t* literals, size_t literal_len, size_t offset,
+                                    size_t match_len) {
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>((literal_len >= 15 ? 15 : literal_len) << 4);
+        if (literal_len >= 15) {
+            op = _write_length(op, literal_len - 15);
+        }
+        memcpy(op, literals, literal_len);
+        op += literal_len;
+        if (match_len == 0) {
+            return op;
+        }
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        size_t ml = match_len - kMinMatch;
+        *token |= static_cast<uint8_t>(ml >= 15 ? 15 : ml);
+        if (ml >= 15) {
+            op = _write_length(op, ml - 15);
+        }
+        return op;
+    }
+
+    static size_t _compress(const uint8_t* src, size_t len, uint8_t* dst);
+};
+
+size_t Lz4Codec::_compress(const uint8_t* src, size_t len, uint8_t* dst) {
+    uint8_t* op = dst;
+    size_t anchor = 0;
+    if (len >= kMatchFindLimit + 1) {
+        // Positions are stored + 1 so that 0 means empty.
+        uint32_t table[1 << kHashLog] = {};
+        const size_t match_limit = len - kMatchFindLimit;
+        const size_t match_end = len - kLastLiterals;
+        size_t ip = 0;
+        size_t misses = 0;
+        while (ip < match_limit) {
+            uint32_t seq = _read32(src + ip);
+            uint32_t h = _hash(seq);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+            if (ref == 0 || ip + 1 - ref > kMaxOffset || _read32(src + ref - 1) != seq) {
+                // Skip faster through incompressible data.
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            ref -= 1;
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                ip--;
+                ref--;
+            }
+            size_t match_len = kMinMatch;
+            while (ip + match_len < match_end && src[ip + match_len] == src[ref + match_len]) {
+                match_len++;
+            }
+            op = _write_sequence(op, src + anchor, ip - anchor, ip - ref, match_len);
+            ip += match_len;
+            anchor = ip;
+            if (ip - 2 < match_limit) {
+                table[_hash(_read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+            }
+        }
+    }
+    op = _write_sequence(op, src + anchor, len - anchor, 0, 0);
+    return op - dst;
+}
+
+Status Lz4Codec::decompress(const Slice& input, uint8_t* output, size_t output_len) const {
+    const auto* ip = reinterpret_cast<const uint8_t*>(input.data);
+    const uint8_t* const in_end = ip + input.size;
+    uint8_t* op = output;
+    uint8_t* const out_begin = output;
+    uint8_t* const out_end = output + output_len;
+
+    auto read_length = [&](size_t* len) -> bool {
+        uint8_t b;
+        do {
+            if (UNLIKELY(ip >= in_end)) {
+                return false;
+            }
+            b = *ip++;
+            *len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < in_end) {
+        uint8_t token = *ip++;
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(&literal_len)) {
+            return Status::Corruption("lz4: truncated literal length");
+        }
+        if (UNLIKELY(literal_len > static_cast<size_t>(in_end - ip) ||
+                     literal_len > static_cast<size_t>(out_end - op))) {
+            return Status::Corruption("lz4: literal run out of bounds");
+        }
+        memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+        if (ip == in_end) {
+            break;
+        }
+        if (UNLIKELY(in_end - ip < 2)) {
+            return Status::Corruption("lz4: truncated match offset");
+        }
+        size_t offset = ip[0] | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (UNLIKELY(offset == 0 || offset > static_cast<size_t>(op - out_begin))) {
+            return Status::Corruption("lz4: invalid match offset");
+        }
+        size_t match_len = token & 15;
+        if (match_len == 15 && !read_length(&match_len)) {
+            return Status::Corruption("lz4: truncated match length");
+        }
+        match_len += kMinMatch;
+        if (UNLIKELY(match_len > static_cast<size_t>(out_end - op))) {
+            return Status::Corruption("lz4: match out of bounds");
+        }
+        const uint8_t* match = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            for (size_t i = 0; i < match_len; ++i) {
+                *op++ = match[i];
+            }
+        }
+    }
+    if (op != out_end) {
+        return Status::Corruption("lz4: decompressed size mismatch");
+    }
+    return Status::OK();
+}
+
+} // namespace
+
+StatusOr<const BlockCompressionCodec*> get_block_compression_codec(CompressionType type) {
+    static const NoCompressionCodec s_none;
+    static const Lz4Codec s_lz4;
+    switch (type) {
+    case CompressionType::NO_COMPRESSION:
+        return &s_none;
+    case CompressionType::LZ4:
+        return &s_lz4;
+    }
+    return Status::NotSupported("unknown compression type " + std::to_string(static_cast<int>(type)));
+}
+
+} // namespace starrocks
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/status.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+enum class CompressionType : uint8_t {
+    NO_COMPRESSION = 0,
+    // LZ4 block format (no frame), interoperable with liblz4's
+    // LZ4_compress_default / LZ4_decompress_safe.
+    LZ4 = 1,
+};
+
+const char* compression_type_name(CompressionType type);
+
+// Compresses independent blocks whose uncompressed size the caller records
+// (spill blocks, storage pages, exchange payloads). Codecs are stateless and
+// thread-safe.
+class BlockCompressionCodec {
+public:
+    virtual ~BlockCompressionCodec() = default;
+
+    virtual CompressionType type() const = 0;
+
+    // Upper bound of the compressed size of |len| input bytes.
+    virtual size_t max_compressed_len(size_t len) const = 0;
+
+    // |output| must have room for max_compressed_len(input.size) bytes.
+    virtual Status compress(const Slice& input, uint8_t* output, size_t* output_len) const = 0;
+
+    // |output_len| must be exactly the uncompressed size; anything else, or
+    // malformed input, is reported as Corruption.
+    virtual Status decompress(const Slice& input, uint8_t* output, size_t output_len) const = 0;
+};
+
+StatusOr<const BlockCompressionCodec*> get_block_compression_codec(CompressionType type);
+
+} // namespace starrocks
@@ -0,0 +1,53 @@
+#include "util/bloom_filter.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace starrocks {
+
+void BlockBloomFilter::init(size_t num_values, int bits_per_value, size_t max_bytes) {
+    size_t bits = std::max<size_t>(num_values, 1) * std::max(bits_per_value, 1);
+    size_t max_blocks = std::max<size_t>(max_bytes / kBlockBytes, 1);
+    size_t num_blocks = 1;
+    while (num_blocks * kBlockBytes * 8 < bits && num_blocks * 2 <= max_blocks) {
+        num_blocks <<= 1;
+    }
+    _num_blocks = num_blocks;
+    _words.assign(num_blocks * 8, 0);
+}
+
+Status BlockBloomFilter::init_from(Slice data) {
+    size_t num_blocks = data.size / kBlockBytes;
+    if (num_blocks == 0 || data.size % kBlockBytes != 0 || (num_blocks & (num_blocks - 1)) != 0) {
+        return Status::Corruption("bloom filter of " + std::to_string(data.size) + " bytes");
+    }
+    _num_blocks = num_blocks;
+    _words.resize_uninitialized(num_blocks * 8);
+    memcpy(_words.data(), data.data, data.size);
+    return Status::OK();
+}
+
+void BlockBloomFilter::merge(const BlockBloomFilter& other) {
+    if (other._num_blocks < _num_blocks) {
+        _fold(other._num_blocks);
+    }
+    // Block i of |other| lands in block i mod _num_blocks.
+    uint32_t* dst = _words.data();
+    const uint32_t* src = other._words.data();
+    size_t num_words = _num_blocks * 8;
+    for (size_t i = 0; i < other._num_blocks * 8; ++i) {
+        dst[i & (num_words - 1)] |= src[i];
+    }
+}
+
+void BlockBloomFilter::_fold(size_t num_blocks) {
+    size_t num_words = num_blocks * 8;
+    uint32_t* words = _words.data();
+    for (size_t i = num_words; i < _num_blocks * 8; ++i) {
+        words[i & (num_words - 1)] |= words[i];
+    }
+    _words.resize(num_words);
+    _num_blocks = num_blocks;
+}
+
+} // namespace starrocks
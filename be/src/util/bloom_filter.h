@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+#include "column/buffer.h"
+#include "common/compiler_util.h"
+#include "common/status.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Split-block bloom filter over 64-bit hashes. The filter is an array of
+// 256-bit blocks; a hash picks one block with its low bits and sets one bit in
+// each of the block's eight 32-bit words with its high bits, so an insert or
+// a lookup touches a single cache line and no false negative is possible.
+//
+// The number of blocks is a power of two. Because the block is chosen by the
+// low bits alone, a filter can be folded onto a smaller one by OR-ing block i
+// into block i mod n, which is how filters of different sizes are merged.
+class BlockBloomFilter {
+public:
+    static constexpr size_t kBlockBytes = 32;
+
+    BlockBloomFilter() = default;
+
+    // Sized for |num_values| values at |bits_per_value| bits each, capped at
+    // |max_bytes|; at least one block.
+    void init(size_t num_values, int bits_per_value, size_t max_bytes);
+    // Takes the blocks written by data(); |data| must hold a power-of-two
+    // number of blocks.
+    Status init_from(Slice data);
+
+    bool empty() const { return _num_blocks == 0; }
+    size_t num_blocks() const { return _num_blocks; }
+    size_t size_bytes() const { return _num_blocks * kBlockBytes; }
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(_words.data()); }
+
+    ALWAYS_INLINE void insert_hash(uint64_t hash) {
+        uint32_t* block = _block(hash);
+        auto key = static_cast<uint32_t>(hash >> 32);
+        for (int i = 0; i < 8; ++i) {
+            block[i] |= 1U << ((key * kSalt[i]) >> 27);
+        }
+    }
+
+    ALWAYS_INLINE bool test_hash(uint64_t hash) const {
+        const uint32_t* block = _block(hash);
+        auto key = static_cast<uint32_t>(hash >> 32);
+        uint32_t hit = 1;
+        for (int i = 0; i < 8; ++i) {
+            hit &= block[i] >> ((key * kSalt[i]) >> 27);
+        }
+        return hit != 0;
+    }
+
+    // Makes this filter pass everything |other| passes. The result has the
+    // smaller of the two sizes.
+    void merge(const BlockBloomFilter& other);
+
+private:
+    static constexpr uint32_t kSalt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                          0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    ALWAYS_INLINE uint32_t* _block(uint64_t hash) { return _words.data() + (hash & (_num_blocks - 1)) * 8; }
+    ALWAYS_INLINE const uint32_t* _block(uint64_t hash) const {
+        return _words.data() + (hash & (_num_blocks - 1)) * 8;
+    }
+
+    // Folds the blocks onto the first |num_blocks| of them.
+    void _fold(size_t num_blocks);
+
+    Buffer<uint32_t> _words;
+    size_t _num_blocks = 0;
+};
+
+} // namespace starrocks
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "column/buffer.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Little-endian fixed-width and LEB128 varint encoding of integers, for the
+// on-disk formats (storage segments). Encoders append to a Buffer; decoders
+// consume from the front of a Slice and return false when it is too short.
+
+inline void put_fixed8(Buffer<uint8_t>* dst, uint8_t v) {
+    dst->push_back(v);
+}
+
+inline void put_fixed16(Buffer<uint8_t>* dst, uint16_t v) {
+    dst->append(reinterpret_cast<const uint8_t*>(&v), sizeof(v));
+}
+
+inline void put_fixed32(Buffer<uint8_t>* dst, uint32_t v) {
+    dst->append(reinterpret_cast<const uint8_t*>(&v), sizeof(v));
+}
+
+inline void put_fixed64(Buffer<uint8_t>* dst, uint64_t v) {
+    dst->append(reinterpret_cast<const uint8_t*>(&v), sizeof(v));
+}
+
+inline void put_varint64(Buffer<uint8_t>* dst, uint64_t v) {
+    uint8_t buf[10];
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = static_cast<uint8_t>(v);
+    dst->append(buf, n);
+}
+
+inline void put_length_prefixed_slice(Buffer<uint8_t>* dst, const Slice& value) {
+    put_varint64(dst, value.size);
+    dst->append(reinterpret_cast<const uint8_t*>(value.data), value.size);
+}
+
+inline bool get_fixed8(Slice* input, uint8_t* v) {
+    if (input->size < 1) {
+        return false;
+    }
+    *v = static_cast<uint8_t>(input->data[0]);
+    input->remove_prefix(1);
+    return true;
+}
+
+inline bool get_fixed16(Slice* input, uint16_t* v) {
+    if (input->size < sizeof(*v)) {
+        return false;
+    }
+    memcpy(v, input->data, sizeof(*v));
+    input->remove_prefix(sizeof(*v));
+    return true;
+}
+
+inline bool get_fixed32(Slice* input, uint32_t* v) {
+    if (input->size < sizeof(*v)) {
+        return false;
+    }
+    memcpy(v, input->data, sizeof(*v));
+    input->remove_prefix(sizeof(*v));
+    return true;
+}
+
+inline bool get_fixed64(Slice* input, uint64_t* v) {
+    if (input->size < sizeof(*v)) {
+        return false;
+    }
+    memcpy(v, input->data, sizeof(*v));
+    input->remove_prefix(sizeof(*v));
+    return true;
+}
+
+inline bool get_varint64(Slice* input, uint64_t* v) {
+    uint64_t result = 0;
+    for (size_t i = 0, shift = 0; i < input->size && shift <= 63; ++i, shift += 7) {
+        auto byte = static_cast<uint8_t>(input->data[i]);
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *v = result;
+            input->remove_prefix(i + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool get_varint32(Slice* input, uint32_t* v) {
+    uint64_t v64;
+    if (!get_varint64(input, &v64) || v64 > UINT32_MAX) {
+        return false;
+    }
+    *v = static_cast<uint32_t>(v64);
+    return true;
+}
+
+// The returned slice points into |input|'s bytes.
+inline bool get_length_prefixed_slice(Slice* input, Slice* value) {
+    uint64_t len;
+    if (!get_varint64(input, &len) || input->size < len) {
+        return false;
+    }
+    *value = Slice(input->data, len);
+    input->remove_prefix(len);
+    return true;
+}
+
+} // namespace starrocks
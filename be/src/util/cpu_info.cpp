@@ -0,0 +1,68 @@
+#include "util/cpu_info.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+namespace starrocks {
+
+static uint32_t probe_features() {
+    uint32_t res = 0;
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) res |= CpuInfo::SSE4_2;
+    if (__builtin_cpu_supports("avx2")) res |= CpuInfo::AVX2;
+    if (__builtin_cpu_supports("bmi2")) res |= CpuInfo::BMI2;
+    if (__builtin_cpu_supports("avx512f")) res |= CpuInfo::AVX512F;
+    if (__builtin_cpu_supports("avx512bw")) res |= CpuInfo::AVX512BW;
+    if (__builtin_cpu_supports("avx512vl")) res |= CpuInfo::AVX512VL;
+#endif
+    return res;
+}
+
+static std::atomic<uint32_t>& feature_bits() {
+    static std::atomic<uint32_t> bits{probe_features()};
+    return bits;
+}
+
+uint32_t CpuInfo::features() {
+    return feature_bits().load(std::memory_order_relaxed);
+}
+
+void CpuInfo::disable_feature(Feature feature) {
+    feature_bits().fetch_and(~static_cast<uint32_t>(feature), std::memory_order_relaxed);
+}
+
+int CpuInfo::num_cores() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+int64_t CpuInfo::l2_cache_size() {
+    static const int64_t size = [] {
+        long v = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+        v = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+        return v > 0 ? static_cast<int64_t>(v) : int64_t(256 * 1024);
+    }();
+    return size;
+}
+
+std::string CpuInfo::debug_string() {
+    static const struct {
+        Feature feature;
+        const char* name;
+    } kNames[] = {{SSE4_2, "sse4.2"},   {AVX2, "avx2"},         {BMI2, "bmi2"},
+                  {AVX512F, "avx512f"}, {AVX512BW, "avx512bw"}, {AVX512VL, "avx512vl"}};
+    std::string res = "cores=" + std::to_string(num_cores()) + " l2=" + std::to_string(l2_cache_size()) + " features=";
+    for (const auto& f : kNames) {
+        if (is_supported(f.feature)) {
+            res.append(f.name).append(" ");
+        }
+    }
+    return res;
+}
+
+} // namespace starrocks
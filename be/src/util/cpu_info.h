@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace starrocks {
+
+// CPU feature detection. Features are probed once on first use; kernels that
+// have vectorized variants consult this to choose an implementation at runtime
+// so a single binary runs on every x86-64 host.
+class CpuInfo {
+public:
+    enum Feature : uint32_t {
+        SSE4_2 = 1u << 0,
+        AVX2 = 1u << 1,
+        BMI2 = 1u << 2,
+        AVX512F = 1u << 3,
+        AVX512BW = 1u << 4,
+        AVX512VL = 1u << 5,
+    };
+
+    static bool is_supported(Feature feature) { return (features() & feature) != 0; }
+
+    static uint32_t features();
+
+    // Disables a feature as if the CPU did not have it. Must be called before
+    // any kernel has been dispatched; used to benchmark fallbacks.
+    static void disable_feature(Feature feature);
+
+    static int num_cores();
+
+    // Per-core L2 data cache size in bytes (256KB when it cannot be probed).
+    static int64_t l2_cache_size();
+
+    static std::string debug_string();
+};
+
+} // namespace starrocks
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Conversions between the in-memory DATE (days since 1970-01-01) and DATETIME
+// (microseconds since the epoch) values and calendar fields, in the proleptic
+// Gregorian calendar, without time zones.
+
+constexpr int64_t kMicrosPerSecond = 1000000;
+constexpr int64_t kMicrosPerDay = 86400 * kMicrosPerSecond;
+
+struct CivilDate {
+    int32_t year;
+    int32_t month;
+    int32_t day;
+};
+
+inline int32_t days_from_civil(int32_t year, int32_t month, int32_t day) {
+    year -= month <= 2;
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const int32_t yoe = year - era * 400;
+    const int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline CivilDate civil_from_days(int32_t days) {
+    const int64_t z = static_cast<int64_t>(days) + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const auto day = static_cast<int32_t>(doy - (153 * mp + 2) / 5 + 1);
+    const auto month = static_cast<int32_t>(mp < 10 ? mp + 3 : mp - 9);
+    return {static_cast<int32_t>(yoe + era * 400 + (month <= 2)), month, day};
+}
+
+inline bool is_leap_year(int32_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline int32_t days_in_month(int32_t year, int32_t month) {
+    static constexpr int32_t kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && is_leap_year(year) ? 29 : kDays[month - 1];
+}
+
+// Day of a DATETIME, rounding towards the past.
+inline int32_t datetime_to_date(int64_t datetime) {
+    int64_t days = datetime / kMicrosPerDay;
+    if (datetime % kMicrosPerDay < 0) {
+        --days;
+    }
+    return static_cast<int32_t>(days);
+}
+
+inline int64_t date_to_datetime(int32_t date) {
+    return date * kMicrosPerDay;
+}
+
+// Microseconds since the start of the day.
+inline int64_t datetime_time_of_day(int64_t datetime) {
+    return datetime - date_to_datetime(datetime_to_date(datetime));
+}
+
+namespace date_util_internal {
+
+inline bool parse_digits(const char** p, const char* end, int min_digits, int max_digits, int64_t* value) {
+    int64_t v = 0;
+    int n = 0;
+    while (*p < end && n < max_digits && **p >= '0' && **p <= '9') {
+        v = v * 10 + (**p - '0');
+        ++*p;
+        ++n;
+    }
+    *value = v;
+    return n >= min_digits;
+}
+
+inline bool consume(const char** p, const char* end, char c) {
+    if (*p < end && **p == c) {
+        ++*p;
+        return true;
+    }
+    return false;
+}
+
+} // namespace date_util_internal
+
+// Parses 'YYYY-MM-DD', optionally followed by ' HH:MM:SS' (or 'T' instead of
+// the space) and up to six digits of fraction, into a DATETIME. Surrounding
+// blanks are allowed; anything else, or an impossible date, fails.
+inline bool parse_datetime(Slice str, int64_t* datetime) {
+    using namespace date_util_internal;
+    const char* p = str.data;
+    const char* end = str.data + str.size;
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+    while (end > p && end[-1] == ' ') {
+        --end;
+    }
+    int64_t year;
+    int64_t month;
+    int64_t day;
+    if (!parse_digits(&p, end, 4, 4, &year) || !consume(&p, end, '-') || !parse_digits(&p, end, 1, 2, &month) ||
+        !consume(&p, end, '-') || !parse_digits(&p, end, 1, 2, &day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)) {
+        return false;
+    }
+    int64_t micros = 0;
+    if (p < end) {
+        if (*p != ' ' && *p != 'T') {
+            return false;
+        }
+        ++p;
+        int64_t hour;
+        int64_t minute;
+        int64_t second;
+        if (!parse_digits(&p, end, 1, 2, &hour) || !consume(&p, end, ':') || !parse_digits(&p, end, 1, 2, &minute) ||
+            !consume(&p, end, ':') || !parse_digits(&p, end, 1, 2, &second)) {
+            return false;
+        }
+        if (hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+        int64_t fraction = 0;
+        if (consume(&p, end, '.')) {
+            const char* start = p;
+            if (!parse_digits(&p, end, 1, 6, &fraction)) {
+                return false;
+            }
+            for (auto digits = p - start; digits < 6; ++digits) {
+                fraction *= 10;
+            }
+        }
+        if (p != end) {
+            return false;
+        }
+        micros = ((hour * 60 + minute) * 60 + second) * kMicrosPerSecond + fraction;
+    }
+    *datetime = date_to_datetime(days_from_civil(static_cast<int32_t>(year), static_cast<int32_t>(month),
+                                                 static_cast<int32_t>(day))) +
+                micros;
+    return true;
+}
+
+inline std::string format_date(int32_t date) {
+    CivilDate civil = civil_from_days(date);
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%04d-%02d-%02d", civil.year, civil.month, civil.day);
+    return std::string(buf, n);
+}
+
+// 'YYYY-MM-DD HH:MM:SS', with the microseconds when there are any.
+inline std::string format_datetime(int64_t datetime) {
+    int64_t micros = datetime_time_of_day(datetime);
+    int64_t seconds = micros / kMicrosPerSecond;
+    char buf[64];
+    int n = snprintf(buf, sizeof(buf), " %02d:%02d:%02d", static_cast<int>(seconds / 3600),
+                     static_cast<int>(seconds / 60 % 60), static_cast<int>(seconds % 60));
+    if (micros % kMicrosPerSecond != 0) {
+        n += snprintf(buf + n, sizeof(buf) - n, ".%06d", static_cast<int>(micros % kMicrosPerSecond));
+    }
+    return format_date(datetime_to_date(datetime)) + std::string(buf, n);
+}
+
+} // namespace starrocks
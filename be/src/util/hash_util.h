@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+// Non-cryptographic hashes used by hash tables and partitioning. Every bit of
+// the result is well mixed, so callers may take the partition from the high
+// bits and the bucket from the low bits of the same hash.
+class HashUtil {
+public:
+    static constexpr uint64_t kDefaultSeed = 0x9E3779B97F4A7C15ULL;
+
+    // Finalizer of MurmurHash3; a bijection on 64-bit values.
+    static ALWAYS_INLINE uint64_t fmix64(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDULL;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    static ALWAYS_INLINE uint64_t hash64(uint64_t value, uint64_t seed = kDefaultSeed) { return fmix64(value ^ seed); }
+
+    // Folds |value| into a running hash of several columns.
+    static ALWAYS_INLINE uint64_t combine(uint64_t hash, uint64_t value) {
+        return fmix64(hash ^ (value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2)));
+    }
+
+    // MurmurHash64A.
+    static uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = kDefaultSeed) {
+        constexpr uint64_t m = 0xC6A4A7935BD1E995ULL;
+        constexpr int r = 47;
+        uint64_t h = seed ^ (len * m);
+        const auto* p = static_cast<const uint8_t*>(data);
+        const uint8_t* end = p + (len & ~size_t(7));
+        for (; p != end; p += 8) {
+            uint64_t k;
+            memcpy(&k, p, 8);
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+        switch (len & 7) {
+        case 7:
+            h ^= uint64_t(p[6]) << 48;
+            [[fallthrough]];
+        case 6:
+            h ^= uint64_t(p[5]) << 40;
+            [[fallthrough]];
+        case 5:
+            h ^= uint64_t(p[4]) << 32;
+            [[fallthrough]];
+        case 4:
+            h ^= uint64_t(p[3]) << 24;
+            [[fallthrough]];
+        case 3:
+            h ^= uint64_t(p[2]) << 16;
+            [[fallthrough]];
+        case 2:
+            h ^= uint64_t(p[1]) << 8;
+            [[fallthrough]];
+        case 1:
+            h ^= uint64_t(p[0]);
+            h *= m;
+        }
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return h;
+    }
+};
+
+} // namespace starrocks
@@ -0,0 +1,150 @@
+#include "util/hyperloglog.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/bit_packing.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+HyperLogLog::HyperLogLog(int precision)
+        : _precision(std::clamp(precision, kMinPrecision, kMaxPrecision)), _registers(size_t(1) << _precision, 0) {}
+
+void HyperLogLog::_fold(int precision) {
+    int shift = _precision - precision;
+    std::vector<uint8_t> registers(size_t(1) << precision, 0);
+    for (size_t i = 0; i < _registers.size(); ++i) {
+        if (_registers[i] == 0) {
+            continue;
+        }
+        // The low |shift| bits of the index become the leading bits of the
+        // rest of the hash.
+        uint64_t dropped = i & ((uint64_t(1) << shift) - 1);
+        uint8_t rank = dropped != 0 ? static_cast<uint8_t>(__builtin_clzll(dropped) - (64 - shift) + 1)
+                                    : static_cast<uint8_t>(_registers[i] + shift);
+        uint8_t& target = registers[i >> shift];
+        target = std::max(target, rank);
+    }
+    _precision = precision;
+    _registers = std::move(registers);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other._precision < _precision) {
+        _fold(other._precision);
+    }
+    if (other._precision == _precision) {
+        for (size_t i = 0; i < _registers.size(); ++i) {
+            _registers[i] = std::max(_registers[i], other._registers[i]);
+        }
+        return;
+    }
+    HyperLogLog folded = other;
+    folded._fold(_precision);
+    merge(folded);
+}
+
+int64_t HyperLogLog::estimate(const uint8_t* registers, int precision) {
+    size_t num_registers = size_t(1) << precision;
+    auto m = static_cast<double>(num_registers);
+    double sum = 0;
+    size_t num_zeros = 0;
+    for (size_t i = 0; i < num_registers; ++i) {
+        sum += std::ldexp(1.0, -registers[i]);
+        num_zeros += registers[i] == 0;
+    }
+    double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && num_zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(num_zeros));
+    }
+    return std::llround(estimate);
+}
+
+enum HllFormat : uint8_t {
+    kHllSparse = 0,
+    kHllDense = 1,
+};
+
+void HyperLogLog::serialize(Buffer<uint8_t>* dst) const {
+    std::vector<uint32_t> entries;
+    for (size_t i = 0; i < _registers.size() && entries.size() * 4 < _registers.size(); ++i) {
+        if (_registers[i] != 0) {
+            entries.push_back(static_cast<uint32_t>(i << 8 | _registers[i]));
+        }
+    }
+    if (entries.size() * 4 < _registers.size()) {
+        serialize_sparse(entries.data(), entries.size(), _precision, dst);
+    } else {
+        serialize_dense(_registers.data(), _precision, dst);
+    }
+}
+
+void HyperLogLog::serialize_sparse(const uint32_t* entries, size_t num_entries, int precision,
+                                   Buffer<uint8_t>* dst) {
+    put_fixed8(dst, kHllSparse);
+    put_fixed8(dst, static_cast<uint8_t>(precision));
+    put_varint64(dst, num_entries);
+    uint32_t prev = 0;
+    for (size_t i = 0; i < num_entries; ++i) {
+        uint32_t index = entries[i] >> 8;
+        put_varint64(dst, index - prev);
+        put_fixed8(dst, static_cast<uint8_t>(entries[i]));
+        prev = index;
+    }
+}
+
+void HyperLogLog::serialize_dense(const uint8_t* registers, int precision, Buffer<uint8_t>* dst) {
+    size_t num_registers = size_t(1) << precision;
+    Buffer<uint64_t> values(num_registers, uint64_t{0});
+    uint8_t max_rank = 0;
+    for (size_t i = 0; i < num_registers; ++i) {
+        values[i] = registers[i];
+        max_rank = std::max(max_rank, registers[i]);
+    }
+    int bits = bits_required(max_rank);
+    put_fixed8(dst, kHllDense);
+    put_fixed8(dst, static_cast<uint8_t>(precision));
+    put_fixed8(dst, static_cast<uint8_t>(bits));
+    bit_pack(values.data(), num_registers, bits, dst);
+}
+
+bool HyperLogLog::deserialize(Slice* input, HyperLogLog* hll) {
+    uint8_t format;
+    uint8_t precision;
+    if (!get_fixed8(input, &format) || !get_fixed8(input, &precision) || precision < kMinPrecision ||
+        precision > kMaxPrecision) {
+        return false;
+    }
+    *hll = HyperLogLog(precision);
+    size_t num_registers = hll->_registers.size();
+    uint8_t max_rank = 64 - precision + 1;
+    if (format == kHllSparse) {
+        uint64_t num_entries;
+        if (!get_varint64(input, &num_entries) || num_entries > num_registers) {
+            return false;
+        }
+        uint64_t index = 0;
+        for (uint64_t i = 0; i < num_entries; ++i) {
+            uint64_t gap;
+            uint8_t rank;
+            if (!get_varint64(input, &gap) || (i > 0 && gap == 0) || (index += gap) >= num_registers ||
+                !get_fixed8(input, &rank) || rank == 0 || rank > max_rank) {
+                return false;
+            }
+            hll->_registers[index] = rank;
+        }
+        return true;
+    }
+    uint8_t bits;
+    if (format != kHllDense || !get_fixed8(input, &bits) || bits > 8 ||
+        input->size < bit_packed_size(num_registers, bits)) {
+        return false;
+    }
+    bit_unpack(reinterpret_cast<const uint8_t*>(input->data), bits, 0, num_registers, hll->_registers.data());
+    input->remove_prefix(bit_packed_size(num_registers, bits));
+    return std::all_of(hll->_registers.begin(), hll->_registers.end(), [max_rank](uint8_t r) { return r <= max_rank; });
+}
+
+} // namespace starrocks
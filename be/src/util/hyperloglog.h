@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "column/buffer.h"
+#include "common/compiler_util.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// HyperLogLog estimate of the number of distinct 64-bit hashes added. The
+// top |precision| bits of a hash pick one of 2^precision one-byte registers,
+// which keeps the largest rank - position of the first set bit - of the
+// remaining bits; the standard error is about 1.04 / sqrt(2^precision),
+// 1.6% at the default precision, in 4KB. Small counts are estimated by
+// linear counting of the empty registers.
+//
+// Like BlockBloomFilter, a sketch folds onto a lower precision, which is how
+// sketches of different precisions merge.
+class HyperLogLog {
+public:
+    static constexpr int kMinPrecision = 4;
+    static constexpr int kMaxPrecision = 18;
+    static constexpr int kDefaultPrecision = 12;
+
+    // |precision| is clamped to [kMinPrecision, kMaxPrecision].
+    explicit HyperLogLog(int precision = kDefaultPrecision);
+
+    int precision() const { return _precision; }
+    const std::vector<uint8_t>& registers() const { return _registers; }
+
+    ALWAYS_INLINE void add_hash(uint64_t hash) { add_hash(_registers.data(), _precision, hash); }
+
+    // Makes this sketch count what |other| counts too. The result has the
+    // lower of the two precisions.
+    void merge(const HyperLogLog& other);
+
+    int64_t estimate() const { return estimate(_registers.data(), _precision); }
+
+    // The same over the 2^precision |registers| of a sketch kept elsewhere,
+    // such as an aggregate state.
+    static ALWAYS_INLINE uint32_t register_index(uint64_t hash, int precision) {
+        return static_cast<uint32_t>(hash >> (64 - precision));
+    }
+    static ALWAYS_INLINE uint8_t register_rank(uint64_t hash, int precision) {
+        // A sentinel bit caps the rank at 64 - precision + 1.
+        uint64_t rest = (hash << precision) | (uint64_t(1) << (precision - 1));
+        return static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    }
+    static ALWAYS_INLINE void add_hash(uint8_t* registers, int precision, uint64_t hash) {
+        uint32_t index = register_index(hash, precision);
+        uint8_t rank = register_rank(hash, precision);
+        if (rank > registers[index]) {
+            registers[index] = rank;
+        }
+    }
+    static int64_t estimate(const uint8_t* registers, int precision);
+
+    // Serialized form: a format byte and the precision, then either the set
+    // registers as (index gap, rank) pairs, while fewer than a quarter of
+    // them are set, or all of them, bit packed.
+    void serialize(Buffer<uint8_t>* dst) const;
+    static bool deserialize(Slice* input, HyperLogLog* hll);
+    // The serialized form of a sketch whose set registers are |entries|,
+    // index << 8 | rank in index order.
+    static void serialize_sparse(const uint32_t* entries, size_t num_entries, int precision, Buffer<uint8_t>* dst);
+    static void serialize_dense(const uint8_t* registers, int precision, Buffer<uint8_t>* dst);
+
+private:
+    // Lowers the precision to |precision|.
+    void _fold(int precision);
+
+    int _precision;
+    std::vector<uint8_t> _registers;
+};
+
+} // namespace starrocks
@@ -0,0 +1,16 @@
+#include "util/mem_info.h"
+
+#include <unistd.h>
+
+namespace starrocks {
+
+int64_t MemInfo::physical_mem() {
+    static const int64_t s_physical_mem = [] {
+        long pages = sysconf(_SC_PHYS_PAGES);
+        long page_size = sysconf(_SC_PAGESIZE);
+        return pages > 0 && page_size > 0 ? static_cast<int64_t>(pages) * page_size : 8L << 30;
+    }();
+    return s_physical_mem;
+}
+
+} // namespace starrocks
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace starrocks {
+
+class MemInfo {
+public:
+    // Physical memory of the host in bytes (8GB when it cannot be probed).
+    static int64_t physical_mem();
+};
+
+} // namespace starrocks
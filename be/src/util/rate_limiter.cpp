@@ -0,0 +1,30 @@
+#include "util/rate_limiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "util/stopwatch.h"
+
+namespace starrocks {
+
+void RateLimiter::acquire(int64_t bytes) {
+    int64_t rate = _bytes_per_second.load(std::memory_order_relaxed);
+    if (rate <= 0 || bytes <= 0) {
+        return;
+    }
+    int64_t cost_ns = static_cast<int64_t>(static_cast<double>(bytes) * 1e9 / rate);
+    int64_t wait_ns;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        int64_t now = monotonic_nanos();
+        _next_free_ns = std::max(_next_free_ns, now - kBurstNanos) + cost_ns;
+        wait_ns = _next_free_ns - now;
+    }
+    if (wait_ns > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wait_ns));
+        _wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "common/compiler_util.h"
+
+namespace starrocks {
+
+// Token bucket shared by the threads doing one kind of background I/O, e.g.
+// compaction, so that together they stay under a bandwidth cap. Callers
+// report the bytes they moved and are put to sleep for as long as it takes
+// the bucket to refill; up to kBurstNanos of idle time is saved as credit.
+class RateLimiter {
+public:
+    static constexpr int64_t kBurstNanos = 100L * 1000 * 1000;
+
+    // |bytes_per_second| <= 0 means unlimited.
+    explicit RateLimiter(int64_t bytes_per_second) : _bytes_per_second(bytes_per_second) {}
+
+    DISALLOW_COPY_AND_MOVE(RateLimiter);
+
+    int64_t rate() const { return _bytes_per_second.load(std::memory_order_relaxed); }
+    void set_rate(int64_t bytes_per_second) { _bytes_per_second.store(bytes_per_second, std::memory_order_relaxed); }
+
+    // Charges |bytes| and blocks until the rate allows them.
+    void acquire(int64_t bytes);
+
+    // Time callers spent blocked.
+    int64_t wait_ns() const { return _wait_ns.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> _bytes_per_second;
+    std::mutex _lock;
+    // When the bytes charged so far will have been paid for.
+    int64_t _next_free_ns = 0;
+    std::atomic<int64_t> _wait_ns{0};
+};
+
+} // namespace starrocks
@@ -0,0 +1,594 @@
+#include "util/roaring_bitmap.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "runtime/mem_pool.h"
+#include "util/coding.h"
+
+namespace starrocks {
+
+using Container = RoaringBitmap::Container;
+
+static constexpr uint32_t kMaxArrayCardinality = RoaringBitmap::kMaxArrayCardinality;
+static constexpr uint32_t kBitmapWords = RoaringBitmap::kBitmapWords;
+static constexpr uint64_t kMaxKey = (uint64_t(1) << 48) - 1;
+
+static constexpr uint8_t kRoaringFormat = 1;
+
+enum ContainerEncoding : uint8_t {
+    kArrayEncoding = 0,
+    kBitmapEncoding = 1,
+    // (start, length - 1) of each range of consecutive values.
+    kRunEncoding = 2,
+};
+
+template <typename T>
+static T* allocate(MemPool* pool, size_t n) {
+    return reinterpret_cast<T*>(pool->allocate(n * sizeof(T), alignof(T)));
+}
+
+static bool test_bit(const uint64_t* bitmap, uint16_t value) {
+    return (bitmap[value >> 6] >> (value & 63)) & 1;
+}
+
+// Sets the bit of |value|; true if it was clear.
+static bool set_bit(uint64_t* bitmap, uint16_t value) {
+    uint64_t mask = uint64_t(1) << (value & 63);
+    bool was_clear = (bitmap[value >> 6] & mask) == 0;
+    bitmap[value >> 6] |= mask;
+    return was_clear;
+}
+
+static void set_range(uint64_t* bitmap, uint32_t first, uint32_t last) {
+    uint32_t first_word = first >> 6;
+    uint32_t last_word = last >> 6;
+    uint64_t first_mask = ~uint64_t(0) << (first & 63);
+    uint64_t last_mask = ~uint64_t(0) >> (63 - (last & 63));
+    if (first_word == last_word) {
+        bitmap[first_word] |= first_mask & last_mask;
+        return;
+    }
+    bitmap[first_word] |= first_mask;
+    for (uint32_t w = first_word + 1; w < last_word; ++w) {
+        bitmap[w] = ~uint64_t(0);
+    }
+    bitmap[last_word] |= last_mask;
+}
+
+static uint32_t count_bits(const uint64_t* bitmap) {
+    uint32_t n = 0;
+    for (uint32_t w = 0; w < kBitmapWords; ++w) {
+        n += __builtin_popcountll(bitmap[w]);
+    }
+    return n;
+}
+
+// Writes the values of |bitmap| to |out|, ascending; returns their number.
+static uint32_t bitmap_to_array(const uint64_t* bitmap, uint16_t* out) {
+    uint32_t n = 0;
+    for (uint32_t w = 0; w < kBitmapWords; ++w) {
+        for (uint64_t word = bitmap[w]; word != 0; word &= word - 1) {
+            out[n++] = static_cast<uint16_t>(w * 64 + __builtin_ctzll(word));
+        }
+    }
+    return n;
+}
+
+static uint64_t* new_bitmap(MemPool* pool) {
+    auto* bitmap = allocate<uint64_t>(pool, kBitmapWords);
+    memset(bitmap, 0, kBitmapWords * sizeof(uint64_t));
+    return bitmap;
+}
+
+// Makes room in the array of |container| for |n| values.
+static void reserve(Container* container, uint32_t n, MemPool* pool) {
+    if (n <= container->capacity) {
+        return;
+    }
+    uint32_t capacity = std::max(n, std::min(std::max<uint32_t>(4, container->capacity * 2), kMaxArrayCardinality));
+    auto* array = allocate<uint16_t>(pool, capacity);
+    std::copy(container->array, container->array + container->cardinality, array);
+    container->array = array;
+    container->capacity = capacity;
+}
+
+static void to_bitmap(Container* container, MemPool* pool) {
+    uint64_t* bitmap = new_bitmap(pool);
+    for (uint32_t i = 0; i < container->cardinality; ++i) {
+        set_bit(bitmap, container->array[i]);
+    }
+    container->bitmap = bitmap;
+    container->array = nullptr;
+    container->capacity = 0;
+}
+
+// A bitmap container left with at most kMaxArrayCardinality values becomes
+// an array, in the memory of the bitmap, which has just the room for it.
+static void shrink_to_array(Container* container) {
+    container->cardinality = count_bits(container->bitmap);
+    if (container->cardinality > kMaxArrayCardinality) {
+        return;
+    }
+    uint16_t values[kMaxArrayCardinality];
+    bitmap_to_array(container->bitmap, values);
+    container->array = reinterpret_cast<uint16_t*>(container->bitmap);
+    std::copy(values, values + container->cardinality, container->array);
+    container->bitmap = nullptr;
+    container->capacity = kMaxArrayCardinality;
+}
+
+static Container copy_container(const Container& from, MemPool* pool) {
+    Container copy = from;
+    if (from.is_bitmap()) {
+        copy.bitmap = allocate<uint64_t>(pool, kBitmapWords);
+        std::copy(from.bitmap, from.bitmap + kBitmapWords, copy.bitmap);
+    } else {
+        copy.array = allocate<uint16_t>(pool, from.cardinality);
+        copy.capacity = from.cardinality;
+        std::copy(from.array, from.array + from.cardinality, copy.array);
+    }
+    return copy;
+}
+
+static void unite(Container* a, const Container& b, MemPool* pool) {
+    if (!a->is_bitmap() && !b.is_bitmap()) {
+        uint16_t merged[2 * kMaxArrayCardinality];
+        auto n = static_cast<uint32_t>(std::set_union(a->array, a->array + a->cardinality, b.array,
+                                                      b.array + b.cardinality, merged) -
+                                       merged);
+        if (n <= kMaxArrayCardinality) {
+            reserve(a, n, pool);
+            std::copy(merged, merged + n, a->array);
+        } else {
+            a->bitmap = new_bitmap(pool);
+            a->array = nullptr;
+            a->capacity = 0;
+            for (uint32_t i = 0; i < n; ++i) {
+                set_bit(a->bitmap, merged[i]);
+            }
+        }
+        a->cardinality = n;
+        return;
+    }
+    if (!a->is_bitmap()) {
+        to_bitmap(a, pool);
+    }
+    if (b.is_bitmap()) {
+        for (uint32_t w = 0; w < kBitmapWords; ++w) {
+            a->bitmap[w] |= b.bitmap[w];
+        }
+        a->cardinality = count_bits(a->bitmap);
+    } else {
+        for (uint32_t i = 0; i < b.cardinality; ++i) {
+            a->cardinality += set_bit(a->bitmap, b.array[i]);
+        }
+    }
+}
+
+// Keeps the values of |a| that |b| has (kKeep) or has not.
+template <bool kKeep>
+static void filter(Container* a, const Container& b) {
+    if (!a->is_bitmap()) {
+        uint32_t n = 0;
+        if (b.is_bitmap()) {
+            for (uint32_t i = 0; i < a->cardinality; ++i) {
+                uint16_t value = a->array[i];
+                a->array[n] = value;
+                n += test_bit(b.bitmap, value) == kKeep;
+            }
+        } else {
+            // Written behind the values read, so in place.
+            uint32_t j = 0;
+            for (uint32_t i = 0; i < a->cardinality; ++i) {
+                uint16_t value = a->array[i];
+                while (j < b.cardinality && b.array[j] < value) {
+                    ++j;
+                }
+                a->array[n] = value;
+                n += (j < b.cardinality && b.array[j] == value) == kKeep;
+            }
+        }
+        a->cardinality = n;
+        return;
+    }
+    if (b.is_bitmap()) {
+        for (uint32_t w = 0; w < kBitmapWords; ++w) {
+            a->bitmap[w] &= kKeep ? b.bitmap[w] : ~b.bitmap[w];
+        }
+    } else if (kKeep) {
+        uint64_t kept[kBitmapWords] = {};
+        for (uint32_t i = 0; i < b.cardinality; ++i) {
+            if (test_bit(a->bitmap, b.array[i])) {
+                set_bit(kept, b.array[i]);
+            }
+        }
+        std::copy(kept, kept + kBitmapWords, a->bitmap);
+    } else {
+        for (uint32_t i = 0; i < b.cardinality; ++i) {
+            a->bitmap[b.array[i] >> 6] &= ~(uint64_t(1) << (b.array[i] & 63));
+        }
+    }
+    shrink_to_array(a);
+}
+
+// Calls |fn| with the first and last value of each range of consecutive
+// values of |container|, ascending.
+template <typename Fn>
+static void for_each_run(const Container& container, Fn&& fn) {
+    if (!container.is_bitmap()) {
+        const uint16_t* values = container.array;
+        uint32_t start = 0;
+        for (uint32_t i = 1; i <= container.cardinality; ++i) {
+            if (i == container.cardinality || values[i] != values[i - 1] + 1) {
+                fn(values[start], values[i - 1]);
+                start = i;
+            }
+        }
+        return;
+    }
+    // The first set (|set|) or clear bit at or after |from|, 1 << 16 if none.
+    auto next = [&container](uint32_t from, bool set) -> uint32_t {
+        for (uint32_t w = from >> 6; w < kBitmapWords; ++w) {
+            uint64_t word = set ? container.bitmap[w] : ~container.bitmap[w];
+            if (w == from >> 6) {
+                word &= ~uint64_t(0) << (from & 63);
+            }
+            if (word != 0) {
+                return w * 64 + __builtin_ctzll(word);
+            }
+        }
+        return 1 << 16;
+    };
+    uint32_t first = next(0, true);
+    while (first < (1 << 16)) {
+        uint32_t end = next(first, false);
+        fn(static_cast<uint16_t>(first), static_cast<uint16_t>(end - 1));
+        first = end < (1 << 16) ? next(end, true) : end;
+    }
+}
+
+static uint32_t count_runs(const Container& container) {
+    uint32_t n = 0;
+    if (!container.is_bitmap()) {
+        for (uint32_t i = 0; i < container.cardinality; ++i) {
+            n += i == 0 || container.array[i] != container.array[i - 1] + 1;
+        }
+        return n;
+    }
+    uint64_t carry = 0;
+    for (uint32_t w = 0; w < kBitmapWords; ++w) {
+        uint64_t word = container.bitmap[w];
+        n += __builtin_popcountll(word & ~((word << 1) | carry));
+        carry = word >> 63;
+    }
+    return n;
+}
+
+uint32_t RoaringBitmap::_lower_bound(uint64_t key) const {
+    return static_cast<uint32_t>(
+            std::lower_bound(_containers, _containers + _size, key,
+                             [](const Container& container, uint64_t k) { return container.key < k; }) -
+            _containers);
+}
+
+Container* RoaringBitmap::_insert_container(uint32_t index, uint64_t key, MemPool* pool) {
+    if (_size == _capacity) {
+        uint32_t capacity = std::max<uint32_t>(4, _capacity * 2);
+        auto* containers = allocate<Container>(pool, capacity);
+        std::copy(_containers, _containers + index, containers);
+        std::copy(_containers + index, _containers + _size, containers + index + 1);
+        _containers = containers;
+        _capacity = capacity;
+    } else {
+        std::copy_backward(_containers + index, _containers + _size, _containers + _size + 1);
+    }
+    _containers[index] = Container{key, 0, 0, nullptr, nullptr};
+    ++_size;
+    return &_containers[index];
+}
+
+void RoaringBitmap::_remove_empty() {
+    uint32_t n = 0;
+    for (uint32_t c = 0; c < _size; ++c) {
+        if (_containers[c].cardinality > 0) {
+            _containers[n++] = _containers[c];
+        }
+    }
+    _size = n;
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t n = 0;
+    for (uint32_t c = 0; c < _size; ++c) {
+        n += _containers[c].cardinality;
+    }
+    return n;
+}
+
+bool RoaringBitmap::contains(uint64_t value) const {
+    uint32_t index = _lower_bound(value >> 16);
+    if (index == _size || _containers[index].key != value >> 16) {
+        return false;
+    }
+    const Container& container = _containers[index];
+    auto low = static_cast<uint16_t>(value);
+    if (container.is_bitmap()) {
+        return test_bit(container.bitmap, low);
+    }
+    return std::binary_search(container.array, container.array + container.cardinality, low);
+}
+
+void RoaringBitmap::add(uint64_t value, MemPool* pool) {
+    uint64_t key = value >> 16;
+    auto low = static_cast<uint16_t>(value);
+    // Values tend to come clustered: try the last container first.
+    uint32_t index = _size > 0 && _containers[_size - 1].key == key ? _size - 1 : _lower_bound(key);
+    Container* container =
+            index < _size && _containers[index].key == key ? &_containers[index] : _insert_container(index, key, pool);
+    if (container->is_bitmap()) {
+        container->cardinality += set_bit(container->bitmap, low);
+        return;
+    }
+    uint16_t* end = container->array + container->cardinality;
+    uint16_t* pos = std::lower_bound(container->array, end, low);
+    if (pos != end && *pos == low) {
+        return;
+    }
+    if (container->cardinality == kMaxArrayCardinality) {
+        to_bitmap(container, pool);
+        set_bit(container->bitmap, low);
+        container->cardinality++;
+        return;
+    }
+    auto offset = pos - container->array;
+    reserve(container, container->cardinality + 1, pool);
+    pos = container->array + offset;
+    std::copy_backward(pos, container->array + container->cardinality, container->array + container->cardinality + 1);
+    *pos = low;
+    container->cardinality++;
+}
+
+void RoaringBitmap::union_with(const RoaringBitmap& other, MemPool* pool) {
+    uint32_t missing = 0;
+    for (uint32_t i = 0, j = 0; j < other._size; ++j) {
+        while (i < _size && _containers[i].key < other._containers[j].key) {
+            ++i;
+        }
+        missing += i == _size || _containers[i].key != other._containers[j].key;
+    }
+    uint32_t size = _size + missing;
+    if (size > _capacity) {
+        auto* containers = allocate<Container>(pool, size);
+        std::copy(_containers, _containers + _size, containers);
+        _containers = containers;
+        _capacity = size;
+    }
+    // From the back, so the containers move at most once.
+    auto i = static_cast<int64_t>(_size) - 1;
+    auto j = static_cast<int64_t>(other._size) - 1;
+    for (int64_t k = size - 1; j >= 0; --k) {
+        const Container& theirs = other._containers[j];
+        if (i >= 0 && _containers[i].key > theirs.key) {
+            _containers[k] = _containers[i--];
+        } else if (i >= 0 && _containers[i].key == theirs.key) {
+            _containers[k] = _containers[i--];
+            unite(&_containers[k], theirs, pool);
+            --j;
+        } else {
+            _containers[k] = copy_container(theirs, pool);
+            --j;
+        }
+    }
+    _size = size;
+}
+
+void RoaringBitmap::intersect_with(const RoaringBitmap& other) {
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < _size; ++i) {
+        Container& container = _containers[i];
+        while (j < other._size && other._containers[j].key < container.key) {
+            ++j;
+        }
+        if (j < other._size && other._containers[j].key == container.key) {
+            filter<true>(&container, other._containers[j]);
+        } else {
+            container.cardinality = 0;
+        }
+    }
+    _remove_empty();
+}
+
+void RoaringBitmap::subtract(const RoaringBitmap& other) {
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < _size; ++i) {
+        Container& container = _containers[i];
+        while (j < other._size && other._containers[j].key < container.key) {
+            ++j;
+        }
+        if (j < other._size && other._containers[j].key == container.key) {
+            filter<false>(&container, other._containers[j]);
+        }
+    }
+    _remove_empty();
+}
+
+std::string RoaringBitmap::to_string() const {
+    std::string text;
+    for_each([&text](uint64_t value) {
+        char buf[24];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        if (!text.empty()) {
+            text += ',';
+        }
+        text.append(buf, end);
+    });
+    return text;
+}
+
+bool RoaringBitmap::parse(Slice text, RoaringBitmap* bitmap, MemPool* pool) {
+    *bitmap = RoaringBitmap();
+    const char* p = text.data;
+    const char* end = text.data + text.size;
+    auto skip_blanks = [&] {
+        while (p < end && *p == ' ') {
+            ++p;
+        }
+    };
+    skip_blanks();
+    if (p == end) {
+        return true;
+    }
+    while (true) {
+        skip_blanks();
+        uint64_t value;
+        auto [next, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc()) {
+            return false;
+        }
+        bitmap->add(value, pool);
+        p = next;
+        skip_blanks();
+        if (p == end) {
+            return true;
+        }
+        if (*p++ != ',') {
+            return false;
+        }
+    }
+}
+
+void RoaringBitmap::serialize(Buffer<uint8_t>* dst) const {
+    put_fixed8(dst, kRoaringFormat);
+    put_varint64(dst, _size);
+    uint64_t prev_key = 0;
+    for (uint32_t c = 0; c < _size; ++c) {
+        const Container& container = _containers[c];
+        put_varint64(dst, container.key - prev_key);
+        prev_key = container.key;
+        put_varint64(dst, container.cardinality - 1);
+        uint32_t num_runs = count_runs(container);
+        size_t array_bytes = container.cardinality * sizeof(uint16_t);
+        size_t bitmap_bytes = kBitmapWords * sizeof(uint64_t);
+        if (num_runs * 2 * sizeof(uint16_t) < std::min(array_bytes, bitmap_bytes)) {
+            put_fixed8(dst, kRunEncoding);
+            put_varint64(dst, num_runs);
+            for_each_run(container, [dst](uint16_t first, uint16_t last) {
+                put_fixed16(dst, first);
+                put_fixed16(dst, last - first);
+            });
+        } else if (container.is_bitmap() && bitmap_bytes < array_bytes) {
+            put_fixed8(dst, kBitmapEncoding);
+            dst->append(reinterpret_cast<const uint8_t*>(container.bitmap), bitmap_bytes);
+        } else {
+            put_fixed8(dst, kArrayEncoding);
+            if (container.is_bitmap()) {
+                uint16_t values[kMaxArrayCardinality];
+                bitmap_to_array(container.bitmap, values);
+                dst->append(reinterpret_cast<const uint8_t*>(values), array_bytes);
+            } else {
+                dst->append(reinterpret_cast<const uint8_t*>(container.array), array_bytes);
+            }
+        }
+    }
+}
+
+// Reads the values of a container of |cardinality| values serialized with
+// |encoding| into |container|, an empty array or bitmap as the cardinality
+// calls for.
+static bool read_values(Slice* input, uint8_t encoding, uint32_t cardinality, Container* container) {
+    switch (encoding) {
+    case kArrayEncoding: {
+        if (container->is_bitmap() || input->size < cardinality * sizeof(uint16_t)) {
+            return false;
+        }
+        memcpy(container->array, input->data, cardinality * sizeof(uint16_t));
+        input->remove_prefix(cardinality * sizeof(uint16_t));
+        for (uint32_t i = 1; i < cardinality; ++i) {
+            if (container->array[i] <= container->array[i - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case kBitmapEncoding: {
+        if (!container->is_bitmap() || input->size < kBitmapWords * sizeof(uint64_t)) {
+            return false;
+        }
+        memcpy(container->bitmap, input->data, kBitmapWords * sizeof(uint64_t));
+        input->remove_prefix(kBitmapWords * sizeof(uint64_t));
+        return count_bits(container->bitmap) == cardinality;
+    }
+    case kRunEncoding: {
+        uint64_t num_runs;
+        if (!get_varint64(input, &num_runs) || num_runs == 0 || num_runs > cardinality) {
+            return false;
+        }
+        uint32_t num_values = 0;
+        uint32_t min_first = 0;
+        for (uint64_t r = 0; r < num_runs; ++r) {
+            uint16_t first;
+            uint16_t length;
+            if (!get_fixed16(input, &first) || !get_fixed16(input, &length)) {
+                return false;
+            }
+            uint32_t last = uint32_t(first) + length;
+            if (first < min_first || last > UINT16_MAX || num_values + length + 1 > cardinality) {
+                return false;
+            }
+            if (container->is_bitmap()) {
+                set_range(container->bitmap, first, last);
+            } else {
+                for (uint32_t value = first; value <= last; ++value) {
+                    container->array[num_values + value - first] = static_cast<uint16_t>(value);
+                }
+            }
+            num_values += length + 1;
+            min_first = last + 1;
+        }
+        return num_values == cardinality;
+    }
+    default:
+        return false;
+    }
+}
+
+bool RoaringBitmap::deserialize(Slice* input, RoaringBitmap* bitmap, MemPool* pool) {
+    *bitmap = RoaringBitmap();
+    uint8_t format;
+    uint64_t num_containers;
+    // A container takes at least four bytes.
+    if (!get_fixed8(input, &format) || format != kRoaringFormat || !get_varint64(input, &num_containers) ||
+        num_containers > input->size / 4) {
+        return false;
+    }
+    auto* containers = allocate<Container>(pool, num_containers);
+    uint64_t key = 0;
+    for (uint64_t c = 0; c < num_containers; ++c) {
+        uint64_t gap;
+        uint64_t cardinality;
+        uint8_t encoding;
+        if (!get_varint64(input, &gap) || (c > 0 && gap == 0) || gap > kMaxKey - key ||
+            !get_varint64(input, &cardinality) || cardinality >= (1 << 16) || !get_fixed8(input, &encoding)) {
+            return false;
+        }
+        key += gap;
+        Container& container = containers[c];
+        container = Container{key, static_cast<uint32_t>(cardinality + 1), 0, nullptr, nullptr};
+        if (container.cardinality > kMaxArrayCardinality) {
+            container.bitmap = new_bitmap(pool);
+        } else {
+            container.array = allocate<uint16_t>(pool, container.cardinality);
+            container.capacity = container.cardinality;
+        }
+        if (!read_values(input, encoding, container.cardinality, &container)) {
+            return false;
+        }
+    }
+    bitmap->_containers = containers;
+    bitmap->_size = bitmap->_capacity = static_cast<uint32_t>(num_containers);
+    return true;
+}
+
+} // namespace starrocks
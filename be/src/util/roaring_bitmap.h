@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "column/buffer.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+class MemPool;
+
+// A set of uint64 values as a roaring bitmap. Values are grouped by their
+// high 48 bits, the key, into containers of their low 16 bits: a sorted
+// array while a container holds at most kMaxArrayCardinality values, a
+// bitmap of all 2^16 beyond, so a container never takes more than 8KB and
+// dense ranges of IDs cost a bit each. Sets are united, intersected and
+// subtracted container by container, words at a time between bitmaps,
+// without enumerating their values.
+//
+// Like an aggregate state, a RoaringBitmap is plain data: the calls that
+// grow it take their memory from a MemPool, which releases it all at once.
+// A default-constructed one is empty; copying one shares its containers.
+class RoaringBitmap {
+public:
+    static constexpr uint32_t kMaxArrayCardinality = 4096;
+    static constexpr uint32_t kBitmapWords = (1 << 16) / 64;
+
+    struct Container {
+        uint64_t key;
+        uint32_t cardinality;
+        // Values |array| has room for; 0 for a bitmap.
+        uint32_t capacity;
+        uint16_t* array;
+        uint64_t* bitmap;
+
+        bool is_bitmap() const { return bitmap != nullptr; }
+    };
+
+    bool empty() const { return _size == 0; }
+    uint64_t cardinality() const;
+    bool contains(uint64_t value) const;
+
+    // By ascending key, none of them empty.
+    const Container* containers() const { return _containers; }
+    size_t num_containers() const { return _size; }
+
+    void add(uint64_t value, MemPool* pool);
+
+    // In place. Intersecting and subtracting only shrink containers, so they
+    // need no memory.
+    void union_with(const RoaringBitmap& other, MemPool* pool);
+    void intersect_with(const RoaringBitmap& other);
+    void subtract(const RoaringBitmap& other);
+
+    // Calls |fn| with each value, ascending.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (uint32_t c = 0; c < _size; ++c) {
+            const Container& container = _containers[c];
+            uint64_t high = container.key << 16;
+            if (container.is_bitmap()) {
+                for (uint32_t w = 0; w < kBitmapWords; ++w) {
+                    for (uint64_t word = container.bitmap[w]; word != 0; word &= word - 1) {
+                        fn(high | (w * 64 + __builtin_ctzll(word)));
+                    }
+                }
+            } else {
+                for (uint32_t i = 0; i < container.cardinality; ++i) {
+                    fn(high | container.array[i]);
+                }
+            }
+        }
+    }
+
+    // Text form: the values, ascending, separated by commas ("1,5,7").
+    std::string to_string() const;
+    // Reads the text form; blanks around values are ignored, and the values
+    // may come in any order and repeat.
+    static bool parse(Slice text, RoaringBitmap* bitmap, MemPool* pool);
+
+    // Serialized form: a format byte and the number of containers, then for
+    // each its key (as the gap from the previous one), its cardinality and
+    // the smallest of three encodings of its values: an array of them, the
+    // bitmap, or ranges of consecutive values.
+    void serialize(Buffer<uint8_t>* dst) const;
+    // Reads a bitmap serialize() wrote from the front of |input|, validating
+    // it; false if |input| does not start with one.
+    static bool deserialize(Slice* input, RoaringBitmap* bitmap, MemPool* pool);
+
+private:
+    // Index of the first container whose key is not below |key|.
+    uint32_t _lower_bound(uint64_t key) const;
+    Container* _insert_container(uint32_t index, uint64_t key, MemPool* pool);
+    // Drops the containers intersecting or subtracting emptied.
+    void _remove_empty();
+
+    Container* _containers = nullptr;
+    uint32_t _size = 0;
+    uint32_t _capacity = 0;
+};
+
+} // namespace starrocks
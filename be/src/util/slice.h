@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace starrocks {
+
+// Non-owning view over a byte range.
+struct Slice {
+    const char* data = "";
+    size_t size = 0;
+
+    Slice() = default;
+    Slice(const char* d, size_t n) : data(d), size(n) {}
+    Slice(const uint8_t* d, size_t n) : data(reinterpret_cast<const char*>(d)), size(n) {}
+    Slice(const std::string& s) : data(s.data()), size(s.size()) {} // NOLINT
+    Slice(std::string_view s) : data(s.data()), size(s.size()) {}   // NOLINT
+    Slice(const char* s) : data(s), size(strlen(s)) {}              // NOLINT
+
+    bool empty() const { return size == 0; }
+    char operator[](size_t i) const { return data[i]; }
+
+    void remove_prefix(size_t n) {
+        data += n;
+        size -= n;
+    }
+
+    std::string to_string() const { return std::string(data, size); }
+    std::string_view to_string_view() const { return std::string_view(data, size); }
+
+    int compare(const Slice& b) const {
+        const size_t min_len = size < b.size ? size : b.size;
+        int r = min_len == 0 ? 0 : memcmp(data, b.data, min_len);
+        if (r == 0) {
+            if (size < b.size) {
+                r = -1;
+            } else if (size > b.size) {
+                r = 1;
+            }
+        }
+        return r;
+    }
+
+    bool operator==(const Slice& b) const { return size == b.size && (size == 0 || memcmp(data, b.data, size) == 0); }
+    bool operator!=(const Slice& b) const { return !(*this == b); }
+    bool operator<(const Slice& b) const { return compare(b) < 0; }
+    bool operator<=(const Slice& b) const { return compare(b) <= 0; }
+    bool operator>(const Slice& b) const { return compare(b) > 0; }
+    bool operator>=(const Slice& b) const { return compare(b) >= 0; }
+};
+
+struct SliceHash {
+    size_t operator()(const Slice& s) const { return std::hash<std::string_view>()(s.to_string_view()); }
+};
+
+} // namespace starrocks
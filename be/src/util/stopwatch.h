@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace starrocks {
+
+inline int64_t monotonic_nanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+inline int64_t monotonic_micros() {
+    return monotonic_nanos() / 1000;
+}
+
+inline int64_t monotonic_millis() {
+    return monotonic_nanos() / 1000000;
+}
+
+class MonotonicStopWatch {
+public:
+    void start() {
+        if (!_running) {
+            _start = monotonic_nanos();
+            _running = true;
+        }
+    }
+
+    void stop() {
+        if (_running) {
+            _total += monotonic_nanos() - _start;
+            _running = false;
+        }
+    }
+
+    void reset() {
+        _total = 0;
+        _running = false;
+    }
+
+    int64_t elapsed_time() const { return _running ? _total + monotonic_nanos() - _start : _total; }
+
+private:
+    int64_t _start = 0;
+    int64_t _total = 0;
+    bool _running = false;
+};
+
+// Adds the lifetime of the scope to |*counter| (in nanoseconds).
+class ScopedTimer {
+public:
+    explicit ScopedTimer(int64_t* counter) : _counter(counter), _start(monotonic_nanos()) {}
+    ~ScopedTimer() { *_counter += monotonic_nanos() - _start; }
+
+private:
+    int64_t* _counter;
+    int64_t _start;
+};
+
+} // namespace starrocks
@@ -0,0 +1,150 @@
+#include "util/tdigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "util/coding.h"
+
+namespace starrocks {
+
+static constexpr uint8_t kTDigestFormat = 1;
+
+static double scale_k(double q) {
+    return TDigest::kCompression / (2 * M_PI) * std::asin(2 * q - 1);
+}
+
+// Inverse of scale_k().
+static double scale_q(double k) {
+    if (k >= TDigest::kCompression / 4) {
+        return 1;
+    }
+    return (std::sin(k * 2 * M_PI / TDigest::kCompression) + 1) / 2;
+}
+
+size_t TDigest::compress(Centroid* centroids, size_t num_centroids) {
+    if (num_centroids == 0) {
+        return 0;
+    }
+    std::sort(centroids, centroids + num_centroids,
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    double total = 0;
+    for (size_t i = 0; i < num_centroids; ++i) {
+        total += static_cast<double>(centroids[i].weight);
+    }
+    size_t last = 0;
+    // Weight of the centroids before the last one, and the quantile the
+    // last one may grow to.
+    double before = 0;
+    double limit = scale_q(scale_k(0) + 1);
+    for (size_t i = 1; i < num_centroids; ++i) {
+        Centroid& current = centroids[last];
+        const Centroid& next = centroids[i];
+        double weight = static_cast<double>(current.weight + next.weight);
+        if ((before + weight) / total <= limit) {
+            current.mean += (next.mean - current.mean) * static_cast<double>(next.weight) / weight;
+            current.weight += next.weight;
+            continue;
+        }
+        before += static_cast<double>(current.weight);
+        limit = scale_q(scale_k(before / total) + 1);
+        centroids[++last] = next;
+    }
+    return last + 1;
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.empty()) {
+        return;
+    }
+    _min = empty() ? other._min : std::min(_min, other._min);
+    _max = empty() ? other._max : std::max(_max, other._max);
+    _centroids.insert(_centroids.end(), other._centroids.begin(), other._centroids.end());
+    _centroids.resize(compress(_centroids.data(), _centroids.size()));
+}
+
+double TDigest::quantile(double q) const {
+    double total = 0;
+    for (const auto& centroid : _centroids) {
+        total += static_cast<double>(centroid.weight);
+    }
+    double rank = std::clamp(q, 0.0, 1.0) * total;
+    // The values of a centroid are spread around its mean: the mean sits at
+    // the middle of the ranks it covers, and ranks between two means are
+    // interpolated, as are those before the first and after the last mean,
+    // towards the smallest and the largest value.
+    double prev_mean = _min;
+    double prev_rank = 0;
+    double covered = 0;
+    for (const auto& centroid : _centroids) {
+        double weight = static_cast<double>(centroid.weight);
+        double mid = covered + weight / 2;
+        if (rank < mid) {
+            double span = mid - prev_rank;
+            return span <= 0 ? centroid.mean : prev_mean + (centroid.mean - prev_mean) * (rank - prev_rank) / span;
+        }
+        prev_mean = centroid.mean;
+        prev_rank = mid;
+        covered += weight;
+    }
+    double span = total - prev_rank;
+    return span <= 0 ? _max : prev_mean + (_max - prev_mean) * (rank - prev_rank) / span;
+}
+
+static void put_double(Buffer<uint8_t>* dst, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_fixed64(dst, bits);
+}
+
+static bool get_double(Slice* input, double* value) {
+    uint64_t bits;
+    if (!get_fixed64(input, &bits)) {
+        return false;
+    }
+    memcpy(value, &bits, sizeof(bits));
+    return !std::isnan(*value);
+}
+
+void TDigest::serialize(const Centroid* centroids, size_t num_centroids, double min, double max,
+                        Buffer<uint8_t>* dst) {
+    put_fixed8(dst, kTDigestFormat);
+    put_varint64(dst, num_centroids);
+    if (num_centroids == 0) {
+        return;
+    }
+    put_double(dst, min);
+    put_double(dst, max);
+    for (size_t i = 0; i < num_centroids; ++i) {
+        put_double(dst, centroids[i].mean);
+        put_varint64(dst, centroids[i].weight);
+    }
+}
+
+bool TDigest::deserialize(Slice* input, TDigest* digest) {
+    uint8_t format;
+    uint64_t num_centroids;
+    // Each centroid takes at least nine bytes.
+    if (!get_fixed8(input, &format) || format != kTDigestFormat || !get_varint64(input, &num_centroids) ||
+        num_centroids > input->size / 9) {
+        return false;
+    }
+    *digest = TDigest();
+    if (num_centroids == 0) {
+        return true;
+    }
+    if (!get_double(input, &digest->_min) || !get_double(input, &digest->_max) || digest->_min > digest->_max) {
+        return false;
+    }
+    digest->_centroids.resize(num_centroids);
+    for (auto& centroid : digest->_centroids) {
+        if (!get_double(input, &centroid.mean) || !get_varint64(input, &centroid.weight) || centroid.weight == 0) {
+            return false;
+        }
+    }
+    // Compressed, so in order; quantile() relies on it.
+    return std::is_sorted(digest->_centroids.begin(), digest->_centroids.end(),
+                          [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+}
+
+} // namespace starrocks
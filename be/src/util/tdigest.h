@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "column/buffer.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// t-digest of a distribution of doubles, for approximate quantiles: the
+// values are summarized by centroids - a mean and the number of values
+// merged into it - small near the extremes and larger towards the median,
+// so the error of a quantile q is about proportional to q * (1 - q). The
+// scale function k(q) = kCompression / (2 pi) * asin(2q - 1) bounds each
+// centroid to a unit of k, which keeps at most about kCompression * pi / 2
+// of them.
+class TDigest {
+public:
+    static constexpr double kCompression = 100;
+
+    struct Centroid {
+        double mean;
+        uint64_t weight;
+    };
+
+    TDigest() = default;
+
+    bool empty() const { return _centroids.empty(); }
+    // Ascending by mean.
+    const std::vector<Centroid>& centroids() const { return _centroids; }
+    double min() const { return _min; }
+    double max() const { return _max; }
+
+    void merge(const TDigest& other);
+
+    // The value below which a fraction |q| of the values lie, interpolated
+    // between the means of the centroids; the digest must not be empty.
+    double quantile(double q) const;
+
+    // Sorts |num_centroids| centroids by mean and merges neighbours within
+    // the bound of the scale function, in place; returns how many are left.
+    static size_t compress(Centroid* centroids, size_t num_centroids);
+
+    // Serialized form: a format byte, the number of centroids, the smallest
+    // and largest value, then the mean and weight of each centroid.
+    void serialize(Buffer<uint8_t>* dst) const { serialize(_centroids.data(), _centroids.size(), _min, _max, dst); }
+    // |centroids| must be compressed.
+    static void serialize(const Centroid* centroids, size_t num_centroids, double min, double max,
+                          Buffer<uint8_t>* dst);
+    static bool deserialize(Slice* input, TDigest* digest);
+
+private:
+    std::vector<Centroid> _centroids;
+    double _min = 0;
+    double _max = 0;
+};
+
+} // namespace starrocks
@@ -0,0 +1,98 @@
+#include "util/theta_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "util/coding.h"
+
+namespace starrocks {
+
+static constexpr uint8_t kThetaFormat = 1;
+
+int64_t ThetaSketch::estimate(size_t num_hashes, uint64_t theta) {
+    if (theta == UINT64_MAX) {
+        return static_cast<int64_t>(num_hashes);
+    }
+    return std::llround(static_cast<double>(num_hashes) * (std::ldexp(1.0, 64) / static_cast<double>(theta)));
+}
+
+void ThetaSketch::_trim() {
+    if (_hashes.size() > kNominalEntries) {
+        _theta = _hashes[kNominalEntries];
+        _hashes.resize(kNominalEntries);
+    }
+}
+
+// The hashes of |from| below |theta|.
+static auto below(const std::vector<uint64_t>& from, uint64_t theta) {
+    return std::make_pair(from.begin(), std::lower_bound(from.begin(), from.end(), theta));
+}
+
+ThetaSketch ThetaSketch::unite(const ThetaSketch& a, const ThetaSketch& b) {
+    uint64_t theta = std::min(a._theta, b._theta);
+    auto [a_begin, a_end] = below(a._hashes, theta);
+    auto [b_begin, b_end] = below(b._hashes, theta);
+    std::vector<uint64_t> hashes;
+    std::set_union(a_begin, a_end, b_begin, b_end, std::back_inserter(hashes));
+    ThetaSketch result(theta, std::move(hashes));
+    result._trim();
+    return result;
+}
+
+ThetaSketch ThetaSketch::intersect(const ThetaSketch& a, const ThetaSketch& b) {
+    uint64_t theta = std::min(a._theta, b._theta);
+    auto [a_begin, a_end] = below(a._hashes, theta);
+    auto [b_begin, b_end] = below(b._hashes, theta);
+    std::vector<uint64_t> hashes;
+    std::set_intersection(a_begin, a_end, b_begin, b_end, std::back_inserter(hashes));
+    return ThetaSketch(theta, std::move(hashes));
+}
+
+ThetaSketch ThetaSketch::a_not_b(const ThetaSketch& a, const ThetaSketch& b) {
+    uint64_t theta = std::min(a._theta, b._theta);
+    auto [a_begin, a_end] = below(a._hashes, theta);
+    auto [b_begin, b_end] = below(b._hashes, theta);
+    std::vector<uint64_t> hashes;
+    std::set_difference(a_begin, a_end, b_begin, b_end, std::back_inserter(hashes));
+    return ThetaSketch(theta, std::move(hashes));
+}
+
+void ThetaSketch::serialize(uint64_t theta, const uint64_t* hashes, size_t num_hashes, Buffer<uint8_t>* dst) {
+    put_fixed8(dst, kThetaFormat);
+    put_fixed64(dst, theta);
+    put_varint64(dst, num_hashes);
+    uint64_t prev = 0;
+    for (size_t i = 0; i < num_hashes; ++i) {
+        put_varint64(dst, hashes[i] - prev);
+        prev = hashes[i];
+    }
+}
+
+bool ThetaSketch::deserialize(Slice* input, ThetaSketch* sketch) {
+    uint8_t format;
+    uint64_t theta;
+    uint64_t num_hashes;
+    // Each hash takes at least a byte.
+    if (!get_fixed8(input, &format) || format != kThetaFormat || !get_fixed64(input, &theta) ||
+        !get_varint64(input, &num_hashes) || num_hashes > input->size) {
+        return false;
+    }
+    std::vector<uint64_t> hashes(num_hashes);
+    uint64_t hash = 0;
+    for (size_t i = 0; i < num_hashes; ++i) {
+        uint64_t gap;
+        if (!get_varint64(input, &gap) || (i > 0 && gap == 0) || gap > theta - hash) {
+            return false;
+        }
+        hash += gap;
+        hashes[i] = hash;
+    }
+    if (num_hashes > 0 && hash >= theta) {
+        return false;
+    }
+    *sketch = ThetaSketch(theta, std::move(hashes));
+    return true;
+}
+
+} // namespace starrocks
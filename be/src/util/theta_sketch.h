@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "column/buffer.h"
+#include "util/slice.h"
+
+namespace starrocks {
+
+// Theta sketch estimating the number of distinct 64-bit hashes: it keeps
+// the hashes below a threshold theta, at most kNominalEntries of them, and
+// estimates their number divided by the fraction of the hash space below
+// theta - exactly the number of hashes until the first kNominalEntries + 1
+// distinct ones lower theta to the smallest hash dropped. The relative
+// error is about 1 / sqrt(kNominalEntries), 1.6%.
+//
+// Unlike HyperLogLog, theta sketches intersect and subtract as well as
+// unite: the result keeps the hashes of the operands below the lower of
+// their thetas that the set operation keeps, so the estimate of an
+// intersection is not derived from those of its operands.
+class ThetaSketch {
+public:
+    static constexpr size_t kNominalEntries = 4096;
+
+    ThetaSketch() = default;
+
+    uint64_t theta() const { return _theta; }
+    // Distinct and ascending, all below theta().
+    const std::vector<uint64_t>& hashes() const { return _hashes; }
+
+    int64_t estimate() const { return estimate(_hashes.size(), _theta); }
+    static int64_t estimate(size_t num_hashes, uint64_t theta);
+
+    static ThetaSketch unite(const ThetaSketch& a, const ThetaSketch& b);
+    static ThetaSketch intersect(const ThetaSketch& a, const ThetaSketch& b);
+    // The hashes of |a| not in |b|.
+    static ThetaSketch a_not_b(const ThetaSketch& a, const ThetaSketch& b);
+
+    // Serialized form: a format byte, theta, then the hashes as varint
+    // gaps between consecutive ones.
+    void serialize(Buffer<uint8_t>* dst) const { serialize(_theta, _hashes.data(), _hashes.size(), dst); }
+    static void serialize(uint64_t theta, const uint64_t* hashes, size_t num_hashes, Buffer<uint8_t>* dst);
+    static bool deserialize(Slice* input, ThetaSketch* sketch);
+
+private:
+    ThetaSketch(uint64_t theta, std::vector<uint64_t> hashes) : _theta(theta), _hashes(std::move(hashes)) {}
+
+    // Drops the hashes beyond the first kNominalEntries, lowering theta.
+    void _trim();
+
+    uint64_t _theta = UINT64_MAX;
+    std::vector<uint64_t> _hashes;
+};
+
+} // namespace starrocks
@@ -0,0 +1,80 @@
+#include "util/threadpool.h"
+
+#include <pthread.h>
+
+namespace starrocks {
+
+ThreadPool::ThreadPool(std::string name, int num_threads, size_t max_queue_size)
+        : _name(std::move(name)), _max_queue_size(max_queue_size) {
+    _threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        _threads.emplace_back([this] { _work(); });
+        pthread_setname_np(_threads.back().native_handle(), _name.substr(0, 15).c_str());
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+Status ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_shutdown) {
+            return Status::Cancelled(_name + " is shut down");
+        }
+        if (_tasks.size() >= _max_queue_size) {
+            return Status::ResourceBusy(_name + " queue is full");
+        }
+        _tasks.emplace_back(std::move(task));
+    }
+    _cv.notify_one();
+    return Status::OK();
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_shutdown) {
+            return;
+        }
+        _shutdown = true;
+    }
+    _cv.notify_all();
+    for (auto& t : _threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+size_t ThreadPool::queued_tasks() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _tasks.size();
+}
+
+int ThreadPool::active_threads() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _active;
+}
+
+void ThreadPool::_work() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> l(_lock);
+            _cv.wait(l, [this] { return _shutdown || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            _active++;
+        }
+        task();
+        std::lock_guard<std::mutex> l(_lock);
+        _active--;
+    }
+}
+
+} // namespace starrocks
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "common/status.h"
+
+namespace starrocks {
+
+// Fixed-size FIFO thread pool for blocking work (I/O, spill writes, compaction)
+// that must not run on pipeline worker threads.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(std::string name, int num_threads, size_t max_queue_size = SIZE_MAX);
+    ~ThreadPool();
+
+    DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+    // Queues |task|. Fails with ResourceBusy when the queue is full and with
+    // Cancelled after shutdown().
+    Status submit(Task task);
+
+    // Stops accepting tasks, runs the queued ones and joins the workers.
+    void shutdown();
+
+    int num_threads() const { return static_cast<int>(_threads.size()); }
+    size_t queued_tasks() const;
+    int active_threads() const;
+
+private:
+    void _work();
+
+    const std::string _name;
+    const size_t _max_queue_size;
+    mutable std::mutex _lock;
+    std::condition_variable _cv;
+    std::deque<Task> _tasks;
+    std::vector<std::thread> _threads;
+    int _active = 0;
+    bool _shutdown = false;
+};
+
+} // namespace starrocks
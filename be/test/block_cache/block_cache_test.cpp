@@ -0,0 +1,196 @@
+#include "block_cache/block_cache.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "block_cache/cached_object_file.h"
+
+namespace starrocks {
+
+static constexpr size_t kBlockSize = 4096;
+
+// Objects of whole blocks in a scratch directory, read through a BlockCache.
+class BlockCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/block_cache_test.XXXXXX";
+        ASSERT_NE(nullptr, ::mkdtemp(dir));
+        _dir = dir;
+        std::filesystem::create_directories(_dir + "/objects");
+        _store = std::make_unique<io::LocalObjectStore>(_dir + "/objects");
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(_dir, ec);
+    }
+
+    static uint8_t byte_at(size_t i) { return static_cast<uint8_t>(i * 131 + i / kBlockSize); }
+
+    void write_object(const std::string& key, size_t num_blocks) {
+        std::vector<char> data(num_blocks * kBlockSize);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(byte_at(i));
+        }
+        std::ofstream out(_dir + "/objects/" + key, std::ios::binary);
+        out.write(data.data(), data.size());
+    }
+
+    void create_cache(size_t mem_blocks, size_t disk_blocks) {
+        BlockCacheOptions options;
+        options.block_size = kBlockSize;
+        options.mem_capacity_bytes = mem_blocks * kBlockSize;
+        options.disk_capacity_bytes = disk_blocks * kBlockSize;
+        options.disk_path = _dir + "/cache";
+        auto cache = BlockCache::create(options, nullptr);
+        ASSERT_TRUE(cache.ok()) << cache.status().to_string();
+        _cache = std::move(cache).value();
+    }
+
+    io::RandomAccessFilePtr open(const std::string& key, int64_t table_id) {
+        auto file = CachedObjectFile::open(_store.get(), key, _cache.get(), table_id);
+        EXPECT_TRUE(file.ok());
+        return std::move(file).value();
+    }
+
+    // Blocks fetched from the store; every fetch reads a whole block.
+    int64_t fetched_blocks() const { return _store->bytes_read() / static_cast<int64_t>(kBlockSize); }
+
+    // Reads a few bytes from the middle of |block| and checks them.
+    static void read_block(const io::RandomAccessFile& file, size_t block) {
+        uint8_t buf[100];
+        size_t offset = block * kBlockSize + 1000;
+        ASSERT_TRUE(file.read_at(offset, buf, sizeof(buf)).ok());
+        for (size_t i = 0; i < sizeof(buf); ++i) {
+            ASSERT_EQ(byte_at(offset + i), buf[i]) << "block " << block << " byte " << i;
+        }
+    }
+
+    std::string _dir;
+    std::unique_ptr<io::LocalObjectStore> _store;
+    std::unique_ptr<BlockCache> _cache;
+};
+
+TEST_F(BlockCacheTest, ReadsAcrossBlocks) {
+    write_object("a", 3);
+    create_cache(4, 0);
+    auto file = open("a", 1);
+    std::vector<uint8_t> buf(2 * kBlockSize + 10);
+    ASSERT_TRUE(file->read_at(kBlockSize / 2, buf.data(), buf.size()).ok());
+    for (size_t i = 0; i < buf.size(); ++i) {
+        ASSERT_EQ(byte_at(kBlockSize / 2 + i), buf[i]);
+    }
+    EXPECT_EQ(3, fetched_blocks());
+    ASSERT_TRUE(file->read_at(0, buf.data(), buf.size()).ok());
+    EXPECT_EQ(3, fetched_blocks());
+    EXPECT_FALSE(file->read_at(3 * kBlockSize - 5, buf.data(), 10).ok());
+}
+
+TEST_F(BlockCacheTest, ScanDoesNotEvictHotBlocks) {
+    write_object("hot", 2);
+    write_object("scan", 64);
+    create_cache(4, 0);
+    auto hot = open("hot", 1);
+    auto scan = open("scan", 2);
+    for (int round = 0; round < 2; ++round) {
+        read_block(*hot, 0);
+        read_block(*hot, 1);
+    }
+    for (size_t block = 0; block < 64; ++block) {
+        read_block(*scan, block);
+    }
+    int64_t fetched = fetched_blocks();
+    read_block(*hot, 0);
+    read_block(*hot, 1);
+    EXPECT_EQ(fetched, fetched_blocks());
+    EXPECT_EQ(4, _cache->table_stats(1).mem_hits);
+    EXPECT_EQ(4 * static_cast<int64_t>(kBlockSize), _cache->mem_usage());
+}
+
+TEST_F(BlockCacheTest, DemotesToDiskAndPromotesBack) {
+    write_object("a", 4);
+    create_cache(2, 8);
+    auto file = open("a", 1);
+    for (size_t block = 0; block < 4; ++block) {
+        read_block(*file, block);
+    }
+    EXPECT_EQ(2 * static_cast<int64_t>(kBlockSize), _cache->mem_usage());
+    EXPECT_EQ(2 * static_cast<int64_t>(kBlockSize), _cache->disk_usage());
+
+    // Blocks 0 and 1 went to disk; reading one brings it back to memory and
+    // pushes another block out to disk in its place.
+    read_block(*file, 0);
+    EXPECT_EQ(4, fetched_blocks());
+    EXPECT_EQ(1, _cache->table_stats(1).disk_hits);
+    read_block(*file, 0);
+    EXPECT_EQ(1, _cache->table_stats(1).disk_hits);
+    EXPECT_EQ(1, _cache->table_stats(1).mem_hits);
+    EXPECT_EQ(2 * static_cast<int64_t>(kBlockSize), _cache->mem_usage());
+    EXPECT_EQ(2 * static_cast<int64_t>(kBlockSize), _cache->disk_usage());
+
+    for (size_t block = 0; block < 4; ++block) {
+        read_block(*file, block);
+    }
+    EXPECT_EQ(4, fetched_blocks());
+    EXPECT_EQ(0, _cache->num_checksum_failures());
+}
+
+TEST_F(BlockCacheTest, CorruptedDiskBlockIsRefetched) {
+    write_object("a", 4);
+    create_cache(2, 8);
+    auto file = open("a", 1);
+    for (size_t block = 0; block < 4; ++block) {
+        read_block(*file, block);
+    }
+    ASSERT_EQ(2 * static_cast<int64_t>(kBlockSize), _cache->disk_usage());
+
+    int fd = ::open((_dir + "/cache/block_cache.data").c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    std::vector<uint8_t> garbage(8 * kBlockSize, 0xab);
+    ASSERT_EQ(static_cast<ssize_t>(garbage.size()), ::pwrite(fd, garbage.data(), garbage.size(), 0));
+    ::close(fd);
+
+    read_block(*file, 0);
+    EXPECT_EQ(1, _cache->num_checksum_failures());
+    EXPECT_EQ(5, fetched_blocks());
+    EXPECT_EQ(0, _cache->table_stats(1).disk_hits);
+    EXPECT_EQ(5, _cache->table_stats(1).misses);
+
+    // The refetched block is cached again.
+    read_block(*file, 0);
+    EXPECT_EQ(5, fetched_blocks());
+}
+
+TEST_F(BlockCacheTest, CountsPerTable) {
+    write_object("a", 2);
+    write_object("b", 2);
+    create_cache(8, 0);
+    auto a = open("a", 7);
+    auto b = open("b", 3);
+    read_block(*a, 0);
+    read_block(*a, 0);
+    read_block(*a, 1);
+    read_block(*b, 1);
+
+    BlockCacheStats stats = _cache->table_stats(7);
+    EXPECT_EQ(1, stats.mem_hits);
+    EXPECT_EQ(2, stats.misses);
+    EXPECT_EQ(100, stats.hit_bytes);
+    EXPECT_EQ(200, stats.miss_bytes);
+    EXPECT_EQ(0, _cache->table_stats(3).mem_hits);
+    EXPECT_EQ(1, _cache->table_stats(3).misses);
+    EXPECT_EQ(0, _cache->table_stats(99).misses);
+
+    auto all = _cache->all_table_stats();
+    ASSERT_EQ(2, all.size());
+    EXPECT_EQ(3, all[0].first);
+    EXPECT_EQ(7, all[1].first);
+}
+
+} // namespace starrocks
@@ -0,0 +1,76 @@
+#include "column/buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "runtime/arena.h"
+
+namespace starrocks {
+
+TEST(BufferTest, GrowsAlignedAndKeepsValues) {
+    Buffer<int32_t> buf;
+    for (int32_t i = 0; i < 1000; ++i) {
+        buf.push_back(i);
+    }
+    ASSERT_EQ(1000, buf.size());
+    ASSERT_GE(buf.capacity(), buf.size());
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(buf.data()) % COLUMN_BUFFER_ALIGNMENT);
+    for (int32_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i, buf[i]);
+    }
+}
+
+TEST(BufferTest, ResizeZeroFillsAndAssigns) {
+    Buffer<int64_t> buf{1, 2, 3};
+    buf.resize(6);
+    EXPECT_EQ(3, buf[2]);
+    EXPECT_EQ(0, buf[5]);
+    buf.resize(8, 7);
+    EXPECT_EQ(7, buf[7]);
+    buf.assign(2, 9);
+    ASSERT_EQ(2, buf.size());
+    EXPECT_EQ(9, buf[0]);
+    EXPECT_EQ(9, buf[1]);
+}
+
+TEST(BufferTest, InsertAndErase) {
+    Buffer<int32_t> buf{1, 5};
+    int32_t values[] = {2, 3, 4};
+    buf.insert(buf.begin() + 1, values, values + 3);
+    ASSERT_EQ(5, buf.size());
+    for (int32_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(i + 1, buf[i]);
+    }
+    buf.erase(buf.begin(), buf.begin() + 2);
+    ASSERT_EQ(3, buf.size());
+    EXPECT_EQ(3, buf.front());
+    EXPECT_EQ(5, buf.back());
+}
+
+TEST(BufferTest, MoveTransfersStorage) {
+    Buffer<uint8_t> a{1, 2, 3};
+    const uint8_t* data = a.data();
+    Buffer<uint8_t> b(std::move(a));
+    EXPECT_EQ(data, b.data());
+    EXPECT_EQ(3, b.size());
+    EXPECT_EQ(nullptr, a.data());
+    EXPECT_EQ(0, a.size());
+
+    Buffer<uint8_t> c(b);
+    EXPECT_NE(b.data(), c.data());
+    EXPECT_EQ(3, c[2]);
+}
+
+TEST(BufferTest, ArenaBackedStorageIsReturned) {
+    Arena arena;
+    {
+        Buffer<double> buf(&arena);
+        buf.resize(4096);
+        EXPECT_EQ(&arena, buf.arena());
+        EXPECT_GE(arena.allocated_bytes(), 4096 * sizeof(double));
+    }
+    EXPECT_EQ(0, arena.allocated_bytes());
+}
+
+} // namespace starrocks
@@ -0,0 +1,66 @@
+#include "column/chunk.h"
+
+#include <gtest/gtest.h>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "column/fixed_length_column.h"
+#include "runtime/descriptors.h"
+
+namespace starrocks {
+
+static ChunkPtr make_chunk(int32_t begin, int32_t end) {
+    auto ids = Int32Column::create();
+    auto names = BinaryColumn::create();
+    for (int32_t i = begin; i < end; ++i) {
+        ids->append_datum(Datum(i));
+        names->append_string("n" + std::to_string(i));
+    }
+    auto chunk = std::make_shared<Chunk>();
+    chunk->append_column(ids, 1);
+    chunk->append_column(names, 2);
+    return chunk;
+}
+
+TEST(ChunkTest, ColumnsBySlot) {
+    ChunkPtr chunk = make_chunk(0, 4);
+    EXPECT_EQ(4, chunk->num_rows());
+    EXPECT_EQ(2, chunk->num_columns());
+    EXPECT_TRUE(chunk->is_slot_exist(2));
+    EXPECT_FALSE(chunk->is_slot_exist(3));
+    EXPECT_EQ(1, chunk->get_index_by_slot_id(2));
+    EXPECT_EQ("[2, 'n2']", chunk->debug_row(2));
+}
+
+TEST(ChunkTest, FilterAppendAndClone) {
+    ChunkPtr chunk = make_chunk(0, 6);
+    Filter filter{1, 0, 1, 0, 1, 0};
+    ASSERT_EQ(3, chunk->filter(filter));
+    EXPECT_EQ("[4, 'n4']", chunk->debug_row(2));
+
+    ChunkUniquePtr copy = chunk->clone_empty();
+    copy->append(*make_chunk(10, 13), 1, 2);
+    uint32_t indexes[] = {2, 0};
+    copy->append_selective(*chunk, indexes, 0, 2);
+    ASSERT_EQ(4, copy->num_rows());
+    EXPECT_EQ("[11, 'n11']", copy->debug_row(0));
+    EXPECT_EQ("[4, 'n4']", copy->debug_row(2));
+    EXPECT_EQ("[0, 'n0']", copy->debug_row(3));
+
+    ChunkUniquePtr clone = chunk->clone();
+    clone->reset();
+    EXPECT_EQ(0, clone->num_rows());
+    EXPECT_EQ(3, chunk->num_rows());
+}
+
+TEST(ChunkTest, CreateForRowDesc) {
+    RowDescriptor desc{{1, TYPE_BIGINT, false}, {2, TYPE_VARCHAR, true}};
+    ChunkPtr chunk = create_chunk_for_row_desc(desc);
+    ASSERT_EQ(2, chunk->num_columns());
+    EXPECT_FALSE(chunk->get_column_by_slot_id(1)->is_nullable());
+    EXPECT_TRUE(chunk->get_column_by_slot_id(2)->is_nullable());
+    ChunkPtr outer = create_chunk_for_row_desc(desc, true);
+    EXPECT_TRUE(outer->get_column_by_slot_id(1)->is_nullable());
+}
+
+} // namespace starrocks
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "column/binary_column.h"
+#include "column/column_helper.h"
+#include "column/const_column.h"
+#include "column/fixed_length_column.h"
+#include "column/nullable_column.h"
+
+namespace starrocks {
+
+TEST(ColumnTest, FixedLengthAppendAndFilter) {
+    auto column = Int32Column::create();
+    for (int32_t i = 0; i < 10; ++i) {
+        column->append_datum(Datum(i));
+    }
+    auto other = Int32Column::create();
+    other->append(*column, 2, 3);
+    ASSERT_EQ(3, other->size());
+    EXPECT_EQ(2, other->get(0).get_int32());
+
+    Filter filter(10, uint8_t{0});
+    filter[1] = filter[4] = filter[9] = 1;
+    ASSERT_EQ(3, column->filter(filter));
+    EXPECT_EQ(1, column->get_data()[0]);
+    EXPECT_EQ(4, column->get_data()[1]);
+    EXPECT_EQ(9, column->get_data()[2]);
+}
+
+TEST(ColumnTest, AppendSelectiveAndRepeat) {
+    auto src = Int64Column::create();
+    for (int64_t i = 0; i < 5; ++i) {
+        src->append_datum(Datum(i * 10));
+    }
+    uint32_t indexes[] = {4, 0, 2};
+    auto dst = Int64Column::create();
+    dst->append_selective(*src, indexes, 0, 3);
+    dst->append_value_multiple_times(*src, 1, 2);
+    ASSERT_EQ(5, dst->size());
+    EXPECT_EQ(40, dst->get(0).get_int64());
+    EXPECT_EQ(0, dst->get(1).get_int64());
+    EXPECT_EQ(20, dst->get(2).get_int64());
+    EXPECT_EQ(10, dst->get(3).get_int64());
+    EXPECT_EQ(10, dst->get(4).get_int64());
+}
+
+TEST(ColumnTest, BinaryColumn) {
+    auto column = BinaryColumn::create();
+    column->append_string("");
+    column->append_string("abc");
+    column->append_string("de");
+    ASSERT_EQ(3, column->size());
+    EXPECT_EQ(Slice(""), column->get_slice(0));
+    EXPECT_EQ(Slice("abc"), column->get_slice(1));
+    EXPECT_EQ("'de'", column->debug_item(2));
+    EXPECT_GT(column->compare_at(2, 1, *column, 1), 0);
+
+    Filter filter{0, 1, 0};
+    ASSERT_EQ(1, column->filter(filter));
+    EXPECT_EQ(Slice("abc"), column->get_slice(0));
+}
+
+TEST(ColumnTest, NullableColumn) {
+    ColumnPtr column = ColumnHelper::create_column(TYPE_INT, true);
+    column->append_datum(Datum(int32_t{7}));
+    column->append_datum(Datum());
+    column->append_default(1);
+    ASSERT_EQ(3, column->size());
+    auto* nullable = static_cast<NullableColumn*>(column.get());
+    EXPECT_FALSE(nullable->is_null(0));
+    EXPECT_TRUE(nullable->is_null(1));
+    EXPECT_TRUE(column->has_null());
+    EXPECT_EQ(7, column->get(0).get_int32());
+    EXPECT_TRUE(column->get(1).is_null());
+    EXPECT_EQ("NULL", column->debug_item(1));
+
+    ColumnPtr copy = column->clone();
+    Filter filter{1, 0, 0};
+    copy->filter(filter);
+    EXPECT_EQ(1, copy->size());
+    EXPECT_FALSE(copy->has_null());
+    EXPECT_EQ(3, column->size());
+}
+
+TEST(ColumnTest, ConstColumnUnfolds) {
+    ColumnPtr column = ColumnHelper::create_const_column<TYPE_INT>(5, 4);
+    EXPECT_TRUE(column->is_constant());
+    EXPECT_EQ(4, column->size());
+    EXPECT_EQ(5, column->get(3).get_int32());
+    ColumnPtr unfolded = ColumnHelper::unfold_const_column(TYPE_INT, 4, column);
+    EXPECT_FALSE(unfolded->is_constant());
+    ASSERT_EQ(4, unfolded->size());
+    EXPECT_EQ(5, unfolded->get(2).get_int32());
+
+    ColumnPtr nulls = ColumnHelper::create_const_null_column(3, TYPE_INT);
+    EXPECT_TRUE(nulls->only_null());
+}
+
+} // namespace starrocks
@@ -0,0 +1,85 @@
+#include "exec/join_hash_map.h"
+
+#include <gtest/gtest.h>
+
+#include "column/binary_column.h"
+#include "column/fixed_length_column.h"
+
+namespace starrocks {
+
+// Joins |build| to |probe| on their slot 1 (and slot 2 when |with_name|) and
+// returns the number of output rows.
+static size_t inner_join_rows(LogicalType key_type, const ColumnPtr& build, const ColumnPtr& probe,
+                              bool with_name, JoinKeyKind expected_kind) {
+    JoinHashTable::Param param;
+    param.build_row_desc = {{1, key_type, false}};
+    param.probe_row_desc = {{1, key_type, false}};
+    param.build_key_slots = {1};
+    param.probe_key_slots = {1};
+    if (with_name) {
+        param.build_row_desc.push_back({2, TYPE_VARCHAR, false});
+        param.probe_row_desc.push_back({2, TYPE_VARCHAR, false});
+        param.build_key_slots.push_back(2);
+        param.probe_key_slots.push_back(2);
+    }
+    auto make_chunk = [&](const ColumnPtr& keys) {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->append_column(keys, 1);
+        if (with_name) {
+            auto names = BinaryColumn::create();
+            for (size_t i = 0; i < keys->size(); ++i) {
+                names->append_string("k");
+            }
+            chunk->append_column(names, 2);
+        }
+        return chunk;
+    };
+
+    JoinHashTable table(std::move(param));
+    EXPECT_TRUE(table.prepare().ok());
+    EXPECT_EQ(expected_kind, table.key_kind());
+    EXPECT_TRUE(table.append_build_chunk(make_chunk(build)).ok());
+    EXPECT_TRUE(table.build().ok());
+
+    JoinProber prober(&table);
+    EXPECT_TRUE(prober.push_probe_chunk(make_chunk(probe)).ok());
+    size_t rows = 0;
+    while (prober.has_remaining()) {
+        auto output = prober.next_output(4096);
+        EXPECT_TRUE(output.ok());
+        rows += output.value()->num_rows();
+    }
+    return rows;
+}
+
+TEST(JoinHashMapTest, IntegerKeys) {
+    auto build = Int32Column::create();
+    auto probe = Int32Column::create();
+    for (int32_t i = 0; i < 100; ++i) {
+        build->append_datum(Datum(i % 10));
+        probe->append_datum(Datum(i));
+    }
+    EXPECT_EQ(100, inner_join_rows(TYPE_INT, build, probe, false, JoinKeyKind::kFixed64));
+    EXPECT_EQ(100, inner_join_rows(TYPE_INT, build, probe, true, JoinKeyKind::kSerialized));
+}
+
+TEST(JoinHashMapTest, NegativeZeroMatchesZero) {
+    auto build = DoubleColumn::create();
+    build->append_datum(Datum(-0.0));
+    build->append_datum(Datum(1.5));
+    auto probe = DoubleColumn::create();
+    probe->append_datum(Datum(0.0));
+    probe->append_datum(Datum(-0.0));
+    probe->append_datum(Datum(-1.5));
+    EXPECT_EQ(2, inner_join_rows(TYPE_DOUBLE, build, probe, false, JoinKeyKind::kFixed64));
+    EXPECT_EQ(2, inner_join_rows(TYPE_DOUBLE, build, probe, true, JoinKeyKind::kSerialized));
+
+    auto float_build = FloatColumn::create();
+    float_build->append_datum(Datum(0.0f));
+    auto float_probe = FloatColumn::create();
+    float_probe->append_datum(Datum(-0.0f));
+    EXPECT_EQ(1, inner_join_rows(TYPE_FLOAT, float_build, float_probe, false, JoinKeyKind::kFixed64));
+    EXPECT_EQ(1, inner_join_rows(TYPE_FLOAT, float_build, float_probe, true, JoinKeyKind::kSerialized));
+}
+
+} // namespace starrocks
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "column/column_helper.h"
+#include "common/config.h"
+#include "exec/pipeline/exchange/chunk_packet.h"
+#include "exec/pipeline/exchange/exchange_receiver.h"
+#include "exec/pipeline/exchange/exchange_sink_operator.h"
+#include "exec/pipeline/exchange/exchange_transport.h"
+#include "exec/pipeline/fragment_context.h"
+
+namespace starrocks::pipeline {
+
+// Exchange sinks sending over a LoopbackTransport to one receiver per
+// destination, all in one fragment that nobody runs.
+class ExchangeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _batch_bytes = config::exchange_batch_bytes;
+        _buffer_bytes = config::exchange_receiver_buffer_bytes;
+        _compression = config::exchange_compression;
+        _fragment_ctx = std::make_unique<FragmentContext>(std::make_shared<QueryContext>("exchange_test"), "f0");
+    }
+
+    void TearDown() override {
+        config::exchange_batch_bytes = _batch_bytes;
+        config::exchange_receiver_buffer_bytes = _buffer_bytes;
+        config::exchange_compression = _compression;
+    }
+
+    RuntimeState* state() const { return _fragment_ctx->runtime_state(); }
+
+    // |num_destinations| receivers expecting |num_senders| senders each.
+    void add_receivers(size_t num_destinations, int32_t num_senders) {
+        for (size_t i = 0; i < num_destinations; ++i) {
+            ExchangeDestination dest{"f" + std::to_string(i + 1), 1};
+            auto receiver = std::make_shared<ExchangeReceiver>(_fragment_ctx.get(), num_senders);
+            receiver->set_num_sources(1);
+            _transport.register_receiver(dest, receiver);
+            _destinations.push_back(dest);
+            _receivers.push_back(receiver);
+        }
+    }
+
+    std::unique_ptr<ExchangeSinkOperatorFactory> make_factory(ExchangePartitionType type,
+                                                              std::vector<SlotId> partition_slots) {
+        return std::make_unique<ExchangeSinkOperatorFactory>(0, 0, &_transport, _desc, type,
+                                                             std::move(partition_slots), _destinations, 0);
+    }
+
+    std::shared_ptr<ExchangeSinkOperator> make_sink(ExchangeSinkOperatorFactory* factory, int32_t dop,
+                                                    int32_t driver_sequence) {
+        auto sink = std::static_pointer_cast<ExchangeSinkOperator>(factory->create(dop, driver_sequence));
+        EXPECT_TRUE(sink->prepare(state()).ok());
+        return sink;
+    }
+
+    // Rows (k, name, v) for k in [begin, end); names are NULL for every
+    // seventh key.
+    ChunkPtr make_chunk(int32_t begin, int32_t end) const {
+        ChunkPtr chunk = create_chunk_for_row_desc(_desc);
+        for (int32_t k = begin; k < end; ++k) {
+            chunk->get_column_by_slot_id(1)->append_datum(Datum(k % 97));
+            std::string name = "name" + std::to_string(k);
+            chunk->get_column_by_slot_id(2)->append_datum(k % 7 == 0 ? Datum() : Datum(Slice(name)));
+            chunk->get_column_by_slot_id(3)->append_datum(Datum(k * 0.5));
+        }
+        return chunk;
+    }
+
+    static std::vector<std::string> rows_of(const Chunk& chunk) {
+        std::vector<std::string> rows;
+        for (size_t i = 0; i < chunk.num_rows(); ++i) {
+            rows.push_back(chunk.debug_row(i));
+        }
+        return rows;
+    }
+
+    // Pulls and decodes every packet queued at receiver |idx|.
+    std::vector<ChunkPtr> drain(size_t idx) const {
+        std::vector<ChunkPtr> chunks;
+        Buffer<uint8_t> scratch;
+        while (ChunkPacketPtr packet = _receivers[idx]->pull()) {
+            auto chunk = decode_chunk_packet(*packet, _desc, &scratch);
+            EXPECT_TRUE(chunk.ok()) << chunk.status().to_string();
+            chunks.push_back(std::move(chunk).value());
+        }
+        return chunks;
+    }
+
+    RowDescriptor _desc{{1, TYPE_INT, false}, {2, TYPE_VARCHAR, true}, {3, TYPE_DOUBLE, false}};
+    std::unique_ptr<FragmentContext> _fragment_ctx;
+    LoopbackTransport _transport;
+    std::vector<ExchangeDestination> _destinations;
+    std::vector<ExchangeReceiverPtr> _receivers;
+
+private:
+    int64_t _batch_bytes = 0;
+    int64_t _buffer_bytes = 0;
+    int32_t _compression = 0;
+};
+
+TEST_F(ExchangeTest, EqualFloatKeysGoToOneDestination) {
+    add_receivers(8, 1);
+    auto factory = make_factory(ExchangePartitionType::HASH, {3});
+    auto sink = make_sink(factory.get(), 1, 0);
+
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    double values[] = {0.0, -0.0, nan, -nan, std::nan("7"), 1.0};
+    ChunkPtr chunk = create_chunk_for_row_desc(_desc);
+    for (size_t i = 0; i < 6; ++i) {
+        chunk->get_column_by_slot_id(1)->append_datum(Datum(int32_t(i)));
+        chunk->get_column_by_slot_id(2)->append_datum(Datum());
+        chunk->get_column_by_slot_id(3)->append_datum(Datum(values[i]));
+    }
+    ASSERT_TRUE(sink->push_chunk(state(), chunk).ok());
+    ASSERT_TRUE(sink->set_finishing(state()).ok());
+
+    // Destination of the row with key i.
+    std::vector<int> dest(6, -1);
+    for (size_t d = 0; d < _receivers.size(); ++d) {
+        for (const ChunkPtr& received : drain(d)) {
+            for (size_t i = 0; i < received->num_rows(); ++i) {
+                dest[received->get_column_by_slot_id(1)->get(i).get_int32()] = d;
+            }
+        }
+    }
+    for (int d : dest) {
+        ASSERT_GE(d, 0);
+    }
+    EXPECT_EQ(dest[0], dest[1]);
+    EXPECT_EQ(dest[2], dest[3]);
+    EXPECT_EQ(dest[2], dest[4]);
+}
+
+TEST_F(ExchangeTest, HashShuffleRoundTrip) {
+    config::exchange_batch_bytes = 4096;
+    add_receivers(3, 1);
+    auto factory = make_factory(ExchangePartitionType::HASH, {1});
+    auto sink = make_sink(factory.get(), 1, 0);
+    std::vector<std::string> sent;
+    for (int32_t begin = 0; begin < 3000; begin += 1000) {
+        ChunkPtr chunk = make_chunk(begin, begin + 1000);
+        auto rows = rows_of(*chunk);
+        sent.insert(sent.end(), rows.begin(), rows.end());
+        ASSERT_TRUE(sink->need_input());
+        ASSERT_TRUE(sink->push_chunk(state(), chunk).ok());
+    }
+    ASSERT_TRUE(sink->set_finishing(state()).ok());
+    EXPECT_FALSE(sink->need_input());
+    EXPECT_GT(sink->num_packets_sent(), 3);
+
+    std::vector<std::string> received;
+    std::vector<int> dest_of_key(97, -1);
+    for (size_t d = 0; d < _receivers.size(); ++d) {
+        for (const ChunkPtr& chunk : drain(d)) {
+            for (size_t i = 0; i < chunk->num_rows(); ++i) {
+                int& dest = dest_of_key[chunk->get_column_by_slot_id(1)->get(i).get_int32()];
+                EXPECT_TRUE(dest == -1 || dest == static_cast<int>(d));
+                dest = d;
+            }
+            auto rows = rows_of(*chunk);
+            received.insert(received.end(), rows.begin(), rows.end());
+        }
+        EXPECT_TRUE(_receivers[d]->is_finished());
+    }
+    std::sort(sent.begin(), sent.end());
+    std::sort(received.begin(), received.end());
+    EXPECT_EQ(sent, received);
+}
+
+TEST_F(ExchangeTest, BroadcastSendsOnePacketEverywhere) {
+    add_receivers(3, 1);
+    auto factory = make_factory(ExchangePartitionType::BROADCAST, {});
+    auto sink = make_sink(factory.get(), 1, 0);
+    ChunkPtr chunk = make_chunk(0, 500);
+    ASSERT_TRUE(sink->push_chunk(state(), chunk).ok());
+    ASSERT_TRUE(sink->set_finishing(state()).ok());
+    EXPECT_EQ(1, sink->num_packets_sent());
+
+    ChunkPacketPtr first = _receivers[0]->pull();
+    ASSERT_NE(nullptr, first);
+    for (size_t d = 1; d < _receivers.size(); ++d) {
+        EXPECT_EQ(first, _receivers[d]->pull());
+    }
+    Buffer<uint8_t> scratch;
+    auto decoded = decode_chunk_packet(*first, _desc, &scratch);
+    ASSERT_TRUE(decoded.ok());
+    EXPECT_EQ(rows_of(*chunk), rows_of(*decoded.value()));
+    for (const auto& receiver : _receivers) {
+        EXPECT_TRUE(receiver->is_finished());
+    }
+}
+
+TEST_F(ExchangeTest, CompressesUnlessIncompressible) {
+    auto codec = get_block_compression_codec(CompressionType::LZ4);
+    ASSERT_TRUE(codec.ok());
+    ChunkPacketEncoder encoder(_desc, codec.value());
+    Buffer<uint8_t> scratch;
+
+    ChunkPtr repetitive = make_chunk(0, 2000);
+    ChunkPacket compressed;
+    ASSERT_TRUE(encoder.encode(*repetitive, &compressed).ok());
+    EXPECT_EQ(CompressionType::LZ4, compressed.compression);
+    EXPECT_LT(compressed.payload.size(), compressed.raw_size);
+    auto decoded = decode_chunk_packet(compressed, _desc, &scratch);
+    ASSERT_TRUE(decoded.ok());
+    EXPECT_EQ(rows_of(*repetitive), rows_of(*decoded.value()));
+
+    // Pseudo-random bytes: LZ4 finds nothing to save.
+    ChunkPtr noise = create_chunk_for_row_desc(_desc);
+    uint64_t x = 88172645463325252ULL;
+    for (int32_t k = 0; k < 32; ++k) {
+        std::string name(2048, '\0');
+        for (char& c : name) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            c = static_cast<char>(x);
+        }
+        noise->get_column_by_slot_id(1)->append_datum(Datum(static_cast<int32_t>(x)));
+        noise->get_column_by_slot_id(2)->append_datum(Datum(Slice(name)));
+        noise->get_column_by_slot_id(3)->append_datum(Datum(static_cast<double>(x)));
+    }
+    ChunkPacket raw;
+    ASSERT_TRUE(encoder.encode(*noise, &raw).ok());
+    EXPECT_EQ(CompressionType::NO_COMPRESSION, raw.compression);
+    EXPECT_EQ(raw.raw_size, raw.payload.size());
+    decoded = decode_chunk_packet(raw, _desc, &scratch);
+    ASSERT_TRUE(decoded.ok());
+    EXPECT_EQ(rows_of(*noise), rows_of(*decoded.value()));
+
+    // The encoder's scratch buffer went out as the raw payload; it must
+    // still compress the next chunk correctly.
+    ASSERT_TRUE(encoder.encode(*repetitive, &compressed).ok());
+    decoded = decode_chunk_packet(compressed, _desc, &scratch);
+    ASSERT_TRUE(decoded.ok());
+    EXPECT_EQ(rows_of(*repetitive), rows_of(*decoded.value()));
+}
+
+TEST_F(ExchangeTest, EosAndSequencesPerSender) {
+    // Every append ships a packet.
+    config::exchange_batch_bytes = 1;
+    add_receivers(1, 2);
+    auto factory = make_factory(ExchangePartitionType::HASH, {1});
+    auto sink0 = make_sink(factory.get(), 2, 0);
+    auto sink1 = make_sink(factory.get(), 2, 1);
+    for (int32_t begin = 0; begin < 30; begin += 10) {
+        ASSERT_TRUE(sink0->push_chunk(state(), make_chunk(begin, begin + 10)).ok());
+        ASSERT_TRUE(sink1->push_chunk(state(), make_chunk(begin, begin + 10)).ok());
+    }
+    ASSERT_TRUE(sink0->set_finishing(state()).ok());
+    const auto& receiver = _receivers[0];
+    std::vector<int64_t> next(2, 0);
+    while (ChunkPacketPtr packet = receiver->pull()) {
+        EXPECT_EQ(next[packet->sender_id]++, packet->sequence);
+    }
+    EXPECT_EQ(3, next[0]);
+    EXPECT_EQ(3, next[1]);
+    // Sender 1 has not sent eos yet.
+    EXPECT_FALSE(receiver->is_finished());
+    ASSERT_TRUE(sink1->set_finishing(state()).ok());
+    EXPECT_TRUE(receiver->is_finished());
+    EXPECT_EQ(8, receiver->num_packets());
+
+    // Resends are ignored; gaps and unknown senders are errors.
+    auto packet = std::make_shared<ChunkPacket>();
+    packet->sender_id = 0;
+    packet->sequence = 1;
+    packet->num_rows = 1;
+    EXPECT_TRUE(receiver->add_packet(packet).ok());
+    EXPECT_FALSE(receiver->has_output());
+    packet->sequence = 5;
+    EXPECT_FALSE(receiver->add_packet(packet).ok());
+    packet->sender_id = 2;
+    EXPECT_FALSE(receiver->add_packet(packet).ok());
+}
+
+TEST_F(ExchangeTest, FullReceiverStopsTheSink) {
+    config::exchange_batch_bytes = 1;
+    config::exchange_receiver_buffer_bytes = 1;
+    add_receivers(2, 1);
+    auto factory = make_factory(ExchangePartitionType::BROADCAST, {});
+    auto sink = make_sink(factory.get(), 1, 0);
+    ASSERT_TRUE(sink->need_input());
+    ASSERT_TRUE(sink->push_chunk(state(), make_chunk(0, 10)).ok());
+    EXPECT_TRUE(_receivers[0]->is_full());
+    EXPECT_FALSE(sink->need_input());
+
+    // Both destinations must have room again.
+    ASSERT_NE(nullptr, _receivers[0]->pull());
+    EXPECT_FALSE(sink->need_input());
+    ASSERT_NE(nullptr, _receivers[1]->pull());
+    EXPECT_TRUE(sink->need_input());
+
+    // Once every destination is closed the sink is done.
+    EXPECT_FALSE(sink->is_finished());
+    _receivers[0]->finish_source();
+    _receivers[1]->finish_source();
+    EXPECT_TRUE(sink->is_finished());
+}
+
+} // namespace starrocks::pipeline
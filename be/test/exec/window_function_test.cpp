@@ -0,0 +1,104 @@
+#include "exec/window_function.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "column/column_helper.h"
+#include "column/fixed_length_column.h"
+#include "column/nullable_column.h"
+
+namespace starrocks {
+
+// Rows of one partition under ROWS BETWEEN |preceding| PRECEDING AND CURRENT ROW.
+static std::vector<WindowRow> rows_preceding(int64_t num_rows, int64_t preceding) {
+    std::vector<WindowRow> rows;
+    for (int64_t r = 0; r < num_rows; ++r) {
+        rows.push_back({r, 0, r, std::max<int64_t>(0, r - preceding), r + 1});
+    }
+    return rows;
+}
+
+static ColumnPtr evaluate(WindowFunctionType type, LogicalType arg_type, const ColumnPtr& arg,
+                          const std::vector<WindowRow>& rows) {
+    auto function = create_window_function(type, arg_type);
+    EXPECT_TRUE(function.ok());
+    ColumnPtr dst = ColumnHelper::create_column(function.value()->result_type(),
+                                                function.value()->is_result_nullable());
+    // Two calls, so that the frame carries over from one to the next.
+    size_t half = rows.size() / 2;
+    function.value()->get_values(arg.get(), 0, rows.data(), half, dst.get());
+    function.value()->get_values(arg.get(), 0, rows.data() + half, rows.size() - half, dst.get());
+    return dst;
+}
+
+TEST(WindowFunctionTest, SlidingIntegerSum) {
+    auto arg = Int32Column::create();
+    for (int32_t v : {5, -3, 8, 1, 0, 7}) {
+        arg->append_datum(Datum(v));
+    }
+    ColumnPtr sums = evaluate(WindowFunctionType::SUM, TYPE_INT, arg, rows_preceding(6, 2));
+    std::vector<int64_t> expected{5, 2, 10, 6, 9, 8};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], sums->get(i).get_int64()) << i;
+    }
+}
+
+TEST(WindowFunctionTest, SlidingDoubleSumDoesNotCancel) {
+    auto arg = DoubleColumn::create();
+    for (double v : {1e20, 1.0, 1.0, 1.0}) {
+        arg->append_datum(Datum(v));
+    }
+    ColumnPtr sums = evaluate(WindowFunctionType::SUM, TYPE_DOUBLE, arg, rows_preceding(4, 1));
+    EXPECT_EQ(1e20, sums->get(0).get_double());
+    EXPECT_EQ(1e20, sums->get(1).get_double());
+    EXPECT_EQ(2.0, sums->get(2).get_double());
+    EXPECT_EQ(2.0, sums->get(3).get_double());
+
+    ColumnPtr avgs = evaluate(WindowFunctionType::AVG, TYPE_DOUBLE, arg, rows_preceding(4, 1));
+    EXPECT_EQ(1.0, avgs->get(3).get_double());
+}
+
+TEST(WindowFunctionTest, SlidingDoubleSumWithNullsAndInfinities) {
+    auto data = DoubleColumn::create();
+    auto nulls = NullColumn::create();
+    double values[] = {1.5, 0, INFINITY, 2.5, 1e300, -1e300, 4.0};
+    for (size_t i = 0; i < 7; ++i) {
+        data->append_datum(Datum(values[i]));
+        nulls->append_datum(Datum(uint8_t(i == 1)));
+    }
+    ColumnPtr arg = NullableColumn::create(data, nulls);
+    ColumnPtr sums = evaluate(WindowFunctionType::SUM, TYPE_DOUBLE, arg, rows_preceding(7, 1));
+    EXPECT_EQ(1.5, sums->get(0).get_double());
+    EXPECT_EQ(1.5, sums->get(1).get_double());
+    EXPECT_TRUE(std::isinf(sums->get(2).get_double()));
+    EXPECT_TRUE(std::isinf(sums->get(3).get_double()));
+    EXPECT_EQ(1e300, sums->get(4).get_double());
+    EXPECT_EQ(0.0, sums->get(5).get_double());
+    EXPECT_EQ(-1e300 + 4.0, sums->get(6).get_double());
+
+    ColumnPtr only_null = evaluate(WindowFunctionType::SUM, TYPE_DOUBLE, arg, {{1, 0, 1, 1, 2}});
+    EXPECT_TRUE(only_null->get(0).is_null());
+}
+
+// Partial sums of these values are exact, whatever the order of the additions.
+TEST(WindowFunctionTest, SlidingDoubleSumMatchesRecomputing) {
+    auto arg = DoubleColumn::create();
+    for (int i = 0; i < 1000; ++i) {
+        arg->append_datum(Datum((i % 7 == 0 ? 1e6 : 0.25) * (i % 3 == 0 ? -1 : 1)));
+    }
+    for (int64_t preceding : {0, 1, 5, 64}) {
+        auto rows = rows_preceding(1000, preceding);
+        ColumnPtr sums = evaluate(WindowFunctionType::SUM, TYPE_DOUBLE, arg, rows);
+        for (const WindowRow& row : rows) {
+            double expected = 0;
+            for (int64_t r = row.frame_start; r < row.frame_end; ++r) {
+                expected += arg->get(r).get_double();
+            }
+            ASSERT_EQ(expected, sums->get(row.row).get_double()) << preceding << " " << row.row;
+        }
+    }
+}
+
+} // namespace starrocks
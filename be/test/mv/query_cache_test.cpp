@@ -0,0 +1,110 @@
+#include "mv/query_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "column/column_helper.h"
+#include "exprs/function_call_expr.h"
+
+namespace starrocks {
+
+// t(k INT, v DOUBLE, s VARCHAR) in memory, in one partition.
+class MemoryTable final : public TableSource {
+public:
+    MemoryTable() {
+        _rows = create_chunk_for_row_desc(_schema);
+        auto add = [&](int32_t k, double v, const std::string& s) {
+            _rows->get_column_by_slot_id(0)->append_datum(Datum(k));
+            _rows->get_column_by_slot_id(1)->append_datum(Datum(v));
+            _rows->get_column_by_slot_id(2)->append_datum(Datum(Slice(s)));
+        };
+        add(1, 1.5e-7, "x");
+        add(2, 3e-7, "x', 'y");
+        add(3, 1.0, "y");
+    }
+
+    const std::string& name() const override { return _name; }
+    const RowDescriptor& schema() const override { return _schema; }
+    int partition_column() const override { return -1; }
+    std::vector<TablePartition> partitions() const override { return {{0, 1}}; }
+
+    Status scan(const std::vector<uint32_t>& columns, const std::vector<SlotId>& slot_ids,
+                const std::vector<int64_t>* partition_ids, const ChunkConsumer& consumer) const override {
+        auto chunk = std::make_shared<Chunk>();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            chunk->append_column(_rows->get_column_by_index(columns[i])->clone(), slot_ids[i]);
+        }
+        return consumer(chunk);
+    }
+
+private:
+    const std::string _name = "t";
+    const RowDescriptor _schema{{0, TYPE_INT, false}, {1, TYPE_DOUBLE, false}, {2, TYPE_VARCHAR, false}};
+    ChunkPtr _rows;
+};
+
+class QueryCacheTest : public ::testing::Test {
+protected:
+    // SELECT k, COUNT(*) FROM t WHERE <predicate> GROUP BY k, returning the
+    // number of rows counted and whether it was read from the cache.
+    std::pair<int64_t, bool> count(const ExprPtr& predicate) {
+        SpjgQuery query;
+        query.tables.push_back({_table, {1, 2, 3}});
+        query.predicates.push_back(predicate);
+        query.group_by.push_back({10, make_column_ref({1, TYPE_INT, false})});
+        query.aggregates.push_back({AggFunctionType::COUNT, nullptr, 11});
+
+        QueryCacheStats stats;
+        auto chunks = _cache.execute(query, &stats);
+        EXPECT_TRUE(chunks.ok()) << chunks.status().to_string();
+        int64_t rows = 0;
+        for (const auto& chunk : chunks.value()) {
+            for (size_t i = 0; i < chunk->num_rows(); ++i) {
+                rows += chunk->get_column_by_slot_id(11)->get(i).get_int64();
+            }
+        }
+        return {rows, stats.partitions_hit > 0};
+    }
+
+    static ExprPtr call(const std::string& name, Exprs args) {
+        auto expr = make_function_call(name, std::move(args));
+        EXPECT_TRUE(expr.ok()) << expr.status().to_string();
+        return expr.value();
+    }
+
+    static ExprPtr v_greater_than(double value) {
+        return call("gt", {make_column_ref({2, TYPE_DOUBLE, false}), make_literal(TYPE_DOUBLE, Datum(value))});
+    }
+
+    static ExprPtr string_literal(const std::string& value) { return make_literal(TYPE_VARCHAR, Datum(Slice(value))); }
+
+    TableSourcePtr _table = std::make_shared<MemoryTable>();
+    QueryCache _cache{1 << 20, nullptr};
+};
+
+TEST_F(QueryCacheTest, RepeatedQueryHits) {
+    EXPECT_EQ(std::make_pair(int64_t{3}, false), count(v_greater_than(1e-7)));
+    EXPECT_EQ(std::make_pair(int64_t{3}, true), count(v_greater_than(1e-7)));
+    EXPECT_EQ(1, _cache.num_entries());
+    EXPECT_EQ(1, _cache.num_hits());
+}
+
+TEST_F(QueryCacheTest, DoubleLiteralsKeyByTheirBits) {
+    EXPECT_EQ(std::make_pair(int64_t{3}, false), count(v_greater_than(1e-7)));
+    EXPECT_EQ(std::make_pair(int64_t{2}, false), count(v_greater_than(2e-7)));
+    EXPECT_EQ(std::make_pair(int64_t{2}, false), count(v_greater_than(2.0000001e-7)));
+    EXPECT_EQ(3, _cache.num_entries());
+}
+
+TEST_F(QueryCacheTest, StringLiteralsKeyByTheirBytes) {
+    // Quoted naively, the literal of the second query reads as the last two
+    // arguments of the first.
+    ExprPtr s = make_column_ref({3, TYPE_VARCHAR, false});
+    ExprPtr two_args = call("concat", {s, string_literal("x"), string_literal("y")});
+    ExprPtr one_arg = call("concat", {s, string_literal("x', 'y")});
+    EXPECT_EQ(std::make_pair(int64_t{1}, false), count(call("eq", {two_args, string_literal("yxy")})));
+    EXPECT_EQ(std::make_pair(int64_t{0}, false), count(call("eq", {one_arg, string_literal("yxy")})));
+    EXPECT_EQ(std::make_pair(int64_t{1}, false), count(call("eq", {one_arg, string_literal("x', 'yx', 'y")})));
+    EXPECT_EQ(std::make_pair(int64_t{1}, true), count(call("eq", {two_args, string_literal("yxy")})));
+}
+
+} // namespace starrocks
@@ -0,0 +1,77 @@
+#include "runtime/arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace starrocks {
+
+TEST(ArenaTest, AllocationsAreAlignedAndAccounted) {
+    Arena arena;
+    void* a = arena.allocate(1);
+    void* b = arena.allocate(100);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a) % COLUMN_BUFFER_ALIGNMENT);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b) % COLUMN_BUFFER_ALIGNMENT);
+    EXPECT_EQ(Arena::alloc_size(1) + Arena::alloc_size(100), arena.allocated_bytes());
+    arena.free(a, 1);
+    arena.free(b, 100);
+    EXPECT_EQ(0, arena.allocated_bytes());
+    EXPECT_GE(arena.peak_allocated_bytes(), Arena::alloc_size(1) + Arena::alloc_size(100));
+}
+
+TEST(ArenaTest, FreedBlocksAreReused) {
+    Arena arena;
+    void* a = arena.allocate(1000);
+    arena.free(a, 1000);
+    size_t reserved = arena.reserved_bytes();
+    void* b = arena.allocate(1000);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(reserved, arena.reserved_bytes());
+    arena.free(b, 1000);
+}
+
+TEST(ArenaTest, ReallocateCopies) {
+    Arena arena;
+    auto* p = static_cast<char*>(arena.allocate(64));
+    memcpy(p, "arena", 6);
+    auto* q = static_cast<char*>(arena.reallocate(p, 64, 4096));
+    EXPECT_STREQ("arena", q);
+    arena.free(q, 4096);
+    EXPECT_EQ(0, arena.allocated_bytes());
+}
+
+TEST(ArenaTest, LargeAllocationsBypassThePool) {
+    Arena arena;
+    size_t size = Arena::kMaxPooledSize * 2;
+    auto* p = static_cast<uint8_t*>(arena.allocate(size));
+    ASSERT_NE(nullptr, p);
+    memset(p, 1, size);
+    arena.free(p, size);
+    EXPECT_EQ(0, arena.allocated_bytes());
+}
+
+TEST(ArenaTest, ConcurrentAllocations) {
+    Arena arena;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&arena] {
+            std::vector<void*> ptrs;
+            for (int i = 0; i < 1000; ++i) {
+                ptrs.push_back(arena.allocate(64 << (i % 5)));
+            }
+            for (int i = 0; i < 1000; ++i) {
+                arena.free(ptrs[i], 64 << (i % 5));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(0, arena.allocated_bytes());
+}
+
+} // namespace starrocks